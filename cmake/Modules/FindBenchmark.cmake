@@ -0,0 +1,39 @@
+# Tries to find Google Benchmark.
+#
+# Usage of this module as follows:
+#
+# find_package(Benchmark)
+#
+# Variables used by this module, they can change the default behaviour and need
+# to be set before calling find_package:
+#
+# BENCHMARK_ROOT_DIR Set this variable to the root installation of
+# Google Benchmark if the module has problems finding
+# the proper installation path.
+#
+# Variables defined by this module:
+#
+# BENCHMARK_FOUND System has Google Benchmark libs/headers
+# BENCHMARK_LIBRARIES The Google Benchmark library
+# BENCHMARK_INCLUDE_DIR The location of the benchmark/benchmark.h header
+
+find_library(BENCHMARK_LIBRARIES
+  NAMES benchmark
+  HINTS ${BENCHMARK_ROOT_DIR}/lib)
+
+find_path(BENCHMARK_INCLUDE_DIR
+  NAMES benchmark/benchmark.h
+  HINTS ${BENCHMARK_ROOT_DIR}/include)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(
+  BENCHMARK
+  DEFAULT_MSG
+  BENCHMARK_LIBRARIES
+  BENCHMARK_INCLUDE_DIR
+)
+
+mark_as_advanced(
+  BENCHMARK_ROOT_DIR
+  BENCHMARK_LIBRARIES
+  BENCHMARK_INCLUDE_DIR)
@@ -0,0 +1,58 @@
+# Tries to find LZ4.
+#
+# Usage of this module as follows:
+#
+# find_package(LZ4)
+#
+# Variables used by this module, they can change the default behaviour and need
+# to be set before calling find_package:
+#
+# LZ4_ROOT_DIR Set this variable to the root installation of
+# LZ4 if the module has problems finding
+# the proper installation path.
+#
+# Variables defined by this module:
+#
+# LZ4_FOUND System has LZ4 libs/headers
+# LZ4_LIBRARIES The LZ4 library
+# LZ4_INCLUDE_DIR The location of the LZ4 frame format header
+# LZ4_VERSION The version of LZ4, read from lz4.h
+#
+# LZ4 older than 1.8.0 is reported as not found.
+
+find_library(LZ4_LIBRARIES
+  NAMES lz4
+  HINTS ${LZ4_ROOT_DIR}/lib)
+
+find_path(LZ4_INCLUDE_DIR
+  NAMES lz4frame.h
+  HINTS ${LZ4_ROOT_DIR}/include)
+
+if(LZ4_INCLUDE_DIR AND EXISTS "${LZ4_INCLUDE_DIR}/lz4.h")
+  file(STRINGS "${LZ4_INCLUDE_DIR}/lz4.h" LZ4_VERSION_LINES
+       REGEX "^#define LZ4_VERSION_(MAJOR|MINOR|RELEASE)[ \t]+[0-9]+")
+  string(REGEX REPLACE ".*#define LZ4_VERSION_MAJOR[ \t]+([0-9]+).*" "\\1" LZ4_VERSION_MAJOR "${LZ4_VERSION_LINES}")
+  string(REGEX REPLACE ".*#define LZ4_VERSION_MINOR[ \t]+([0-9]+).*" "\\1" LZ4_VERSION_MINOR "${LZ4_VERSION_LINES}")
+  string(REGEX REPLACE ".*#define LZ4_VERSION_RELEASE[ \t]+([0-9]+).*" "\\1" LZ4_VERSION_RELEASE "${LZ4_VERSION_LINES}")
+  set(LZ4_VERSION "${LZ4_VERSION_MAJOR}.${LZ4_VERSION_MINOR}.${LZ4_VERSION_RELEASE}")
+  if(NOT LZ4_VERSION MATCHES "^[0-9]+\\.[0-9]+\\.[0-9]+$")
+    unset(LZ4_VERSION)   # too old to define the version macros
+  endif(NOT LZ4_VERSION MATCHES "^[0-9]+\\.[0-9]+\\.[0-9]+$")
+endif(LZ4_INCLUDE_DIR AND EXISTS "${LZ4_INCLUDE_DIR}/lz4.h")
+
+# the minimum version, unless the caller asks for another one
+if(NOT LZ4_FIND_VERSION)
+  set(LZ4_FIND_VERSION 1.8.0)
+endif(NOT LZ4_FIND_VERSION)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(
+  LZ4
+  REQUIRED_VARS LZ4_LIBRARIES LZ4_INCLUDE_DIR LZ4_VERSION
+  VERSION_VAR LZ4_VERSION
+)
+
+mark_as_advanced(
+  LZ4_ROOT_DIR
+  LZ4_LIBRARIES
+  LZ4_INCLUDE_DIR)
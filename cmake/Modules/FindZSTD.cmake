@@ -0,0 +1,58 @@
+# Tries to find zstd.
+#
+# Usage of this module as follows:
+#
+# find_package(ZSTD)
+#
+# Variables used by this module, they can change the default behaviour and need
+# to be set before calling find_package:
+#
+# ZSTD_ROOT_DIR Set this variable to the root installation of
+# zstd if the module has problems finding
+# the proper installation path.
+#
+# Variables defined by this module:
+#
+# ZSTD_FOUND System has zstd libs/headers
+# ZSTD_LIBRARIES The zstd library
+# ZSTD_INCLUDE_DIR The location of zstd headers
+# ZSTD_VERSION The version of zstd, read from zstd.h
+#
+# zstd older than 1.4.0 is reported as not found.
+
+find_library(ZSTD_LIBRARIES
+  NAMES zstd
+  HINTS ${ZSTD_ROOT_DIR}/lib)
+
+find_path(ZSTD_INCLUDE_DIR
+  NAMES zstd.h
+  HINTS ${ZSTD_ROOT_DIR}/include)
+
+if(ZSTD_INCLUDE_DIR AND EXISTS "${ZSTD_INCLUDE_DIR}/zstd.h")
+  file(STRINGS "${ZSTD_INCLUDE_DIR}/zstd.h" ZSTD_VERSION_LINES
+       REGEX "^#define ZSTD_VERSION_(MAJOR|MINOR|RELEASE)[ \t]+[0-9]+")
+  string(REGEX REPLACE ".*#define ZSTD_VERSION_MAJOR[ \t]+([0-9]+).*" "\\1" ZSTD_VERSION_MAJOR "${ZSTD_VERSION_LINES}")
+  string(REGEX REPLACE ".*#define ZSTD_VERSION_MINOR[ \t]+([0-9]+).*" "\\1" ZSTD_VERSION_MINOR "${ZSTD_VERSION_LINES}")
+  string(REGEX REPLACE ".*#define ZSTD_VERSION_RELEASE[ \t]+([0-9]+).*" "\\1" ZSTD_VERSION_RELEASE "${ZSTD_VERSION_LINES}")
+  set(ZSTD_VERSION "${ZSTD_VERSION_MAJOR}.${ZSTD_VERSION_MINOR}.${ZSTD_VERSION_RELEASE}")
+  if(NOT ZSTD_VERSION MATCHES "^[0-9]+\\.[0-9]+\\.[0-9]+$")
+    unset(ZSTD_VERSION)   # too old to define the version macros
+  endif(NOT ZSTD_VERSION MATCHES "^[0-9]+\\.[0-9]+\\.[0-9]+$")
+endif(ZSTD_INCLUDE_DIR AND EXISTS "${ZSTD_INCLUDE_DIR}/zstd.h")
+
+# the minimum version, unless the caller asks for another one
+if(NOT ZSTD_FIND_VERSION)
+  set(ZSTD_FIND_VERSION 1.4.0)
+endif(NOT ZSTD_FIND_VERSION)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(
+  ZSTD
+  REQUIRED_VARS ZSTD_LIBRARIES ZSTD_INCLUDE_DIR ZSTD_VERSION
+  VERSION_VAR ZSTD_VERSION
+)
+
+mark_as_advanced(
+  ZSTD_ROOT_DIR
+  ZSTD_LIBRARIES
+  ZSTD_INCLUDE_DIR)
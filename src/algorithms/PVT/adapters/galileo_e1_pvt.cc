@@ -67,6 +67,72 @@ GalileoE1Pvt::GalileoE1Pvt(ConfigurationInterface* configuration,
     // display rate
     int display_rate_ms;
     display_rate_ms = configuration->property(role + ".display_rate_ms", 500);
+    // observables measurement rate: the observables block only delivers one out of
+    // input_rate_ms epochs, so the PVT rates must be multiples of it
+    int input_rate_ms;
+    input_rate_ms = configuration->property("Observables.output_rate_ms", 1);
+    if (input_rate_ms < 1)
+        {
+            input_rate_ms = 1;
+        }
+    if (output_rate_ms % input_rate_ms != 0)
+        {
+            output_rate_ms = (output_rate_ms / input_rate_ms + 1) * input_rate_ms;
+            LOG(WARNING) << role << ".output_rate_ms is not a multiple of Observables.output_rate_ms. Using " << output_rate_ms << " instead";
+        }
+    if (display_rate_ms % input_rate_ms != 0)
+        {
+            display_rate_ms = (display_rate_ms / input_rate_ms + 1) * input_rate_ms;
+            LOG(WARNING) << role << ".display_rate_ms is not a multiple of Observables.output_rate_ms. Using " << display_rate_ms << " instead";
+        }
+    // positioning mode: epoch-wise Least Squares (LS, or LS_ARMADILLO with the former solver) or Kalman filter (EKF)
+    std::string default_positioning_mode = "LS";
+    std::string positioning_mode;
+    positioning_mode = configuration->property(role + ".positioning_mode", default_positioning_mode);
+    if ((positioning_mode != "LS") and (positioning_mode != "EKF") and (positioning_mode != "LS_ARMADILLO"))
+        {
+            LOG(WARNING) << role << ".positioning_mode=" << positioning_mode << " is not valid, using LS";
+            positioning_mode = "LS";
+        }
+    double ekf_pseudorange_sigma_m;
+    ekf_pseudorange_sigma_m = configuration->property(role + ".ekf_pseudorange_sigma_m", 5.0);
+    double ekf_acceleration_psd;
+    ekf_acceleration_psd = configuration->property(role + ".ekf_acceleration_psd", 1.0);
+    // output writer thread queue
+    unsigned int output_queue_size;
+    output_queue_size = configuration->property(role + ".output_queue_size", 1024);
+    std::string default_output_queue_policy = "block";
+    std::string output_queue_policy;
+    output_queue_policy = configuration->property(role + ".output_queue_policy", default_output_queue_policy);
+    if ((output_queue_policy != "block") and (output_queue_policy != "drop"))
+        {
+            LOG(WARNING) << role << ".output_queue_policy=" << output_queue_policy << " is not valid, using block";
+            output_queue_policy = "block";
+        }
+    // TCP streaming servers for local clients (e.g. RTK processes)
+    bool flag_rtcm_server;
+    flag_rtcm_server = configuration->property(role + ".flag_rtcm_server", false);
+    unsigned int rtcm_tcp_port;
+    rtcm_tcp_port = configuration->property(role + ".rtcm_tcp_port", 2101);
+    unsigned int rtcm_station_id;
+    rtcm_station_id = configuration->property(role + ".rtcm_station_id", 1234);
+    if (rtcm_station_id > 4095)
+        {
+            LOG(WARNING) << role << ".rtcm_station_id=" << rtcm_station_id << " is not valid, using 1234";
+            rtcm_station_id = 1234;
+        }
+    unsigned int rtcm_observables;
+    rtcm_observables = configuration->property(role + ".rtcm_observables", 7);
+    if (rtcm_observables != 4 and rtcm_observables != 7 and (rtcm_observables < 1001 or rtcm_observables > 1004))
+        {
+            LOG(WARNING) << role << ".rtcm_observables=" << rtcm_observables << " is not valid, using 7";
+            rtcm_observables = 7;
+        }
+    std::string default_stream_address = "127.0.0.1";
+    std::string stream_address;
+    stream_address = configuration->property(role + ".stream_address", default_stream_address);
+    unsigned int stream_client_queue_size;
+    stream_client_queue_size = configuration->property(role + ".stream_client_queue_size", 64);
     // NMEA Printer settings
     bool flag_nmea_tty_port;
     flag_nmea_tty_port = configuration->property(role + ".flag_nmea_tty_port", false);
@@ -76,6 +142,14 @@ GalileoE1Pvt::GalileoE1Pvt(ConfigurationInterface* configuration,
     nmea_dump_devname = configuration->property(role + ".nmea_dump_devname", default_nmea_dump_devname);
     // make PVT object
     pvt_ = galileo_e1_make_pvt_cc(in_streams_, queue_, dump_, dump_filename_, averaging_depth, flag_averaging, output_rate_ms, display_rate_ms, flag_nmea_tty_port, nmea_dump_filename, nmea_dump_devname);
+    pvt_->set_input_rate_ms(input_rate_ms);
+    pvt_->set_ekf(positioning_mode == "EKF", ekf_pseudorange_sigma_m, ekf_acceleration_psd);
+    pvt_->set_ls_armadillo(positioning_mode == "LS_ARMADILLO");
+    pvt_->set_output_queue(output_queue_size, output_queue_policy == "drop");
+    if (flag_rtcm_server == true and rtcm_tcp_port <= 65535)
+        {
+            pvt_->set_rtcm_server(stream_address, static_cast<unsigned short>(rtcm_tcp_port), rtcm_station_id, stream_client_queue_size, rtcm_observables);
+        }
     DLOG(INFO) << "pvt(" << pvt_->unique_id() << ")";
 }
 
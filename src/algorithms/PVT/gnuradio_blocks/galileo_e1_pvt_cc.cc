@@ -50,6 +50,8 @@ extern concurrent_map<Galileo_Iono> global_galileo_iono_map;
 extern concurrent_map<Galileo_Utc_Model> global_galileo_utc_model_map;
 extern concurrent_map<Galileo_Almanac> global_galileo_almanac_map;
 
+extern concurrent_map<Gnss_Receiver_Fix> global_receiver_fix_map;
+
 galileo_e1_pvt_cc_sptr
 galileo_e1_make_pvt_cc(unsigned int nchannels, boost::shared_ptr<gr::msg_queue> queue, bool dump, std::string dump_filename, int averaging_depth, bool flag_averaging, int output_rate_ms, int display_rate_ms, bool flag_nmea_tty_port, std::string nmea_dump_filename, std::string nmea_dump_devname)
 {
@@ -61,6 +63,7 @@ galileo_e1_pvt_cc::galileo_e1_pvt_cc(unsigned int nchannels, boost::shared_ptr<g
 		                		                gr::block("galileo_e1_pvt_cc", gr::io_signature::make(nchannels, nchannels,  sizeof(Gnss_Synchro)),
 		                		                        gr::io_signature::make(1, 1, sizeof(gr_complex)))
 {
+    d_counters = gnss_block_counters(this);
 
     d_output_rate_ms = output_rate_ms;
     d_display_rate_ms = display_rate_ms;
@@ -88,27 +91,47 @@ galileo_e1_pvt_cc::galileo_e1_pvt_cc(unsigned int nchannels, boost::shared_ptr<g
     d_ls_pvt->set_averaging_depth(d_averaging_depth);
 
     d_sample_counter = 0;
+    d_input_rate_ms = 1;
+    d_galileo_ephemeris_version = 0;
+    d_galileo_utc_model_version = 0;
+    d_galileo_iono_version = 0;
+    d_galileo_almanac_version = 0;
     d_last_sample_nav_output = 0;
+    d_last_sample_rtcm_output = 0;
+    d_rtcm_observables = 7;
+    d_last_sample_fix_output = 0;
     d_rx_time = 0.0;
 
     b_rinex_header_writen = false;
     rp = std::make_shared<Rinex_Printer>();
 
+    // RINEX, KML and dump records are written by the output writer thread
+    d_output_writer = std::make_shared<Pvt_Output_Writer>(1024, false);
+    add_output_flush();
+
     // ############# ENABLE DATA FILE LOG #################
     if (d_dump == true)
         {
             if (d_dump_file.is_open() == false)
                 {
-                    try
-                    {
-                            d_dump_file.exceptions (std::ifstream::failbit | std::ifstream::badbit );
-                            d_dump_file.open(d_dump_filename.c_str(), std::ios::out | std::ios::binary);
-                            LOG(INFO) << "PVT dump enabled Log file: " << d_dump_filename.c_str();
-                    }
-                    catch (const std::ifstream::failure& e)
-                    {
-                            LOG(WARNING) << "Exception opening PVT dump file " << e.what();
-                    }
+                    d_dump_file.set_attribute("source", "galileo_e1_pvt");
+                    d_dump_file.set_attribute("channels", d_nchannels);
+                    for (unsigned int i = 0; i < d_nchannels; i++)
+                        {
+                            std::string channel = "ch" + std::to_string(i) + "_";
+                            d_dump_file.add_field<double>(channel + "Pseudorange_m");
+                            d_dump_file.add_field<double>(channel + "reserved");
+                            d_dump_file.add_field<double>(channel + "rx_time_s");
+                        }
+                    // records are already written from the output writer thread
+                    if (d_dump_file.open(d_dump_filename, false))
+                        {
+                            LOG(INFO) << "PVT dump enabled Log file: " << d_dump_filename;
+                        }
+                    else
+                        {
+                            LOG(WARNING) << "Unable to open PVT dump file " << d_dump_filename;
+                        }
                 }
         }
 }
@@ -116,7 +139,66 @@ galileo_e1_pvt_cc::galileo_e1_pvt_cc(unsigned int nchannels, boost::shared_ptr<g
 
 
 galileo_e1_pvt_cc::~galileo_e1_pvt_cc()
-{}
+{
+    d_output_writer->stop();
+    if (d_rtcm_server) d_rtcm_server->stop();
+}
+
+
+
+void galileo_e1_pvt_cc::set_input_rate_ms(int input_rate_ms)
+{
+    if (input_rate_ms > 0)
+        {
+            d_input_rate_ms = input_rate_ms;
+        }
+}
+
+
+void galileo_e1_pvt_cc::set_output_queue(unsigned int queue_size, bool drop_when_full)
+{
+    d_output_writer->stop();
+    d_output_writer = std::make_shared<Pvt_Output_Writer>(queue_size, drop_when_full);
+    add_output_flush();
+}
+
+
+void galileo_e1_pvt_cc::set_rtcm_server(const std::string& address, unsigned short port, unsigned int station_id, unsigned int client_queue_size, unsigned int observables_type)
+{
+    d_rtcm_observables = observables_type;
+    d_rtcm_server = std::make_shared<Pvt_Stream_Server>(address, port, client_queue_size);
+    if (d_rtcm_server->start() == false)
+        {
+            d_rtcm_server.reset();
+            return;
+        }
+    // frames are only streamed, there is no RTCM file or serial device
+    d_rtcm_printer = std::make_shared<Rtcm_Printer>("", false, "", station_id);
+    d_rtcm_printer->set_stream_server(d_rtcm_server);
+}
+
+
+void galileo_e1_pvt_cc::add_output_flush()
+{
+    std::shared_ptr<Rinex_Printer> rinex = rp;
+    d_output_writer->add_flush([rinex]() { rinex->obsFile.flush(); rinex->navGalFile.flush(); });
+    if (d_dump == true)
+        {
+            d_output_writer->add_flush([this]() { if (d_dump_file.is_open()) d_dump_file.flush(); });
+        }
+}
+
+
+void galileo_e1_pvt_cc::set_ekf(bool flag_ekf, double pseudorange_sigma_m, double acceleration_psd)
+{
+    d_ls_pvt->set_ekf(flag_ekf, pseudorange_sigma_m, acceleration_psd);
+}
+
+
+void galileo_e1_pvt_cc::set_ls_armadillo(bool flag_ls_armadillo)
+{
+    d_ls_pvt->set_ls_armadillo(flag_ls_armadillo);
+}
 
 
 
@@ -130,7 +212,9 @@ bool galileo_e1_pvt_cc::pseudoranges_pairCompare_min( std::pair<int,Gnss_Synchro
 int galileo_e1_pvt_cc::general_work (int noutput_items, gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items,	gr_vector_void_star &output_items)
 {
-    d_sample_counter++;
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
+    d_counters->set_dropped(d_output_writer->dropped());   // outputs the writer could not keep up with
+    d_sample_counter += d_input_rate_ms; // each input item spans d_input_rate_ms observables epochs
 
     std::map<int,Gnss_Synchro> gnss_pseudoranges_map;
 
@@ -144,31 +228,28 @@ int galileo_e1_pvt_cc::general_work (int noutput_items, gr_vector_int &ninput_it
                     d_rx_time = in[i][0].d_TOW_at_current_symbol; // all the channels have the same RX timestamp (common RX time pseudoranges)
                 }
         }
+    // the records of this epoch carry the age of its samples
+    long long sample_arrival_ns = gnss_latency_at_pvt(gnss_pseudoranges_map);
+    if (gnss_latency_late(sample_arrival_ns))
+        {
+            d_counters->add_late();
+        }
+    d_output_writer->set_sample_arrival(sample_arrival_ns);
 
     // ############ 1. READ EPHEMERIS/UTC_MODE/IONO FROM GLOBAL MAPS ####
 
-    if (global_galileo_ephemeris_map.size() > 0)
-        {
-            d_ls_pvt->galileo_ephemeris_map = global_galileo_ephemeris_map.get_map_copy();
-        }
+    // The global maps are only copied when a new version has been published
 
-    if (global_galileo_utc_model_map.size() > 0)
-        {
-            // UTC MODEL data is shared for all the Galileo satellites. Read always at ID=0
-            global_galileo_utc_model_map.read(0, d_ls_pvt->galileo_utc_model);
-        }
+    global_galileo_ephemeris_map.get_map_copy_if_updated(d_ls_pvt->galileo_ephemeris_map, d_galileo_ephemeris_version);
 
-    if (global_galileo_iono_map.size() > 0)
-        {
-            // IONO data is shared for all the Galileo satellites. Read always at ID=0
-            global_galileo_iono_map.read(0, d_ls_pvt->galileo_iono);
-        }
+    // UTC MODEL data is shared for all the Galileo satellites. Read always at ID=0
+    global_galileo_utc_model_map.read_if_updated(0, d_ls_pvt->galileo_utc_model, d_galileo_utc_model_version);
 
-    if (global_galileo_almanac_map.size() > 0)
-        {
-            // Almanac data is shared for all the Galileo satellites. Read always at ID=0
-            global_galileo_almanac_map.read(0, d_ls_pvt->galileo_almanac);
-        }
+    // IONO data is shared for all the Galileo satellites. Read always at ID=0
+    global_galileo_iono_map.read_if_updated(0, d_ls_pvt->galileo_iono, d_galileo_iono_version);
+
+    // Almanac data is shared for all the Galileo satellites. Read always at ID=0
+    global_galileo_almanac_map.read_if_updated(0, d_ls_pvt->galileo_almanac, d_galileo_almanac_version);
 
     // ############ 2 COMPUTE THE PVT ################################
     if (gnss_pseudoranges_map.size() > 0 and d_ls_pvt->galileo_ephemeris_map.size() > 0)
@@ -178,10 +259,43 @@ int galileo_e1_pvt_cc::general_work (int noutput_items, gr_vector_int &ninput_it
                 {
                     bool pvt_result;
                     pvt_result = d_ls_pvt->get_PVT(gnss_pseudoranges_map, d_rx_time, d_flag_averaging);
+                    if (d_rtcm_printer)
+                        {
+                            // RTCM observables at the output rate, ephemeris and antenna position every 5 s
+                            std::shared_ptr<Rtcm_Printer> rtcm = d_rtcm_printer;
+                            unsigned int observables_type = d_rtcm_observables;
+                            double rx_time = d_rx_time;
+                            d_output_writer->post([rtcm, observables_type, rx_time, gnss_pseudoranges_map]() { rtcm->Print_Rtcm_Observables(observables_type, rx_time, gnss_pseudoranges_map); });
+                            if ((d_sample_counter - d_last_sample_rtcm_output) >= 5000)
+                                {
+                                    std::map<int,Galileo_Ephemeris> gal_eph_map = d_ls_pvt->galileo_ephemeris_map;
+                                    bool valid_position = d_ls_pvt->b_valid_position;
+                                    double x = d_ls_pvt->d_x_m;
+                                    double y = d_ls_pvt->d_y_m;
+                                    double z = d_ls_pvt->d_z_m;
+                                    d_output_writer->post([rtcm, gal_eph_map, valid_position, x, y, z]()
+                                            {
+                                                rtcm->Print_Rtcm_Ephemeris(gal_eph_map);
+                                                if (valid_position and rtcm->encode_M1005(x, y, z) > 0) rtcm->Print_Rtcm_Frame();
+                                            });
+                                    d_last_sample_rtcm_output = d_sample_counter;
+                                }
+                        }
 
                     if (pvt_result == true)
                         {
-                            d_kml_dump->print_position_galileo(d_ls_pvt, d_flag_averaging);
+                            // kept in the receiver state for the next start
+                            if ((d_sample_counter - d_last_sample_fix_output) >= 1000 or d_last_sample_fix_output == 0)
+                                {
+                                    global_receiver_fix_map.write(0, d_ls_pvt->receiver_fix());
+                                    d_last_sample_fix_output = d_sample_counter;
+                                }
+                            // the writer thread works on a copy of the solution and of the data it needs
+                            std::shared_ptr<Pvt_Solution> solution = std::make_shared<Pvt_Solution>(*d_ls_pvt);
+                            std::shared_ptr<Kml_Printer> kml = d_kml_dump;
+                            std::shared_ptr<Rinex_Printer> rinex = rp;
+                            bool flag_averaging = d_flag_averaging;
+                            d_output_writer->post([kml, solution, flag_averaging]() { kml->print_position_galileo(solution, flag_averaging); });
                             //ToDo: Implement Galileo RINEX and Galileo NMEA outputs
                             //   d_nmea_printer->Print_Nmea_Line(d_ls_pvt, d_flag_averaging);
                             //
@@ -191,8 +305,16 @@ int galileo_e1_pvt_cc::general_work (int noutput_items, gr_vector_int &ninput_it
                                     galileo_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.begin();
                                     if (galileo_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end())
                                         {
-                                            rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, d_rx_time);
-                                            rp->rinex_nav_header(rp->navGalFile, d_ls_pvt->galileo_iono, d_ls_pvt->galileo_utc_model, d_ls_pvt->galileo_almanac);
+                                            Galileo_Ephemeris eph = galileo_ephemeris_iter->second;
+                                            Galileo_Iono iono = d_ls_pvt->galileo_iono;
+                                            Galileo_Utc_Model utc_model = d_ls_pvt->galileo_utc_model;
+                                            Galileo_Almanac almanac = d_ls_pvt->galileo_almanac;
+                                            double rx_time = d_rx_time;
+                                            d_output_writer->post([rinex, eph, iono, utc_model, almanac, rx_time]()
+                                                    {
+                                                        rinex->rinex_obs_header(rinex->obsFile, eph, rx_time);
+                                                        rinex->rinex_nav_header(rinex->navGalFile, iono, utc_model, almanac);
+                                                    });
                                             b_rinex_header_writen = true; // do not write header anymore
                                         }
                                 }
@@ -202,15 +324,21 @@ int galileo_e1_pvt_cc::general_work (int noutput_items, gr_vector_int &ninput_it
                                     // Notice that d_sample_counter period is 4ms (for Galileo correlators)
                                     if ((d_sample_counter - d_last_sample_nav_output) >= 6000)
                                         {
-                                            rp->log_rinex_nav(rp->navGalFile, d_ls_pvt->galileo_ephemeris_map);
+                                            std::map<int,Galileo_Ephemeris> eph_map = d_ls_pvt->galileo_ephemeris_map;
+                                            d_output_writer->post([rinex, eph_map]() { rinex->log_rinex_nav(rinex->navGalFile, eph_map); });
                                             d_last_sample_nav_output = d_sample_counter;
                                         }
-                                       std::map<int, Galileo_Ephemeris>::iterator galileo_ephemeris_iter;
-                                       galileo_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.begin();
-                                       if (galileo_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end())
-                                          {
-                                              rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, d_rx_time, gnss_pseudoranges_map);
-                                          }
+                                    std::map<int, Galileo_Ephemeris>::iterator galileo_ephemeris_iter;
+                                    galileo_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.begin();
+                                    if (galileo_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end())
+                                        {
+                                            Galileo_Ephemeris eph = galileo_ephemeris_iter->second;
+                                            double rx_time = d_rx_time;
+                                            d_output_writer->post([rinex, eph, rx_time, gnss_pseudoranges_map]()
+                                                    {
+                                                        rinex->log_rinex_obs(rinex->obsFile, eph, rx_time, gnss_pseudoranges_map);
+                                                    });
+                                        }
                                 }
                         }
                 }
@@ -235,22 +363,17 @@ int galileo_e1_pvt_cc::general_work (int noutput_items, gr_vector_int &ninput_it
             // MULTIPLEXED FILE RECORDING - Record results to file
             if(d_dump == true)
                 {
-                    try
-                    {
-                            double tmp_double;
-                            for (unsigned int i = 0; i < d_nchannels; i++)
-                                {
-                                    tmp_double = in[i][0].Pseudorange_m;
-                                    d_dump_file.write((char*)&tmp_double, sizeof(double));
-                                    tmp_double = 0;
-                                    d_dump_file.write((char*)&tmp_double, sizeof(double));
-                                    d_dump_file.write((char*)&d_rx_time, sizeof(double));
-                                }
-                    }
-                    catch (const std::ifstream::failure& e)
-                    {
-                            LOG(WARNING) << "Exception writing observables dump file " << e.what();
-                    }
+                    std::vector<double> record(3 * d_nchannels, 0.0);
+                    for (unsigned int i = 0; i < d_nchannels; i++)
+                        {
+                            record[3 * i] = in[i][0].Pseudorange_m;
+                            record[3 * i + 2] = d_rx_time;
+                        }
+                    d_output_writer->post([this, record]()
+                            {
+                                d_dump_file.put(record.data(), record.size());
+                                d_dump_file.end_record();
+                            });
                 }
         }
 
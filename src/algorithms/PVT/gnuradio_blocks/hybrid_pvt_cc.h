@@ -47,12 +47,17 @@
 #include "gps_ephemeris.h"
 #include "gps_utc_model.h"
 #include "gps_iono.h"
+#include "gnss_dump_writer.h"
 #include "nmea_printer.h"
 #include "kml_printer.h"
 #include "rinex_printer.h"
+#include "rtcm_printer.h"
+#include "pvt_output_writer.h"
+#include "pvt_stream_server.h"
 #include "hybrid_ls_pvt.h"
 #include "GPS_L1_CA.h"
 #include "Galileo_E1.h"
+#include "gnss_block_counters.h"
 
 class hybrid_pvt_cc;
 
@@ -103,25 +108,74 @@ private:
     std::shared_ptr<Rinex_Printer> rp;
     unsigned int d_nchannels;
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Gnss_Dump_Writer d_dump_file;
     int d_averaging_depth;
     bool d_flag_averaging;
     int d_output_rate_ms;
     int d_display_rate_ms;
+    int d_input_rate_ms;
     long unsigned int d_sample_counter;
     long unsigned int valid_solution_counter;
     long unsigned int valid_solution_16_sat_counter;
     long unsigned int d_last_sample_nav_output;
+    long unsigned int d_last_sample_rtcm_output;
+    long unsigned int d_last_sample_fix_output;
     std::shared_ptr<Kml_Printer> d_kml_dump;
     std::shared_ptr<Nmea_Printer> d_nmea_printer;
+    std::shared_ptr<Pvt_Output_Writer> d_output_writer;
+    std::shared_ptr<Rtcm_Printer> d_rtcm_printer;
+    std::shared_ptr<Pvt_Stream_Server> d_rtcm_server;
+    unsigned int d_rtcm_observables;
     double d_rx_time;
     double d_TOW_at_curr_symbol_constellation;
     std::shared_ptr<hybrid_ls_pvt> d_ls_pvt;
+    // versions of the global navigation data maps already copied into d_ls_pvt
+    unsigned long int d_galileo_ephemeris_version;
+    unsigned long int d_galileo_utc_model_version;
+    unsigned long int d_galileo_iono_version;
+    unsigned long int d_galileo_almanac_version;
+    bool d_galileo_almanac_arrived;
+    unsigned long int d_gps_ephemeris_version;
+    unsigned long int d_gps_utc_model_version;
+    unsigned long int d_gps_iono_version;
+    void add_output_flush();
     bool pseudoranges_pairCompare_min(std::pair<int,Gnss_Synchro> a, std::pair<int,Gnss_Synchro> b);
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
     ~hybrid_pvt_cc (); //!< Default destructor
 
+    /*!
+     * \brief Sets the number of observables epochs between two consecutive input items
+     * (i.e., the Observables output_rate_ms), so that the PVT epoch counter keeps track of receiver time
+     */
+    void set_input_rate_ms(int input_rate_ms);
+
+    /*!
+     * \brief Sets the maximum number of records waiting for the output writer thread, and
+     * whether new records are dropped (true) or the block waits (false) when it is full
+     */
+    void set_output_queue(unsigned int queue_size, bool drop_when_full);
+
+    /*!
+     * \brief Streams RTCM 3 observables (\p observables_type 1001 to 1004, MSM 4 or 7) at the output rate, ephemeris and antenna
+     * position to the TCP clients connected to \p port of \p address, each one with a queue of up to
+     * \p client_queue_size messages
+     */
+    void set_rtcm_server(const std::string& address, unsigned short port, unsigned int station_id, unsigned int client_queue_size, unsigned int observables_type);
+
+    /*!
+     * \brief Computes the positions with the Kalman filter (true) or with epoch-wise
+     * Least Squares (false), see the set_ekf method of the PVT library
+     */
+    void set_ekf(bool flag_ekf, double pseudorange_sigma_m, double acceleration_psd);
+
+    /*!
+     * \brief Computes the Least Squares positions with the former Armadillo solver,
+     * see the set_ls_armadillo method of the PVT library
+     */
+    void set_ls_armadillo(bool flag_ls_armadillo);
+
     int general_work (int noutput_items, gr_vector_int &ninput_items,
             gr_vector_const_void_star &input_items, gr_vector_void_star &output_items); //!< PVT Signal Processing
 };
@@ -48,21 +48,30 @@ gps_l1_ca_ls_pvt::gps_l1_ca_ls_pvt(int nchannels,std::string dump_filename, bool
     d_averaging_depth = 0;
     d_GPS_current_time = 0;
     b_valid_position = false;
+    d_flag_ekf = false;
+    d_flag_ls_armadillo = false;
     // ############# ENABLE DATA FILE LOG #################
     if (d_flag_dump_enabled == true)
         {
             if (d_dump_file.is_open() == false)
                 {
-                    try
-                    {
-                            d_dump_file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-                            d_dump_file.open(d_dump_filename.c_str(), std::ios::out | std::ios::binary);
-                            LOG(INFO) << "PVT lib dump enabled Log file: " << d_dump_filename.c_str();
-                    }
-                    catch (std::ifstream::failure e)
-                    {
-                            LOG(WARNING) << "Exception opening PVT lib dump file " << e.what();
-                    }
+                    d_dump_file.set_attribute("source", "gps_l1_ca_ls_pvt");
+                    d_dump_file.add_field<double>("rx_time_s");
+                    d_dump_file.add_field<double>("x_m");
+                    d_dump_file.add_field<double>("y_m");
+                    d_dump_file.add_field<double>("z_m");
+                    d_dump_file.add_field<double>("clock_offset");
+                    d_dump_file.add_field<double>("latitude_deg");
+                    d_dump_file.add_field<double>("longitude_deg");
+                    d_dump_file.add_field<double>("height_m");
+                    if (d_dump_file.open(d_dump_filename))
+                        {
+                            LOG(INFO) << "PVT lib dump enabled Log file: " << d_dump_filename;
+                        }
+                    else
+                        {
+                            LOG(WARNING) << "Unable to open PVT lib dump file " << d_dump_filename;
+                        }
                 }
         }
 }
@@ -74,172 +83,32 @@ void gps_l1_ca_ls_pvt::set_averaging_depth(int depth)
 }
 
 
-gps_l1_ca_ls_pvt::~gps_l1_ca_ls_pvt()
+void gps_l1_ca_ls_pvt::set_ekf(bool flag_ekf, double pseudorange_sigma_m, double acceleration_psd)
 {
-    d_dump_file.close();
-    delete[] d_ephemeris;
+    d_flag_ekf = flag_ekf;
+    d_ekf.pseudorange_sigma_m = pseudorange_sigma_m;
+    d_ekf.acceleration_psd = acceleration_psd;
+    d_ekf.reset();
 }
 
 
-arma::vec gps_l1_ca_ls_pvt::rotateSatellite(double traveltime, arma::vec X_sat)
+void gps_l1_ca_ls_pvt::set_ls_armadillo(bool flag_ls_armadillo)
 {
-    /*
-     *  Returns rotated satellite ECEF coordinates due to Earth
-     * rotation during signal travel time
-     *
-     *   Inputs:
-     *       travelTime  - signal travel time
-     *       X_sat       - satellite's ECEF coordinates
-     *
-     *   Returns:
-     *       X_sat_rot   - rotated satellite's coordinates (ECEF)
-     */
-
-    //--- Find rotation angle --------------------------------------------------
-    double omegatau;
-    omegatau = OMEGA_EARTH_DOT * traveltime;
-
-    //--- Build a rotation matrix ----------------------------------------------
-    arma::mat R3 = arma::zeros(3,3);
-    R3(0, 0) = cos(omegatau);
-    R3(0, 1) = sin(omegatau);
-    R3(0, 2) = 0.0;
-    R3(1, 0) = -sin(omegatau);
-    R3(1, 1) = cos(omegatau);
-    R3(1, 2) = 0.0;
-    R3(2, 0) = 0.0;
-    R3(2, 1) = 0.0;
-    R3(2, 2) = 1.0;
-
-    //--- Do the rotation ------------------------------------------------------
-    arma::vec X_sat_rot;
-    X_sat_rot = R3 * X_sat;
-    return X_sat_rot;
+    d_flag_ls_armadillo = flag_ls_armadillo;
 }
 
 
-arma::vec gps_l1_ca_ls_pvt::leastSquarePos(arma::mat satpos, arma::vec obs, arma::mat w)
+gps_l1_ca_ls_pvt::~gps_l1_ca_ls_pvt()
 {
-    /* Computes the Least Squares Solution.
-     *   Inputs:
-     *       satpos      - Satellites positions in ECEF system: [X; Y; Z;]
-     *       obs         - Observations - the pseudorange measurements to each satellite
-     *       w           - weigths vector
-     *
-     *   Returns:
-     *       pos         - receiver position and receiver clock error
-     *                   (in ECEF system: [X, Y, Z, dt])
-     */
-
-    //=== Initialization =======================================================
-    int nmbOfIterations = 10; // TODO: include in config
-    int nmbOfSatellites;
-    nmbOfSatellites = satpos.n_cols;	//Armadillo
-    arma::vec pos = "0.0 0.0 0.0 0.0";
-    arma::mat A;
-    arma::mat omc;
-    arma::mat az;
-    arma::mat el;
-    A = arma::zeros(nmbOfSatellites, 4);
-    omc = arma::zeros(nmbOfSatellites, 1);
-    az = arma::zeros(1, nmbOfSatellites);
-    el = arma::zeros(1, nmbOfSatellites);
-    arma::mat X = satpos;
-    arma::vec Rot_X;
-    double rho2;
-    double traveltime;
-    double trop = 0.0;
-    double dlambda;
-    double dphi;
-    double h;
-    arma::mat mat_tmp;
-    arma::vec x;
-
-    //=== Iteratively find receiver position ===================================
-    for (int iter = 0; iter < nmbOfIterations; iter++)
-        {
-            for (int i = 0; i < nmbOfSatellites; i++)
-                {
-                    if (iter == 0)
-                        {
-                            //--- Initialize variables at the first iteration --------------
-                            Rot_X = X.col(i); //Armadillo
-                            trop = 0.0;
-                        }
-                    else
-                        {
-                            //--- Update equations -----------------------------------------
-                            rho2 = (X(0, i) - pos(0)) * (X(0, i) - pos(0))
-                                 + (X(1, i) - pos(1)) * (X(1, i) - pos(1))
-                                 + (X(2, i) - pos(2)) * (X(2, i) - pos(2));
-                            traveltime = sqrt(rho2) / GPS_C_m_s;
-
-                            //--- Correct satellite position (do to earth rotation) --------
-                            Rot_X = rotateSatellite(traveltime, X.col(i)); //armadillo
-
-                            //--- Find satellites' DOA
-                            topocent(&d_visible_satellites_Az[i], &d_visible_satellites_El[i],
-                                    &d_visible_satellites_Distance[i], pos.subvec(0,2), Rot_X - pos.subvec(0,2));
-
-                            if(FLAGS_tropo)
-                                {                         
-                                    if(traveltime < 0.1 && nmbOfSatellites > 3)
-                                        {
-                                            //--- Find receiver's height
-                                            togeod(&dphi, &dlambda, &h, 6378137.0, 298.257223563, pos(0), pos(1), pos(2));
-
-                                            //--- Find delay due to troposphere (in meters)
-                                            tropo(&trop, sin(d_visible_satellites_El[i] * GPS_PI / 180.0), h / 1000, 1013.0, 293.0, 50.0, 0.0, 0.0, 0.0);
-                                            if(trop > 50.0 ) trop = 0.0;
-                                        }
-                                }
-                        }
-
-
-                    //--- Apply the corrections ----------------------------------------
-                    omc(i) = (obs(i) - norm(Rot_X - pos.subvec(0,2),2) - pos(3) - trop); // Armadillo
-
-                    //--- Construct the A matrix ---------------------------------------
-                    //Armadillo
-                    A(i,0) = (-(Rot_X(0) - pos(0))) / obs(i);
-                    A(i,1) = (-(Rot_X(1) - pos(1))) / obs(i);
-                    A(i,2) = (-(Rot_X(2) - pos(2))) / obs(i);
-                    A(i,3) = 1.0;
-                }
-
-            //--- Find position update ---------------------------------------------
-            x = arma::solve(w*A, w*omc); // Armadillo
-
-            //--- Apply position update --------------------------------------------
-            pos = pos + x;
-            if (arma::norm(x, 2) < 1e-4)
-                {
-                    break; // exit the loop because we assume that the LS algorithm has converged (err < 0.1 cm)
-                }
-        }
-
-    try
-    {
-            //-- compute the Dilution Of Precision values
-            d_Q = arma::inv(arma::htrans(A)*A);
-    }
-    catch(std::exception& e)
-    {
-            d_Q = arma::zeros(4, 4);
-    }
-    return pos;
+    d_dump_file.close();
+    delete[] d_ephemeris;
 }
 
 
-bool gps_l1_ca_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map, double GPS_current_time, bool flag_averaging)
+bool gps_l1_ca_ls_pvt::get_PVT(const std::map<int,Gnss_Synchro>& gnss_pseudoranges_map, double GPS_current_time, bool flag_averaging)
 {
-    std::map<int,Gnss_Synchro>::iterator gnss_pseudoranges_iter;
+    std::map<int,Gnss_Synchro>::const_iterator gnss_pseudoranges_iter;
     std::map<int,Gps_Ephemeris>::iterator gps_ephemeris_iter;
-    int valid_pseudoranges = gnss_pseudoranges_map.size();
-
-    arma::mat W = arma::eye(valid_pseudoranges, valid_pseudoranges); //channels weights matrix
-    arma::vec obs = arma::zeros(valid_pseudoranges);                 // pseudoranges observation vector
-    arma::mat satpos = arma::zeros(3, valid_pseudoranges);           //satellite positions matrix
 
     int GPS_week = 0;
     double utc = 0;
@@ -252,7 +121,9 @@ bool gps_l1_ca_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map,
     // ****** PREPARE THE LEAST SQUARES DATA (SV POSITIONS MATRIX AND OBS VECTORS) ****
     // ********************************************************************************
     int valid_obs = 0; //valid observations counter
-    int obs_counter = 0;
+    d_ls_solver.clear();
+    d_ls_armadillo.clear();
+    d_ekf.clear();
     for(gnss_pseudoranges_iter = gnss_pseudoranges_map.begin();
             gnss_pseudoranges_iter != gnss_pseudoranges_map.end();
             gnss_pseudoranges_iter++)
@@ -264,7 +135,6 @@ bool gps_l1_ca_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map,
                     /*!
                      * \todo Place here the satellite CN0 (power level, or weight factor)
                      */
-                    W(obs_counter, obs_counter) = 1;
 
                     // COMMON RX TIME PVT ALGORITHM MODIFICATION (Like RINEX files)
                     // first estimate of transmit time
@@ -272,28 +142,31 @@ bool gps_l1_ca_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map,
                     double Tx_time = Rx_time - gnss_pseudoranges_iter->second.Pseudorange_m / GPS_C_m_s;
 
                     // 2- compute the clock drift using the clock model (broadcast) for this SV, including relativistic effect
-                    SV_clock_bias_s = gps_ephemeris_iter->second.sv_clock_drift(Tx_time); //- gps_ephemeris_iter->second.d_TGD;
+                    SV_clock_bias_s = d_gps_orbit_cache.sv_clock_drift(gps_ephemeris_iter->second, Tx_time); //- gps_ephemeris_iter->second.d_TGD;
 
                     // 3- compute the current ECEF position for this SV using corrected TX time
                     TX_time_corrected_s = Tx_time - SV_clock_bias_s;
-                    gps_ephemeris_iter->second.satellitePosition(TX_time_corrected_s);
-
-                    satpos(0, obs_counter) = gps_ephemeris_iter->second.d_satpos_X;
-                    satpos(1, obs_counter) = gps_ephemeris_iter->second.d_satpos_Y;
-                    satpos(2, obs_counter) = gps_ephemeris_iter->second.d_satpos_Z;
+                    d_gps_orbit_cache.satellitePosition(gps_ephemeris_iter->second, TX_time_corrected_s);
 
                     // 4- fill the observations vector with the corrected pseudoranges
-                    obs(obs_counter) = gnss_pseudoranges_iter->second.Pseudorange_m + SV_clock_bias_s * GPS_C_m_s;
+                    double pseudorange_corrected_m = gnss_pseudoranges_iter->second.Pseudorange_m + SV_clock_bias_s * GPS_C_m_s;
+                    if (d_ls_solver.add_observation(gps_ephemeris_iter->second.d_satpos_X, gps_ephemeris_iter->second.d_satpos_Y, gps_ephemeris_iter->second.d_satpos_Z, pseudorange_corrected_m, 1.0) == false)
+                        {
+                            LOG(WARNING) << "More than " << PVT_MAX_CHANNELS << " observations, the rest of the satellites are not used";
+                            break;
+                        }
+                    d_ls_armadillo.add_observation(gps_ephemeris_iter->second.d_satpos_X, gps_ephemeris_iter->second.d_satpos_Y, gps_ephemeris_iter->second.d_satpos_Z, pseudorange_corrected_m, 1.0);
+                    d_ekf.add_observation(gps_ephemeris_iter->second.d_satpos_X, gps_ephemeris_iter->second.d_satpos_Y, gps_ephemeris_iter->second.d_satpos_Z, pseudorange_corrected_m, 0);
                     d_visible_satellites_IDs[valid_obs] = gps_ephemeris_iter->second.i_satellite_PRN;
                     d_visible_satellites_CN0_dB[valid_obs] = gnss_pseudoranges_iter->second.CN0_dB_hz;
                     valid_obs++;
 
                     // SV ECEF DEBUG OUTPUT
-                    LOG(INFO) << "(new)ECEF satellite SV ID=" << gps_ephemeris_iter->second.i_satellite_PRN
+                    DLOG(INFO) << "(new)ECEF satellite SV ID=" << gps_ephemeris_iter->second.i_satellite_PRN
                             << " X=" << gps_ephemeris_iter->second.d_satpos_X
                             << " [m] Y=" << gps_ephemeris_iter->second.d_satpos_Y
                             << " [m] Z=" << gps_ephemeris_iter->second.d_satpos_Z
-                            << " [m] PR_obs=" << obs(obs_counter) << " [m]";
+                            << " [m] PR_obs=" << pseudorange_corrected_m << " [m]";
 
                     // compute the UTC time for this SV (just to print the associated UTC timestamp)
                     GPS_week = gps_ephemeris_iter->second.i_GPS_week;
@@ -302,34 +175,98 @@ bool gps_l1_ca_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map,
             else // the ephemeris are not available for this SV
                 {
                     // no valid pseudorange for the current SV
-                    W(obs_counter, obs_counter) = 0; // SV de-activated
-                    obs(obs_counter) = 1;            // to avoid algorithm problems (divide by zero)
                     DLOG(INFO) << "No ephemeris data for SV " << gnss_pseudoranges_iter->first;
                 }
-            obs_counter++;
         }
 
     // ********************************************************************************
     // ****** SOLVE LEAST SQUARES******************************************************
     // ********************************************************************************
     d_valid_observations = valid_obs;
-    LOG(INFO) << "(new)PVT: valid observations=" << valid_obs;
+    DLOG(INFO) << "(new)PVT: valid observations=" << valid_obs;
 
     if (valid_obs >= 4)
         {
-            arma::vec mypos;
-            LOG(INFO) << "satpos=" << satpos;
-            LOG(INFO) << "obs=" << obs;
-            LOG(INFO) << "W=" << W;
-            mypos = leastSquarePos(satpos, obs, W);
-            LOG(INFO) << "(new)Position at TOW=" << GPS_current_time << " in ECEF (X,Y,Z) = " << mypos;
+            arma::vec::fixed<4> mypos;
+            d_ls_solver.tropo_enabled = FLAGS_tropo;
+            d_ls_armadillo.tropo_enabled = FLAGS_tropo;
+            d_ekf.tropo_enabled = FLAGS_tropo;
+            bool ekf_fix = false;
+            if (d_flag_ekf and d_ekf.initialized())
+                {
+                    ekf_fix = d_ekf.update(GPS_current_time, mypos.memptr());
+                    if (ekf_fix == false)
+                        {
+                            LOG(WARNING) << "Restarting the PVT Kalman filter from a Least Squares fix (" << d_ekf.rejected
+                                         << " out of " << valid_obs << " observations rejected)";
+                            d_ekf.reset();
+                        }
+                }
+            if (ekf_fix == true)
+                {
+                    for (int i = 0; i < valid_obs; i++)
+                        {
+                            d_visible_satellites_Az[i] = d_ekf.az_deg[i];
+                            d_visible_satellites_El[i] = d_ekf.el_deg[i];
+                            d_visible_satellites_Distance[i] = d_ekf.distance_m[i];
+                        }
+                    d_Q = arma::mat(&d_ekf.Q[0][0], 4, 4);
+                }
+            else
+                {
+                    bool ls_fix;
+                    const double* ls_az_deg;
+                    const double* ls_el_deg;
+                    const double* ls_distance_m;
+                    const double* ls_Q;
+                    if (d_flag_ls_armadillo == true)
+                        {
+                            ls_fix = d_ls_armadillo.solve(mypos.memptr());
+                            ls_az_deg = d_ls_armadillo.az_deg;
+                            ls_el_deg = d_ls_armadillo.el_deg;
+                            ls_distance_m = d_ls_armadillo.distance_m;
+                            ls_Q = &d_ls_armadillo.Q[0][0];
+                        }
+                    else
+                        {
+                            ls_fix = d_ls_solver.solve(mypos.memptr());
+                            ls_az_deg = d_ls_solver.az_deg;
+                            ls_el_deg = d_ls_solver.el_deg;
+                            ls_distance_m = d_ls_solver.distance_m;
+                            ls_Q = &d_ls_solver.Q[0][0];
+                        }
+                    if (ls_fix == false)
+                        {
+                            LOG(WARNING) << "Singular geometry in the PVT least squares solution";
+                            b_valid_position = false;
+                            return false;
+                        }
+                    for (int i = 0; i < valid_obs; i++)
+                        {
+                            d_visible_satellites_Az[i] = ls_az_deg[i];
+                            d_visible_satellites_El[i] = ls_el_deg[i];
+                            d_visible_satellites_Distance[i] = ls_distance_m[i];
+                        }
+                    d_Q = arma::mat(ls_Q, 4, 4); // symmetric, the storage order does not matter
+                }
+            VLOG(1) << "(new)Position at TOW=" << GPS_current_time << " in ECEF (X,Y,Z) = " << mypos;
+            d_x_m = mypos(0);
+            d_y_m = mypos(1);
+            d_z_m = mypos(2);
             gps_l1_ca_ls_pvt::cart2geo(mypos(0), mypos(1), mypos(2), 4);
             //ToDo: Find an Observables/PVT random bug with some satellite configurations that gives an erratic PVT solution (i.e. height>50 km)
             if (d_height_m > 50000)
-            {
-            	b_valid_position = false;
-            	return false;
-            }
+                {
+                    d_ls_solver.reset(); // do not warm-start from an erratic solution
+                    d_ekf.reset();
+                    b_valid_position = false;
+                    return false;
+                }
+            set_rx_clock(mypos(3), GPS_current_time, ekf_fix, d_ekf.state[7]);
+            if (d_flag_ekf == true and ekf_fix == false)
+                {
+                    d_ekf.initialize(mypos.memptr(), GPS_current_time);
+                }
             // Compute UTC time and print PVT solution
             double secondsperweek = 604800.0; // number of seconds in one week (7*24*60*60)
             boost::posix_time::time_duration t = boost::posix_time::seconds(utc + secondsperweek * static_cast<double>(GPS_week));
@@ -337,9 +274,9 @@ bool gps_l1_ca_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map,
             boost::posix_time::ptime p_time(boost::gregorian::date(1999, 8, 22), t);
             d_position_UTC_time = p_time;
 
-            LOG(INFO) << "(new)Position at " << boost::posix_time::to_simple_string(p_time)
-                      << " is Lat = " << d_latitude_d << " [deg], Long = " << d_longitude_d
-                      << " [deg], Height= " << d_height_m << " [m]";
+            VLOG(1) << "(new)Position at " << boost::posix_time::to_simple_string(p_time)
+                    << " is Lat = " << d_latitude_d << " [deg], Long = " << d_longitude_d
+                    << " [deg], Height= " << d_height_m << " [m]";
 
             // ###### Compute DOPs ########
 
@@ -384,38 +321,23 @@ bool gps_l1_ca_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map,
             if(d_flag_dump_enabled == true)
                 {
                     // MULTIPLEXED FILE RECORDING - Record results to file
-                    try
-                    {
-                            double tmp_double;
-                            //  PVT GPS time
-                            tmp_double = GPS_current_time;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // ECEF User Position East [m]
-                            tmp_double = mypos(0);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // ECEF User Position North [m]
-                            tmp_double = mypos(1);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // ECEF User Position Up [m]
-                            tmp_double = mypos(2);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // User clock offset [s]
-                            tmp_double = mypos(3);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // GEO user position Latitude [deg]
-                            tmp_double = d_latitude_d;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // GEO user position Longitude [deg]
-                            tmp_double = d_longitude_d;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // GEO user position Height [m]
-                            tmp_double = d_height_m;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                    }
-                    catch (std::ifstream::failure e)
-                    {
-                            LOG(WARNING) << "Exception writing PVT LS dump file " << e.what();
-                    }
+                    //  PVT GPS time
+                    d_dump_file.put<double>(GPS_current_time);
+                    // ECEF User Position East [m]
+                    d_dump_file.put<double>(mypos(0));
+                    // ECEF User Position North [m]
+                    d_dump_file.put<double>(mypos(1));
+                    // ECEF User Position Up [m]
+                    d_dump_file.put<double>(mypos(2));
+                    // User clock offset [s]
+                    d_dump_file.put<double>(mypos(3));
+                    // GEO user position Latitude [deg]
+                    d_dump_file.put<double>(d_latitude_d);
+                    // GEO user position Longitude [deg]
+                    d_dump_file.put<double>(d_longitude_d);
+                    // GEO user position Height [m]
+                    d_dump_file.put<double>(d_height_m);
+                    d_dump_file.end_record();
                 }
 
             // MOVING AVERAGE PVT
@@ -519,296 +441,3 @@ void gps_l1_ca_ls_pvt::cart2geo(double X, double Y, double Z, int elipsoid_selec
     d_longitude_d = lambda * 180 / GPS_PI;
     d_height_m = h;
 }
-
-
-void gps_l1_ca_ls_pvt::togeod(double *dphi, double *dlambda, double *h, double a, double finv, double X, double Y, double Z)
-{
-    /* Subroutine to calculate geodetic coordinates latitude, longitude,
-	height given Cartesian coordinates X,Y,Z, and reference ellipsoid
-	values semi-major axis (a) and the inverse of flattening (finv).
-
-	 The output units of angular quantities will be in decimal degrees
-	  (15.5 degrees not 15 deg 30 min). The output units of h will be the
-	  same as the units of X,Y,Z,a.
-
-	   Inputs:
-	       a           - semi-major axis of the reference ellipsoid
-	       finv        - inverse of flattening of the reference ellipsoid
-	       X,Y,Z       - Cartesian coordinates
-
-	   Outputs:
-	       dphi        - latitude
-	       dlambda     - longitude
-	       h           - height above reference ellipsoid
-
-	       Based in a Matlab function by Kai Borre
-     */
-
-    *h = 0;
-    double tolsq = 1.e-10;  // tolerance to accept convergence
-    int maxit = 10;         // max number of iterations
-    double rtd = 180/GPS_PI;
-
-    // compute square of eccentricity
-    double esq;
-    if (finv < 1.0E-20)
-        {
-            esq = 0;
-        }
-    else
-        {
-            esq = (2 - 1/finv) / finv;
-        }
-
-    // first guess
-
-    double P = sqrt(X*X + Y*Y); // P is distance from spin axis
-    //direct calculation of longitude
-    if (P > 1.0E-20)
-        {
-            *dlambda = atan2(Y,X) * rtd;
-        }
-    else
-        {
-            *dlambda = 0;
-        }
-    // correct longitude bound
-    if (*dlambda < 0)
-        {
-            *dlambda = *dlambda + 360.0;
-        }
-    double r = sqrt(P * P + Z * Z); // r is distance from origin (0,0,0)
-
-    double sinphi;
-    if (r > 1.0E-20)
-        {
-            sinphi = Z/r;
-        }
-    else
-        {
-            sinphi = 0;
-        }
-    *dphi = asin(sinphi);
-
-    // initial value of height  =  distance from origin minus
-    // approximate distance from origin to surface of ellipsoid
-    if (r < 1.0E-20)
-        {
-            *h = 0;
-            return;
-        }
-
-    *h = r - a * (1 - sinphi * sinphi / finv);
-
-    // iterate
-    double cosphi;
-    double N_phi;
-    double dP;
-    double dZ;
-    double oneesq = 1 - esq;
-
-    for (int i = 0; i < maxit; i++)
-        {
-            sinphi = sin(*dphi);
-            cosphi = cos(*dphi);
-
-            // compute radius of curvature in prime vertical direction
-            N_phi = a / sqrt(1 - esq * sinphi * sinphi);
-
-            // compute residuals in P and Z
-            dP = P - (N_phi + (*h)) * cosphi;
-            dZ = Z - (N_phi*oneesq + (*h)) * sinphi;
-
-            // update height and latitude
-            *h = *h + (sinphi * dZ + cosphi * dP);
-            *dphi = *dphi + (cosphi * dZ - sinphi * dP)/(N_phi + (*h));
-
-            //     test for convergence
-            if ((dP * dP + dZ * dZ) < tolsq)
-                {
-                    break;
-                }
-            if (i == (maxit - 1))
-                {
-                    LOG(WARNING) << "The computation of geodetic coordinates did not converge";
-                }
-        }
-    *dphi = (*dphi) * rtd;
-}
-
-
-void gps_l1_ca_ls_pvt::topocent(double *Az, double *El, double *D, arma::vec x, arma::vec dx)
-{
-    /*  Transformation of vector dx into topocentric coordinate
-	system with origin at x
-	   Inputs:
-	      x           - vector origin coordinates (in ECEF system [X; Y; Z;])
-	      dx          - vector ([dX; dY; dZ;]).
-
-	   Outputs:
-	      D           - vector length. Units like the input
-	      Az          - azimuth from north positive clockwise, degrees
-	      El          - elevation angle, degrees
-
-	      Based on a Matlab function by Kai Borre
-     */
-
-    double lambda;
-    double phi;
-    double h;
-    double dtr = GPS_PI / 180.0;
-    double a = 6378137.0;          // semi-major axis of the reference ellipsoid WGS-84
-    double finv = 298.257223563;   // inverse of flattening of the reference ellipsoid WGS-84
-
-    // Transform x into geodetic coordinates
-    togeod(&phi, &lambda, &h, a, finv, x(0), x(1), x(2));
-
-    double cl = cos(lambda * dtr);
-    double sl = sin(lambda * dtr);
-    double cb = cos(phi * dtr);
-    double sb = sin(phi * dtr);
-
-    arma::mat F = arma::zeros(3,3);
-
-    F(0,0) = -sl;
-    F(0,1) = -sb * cl;
-    F(0,2) = cb * cl;
-
-    F(1,0) = cl;
-    F(1,1) = -sb * sl;
-    F(1,2) = cb * sl;
-
-    F(2,0) = 0;
-    F(2,1) = cb;
-    F(2,2) = sb;
-
-    arma::vec local_vector;
-
-    local_vector = arma::htrans(F) * dx;
-
-    double E = local_vector(0);
-    double N = local_vector(1);
-    double U = local_vector(2);
-
-    double hor_dis;
-    hor_dis = sqrt(E * E + N * N);
-
-    if (hor_dis < 1.0E-20)
-        {
-            *Az = 0;
-            *El = 90;
-        }
-    else
-        {
-            *Az = atan2(E, N) / dtr;
-            *El = atan2(U, hor_dis) / dtr;
-        }
-
-    if (*Az < 0)
-        {
-            *Az = *Az + 360.0;
-        }
-
-    *D = sqrt(dx(0) * dx(0) + dx(1) * dx(1) + dx(2) * dx(2));
-}
-
-
-void gps_l1_ca_ls_pvt::tropo(double *ddr_m, double sinel, double hsta_km, double p_mb, double t_kel, double hum, double hp_km, double htkel_km, double hhum_km)
-{
-    /*   Inputs:
-           sinel     - sin of elevation angle of satellite
-           hsta_km   - height of station in km
-           p_mb      - atmospheric pressure in mb at height hp_km
-           t_kel     - surface temperature in degrees Kelvin at height htkel_km
-           hum       - humidity in % at height hhum_km
-           hp_km     - height of pressure measurement in km
-           htkel_km  - height of temperature measurement in km
-           hhum_km   - height of humidity measurement in km
-
-       Outputs:
-           ddr_m     - range correction (meters)
-
-     Reference
-     Goad, C.C. & Goodman, L. (1974) A Modified Hopfield Tropospheric
-     Refraction Correction Model. Paper presented at the
-     American Geophysical Union Annual Fall Meeting, San
-     Francisco, December 12-17
-
-     Translated to C++ by Carles Fernandez from a Matlab implementation by Kai Borre
-     */
-
-    const double a_e    = 6378.137;    // semi-major axis of earth ellipsoid
-    const double b0     = 7.839257e-5;
-    const double tlapse = -6.5;
-    const double em     = -978.77 / (2.8704e6 * tlapse * 1.0e-5);
-
-    double tkhum  = t_kel + tlapse * (hhum_km - htkel_km);
-    double atkel  = 7.5 * (tkhum - 273.15) / (237.3 + tkhum - 273.15);
-    double e0     = 0.0611 * hum * pow(10, atkel);
-    double tksea  = t_kel - tlapse * htkel_km;
-    double tkelh  = tksea + tlapse * hhum_km;
-    double e0sea  = e0 * pow((tksea / tkelh), (4 * em));
-    double tkelp  = tksea + tlapse * hp_km;
-    double psea   = p_mb * pow((tksea / tkelp), em);
-
-    if(sinel < 0) { sinel = 0.0; }
-
-    double tropo_delay   = 0.0;
-    bool done      = false;
-    double refsea  = 77.624e-6 / tksea;
-    double htop    = 1.1385e-5 / refsea;
-    refsea         = refsea * psea;
-    double ref     = refsea * pow(((htop - hsta_km) / htop), 4);
-
-    double a;
-    double b;
-    double rtop;
-
-    while(1)
-        {
-            rtop = pow((a_e + htop), 2) - pow((a_e + hsta_km), 2) * (1 - pow(sinel, 2));
-
-            // check to see if geometry is crazy
-            if(rtop < 0) { rtop = 0; }
-
-            rtop = sqrt(rtop) - (a_e + hsta_km) * sinel;
-
-            a    = -sinel / (htop - hsta_km);
-            b    = -b0 * (1 - pow(sinel,2)) / (htop - hsta_km);
-
-            arma::vec rn = arma::vec(8);
-            rn.zeros();
-
-            for(int i = 0; i<8; i++)
-                {
-                    rn(i) = pow(rtop, (i+1+1));
-
-                }
-
-            arma::rowvec alpha = {2 * a, 2 * pow(a, 2) + 4 * b /3, a * (pow(a, 2) + 3 * b),
-                    pow(a, 4)/5 + 2.4 * pow(a, 2) * b + 1.2 * pow(b, 2), 2 * a * b * (pow(a, 2) + 3 * b)/3,
-                    pow(b, 2) * (6 * pow(a, 2) + 4 * b) * 1.428571e-1, 0, 0};
-
-            if(pow(b, 2) > 1.0e-35)
-                {
-                    alpha(6) = a * pow(b, 3) /2;
-                    alpha(7) = pow(b, 4) / 9;
-                }
-
-            double dr = rtop;
-            arma::mat aux_ = alpha * rn;
-            dr = dr + aux_(0, 0);
-            tropo_delay = tropo_delay + dr * ref * 1000;
-
-            if(done == true)
-                {
-                    *ddr_m = tropo_delay;
-                    break;
-                }
-
-            done    = true;
-            refsea  = (371900.0e-6 / tksea - 12.92e-6) / tksea;
-            htop    = 1.1385e-5 * (1255 / tksea + 0.05) / refsea;
-            ref     = refsea * e0sea * pow(((htop - hsta_km) / htop), 4);
-        }
-}
@@ -48,35 +48,33 @@
 #include "GPS_L1_CA.h"
 #include "galileo_navigation_message.h"
 #include "gps_navigation_message.h"
+#include "gnss_dump_writer.h"
 #include "gnss_synchro.h"
 #include "galileo_ephemeris.h"
 #include "galileo_utc_model.h"
 #include "gps_ephemeris.h"
 #include "gps_utc_model.h"
-
-#define PVT_MAX_CHANNELS 24
+#include "ls_pvt_armadillo.h"
+#include "ls_pvt_solver.h"
+#include "orbit_cache.h"
+#include "pvt_ekf.h"
+#include "pvt_solution.h"
 
 /*!
  * \brief This class implements a simple PVT Least Squares solution
  */
-class hybrid_ls_pvt
+class hybrid_ls_pvt : public Pvt_Solution
 {
 private:
-    arma::vec leastSquarePos(arma::mat satpos, arma::vec obs, arma::mat w);
-    arma::vec rotateSatellite(double traveltime, arma::vec X_sat);
-    void topocent(double *Az, double *El, double *D, arma::vec x, arma::vec dx);
-    void togeod(double *dphi, double *dlambda, double *h, double a, double finv, double X, double Y, double Z);
-    void tropo(double *ddr_m, double sinel, double hsta_km, double p_mb, double t_kel, double hum, double hp_km, double htkel_km, double hhum_km);
+    Orbit_Cache<Galileo_Ephemeris> d_galileo_orbit_cache;   // polynomial fits of the Galileo orbits and clocks
+    Orbit_Cache<Gps_Ephemeris> d_gps_orbit_cache;   // polynomial fits of the GPS orbits and clocks
+    Ls_Pvt_Solver<PVT_MAX_CHANNELS> d_ls_solver;   // fixed-size least squares solver, warm-started from the last fix
+    Ls_Pvt_Armadillo<PVT_MAX_CHANNELS> d_ls_armadillo;   // former least squares solver, kept for comparison
+    Pvt_Ekf<PVT_MAX_CHANNELS> d_ekf;   // recursive alternative to the least squares solution
 public:
     int d_nchannels;                                        //!< Number of available channels for positioning
-    int d_valid_observations;                               //!< Number of valid pseudorange observations (valid satellites)
     int d_valid_GPS_obs;                                    //!< Number of valid GPS pseudorange observations (valid GPS satellites) -- used for hybrid configuration
     int d_valid_GAL_obs;                                    //!< Number of valid GALILEO pseudorange observations (valid GALILEO satellites) -- used for hybrid configuration
-    int d_visible_satellites_IDs[PVT_MAX_CHANNELS];         //!< Array with the IDs of the valid satellites
-    double d_visible_satellites_El[PVT_MAX_CHANNELS];       //!< Array with the LOS Elevation of the valid satellites
-    double d_visible_satellites_Az[PVT_MAX_CHANNELS];       //!< Array with the LOS Azimuth of the valid satellites
-    double d_visible_satellites_Distance[PVT_MAX_CHANNELS]; //!< Array with the LOS Distance of the valid satellites
-    double d_visible_satellites_CN0_dB[PVT_MAX_CHANNELS];   //!< Array with the IDs of the valid satellites
 
     Galileo_Navigation_Message* d_Gal_ephemeris;
     Gps_Navigation_Message* d_GPS_ephemeris;
@@ -91,46 +89,43 @@ public:
     Gps_Iono gps_iono;
 
     double d_galileo_current_time;
-    boost::posix_time::ptime d_position_UTC_time;
-    bool b_valid_position;
     int count_valid_position;
-    double d_latitude_d;  //!< Latitude in degrees
-    double d_longitude_d; //!< Longitude in degrees
-    double d_height_m;    //!< Height [m]
     //averaging
     std::deque<double> d_hist_latitude_d;
     std::deque<double> d_hist_longitude_d;
     std::deque<double> d_hist_height_m;
     int d_averaging_depth;    //!< Length of averaging window
-    double d_avg_latitude_d;  //!< Averaged latitude in degrees
-    double d_avg_longitude_d; //!< Averaged longitude in degrees
-    double d_avg_height_m;    //!< Averaged height [m]
-
-    double d_x_m;
-    double d_y_m;
-    double d_z_m;
 
     // DOP estimations
     arma::mat d_Q;
-    double d_GDOP;
-    double d_PDOP;
-    double d_HDOP;
-    double d_VDOP;
-    double d_TDOP;
 
     bool d_flag_dump_enabled;
-    bool d_flag_averaging;
+    bool d_flag_ekf;   //!< Positions from the Kalman filter instead of epoch-wise Least Squares
+    bool d_flag_ls_armadillo;   //!< Least Squares positions from the former Armadillo solver
 
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Gnss_Dump_Writer d_dump_file;
 
     void set_averaging_depth(int depth);
 
+    /*!
+     * \brief Selects the Kalman filter (true) or the Least Squares (false) solution,
+     * with the pseudorange noise standard deviation [m] and the acceleration
+     * power spectral density [m^2/s^3] of the filter
+     */
+    void set_ekf(bool flag_ekf, double pseudorange_sigma_m, double acceleration_psd);
+
+    /*!
+     * \brief Computes the Least Squares positions with the former Armadillo
+     * solver (true) instead of Ls_Pvt_Solver (false), to compare them
+     */
+    void set_ls_armadillo(bool flag_ls_armadillo);
+
     hybrid_ls_pvt(int nchannels,std::string dump_filename, bool flag_dump_to_file);
 
     ~hybrid_ls_pvt();
 
-    bool get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map, double hybrid_current_time, bool flag_averaging);
+    bool get_PVT(const std::map<int,Gnss_Synchro>& gnss_pseudoranges_map, double hybrid_current_time, bool flag_averaging);
 
     /*!
      * \brief Conversion of Cartesian coordinates (X,Y,Z) to geographical
@@ -82,7 +82,7 @@ bool Kml_Printer::set_headers(std::string filename)
 
 
 
-bool Kml_Printer::print_position(const std::shared_ptr<gps_l1_ca_ls_pvt>& position, bool print_average_values)
+bool Kml_Printer::print_position(const std::shared_ptr<Pvt_Solution>& position, bool print_average_values)
 {
     double latitude;
     double longitude;
@@ -116,7 +116,7 @@ bool Kml_Printer::print_position(const std::shared_ptr<gps_l1_ca_ls_pvt>& positi
 
 //ToDo: make the class ls_pvt generic and heritate the particular gps/gal/glo ls_pvt in order to
 // reuse kml_printer functions
-bool Kml_Printer::print_position_galileo(const std::shared_ptr<galileo_e1_ls_pvt>& position, bool print_average_values)
+bool Kml_Printer::print_position_galileo(const std::shared_ptr<Pvt_Solution>& position, bool print_average_values)
 {
     double latitude;
     double longitude;
@@ -146,7 +146,7 @@ bool Kml_Printer::print_position_galileo(const std::shared_ptr<galileo_e1_ls_pvt
         }
 }
 
-bool Kml_Printer::print_position_hybrid(const std::shared_ptr<hybrid_ls_pvt>& position, bool print_average_values)
+bool Kml_Printer::print_position_hybrid(const std::shared_ptr<Pvt_Solution>& position, bool print_average_values)
 {
     double latitude;
     double longitude;
@@ -0,0 +1,211 @@
+/*!
+ * \file ls_pvt_armadillo.h
+ * \brief Least Squares position solver on Armadillo matrices, as computed
+ * by the PVT libraries before Ls_Pvt_Solver
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_LS_PVT_ARMADILLO_H_
+#define GNSS_SDR_LS_PVT_ARMADILLO_H_
+
+#include <cmath>
+#include <exception>
+#include <armadillo>
+#include "GPS_L1_CA.h"
+#include "ls_pvt_solver.h"
+
+/*!
+ * \brief This class keeps the former leastSquarePos of the PVT libraries,
+ * selected with positioning_mode=LS_ARMADILLO, so that Ls_Pvt_Solver can be
+ * compared against it on recorded observables.
+ *
+ * Every epoch starts from the Earth center with no corrections, builds the
+ * n x 4 design matrix (divided by the pseudoranges) and solves it with
+ * arma::solve. The troposphere is only applied once the travel times are
+ * plausible. It has the interface of Ls_Pvt_Solver, except that reset()
+ * does nothing because there is no warm start.
+ */
+template<int MAX_OBS>
+class Ls_Pvt_Armadillo
+{
+public:
+    double az_deg[MAX_OBS];       //!< Azimuth of each observation at the solution [deg]
+    double el_deg[MAX_OBS];       //!< Elevation of each observation at the solution [deg]
+    double distance_m[MAX_OBS];   //!< Geometric range of each observation at the solution [m]
+    double Q[4][4];               //!< inv(A'A) at the solution, for the DOP computation
+    int iterations;               //!< Number of iterations used by the last solve()
+    bool tropo_enabled;           //!< Apply the troposphere model (default true)
+
+    Ls_Pvt_Armadillo()
+    {
+        d_n = 0;
+        iterations = 0;
+        tropo_enabled = true;
+        for (int i = 0; i < 4; i++)
+            {
+                for (int j = 0; j < 4; j++) Q[i][j] = 0.0;
+            }
+    }
+
+    //! Removes all the observations of the current epoch
+    void clear()
+    {
+        d_n = 0;
+    }
+
+    void reset()
+    {
+    }
+
+    int size() const
+    {
+        return d_n;
+    }
+
+    /*!
+     * \brief Adds a pseudorange observation (already corrected for the
+     * satellite clock) with the ECEF satellite position at transmission time.
+     * Returns false if MAX_OBS observations were already added.
+     */
+    bool add_observation(double sat_x, double sat_y, double sat_z, double pseudorange_m, double weight)
+    {
+        if (d_n >= MAX_OBS)
+            {
+                return false;
+            }
+        d_sat[d_n][0] = sat_x;
+        d_sat[d_n][1] = sat_y;
+        d_sat[d_n][2] = sat_z;
+        d_obs[d_n] = pseudorange_m;
+        d_w[d_n] = weight;
+        d_n++;
+        return true;
+    }
+
+    /*!
+     * \brief Computes the receiver position and clock offset [X, Y, Z, c*dt] (ECEF, meters).
+     * Returns false if there are less than 4 observations or arma::solve fails.
+     */
+    bool solve(double pos_out[4], int max_iterations = 10)
+    {
+        if (d_n < 4)
+            {
+                return false;
+            }
+        arma::vec pos = arma::zeros(4);
+        arma::mat A = arma::zeros(d_n, 4);
+        arma::vec omc = arma::zeros(d_n);
+        arma::mat W = arma::zeros(d_n, d_n);
+        arma::vec x;
+        for (int i = 0; i < d_n; i++) W(i, i) = d_w[i];
+
+        iterations = 0;
+        for (int iter = 0; iter < max_iterations; iter++)
+            {
+                iterations++;
+                for (int i = 0; i < d_n; i++)
+                    {
+                        double rot[3] = {d_sat[i][0], d_sat[i][1], d_sat[i][2]};
+                        double trop = 0.0;
+                        if (iter > 0)
+                            {
+                                double rho2 = (d_sat[i][0] - pos(0)) * (d_sat[i][0] - pos(0))
+                                            + (d_sat[i][1] - pos(1)) * (d_sat[i][1] - pos(1))
+                                            + (d_sat[i][2] - pos(2)) * (d_sat[i][2] - pos(2));
+                                double traveltime = std::sqrt(rho2) / GPS_C_m_s;
+
+                                //--- Correct satellite position (do to earth rotation) --------
+                                Ls_Pvt_Solver<MAX_OBS>::rotate_satellite(traveltime, d_sat[i], rot);
+
+                                //--- Find satellites' DOA
+                                double phi;
+                                double lambda;
+                                double h;
+                                Ls_Pvt_Solver<MAX_OBS>::togeod(&phi, &lambda, &h, 6378137.0, 298.257223563, pos(0), pos(1), pos(2));
+                                double dx[3] = {rot[0] - pos(0), rot[1] - pos(1), rot[2] - pos(2)};
+                                Ls_Pvt_Solver<MAX_OBS>::topocent(&az_deg[i], &el_deg[i], &distance_m[i], phi, lambda, dx);
+
+                                if (tropo_enabled and (traveltime < 0.1) and (d_n > 3))
+                                    {
+                                        //--- Find delay due to troposphere (in meters)
+                                        Ls_Pvt_Solver<MAX_OBS>::tropo(&trop, std::sin(el_deg[i] * GPS_PI / 180.0), h / 1000.0, 1013.0, 293.0, 50.0, 0.0, 0.0, 0.0);
+                                        if (trop > 50.0) trop = 0.0;
+                                    }
+                            }
+
+                        //--- Apply the corrections ----------------------------------------
+                        double e0 = rot[0] - pos(0);
+                        double e1 = rot[1] - pos(1);
+                        double e2 = rot[2] - pos(2);
+                        omc(i) = d_obs[i] - std::sqrt(e0 * e0 + e1 * e1 + e2 * e2) - pos(3) - trop;
+
+                        //--- Construct the A matrix ---------------------------------------
+                        A(i, 0) = -e0 / d_obs[i];
+                        A(i, 1) = -e1 / d_obs[i];
+                        A(i, 2) = -e2 / d_obs[i];
+                        A(i, 3) = 1.0;
+                    }
+
+                //--- Find position update ---------------------------------------------
+                if (arma::solve(x, W * A, W * omc) == false)
+                    {
+                        return false;
+                    }
+
+                //--- Apply position update --------------------------------------------
+                pos = pos + x;
+                if (arma::norm(x, 2) < 1e-4)
+                    {
+                        break; // exit the loop because we assume that the LS algorithm has converged (err < 0.1 cm)
+                    }
+            }
+
+        arma::mat q;
+        try
+        {
+                //-- compute the Dilution Of Precision values
+                q = arma::inv(arma::htrans(A) * A);
+        }
+        catch(std::exception& e)
+        {
+                q = arma::zeros(4, 4);
+        }
+        for (int r = 0; r < 4; r++)
+            {
+                for (int c = 0; c < 4; c++) Q[r][c] = q(r, c);
+                pos_out[r] = pos(r);
+            }
+        return true;
+    }
+
+private:
+    double d_sat[MAX_OBS][3];
+    double d_obs[MAX_OBS];
+    double d_w[MAX_OBS];
+    int d_n;
+};
+
+#endif
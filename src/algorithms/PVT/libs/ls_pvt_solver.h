@@ -0,0 +1,445 @@
+/*!
+ * \file ls_pvt_solver.h
+ * \brief Least Squares position solver working on compile-time bounded
+ * matrices, with no heap allocation per epoch
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_LS_PVT_SOLVER_H_
+#define GNSS_SDR_LS_PVT_SOLVER_H_
+
+#include <cmath>
+#include "GPS_L1_CA.h"
+
+/*!
+ * \brief This class implements the iterative Least Squares position and
+ * receiver clock solution used by the PVT blocks, on fixed-size storage
+ * bounded by MAX_OBS observations.
+ *
+ * Each iteration corrects the satellite positions for the Earth rotation
+ * during the signal travel time, applies a Hopfield troposphere model
+ * and solves the weighted normal equations with an in-place 4x4 Cholesky
+ * factorization. The solver warm-starts from the previous valid solution,
+ * which usually converges in one or two iterations.
+ *
+ * Usage: clear(), add_observation() for each satellite, then solve().
+ */
+template<int MAX_OBS>
+class Ls_Pvt_Solver
+{
+public:
+    double az_deg[MAX_OBS];       //!< Azimuth of each observation at the solution [deg]
+    double el_deg[MAX_OBS];       //!< Elevation of each observation at the solution [deg]
+    double distance_m[MAX_OBS];   //!< Geometric range of each observation at the solution [m]
+    double Q[4][4];               //!< inv(A'A) at the solution, for the DOP computation
+    int iterations;               //!< Number of iterations used by the last solve()
+    bool tropo_enabled;           //!< Apply the troposphere model (default true)
+
+    Ls_Pvt_Solver()
+    {
+        d_n = 0;
+        d_warm = false;
+        iterations = 0;
+        tropo_enabled = true;
+        for (int i = 0; i < 4; i++)
+            {
+                d_pos[i] = 0.0;
+                for (int j = 0; j < 4; j++) Q[i][j] = 0.0;
+            }
+    }
+
+    //! Removes all the observations of the current epoch
+    void clear()
+    {
+        d_n = 0;
+    }
+
+    //! Forgets the previous solution, so that next solve() starts from the Earth center
+    void reset()
+    {
+        d_warm = false;
+        for (int i = 0; i < 4; i++) d_pos[i] = 0.0;
+    }
+
+    int size() const
+    {
+        return d_n;
+    }
+
+    /*!
+     * \brief Adds a pseudorange observation (already corrected for the
+     * satellite clock) with the ECEF satellite position at transmission time.
+     * Returns false if MAX_OBS observations were already added.
+     */
+    bool add_observation(double sat_x, double sat_y, double sat_z, double pseudorange_m, double weight)
+    {
+        if (d_n >= MAX_OBS)
+            {
+                return false;
+            }
+        d_sat[d_n][0] = sat_x;
+        d_sat[d_n][1] = sat_y;
+        d_sat[d_n][2] = sat_z;
+        d_obs[d_n] = pseudorange_m;
+        d_w[d_n] = weight;
+        d_n++;
+        return true;
+    }
+
+    /*!
+     * \brief Computes the receiver position and clock offset [X, Y, Z, c*dt] (ECEF, meters).
+     * Returns false if there are less than 4 observations or the geometry is singular.
+     */
+    bool solve(double pos[4], int max_iterations = 10)
+    {
+        if (d_n < 4)
+            {
+                return false;
+            }
+        double x[4];
+        double rot[3];
+        double N[4][4];
+        double b[4];
+        double a_row[4];
+        double trop;
+        bool warm = d_warm;
+        for (int k = 0; k < 4; k++) x[k] = d_pos[k];
+
+        iterations = 0;
+        for (int iter = 0; iter < max_iterations; iter++)
+            {
+                iterations++;
+                bool corrections = warm or (iter > 0);
+                double phi_rx = 0.0;
+                double lambda_rx = 0.0;
+                double h_rx = 0.0;
+                if (corrections)
+                    {
+                        // the receiver geodetic coordinates are shared by all the satellites
+                        togeod(&phi_rx, &lambda_rx, &h_rx, 6378137.0, 298.257223563, x[0], x[1], x[2]);
+                    }
+                for (int r = 0; r < 4; r++)
+                    {
+                        b[r] = 0.0;
+                        for (int c = 0; c < 4; c++) N[r][c] = 0.0;
+                    }
+                for (int i = 0; i < d_n; i++)
+                    {
+                        trop = 0.0;
+                        if (corrections)
+                            {
+                                double dx0 = d_sat[i][0] - x[0];
+                                double dx1 = d_sat[i][1] - x[1];
+                                double dx2 = d_sat[i][2] - x[2];
+                                double traveltime = std::sqrt(dx0 * dx0 + dx1 * dx1 + dx2 * dx2) / GPS_C_m_s;
+                                rotate_satellite(traveltime, d_sat[i], rot);
+                                double dx[3] = {rot[0] - x[0], rot[1] - x[1], rot[2] - x[2]};
+                                topocent(&az_deg[i], &el_deg[i], &distance_m[i], phi_rx, lambda_rx, dx);
+                                if (tropo_enabled and traveltime < 0.1 and d_n > 3)
+                                    {
+                                        tropo(&trop, std::sin(el_deg[i] * GPS_PI / 180.0), h_rx / 1000.0, 1013.0, 293.0, 50.0, 0.0, 0.0, 0.0);
+                                        if (trop > 50.0 or trop < 0.0) trop = 0.0; // not a plausible delay, the position is still far off
+                                    }
+                            }
+                        else
+                            {
+                                rot[0] = d_sat[i][0];
+                                rot[1] = d_sat[i][1];
+                                rot[2] = d_sat[i][2];
+                            }
+                        double e0 = rot[0] - x[0];
+                        double e1 = rot[1] - x[1];
+                        double e2 = rot[2] - x[2];
+                        double range = std::sqrt(e0 * e0 + e1 * e1 + e2 * e2);
+                        double omc = d_obs[i] - range - x[3] - trop;
+                        a_row[0] = -e0 / range;
+                        a_row[1] = -e1 / range;
+                        a_row[2] = -e2 / range;
+                        a_row[3] = 1.0;
+                        double w2 = d_w[i] * d_w[i];
+                        for (int r = 0; r < 4; r++)
+                            {
+                                b[r] += w2 * a_row[r] * omc;
+                                for (int c = 0; c <= r; c++) N[r][c] += w2 * a_row[r] * a_row[c];
+                            }
+                    }
+                if (cholesky_solve(N, b) == false)
+                    {
+                        d_warm = false;
+                        return false;
+                    }
+                for (int k = 0; k < 4; k++) x[k] += b[k];
+                if (std::sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2] + b[3] * b[3]) < 1e-4)
+                    {
+                        break; // converged (err < 0.1 mm)
+                    }
+            }
+
+        // Q = inv(A'A) at the solution, unweighted as in the DOP definition
+        double M[4][4];
+        for (int r = 0; r < 4; r++)
+            {
+                for (int c = 0; c < 4; c++) M[r][c] = 0.0;
+            }
+        for (int i = 0; i < d_n; i++)
+            {
+                rotate_satellite(distance_m[i] / GPS_C_m_s, d_sat[i], rot);
+                double e0 = rot[0] - x[0];
+                double e1 = rot[1] - x[1];
+                double e2 = rot[2] - x[2];
+                double range = std::sqrt(e0 * e0 + e1 * e1 + e2 * e2);
+                a_row[0] = -e0 / range;
+                a_row[1] = -e1 / range;
+                a_row[2] = -e2 / range;
+                a_row[3] = 1.0;
+                for (int r = 0; r < 4; r++)
+                    {
+                        for (int c = 0; c <= r; c++) M[r][c] += a_row[r] * a_row[c];
+                    }
+            }
+        if (cholesky_inverse(M, Q) == false)
+            {
+                for (int r = 0; r < 4; r++)
+                    {
+                        for (int c = 0; c < 4; c++) Q[r][c] = 0.0;
+                    }
+            }
+
+        for (int k = 0; k < 4; k++)
+            {
+                d_pos[k] = x[k];
+                pos[k] = x[k];
+            }
+        d_warm = true;
+        return true;
+    }
+
+    //! Rotates the satellite ECEF coordinates due to the Earth rotation during the signal travel time
+    static void rotate_satellite(double traveltime, const double X_sat[3], double X_sat_rot[3])
+    {
+        double omegatau = OMEGA_EARTH_DOT * traveltime;
+        double c = std::cos(omegatau);
+        double s = std::sin(omegatau);
+        X_sat_rot[0] = c * X_sat[0] + s * X_sat[1];
+        X_sat_rot[1] = -s * X_sat[0] + c * X_sat[1];
+        X_sat_rot[2] = X_sat[2];
+    }
+
+    //! Geodetic coordinates (latitude and longitude in degrees, height in the units of a) of the ECEF point X, Y, Z. Based on a Matlab function by Kai Borre
+    static void togeod(double *dphi, double *dlambda, double *h, double a, double finv, double X, double Y, double Z)
+    {
+        *h = 0;
+        double tolsq = 1.e-10;
+        int maxit = 10;
+        double rtd = 180.0 / GPS_PI;
+        double esq = (finv < 1.0E-20) ? 0.0 : (2 - 1 / finv) / finv;
+        double P = std::sqrt(X * X + Y * Y);
+        *dlambda = (P > 1.0E-20) ? std::atan2(Y, X) * rtd : 0.0;
+        if (*dlambda < 0) *dlambda = *dlambda + 360.0;
+        double r = std::sqrt(P * P + Z * Z);
+        double sinphi = (r > 1.0E-20) ? Z / r : 0.0;
+        *dphi = std::asin(sinphi);
+        if (r < 1.0E-20)
+            {
+                *h = 0;
+                return;
+            }
+        *h = r - a * (1 - sinphi * sinphi / finv);
+        double oneesq = 1 - esq;
+        for (int i = 0; i < maxit; i++)
+            {
+                sinphi = std::sin(*dphi);
+                double cosphi = std::cos(*dphi);
+                double N_phi = a / std::sqrt(1 - esq * sinphi * sinphi);
+                double dP = P - (N_phi + (*h)) * cosphi;
+                double dZ = Z - (N_phi * oneesq + (*h)) * sinphi;
+                *h = *h + (sinphi * dZ + cosphi * dP);
+                *dphi = *dphi + (cosphi * dZ - sinphi * dP) / (N_phi + (*h));
+                if ((dP * dP + dZ * dZ) < tolsq) break;
+            }
+        *dphi = (*dphi) * rtd;
+    }
+
+    //! Azimuth, elevation (degrees) and length of vector dx in the topocentric frame at latitude phi, longitude lambda (degrees)
+    static void topocent(double *Az, double *El, double *D, double phi, double lambda, const double dx[3])
+    {
+        double dtr = GPS_PI / 180.0;
+        double cl = std::cos(lambda * dtr);
+        double sl = std::sin(lambda * dtr);
+        double cb = std::cos(phi * dtr);
+        double sb = std::sin(phi * dtr);
+        double E = -sl * dx[0] + cl * dx[1];
+        double N = -sb * cl * dx[0] - sb * sl * dx[1] + cb * dx[2];
+        double U = cb * cl * dx[0] + cb * sl * dx[1] + sb * dx[2];
+        double hor_dis = std::sqrt(E * E + N * N);
+        if (hor_dis < 1.0E-20)
+            {
+                *Az = 0;
+                *El = 90;
+            }
+        else
+            {
+                *Az = std::atan2(E, N) / dtr;
+                *El = std::atan2(U, hor_dis) / dtr;
+            }
+        if (*Az < 0) *Az = *Az + 360.0;
+        *D = std::sqrt(dx[0] * dx[0] + dx[1] * dx[1] + dx[2] * dx[2]);
+    }
+
+    /*!
+     * \brief Range correction [m] of the modified Hopfield troposphere model.
+     * Goad, C.C. & Goodman, L. (1974) A Modified Hopfield Tropospheric Refraction
+     * Correction Model. Translated from a Matlab implementation by Kai Borre
+     */
+    static void tropo(double *ddr_m, double sinel, double hsta_km, double p_mb, double t_kel, double hum, double hp_km, double htkel_km, double hhum_km)
+    {
+        const double a_e    = 6378.137;
+        const double b0     = 7.839257e-5;
+        const double tlapse = -6.5;
+        const double em     = -978.77 / (2.8704e6 * tlapse * 1.0e-5);
+
+        double tkhum  = t_kel + tlapse * (hhum_km - htkel_km);
+        double atkel  = 7.5 * (tkhum - 273.15) / (237.3 + tkhum - 273.15);
+        double e0     = 0.0611 * hum * std::pow(10, atkel);
+        double tksea  = t_kel - tlapse * htkel_km;
+        double tkelh  = tksea + tlapse * hhum_km;
+        double e0sea  = e0 * std::pow((tksea / tkelh), (4 * em));
+        double tkelp  = tksea + tlapse * hp_km;
+        double psea   = p_mb * std::pow((tksea / tkelp), em);
+
+        if (sinel < 0) sinel = 0.0;
+
+        double tropo_delay = 0.0;
+        double refsea = 77.624e-6 / tksea;
+        double htop = 1.1385e-5 / refsea;
+        refsea = refsea * psea;
+        double ref = refsea * std::pow(((htop - hsta_km) / htop), 4);
+
+        for (int pass = 0; pass < 2; pass++)
+            {
+                double rtop = std::pow((a_e + htop), 2) - std::pow((a_e + hsta_km), 2) * (1 - sinel * sinel);
+                if (rtop < 0) rtop = 0;
+                rtop = std::sqrt(rtop) - (a_e + hsta_km) * sinel;
+                double a = -sinel / (htop - hsta_km);
+                double b = -b0 * (1 - sinel * sinel) / (htop - hsta_km);
+                double alpha[8] = {2 * a, 2 * a * a + 4 * b / 3, a * (a * a + 3 * b),
+                        std::pow(a, 4) / 5 + 2.4 * a * a * b + 1.2 * b * b, 2 * a * b * (a * a + 3 * b) / 3,
+                        b * b * (6 * a * a + 4 * b) * 1.428571e-1, 0, 0};
+                if (b * b > 1.0e-35)
+                    {
+                        alpha[6] = a * b * b * b / 2;
+                        alpha[7] = std::pow(b, 4) / 9;
+                    }
+                double dr = rtop;
+                double rn = rtop;
+                for (int i = 0; i < 8; i++)
+                    {
+                        rn *= rtop; // rtop^(i+2)
+                        dr += alpha[i] * rn;
+                    }
+                tropo_delay = tropo_delay + dr * ref * 1000;
+
+                refsea = (371900.0e-6 / tksea - 12.92e-6) / tksea;
+                htop = 1.1385e-5 * (1255 / tksea + 0.05) / refsea;
+                ref = refsea * e0sea * std::pow(((htop - hsta_km) / htop), 4);
+            }
+        *ddr_m = tropo_delay;
+    }
+
+    //! Inverse of the symmetric positive definite 4x4 matrix whose lower triangle is in N (N is overwritten)
+    static bool cholesky_inverse(double N[4][4], double inverse[4][4])
+    {
+        if (cholesky(N) == false)
+            {
+                return false;
+            }
+        for (int c = 0; c < 4; c++)
+            {
+                double e[4] = {0.0, 0.0, 0.0, 0.0};
+                e[c] = 1.0;
+                cholesky_substitute(N, e);
+                for (int r = 0; r < 4; r++) inverse[r][c] = e[r];
+            }
+        return true;
+    }
+
+private:
+    double d_sat[MAX_OBS][3];
+    double d_obs[MAX_OBS];
+    double d_w[MAX_OBS];
+    int d_n;
+    double d_pos[4];
+    bool d_warm;
+
+    // In-place Cholesky factorization of the lower triangle of N (4x4, SPD)
+    static bool cholesky(double N[4][4])
+    {
+        for (int j = 0; j < 4; j++)
+            {
+                double d = N[j][j];
+                for (int k = 0; k < j; k++) d -= N[j][k] * N[j][k];
+                if (d <= 0.0)
+                    {
+                        return false;
+                    }
+                N[j][j] = std::sqrt(d);
+                for (int i = j + 1; i < 4; i++)
+                    {
+                        double s = N[i][j];
+                        for (int k = 0; k < j; k++) s -= N[i][k] * N[j][k];
+                        N[i][j] = s / N[j][j];
+                    }
+            }
+        return true;
+    }
+
+    // Solves L L' x = b in place, once N holds its Cholesky factor L
+    static void cholesky_substitute(const double L[4][4], double b[4])
+    {
+        for (int i = 0; i < 4; i++)
+            {
+                for (int k = 0; k < i; k++) b[i] -= L[i][k] * b[k];
+                b[i] /= L[i][i];
+            }
+        for (int i = 3; i >= 0; i--)
+            {
+                for (int k = i + 1; k < 4; k++) b[i] -= L[k][i] * b[k];
+                b[i] /= L[i][i];
+            }
+    }
+
+    static bool cholesky_solve(double N[4][4], double b[4])
+    {
+        if (cholesky(N) == false)
+            {
+                return false;
+            }
+        cholesky_substitute(N, b);
+        return true;
+    }
+};
+
+#endif
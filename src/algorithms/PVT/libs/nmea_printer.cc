@@ -72,6 +72,13 @@ Nmea_Printer::Nmea_Printer(std::string filename, bool flag_nmea_tty_port, std::s
 
 
 
+void Nmea_Printer::set_stream_server(const std::shared_ptr<Pvt_Stream_Server>& server)
+{
+    nmea_stream_server = server;
+}
+
+
+
 
 Nmea_Printer::~Nmea_Printer()
 {
@@ -132,7 +139,7 @@ void Nmea_Printer::close_serial ()
 }
 
 
-bool Nmea_Printer::Print_Nmea_Line(const std::shared_ptr<gps_l1_ca_ls_pvt>& pvt_data, bool print_average_values)
+bool Nmea_Printer::Print_Nmea_Line(const std::shared_ptr<Pvt_Solution>& pvt_data, bool print_average_values)
 {
     std::string GPRMC;
     std::string GPGGA;
@@ -190,6 +197,13 @@ bool Nmea_Printer::Print_Nmea_Line(const std::shared_ptr<gps_l1_ca_ls_pvt>& pvt_
                     DLOG(INFO) << "NMEA printer can not write on serial device" << nmea_filename.c_str();;
             }
         }
+
+    //send to the streaming clients
+    if (nmea_stream_server)
+        {
+            std::string sentences = GPRMC + GPGGA + GPGSA + GPGSV;
+            nmea_stream_server->publish(sentences.c_str(), sentences.length());
+        }
     return true;
 }
 
@@ -41,6 +41,7 @@
 #include <fstream>
 #include <string>
 #include "gps_l1_ca_ls_pvt.h"
+#include "pvt_stream_server.h"
 
 
 /*!
@@ -60,7 +61,12 @@ public:
     /*!
      * \brief Print NMEA PVT and satellite info to the initialized device
      */
-    bool Print_Nmea_Line(const std::shared_ptr<gps_l1_ca_ls_pvt>& position, bool print_average_values);
+    bool Print_Nmea_Line(const std::shared_ptr<Pvt_Solution>& position, bool print_average_values);
+
+    /*!
+     * \brief Also sends the NMEA sentences to the clients of \p server
+     */
+    void set_stream_server(const std::shared_ptr<Pvt_Stream_Server>& server);
 
     /*!
      * \brief Default destructor.
@@ -72,7 +78,8 @@ private:
     std::ofstream nmea_file_descriptor; // Output file stream for NMEA log file
     std::string nmea_devname;
     int nmea_dev_descriptor; // NMEA serial device descriptor (i.e. COM port)
-    std::shared_ptr<gps_l1_ca_ls_pvt> d_PVT_data;
+    std::shared_ptr<Pvt_Stream_Server> nmea_stream_server; // NMEA TCP clients
+    std::shared_ptr<Pvt_Solution> d_PVT_data;
     int init_serial(std::string serial_device); //serial port control
     void close_serial();
     std::string get_GPGGA(); // fix data
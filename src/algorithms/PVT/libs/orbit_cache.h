@@ -0,0 +1,208 @@
+/*!
+ * \file orbit_cache.h
+ * \brief Cache of Chebyshev polynomial fits of the broadcast orbit and
+ * clock models, to avoid solving Kepler's equation at every PVT epoch
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_ORBIT_CACHE_H_
+#define GNSS_SDR_ORBIT_CACHE_H_
+
+#include <cmath>
+#include <map>
+#include "galileo_ephemeris.h"
+#include "gps_ephemeris.h"
+
+/*!
+ * \brief Identifies the ephemeris set a cached fit was computed from.
+ * A change in the issue of data or in the reference time invalidates the fit.
+ */
+struct Orbit_Cache_Issue
+{
+    double reference_time;
+    double issue_of_data;
+    bool operator==(const Orbit_Cache_Issue& other) const
+    {
+        return (reference_time == other.reference_time) and (issue_of_data == other.issue_of_data);
+    }
+};
+
+inline Orbit_Cache_Issue orbit_cache_issue(const Gps_Ephemeris& eph)
+{
+    Orbit_Cache_Issue issue = { eph.d_Toe, eph.d_IODC };
+    return issue;
+}
+
+inline Orbit_Cache_Issue orbit_cache_issue(const Galileo_Ephemeris& eph)
+{
+    Orbit_Cache_Issue issue = { eph.t0e_1, static_cast<double>(eph.IOD_ephemeris) };
+    return issue;
+}
+
+
+/*!
+ * \brief This class keeps, for each satellite, a Chebyshev polynomial fit of
+ * the ECEF position, ECEF velocity and clock correction given by the broadcast
+ * ephemeris over a short time window.
+ *
+ * The fit is computed lazily the first time a satellite is evaluated inside
+ * a window, by sampling the exact orbital model at ORBIT_CACHE_NODES Chebyshev
+ * nodes. Subsequent evaluations in the same window only cost a Clenshaw
+ * recurrence per component. The fit is discarded when the ephemeris issue
+ * of data or reference time changes.
+ *
+ * Ephemeris can be either Gps_Ephemeris or Galileo_Ephemeris.
+ */
+template<class Ephemeris>
+class Orbit_Cache
+{
+public:
+    static const int ORBIT_CACHE_NODES = 12;
+
+    /*!
+     * \brief Constructor. \p window_s is the length of the fitting windows, in seconds.
+     */
+    Orbit_Cache(double window_s = 60.0)
+    {
+        d_window_s = window_s;
+    }
+
+    /*!
+     * \brief Same as Ephemeris::sv_clock_drift (clock bias including the
+     * relativistic term), evaluated from the cached fit
+     */
+    double sv_clock_drift(Ephemeris& eph, double transmitTime)
+    {
+        const Orbit_Cache_Window& w = window(eph, transmitTime);
+        return clenshaw(w.coeffs[6], w.normalized_time(transmitTime));
+    }
+
+    /*!
+     * \brief Same as Ephemeris::satellitePosition: fills d_satpos_* and
+     * d_satvel_* of \p eph, evaluated from the cached fit
+     */
+    void satellitePosition(Ephemeris& eph, double transmitTime)
+    {
+        const Orbit_Cache_Window& w = window(eph, transmitTime);
+        double x = w.normalized_time(transmitTime);
+        eph.d_satpos_X = clenshaw(w.coeffs[0], x);
+        eph.d_satpos_Y = clenshaw(w.coeffs[1], x);
+        eph.d_satpos_Z = clenshaw(w.coeffs[2], x);
+        eph.d_satvel_X = clenshaw(w.coeffs[3], x);
+        eph.d_satvel_Y = clenshaw(w.coeffs[4], x);
+        eph.d_satvel_Z = clenshaw(w.coeffs[5], x);
+    }
+
+    /*!
+     * \brief Drops all the cached fits
+     */
+    void clear()
+    {
+        d_windows.clear();
+    }
+
+private:
+    struct Orbit_Cache_Window
+    {
+        Orbit_Cache_Issue issue;
+        double t_start;
+        double t_end;
+        double coeffs[7][ORBIT_CACHE_NODES]; // X, Y, Z, VX, VY, VZ, clock
+
+        double normalized_time(double t) const
+        {
+            return (2.0 * t - t_start - t_end) / (t_end - t_start);
+        }
+    };
+
+    double d_window_s;
+    std::map<unsigned int, Orbit_Cache_Window> d_windows; // indexed by PRN
+
+    static double clenshaw(const double* c, double x)
+    {
+        double b1 = 0.0;
+        double b2 = 0.0;
+        double tmp;
+        for (int j = ORBIT_CACHE_NODES - 1; j > 0; j--)
+            {
+                tmp = b1;
+                b1 = 2.0 * x * b1 - b2 + c[j];
+                b2 = tmp;
+            }
+        return x * b1 - b2 + 0.5 * c[0];
+    }
+
+    const Orbit_Cache_Window& window(Ephemeris& eph, double t)
+    {
+        Orbit_Cache_Issue issue = orbit_cache_issue(eph);
+        typename std::map<unsigned int, Orbit_Cache_Window>::iterator it = d_windows.find(eph.i_satellite_PRN);
+        if ((it != d_windows.end()) and (it->second.issue == issue) and (t >= it->second.t_start) and (t <= it->second.t_end))
+            {
+                return it->second;
+            }
+        Orbit_Cache_Window& w = d_windows[eph.i_satellite_PRN];
+        w.issue = issue;
+        w.t_start = std::floor(t / d_window_s) * d_window_s;
+        w.t_end = w.t_start + d_window_s;
+        fit(eph, w);
+        return w;
+    }
+
+    void fit(const Ephemeris& eph, Orbit_Cache_Window& w)
+    {
+        // work on a copy, the orbital model functions overwrite the ephemeris state
+        Ephemeris model = eph;
+        double samples[7][ORBIT_CACHE_NODES];
+        double half = 0.5 * (w.t_end - w.t_start);
+        double mid = w.t_start + half;
+        for (int k = 0; k < ORBIT_CACHE_NODES; k++)
+            {
+                double t = mid + half * std::cos(M_PI * (k + 0.5) / ORBIT_CACHE_NODES);
+                model.satellitePosition(t);
+                samples[0][k] = model.d_satpos_X;
+                samples[1][k] = model.d_satpos_Y;
+                samples[2][k] = model.d_satpos_Z;
+                samples[3][k] = model.d_satvel_X;
+                samples[4][k] = model.d_satvel_Y;
+                samples[5][k] = model.d_satvel_Z;
+                samples[6][k] = model.sv_clock_drift(t);
+            }
+        for (int n = 0; n < 7; n++)
+            {
+                for (int j = 0; j < ORBIT_CACHE_NODES; j++)
+                    {
+                        double sum = 0.0;
+                        for (int k = 0; k < ORBIT_CACHE_NODES; k++)
+                            {
+                                sum += samples[n][k] * std::cos(M_PI * j * (k + 0.5) / ORBIT_CACHE_NODES);
+                            }
+                        w.coeffs[n][j] = 2.0 * sum / ORBIT_CACHE_NODES;
+                    }
+            }
+    }
+};
+
+#endif
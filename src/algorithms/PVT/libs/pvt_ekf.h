@@ -0,0 +1,315 @@
+/*!
+ * \file pvt_ekf.h
+ * \brief Extended Kalman filter for the position, velocity and receiver
+ * clock, updated once per epoch with the satellite pseudoranges
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PVT_EKF_H_
+#define GNSS_SDR_PVT_EKF_H_
+
+#include <cmath>
+#include <cstring>
+#include "ls_pvt_solver.h"
+
+#define PVT_EKF_STATES 9
+
+/*!
+ * \brief This class implements an extended Kalman filter with the state
+ * [X, Y, Z, VX, VY, VZ, c*dt, c*dt_dot, c*isb] (ECEF, meters and m/s), where
+ * isb is the inter-system (Galileo - GPS) clock bias used by the hybrid receiver.
+ *
+ * The filter is started from a Least Squares fix with initialize(). Each
+ * epoch is then a constant velocity / clock drift prediction and one
+ * sequential scalar update per pseudorange, so that no matrix inversion
+ * is needed and the cost does not depend on the past. Observations whose
+ * innovation exceeds innovation_gate_m are discarded; if most of them are
+ * discarded the filter is considered diverged and update() returns false,
+ * so that the caller can restart it from a new Least Squares fix.
+ */
+template<int MAX_OBS>
+class Pvt_Ekf
+{
+public:
+    double state[PVT_EKF_STATES];                  //!< Filter state
+    double P[PVT_EKF_STATES][PVT_EKF_STATES];      //!< State covariance
+    double az_deg[MAX_OBS];                        //!< Azimuth of each observation at the predicted position [deg]
+    double el_deg[MAX_OBS];                        //!< Elevation of each observation at the predicted position [deg]
+    double distance_m[MAX_OBS];                    //!< Geometric range of each observation at the predicted position [m]
+    double Q[4][4];                                //!< inv(A'A) at the updated position, for the DOP computation
+    int rejected;                                  //!< Number of observations discarded by the last update()
+
+    double pseudorange_sigma_m;   //!< Pseudorange noise standard deviation [m]
+    double acceleration_psd;      //!< Power spectral density of the acceleration, per axis [m^2/s^3]
+    double clock_bias_psd;        //!< Power spectral density of the clock bias noise [m^2/s]
+    double clock_drift_psd;       //!< Power spectral density of the clock drift noise [m^2/s^3]
+    double isb_psd;               //!< Power spectral density of the inter-system bias noise [m^2/s]
+    double innovation_gate_m;     //!< Observations with larger innovations are discarded [m]
+    double max_prediction_s;      //!< Longer gaps between epochs restart the filter [s]
+    bool tropo_enabled;           //!< Apply the troposphere model (default true)
+
+    Pvt_Ekf()
+    {
+        pseudorange_sigma_m = 5.0;
+        acceleration_psd = 1.0;
+        clock_bias_psd = 0.1;
+        clock_drift_psd = 10.0;
+        isb_psd = 1e-4;
+        innovation_gate_m = 150.0;
+        max_prediction_s = 10.0;
+        tropo_enabled = true;
+        rejected = 0;
+        d_n = 0;
+        reset();
+    }
+
+    //! Removes all the observations of the current epoch
+    void clear()
+    {
+        d_n = 0;
+    }
+
+    //! Stops the filter, it has to be initialized again
+    void reset()
+    {
+        d_initialized = false;
+        d_time = 0.0;
+        for (int i = 0; i < PVT_EKF_STATES; i++)
+            {
+                state[i] = 0.0;
+                for (int j = 0; j < PVT_EKF_STATES; j++) P[i][j] = 0.0;
+            }
+        for (int i = 0; i < 4; i++)
+            {
+                for (int j = 0; j < 4; j++) Q[i][j] = 0.0;
+            }
+    }
+
+    bool initialized() const
+    {
+        return d_initialized;
+    }
+
+    int size() const
+    {
+        return d_n;
+    }
+
+    /*!
+     * \brief Starts the filter at time \p t [s] from the position and clock
+     * offset \p pos = [X, Y, Z, c*dt] given by a Least Squares solution
+     */
+    void initialize(const double pos[4], double t)
+    {
+        reset();
+        for (int i = 0; i < 3; i++)
+            {
+                state[i] = pos[i];
+                P[i][i] = 100.0;       // (10 m)^2
+                P[i + 3][i + 3] = 100.0; // (10 m/s)^2, the velocity is unknown
+            }
+        state[6] = pos[3];
+        P[6][6] = 100.0;
+        P[7][7] = 1.0e4;               // TCXO frequency offsets of a few ppm are common
+        P[8][8] = 1.0e4;
+        d_time = t;
+        d_initialized = true;
+    }
+
+    /*!
+     * \brief Adds a pseudorange observation (already corrected for the
+     * satellite clock) with the ECEF satellite position at transmission time.
+     * \p system is 0 for the reference system (GPS) and 1 for the system
+     * affected by the inter-system bias (Galileo).
+     * Returns false if MAX_OBS observations were already added.
+     */
+    bool add_observation(double sat_x, double sat_y, double sat_z, double pseudorange_m, int system)
+    {
+        if (d_n >= MAX_OBS)
+            {
+                return false;
+            }
+        d_sat[d_n][0] = sat_x;
+        d_sat[d_n][1] = sat_y;
+        d_sat[d_n][2] = sat_z;
+        d_obs[d_n] = pseudorange_m;
+        d_system[d_n] = system;
+        d_n++;
+        return true;
+    }
+
+    /*!
+     * \brief Propagates the filter to time \p t [s] and updates it with the
+     * observations of the epoch. Fills \p pos = [X, Y, Z, c*dt] with the
+     * filtered solution. Returns false if the filter is not initialized, the
+     * prediction interval is not valid or the filter has diverged; the state,
+     * the covariance and the time of the filter are then left as they were.
+     */
+    bool update(double t, double pos[4])
+    {
+        if (d_initialized == false)
+            {
+                return false;
+            }
+        double dt = t - d_time;
+        if (dt < 0.0 or dt > max_prediction_s)
+            {
+                return false;
+            }
+        double previous_state[PVT_EKF_STATES];
+        double previous_P[PVT_EKF_STATES][PVT_EKF_STATES];
+        std::memcpy(previous_state, state, sizeof(state));
+        std::memcpy(previous_P, P, sizeof(P));
+        predict(dt);
+
+        // the corrections and the geometry are linearized once, at the predicted position
+        // xp; the sequential updates then use h(xp) + H (x - xp), as a batch update would
+        double xp[3] = {state[0], state[1], state[2]};
+        double phi_rx, lambda_rx, h_rx;
+        Ls_Pvt_Solver<MAX_OBS>::togeod(&phi_rx, &lambda_rx, &h_rx, 6378137.0, 298.257223563, xp[0], xp[1], xp[2]);
+        double R = pseudorange_sigma_m * pseudorange_sigma_m;
+        double A[4][4];
+        for (int r = 0; r < 4; r++)
+            {
+                for (int c = 0; c < 4; c++) A[r][c] = 0.0;
+            }
+        rejected = 0;
+        for (int i = 0; i < d_n; i++)
+            {
+                double rot[3];
+                double dx[3] = {d_sat[i][0] - xp[0], d_sat[i][1] - xp[1], d_sat[i][2] - xp[2]};
+                double traveltime = std::sqrt(dx[0] * dx[0] + dx[1] * dx[1] + dx[2] * dx[2]) / GPS_C_m_s;
+                Ls_Pvt_Solver<MAX_OBS>::rotate_satellite(traveltime, d_sat[i], rot);
+                for (int k = 0; k < 3; k++) dx[k] = rot[k] - xp[k];
+                Ls_Pvt_Solver<MAX_OBS>::topocent(&az_deg[i], &el_deg[i], &distance_m[i], phi_rx, lambda_rx, dx);
+                double trop = 0.0;
+                if (tropo_enabled)
+                    {
+                        Ls_Pvt_Solver<MAX_OBS>::tropo(&trop, std::sin(el_deg[i] * GPS_PI / 180.0), h_rx / 1000.0, 1013.0, 293.0, 50.0, 0.0, 0.0, 0.0);
+                        if (trop > 50.0 or trop < 0.0) trop = 0.0;
+                    }
+
+                // H = [-e', 0, 0, 0, 1, 0, system]
+                double range = distance_m[i];
+                double h[PVT_EKF_STATES] = {-dx[0] / range, -dx[1] / range, -dx[2] / range, 0.0, 0.0, 0.0, 1.0, 0.0, (d_system[i] == 1) ? 1.0 : 0.0};
+                double predicted = range + state[6] + h[8] * state[8] + trop;
+                for (int k = 0; k < 3; k++) predicted += h[k] * (state[k] - xp[k]);
+                double innovation = d_obs[i] - predicted;
+                if (std::fabs(innovation) > innovation_gate_m)
+                    {
+                        rejected++;
+                        continue;
+                    }
+                for (int r = 0; r < 4; r++)
+                    {
+                        double a_r = (r < 3) ? h[r] : 1.0;
+                        for (int c = 0; c < 4; c++) A[r][c] += a_r * ((c < 3) ? h[c] : 1.0);
+                    }
+
+                // scalar update: K = P h' / (h P h' + R), P = P - K h P
+                double Ph[PVT_EKF_STATES];
+                double S = R;
+                for (int r = 0; r < PVT_EKF_STATES; r++)
+                    {
+                        Ph[r] = 0.0;
+                        for (int c = 0; c < PVT_EKF_STATES; c++) Ph[r] += P[r][c] * h[c];
+                        S += h[r] * Ph[r];
+                    }
+                for (int r = 0; r < PVT_EKF_STATES; r++)
+                    {
+                        state[r] += Ph[r] * innovation / S;
+                        for (int c = 0; c < PVT_EKF_STATES; c++) P[r][c] -= Ph[r] * Ph[c] / S;
+                    }
+            }
+        if (2 * rejected > d_n or d_n - rejected < 1)
+            {
+                std::memcpy(state, previous_state, sizeof(state));
+                std::memcpy(P, previous_P, sizeof(P));
+                return false;
+            }
+        d_time = t;
+        if (Ls_Pvt_Solver<MAX_OBS>::cholesky_inverse(A, Q) == false)
+            {
+                for (int r = 0; r < 4; r++)
+                    {
+                        for (int c = 0; c < 4; c++) Q[r][c] = 0.0;
+                    }
+            }
+        for (int k = 0; k < 3; k++) pos[k] = state[k];
+        pos[3] = state[6];
+        return true;
+    }
+
+private:
+    double d_sat[MAX_OBS][3];
+    double d_obs[MAX_OBS];
+    int d_system[MAX_OBS];
+    int d_n;
+    double d_time;
+    bool d_initialized;
+
+    // x = F x, P = F P F' + Qd, with constant velocity and clock drift models
+    void predict(double dt)
+    {
+        for (int k = 0; k < 3; k++)
+            {
+                state[k] += state[k + 3] * dt;
+            }
+        state[6] += state[7] * dt;
+
+        // F = I + dt * (d/dt position <- velocity, bias <- drift), applied in place as P = F P F'
+        const int pairs[4][2] = {{0, 3}, {1, 4}, {2, 5}, {6, 7}};
+        for (int p = 0; p < 4; p++)
+            {
+                int a = pairs[p][0];
+                int b = pairs[p][1];
+                for (int c = 0; c < PVT_EKF_STATES; c++) P[a][c] += dt * P[b][c]; // rows: F P
+            }
+        for (int p = 0; p < 4; p++)
+            {
+                int a = pairs[p][0];
+                int b = pairs[p][1];
+                for (int r = 0; r < PVT_EKF_STATES; r++) P[r][a] += dt * P[r][b]; // columns: (F P) F'
+            }
+
+        double dt2 = dt * dt;
+        double dt3 = dt2 * dt;
+        for (int k = 0; k < 3; k++)
+            {
+                P[k][k] += acceleration_psd * dt3 / 3.0;
+                P[k][k + 3] += acceleration_psd * dt2 / 2.0;
+                P[k + 3][k] += acceleration_psd * dt2 / 2.0;
+                P[k + 3][k + 3] += acceleration_psd * dt;
+            }
+        P[6][6] += clock_bias_psd * dt + clock_drift_psd * dt3 / 3.0;
+        P[6][7] += clock_drift_psd * dt2 / 2.0;
+        P[7][6] += clock_drift_psd * dt2 / 2.0;
+        P[7][7] += clock_drift_psd * dt;
+        P[8][8] += isb_psd * dt;
+    }
+};
+
+#endif
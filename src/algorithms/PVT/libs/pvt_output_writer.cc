@@ -0,0 +1,209 @@
+/*!
+ * \file pvt_output_writer.cc
+ * \brief Writer thread that takes the RINEX, NMEA, KML and dump outputs
+ * away from the PVT signal processing thread
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pvt_output_writer.h"
+#include <exception>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+// records written before the files are flushed while the queue stays busy
+#define PVT_OUTPUT_WRITER_MAX_BATCH 256
+
+
+Pvt_Output_Writer::Pvt_Output_Writer(unsigned int queue_size, bool drop_when_full)
+{
+    if (queue_size < 1)
+        {
+            queue_size = 1;
+        }
+    d_queue_size = queue_size;
+    d_ring.resize(queue_size);
+    d_posted_ns.resize(queue_size);
+    d_arrival_ns.resize(queue_size);
+    d_sample_arrival_ns = 0;
+    d_pvt_to_output = gnss_latency_histogram("pvt_to_output");
+    d_sample_to_output = gnss_latency_histogram("sample_to_output");
+    d_drop_when_full = drop_when_full;
+    d_head = 0;
+    d_tail = 0;
+    d_written = 0;
+    d_dropped = 0;
+    d_waits = 0;
+    d_stop = false;
+    d_stopped = false;
+    d_thread = boost::thread(&Pvt_Output_Writer::run, this);
+}
+
+
+Pvt_Output_Writer::~Pvt_Output_Writer()
+{
+    stop();
+}
+
+
+bool Pvt_Output_Writer::post(const std::function<void()>& record)
+{
+    if (d_stopped == true)
+        {
+            record();
+            d_written++;
+            return true;
+        }
+    unsigned long int tail = d_tail.load(std::memory_order_relaxed);
+    if (tail - d_head.load(std::memory_order_acquire) >= d_queue_size)
+        {
+            if (d_drop_when_full == true)
+                {
+                    unsigned long int dropped = d_dropped.fetch_add(1) + 1;
+                    if ((dropped == 1) or (dropped % 1000 == 0))
+                        {
+                            LOG(WARNING) << "PVT output queue full, " << dropped << " records dropped so far";
+                        }
+                    return false;
+                }
+            d_waits++;
+            while (tail - d_head.load(std::memory_order_acquire) >= d_queue_size)
+                {
+                    boost::this_thread::sleep(boost::posix_time::microseconds(100));
+                }
+        }
+    d_ring[tail % d_queue_size] = record;
+    d_posted_ns[tail % d_queue_size] = gnss_steady_ns();
+    d_arrival_ns[tail % d_queue_size] = d_sample_arrival_ns;
+    d_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+
+void Pvt_Output_Writer::add_flush(const std::function<void()>& flush)
+{
+    boost::mutex::scoped_lock lock(d_flush_mutex);
+    d_flush.push_back(flush);
+}
+
+
+void Pvt_Output_Writer::stop()
+{
+    if (d_stopped == true)
+        {
+            return;
+        }
+    d_stop = true;
+    d_thread.join();
+    d_stopped = true;
+    LOG(INFO) << "PVT output writer stopped: " << d_written << " records written, "
+              << d_dropped << " dropped, " << d_waits << " waited for room in the queue";
+}
+
+
+unsigned long int Pvt_Output_Writer::written() const
+{
+    return d_written.load();
+}
+
+
+unsigned long int Pvt_Output_Writer::dropped() const
+{
+    return d_dropped.load();
+}
+
+
+unsigned long int Pvt_Output_Writer::waits() const
+{
+    return d_waits.load();
+}
+
+
+void Pvt_Output_Writer::flush()
+{
+    boost::mutex::scoped_lock lock(d_flush_mutex);
+    for (unsigned int i = 0; i < d_flush.size(); i++)
+        {
+            try
+            {
+                    d_flush.at(i)();
+            }
+            catch (const std::exception& e)
+            {
+                    LOG(WARNING) << "Exception flushing PVT output " << e.what();
+            }
+        }
+}
+
+
+void Pvt_Output_Writer::run()
+{
+    int batch = 0;
+    while (true)
+        {
+            unsigned long int head = d_head.load(std::memory_order_relaxed);
+            if (head == d_tail.load(std::memory_order_acquire))
+                {
+                    if (batch > 0)
+                        {
+                            flush();
+                            batch = 0;
+                        }
+                    // records posted before stop() are written before leaving
+                    if (d_stop.load() and (head == d_tail.load(std::memory_order_acquire)))
+                        {
+                            break;
+                        }
+                    boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+                    continue;
+                }
+            std::function<void()> record;
+            record.swap(d_ring[head % d_queue_size]);
+            long long posted_ns = d_posted_ns[head % d_queue_size];
+            long long arrival_ns = d_arrival_ns[head % d_queue_size];
+            d_head.store(head + 1, std::memory_order_release);
+            try
+            {
+                    record();
+            }
+            catch (const std::exception& e)
+            {
+                    LOG(WARNING) << "Exception writing PVT output " << e.what();
+            }
+            long long written_ns = gnss_steady_ns();
+            d_pvt_to_output->add(written_ns - posted_ns);
+            if (arrival_ns > 0)
+                {
+                    d_sample_to_output->add(written_ns - arrival_ns);
+                }
+            d_written++;
+            if (++batch >= PVT_OUTPUT_WRITER_MAX_BATCH)
+                {
+                    flush();
+                    batch = 0;
+                }
+        }
+}
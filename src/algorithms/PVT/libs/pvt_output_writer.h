@@ -0,0 +1,124 @@
+/*!
+ * \file pvt_output_writer.h
+ * \brief Writer thread that takes the RINEX, NMEA, KML and dump outputs
+ * away from the PVT signal processing thread
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PVT_OUTPUT_WRITER_H_
+#define GNSS_SDR_PVT_OUTPUT_WRITER_H_
+
+#include <atomic>
+#include <functional>
+#include <vector>
+#include <boost/thread.hpp>
+#include "gnss_latency.h"
+
+/*!
+ * \brief This class runs the output records posted by a PVT block in a
+ * dedicated thread.
+ *
+ * A record is a function that formats and writes data captured by value
+ * (a copy of the solution, the observables and the ephemeris it needs), so
+ * it does not share any mutable state with the PVT block. Records are kept
+ * in a bounded single-producer / single-consumer ring buffer; posting never
+ * takes a lock. When the buffer is full the record is either dropped or the
+ * PVT block waits for room, depending on the policy. The flush functions
+ * are called by the writer thread once the posted records have been written,
+ * so that files are flushed in batches instead of at every line.
+ *
+ * The writer measures how long each record waited in the queue
+ * ("pvt_to_output" latency) and, for the records of an epoch whose sample
+ * arrival time is known (see set_sample_arrival()), the age of the
+ * samples when the record is written ("sample_to_output").
+ */
+class Pvt_Output_Writer
+{
+public:
+    /*!
+     * \brief Constructor. Starts the writer thread.
+     * \param[in] queue_size Maximum number of records waiting to be written
+     * \param[in] drop_when_full Drop the new records when the queue is full (true) or wait for room (false)
+     */
+    Pvt_Output_Writer(unsigned int queue_size, bool drop_when_full);
+
+    /*!
+     * \brief Destructor. Writes the pending records and stops the writer thread.
+     */
+    ~Pvt_Output_Writer();
+
+    /*!
+     * \brief Queues a record. Must always be called from the same thread.
+     * Returns false if the record was dropped because the queue was full.
+     * Once the writer is stopped, records are run in the calling thread.
+     */
+    bool post(const std::function<void()>& record);
+
+    /*!
+     * \brief Sets the steady clock time [ns] at which the samples of the
+     * records posted from now on arrived (0: unknown)
+     */
+    void set_sample_arrival(long long sample_arrival_ns) { d_sample_arrival_ns = sample_arrival_ns; }
+
+    /*!
+     * \brief Adds a function called by the writer thread after each batch of records
+     */
+    void add_flush(const std::function<void()>& flush);
+
+    /*!
+     * \brief Writes the pending records and stops the writer thread
+     */
+    void stop();
+
+    unsigned long int written() const;   //!< Number of records written
+    unsigned long int dropped() const;   //!< Number of records dropped because the queue was full
+    unsigned long int waits() const;     //!< Number of records that had to wait for room in the queue
+
+private:
+    void run();
+    void flush();
+
+    std::vector<std::function<void()> > d_ring;
+    std::vector<long long> d_posted_ns;      // time each record in the ring was posted
+    std::vector<long long> d_arrival_ns;     // arrival of the samples of each record in the ring
+    long long d_sample_arrival_ns;           // PVT thread
+    std::shared_ptr<Gnss_Latency_Histogram> d_pvt_to_output;
+    std::shared_ptr<Gnss_Latency_Histogram> d_sample_to_output;
+    unsigned long int d_queue_size;
+    bool d_drop_when_full;
+    std::atomic<unsigned long int> d_head;   // next record to be written (writer thread)
+    std::atomic<unsigned long int> d_tail;   // next free slot (PVT thread)
+    std::atomic<unsigned long int> d_written;
+    std::atomic<unsigned long int> d_dropped;
+    std::atomic<unsigned long int> d_waits;
+    std::atomic<bool> d_stop;
+    bool d_stopped;
+    std::vector<std::function<void()> > d_flush;
+    boost::mutex d_flush_mutex;
+    boost::thread d_thread;
+};
+
+#endif
@@ -0,0 +1,158 @@
+/*!
+ * \file pvt_solution.h
+ * \brief Position, velocity and time solution data shared by the PVT
+ * libraries and the output printers
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PVT_SOLUTION_H_
+#define GNSS_SDR_PVT_SOLUTION_H_
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include "gnss_receiver_fix.h"
+
+#define PVT_MAX_CHANNELS 24
+
+/*!
+ * \brief This class holds the results of a PVT computation that are
+ * printed to the KML and NMEA outputs.
+ *
+ * The PVT libraries derive from it, so that a copy of this base part is an
+ * immutable snapshot of the latest solution that can be handed over to
+ * another thread.
+ */
+class Pvt_Solution
+{
+public:
+    int d_valid_observations;                               //!< Number of valid pseudorange observations (valid satellites)
+    int d_visible_satellites_IDs[PVT_MAX_CHANNELS];         //!< Array with the IDs of the valid satellites
+    double d_visible_satellites_El[PVT_MAX_CHANNELS];       //!< Array with the LOS Elevation of the valid satellites
+    double d_visible_satellites_Az[PVT_MAX_CHANNELS];       //!< Array with the LOS Azimuth of the valid satellites
+    double d_visible_satellites_Distance[PVT_MAX_CHANNELS]; //!< Array with the LOS Distance of the valid satellites
+    double d_visible_satellites_CN0_dB[PVT_MAX_CHANNELS];   //!< Array with the IDs of the valid satellites
+
+    boost::posix_time::ptime d_position_UTC_time;
+    bool b_valid_position;
+
+    double d_latitude_d;  //!< Latitude in degrees
+    double d_longitude_d; //!< Longitude in degrees
+    double d_height_m;    //!< Height [m]
+
+    double d_avg_latitude_d;  //!< Averaged latitude in degrees
+    double d_avg_longitude_d; //!< Averaged longitude in degrees
+    double d_avg_height_m;    //!< Averaged height [m]
+
+    double d_x_m;
+    double d_y_m;
+    double d_z_m;
+
+    double d_rx_clock_bias_m;    //!< Receiver clock bias, times the speed of light [m]
+    double d_rx_clock_drift_m_s; //!< Receiver clock drift, times the speed of light [m/s]
+    double d_rx_clock_time_s;    //!< Receiver time of the clock estimate [s]
+
+    // DOP estimations
+    double d_GDOP;
+    double d_PDOP;
+    double d_HDOP;
+    double d_VDOP;
+    double d_TDOP;
+
+    bool d_flag_averaging;
+
+    Pvt_Solution()
+    {
+        d_valid_observations = 0;
+        for (int i = 0; i < PVT_MAX_CHANNELS; i++)
+            {
+                d_visible_satellites_IDs[i] = 0;
+                d_visible_satellites_El[i] = 0.0;
+                d_visible_satellites_Az[i] = 0.0;
+                d_visible_satellites_Distance[i] = 0.0;
+                d_visible_satellites_CN0_dB[i] = 0.0;
+            }
+        b_valid_position = false;
+        d_latitude_d = 0.0;
+        d_longitude_d = 0.0;
+        d_height_m = 0.0;
+        d_avg_latitude_d = 0.0;
+        d_avg_longitude_d = 0.0;
+        d_avg_height_m = 0.0;
+        d_x_m = 0.0;
+        d_y_m = 0.0;
+        d_z_m = 0.0;
+        d_rx_clock_bias_m = 0.0;
+        d_rx_clock_drift_m_s = 0.0;
+        d_rx_clock_time_s = 0.0;
+        d_GDOP = 0.0;
+        d_PDOP = 0.0;
+        d_HDOP = 0.0;
+        d_VDOP = 0.0;
+        d_TDOP = 0.0;
+        d_flag_averaging = false;
+    }
+
+    /*!
+     * \brief Stores the receiver clock of a new fix taken at receiver time \p t_s.
+     * Without a filtered drift, it is estimated from the previous bias, if that is recent.
+     */
+    void set_rx_clock(double bias_m, double t_s, bool has_drift, double drift_m_s)
+    {
+        double dt = t_s - d_rx_clock_time_s;
+        if (has_drift)
+            {
+                d_rx_clock_drift_m_s = drift_m_s;
+            }
+        else if (d_rx_clock_time_s > 0.0 and dt > 0.0 and dt < 10.0)
+            {
+                d_rx_clock_drift_m_s = (bias_m - d_rx_clock_bias_m) / dt;
+            }
+        else
+            {
+                d_rx_clock_drift_m_s = 0.0;
+            }
+        d_rx_clock_bias_m = bias_m;
+        d_rx_clock_time_s = t_s;
+    }
+
+    //! The latest fix, as kept in the receiver state
+    Gnss_Receiver_Fix receiver_fix() const
+    {
+        Gnss_Receiver_Fix fix;
+        fix.valid = b_valid_position;
+        fix.utc_time_s = (d_position_UTC_time - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_milliseconds() / 1000.0;
+        fix.latitude_d = d_latitude_d;
+        fix.longitude_d = d_longitude_d;
+        fix.height_m = d_height_m;
+        fix.x_m = d_x_m;
+        fix.y_m = d_y_m;
+        fix.z_m = d_z_m;
+        fix.clock_bias_m = d_rx_clock_bias_m;
+        fix.clock_drift_m_s = d_rx_clock_drift_m_s;
+        return fix;
+    }
+};
+
+#endif
@@ -0,0 +1,220 @@
+/*!
+ * \file pvt_stream_server.cc
+ * \brief TCP server that streams the RTCM or NMEA output of the PVT block
+ * to any number of local clients
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pvt_stream_server.h"
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+Pvt_Stream_Server::Pvt_Stream_Server(const std::string& address, unsigned short port, unsigned int client_queue_size) :
+        d_acceptor(d_io_service)
+{
+    if (client_queue_size < 1)
+        {
+            client_queue_size = 1;
+        }
+    d_address = address;
+    d_port = port;
+    d_client_queue_size = client_queue_size;
+    d_running = false;
+    d_clients = 0;
+    d_sent = 0;
+    d_dropped = 0;
+}
+
+
+Pvt_Stream_Server::~Pvt_Stream_Server()
+{
+    stop();
+}
+
+
+bool Pvt_Stream_Server::start()
+{
+    if (d_running == true)
+        {
+            return true;
+        }
+    try
+    {
+            boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address::from_string(d_address), d_port);
+            d_acceptor.open(endpoint.protocol());
+            d_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+            d_acceptor.bind(endpoint);
+            d_acceptor.listen();
+            d_port = d_acceptor.local_endpoint().port();
+    }
+    catch (const boost::system::system_error& e)
+    {
+            LOG(WARNING) << "Cannot listen on " << d_address << ":" << d_port << ": " << e.what();
+            boost::system::error_code ec;
+            d_acceptor.close(ec);
+            return false;
+    }
+    accept();
+    d_running = true;
+    d_io_service.reset();
+    d_thread = boost::thread([this]() { d_io_service.run(); });
+    LOG(INFO) << "Streaming server listening on " << d_address << ":" << d_port;
+    return true;
+}
+
+
+void Pvt_Stream_Server::stop()
+{
+    if (d_running == false)
+        {
+            return;
+        }
+    // once the acceptor and the sockets are closed the server thread runs out of work and returns
+    d_io_service.post([this]()
+            {
+                boost::system::error_code ec;
+                d_acceptor.close(ec);
+                while (d_client_list.empty() == false)
+                    {
+                        close(d_client_list.front());
+                    }
+            });
+    d_thread.join();
+    d_running = false;
+    LOG(INFO) << "Streaming server on TCP port " << d_port << ": " << d_sent << " messages sent, " << d_dropped << " dropped";
+}
+
+
+void Pvt_Stream_Server::publish(const char* data, std::size_t length)
+{
+    if (d_clients == 0 or length == 0)
+        {
+            return;
+        }
+    std::shared_ptr<const std::string> message = std::make_shared<const std::string>(data, length);
+    d_io_service.post([this, message]() { deliver(message); });
+}
+
+
+void Pvt_Stream_Server::accept()
+{
+    Stream_Client_Ptr client = std::make_shared<Stream_Client>(d_io_service);
+    d_acceptor.async_accept(client->socket, [this, client](const boost::system::error_code& error)
+            {
+                if (error)
+                    {
+                        if (error != boost::asio::error::operation_aborted)
+                            {
+                                LOG(WARNING) << "Streaming server accept error: " << error.message();
+                                accept();
+                            }
+                        return;
+                    }
+                boost::system::error_code ec;
+                client->socket.set_option(boost::asio::ip::tcp::no_delay(true), ec);
+                d_client_list.push_back(client);
+                d_clients = d_client_list.size();
+                DLOG(INFO) << "Streaming client connected on TCP port " << d_port;
+                read(client);
+                accept();
+            });
+}
+
+
+void Pvt_Stream_Server::deliver(const std::shared_ptr<const std::string>& message)
+{
+    for (std::list<Stream_Client_Ptr>::iterator it = d_client_list.begin(); it != d_client_list.end(); ++it)
+        {
+            const Stream_Client_Ptr& client = *it;
+            if (client->queue.size() >= d_client_queue_size)
+                {
+                    unsigned long int dropped = d_dropped.fetch_add(1) + 1;
+                    if (dropped == 1 or dropped % 1000 == 0)
+                        {
+                            LOG(WARNING) << "Streaming client on TCP port " << d_port << " is too slow, " << dropped << " messages dropped";
+                        }
+                    continue;
+                }
+            client->queue.push_back(message);
+            if (client->writing == false)
+                {
+                    write(client);
+                }
+        }
+}
+
+
+void Pvt_Stream_Server::write(const Stream_Client_Ptr& client)
+{
+    // the handler keeps the message alive, close() may clear the queue before it runs
+    std::shared_ptr<const std::string> message = client->queue.front();
+    client->writing = true;
+    boost::asio::async_write(client->socket, boost::asio::buffer(*message),
+            [this, client, message](const boost::system::error_code& error, std::size_t)
+            {
+                client->writing = false;
+                if (error or client->socket.is_open() == false)
+                    {
+                        close(client);
+                        return;
+                    }
+                d_sent++;
+                client->queue.pop_front();
+                if (client->queue.empty() == false)
+                    {
+                        write(client);
+                    }
+            });
+}
+
+
+void Pvt_Stream_Server::read(const Stream_Client_Ptr& client)
+{
+    // incoming data is discarded, reading only detects the disconnections
+    client->socket.async_read_some(boost::asio::buffer(client->read_buffer, sizeof(client->read_buffer)),
+            [this, client](const boost::system::error_code& error, std::size_t)
+            {
+                if (error)
+                    {
+                        close(client);
+                        return;
+                    }
+                read(client);
+            });
+}
+
+
+void Pvt_Stream_Server::close(const Stream_Client_Ptr& client)
+{
+    boost::system::error_code ec;
+    client->socket.close(ec);
+    client->queue.clear();
+    d_client_list.remove(client);
+    d_clients = d_client_list.size();
+}
@@ -0,0 +1,122 @@
+/*!
+ * \file pvt_stream_server.h
+ * \brief TCP server that streams the RTCM or NMEA output of the PVT block
+ * to any number of local clients
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PVT_STREAM_SERVER_H_
+#define GNSS_SDR_PVT_STREAM_SERVER_H_
+
+#include <atomic>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <boost/asio.hpp>
+#include <boost/thread.hpp>
+
+/*!
+ * \brief This class implements a TCP server that sends every published
+ * message (an RTCM frame or a group of NMEA sentences) to all the connected
+ * clients.
+ *
+ * The sockets are served asynchronously by a dedicated thread. Each client
+ * has its own queue of at most client_queue_size messages: when a client
+ * does not read fast enough its queue fills up and the new messages are
+ * dropped for that client only, whole messages at a time so that the
+ * stream stays decodable. publish() only posts the message to the server
+ * thread, so the PVT block is never blocked by the network.
+ * Data received from the clients is ignored.
+ */
+class Pvt_Stream_Server
+{
+public:
+    /*!
+     * \brief Constructor.
+     * \param[in] address Local address to listen on (e.g. 127.0.0.1, or 0.0.0.0 for all the interfaces)
+     * \param[in] port TCP port to listen on (0 lets the system choose one, see port())
+     * \param[in] client_queue_size Maximum number of messages waiting to be sent to each client
+     */
+    Pvt_Stream_Server(const std::string& address, unsigned short port, unsigned int client_queue_size);
+
+    /*!
+     * \brief Destructor. Closes the connections and stops the server thread.
+     */
+    ~Pvt_Stream_Server();
+
+    /*!
+     * \brief Starts listening and the server thread. Returns false if the address or the port cannot be used.
+     */
+    bool start();
+
+    /*!
+     * \brief Closes the connections and stops the server thread
+     */
+    void stop();
+
+    /*!
+     * \brief Sends \p length bytes of \p data to every connected client. Can be called from any thread.
+     */
+    void publish(const char* data, std::size_t length);
+
+    unsigned short port() const { return d_port; }          //!< Port the server is listening on
+    unsigned int clients() const { return d_clients; }      //!< Number of connected clients
+    unsigned long int sent() const { return d_sent; }       //!< Messages sent, summed over the clients
+    unsigned long int dropped() const { return d_dropped; } //!< Messages dropped by full client queues
+
+private:
+    struct Stream_Client
+    {
+        boost::asio::ip::tcp::socket socket;
+        std::deque<std::shared_ptr<const std::string> > queue;
+        bool writing;
+        char read_buffer[256];
+        Stream_Client(boost::asio::io_service& io_service) : socket(io_service), writing(false) {}
+    };
+    typedef std::shared_ptr<Stream_Client> Stream_Client_Ptr;
+
+    void accept();
+    void deliver(const std::shared_ptr<const std::string>& message);
+    void write(const Stream_Client_Ptr& client);
+    void read(const Stream_Client_Ptr& client);
+    void close(const Stream_Client_Ptr& client);
+
+    boost::asio::io_service d_io_service;
+    boost::asio::ip::tcp::acceptor d_acceptor;
+    std::list<Stream_Client_Ptr> d_client_list;  // only used by the server thread
+    boost::thread d_thread;
+    std::string d_address;
+    unsigned short d_port;
+    unsigned int d_client_queue_size;
+    bool d_running;
+    std::atomic<unsigned int> d_clients;
+    std::atomic<unsigned long int> d_sent;
+    std::atomic<unsigned long int> d_dropped;
+};
+
+#endif
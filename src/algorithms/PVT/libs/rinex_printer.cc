@@ -176,6 +176,7 @@ Rinex_Printer::Rinex_Printer()
         }
 
     numberTypesObservations = 4; // Number of available types of observable in the system
+    lineLength = 0;
 }
 
 
@@ -922,476 +923,245 @@ void Rinex_Printer::rinex_sbs_header(std::ofstream& out)
 }
 
 
+void Rinex_Printer::lineWrite(std::ofstream& out, const bool check_length)
+{
+    if (check_length and lineLength != 80)
+        {
+            LOG(ERROR) << "Bad defined RINEX line: "
+                    << lineLength << " characters (must be 80)" << std::endl
+                    << std::string(lineBuffer, lineLength) << std::endl
+                    << "----|---1|0---|---2|0---|---3|0---|---4|0---|---5|0---|---6|0---|---7|0---|---8|" << std::endl;
+        }
+    lineBuffer[lineLength < RINEX_LINE_BUFFER_LENGTH ? lineLength : RINEX_LINE_BUFFER_LENGTH - 1] = '\n';
+    out.write(lineBuffer, (lineLength < RINEX_LINE_BUFFER_LENGTH ? lineLength : RINEX_LINE_BUFFER_LENGTH - 1) + 1);
+}
+
+
+void Rinex_Printer::lineAppendNavEpoch(const boost::posix_time::ptime& p, const bool four_digit_year)
+{
+    boost::gregorian::date::ymd_type ymd = p.date().year_month_day();
+    boost::posix_time::time_duration tod = p.time_of_day();
+    if (four_digit_year)
+        {
+            lineAppendInt(static_cast<int>(ymd.year), 4);
+        }
+    else
+        {
+            lineAppendTwoDigits(static_cast<int>(ymd.year));
+        }
+    lineAppend(' ');
+    lineAppendTwoDigits(static_cast<int>(ymd.month));
+    lineAppend(' ');
+    lineAppendTwoDigits(static_cast<int>(ymd.day));
+    lineAppend(' ');
+    lineAppendTwoDigits(static_cast<int>(tod.hours()));
+    lineAppend(' ');
+    lineAppendTwoDigits(static_cast<int>(tod.minutes()));
+    lineAppend(' ');
+    lineAppendTwoDigits(static_cast<int>(tod.seconds()));
+}
+
+
+void Rinex_Printer::logBroadcastOrbit(std::ofstream& out, const int record_version, const double a, const double b, const double c, const double d)
+{
+    lineClear();
+    lineAppend(' ', record_version == 2 ? 4 : 5);
+    lineAppendFor(a);
+    lineAppend(' ');
+    lineAppendFor(b);
+    lineAppend(' ');
+    lineAppendFor(c);
+    lineAppend(' ');
+    lineAppendFor(d);
+    if (record_version == 2)
+        {
+            lineAppend(' ');
+        }
+    lineWrite(out, true);
+}
+
+
 void Rinex_Printer::log_rinex_nav(std::ofstream& out, const std::map<int,Gps_Ephemeris>& eph_map)
 {
-    std::string line;
     std::map<int,Gps_Ephemeris>::const_iterator gps_ephemeris_iter;
+    const char system = satelliteSystem["GPS"].at(0);
 
     for(gps_ephemeris_iter = eph_map.begin();
-    		gps_ephemeris_iter != eph_map.end();
-    		gps_ephemeris_iter++)
-    {
-            // -------- SV / EPOCH / SV CLK
-            boost::posix_time::ptime p_utc_time = Rinex_Printer::compute_GPS_time(gps_ephemeris_iter->second,gps_ephemeris_iter->second.d_TOW);
-            std::string timestring = boost::posix_time::to_iso_string(p_utc_time);
-            std::string month (timestring, 4, 2);
-            std::string day (timestring, 6, 2);
-            std::string hour (timestring, 9, 2);
-            std::string minutes (timestring, 11, 2);
-            std::string seconds (timestring, 13, 2);
-            if (version == 2)
-                {
-                    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(gps_ephemeris_iter->second.i_satellite_PRN), 2);
-                    line += std::string(1, ' ');
-                    std::string year (timestring, 2, 2);
-                    line += year;
-                    line += std::string(1, ' ');
-                    line += month;
-                    line += std::string(1, ' ');
-                    line += day;
-                    line += std::string(1, ' ');
-                    line += hour;
-                    line += std::string(1, ' ');
-                    line += minutes;
-                    line += std::string(1, ' ');
-                    line += seconds;
-                    line += std::string(1, '.');
-                    std::string decimal = std::string("0");
-                    if (timestring.size() > 16)
-                        {
-                            std::string decimal (timestring, 16, 1);
-                        }
-                    line += decimal;
-                    line += std::string(1, ' ');
-                    line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_A_f0, 18, 2);
-                    line += std::string(1, ' ');
-                    line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_A_f1, 18, 2);
-                    line += std::string(1, ' ');
-                    line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_A_f2, 18, 2);
-                    line += std::string(1, ' ');
-                }
-            if (version == 3)
+            gps_ephemeris_iter != eph_map.end();
+            gps_ephemeris_iter++)
+        {
+            const Gps_Ephemeris& eph = gps_ephemeris_iter->second;
+
+            // IODE is not present in ephemeris data, (IODC, Toe) identifies the issue of data
+            std::map<int, std::pair<double, double> >::iterator logged = gpsEphemerisLogged.find(eph.i_satellite_PRN);
+            if (logged != gpsEphemerisLogged.end() and logged->second.first == eph.d_IODC and logged->second.second == eph.d_Toe)
                 {
-                    line += satelliteSystem["GPS"];
-                    if (gps_ephemeris_iter->second.i_satellite_PRN < 10)  line += std::string("0");
-                    line += boost::lexical_cast<std::string>(gps_ephemeris_iter->second.i_satellite_PRN);
-                    std::string year (timestring, 0, 4);
-                    line += std::string(1, ' ');
-                    line += year;
-                    line += std::string(1, ' ');
-                    line += month;
-                    line += std::string(1, ' ');
-                    line += day;
-                    line += std::string(1, ' ');
-                    line += hour;
-                    line += std::string(1, ' ');
-                    line += minutes;
-                    line += std::string(1, ' ');
-                    line += seconds;
-                    line += std::string(1, ' ');
-                    line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_A_f0, 18, 2);
-                    line += std::string(1, ' ');
-                    line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_A_f1, 18, 2);
-                    line += std::string(1, ' ');
-                    line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_A_f2, 18, 2);
+                    continue;
                 }
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
-
-            // -------- BROADCAST ORBIT - 1
-            line.clear();
+            gpsEphemerisLogged[eph.i_satellite_PRN] = std::make_pair(eph.d_IODC, eph.d_Toe);
 
+            // -------- SV / EPOCH / SV CLK
+            boost::posix_time::ptime p_utc_time = Rinex_Printer::compute_GPS_time(eph, eph.d_TOW);
+            lineClear();
             if (version == 2)
                 {
-                    line += std::string(4, ' ');
+                    lineAppendInt(eph.i_satellite_PRN, 2);
+                    lineAppend(' ');
+                    lineAppendNavEpoch(p_utc_time, false);
+                    lineAppend(".0 ", 3);
+                    lineAppendFor(eph.d_A_f0);
+                    lineAppend(' ');
+                    lineAppendFor(eph.d_A_f1);
+                    lineAppend(' ');
+                    lineAppendFor(eph.d_A_f2);
+                    lineAppend(' ');
                 }
             if (version == 3)
                 {
-                    line += std::string(5, ' ');
+                    lineAppend(system);
+                    if (eph.i_satellite_PRN < 10) lineAppend('0');
+                    lineAppendInt(eph.i_satellite_PRN, 0);
+                    lineAppend(' ');
+                    lineAppendNavEpoch(p_utc_time, true);
+                    lineAppend(' ');
+                    lineAppendFor(eph.d_A_f0);
+                    lineAppend(' ');
+                    lineAppendFor(eph.d_A_f1);
+                    lineAppend(' ');
+                    lineAppendFor(eph.d_A_f2);
                 }
-            // IODE is not present in ephemeris data
+            lineWrite(out, true);
+
+            // -------- BROADCAST ORBIT - 1
             // If there is a discontinued reception the ephemeris is not validated
-            //if (gps_ephemeris_iter->second.d_IODE_SF2 == gps_ephemeris_iter->second.d_IODE_SF3)
-            //    {
-            //        line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_IODE_SF2, 18, 2);
-            //    }
-            //else
-            //    {
-            //        LOG(ERROR) << "Discontinued reception of Frame 2 and 3 " << std::endl;
-            //    }
             double d_IODE_SF2 = 0;
-            line += Rinex_Printer::doub2for(d_IODE_SF2, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_Crs, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_Delta_n, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_M_0, 18, 2);
-            if (version == 2)
-                {
-                    line += std::string(1, ' ');
-                }
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
+            logBroadcastOrbit(out, version, d_IODE_SF2, eph.d_Crs, eph.d_Delta_n, eph.d_M_0);
 
             // -------- BROADCAST ORBIT - 2
-            line.clear();
-            if (version == 2)
-                {
-                    line += std::string(4, ' ');
-                }
-            if (version == 3)
-                {
-                    line += std::string(5, ' ');
-                }
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_Cuc, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_e_eccentricity, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_Cus, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_sqrt_A, 18, 2);
-            if (version == 2)
-                {
-                    line += std::string(1, ' ');
-                }
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
-
+            logBroadcastOrbit(out, version, eph.d_Cuc, eph.d_e_eccentricity, eph.d_Cus, eph.d_sqrt_A);
 
             // -------- BROADCAST ORBIT - 3
-            line.clear();
-            if (version == 2)
-                {
-                    line += std::string(4, ' ');
-                }
-            if (version == 3)
-                {
-                    line += std::string(5, ' ');
-                }
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_Toe, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_Cic, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_OMEGA0, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_Cis, 18, 2);
-            if (version == 2)
-                {
-                    line += std::string(1, ' ');
-                }
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
-
-
+            logBroadcastOrbit(out, version, eph.d_Toe, eph.d_Cic, eph.d_OMEGA0, eph.d_Cis);
 
             // -------- BROADCAST ORBIT - 4
-            line.clear();
-            if (version == 2)
-                {
-                    line += std::string(4, ' ');
-                }
-            if (version == 3)
-                {
-                    line += std::string(5, ' ');
-                }
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_i_0, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_Crc, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_OMEGA, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_OMEGA_DOT, 18, 2);
-            if (version == 2)
-                {
-                    line += std::string(1, ' ');
-                }
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
-
+            logBroadcastOrbit(out, version, eph.d_i_0, eph.d_Crc, eph.d_OMEGA, eph.d_OMEGA_DOT);
 
             // -------- BROADCAST ORBIT - 5
-            line.clear();
-            if (version == 2)
-                {
-                    line += std::string(4, ' ');
-                }
-            if (version == 3)
-                {
-                    line += std::string(5, ' ');
-                }
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_IDOT, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(static_cast<double>(gps_ephemeris_iter->second.i_code_on_L2), 18, 2);
-            line += std::string(1, ' ');
-            double GPS_week_continuous_number = static_cast<double>(gps_ephemeris_iter->second.i_GPS_week + 1024); // valid until April 7, 2019 (check http://www.colorado.edu/geography/gcraft/notes/gps/gpseow.htm)
-            line += Rinex_Printer::doub2for(GPS_week_continuous_number, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(static_cast<double>(gps_ephemeris_iter->second.i_code_on_L2), 18, 2);
-            if (version == 2)
-                {
-                    line += std::string(1, ' ');
-                }
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
+            double GPS_week_continuous_number = static_cast<double>(eph.i_GPS_week + 1024); // valid until April 7, 2019 (check http://www.colorado.edu/geography/gcraft/notes/gps/gpseow.htm)
+            logBroadcastOrbit(out, version, eph.d_IDOT, static_cast<double>(eph.i_code_on_L2), GPS_week_continuous_number, static_cast<double>(eph.i_code_on_L2));
 
             // -------- BROADCAST ORBIT - 6
-            line.clear();
-            if (version == 2)
-                {
-                    line += std::string(4, ' ');
-                }
-            if (version == 3)
-                {
-                    line += std::string(5, ' ');
-                }
-            line += Rinex_Printer::doub2for(static_cast<double>(gps_ephemeris_iter->second.i_SV_accuracy), 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(static_cast<double>(gps_ephemeris_iter->second.i_SV_health), 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_TGD, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_IODC, 18, 2);
-            if (version == 2)
-                {
-                    line += std::string(1, ' ');
-                }
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
+            logBroadcastOrbit(out, version, static_cast<double>(eph.i_SV_accuracy), static_cast<double>(eph.i_SV_health), eph.d_TGD, eph.d_IODC);
 
             // -------- BROADCAST ORBIT - 7
-            line.clear();
-            if (version == 2)
-                {
-                    line += std::string(4, ' ');
-                }
-            if (version == 3)
-                {
-                    line += std::string(5, ' ');
-                }
-            line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_TOW, 18, 2);
-            line += std::string(1, ' ');
             double curve_fit_interval = 4;
-
-            if (gps_ephemeris_iter->second.satelliteBlock.at(gps_ephemeris_iter->second.i_satellite_PRN).compare("IIA"))
+            const std::string& block = eph.satelliteBlock.at(eph.i_satellite_PRN);
+            if (block.compare("IIA"))
                 {
                     // Block II/IIA (Table 20-XI IS-GPS-200E )
-                    if ( (gps_ephemeris_iter->second.d_IODC > 239) && (gps_ephemeris_iter->second.d_IODC < 248) )  curve_fit_interval = 8;
-                    if ( ( (gps_ephemeris_iter->second.d_IODC > 247) && (gps_ephemeris_iter->second.d_IODC < 256) ) || (gps_ephemeris_iter->second.d_IODC == 496) ) curve_fit_interval = 14;
-                    if ( (gps_ephemeris_iter->second.d_IODC > 496) && (gps_ephemeris_iter->second.d_IODC < 504) ) curve_fit_interval = 26;
-                    if ( (gps_ephemeris_iter->second.d_IODC > 503) && (gps_ephemeris_iter->second.d_IODC < 511) )  curve_fit_interval = 50;
-                    if ( ( (gps_ephemeris_iter->second.d_IODC > 751) && (gps_ephemeris_iter->second.d_IODC < 757) ) || (gps_ephemeris_iter->second.d_IODC == 511) ) curve_fit_interval = 74;
-                    if ( gps_ephemeris_iter->second.d_IODC == 757 ) curve_fit_interval = 98;
+                    if ( (eph.d_IODC > 239) && (eph.d_IODC < 248) )  curve_fit_interval = 8;
+                    if ( ( (eph.d_IODC > 247) && (eph.d_IODC < 256) ) || (eph.d_IODC == 496) ) curve_fit_interval = 14;
+                    if ( (eph.d_IODC > 496) && (eph.d_IODC < 504) ) curve_fit_interval = 26;
+                    if ( (eph.d_IODC > 503) && (eph.d_IODC < 511) )  curve_fit_interval = 50;
+                    if ( ( (eph.d_IODC > 751) && (eph.d_IODC < 757) ) || (eph.d_IODC == 511) ) curve_fit_interval = 74;
+                    if ( eph.d_IODC == 757 ) curve_fit_interval = 98;
                 }
 
-            if ((gps_ephemeris_iter->second.satelliteBlock.at(gps_ephemeris_iter->second.i_satellite_PRN).compare("IIR") == 0) ||
-                    (gps_ephemeris_iter->second.satelliteBlock.at(gps_ephemeris_iter->second.i_satellite_PRN).compare("IIR-M") == 0) ||
-                    (gps_ephemeris_iter->second.satelliteBlock.at(gps_ephemeris_iter->second.i_satellite_PRN).compare("IIF") == 0) ||
-                    (gps_ephemeris_iter->second.satelliteBlock.at(gps_ephemeris_iter->second.i_satellite_PRN).compare("IIIA") == 0) )
+            if ((block.compare("IIR") == 0) ||
+                    (block.compare("IIR-M") == 0) ||
+                    (block.compare("IIF") == 0) ||
+                    (block.compare("IIIA") == 0) )
                 {
                     // Block IIR/IIR-M/IIF/IIIA (Table 20-XII IS-GPS-200E )
-                    if ( (gps_ephemeris_iter->second.d_IODC > 239) && (gps_ephemeris_iter->second.d_IODC < 248))  curve_fit_interval = 8;
-                    if ( ( (gps_ephemeris_iter->second.d_IODC > 247) && (gps_ephemeris_iter->second.d_IODC < 256)) || (gps_ephemeris_iter->second.d_IODC == 496) ) curve_fit_interval = 14;
-                    if ( ( (gps_ephemeris_iter->second.d_IODC > 496) && (gps_ephemeris_iter->second.d_IODC < 504)) || ( (gps_ephemeris_iter->second.d_IODC > 1020) && (gps_ephemeris_iter->second.d_IODC < 1024) ) ) curve_fit_interval = 26;
+                    if ( (eph.d_IODC > 239) && (eph.d_IODC < 248))  curve_fit_interval = 8;
+                    if ( ( (eph.d_IODC > 247) && (eph.d_IODC < 256)) || (eph.d_IODC == 496) ) curve_fit_interval = 14;
+                    if ( ( (eph.d_IODC > 496) && (eph.d_IODC < 504)) || ( (eph.d_IODC > 1020) && (eph.d_IODC < 1024) ) ) curve_fit_interval = 26;
                 }
-            line += Rinex_Printer::doub2for(curve_fit_interval, 18, 2);
-            line += std::string(1, ' ');
-            line += std::string(18, ' '); // spare
-            line += std::string(1, ' ');
-            line += std::string(18, ' '); // spare
+            lineClear();
+            lineAppend(' ', version == 2 ? 4 : 5);
+            lineAppendFor(eph.d_TOW);
+            lineAppend(' ');
+            lineAppendFor(curve_fit_interval);
+            lineAppend(' ', 1 + 18 + 1 + 18); // spare
             if (version == 2)
                 {
-                    line += std::string(1, ' ');
+                    lineAppend(' ');
                 }
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-            line.clear();
+            lineWrite(out, true);
         }
 }
 
 
 void Rinex_Printer::log_rinex_nav(std::ofstream& out, const std::map<int, Galileo_Ephemeris>& eph_map)
 {
-    std::string line;
     std::map<int,Galileo_Ephemeris>::const_iterator galileo_ephemeris_iter;
-    line.clear();
+    const char system = satelliteSystem["Galileo"].at(0);
     for(galileo_ephemeris_iter = eph_map.begin();
             galileo_ephemeris_iter != eph_map.end();
             galileo_ephemeris_iter++)
         {
-            // -------- SV / EPOCH / SV CLK
-            boost::posix_time::ptime p_utc_time = Rinex_Printer::compute_Galileo_time(galileo_ephemeris_iter->second, galileo_ephemeris_iter->second.TOW_5);
-            std::string timestring = boost::posix_time::to_iso_string(p_utc_time);
-            std::string month (timestring, 4, 2);
-            std::string day (timestring, 6, 2);
-            std::string hour (timestring, 9, 2);
-            std::string minutes (timestring, 11, 2);
-            std::string seconds (timestring, 13, 2);
-
-            line += satelliteSystem["Galileo"];
-            if (galileo_ephemeris_iter->second.i_satellite_PRN < 10)  line += std::string("0");
-            line += boost::lexical_cast<std::string>(galileo_ephemeris_iter->second.i_satellite_PRN);
-            std::string year (timestring, 0, 4);
-            line += std::string(1, ' ');
-            line += year;
-            line += std::string(1, ' ');
-            line += month;
-            line += std::string(1, ' ');
-            line += day;
-            line += std::string(1, ' ');
-            line += hour;
-            line += std::string(1, ' ');
-            line += minutes;
-            line += std::string(1, ' ');
-            line += seconds;
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.af0_4, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.af1_4, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.af2_4, 18, 2);
+            const Galileo_Ephemeris& eph = galileo_ephemeris_iter->second;
 
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            std::map<int, int>::iterator logged = galileoEphemerisLogged.find(eph.i_satellite_PRN);
+            if (logged != galileoEphemerisLogged.end() and logged->second == eph.IOD_ephemeris)
+                {
+                    continue;
+                }
+            galileoEphemerisLogged[eph.i_satellite_PRN] = eph.IOD_ephemeris;
 
+            // -------- SV / EPOCH / SV CLK
+            boost::posix_time::ptime p_utc_time = Rinex_Printer::compute_Galileo_time(eph, eph.TOW_5);
+            lineClear();
+            lineAppend(system);
+            if (eph.i_satellite_PRN < 10) lineAppend('0');
+            lineAppendInt(eph.i_satellite_PRN, 0);
+            lineAppend(' ');
+            lineAppendNavEpoch(p_utc_time, true);
+            lineAppend(' ');
+            lineAppendFor(eph.af0_4);
+            lineAppend(' ');
+            lineAppendFor(eph.af1_4);
+            lineAppend(' ');
+            lineAppendFor(eph.af2_4);
+            lineWrite(out, true);
 
             // -------- BROADCAST ORBIT - 1
-            line.clear();
-            line += std::string(5, ' ');
-            line += Rinex_Printer::doub2for(static_cast<double>(galileo_ephemeris_iter->second.IOD_ephemeris), 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.C_rs_3, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.delta_n_3, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.M0_1, 18, 2);
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
+            logBroadcastOrbit(out, 3, static_cast<double>(eph.IOD_ephemeris), eph.C_rs_3, eph.delta_n_3, eph.M0_1);
 
             // -------- BROADCAST ORBIT - 2
-            line.clear();
-            line += std::string(5, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.C_uc_3, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.e_1, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.C_us_3, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.A_1, 18, 2);
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
+            logBroadcastOrbit(out, 3, eph.C_uc_3, eph.e_1, eph.C_us_3, eph.A_1);
 
             // -------- BROADCAST ORBIT - 3
-            line.clear();
-            line += std::string(5, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.t0e_1, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.C_ic_4, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.OMEGA_0_2, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.C_is_4, 18, 2);
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
+            logBroadcastOrbit(out, 3, eph.t0e_1, eph.C_ic_4, eph.OMEGA_0_2, eph.C_is_4);
 
             // -------- BROADCAST ORBIT - 4
-            line.clear();
-            line += std::string(5, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.i_0_2, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.C_rc_3, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.omega_2, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.OMEGA_dot_3, 18, 2);
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
+            logBroadcastOrbit(out, 3, eph.i_0_2, eph.C_rc_3, eph.omega_2, eph.OMEGA_dot_3);
 
             // -------- BROADCAST ORBIT - 5
-            line.clear();
-            line += std::string(5, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.iDot_2, 18, 2);
-            line += std::string(1, ' ');
-            //double one = 1.0; // INAV E1-B
-            std::string iNAVE1B("1000000001");
-            int data_source_INAV = Rinex_Printer::toInt(iNAVE1B, 10);
-            line += Rinex_Printer::doub2for(static_cast<double>(data_source_INAV), 18, 2);
-            line += std::string(1, ' ');
-            double GST_week = static_cast<double>(galileo_ephemeris_iter->second.WN_5);
+            int data_source_INAV = 513; // INAV E1-B, bits 0 and 9
+            double GST_week = static_cast<double>(eph.WN_5);
             double num_GST_rollovers = floor((GST_week + 1024.0) / 4096.0 );
             double Galileo_week_continuous_number = GST_week + 1024.0 + num_GST_rollovers * 4096.0;
-            line += Rinex_Printer::doub2for(Galileo_week_continuous_number, 18, 2);
-            line += std::string(1, ' ');
             double zero = 0.0;
-            line += Rinex_Printer::doub2for(zero, 18, 2);
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
+            logBroadcastOrbit(out, 3, eph.iDot_2, static_cast<double>(data_source_INAV), Galileo_week_continuous_number, zero);
 
             // -------- BROADCAST ORBIT - 6
-            line.clear();
-            line += std::string(5, ' ');
-            //line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.SISA_3, 18, 2);
-            line += Rinex_Printer::doub2for(zero, 18, 2);  // *************** CHANGE THIS WHEN GALILEO SIGNAL IS VALID
-            line += std::string(1, ' ');
-            std::string E1B_HS;
-            std::string E5B_HS;
-            if(galileo_ephemeris_iter->second.E1B_HS_5 == 0) E1B_HS = "00";
-            if(galileo_ephemeris_iter->second.E1B_HS_5 == 1) E1B_HS = "01";
-            if(galileo_ephemeris_iter->second.E1B_HS_5 == 2) E1B_HS = "10";
-            if(galileo_ephemeris_iter->second.E1B_HS_5 == 3) E1B_HS = "11";
-            if(galileo_ephemeris_iter->second.E5b_HS_5 == 0) E5B_HS = "00";
-            if(galileo_ephemeris_iter->second.E5b_HS_5 == 1) E5B_HS = "01";
-            if(galileo_ephemeris_iter->second.E5b_HS_5 == 2) E5B_HS = "10";
-            if(galileo_ephemeris_iter->second.E5b_HS_5 == 3) E5B_HS = "11";
-
-            if(E1B_HS == "11") LOG(WARNING) << "Signal Component currently in Test";
-            if(E1B_HS == "10") LOG(WARNING) << "Signal will be out of service";
-            if(E1B_HS == "01") LOG(WARNING) << "Signal out of service";
-            E1B_HS = "00";  // *************** CHANGE THIS WHEN GALILEO SIGNAL IS VALID
-
-            std::string E1B_DVS = boost::lexical_cast<std::string>(galileo_ephemeris_iter->second.E1B_DVS_5);
-            if(E1B_DVS == "1") LOG(WARNING) << "Navigation data without guarantee";
-            E1B_DVS = "0"; // *************** CHANGE THIS WHEN GALILEO SIGNAL IS VALID
-
-            std::string SVhealth_str = E5B_HS + boost::lexical_cast<std::string>(galileo_ephemeris_iter->second.E5b_DVS_5)
-                    + "11" + "1" + E1B_DVS +  E1B_HS
-                    + boost::lexical_cast<std::string>(galileo_ephemeris_iter->second.E1B_DVS_5);
-            SVhealth_str = "000000000"; // *************** CHANGE THIS WHEN GALILEO SIGNAL IS VALID
-            int SVhealth = Rinex_Printer::toInt(SVhealth_str, 9);
-            line += Rinex_Printer::doub2for(static_cast<double>(SVhealth), 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.BGD_E1E5a_5, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.BGD_E1E5b_5, 18, 2);
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
+            if(eph.E1B_HS_5 == 3) LOG(WARNING) << "Signal Component currently in Test";
+            if(eph.E1B_HS_5 == 2) LOG(WARNING) << "Signal will be out of service";
+            if(eph.E1B_HS_5 == 1) LOG(WARNING) << "Signal out of service";
+            if(eph.E1B_DVS_5 == 1) LOG(WARNING) << "Navigation data without guarantee";
+            int SVhealth = 0; // *************** CHANGE THIS WHEN GALILEO SIGNAL IS VALID
+            // SISA: *************** CHANGE THIS WHEN GALILEO SIGNAL IS VALID
+            logBroadcastOrbit(out, 3, zero, static_cast<double>(SVhealth), eph.BGD_E1E5a_5, eph.BGD_E1E5b_5);
 
             // -------- BROADCAST ORBIT - 7
-            line.clear();
-            line += std::string(5, ' ');
-            line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.TOW_5, 18, 2);
-            line += std::string(1, ' ');
-            line += Rinex_Printer::doub2for(zero, 18, 2);
-            line += std::string(1, ' ');
-            line += std::string(18, ' '); // spare
-            line += std::string(1, ' ');
-            line += std::string(18, ' '); // spare
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-            line.clear();
+            lineClear();
+            lineAppend(' ', 5);
+            lineAppendFor(eph.TOW_5);
+            lineAppend(' ');
+            lineAppendFor(zero);
+            lineAppend(' ', 1 + 18 + 1 + 18); // spare
+            lineWrite(out, true);
         }
 }
 
@@ -2098,391 +1868,140 @@ void Rinex_Printer::rinex_obs_header(std::ofstream& out, const Gps_Ephemeris& gp
     out << line << std::endl;
 }
 
-void Rinex_Printer::log_rinex_obs(std::ofstream& out, const Gps_Ephemeris& eph, const double obs_time, const std::map<int,Gnss_Synchro>& pseudoranges)
+void Rinex_Printer::logObservationEpoch(std::ofstream& out, const int record_version, const boost::posix_time::ptime& p, const double obs_time, const std::map<int, Gnss_Synchro>& pseudoranges)
 {
-    // RINEX observations timestamps are GPS timestamps.
-    std::string line;
-
-    boost::posix_time::ptime p_gps_time = Rinex_Printer::compute_GPS_time(eph, obs_time);
-    std::string timestring = boost::posix_time::to_iso_string(p_gps_time);
-    //double utc_t = nav_msg.utc_time(nav_msg.sv_clock_correction(obs_time));
-    //double gps_t = eph.sv_clock_correction(obs_time);
-    double gps_t = obs_time;
-
-    std::string month (timestring, 4, 2);
-    std::string day (timestring, 6, 2);
-    std::string hour (timestring, 9, 2);
-    std::string minutes (timestring, 11, 2);
-
-    if (version == 2)
+    boost::gregorian::date::ymd_type ymd = p.date().year_month_day();
+    boost::posix_time::time_duration tod = p.time_of_day();
+    double seconds = fmod(obs_time, 60);
+    lineClear();
+    if (record_version == 2)
         {
-            line.clear();
-            std::string year (timestring, 2, 2);
-            line += std::string(1, ' ');
-            line += year;
-            line += std::string(1, ' ');
-            if (month.compare(0, 1 , "0") == 0)
-                {
-                    line += std::string(1, ' ');
-                    line += month.substr(1, 1);
-                }
-            else
-                {
-                    line += month;
-                }
-            line += std::string(1, ' ');
-            if (day.compare(0, 1 , "0") == 0)
-                {
-                    line += std::string(1, ' ');
-                    line += day.substr(1, 1);
-                }
-            else
-                {
-                    line += day;
-                }
-            line += std::string(1, ' ');
-            line += hour;
-            line += std::string(1, ' ');
-            line += minutes;
-            line += std::string(1, ' ');
-            line += Rinex_Printer::asString(fmod(gps_t, 60), 7);
-            line += std::string(2, ' ');
-            // Epoch flag 0: OK     1: power failure between previous and current epoch   <1: Special event
-            line += std::string(1, '0');
-            //Number of satellites observed in current epoch
-            int numSatellitesObserved = 0;
-            std::map<int, Gnss_Synchro>::const_iterator pseudoranges_iter;
-            for(pseudoranges_iter = pseudoranges.begin();
-                    pseudoranges_iter != pseudoranges.end();
-                    pseudoranges_iter++)
-                {
-                    numSatellitesObserved++;
-                }
-            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(numSatellitesObserved), 3);
-            for(pseudoranges_iter = pseudoranges.begin();
-                    pseudoranges_iter != pseudoranges.end();
-                    pseudoranges_iter++)
-                {
-                    line += satelliteSystem["GPS"];
-                    if (static_cast<int>(pseudoranges_iter->first) < 10) line += std::string(1, '0');
-                    line += boost::lexical_cast<std::string>(static_cast<int>(pseudoranges_iter->first));
-                }
-            // Receiver clock offset (optional)
-            //line += rightJustify(asString(clockOffset, 12), 15);
-            line += std::string(80 - line.size(), ' ');
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
-
-            for(pseudoranges_iter = pseudoranges.begin();
-                    pseudoranges_iter != pseudoranges.end();
-                    pseudoranges_iter++)
-                {
-                    std::string lineObs;
-                    lineObs.clear();
-                    line.clear();
-                    // GPS L1 PSEUDORANGE
-                    line += std::string(2, ' ');
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Pseudorange_m, 3), 14);
-
-                    //Loss of lock indicator (LLI)
-                    int lli = 0; // Include in the observation!!
-                    if (lli == 0)
-                        {
-                            lineObs += std::string(1, ' ');
-                        }
-                    else
-                        {
-                            lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                        }
-                    // GPS L1 CA PHASE
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_phase_rads/GPS_TWO_PI, 3), 14);
-                    // GPS L1 CA DOPPLER
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_Doppler_hz, 3), 14);
-                    //GPS L1 SIGNAL STRENGTH
-                    //int ssi=signalStrength(54.0); // The original RINEX 2.11 file stores the RSS in a tabulated format 1-9. However, it is also valid to store the CN0 using dB-Hz units
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.CN0_dB_hz, 3), 14);
-                    if (lineObs.size() < 80) lineObs += std::string(80 - lineObs.size(), ' ');
-                    out << lineObs << std::endl;
-                }
+            lineAppend(' ');
+            lineAppendTwoDigits(static_cast<int>(ymd.year));
+            lineAppend(' ');
+            lineAppendInt(static_cast<int>(ymd.month), 2);
+            lineAppend(' ');
+            lineAppendInt(static_cast<int>(ymd.day), 2);
         }
-
-    if (version == 3)
+    else
         {
-            std::string year (timestring, 0, 4);
-            line += std::string(1, '>');
-            line += std::string(1, ' ');
-            line += year;
-            line += std::string(1, ' ');
-            line += month;
-            line += std::string(1, ' ');
-            line += day;
-            line += std::string(1, ' ');
-            line += hour;
-            line += std::string(1, ' ');
-            line += minutes;
-
-            line += std::string(1, ' ');
-            double seconds=fmod(gps_t, 60);
-            // Add extra 0 if seconds are < 10
-            if (seconds < 10)
-            {
-            	line +=std::string(1, '0');
-            }
-            line += Rinex_Printer::asString(seconds, 7);
-            line += std::string(2, ' ');
-            // Epoch flag 0: OK     1: power failure between previous and current epoch   <1: Special event
-            line += std::string(1, '0');
-
-            //Number of satellites observed in current epoch
-            int numSatellitesObserved = 0;
+            lineAppend("> ", 2);
+            lineAppendInt(static_cast<int>(ymd.year), 4);
+            lineAppend(' ');
+            lineAppendTwoDigits(static_cast<int>(ymd.month));
+            lineAppend(' ');
+            lineAppendTwoDigits(static_cast<int>(ymd.day));
+        }
+    lineAppend(' ');
+    lineAppendTwoDigits(static_cast<int>(tod.hours()));
+    lineAppend(' ');
+    lineAppendTwoDigits(static_cast<int>(tod.minutes()));
+    lineAppend(' ');
+    // Add extra 0 if seconds are < 10
+    if (record_version == 3 and seconds < 10) lineAppend('0');
+    lineAppendFixed(seconds, 7, 0);
+    // Epoch flag 0: OK     1: power failure between previous and current epoch   <1: Special event
+    lineAppend("  0", 3);
+    // Number of satellites observed in current epoch
+    lineAppendInt(static_cast<int>(pseudoranges.size()), 3);
+    if (record_version == 2)
+        {
+            const char system = satelliteSystem["GPS"].at(0);
             std::map<int, Gnss_Synchro>::const_iterator pseudoranges_iter;
             for(pseudoranges_iter = pseudoranges.begin();
                     pseudoranges_iter != pseudoranges.end();
                     pseudoranges_iter++)
                 {
-                    numSatellitesObserved++;
-                }
-            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(numSatellitesObserved), 3);
-
-
-            // Receiver clock offset (optional)
-            //line += rightJustify(asString(clockOffset, 12), 15);
-
-            line += std::string(80 - line.size(), ' ');
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
-            for(pseudoranges_iter = pseudoranges.begin();
-                    pseudoranges_iter != pseudoranges.end();
-                    pseudoranges_iter++)
-                {
-                    std::string lineObs;
-                    lineObs.clear();
-                    lineObs += satelliteSystem["GPS"];
-                    if (static_cast<int>(pseudoranges_iter->first) < 10) lineObs += std::string(1, '0');
-                    lineObs += boost::lexical_cast<std::string>(static_cast<int>(pseudoranges_iter->first));
-                    //lineObs += std::string(2, ' ');
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Pseudorange_m, 3), 14);
-
-                    //Loss of lock indicator (LLI)
-                    int lli = 0; // Include in the observation!!
-                    if (lli == 0)
-                        {
-                            lineObs += std::string(1, ' ');
-                        }
-                    else
-                        {
-                            lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                        }
-
-                    // GPS L1 CA PHASE
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_phase_rads/GPS_TWO_PI, 3), 14);
-
-                    // GPS L1 CA DOPPLER
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_Doppler_hz, 3), 14);
-
-                    //GPS L1 SIGNAL STRENGTH
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.CN0_dB_hz, 3), 14);
-
-                    if (lineObs.size() < 80) lineObs += std::string(80 - lineObs.size(), ' ');
-                    out << lineObs << std::endl;
+                    lineAppend(system);
+                    if (pseudoranges_iter->first < 10) lineAppend('0');
+                    lineAppendInt(pseudoranges_iter->first, 0);
                 }
         }
+    // Receiver clock offset (optional)
+    linePad(80);
+    lineWrite(out, true);
 }
 
 
-
-void Rinex_Printer::log_rinex_obs(std::ofstream& out, const Galileo_Ephemeris& eph, double obs_time, const std::map<int,Gnss_Synchro>& pseudoranges)
+void Rinex_Printer::logObservationLine(std::ofstream& out, const int record_version, const char system, const int prn, const Gnss_Synchro& gs, const double phase_cycles)
 {
-    // RINEX observations timestamps are Galileo timestamps.
-    // See http://gage14.upc.es/gLAB/HTML/Observation_Rinex_v3.01.html
-
-    std::string line;
-
-    boost::posix_time::ptime p_galileo_time = Rinex_Printer::compute_Galileo_time(eph, obs_time);
-    std::string timestring = boost::posix_time::to_iso_string(p_galileo_time);
-    //double utc_t = nav_msg.utc_time(nav_msg.sv_clock_correction(obs_time));
-    //double gps_t = eph.sv_clock_correction(obs_time);
-    double galileo_t = obs_time;
-
-    std::string month (timestring, 4, 2);
-    std::string day (timestring, 6, 2);
-    std::string hour (timestring, 9, 2);
-    std::string minutes (timestring, 11, 2);
-
-    std::string year (timestring, 0, 4);
-    line += std::string(1, '>');
-    line += std::string(1, ' ');
-    line += year;
-    line += std::string(1, ' ');
-    line += month;
-    line += std::string(1, ' ');
-    line += day;
-    line += std::string(1, ' ');
-    line += hour;
-    line += std::string(1, ' ');
-    line += minutes;
-
-    line += std::string(1, ' ');
-    double seconds = fmod(galileo_t, 60);
-    // Add extra 0 if seconds are < 10
-    if (seconds < 10)
+    lineClear();
+    if (system != 0)
         {
-            line +=std::string(1, '0');
+            lineAppend(system);
         }
-    line += Rinex_Printer::asString(seconds, 7);
-    line += std::string(2, ' ');
-    // Epoch flag 0: OK     1: power failure between previous and current epoch   <1: Special event
-    line += std::string(1, '0');
-
-    //Number of satellites observed in current epoch
-    int numSatellitesObserved = 0;
-    std::map<int, Gnss_Synchro>::const_iterator pseudoranges_iter;
-    for(pseudoranges_iter = pseudoranges.begin();
-            pseudoranges_iter != pseudoranges.end();
-            pseudoranges_iter++)
+    if (record_version == 3)
         {
-            numSatellitesObserved++;
+            if (prn < 10) lineAppend('0');
+            lineAppendInt(prn, 0);
         }
-    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(numSatellitesObserved), 3);
+    // PSEUDORANGE
+    lineAppendFixed(gs.Pseudorange_m, 3, 14);
+    // Loss of lock indicator (LLI), not available yet
+    lineAppend(' ');
+    // PHASE
+    lineAppendFixed(phase_cycles, 3, 14);
+    // DOPPLER
+    lineAppendFixed(gs.Carrier_Doppler_hz, 3, 14);
+    // SIGNAL STRENGTH. RINEX 2.11 tabulates the RSS as 1-9, but it is also valid to store the CN0 in dB-Hz
+    lineAppendFixed(gs.CN0_dB_hz, 3, 14);
+    linePad(80);
+    lineWrite(out, false);
+}
 
-    // Receiver clock offset (optional)
-    //line += rightJustify(asString(clockOffset, 12), 15);
 
-    line += std::string(80 - line.size(), ' ');
-    Rinex_Printer::lengthCheck(line);
-    out << line << std::endl;
+void Rinex_Printer::log_rinex_obs(std::ofstream& out, const Gps_Ephemeris& eph, const double obs_time, const std::map<int,Gnss_Synchro>& pseudoranges)
+{
+    // RINEX observations timestamps are GPS timestamps.
+    boost::posix_time::ptime p_gps_time = Rinex_Printer::compute_GPS_time(eph, obs_time);
+    logObservationEpoch(out, version, p_gps_time, obs_time, pseudoranges);
 
+    const char system = (version == 3) ? satelliteSystem["GPS"].at(0) : 0;
+    std::map<int, Gnss_Synchro>::const_iterator pseudoranges_iter;
     for(pseudoranges_iter = pseudoranges.begin();
             pseudoranges_iter != pseudoranges.end();
             pseudoranges_iter++)
         {
-            std::string lineObs;
-            lineObs.clear();
-            lineObs += satelliteSystem["Galileo"];
-            if (static_cast<int>(pseudoranges_iter->first) < 10) lineObs += std::string(1, '0');
-            lineObs += boost::lexical_cast<std::string>(static_cast<int>(pseudoranges_iter->first));
-            //lineObs += std::string(2, ' ');
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Pseudorange_m, 3), 14);
-
-            //Loss of lock indicator (LLI)
-            int lli = 0; // Include in the observation!!
-            if (lli == 0)
-                {
-                    lineObs += std::string(1, ' ');
-                }
-            else
-                {
-                    lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                }
-            // Galileo E1B PHASE
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_phase_rads / (2 * GALILEO_PI), 3), 14);
-            // Galileo E1B DOPPLER
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_Doppler_hz, 3), 14);
-            // Galileo E1B SIGNAL STRENGTH
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.CN0_dB_hz, 3), 14);
-            if (lineObs.size() < 80) lineObs += std::string(80 - lineObs.size(), ' ');
-            out << lineObs << std::endl;
+            logObservationLine(out, version, system, pseudoranges_iter->first, pseudoranges_iter->second, pseudoranges_iter->second.Carrier_phase_rads / GPS_TWO_PI);
         }
 }
 
 
-void Rinex_Printer::log_rinex_obs(std::ofstream& out, const Gps_Ephemeris& gps_eph, const Galileo_Ephemeris& galileo_eph,  double gps_obs_time, const std::map<int,Gnss_Synchro>& pseudoranges)
-{
-    std::string line;
-
-    boost::posix_time::ptime p_gps_time = Rinex_Printer::compute_GPS_time(gps_eph, gps_obs_time);
-    std::string timestring = boost::posix_time::to_iso_string(p_gps_time);
-    //double utc_t = nav_msg.utc_time(nav_msg.sv_clock_correction(obs_time));
-    //double gps_t = eph.sv_clock_correction(obs_time);
-    double gps_t = gps_obs_time;
 
-    std::string month (timestring, 4, 2);
-    std::string day (timestring, 6, 2);
-    std::string hour (timestring, 9, 2);
-    std::string minutes (timestring, 11, 2);
-
-    std::string year (timestring, 0, 4);
-    line += std::string(1, '>');
-    line += std::string(1, ' ');
-    line += year;
-    line += std::string(1, ' ');
-    line += month;
-    line += std::string(1, ' ');
-    line += day;
-    line += std::string(1, ' ');
-    line += hour;
-    line += std::string(1, ' ');
-    line += minutes;
-
-    line += std::string(1, ' ');
-    double seconds = fmod(gps_t, 60);
-    // Add extra 0 if seconds are < 10
-    if (seconds < 10)
-        {
-            line +=std::string(1, '0');
-        }
-    line += Rinex_Printer::asString(seconds, 7);
-    line += std::string(2, ' ');
-    // Epoch flag 0: OK     1: power failure between previous and current epoch   <1: Special event
-    line += std::string(1, '0');
+void Rinex_Printer::log_rinex_obs(std::ofstream& out, const Galileo_Ephemeris& eph, double obs_time, const std::map<int,Gnss_Synchro>& pseudoranges)
+{
+    // RINEX observations timestamps are Galileo timestamps.
+    // See http://gage14.upc.es/gLAB/HTML/Observation_Rinex_v3.01.html
+    boost::posix_time::ptime p_galileo_time = Rinex_Printer::compute_Galileo_time(eph, obs_time);
+    logObservationEpoch(out, 3, p_galileo_time, obs_time, pseudoranges);
 
-    //Number of satellites observed in current epoch
-    int numSatellitesObserved = 0;
-    std::map<int,Gnss_Synchro>::const_iterator pseudoranges_iter;
+    const char system = satelliteSystem["Galileo"].at(0);
+    std::map<int, Gnss_Synchro>::const_iterator pseudoranges_iter;
     for(pseudoranges_iter = pseudoranges.begin();
             pseudoranges_iter != pseudoranges.end();
             pseudoranges_iter++)
         {
-            numSatellitesObserved++;
+            logObservationLine(out, 3, system, pseudoranges_iter->first, pseudoranges_iter->second, pseudoranges_iter->second.Carrier_phase_rads / (2 * GALILEO_PI));
         }
-    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(numSatellitesObserved), 3);
+}
 
-    // Receiver clock offset (optional)
-    //line += rightJustify(asString(clockOffset, 12), 15);
 
-    line += std::string(80 - line.size(), ' ');
-    Rinex_Printer::lengthCheck(line);
-    out << line << std::endl;
+void Rinex_Printer::log_rinex_obs(std::ofstream& out, const Gps_Ephemeris& gps_eph, const Galileo_Ephemeris& galileo_eph,  double gps_obs_time, const std::map<int,Gnss_Synchro>& pseudoranges)
+{
+    boost::posix_time::ptime p_gps_time = Rinex_Printer::compute_GPS_time(gps_eph, gps_obs_time);
+    logObservationEpoch(out, 3, p_gps_time, gps_obs_time, pseudoranges);
 
-    std::string s;
+    const char gps_system = satelliteSystem["GPS"].at(0);
+    const char galileo_system = satelliteSystem["Galileo"].at(0);
+    std::map<int, Gnss_Synchro>::const_iterator pseudoranges_iter;
     for(pseudoranges_iter = pseudoranges.begin();
             pseudoranges_iter != pseudoranges.end();
             pseudoranges_iter++)
         {
-            std::string lineObs;
-            lineObs.clear();
-
-            s.assign(1, pseudoranges_iter->second.System);
-            if(s.compare("G") == 0) lineObs += satelliteSystem["GPS"];
-            if(s.compare("E") == 0) lineObs += satelliteSystem["Galileo"];
-            if (static_cast<int>(pseudoranges_iter->first) < 10) lineObs += std::string(1, '0');
-            lineObs += boost::lexical_cast<std::string>(static_cast<int>(pseudoranges_iter->first));
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Pseudorange_m, 3), 14);
-
-            //Loss of lock indicator (LLI)
-            int lli = 0; // Include in the observation!!
-            if (lli == 0)
-                {
-                    lineObs += std::string(1, ' ');
-                }
-            else
-                {
-                    lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                }
-
-            // PHASE
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_phase_rads/GPS_TWO_PI, 3), 14);
-
-            // DOPPLER
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_Doppler_hz, 3), 14);
-
-            // SIGNAL STRENGTH
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.CN0_dB_hz, 3), 14);
-
-            if (lineObs.size() < 80) lineObs += std::string(80 - lineObs.size(), ' ');
-            out << lineObs << std::endl;
+            char system = 0;
+            if (pseudoranges_iter->second.System == 'G') system = gps_system;
+            if (pseudoranges_iter->second.System == 'E') system = galileo_system;
+            logObservationLine(out, 3, system, pseudoranges_iter->first, pseudoranges_iter->second, pseudoranges_iter->second.Carrier_phase_rads / GPS_TWO_PI);
         }
 }
 
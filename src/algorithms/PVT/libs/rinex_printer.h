@@ -57,6 +57,9 @@
 #include <sstream>  // for stringstream
 #include <iomanip>  // for setprecision
 #include <map>
+#include <utility>
+#include <cmath>
+#include <cstdio>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include "gps_navigation_message.h"
 #include "galileo_navigation_message.h"
@@ -67,6 +70,8 @@
 
 class Sbas_Raw_Msg;
 
+#define RINEX_LINE_BUFFER_LENGTH 256
+
 /*!
  * \brief Class that handles the generation of Receiver
  * INdependent EXchange format (RINEX) files
@@ -141,12 +146,14 @@ public:
     boost::posix_time::ptime compute_Galileo_time(const Galileo_Ephemeris& eph, const double obs_time);
 
     /*!
-     *  \brief Writes data from the GPS navigation message into the RINEX file
+     *  \brief Writes data from the GPS navigation message into the RINEX file.
+     *  Only the ephemerides with an issue of data (IODC, Toe) not yet written are logged
      */
     void log_rinex_nav(std::ofstream& out, const std::map<int, Gps_Ephemeris>& eph_map);
 
     /*!
-     *  \brief Writes data from the Galileo navigation message into the RINEX file
+     *  \brief Writes data from the Galileo navigation message into the RINEX file.
+     *  Only the ephemerides with an IOD not yet written are logged
      */
     void log_rinex_nav(std::ofstream& out, const std::map<int, Galileo_Ephemeris>& eph_map);
 
@@ -217,6 +224,77 @@ private:
     std::string navGalfilename;
     std::string navMixfilename;
 
+    std::map<int, std::pair<double, double> > gpsEphemerisLogged; // (IODC, Toe) of the last GPS ephemeris written for each PRN
+    std::map<int, int> galileoEphemerisLogged;                     // IOD of the last Galileo ephemeris written for each PRN
+
+    /*
+     * The navigation and observation records are built in this fixed line
+     * buffer, without temporary strings or stream conversions
+     */
+    char lineBuffer[RINEX_LINE_BUFFER_LENGTH];
+    int lineLength;
+
+    inline void lineClear()
+    { lineLength = 0; }
+
+    inline void lineAppend(const char c, const int n = 1);
+
+    inline void lineAppend(const char* s, const int n);
+
+    /*
+     * Appends the two last digits of x, with a leading zero
+     */
+    inline void lineAppendTwoDigits(const int x);
+
+    /*
+     * Appends the non-negative integer x right-justified in a field of
+     * the given width, as rightJustify(asString(x), width). Width 0 appends all the digits.
+     */
+    inline void lineAppendInt(const int x, const int width);
+
+    /*
+     * Appends x with the given number of decimals right-justified in a field
+     * of the given width, as rightJustify(asString(x, decimals), width).
+     * Width 0 appends all the characters.
+     */
+    inline void lineAppendFixed(const double x, const int decimals, const int width);
+
+    /*
+     * Appends d in FORTRAN notation, as doub2for(d, 18, 2)
+     */
+    inline void lineAppendFor(const double d);
+
+    /*
+     * Appends blanks up to the given length
+     */
+    inline void linePad(const int length);
+
+    /*
+     * Writes the line buffer as a RINEX line
+     */
+    void lineWrite(std::ofstream& out, const bool check_length);
+
+    /*
+     * Appends the date and time of p in the format of the navigation records
+     */
+    void lineAppendNavEpoch(const boost::posix_time::ptime& p, const bool four_digit_year);
+
+    /*
+     * Writes a BROADCAST ORBIT line of a navigation record
+     */
+    void logBroadcastOrbit(std::ofstream& out, const int record_version, const double a, const double b, const double c, const double d);
+
+    /*
+     * Writes the epoch line of an observation record
+     */
+    void logObservationEpoch(std::ofstream& out, const int record_version, const boost::posix_time::ptime& p, const double obs_time, const std::map<int, Gnss_Synchro>& pseudoranges);
+
+    /*
+     * Writes the line of one satellite of an observation record. No satellite
+     * system nor PRN are written if system is 0 (RINEX 2)
+     */
+    void logObservationLine(std::ofstream& out, const int record_version, const char system, const int prn, const Gnss_Synchro& gs, const double phase_cycles);
+
     /*
      * Generates the data for the PGM / RUN BY / DATE line
      */
@@ -578,6 +656,153 @@ inline std::string& Rinex_Printer::sci2for(std::string& aStr,
 
 
 
+inline void Rinex_Printer::lineAppend(const char c, const int n)
+{
+    for (int i = 0; i < n and lineLength < RINEX_LINE_BUFFER_LENGTH; i++)
+        {
+            lineBuffer[lineLength++] = c;
+        }
+}
+
+
+inline void Rinex_Printer::lineAppend(const char* s, const int n)
+{
+    for (int i = 0; i < n and lineLength < RINEX_LINE_BUFFER_LENGTH; i++)
+        {
+            lineBuffer[lineLength++] = s[i];
+        }
+}
+
+
+inline void Rinex_Printer::lineAppendTwoDigits(const int x)
+{
+    lineAppend(static_cast<char>('0' + (x / 10) % 10));
+    lineAppend(static_cast<char>('0' + x % 10));
+}
+
+
+inline void Rinex_Printer::lineAppendInt(const int x, const int width)
+{
+    char digits[16];
+    int n = 0;
+    unsigned int u = static_cast<unsigned int>(x);
+    do
+        {
+            digits[15 - n++] = static_cast<char>('0' + u % 10);
+            u /= 10;
+        }
+    while (u > 0);
+    if (width == 0)
+        {
+            lineAppend(&digits[16 - n], n);
+        }
+    else if (n >= width)
+        {
+            lineAppend(&digits[16 - width], width);  // truncated from the left
+        }
+    else
+        {
+            lineAppend(' ', width - n);
+            lineAppend(&digits[16 - n], n);
+        }
+}
+
+
+inline void Rinex_Printer::lineAppendFixed(const double x, const int decimals, const int width)
+{
+    static const double scale[10] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+    char digits[512];   // large enough for any double in fixed notation
+    int n = 0;
+    double scaled = (decimals >= 0 and decimals < 10) ? std::fabs(x) * scale[decimals] : 1e20;
+    double fraction = scaled - std::floor(scaled);
+    // Integer arithmetic whenever the rounding of the product is not ambiguous, so that
+    // the result is the same as printing the exact binary value. Otherwise, printf.
+    if (scaled < 1e12 and std::fabs(fraction - 0.5) > 1e-3)
+        {
+            unsigned long long int r = static_cast<unsigned long long int>(std::floor(scaled + 0.5));
+            char reversed[32];
+            int m = 0;
+            for (int i = 0; i < decimals; i++)
+                {
+                    reversed[m++] = static_cast<char>('0' + r % 10);
+                    r /= 10;
+                }
+            if (decimals > 0) reversed[m++] = '.';
+            do
+                {
+                    reversed[m++] = static_cast<char>('0' + r % 10);
+                    r /= 10;
+                }
+            while (r > 0);
+            if (std::signbit(x)) reversed[m++] = '-';
+            while (m > 0) digits[n++] = reversed[--m];
+        }
+    else
+        {
+            n = std::snprintf(digits, sizeof(digits), "%.*f", decimals, x);
+            if (n < 0) n = 0;
+            if (n >= static_cast<int>(sizeof(digits))) n = sizeof(digits) - 1;
+        }
+    if (width == 0)
+        {
+            lineAppend(digits, n);
+        }
+    else if (n >= width)
+        {
+            lineAppend(&digits[n - width], width);  // truncated from the left
+        }
+    else
+        {
+            lineAppend(' ', width - n);
+            lineAppend(digits, n);
+        }
+}
+
+
+inline void Rinex_Printer::lineAppendFor(const double d)
+{
+    // d.ddddddddddde+xx, turned into .dddddddddddd with the exponent incremented by one
+    char sci[32];
+    int n = std::snprintf(sci, sizeof(sci), "%.11e", d);
+    const char* mantissa = sci;
+    if (*mantissa == '-') mantissa++;
+    const char* e = mantissa;
+    while (*e != '\0' and *e != 'e') e++;
+    if (*e != 'e' or mantissa[1] != '.' or (e - mantissa) != 13)
+        {
+            // not a finite number
+            if (n > 18) n = 18;
+            lineAppend(' ', 18 - n);
+            lineAppend(sci, n);
+            return;
+        }
+    long iexp = std::strtol(e + 1, 0, 10);
+    if (d != 0.0) iexp += 1;
+    lineAppend((d < 0.0 or std::signbit(d)) ? '-' : ' ');
+    lineAppend('.');
+    lineAppend(mantissa[0]);
+    lineAppend(mantissa + 2, 11);
+    lineAppend('D');
+    if (iexp < 0)
+        {
+            lineAppend('-');
+            iexp = -iexp;
+        }
+    else
+        {
+            lineAppend('+');
+        }
+    lineAppendTwoDigits(static_cast<int>(iexp % 100));
+}
+
+
+inline void Rinex_Printer::linePad(const int length)
+{
+    if (lineLength < length) lineAppend(' ', length - lineLength);
+}
+
+
+
 inline std::string asString(const long double x, const std::string::size_type precision)
 {
     std::ostringstream ss;
@@ -34,23 +34,107 @@
 #include "rtcm_printer.h"
 #include <fcntl.h>    // for O_RDWR
 #include <termios.h>  // for tcgetattr
-#include <algorithm>  // for std::reverse
-#include <sstream>    // for std::stringstream
-#include <boost/algorithm/string.hpp>  // for to_upper_copy
-#include <boost/date_time/posix_time/posix_time.hpp>
-#include <boost/dynamic_bitset.hpp>
-#include <gflags/gflags.h>
+#include <unistd.h>   // for write
+#include <cstring>    // for memset
 #include <glog/logging.h>
+#include "GPS_L1_CA.h"
+#include "Galileo_E1.h"
 
+#define RTCM_RANGE_MS (GPS_C_m_s * 0.001)  // distance travelled by light in 1 ms [m]
+#define RTCM_MAX_LOCK_GAP 10.0              // longer gaps between observations of a satellite restart its lock time [s]
 
 using google::LogMessage;
 
-//DEFINE_string(RTCM_version, "3.2", "Specifies the RTCM Version");
+namespace
+{
+// CRC-24Q (polynomial 0x1864CFB), one table lookup per byte
+struct Crc24q_Table
+{
+    unsigned int value[256];
+    Crc24q_Table()
+    {
+        for (unsigned int i = 0; i < 256; i++)
+            {
+                unsigned int crc = i << 16;
+                for (int k = 0; k < 8; k++)
+                    {
+                        crc <<= 1;
+                        if (crc & 0x1000000) crc ^= 0x1864CFB;
+                    }
+                value[i] = crc & 0xFFFFFF;
+            }
+    }
+};
+
+const Crc24q_Table crc24q_table;
+
+
+unsigned int tow_ms(double obs_time)
+{
+    long long int ms = static_cast<long long int>(std::floor(obs_time * 1000.0 + 0.5)) % 604800000LL;
+    if (ms < 0) ms += 604800000LL;
+    return static_cast<unsigned int>(ms);
+}
+
 
-Rtcm_Printer::Rtcm_Printer(std::string filename, bool flag_rtcm_tty_port, std::string rtcm_dump_devname)
+// DF013 and DF019, lock time [s] of messages 1001 to 1004
+unsigned int lock_time_indicator(double lock_s)
+{
+    int lock = static_cast<int>(lock_s);
+    if (lock < 24) return lock;
+    if (lock < 72) return (lock + 24) / 2;
+    if (lock < 168) return (lock + 120) / 4;
+    if (lock < 360) return (lock + 408) / 8;
+    if (lock < 744) return (lock + 1176) / 16;
+    if (lock < 937) return (lock + 3096) / 32;
+    return 127;
+}
+
+
+// DF402, lock time indicator of MSM4
+unsigned int msm_lock_time_indicator(double lock_s)
+{
+    if (lock_s < 0.032) return 0;
+    unsigned int indicator = 1;
+    double limit = 0.064;
+    while (indicator < 15 and lock_s >= limit)
+        {
+            indicator++;
+            limit *= 2.0;
+        }
+    return indicator;
+}
+
+
+// DF407, lock time indicator with extended range and resolution of MSM7
+unsigned int msm_extended_lock_time_indicator(double lock_s)
+{
+    long long int lock_ms = static_cast<long long int>(lock_s * 1000.0);
+    if (lock_ms < 64) return static_cast<unsigned int>(lock_ms);
+    for (int k = 1; k <= 20; k++)
+        {
+            if (lock_ms < (1LL << (k + 6)))
+                {
+                    return static_cast<unsigned int>(32 * (k + 1) + ((lock_ms - (1LL << (k + 5))) >> k));
+                }
+        }
+    return 704;
+}
+
+
+unsigned int clamp_field(long long int value, long long int max_value)
+{
+    if (value < 0) return 0;
+    if (value > max_value) return static_cast<unsigned int>(max_value);
+    return static_cast<unsigned int>(value);
+}
+}
+
+
+Rtcm_Printer::Rtcm_Printer(std::string filename, bool flag_rtcm_tty_port, std::string rtcm_dump_devname, unsigned int station_id)
 {
     rtcm_filename = filename;
-    rtcm_file_descriptor.open(rtcm_filename.c_str(), std::ios::out);
+    rtcm_file_descriptor.open(rtcm_filename.c_str(), std::ios::out | std::ios::binary);
     if (rtcm_file_descriptor.is_open())
         {
             DLOG(INFO) << "RTCM printer writing on " << rtcm_filename.c_str();
@@ -69,9 +153,10 @@ Rtcm_Printer::Rtcm_Printer(std::string filename, bool flag_rtcm_tty_port, std::s
         {
             rtcm_dev_descriptor = -1;
         }
-    Rtcm_Printer::reset_data_fields();
-    preamble = std::bitset<8>("11010011");
-    reserved_field = std::bitset<6>("000000");
+    rtcm_station_id = station_id & 0xFFF; // Max: 4095
+    rtcm_frame_length = 0;
+    rtcm_bit_position = 0;
+    std::memset(rtcm_frame, 0, sizeof(rtcm_frame));
 }
 
 
@@ -138,255 +223,530 @@ void Rtcm_Printer::close_serial()
         }
 }
 
-void Rtcm_Printer::reset_data_fields()
+
+
+bool Rtcm_Printer::Print_Rtcm_MSM(unsigned int msm, double obs_time, const std::map<int, Gnss_Synchro>& pseudoranges)
 {
-    //DF001.reset();
-    DF002.reset();
-    DF003.reset();
-    DF004.reset();
-    DF005.reset();
-    DF006.reset();
-    DF007.reset();
-    DF008.reset();
-    DF009.reset();
-    DF010.reset();
-    DF011.reset();
-    DF012.reset();
-    DF013.reset();
-    DF014.reset();
-    DF015.reset();
-
-    // Contents of GPS Satellite Ephemeris Data, Message Type 1019
-    DF071.reset();
-    DF076.reset();
-    DF077.reset();
-    DF078.reset();
-    DF079.reset();
-    DF081.reset();
-    DF082.reset();
-    DF083.reset();
-    DF084.reset();
-    DF085.reset();
-    DF086.reset();
-    DF087.reset();
-
-    DF088.reset();
-    DF089.reset();
-    DF090.reset();
-    DF091.reset();
-    DF092.reset();
-    DF093.reset();
-    DF094.reset();
-    DF095.reset();
-    DF096.reset();
-    DF097.reset();
-    DF098.reset();
-    DF099.reset();
-    DF100.reset();
-    DF101.reset();
-    DF102.reset();
-    DF103.reset();
-    DF137.reset();
-
-    // Contents of Galileo F/NAV Satellite Ephemeris Data, Message Type 1045
-    DF252.reset();
-    DF289.reset();
-    DF290.reset();
-    DF291.reset();
-    DF292.reset();
-    DF293.reset();
-    DF294.reset();
-    DF295.reset();
-    DF296.reset();
-    DF297.reset();
-    DF298.reset();
-    DF299.reset();
-    DF300.reset();
-    DF301.reset();
-    DF302.reset();
-    DF303.reset();
-    DF304.reset();
-    DF305.reset();
-    DF306.reset();
-    DF307.reset();
-    DF308.reset();
-    DF309.reset();
-    DF310.reset();
-    DF311.reset();
-    DF312.reset();
-    DF314.reset();
-    DF315.reset();
+    bool gps = false;
+    bool galileo = false;
+    for (std::map<int, Gnss_Synchro>::const_iterator it = pseudoranges.begin(); it != pseudoranges.end(); ++it)
+        {
+            if (it->second.System == 'G') gps = true;
+            if (it->second.System == 'E') galileo = true;
+        }
+    bool printed = false;
+    if (gps and encode_MSM(msm, 'G', obs_time, pseudoranges, galileo) > 0)
+        {
+            printed = Print_Rtcm_Frame();
+        }
+    if (galileo and encode_MSM(msm, 'E', obs_time, pseudoranges, false) > 0)
+        {
+            printed = Print_Rtcm_Frame() or printed;
+        }
+    return printed;
 }
 
 
 
-/* Stationary Antenna Reference Point, No Height Information
- * Reference Station Id = 2003
-   GPS Service supported, but not GLONASS or Galileo
-   ARP ECEF-X = 1114104.5999 meters
-   ARP ECEF-Y = -4850729.7108 meters
-   ARP ECEF-Z = 3975521.4643 meters
-   Expected output: D3 00 13 3E D7 D3 02 02 98 0E DE EF 34 B4 BD 62
-                    AC 09 41 98 6F 33 36 0B 98
- */
-std::bitset<152> Rtcm_Printer::get_M1005_test ()
+bool Rtcm_Printer::Print_Rtcm_Observables(unsigned int observables_type, double obs_time, const std::map<int, Gnss_Synchro>& pseudoranges)
 {
-    unsigned int m1005 = 1005;
-    unsigned int reference_station_id = 2003; // Max: 4095
-    long long int ECEF_X = 11141045999;       // Resolution 0.0001 m
-    long long int ECEF_Y = -48507297108;      // Resolution 0.0001 m
-    long long int ECEF_Z = 39755214643;       // Resolution 0.0001 m
-    unsigned int itrf_realization_year = 0;   // Reserved
-    std::bitset<1> DF001;
-
-    DF002 = std::bitset<12>(m1005);
-    DF003 = std::bitset<12>(reference_station_id);
-    DF021 = std::bitset<6>(itrf_realization_year);
-    DF022 = std::bitset<1>("1");          // GPS
-    DF023 = std::bitset<1>("0");          // Glonass
-    DF024 = std::bitset<1>("0");          // Galileo
-    DF141 = std::bitset<1>("0");          // 0: Real, physical reference station
-    DF001 = std::bitset<1>("0");          // Reserved, set to 0
-    DF025 = std::bitset<38>(ECEF_X);      // ECEF-X in 0.0001 m
-    DF142 = std::bitset<1>("0");          // Single Receiver Oscillator Indicator
-    DF026 = std::bitset<38>(ECEF_Y);      // ECEF-Y in 0.0001 m
-    DF364 = std::bitset<2>("00");         // Quarter Cycle Indicator
-    DF027 = std::bitset<38>(ECEF_Z);      // ECEF-Z in 0.0001 m
-
-    std::string message = DF002.to_string() +
-            DF003.to_string() +
-            DF021.to_string() +
-            DF022.to_string() +
-            DF023.to_string() +
-            DF024.to_string() +
-            DF141.to_string() +
-            DF025.to_string() +
-            DF142.to_string() +
-            DF001.to_string() +
-            DF026.to_string() +
-            DF364.to_string() +
-            DF027.to_string() ;
-
-    std::bitset<152> test_msg(message);
-    return test_msg;
+    if (observables_type < 1001 or observables_type > 1004)
+        {
+            return Print_Rtcm_MSM(observables_type, obs_time, pseudoranges);
+        }
+    bool gps = false;
+    bool galileo = false;
+    for (std::map<int, Gnss_Synchro>::const_iterator it = pseudoranges.begin(); it != pseudoranges.end(); ++it)
+        {
+            if (it->second.System == 'G') gps = true;
+            if (it->second.System == 'E') galileo = true;
+        }
+    bool printed = false;
+    if (gps and encode_observables(observables_type, obs_time, pseudoranges, galileo) > 0)
+        {
+            printed = Print_Rtcm_Frame();
+        }
+    // there is no legacy message for Galileo
+    if (galileo and encode_MSM(7, 'E', obs_time, pseudoranges, false) > 0)
+        {
+            printed = Print_Rtcm_Frame() or printed;
+        }
+    return printed;
 }
 
 
 
-std::string Rtcm_Printer::print_M1005_test ()
+void Rtcm_Printer::Print_Rtcm_Ephemeris(const std::map<int, Gps_Ephemeris>& gps_eph_map)
 {
-    std::bitset<152> m1005 = get_M1005_test();
-    unsigned int msg_length_bits = m1005.to_string().length();
-    unsigned int msg_length_bytes = std::ceil(static_cast<float>(msg_length_bits) / 8.0);
-    message_length = std::bitset<10>(msg_length_bytes);
-    unsigned int zeros_to_fill = 8*msg_length_bytes -  msg_length_bits;
-    std::string b(zeros_to_fill, '0');
-    std::string msg_content = m1005.to_string() + b;
-    std::string msg_without_crc = preamble.to_string() +
-            reserved_field.to_string() +
-            message_length.to_string() +
-            msg_content;
-    return Rtcm_Printer::add_CRC(msg_without_crc);
+    for (std::map<int, Gps_Ephemeris>::const_iterator it = gps_eph_map.begin(); it != gps_eph_map.end(); ++it)
+        {
+            if (encode_M1019(it->second) > 0) Print_Rtcm_Frame();
+        }
 }
 
 
 
-std::bitset<122> Rtcm_Printer::get_M1001()
+void Rtcm_Printer::Print_Rtcm_Ephemeris(const std::map<int, Galileo_Ephemeris>& gal_eph_map)
 {
-    unsigned int m1001 = 1001;
-    unsigned int reference_station_id = 1234; // Max: 4095
-    DF002 = std::bitset<12>(m1001);
-    DF003 = std::bitset<12>(reference_station_id);
-    //DF004 = std::bitset<30>
-    //DF005 = std::bitset<1>
-    //DF006 = std::bitset<5>
-    DF007 = std::bitset<1>("0");
-    //DF008 = std::bitset<3>
-    std::bitset<122> fake_msg;
-    fake_msg.reset();
-    return fake_msg;
+    for (std::map<int, Galileo_Ephemeris>::const_iterator it = gal_eph_map.begin(); it != gal_eph_map.end(); ++it)
+        {
+            if (encode_M1045(it->second) > 0) Print_Rtcm_Frame();
+        }
 }
 
 
 
-void Rtcm_Printer::print_M1001 ()
+void Rtcm_Printer::set_stream_server(const std::shared_ptr<Pvt_Stream_Server>& server)
 {
-    std::bitset<122> m1001 = get_M1001();
-    unsigned int msg_length_bits = m1001.to_string().length();
-    unsigned int msg_length_bytes = std::ceil(static_cast<float>(msg_length_bits) / 8.0);
-    message_length = std::bitset<10>(msg_length_bytes);
-    unsigned int zeros_to_fill = 8*msg_length_bytes -  msg_length_bits;
-    std::string b(zeros_to_fill, '0');
-    message_length = std::bitset<10>(static_cast<int>(msg_length_bytes));
-    std::string msg_content = m1001.to_string() + b;
-    std::string msg_without_crc = preamble.to_string() +
-            reserved_field.to_string() +
-            message_length.to_string() +
-            msg_content;
-    std::string message = Rtcm_Printer::add_CRC(msg_without_crc);
+    rtcm_stream_server = server;
 }
 
 
 
-std::bitset<138> Rtcm_Printer::get_M1002 ()
+unsigned int Rtcm_Printer::crc24q(const unsigned char* buffer, int length)
 {
-    std::bitset<138> fake_msg;
-    fake_msg.reset();
-    return fake_msg;
+    unsigned int crc = 0;
+    for (int i = 0; i < length; i++)
+        {
+            crc = ((crc << 8) & 0xFFFFFF) ^ crc24q_table.value[((crc >> 16) ^ buffer[i]) & 0xFF];
+        }
+    return crc;
 }
 
-std::bitset<488> Rtcm_Printer::get_M1019 ()
+
+
+void Rtcm_Printer::begin_message()
 {
-    std::bitset<488> fake_msg;
-        fake_msg.reset();
-        return fake_msg;
+    std::memset(rtcm_frame, 0, sizeof(rtcm_frame));
+    rtcm_frame_length = 0;
+    rtcm_bit_position = 24;
+}
+
+
+
+int Rtcm_Printer::end_message()
+{
+    if (rtcm_bit_position > 8 * (3 + RTCM_MAX_PAYLOAD_LENGTH))
+        {
+            LOG(WARNING) << "RTCM message longer than " << RTCM_MAX_PAYLOAD_LENGTH << " bytes, discarded";
+            rtcm_frame_length = 0;
+            return 0;
+        }
+    int payload_length = (rtcm_bit_position - 24 + 7) / 8;
+    rtcm_frame[0] = 0xD3;  // preamble
+    rtcm_frame[1] = static_cast<unsigned char>((payload_length >> 8) & 0x03);  // 6 reserved bits and the 2 MSB of the length
+    rtcm_frame[2] = static_cast<unsigned char>(payload_length & 0xFF);
+    unsigned int crc = crc24q(rtcm_frame, 3 + payload_length);
+    rtcm_frame[3 + payload_length] = static_cast<unsigned char>((crc >> 16) & 0xFF);
+    rtcm_frame[4 + payload_length] = static_cast<unsigned char>((crc >> 8) & 0xFF);
+    rtcm_frame[5 + payload_length] = static_cast<unsigned char>(crc & 0xFF);
+    rtcm_frame_length = 6 + payload_length;
+    return rtcm_frame_length;
+}
+
+
+
+bool Rtcm_Printer::Print_Rtcm_Frame()
+{
+    if (rtcm_frame_length == 0)
+        {
+            return false;
+        }
+    if (rtcm_file_descriptor.is_open())
+        {
+            rtcm_file_descriptor.write(reinterpret_cast<const char*>(rtcm_frame), rtcm_frame_length);
+        }
+    if (rtcm_dev_descriptor != -1)
+        {
+            if (write(rtcm_dev_descriptor, rtcm_frame, rtcm_frame_length) == -1)
+                {
+                    DLOG(INFO) << "RTCM printer cannot write on serial device " << rtcm_devname.c_str();
+                    return false;
+                }
+        }
+    if (rtcm_stream_server)
+        {
+            rtcm_stream_server->publish(reinterpret_cast<const char*>(rtcm_frame), rtcm_frame_length);
+        }
+    return true;
 }
 
 
 
-std::bitset<496> Rtcm_Printer::get_M1045 ()
+Rtcm_Printer::Rtcm_Lock& Rtcm_Printer::update_lock(char system, int prn, double obs_time)
 {
-    std::bitset<496> fake_msg;
-    fake_msg.reset();
-    return fake_msg;
+    Rtcm_Lock& lock = rtcm_lock[static_cast<int>(system) * 256 + prn];
+    if (lock.valid == false or obs_time < lock.last or obs_time - lock.last > RTCM_MAX_LOCK_GAP)
+        {
+            lock.start = obs_time;
+            lock.offset_valid = false;
+            lock.valid = true;
+        }
+    lock.last = obs_time;
+    return lock;
 }
 
 
 
+int Rtcm_Printer::select_satellites(char system, const std::map<int, Gnss_Synchro>& pseudoranges, const Gnss_Synchro** sats)
+{
+    // observables of the system with a valid rough range (up to 254 ms), sorted by PRN
+    unsigned long long int used = 0;
+    int n_sat = 0;
+    for (std::map<int, Gnss_Synchro>::const_iterator it = pseudoranges.begin(); it != pseudoranges.end(); ++it)
+        {
+            const Gnss_Synchro& gs = it->second;
+            if (gs.System != system or gs.PRN < 1 or gs.PRN > RTCM_MAX_SATELLITES) continue;
+            if (gs.Pseudorange_m <= 0.0 or gs.Pseudorange_m >= 254.0 * RTCM_RANGE_MS) continue;
+            unsigned long long int bit = 1ULL << (gs.PRN - 1);
+            if (used & bit) continue;
+            used |= bit;
+            int i = n_sat++;
+            while (i > 0 and sats[i - 1]->PRN > gs.PRN)
+                {
+                    sats[i] = sats[i - 1];
+                    i--;
+                }
+            sats[i] = &gs;
+        }
+    return n_sat;
+}
+
 
 
-std::string Rtcm_Printer::add_CRC (const std::string& message_without_crc)
+int Rtcm_Printer::encode_observables(unsigned int message_type, double obs_time, const std::map<int, Gnss_Synchro>& pseudoranges, bool more_messages)
 {
-    // ******  Computes Qualcomm CRC-24Q ******
-    // 1) Converts the string to a vector of unsigned char:
-    boost::dynamic_bitset<unsigned char> frame_bits(message_without_crc);
-    std::vector<unsigned char> bytes;
-    boost::to_block_range(frame_bits, std::back_inserter(bytes));
-    std::reverse(bytes.begin(),bytes.end());
-
-    // 2) Computes CRC
-    CRC_RTCM.process_bytes(bytes.data(), bytes.size());
-    crc_frame = std::bitset<24>(CRC_RTCM.checksum());
-
-    // 3) Builds the complete message
-    std::string complete_message = message_without_crc + crc_frame.to_string();
-    return bin_to_hex(complete_message);
+    if (message_type < 1001 or message_type > 1004)
+        {
+            LOG(WARNING) << "RTCM message type " << message_type << " is not a GPS observables message";
+            return 0;
+        }
+    const Gnss_Synchro* sats[RTCM_MAX_SATELLITES];
+    int n_sat = select_satellites('G', pseudoranges, sats);
+    if (n_sat > 31) n_sat = 31;  // DF006 is a 5-bit field
+    if (n_sat == 0)
+        {
+            rtcm_frame_length = 0;
+            return 0;
+        }
+    const double lambda = GPS_C_m_s / GPS_L1_FREQ_HZ;
+    const bool extended = (message_type == 1002 or message_type == 1004);
+    const bool l2 = (message_type == 1003 or message_type == 1004);
+
+    begin_message();
+    put_bits(message_type, 12);               // DF002
+    put_bits(rtcm_station_id, 12);            // DF003
+    put_bits(tow_ms(obs_time), 30);           // DF004 GPS epoch time [ms]
+    put_bits(more_messages ? 1 : 0, 1);       // DF005 synchronous GNSS flag
+    put_bits(n_sat, 5);                       // DF006 number of GPS satellites
+    put_bits(0, 1);                           // DF007 divergence-free smoothing indicator
+    put_bits(0, 3);                           // DF008 smoothing interval
+    for (int i = 0; i < n_sat; i++)
+        {
+            const Gnss_Synchro& gs = *sats[i];
+            Rtcm_Lock& lock = update_lock('G', gs.PRN, obs_time);
+            long long int ambiguity = static_cast<long long int>(std::floor(gs.Pseudorange_m / RTCM_RANGE_MS));
+            long long int pseudorange = scaled(gs.Pseudorange_m - static_cast<double>(ambiguity) * RTCM_RANGE_MS, 0.02);
+            long long int phase_minus_pseudorange = -524288; // invalid
+            if (gs.Carrier_phase_rads != 0.0)
+                {
+                    // The tracking loops accumulate the Doppler, so the phaserange is the
+                    // opposite of the carrier phase. An integer offset, kept while the lock
+                    // lasts, brings it next to the pseudorange; if the difference leaves
+                    // the +/-1500 cycles the standard allows, the offset and lock restart.
+                    double cycles = -gs.Carrier_phase_rads / GPS_TWO_PI;
+                    double pseudorange_cycles = (static_cast<double>(pseudorange) * 0.02 + static_cast<double>(ambiguity) * RTCM_RANGE_MS) / lambda;
+                    if (lock.offset_valid == false)
+                        {
+                            lock.offset_cycles = std::floor(cycles - pseudorange_cycles + 0.5);
+                            lock.offset_valid = true;
+                        }
+                    double difference = cycles - lock.offset_cycles - pseudorange_cycles;
+                    if (std::fabs(difference) >= 1500.0)
+                        {
+                            lock.offset_cycles = std::floor(cycles - pseudorange_cycles + 0.5);
+                            lock.start = obs_time;
+                            difference = cycles - lock.offset_cycles - pseudorange_cycles;
+                        }
+                    phase_minus_pseudorange = scaled(difference * lambda, 0.0005);
+                }
+            put_bits(gs.PRN, 6);                                        // DF009 satellite ID
+            put_bits(0, 1);                                             // DF010 L1 code indicator (C/A)
+            put_bits(pseudorange, 24);                                  // DF011 L1 pseudorange [0.02 m]
+            put_signed(phase_minus_pseudorange, 20);                    // DF012 L1 phaserange - L1 pseudorange [0.0005 m]
+            put_bits(lock_time_indicator(obs_time - lock.start), 7);    // DF013 L1 lock time indicator
+            if (extended)
+                {
+                    put_bits(ambiguity, 8);                                    // DF014 L1 pseudorange modulus ambiguity [ms]
+                    put_bits(clamp_field(scaled(gs.CN0_dB_hz, 0.25), 255), 8); // DF015 L1 CNR [0.25 dB-Hz]
+                }
+            if (l2)
+                {
+                    put_bits(0, 2);             // DF016 L2 code indicator
+                    put_signed(-8192, 14);      // DF017 L2-L1 pseudorange difference, invalid
+                    put_signed(-524288, 20);    // DF018 L2 phaserange - L1 pseudorange, invalid
+                    put_bits(0, 7);             // DF019 L2 lock time indicator
+                    if (message_type == 1004)
+                        {
+                            put_bits(0, 8);     // DF020 L2 CNR, not computed
+                        }
+                }
+        }
+    return end_message();
 }
 
 
-std::string  Rtcm_Printer::bin_to_hex(const std::string& s)
+
+int Rtcm_Printer::encode_MSM(unsigned int msm, char system, double obs_time, const std::map<int, Gnss_Synchro>& pseudoranges, bool more_messages)
 {
-    std::string s_aux;
-    std::stringstream ss;
-    for(int i = 0; i < s.length() - 1; i = i + 32)
+    if ((msm != 4 and msm != 7) or (system != 'G' and system != 'E'))
+        {
+            LOG(WARNING) << "RTCM MSM" << msm << " is not supported for system " << system;
+            return 0;
+        }
+    const Gnss_Synchro* sats[RTCM_MAX_SATELLITES];
+    int n_sat = select_satellites(system, pseudoranges, sats);
+    if (n_sat == 0)
+        {
+            rtcm_frame_length = 0;
+            return 0;
+        }
+    // one signal per satellite: GPS L1 C/A (1C, signal ID 2) or Galileo E1 B+C (1X, signal ID 5),
+    // since the E1 tracking uses both the data and the pilot components (signal ID 3 is the E1 A PRS)
+    const double lambda = (system == 'G') ? GPS_C_m_s / GPS_L1_FREQ_HZ : GPS_C_m_s / Galileo_E1_FREQ_HZ;
+    const double phase_two_pi = (system == 'G') ? GPS_TWO_PI : 2.0 * GALILEO_PI;
+    const unsigned int signal_id = (system == 'G') ? 2 : 5;
+    const bool msm7 = (msm == 7);
+
+    long long int rough_range[RTCM_MAX_SATELLITES];    // [2^-10 ms]
+    long long int rough_rate[RTCM_MAX_SATELLITES];     // [m/s]
+    long long int fine_range[RTCM_MAX_SATELLITES];
+    long long int fine_phase[RTCM_MAX_SATELLITES];
+    long long int fine_rate[RTCM_MAX_SATELLITES];
+    unsigned int lock_indicator[RTCM_MAX_SATELLITES];
+    unsigned int cnr[RTCM_MAX_SATELLITES];
+    unsigned long long int satellite_mask = 0;
+    for (int i = 0; i < n_sat; i++)
+        {
+            const Gnss_Synchro& gs = *sats[i];
+            Rtcm_Lock& lock = update_lock(system, gs.PRN, obs_time);
+            satellite_mask |= 1ULL << (RTCM_MAX_SATELLITES - gs.PRN);
+            rough_range[i] = scaled(gs.Pseudorange_m / RTCM_RANGE_MS, 1.0 / 1024.0);
+            double rough_range_m = static_cast<double>(rough_range[i]) / 1024.0 * RTCM_RANGE_MS;
+            double residual_ms = (gs.Pseudorange_m - rough_range_m) / RTCM_RANGE_MS;
+            fine_range[i] = msm7 ? scaled(residual_ms, TWO_N29) : scaled(residual_ms, TWO_N24);
+
+            fine_phase[i] = msm7 ? -8388608 : -2097152; // invalid
+            if (gs.Carrier_phase_rads != 0.0)
+                {
+                    // The phaserange is the opposite of the accumulated carrier phase, an
+                    // ambiguous number of cycles: an integer offset, kept while the lock
+                    // lasts, brings it next to the rough range. If it drifts out of the
+                    // +/-2^-8 ms field range, the offset and lock restart.
+                    double cycles = -gs.Carrier_phase_rads / phase_two_pi;
+                    if (lock.offset_valid == false)
+                        {
+                            lock.offset_cycles = std::floor(cycles - gs.Pseudorange_m / lambda + 0.5);
+                            lock.offset_valid = true;
+                        }
+                    double phase_ms = ((cycles - lock.offset_cycles) * lambda - rough_range_m) / RTCM_RANGE_MS;
+                    if (std::fabs(phase_ms) >= 1.0 / 256.0)
+                        {
+                            lock.offset_cycles = std::floor(cycles - gs.Pseudorange_m / lambda + 0.5);
+                            lock.start = obs_time;
+                            phase_ms = ((cycles - lock.offset_cycles) * lambda - rough_range_m) / RTCM_RANGE_MS;
+                        }
+                    fine_phase[i] = msm7 ? scaled(phase_ms, TWO_N31) : scaled(phase_ms, TWO_N29);
+                }
+            double lock_s = obs_time - lock.start;
+            lock_indicator[i] = msm7 ? msm_extended_lock_time_indicator(lock_s) : msm_lock_time_indicator(lock_s);
+            cnr[i] = msm7 ? clamp_field(scaled(gs.CN0_dB_hz, 0.0625), 1023) : clamp_field(scaled(gs.CN0_dB_hz, 1.0), 63);
+
+            double rate_m_s = -gs.Carrier_Doppler_hz * lambda;
+            rough_rate[i] = scaled(rate_m_s, 1.0);
+            fine_rate[i] = scaled(rate_m_s - static_cast<double>(rough_rate[i]), 0.0001);
+            if (rough_rate[i] < -8191 or rough_rate[i] > 8191)
+                {
+                    rough_rate[i] = -8192; // invalid
+                    fine_rate[i] = -16384;
+                }
+        }
+
+    begin_message();
+    // Message header
+    put_bits((system == 'G' ? 1070 : 1090) + msm, 12);  // DF002
+    put_bits(rtcm_station_id, 12);                      // DF003
+    put_bits(tow_ms(obs_time), 30);                     // DF004 (GPS) or DF248 (Galileo) epoch time [ms]
+    put_bits(more_messages ? 1 : 0, 1);                 // DF393 multiple message bit
+    put_bits(0, 3);                                     // DF409 issue of data station
+    put_bits(0, 7);                                     // DF001 reserved
+    put_bits(0, 2);                                     // DF411 clock steering indicator
+    put_bits(0, 2);                                     // DF412 external clock indicator
+    put_bits(0, 1);                                     // DF417 divergence-free smoothing indicator
+    put_bits(0, 3);                                     // DF418 smoothing interval
+    put_bits(satellite_mask, 64);                       // DF394 GNSS satellite mask
+    put_bits(1u << (32 - signal_id), 32);               // DF395 GNSS signal mask
+    put_bits((n_sat == 64) ? ~0ULL : (1ULL << n_sat) - 1ULL, n_sat);  // DF396 cell mask, every satellite has the signal
+
+    // Satellite data
+    for (int i = 0; i < n_sat; i++) put_bits(rough_range[i] >> 10, 8);   // DF397 integer ms
+    if (msm7)
+        {
+            for (int i = 0; i < n_sat; i++) put_bits(0, 4);               // extended satellite information
+        }
+    for (int i = 0; i < n_sat; i++) put_bits(rough_range[i] & 1023, 10); // DF398 rough range modulo 1 ms
+    if (msm7)
+        {
+            for (int i = 0; i < n_sat; i++) put_signed(rough_rate[i], 14);  // DF399 rough phaserange rate [m/s]
+        }
+
+    // Signal data
+    for (int i = 0; i < n_sat; i++) put_signed(fine_range[i], msm7 ? 20 : 15);  // DF405 or DF400 fine pseudorange
+    for (int i = 0; i < n_sat; i++) put_signed(fine_phase[i], msm7 ? 24 : 22);  // DF406 or DF401 fine phaserange
+    for (int i = 0; i < n_sat; i++) put_bits(lock_indicator[i], msm7 ? 10 : 4); // DF407 or DF402 lock time indicator
+    for (int i = 0; i < n_sat; i++) put_bits(0, 1);                             // DF420 half-cycle ambiguity indicator
+    for (int i = 0; i < n_sat; i++) put_bits(cnr[i], msm7 ? 10 : 6);            // DF408 or DF403 CNR
+    if (msm7)
         {
-            s_aux.assign(s, i, 32);
-            std::bitset<32> bs(s_aux);
-            unsigned n = bs.to_ulong();
-            ss << std::hex << n;
+            for (int i = 0; i < n_sat; i++) put_signed(fine_rate[i], 15);       // DF404 fine phaserange rate [0.0001 m/s]
         }
-    //return ss.str();
-    return boost::to_upper_copy(ss.str());
+    return end_message();
+}
+
+
+
+int Rtcm_Printer::encode_M1005(double ecef_x_m, double ecef_y_m, double ecef_z_m)
+{
+    return encode_arp(rtcm_station_id, true, scaled(ecef_x_m, 0.0001), scaled(ecef_y_m, 0.0001), scaled(ecef_z_m, 0.0001));
+}
+
+
+
+int Rtcm_Printer::encode_arp(unsigned int station_id, bool galileo, long long int ecef_x, long long int ecef_y, long long int ecef_z)
+{
+    begin_message();
+    put_bits(1005, 12);           // DF002
+    put_bits(station_id, 12);     // DF003
+    put_bits(0, 6);               // DF021 ITRF realization year, reserved
+    put_bits(1, 1);               // DF022 GPS
+    put_bits(0, 1);               // DF023 Glonass
+    put_bits(galileo ? 1 : 0, 1); // DF024 Galileo
+    put_bits(0, 1);               // DF141 0: Real, physical reference station
+    put_signed(ecef_x, 38);       // DF025 ECEF-X [0.0001 m]
+    put_bits(0, 1);               // DF142 single receiver oscillator indicator
+    put_bits(0, 1);               // DF001 reserved
+    put_signed(ecef_y, 38);       // DF026 ECEF-Y [0.0001 m]
+    put_bits(0, 2);               // DF364 quarter cycle indicator
+    put_signed(ecef_z, 38);       // DF027 ECEF-Z [0.0001 m]
+    return end_message();
 }
 
 
+
+/* Stationary Antenna Reference Point, No Height Information
+ * Reference Station Id = 2003
+   GPS Service supported, but not GLONASS or Galileo
+   ARP ECEF-X = 1114104.5999 meters
+   ARP ECEF-Y = -4850729.7108 meters
+   ARP ECEF-Z = 3975521.4643 meters
+   Expected output: D3 00 13 3E D7 D3 02 02 98 0E DE EF 34 B4 BD 62
+                    AC 09 41 98 6F 33 36 0B 98
+ */
+std::string Rtcm_Printer::print_M1005_test ()
+{
+    encode_arp(2003, false, 11141045999LL, -48507297108LL, 39755214643LL);
+    return bin_to_hex(rtcm_frame, rtcm_frame_length);
+}
+
+
+
+int Rtcm_Printer::encode_M1019(const Gps_Ephemeris& gps_eph)
+{
+    begin_message();
+    put_bits(1019, 12);                                                 // DF002
+    put_bits(gps_eph.i_satellite_PRN, 6);                               // DF009
+    put_bits(gps_eph.i_GPS_week % 1024, 10);                            // DF076
+    put_bits(gps_eph.i_SV_accuracy, 4);                                 // DF077
+    put_bits(gps_eph.i_code_on_L2, 2);                                  // DF078
+    put_signed(scaled(gps_eph.d_IDOT, I_DOT_LSB), 14);                  // DF079
+    put_bits(static_cast<unsigned int>(gps_eph.d_IODC) & 0xFF, 8);      // DF071 IODE, the 8 LSB of the IODC
+    put_bits(scaled(gps_eph.d_Toc, T_OC_LSB), 16);                      // DF081
+    put_signed(scaled(gps_eph.d_A_f2, A_F2_LSB), 8);                    // DF082
+    put_signed(scaled(gps_eph.d_A_f1, A_F1_LSB), 16);                   // DF083
+    put_signed(scaled(gps_eph.d_A_f0, A_F0_LSB), 22);                   // DF084
+    put_bits(static_cast<unsigned int>(gps_eph.d_IODC), 10);            // DF085
+    put_signed(scaled(gps_eph.d_Crs, C_RS_LSB), 16);                    // DF086
+    put_signed(scaled(gps_eph.d_Delta_n, DELTA_N_LSB), 16);             // DF087
+    put_signed(scaled(gps_eph.d_M_0, M_0_LSB), 32);                     // DF088
+    put_signed(scaled(gps_eph.d_Cuc, C_UC_LSB), 16);                    // DF089
+    put_bits(scaled(gps_eph.d_e_eccentricity, E_LSB), 32);              // DF090
+    put_signed(scaled(gps_eph.d_Cus, C_US_LSB), 16);                    // DF091
+    put_bits(scaled(gps_eph.d_sqrt_A, SQRT_A_LSB), 32);                 // DF092
+    put_bits(scaled(gps_eph.d_Toe, T_OE_LSB), 16);                      // DF093
+    put_signed(scaled(gps_eph.d_Cic, C_IC_LSB), 16);                    // DF094
+    put_signed(scaled(gps_eph.d_OMEGA0, OMEGA_0_LSB), 32);              // DF095
+    put_signed(scaled(gps_eph.d_Cis, C_IS_LSB), 16);                    // DF096
+    put_signed(scaled(gps_eph.d_i_0, I_0_LSB), 32);                     // DF097
+    put_signed(scaled(gps_eph.d_Crc, C_RC_LSB), 16);                    // DF098
+    put_signed(scaled(gps_eph.d_OMEGA, OMEGA_LSB), 32);                 // DF099
+    put_signed(scaled(gps_eph.d_OMEGA_DOT, OMEGA_DOT_LSB), 24);         // DF100
+    put_signed(scaled(gps_eph.d_TGD, T_GD_LSB), 8);                     // DF101
+    put_bits(gps_eph.i_SV_health, 6);                                   // DF102
+    put_bits(gps_eph.b_L2_P_data_flag ? 1 : 0, 1);                      // DF103
+    put_bits(gps_eph.b_fit_interval_flag ? 1 : 0, 1);                   // DF137
+    return end_message();
+}
+
+
+
+int Rtcm_Printer::encode_M1045(const Galileo_Ephemeris& gal_eph)
+{
+    // The receiver decodes the I/NAV message, which has the same ephemeris and
+    // clock parameters as the F/NAV. The E1-B health and data validity take
+    // the place of the E5a ones, that are not broadcast in I/NAV.
+    begin_message();
+    put_bits(1045, 12);                                                     // DF002
+    put_bits(gal_eph.i_satellite_PRN, 6);                                   // DF252
+    put_bits(static_cast<unsigned int>(gal_eph.WN_5) % 4096, 12);           // DF289
+    put_bits(gal_eph.IOD_ephemeris, 10);                                    // DF290
+    put_bits(static_cast<unsigned int>(gal_eph.SISA_3), 8);                 // DF291
+    put_signed(scaled(gal_eph.iDot_2, iDot_2_LSB), 14);                     // DF292
+    put_bits(scaled(gal_eph.t0c_4, t0c_4_LSB), 14);                         // DF293
+    put_signed(scaled(gal_eph.af2_4, af2_4_LSB), 6);                        // DF294
+    put_signed(scaled(gal_eph.af1_4, af1_4_LSB), 21);                       // DF295
+    put_signed(scaled(gal_eph.af0_4, af0_4_LSB), 31);                       // DF296
+    put_signed(scaled(gal_eph.C_rs_3, C_rs_3_LSB), 16);                     // DF297
+    put_signed(scaled(gal_eph.delta_n_3, delta_n_3_LSB), 16);               // DF298
+    put_signed(scaled(gal_eph.M0_1, M0_1_LSB), 32);                         // DF299
+    put_signed(scaled(gal_eph.C_uc_3, C_uc_3_LSB), 16);                     // DF300
+    put_bits(scaled(gal_eph.e_1, e_1_LSB), 32);                             // DF301
+    put_signed(scaled(gal_eph.C_us_3, C_us_3_LSB), 16);                     // DF302
+    put_bits(scaled(gal_eph.A_1, A_1_LSB_gal), 32);                         // DF303
+    put_bits(scaled(gal_eph.t0e_1, t0e_1_LSB), 14);                         // DF304
+    put_signed(scaled(gal_eph.C_ic_4, C_ic_4_LSB), 16);                     // DF305
+    put_signed(scaled(gal_eph.OMEGA_0_2, OMEGA_0_2_LSB), 32);               // DF306
+    put_signed(scaled(gal_eph.C_is_4, C_is_4_LSB), 16);                     // DF307
+    put_signed(scaled(gal_eph.i_0_2, i_0_2_LSB), 32);                       // DF308
+    put_signed(scaled(gal_eph.C_rc_3, C_rc_3_LSB), 16);                     // DF309
+    put_signed(scaled(gal_eph.omega_2, omega_2_LSB), 32);                   // DF310
+    put_signed(scaled(gal_eph.OMEGA_dot_3, OMEGA_dot_3_LSB), 24);           // DF311
+    put_signed(scaled(gal_eph.BGD_E1E5a_5, BGD_E1E5a_5_LSB), 10);           // DF312
+    put_bits(static_cast<unsigned int>(gal_eph.E1B_HS_5), 2);               // DF314
+    put_bits(static_cast<unsigned int>(gal_eph.E1B_DVS_5), 1);              // DF315
+    put_bits(0, 7);                                                         // reserved
+    return end_message();
+}
+
+
+
+std::string Rtcm_Printer::bin_to_hex(const unsigned char* buffer, int length) const
+{
+    static const char digits[] = "0123456789ABCDEF";
+    std::string hex(2 * length, '0');
+    for (int i = 0; i < length; i++)
+        {
+            hex[2 * i] = digits[buffer[i] >> 4];
+            hex[2 * i + 1] = digits[buffer[i] & 0x0F];
+        }
+    return hex;
+}
@@ -34,16 +34,37 @@
 #ifndef GNSS_SDR_RTCM_PRINTER_H_
 #define GNSS_SDR_RTCM_PRINTER_H_
 
-#include <bitset>   // std::bitset
+#include <cmath>    // std::floor
 #include <fstream>  // std::ofstream
-#include <iostream> // std::cout
+#include <map>
+#include <memory>
 #include <string>   // std::string
-#include <vector>
-#include <boost/crc.hpp>
+#include "gps_ephemeris.h"
+#include "galileo_ephemeris.h"
+#include "gnss_synchro.h"
+#include "pvt_stream_server.h"
 
+#define RTCM_MAX_PAYLOAD_LENGTH 1023  // bytes, limited by the 10-bit message length field
+#define RTCM_MAX_FRAME_LENGTH 1029    // preamble, reserved bits and length (3 bytes) + payload + CRC-24Q (3 bytes)
+#define RTCM_MAX_SATELLITES 64        // size of the MSM satellite mask
 
 /*!
  * \brief This class provides a implementation of a subset of the RTCM Standard 10403.2 messages
+ *
+ * Messages are packed bit by bit into a fixed frame buffer, in network
+ * (MSB first) order, and protected with a table driven CRC-24Q. Each
+ * encode_* method assembles one complete transport layer frame, which stays
+ * available through frame() and frame_length() until the next call, and
+ * returns its length in bytes (0 if there was nothing to encode).
+ * Print_Rtcm_Frame() writes the last frame to the output file, serial device
+ * and streaming server.
+ *
+ * Supported messages:
+ * - 1001, 1002, 1003, 1004: GPS L1 (and invalid L2) RTK observables
+ * - 1005: Stationary Antenna Reference Point
+ * - 1019: GPS ephemeris
+ * - 1045: Galileo ephemeris
+ * - MSM4 and MSM7 (1074, 1077, 1094, 1097): GPS L1 C/A and Galileo E1 B+C observables
  */
 class Rtcm_Printer
 {
@@ -51,172 +72,139 @@ public:
     /*!
      * \brief Default constructor.
      */
-    Rtcm_Printer(std::string filename, bool flag_rtcm_tty_port, std::string rtcm_dump_filename);
+    Rtcm_Printer(std::string filename, bool flag_rtcm_tty_port, std::string rtcm_dump_filename, unsigned int station_id = 1234);
 
     /*!
-     * \brief Print RTCM 3.2 messages to the initialized device
+     * \brief Default destructor.
      */
-    //bool Print_Nmea_Line(gps_l1_ca_ls_pvt* position, bool print_average_values);
+    ~Rtcm_Printer();
 
     /*!
-     * \brief Default destructor.
+     * \brief Encodes the GPS observables of \p pseudoranges at \p obs_time (GPS time of week [s])
+     * in a message type 1001, 1002, 1003 or 1004. \p more_messages sets the synchronous GNSS
+     * flag, to indicate that other observables of the same epoch follow.
      */
-    ~Rtcm_Printer();
+    int encode_observables(unsigned int message_type, double obs_time, const std::map<int, Gnss_Synchro>& pseudoranges, bool more_messages);
+
+    /*!
+     * \brief Encodes the observables of \p system ('G' or 'E') in a Multiple Signal Message
+     * MSM4 (\p msm = 4) or MSM7 (\p msm = 7)
+     */
+    int encode_MSM(unsigned int msm, char system, double obs_time, const std::map<int, Gnss_Synchro>& pseudoranges, bool more_messages);
+
+    /*!
+     * \brief Encodes the Antenna Reference Point ECEF coordinates [m] in a message type 1005
+     */
+    int encode_M1005(double ecef_x_m, double ecef_y_m, double ecef_z_m);
+
+    int encode_M1019(const Gps_Ephemeris& gps_eph);     //!< Encodes a GPS ephemeris in a message type 1019
+    int encode_M1045(const Galileo_Ephemeris& gal_eph); //!< Encodes a Galileo ephemeris in a message type 1045
+
+    const unsigned char* frame() const { return rtcm_frame; } //!< Last encoded frame
+    int frame_length() const { return rtcm_frame_length; }    //!< Length of the last encoded frame [bytes]
+
+    /*!
+     * \brief Writes the last encoded frame to the RTCM file, serial device and streaming clients
+     */
+    bool Print_Rtcm_Frame();
 
-    void print_M1001();
+    /*!
+     * \brief Encodes and prints the GPS and Galileo observables of an epoch as MSM4 or MSM7
+     */
+    bool Print_Rtcm_MSM(unsigned int msm, double obs_time, const std::map<int, Gnss_Synchro>& pseudoranges);
+
+    /*!
+     * \brief Encodes and prints the observables of an epoch with \p observables_type,
+     * either a legacy message type (1001 to 1004) or a MSM number (4 or 7).
+     * The legacy messages only carry GPS, so the Galileo satellites are sent as MSM7.
+     */
+    bool Print_Rtcm_Observables(unsigned int observables_type, double obs_time, const std::map<int, Gnss_Synchro>& pseudoranges);
+
+    void Print_Rtcm_Ephemeris(const std::map<int, Gps_Ephemeris>& gps_eph_map);     //!< Encodes and prints a 1019 for each ephemeris
+    void Print_Rtcm_Ephemeris(const std::map<int, Galileo_Ephemeris>& gal_eph_map); //!< Encodes and prints a 1045 for each ephemeris
+
+    /*!
+     * \brief Also sends the frames printed by Print_Rtcm_Frame() to the clients of \p server
+     */
+    void set_stream_server(const std::shared_ptr<Pvt_Stream_Server>& server);
+
+    /*!
+     * \brief Encodes the example message type 1005 of the RTCM standard and
+     * returns the frame in hexadecimal
+     */
     std::string print_M1005_test();
+
+    /*!
+     * \brief Computes the Qualcomm CRC-24Q of \p length bytes
+     */
+    static unsigned int crc24q(const unsigned char* buffer, int length);
+
 private:
     std::string rtcm_filename; // String with the RTCM log filename
     std::ofstream rtcm_file_descriptor; // Output file stream for RTCM log file
     std::string rtcm_devname;
     int rtcm_dev_descriptor; // RTCM serial device descriptor (i.e. COM port)
-    //gps_l1_ca_ls_pvt* d_PVT_data;
+    std::shared_ptr<Pvt_Stream_Server> rtcm_stream_server; // RTCM TCP clients
     int init_serial (std::string serial_device); //serial port control
     void close_serial ();
 
-    //std::bitset<8> DF001;
-    std::bitset<12> DF002;
-    std::bitset<12> DF003;
-    std::bitset<30> DF004;
-    std::bitset<1> DF005;
-    std::bitset<5> DF006;
-    std::bitset<1> DF007;
-    std::bitset<3> DF008;
-    std::bitset<6> DF009;
-    std::bitset<1> DF010;
-    std::bitset<24> DF011;
-    std::bitset<20> DF012;
-    std::bitset<7> DF013;
-    std::bitset<8> DF014;
-    std::bitset<8> DF015;
-
-
-    std::bitset<6> DF021;
-    std::bitset<1> DF022;
-    std::bitset<1> DF023;
-    std::bitset<1> DF024;
-    std::bitset<38> DF025;
-    std::bitset<38> DF026;
-    std::bitset<38> DF027;
-
-    // Contents of GPS Satellite Ephemeris Data, Message Type 1019
-    std::bitset<8> DF071;
-    std::bitset<10> DF076;
-    std::bitset<4> DF077;
-    std::bitset<2> DF078;
-    std::bitset<14> DF079;
-    std::bitset<16> DF081;
-    std::bitset<8> DF082;
-    std::bitset<16> DF083;
-    std::bitset<22> DF084;
-    std::bitset<10> DF085;
-    std::bitset<16> DF086;
-    std::bitset<16> DF087;
-
-    std::bitset<32> DF088;
-    std::bitset<16> DF089;
-    std::bitset<32> DF090;
-    std::bitset<16> DF091;
-    std::bitset<32> DF092;
-    std::bitset<16> DF093;
-    std::bitset<16> DF094;
-    std::bitset<32> DF095;
-    std::bitset<16> DF096;
-    std::bitset<32> DF097;
-    std::bitset<16> DF098;
-    std::bitset<32> DF099;
-    std::bitset<24> DF100;
-    std::bitset<8> DF101;
-    std::bitset<6> DF102;
-    std::bitset<1> DF103;
-    std::bitset<1> DF137;
-
-
-    std::bitset<1> DF141;
-    std::bitset<1> DF142;
-
-    // Contents of Galileo F/NAV Satellite Ephemeris Data, Message Type 1045
-    std::bitset<6> DF252;
-    std::bitset<12> DF289;
-    std::bitset<10> DF290;
-    std::bitset<8> DF291;
-    std::bitset<14> DF292;
-    std::bitset<14> DF293;
-    std::bitset<6> DF294;
-    std::bitset<21> DF295;
-    std::bitset<31> DF296;
-    std::bitset<16> DF297;
-    std::bitset<32> DF298;
-    std::bitset<14> DF299;
-    std::bitset<16> DF300;
-    std::bitset<32> DF301;
-    std::bitset<16> DF302;
-    std::bitset<32> DF303;
-    std::bitset<14> DF304;
-    std::bitset<16> DF305;
-    std::bitset<32> DF306;
-    std::bitset<16> DF307;
-    std::bitset<32> DF308;
-    std::bitset<16> DF309;
-    std::bitset<32> DF310;
-    std::bitset<24> DF311;
-    std::bitset<10> DF312;
-    std::bitset<2> DF314;
-    std::bitset<1> DF315;
-
-    std::bitset<2> DF364;
-
-    // Content of message header for MSM1, MSM2, MSM3, MSM4, MSM5, MSM6 and MSM7
-    std::bitset<1> DF393;
-    std::bitset<1> DF394;
-    std::bitset<1> DF395;
-    std::bitset<1> DF396; //variable
-    std::bitset<1> DF409;
-    std::bitset<1> DF411;
-    std::bitset<1> DF412;
-    std::bitset<1> DF417;
-    std::bitset<1> DF418;
-
-    // Content of Satellite data for MSM4 and MSM6
-    std::vector<std::bitset<8> > DF397; // 8*NSAT
-    std::vector<std::bitset<10> > DF398; // 10*NSAT
-
-    // Content of Satellite data for MSM5 and MSM7
-    std::vector<std::bitset<14> > DF399; // 14*NSAT
-
-    // Messages
-    std::bitset<64> message1001_header;
-    std::bitset<58> message1001_content;
-    std::bitset<64> message1002_header;
-    std::bitset<74> message1002_content;
-
-    std::bitset<488> message1019_content;
-
-    std::bitset<496> message1045_content;
-
-    std::bitset<169> MSM_header; // 169+X
-
-    std::vector<std::bitset<18> > MSM4_content; // 18 * Nsat
-
-    std::vector<std::bitset<36> > MSM5_content; // 36 * Nsat
-
-    std::bitset<122> get_M1001();
-    std::bitset<138> get_M1002();  //  GPS observables
-    std::bitset<488> get_M1019();  // GPS ephemeris
-    std::bitset<496> get_M1045();  // Galileo ephemeris
-    std::bitset<152> get_M1005_test();
-
-    void reset_data_fields ();
-
-    // Transport Layer
-    std::bitset<8> preamble;
-    std::bitset<6> reserved_field;
-    std::bitset<10> message_length;
-    std::bitset<24> crc_frame;
-    typedef boost::crc_optimal<24, 0x1864CFBu, 0x0, 0x0, false, false> crc_24_q_type;
-    crc_24_q_type CRC_RTCM;
-    std::string add_CRC(const std::string& m);
-    std::string bin_to_hex(const std::string& s);
+    unsigned int rtcm_station_id;
+    unsigned char rtcm_frame[RTCM_MAX_FRAME_LENGTH];
+    int rtcm_frame_length;
+    int rtcm_bit_position;  // next payload bit to be written, counted from the start of the frame
+
+    // Continuous tracking of each satellite, for the lock time indicators and
+    // the phase range offset (an integer number of cycles) of the MSM
+    struct Rtcm_Lock
+    {
+        bool valid;
+        bool offset_valid;
+        double start;
+        double last;
+        double offset_cycles;
+        Rtcm_Lock() : valid(false), offset_valid(false), start(0.0), last(0.0), offset_cycles(0.0) {}
+    };
+    std::map<int, Rtcm_Lock> rtcm_lock;
+    Rtcm_Lock& update_lock(char system, int prn, double obs_time);
+
+    int select_satellites(char system, const std::map<int, Gnss_Synchro>& pseudoranges, const Gnss_Synchro** sats);
+    int encode_arp(unsigned int station_id, bool galileo, long long int ecef_x, long long int ecef_y, long long int ecef_z);
+    void begin_message();
+    int end_message();
+
+    // Appends the \p length least significant bits of \p value to the payload, MSB first
+    inline void put_bits(unsigned long long int value, int length)
+    {
+        if (rtcm_bit_position + length > 8 * (3 + RTCM_MAX_PAYLOAD_LENGTH))
+            {
+                rtcm_bit_position = 8 * (3 + RTCM_MAX_PAYLOAD_LENGTH) + 1; // marks the overflow, checked by end_message()
+                return;
+            }
+        while (length > 0)
+            {
+                int byte = rtcm_bit_position >> 3;
+                int free_bits = 8 - (rtcm_bit_position & 7);
+                int n = (length < free_bits) ? length : free_bits;
+                unsigned int chunk = static_cast<unsigned int>(value >> (length - n)) & ((1u << n) - 1u);
+                rtcm_frame[byte] |= static_cast<unsigned char>(chunk << (free_bits - n));
+                rtcm_bit_position += n;
+                length -= n;
+            }
+    }
+
+    // Two's complement of \p value in \p length bits
+    inline void put_signed(long long int value, int length)
+    {
+        put_bits(static_cast<unsigned long long int>(value), length);
+    }
+
+    // Rounds \p value / \p lsb to the nearest integer
+    static inline long long int scaled(double value, double lsb)
+    {
+        return static_cast<long long int>(std::floor(value / lsb + 0.5));
+    }
+
+    std::string bin_to_hex(const unsigned char* buffer, int length) const;
 };
 
 #endif
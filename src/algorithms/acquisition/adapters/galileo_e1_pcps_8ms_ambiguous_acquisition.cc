@@ -221,6 +221,13 @@ GalileoE1Pcps8msAmbiguousAcquisition::init()
 }
 
 
+void
+GalileoE1Pcps8msAmbiguousAcquisition::release()
+{
+    acquisition_cc_->free_grid_memory();
+}
+
+
 void
 GalileoE1Pcps8msAmbiguousAcquisition::set_local_code()
 {
@@ -231,6 +231,13 @@ GalileoE1PcpsAmbiguousAcquisition::init()
 }
 
 
+void
+GalileoE1PcpsAmbiguousAcquisition::release()
+{
+    acquisition_cc_->free_grid_memory();
+}
+
+
 void
 GalileoE1PcpsAmbiguousAcquisition::set_local_code()
 {
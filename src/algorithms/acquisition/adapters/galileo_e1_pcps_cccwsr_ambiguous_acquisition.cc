@@ -224,6 +224,13 @@ GalileoE1PcpsCccwsrAmbiguousAcquisition::init()
 }
 
 
+void
+GalileoE1PcpsCccwsrAmbiguousAcquisition::release()
+{
+    acquisition_cc_->free_grid_memory();
+}
+
+
 void
 GalileoE1PcpsCccwsrAmbiguousAcquisition::set_local_code()
 {
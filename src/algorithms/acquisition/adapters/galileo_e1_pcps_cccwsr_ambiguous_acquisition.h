@@ -126,6 +126,11 @@ public:
      */
     void reset();
 
+    /*!
+     * \brief Frees the search grid until the next init()
+     */
+    void release();
+
 private:
     ConfigurationInterface* configuration_;
     pcps_cccwsr_acquisition_cc_sptr acquisition_cc_;
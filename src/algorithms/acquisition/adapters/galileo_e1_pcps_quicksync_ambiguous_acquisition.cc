@@ -255,6 +255,13 @@ GalileoE1PcpsQuickSyncAmbiguousAcquisition::init()
 }
 
 
+void
+GalileoE1PcpsQuickSyncAmbiguousAcquisition::release()
+{
+    acquisition_cc_->free_grid_memory();
+}
+
+
 void
 GalileoE1PcpsQuickSyncAmbiguousAcquisition::set_local_code()
 {
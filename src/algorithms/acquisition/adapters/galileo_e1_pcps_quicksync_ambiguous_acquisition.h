@@ -129,6 +129,11 @@ public:
      */
     void reset();
 
+    /*!
+     * \brief Frees the search grid until the next init()
+     */
+    void release();
+
 private:
     ConfigurationInterface* configuration_;
     pcps_quicksync_acquisition_cc_sptr acquisition_cc_;
@@ -223,6 +223,13 @@ GalileoE1PcpsTongAmbiguousAcquisition::init()
 }
 
 
+void
+GalileoE1PcpsTongAmbiguousAcquisition::release()
+{
+    acquisition_cc_->free_grid_memory();
+}
+
+
 void
 GalileoE1PcpsTongAmbiguousAcquisition::set_local_code()
 {
@@ -217,6 +217,12 @@ void GalileoE5aNoncoherentIQAcquisitionCaf::init()
     set_local_code();
 }
 
+
+void GalileoE5aNoncoherentIQAcquisitionCaf::release()
+{
+    acquisition_cc_->free_grid_memory();
+}
+
 void GalileoE5aNoncoherentIQAcquisitionCaf::set_local_code()
 {
 	if (item_type_.compare("gr_complex")==0)
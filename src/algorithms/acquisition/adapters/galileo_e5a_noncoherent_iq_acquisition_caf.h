@@ -129,6 +129,11 @@ public:
 	  */
 	 void reset();
 
+	 /*!
+	  * \brief Frees the search grid until the next init()
+	  */
+	 void release();
+
 private:
 	 ConfigurationInterface* configuration_;
 	 galileo_e5a_noncoherentIQ_acquisition_caf_cc_sptr acquisition_cc_;
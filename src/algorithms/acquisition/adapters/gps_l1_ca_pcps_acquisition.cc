@@ -215,6 +215,12 @@ void GpsL1CaPcpsAcquisition::init()
 }
 
 
+void GpsL1CaPcpsAcquisition::release()
+{
+    acquisition_cc_->free_grid_memory();
+}
+
+
 void GpsL1CaPcpsAcquisition::set_local_code()
 {
     if (item_type_.compare("gr_complex") == 0)
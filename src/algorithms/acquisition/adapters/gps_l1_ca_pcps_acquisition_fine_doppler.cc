@@ -151,6 +151,12 @@ void GpsL1CaPcpsAcquisitionFineDoppler::init()
 }
 
 
+void GpsL1CaPcpsAcquisitionFineDoppler::release()
+{
+    acquisition_cc_->free_grid_memory();
+}
+
+
 void GpsL1CaPcpsAcquisitionFineDoppler::set_local_code()
 {
     gps_l1_ca_code_gen_complex_sampled(code_, gnss_synchro_->PRN, fs_in_, 0);
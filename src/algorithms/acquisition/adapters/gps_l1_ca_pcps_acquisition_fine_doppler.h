@@ -129,6 +129,11 @@ public:
      */
     void reset();
 
+    /*!
+     * \brief Frees the search grid until the next init()
+     */
+    void release();
+
 private:
     pcps_acquisition_fine_doppler_cc_sptr acquisition_cc_;
     size_t item_size_;
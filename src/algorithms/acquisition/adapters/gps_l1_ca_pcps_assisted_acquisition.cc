@@ -149,6 +149,12 @@ void GpsL1CaPcpsAssistedAcquisition::init()
     set_local_code();
 }
 
+
+void GpsL1CaPcpsAssistedAcquisition::release()
+{
+    // the assisted acquisition frees its grid itself at the end of each search
+}
+
 void GpsL1CaPcpsAssistedAcquisition::set_local_code()
 {
     gps_l1_ca_code_gen_complex_sampled(code_, gnss_synchro_->PRN, fs_in_, 0);
@@ -210,6 +210,12 @@ void GpsL1CaPcpsMultithreadAcquisition::init()
 }
 
 
+void GpsL1CaPcpsMultithreadAcquisition::release()
+{
+    acquisition_cc_->free_grid_memory();
+}
+
+
 void GpsL1CaPcpsMultithreadAcquisition::set_local_code()
 {
     if (item_type_.compare("gr_complex") == 0)
@@ -209,6 +209,12 @@ void GpsL1CaPcpsOpenClAcquisition::init()
 }
 
 
+void GpsL1CaPcpsOpenClAcquisition::release()
+{
+    acquisition_cc_->free_grid_memory();
+}
+
+
 void GpsL1CaPcpsOpenClAcquisition::set_local_code()
 {
     if (item_type_.compare("gr_complex") == 0)
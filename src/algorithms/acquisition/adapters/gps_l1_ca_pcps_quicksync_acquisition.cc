@@ -245,6 +245,12 @@ void GpsL1CaPcpsQuickSyncAcquisition::init()
 }
 
 
+void GpsL1CaPcpsQuickSyncAcquisition::release()
+{
+    acquisition_cc_->free_grid_memory();
+}
+
+
 void GpsL1CaPcpsQuickSyncAcquisition::set_local_code()
 {
     if (item_type_.compare("gr_complex") == 0)
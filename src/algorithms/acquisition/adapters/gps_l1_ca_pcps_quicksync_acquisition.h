@@ -132,6 +132,11 @@ public:
      */
     void reset();
 
+    /*!
+     * \brief Frees the search grid until the next init()
+     */
+    void release();
+
 
 private:
     ConfigurationInterface* configuration_;
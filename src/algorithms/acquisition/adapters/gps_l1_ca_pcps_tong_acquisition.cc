@@ -201,6 +201,12 @@ void GpsL1CaPcpsTongAcquisition::init()
     set_local_code();
 }
 
+
+void GpsL1CaPcpsTongAcquisition::release()
+{
+    acquisition_cc_->free_grid_memory();
+}
+
 void GpsL1CaPcpsTongAcquisition::set_local_code()
 {
     if (item_type_.compare("gr_complex") == 0)
@@ -79,6 +79,7 @@ galileo_e5a_noncoherentIQ_acquisition_caf_cc::galileo_e5a_noncoherentIQ_acquisit
 		gr::io_signature::make(1, 1, sizeof(gr_complex)),
 		gr::io_signature::make(0, 0, sizeof(gr_complex)))
 {
+    d_counters = gnss_block_counters(this);
     d_sample_counter = 0;    // SAMPLE COUNTER
     d_active = false;
     d_state = 0;
@@ -139,7 +140,7 @@ galileo_e5a_noncoherentIQ_acquisition_caf_cc::galileo_e5a_noncoherentIQ_acquisit
     d_dump_filename = dump_filename;
 }
 
-galileo_e5a_noncoherentIQ_acquisition_caf_cc::~galileo_e5a_noncoherentIQ_acquisition_caf_cc()
+void galileo_e5a_noncoherentIQ_acquisition_caf_cc::free_grid_memory()
 {
     if (d_num_doppler_bins > 0)
         {
@@ -148,7 +149,22 @@ galileo_e5a_noncoherentIQ_acquisition_caf_cc::~galileo_e5a_noncoherentIQ_acquisi
                     volk_free(d_grid_doppler_wipeoffs[i]);
                 }
             delete[] d_grid_doppler_wipeoffs;
+            if (d_CAF_window_hz > 0)
+                {
+                    volk_free(d_CAF_vector);
+                    volk_free(d_CAF_vector_I);
+                    if (d_both_signal_components == true)
+                        {
+                            volk_free(d_CAF_vector_Q);
+                        }
+                }
         }
+    d_num_doppler_bins = 0;
+}
+
+galileo_e5a_noncoherentIQ_acquisition_caf_cc::~galileo_e5a_noncoherentIQ_acquisition_caf_cc()
+{
+    free_grid_memory();
 
     volk_free(d_inbuffer);
     volk_free(d_fft_code_I_A);
@@ -169,15 +185,6 @@ galileo_e5a_noncoherentIQ_acquisition_caf_cc::~galileo_e5a_noncoherentIQ_acquisi
 		    volk_free(d_magnitudeQB);
 		}
 	}
-    if (d_CAF_window_hz > 0)
-        {
-            volk_free(d_CAF_vector);
-            volk_free(d_CAF_vector_I);
-            if (d_both_signal_components == true)
-                {
-                    volk_free(d_CAF_vector_Q);
-                }
-        }
 
     delete d_fft_if;
     delete d_ifft;
@@ -248,7 +255,7 @@ void galileo_e5a_noncoherentIQ_acquisition_caf_cc::init()
     d_input_power = 0.0;
 
     // Count the number of bins
-    d_num_doppler_bins = 0;
+    free_grid_memory();   // init() may be called again with another grid
     for (int doppler = static_cast<int>(-d_doppler_max);
          doppler <= static_cast<int>(d_doppler_max);
          doppler += d_doppler_step)
@@ -285,6 +292,7 @@ int galileo_e5a_noncoherentIQ_acquisition_caf_cc::general_work(int noutput_items
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
     /*
      * By J.Arribas, L.Esteve, M.Molina and M.Sales
      * Acquisition strategy (Kay Borre book + CFAR threshold):
@@ -49,6 +49,7 @@
 #include <gnuradio/fft/fft.h>
 #include "concurrent_queue.h"
 #include "gnss_synchro.h"
+#include "gnss_block_counters.h"
 
 class galileo_e5a_noncoherentIQ_acquisition_caf_cc;
 
@@ -157,6 +158,7 @@ private:
     std::string d_dump_filename;
     unsigned int d_buffer_count;
     unsigned int d_gr_stream_buffer;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
     /*!
@@ -187,6 +189,11 @@ public:
       */
      void init();
 
+     /*!
+      * \brief Frees the Doppler search grid. The next init() builds it again.
+      */
+     void free_grid_memory();
+
      /*!
       * \brief Sets local code for PCPS acquisition algorithm.
       * \param code - Pointer to the PRN code.
@@ -43,6 +43,7 @@
 #include <gnuradio/fft/fft.h>
 #include "concurrent_queue.h"
 #include "gnss_synchro.h"
+#include "gnss_block_counters.h"
 
 class galileo_pcps_8ms_acquisition_cc;
 
@@ -115,6 +116,7 @@ private:
 	bool d_dump;
 	unsigned int d_channel;
 	std::string d_dump_filename;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
     /*!
@@ -145,6 +147,11 @@ public:
      */
     void init();
 
+    /*!
+     * \brief Frees the Doppler search grid. The next init() builds it again.
+     */
+    void free_grid_memory();
+
     /*!
      * \brief Sets local code for PCPS acquisition algorithm.
      * \param code - Pointer to the PRN code.
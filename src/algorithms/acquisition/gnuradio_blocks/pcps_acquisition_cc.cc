@@ -68,6 +68,7 @@ pcps_acquisition_cc::pcps_acquisition_cc(
     gr::io_signature::make(1, 1, sizeof(gr_complex) * sampled_ms * samples_per_ms),
     gr::io_signature::make(0, 0, sizeof(gr_complex) * sampled_ms * samples_per_ms))
 {
+    d_counters = gnss_block_counters(this);
     d_sample_counter = 0;    // SAMPLE COUNTER
     d_active = false;
     d_state = 0;
@@ -100,7 +101,7 @@ pcps_acquisition_cc::pcps_acquisition_cc(
     d_dump_filename = dump_filename;
 }
 
-pcps_acquisition_cc::~pcps_acquisition_cc()
+void pcps_acquisition_cc::free_grid_memory()
 {
     if (d_num_doppler_bins > 0)
         {
@@ -110,6 +111,12 @@ pcps_acquisition_cc::~pcps_acquisition_cc()
                 }
             delete[] d_grid_doppler_wipeoffs;
         }
+    d_num_doppler_bins = 0;
+}
+
+pcps_acquisition_cc::~pcps_acquisition_cc()
+{
+    free_grid_memory();
 
     volk_free(d_fft_codes);
     volk_free(d_magnitude);
@@ -139,7 +146,7 @@ void pcps_acquisition_cc::init()
     d_input_power = 0.0;
 
     // Count the number of bins
-    d_num_doppler_bins = 0;
+    free_grid_memory();   // init() may be called again with another grid
     for (int doppler = static_cast<int>(-d_doppler_max);
          doppler <= static_cast<int>(d_doppler_max);
          doppler += d_doppler_step)
@@ -162,6 +169,7 @@ int pcps_acquisition_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
     /*
      * By J.Arribas, L.Esteve and M.Molina
      * Acquisition strategy (Kay Borre book + CFAR threshold):
@@ -61,6 +61,7 @@
 #include <gnuradio/fft/fft.h>
 #include "concurrent_queue.h"
 #include "gnss_synchro.h"
+#include "gnss_block_counters.h"
 
 class pcps_acquisition_cc;
 
@@ -136,6 +137,7 @@ private:
     bool d_dump;
     unsigned int d_channel;
     std::string d_dump_filename;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
     /*!
@@ -166,6 +168,11 @@ public:
       */
      void init();
 
+     /*!
+      * \brief Frees the Doppler search grid. The next init() builds it again.
+      */
+     void free_grid_memory();
+
      /*!
       * \brief Sets local code for PCPS acquisition algorithm.
       * \param code - Pointer to the PRN code.
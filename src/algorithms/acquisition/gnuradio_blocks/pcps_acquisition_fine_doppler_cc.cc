@@ -66,6 +66,7 @@ pcps_acquisition_fine_doppler_cc::pcps_acquisition_fine_doppler_cc(
 		                gr::io_signature::make(1, 1, sizeof(gr_complex)),
 		                gr::io_signature::make(0, 0, sizeof(gr_complex)))
 {
+    d_counters = gnss_block_counters(this);
     d_sample_counter = 0;    // SAMPLE COUNTER
     d_active = false;
     d_queue = queue;
@@ -81,6 +82,8 @@ pcps_acquisition_fine_doppler_cc::pcps_acquisition_fine_doppler_cc(
     d_gnuradio_forecast_samples = d_fft_size;
     d_input_power = 0.0;
     d_state = 0;
+    d_num_doppler_points = 0;
+    d_doppler_step = 0;
     d_carrier = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
     d_fft_codes = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
     d_magnitude = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
@@ -99,6 +102,7 @@ pcps_acquisition_fine_doppler_cc::pcps_acquisition_fine_doppler_cc(
 void pcps_acquisition_fine_doppler_cc::set_doppler_step(unsigned int doppler_step)
 {
     d_doppler_step = doppler_step;
+    free_grid_memory();   // the step may change again at run time
     // Create the search grid array
 
     d_num_doppler_points = floor(std::abs(d_config_doppler_max - d_config_doppler_min) / d_doppler_step);
@@ -113,13 +117,17 @@ void pcps_acquisition_fine_doppler_cc::set_doppler_step(unsigned int doppler_ste
 
 void pcps_acquisition_fine_doppler_cc::free_grid_memory()
 {
-    for (int i = 0; i < d_num_doppler_points; i++)
+    if (d_num_doppler_points > 0)
         {
-            volk_free(d_grid_data[i]);
-            delete[] d_grid_doppler_wipeoffs[i];
+            for (int i = 0; i < d_num_doppler_points; i++)
+                {
+                    volk_free(d_grid_data[i]);
+                    delete[] d_grid_doppler_wipeoffs[i];
+                }
+            delete d_grid_data;
+            delete d_grid_doppler_wipeoffs;
         }
-    delete d_grid_data;
-    delete d_grid_doppler_wipeoffs;
+    d_num_doppler_points = 0;
 }
 
 pcps_acquisition_fine_doppler_cc::~pcps_acquisition_fine_doppler_cc()
@@ -154,7 +162,10 @@ void pcps_acquisition_fine_doppler_cc::init()
     d_gnss_synchro->Acq_samplestamp_samples = 0;
     d_input_power = 0.0;
     d_state = 0;
-
+    if (d_num_doppler_points == 0 and d_doppler_step > 0)
+        {
+            set_doppler_step(d_doppler_step);   // the grid was freed
+        }
 }
 
 void pcps_acquisition_fine_doppler_cc::forecast (int noutput_items,
@@ -408,6 +419,7 @@ int pcps_acquisition_fine_doppler_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
 
     /*!
      * TODO: 	High sensitivity acquisition algorithm:
@@ -59,6 +59,7 @@
 #include <gnuradio/fft/fft.h>
 #include "concurrent_queue.h"
 #include "gnss_synchro.h"
+#include "gnss_block_counters.h"
 
 class pcps_acquisition_fine_doppler_cc;
 typedef boost::shared_ptr<pcps_acquisition_fine_doppler_cc>
@@ -98,7 +99,6 @@ private:
 	double search_maximum();
 	void reset_grid();
 	void update_carrier_wipeoff();
-	void free_grid_memory();
 
 	long d_fs_in;
 	long d_freq;
@@ -140,6 +140,7 @@ private:
 	unsigned int d_channel;
 
 	std::string d_dump_filename;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
 	/*!
@@ -170,6 +171,11 @@ public:
 	  */
 	 void init();
 
+	 /*!
+	  * \brief Frees the Doppler search grid. The next init() builds it again.
+	  */
+	 void free_grid_memory();
+
 	 /*!
 	  * \brief Sets local code for PCPS acquisition algorithm.
 	  * \param code - Pointer to the PRN code.
@@ -66,6 +66,7 @@ pcps_assisted_acquisition_cc::pcps_assisted_acquisition_cc(
 		                gr::io_signature::make(1, 1, sizeof(gr_complex)),
 		                gr::io_signature::make(0, 0, sizeof(gr_complex)))
 {
+    d_counters = gnss_block_counters(this);
     d_sample_counter = 0;    // SAMPLE COUNTER
     d_active = false;
     d_queue = queue;
@@ -351,6 +352,7 @@ int pcps_assisted_acquisition_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
     /*!
      * TODO: 	High sensitivity acquisition algorithm:
      * 			State Mechine:
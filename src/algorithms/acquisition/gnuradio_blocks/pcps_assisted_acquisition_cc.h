@@ -59,6 +59,7 @@
 #include <gnuradio/fft/fft.h>
 #include "concurrent_queue.h"
 #include "gnss_synchro.h"
+#include "gnss_block_counters.h"
 
 class pcps_assisted_acquisition_cc;
 
@@ -143,6 +144,7 @@ private:
     unsigned int d_channel;
 
     std::string d_dump_filename;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
     /*!
@@ -69,6 +69,7 @@ pcps_cccwsr_acquisition_cc::pcps_cccwsr_acquisition_cc(
     gr::io_signature::make(1, 1, sizeof(gr_complex) * sampled_ms * samples_per_ms),
     gr::io_signature::make(0, 0, sizeof(gr_complex) * sampled_ms * samples_per_ms))
 {
+    d_counters = gnss_block_counters(this);
     d_sample_counter = 0;    // SAMPLE COUNTER
     d_active = false;
     d_state = 0;
@@ -105,7 +106,7 @@ pcps_cccwsr_acquisition_cc::pcps_cccwsr_acquisition_cc(
     d_dump_filename = dump_filename;
 }
 
-pcps_cccwsr_acquisition_cc::~pcps_cccwsr_acquisition_cc()
+void pcps_cccwsr_acquisition_cc::free_grid_memory()
 {
     if (d_num_doppler_bins > 0)
         {
@@ -115,6 +116,12 @@ pcps_cccwsr_acquisition_cc::~pcps_cccwsr_acquisition_cc()
                 }
             delete[] d_grid_doppler_wipeoffs;
         }
+    d_num_doppler_bins = 0;
+}
+
+pcps_cccwsr_acquisition_cc::~pcps_cccwsr_acquisition_cc()
+{
+    free_grid_memory();
 
     volk_free(d_fft_code_data);
     volk_free(d_fft_code_pilot);
@@ -162,7 +169,7 @@ void pcps_cccwsr_acquisition_cc::init()
     d_input_power = 0.0;
 
     // Count the number of bins
-    d_num_doppler_bins = 0;
+    free_grid_memory();   // init() may be called again with another grid
     for (int doppler = static_cast<int>(-d_doppler_max);
          doppler <= static_cast<int>(d_doppler_max);
          doppler += d_doppler_step)
@@ -186,6 +193,7 @@ int pcps_cccwsr_acquisition_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
 
     int acquisition_message = -1; //0=STOP_CHANNEL 1=ACQ_SUCCEES 2=ACQ_FAIL
 
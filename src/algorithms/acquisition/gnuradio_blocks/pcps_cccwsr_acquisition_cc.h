@@ -49,6 +49,7 @@
 #include <gnuradio/fft/fft.h>
 #include "concurrent_queue.h"
 #include "gnss_synchro.h"
+#include "gnss_block_counters.h"
 
 
 class pcps_cccwsr_acquisition_cc;
@@ -125,6 +126,7 @@ private:
     bool d_dump;
     unsigned int d_channel;
     std::string d_dump_filename;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
     /*!
@@ -155,6 +157,11 @@ public:
       */
      void init();
 
+     /*!
+      * \brief Frees the Doppler search grid. The next init() builds it again.
+      */
+     void free_grid_memory();
+
      /*!
       * \brief Sets local code for CCCWSR acquisition algorithm.
       * \param data_code - Pointer to the data PRN code.
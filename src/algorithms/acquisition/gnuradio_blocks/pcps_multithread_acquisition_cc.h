@@ -63,6 +63,7 @@
 #include <gnuradio/fft/fft.h>
 #include "concurrent_queue.h"
 #include "gnss_synchro.h"
+#include "gnss_block_counters.h"
 
 class pcps_multithread_acquisition_cc;
 
@@ -144,6 +145,7 @@ private:
     gr_complex** d_in_buffer;
     std::vector<unsigned long int> d_sample_counter_buffer;
     unsigned int d_in_dwell_count;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
     /*!
@@ -174,6 +176,11 @@ public:
      */
     void init();
 
+    /*!
+     * \brief Frees the Doppler search grid. The next init() builds it again.
+     */
+    void free_grid_memory();
+
     /*!
      * \brief Sets local code for PCPS acquisition algorithm.
      * \param code - Pointer to the PRN code.
@@ -91,6 +91,7 @@ pcps_opencl_acquisition_cc::pcps_opencl_acquisition_cc(
     gr::io_signature::make(1, 1, sizeof(gr_complex) * sampled_ms * samples_per_ms),
     gr::io_signature::make(0, 0, sizeof(gr_complex) * sampled_ms * samples_per_ms))
 {
+    d_counters = gnss_block_counters(this);
     d_sample_counter = 0;    // SAMPLE COUNTER
     d_active = false;
     d_state = 0;
@@ -146,16 +147,30 @@ pcps_opencl_acquisition_cc::pcps_opencl_acquisition_cc(
 
 
 
-pcps_opencl_acquisition_cc::~pcps_opencl_acquisition_cc()
+void pcps_opencl_acquisition_cc::free_grid_memory()
 {
     if (d_num_doppler_bins > 0)
         {
             for (unsigned int i = 0; i < d_num_doppler_bins; i++)
                 {
                     volk_free(d_grid_doppler_wipeoffs[i]);
+                    if (d_opencl == 0)
+                        {
+                            delete d_cl_buffer_grid_doppler_wipeoffs[i];
+                        }
                 }
             delete[] d_grid_doppler_wipeoffs;
+            if (d_opencl == 0)
+                {
+                    delete[] d_cl_buffer_grid_doppler_wipeoffs;
+                }
         }
+    d_num_doppler_bins = 0;
+}
+
+pcps_opencl_acquisition_cc::~pcps_opencl_acquisition_cc()
+{
+    free_grid_memory();
 
     for (unsigned int i = 0; i < d_max_dwells; i++)
         {
@@ -175,10 +190,6 @@ pcps_opencl_acquisition_cc::~pcps_opencl_acquisition_cc()
             delete d_cl_buffer_2;
             delete d_cl_buffer_magnitude;
             delete d_cl_buffer_fft_codes;
-            if(d_num_doppler_bins > 0)
-                {
-                    delete[] d_cl_buffer_grid_doppler_wipeoffs;
-                }
 
             clFFT_DestroyPlan(d_cl_fft_plan);
         }
@@ -297,7 +308,7 @@ void pcps_opencl_acquisition_cc::init()
     d_input_power = 0.0;
 
     // Count the number of bins
-    d_num_doppler_bins = 0;
+    free_grid_memory();   // init() may be called again with another grid
     for (int doppler = static_cast<int>(-d_doppler_max);
          doppler <= static_cast<int>(d_doppler_max);
          doppler += d_doppler_step)
@@ -669,6 +680,7 @@ int pcps_opencl_acquisition_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
     int acquisition_message = -1; //0=STOP_CHANNEL 1=ACQ_SUCCEES 2=ACQ_FAIL
     switch (d_state)
     {
@@ -64,6 +64,7 @@
 #include "concurrent_queue.h"
 #include "fft_internal.h"
 #include "gnss_synchro.h"
+#include "gnss_block_counters.h"
 
 #ifdef __APPLE__
    #include "cl.hpp"
@@ -170,6 +171,7 @@ private:
     cl_int d_cl_fft_batch_size;
 
     int d_opencl;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
     /*!
@@ -200,6 +202,11 @@ public:
       */
      void init();
 
+     /*!
+      * \brief Frees the Doppler search grid. The next init() builds it again.
+      */
+     void free_grid_memory();
+
      /*!
       * \brief Sets local code for PCPS acquisition algorithm.
       * \param code - Pointer to the PRN code.
@@ -74,6 +74,7 @@ pcps_quicksync_acquisition_cc::pcps_quicksync_acquisition_cc(
                gr::io_signature::make(1, 1, (sizeof(gr_complex)*sampled_ms * samples_per_ms )),
                gr::io_signature::make(0, 0, (sizeof(gr_complex)*sampled_ms * samples_per_ms )))
 {
+    d_counters = gnss_block_counters(this);
     //DLOG(INFO) << "START CONSTRUCTOR";
 
     d_sample_counter = 0;    // SAMPLE COUNTER
@@ -120,9 +121,8 @@ pcps_quicksync_acquisition_cc::pcps_quicksync_acquisition_cc(
     // DLOG(INFO) << "END CONSTRUCTOR";
 }
 
-pcps_quicksync_acquisition_cc::~pcps_quicksync_acquisition_cc()
+void pcps_quicksync_acquisition_cc::free_grid_memory()
 {
-    //DLOG(INFO) << "START DESTROYER";
     if (d_num_doppler_bins > 0)
         {
             for (unsigned int i = 0; i < d_num_doppler_bins; i++)
@@ -131,6 +131,13 @@ pcps_quicksync_acquisition_cc::~pcps_quicksync_acquisition_cc()
                 }
             delete[] d_grid_doppler_wipeoffs;
         }
+    d_num_doppler_bins = 0;
+}
+
+pcps_quicksync_acquisition_cc::~pcps_quicksync_acquisition_cc()
+{
+    //DLOG(INFO) << "START DESTROYER";
+    free_grid_memory();
 
     volk_free(d_fft_codes);
     volk_free(d_magnitude);
@@ -186,7 +193,7 @@ void pcps_quicksync_acquisition_cc::init()
     d_input_power = 0.0;
 
     // Count the number of bins
-    d_num_doppler_bins = 0;
+    free_grid_memory();   // init() may be called again with another grid
     for (int doppler = static_cast<int>(-d_doppler_max);
             doppler <= static_cast<int>(d_doppler_max);
             doppler += d_doppler_step)
@@ -212,6 +219,7 @@ int pcps_quicksync_acquisition_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
     /*
      * By J.Arribas, L.Esteve and M.Molina
      * Acquisition strategy (Kay Borre book + CFAR threshold):
@@ -65,6 +65,7 @@
 #include <gnuradio/fft/fft.h>
 #include "concurrent_queue.h"
 #include "gnss_synchro.h"
+#include "gnss_block_counters.h"
 
 class pcps_quicksync_acquisition_cc;
 
@@ -156,6 +157,7 @@ private:
     bool d_dump;
     unsigned int d_channel;
     std::string d_dump_filename;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
     /*!
@@ -186,6 +188,11 @@ public:
      */
     void init();
 
+    /*!
+     * \brief Frees the Doppler search grid. The next init() builds it again.
+     */
+    void free_grid_memory();
+
     /*!
      * \brief Sets local code for PCPS acquisition algorithm.
      * \param code - Pointer to the PRN code.
@@ -62,6 +62,7 @@
 #include <gnuradio/fft/fft.h>
 #include "concurrent_queue.h"
 #include "gnss_synchro.h"
+#include "gnss_block_counters.h"
 
 class pcps_tong_acquisition_cc;
 
@@ -134,6 +135,7 @@ private:
     bool d_dump;
     unsigned int d_channel;
     std::string d_dump_filename;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
     /*!
@@ -164,6 +166,11 @@ public:
       */
      void init();
 
+     /*!
+      * \brief Frees the Doppler search grid. The next init() builds it again.
+      */
+     void free_grid_memory();
+
      /*!
       * \brief Sets local code for TONG acquisition algorithm.
       * \param code - Pointer to the PRN code.
@@ -33,9 +33,6 @@
 #include <iostream>
 #include <sstream>
 #include <boost/lexical_cast.hpp>
-#include <boost/thread/thread.hpp>
-#include <boost/date_time/posix_time/posix_time.hpp>
-#include <boost/chrono.hpp>
 #include <glog/logging.h>
 #include <gnuradio/io_signature.h>
 #include <gnuradio/message.h>
@@ -43,6 +40,7 @@
 #include "tracking_interface.h"
 #include "telemetry_decoder_interface.h"
 #include "configuration_interface.h"
+#include "gnss_event_loop.h"
 #include "gnss_flowgraph.h"
 
 
@@ -59,7 +57,6 @@ Channel::Channel(ConfigurationInterface *configuration, unsigned int channel,
                 role_(role), implementation_(implementation), channel_(channel),
                 queue_(queue)
 {
-    stop_ = false;
     acq_->set_channel(channel_);
     trk_->set_channel(channel_);
     nav_->set_channel(channel_);
@@ -81,14 +78,15 @@ Channel::Channel(ConfigurationInterface *configuration, unsigned int channel,
     DLOG(INFO) << "Channel "<< channel_ << " Doppler_step = " << doppler_step;
 
     acq_->set_doppler_step(doppler_step);
+    doppler_step_ = doppler_step;
+    acq_doppler_step_ = 0;   // the search grid is built by the first acquisition
+    coarse_acquisition_ = false;
 
     float threshold = configuration->property("Acquisition_"+implementation_+ boost::lexical_cast<std::string>(channel_) + ".threshold", 0.0);
     if(threshold == 0.0) threshold = configuration->property("Acquisition_"+implementation_+".threshold", 0.0);
 
     acq_->set_threshold(threshold);
 
-    acq_->init();
-
     repeat_ = configuration->property("Acquisition_"+implementation_+  boost::lexical_cast<std::string>(channel_) + ".repeat_satellite", false);
     DLOG(INFO) << "Channel " << channel_ << " satellite repeat = " << repeat_;
 
@@ -101,7 +99,6 @@ Channel::Channel(ConfigurationInterface *configuration, unsigned int channel,
     channel_fsm_.set_queue(queue_);
 
     connected_ = false;
-    message_ = 0;
     gnss_signal_ = Gnss_Signal();
 }
 
@@ -109,6 +106,7 @@ Channel::Channel(ConfigurationInterface *configuration, unsigned int channel,
 // Destructor
 Channel::~Channel()
 {
+    stop();
     delete acq_;
     delete trk_;
     delete nav_;
@@ -189,6 +187,15 @@ void Channel::set_signal(Gnss_Signal gnss_signal)
 
 void Channel::start_acquisition()
 {
+    unsigned int doppler_step = coarse_acquisition_ ? 2 * doppler_step_ : doppler_step_;
+    if (doppler_step != acq_doppler_step_)
+        {
+            // the acquisition is idle between searches: its grid can be built again
+            LOG(INFO) << "Channel " << channel_ << " Doppler_step = " << doppler_step;
+            acq_->set_doppler_step(doppler_step);
+            acq_->init();
+            acq_doppler_step_ = doppler_step;
+        }
     channel_fsm_.Event_gps_start_acquisition();
 }
 
@@ -196,62 +203,55 @@ void Channel::start_acquisition()
 
 void Channel::start()
 {
-    ch_thread_ = boost::thread(&Channel::run, this);
+    // the acquisition messages are handled in the event loop, not in a thread of the channel
+    gnss_event_loop().start();
+    gnss_event_loop().attach<int>(channel_internal_queue_, boost::bind(&Channel::process_channel_message, this, _1));
 }
 
 
 
-void Channel::run()
+void Channel::standby()
 {
-    while (!stop_)
-        {
-            channel_internal_queue_.wait_and_pop(message_);
-            process_channel_messages();
-        }
+    channel_fsm_.Event_gps_failed_tracking_standby();
 }
 
 
 
-void Channel::standby()
+void Channel::set_coarse_acquisition(bool coarse)
 {
-    channel_fsm_.Event_gps_failed_tracking_standby();
+    coarse_acquisition_ = coarse;
+}
+
+
+
+void Channel::park(bool parked)
+{
+    if (parked and acq_doppler_step_ != 0)
+        {
+            // idle: nothing searches in the grid until the next start_acquisition()
+            acq_->release();
+            acq_doppler_step_ = 0;
+        }
+    DLOG(INFO) << "Channel " << channel_ << (parked ? " parked" : " back in the pool");
 }
 
 
 
 /*
- * Set stop_ to true and blocks the calling thread until
- * the thread of the constructor has completed
+ * Detaches the queue of the channel from the event loop, and waits until
+ * the messages already posted have been handled
  */
 void Channel::stop()
 {
-    channel_internal_queue_.push(0); //message to stop channel
-    stop_ = true;
-    /* When the boost::thread object that represents a thread of execution
-     * is destroyed the thread becomes detached. Once a thread is detached,
-     * it will continue executing until the invocation of the function or
-     * callable object supplied on construction has completed,
-     * or the program is terminated. In order to wait for a thread of
-     * execution to finish, the join() or timed_join() member functions of
-     * the boost::thread object must be used. join() will block the calling
-     * thread until the thread represented by the boost::thread object
-     * has completed.
-     * NOTE: timed_join() is deprecated and only present up to Boost 1.56
-     *       try_join_until() was introduced in Boost 1.50
-     */
-#ifdef OLD_BOOST
-    ch_thread_.timed_join(boost::posix_time::seconds(1));
-#endif
-#ifndef OLD_BOOST
-    ch_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(50));
-#endif
+    gnss_event_loop().detach(channel_internal_queue_);
+    gnss_event_loop().flush();
 }
 
 
 
-void Channel::process_channel_messages()
+void Channel::process_channel_message(int const& message)
 {
-    switch (message_)
+    switch (message)
     {
     case 0:
         DLOG(INFO) << "Stop channel " << channel_;
@@ -82,11 +82,13 @@ public:
     TelemetryDecoderInterface* telemetry(){ return nav_; }
     void start_acquisition();                   //!< Start the State Machine
     void set_signal(Gnss_Signal gnss_signal_);  //!< Sets the channel GNSS signal
-    void start();                               //!< Start the thread
+    void start();                               //!< Start handling the acquisition messages in the event loop
     void standby();
+    void set_coarse_acquisition(bool coarse);
+    void park(bool parked);                     //!< Frees the acquisition grid of an idle channel taken out of the pool
     /*!
-     * \brief Set stop_ to true and blocks the calling thread until
-     * the thread of the constructor has completed
+     * \brief Stops handling the acquisition messages, and waits until
+     * the ones already received are handled
      */
     void stop();
 
@@ -101,15 +103,14 @@ private:
     Gnss_Synchro gnss_synchro_;
     Gnss_Signal gnss_signal_;
     bool connected_;
-    bool stop_;
-    int message_;
     bool repeat_;
+    unsigned int doppler_step_;        // configured Doppler step of the acquisition
+    unsigned int acq_doppler_step_;    // Doppler step of the current acquisition grid, 0 if there is none
+    bool coarse_acquisition_;
     GpsL1CaChannelFsm channel_fsm_;
     boost::shared_ptr<gr::msg_queue> queue_;
-    concurrent_queue<int> channel_internal_queue_;
-    boost::thread ch_thread_;
-    void run();
-    void process_channel_messages();
+    concurrent_queue<int> channel_internal_queue_;   // attached to the event loop of the receiver
+    void process_channel_message(int const& message);
 };
 
 #endif /*GNSS_SDR_CHANNEL_H_*/
@@ -0,0 +1,111 @@
+/*!
+ * \file packed_to_complex.cc
+ * \brief Adapts a stream of 1, 2 or 4-bit packed samples to a complex stream
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "packed_to_complex.h"
+#include <complex>
+#include <glog/logging.h>
+#include "configuration_interface.h"
+
+using google::LogMessage;
+
+PackedToComplex::PackedToComplex(ConfigurationInterface* configuration, std::string role,
+        unsigned int in_streams, unsigned int out_streams,
+        boost::shared_ptr<gr::msg_queue> queue) :
+                config_(configuration), role_(role), in_streams_(in_streams),
+                out_streams_(out_streams), queue_(queue)
+{
+    std::string default_output_item_type = "gr_complex";
+    std::string default_dump_filename = "../data/data_type_adapter.dat";
+
+    DLOG(INFO) << "role " << role_;
+
+    Packed_Sample_Format format;
+    format.bits = config_->property(role_ + ".bits", 2u);
+    format.complex = config_->property(role_ + ".complex", true);
+    format.sign_magnitude = (config_->property(role_ + ".encoding", std::string("twos_complement")).compare("sign_magnitude") == 0);
+    format.msb_first = (config_->property(role_ + ".bit_order", std::string("lsb_first")).compare("msb_first") == 0);
+    format.word_bytes = config_->property(role_ + ".word_bytes", 1u);
+    format.big_endian = (config_->property(role_ + ".byte_order", std::string("little")).compare("big") == 0);
+    output_item_type_ = config_->property(role_ + ".output_item_type", default_output_item_type);
+    if (output_item_type_.compare("gr_complex") != 0 and output_item_type_.compare("cbyte") != 0)
+        {
+            LOG(WARNING) << output_item_type_ << " unrecognized output item type. Using gr_complex.";
+            output_item_type_ = "gr_complex";
+        }
+
+    dump_ = config_->property(role_ + ".dump", false);
+    dump_filename_ = config_->property(role_ + ".dump_filename", default_dump_filename);
+
+    unpack_ = make_unpack_packed_samples(format, output_item_type_);
+    DLOG(INFO) << "data_type_adapter_(" << unpack_->unique_id() << ")";
+
+    if (dump_)
+        {
+            size_t item_size = sizeof(gr_complex);
+            if (output_item_type_.compare("cbyte") == 0) item_size = sizeof(std::complex<signed char>);
+            DLOG(INFO) << "Dumping output into file " << dump_filename_;
+            file_sink_ = gr::blocks::file_sink::make(item_size, dump_filename_.c_str());
+        }
+}
+
+
+PackedToComplex::~PackedToComplex()
+{}
+
+
+void PackedToComplex::connect(gr::top_block_sptr top_block)
+{
+    if (dump_)
+        {
+            top_block->connect(unpack_, 0, file_sink_, 0);
+        }
+}
+
+
+void PackedToComplex::disconnect(gr::top_block_sptr top_block)
+{
+    if (dump_)
+        {
+            top_block->disconnect(unpack_, 0, file_sink_, 0);
+        }
+}
+
+
+
+gr::basic_block_sptr PackedToComplex::get_left_block()
+{
+    return unpack_;
+}
+
+
+
+gr::basic_block_sptr PackedToComplex::get_right_block()
+{
+    return unpack_;
+}
@@ -0,0 +1,92 @@
+/*!
+ * \file packed_to_complex.h
+ * \brief Adapts a stream of 1, 2 or 4-bit packed samples to a complex stream
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PACKED_TO_COMPLEX_H_
+#define GNSS_SDR_PACKED_TO_COMPLEX_H_
+
+#include <string>
+#include <gnuradio/blocks/file_sink.h>
+#include <gnuradio/msg_queue.h>
+#include "gnss_block_interface.h"
+#include "unpack_packed_samples.h"
+
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Adapts a byte stream of packed front-end samples to a gr_complex
+ * or 8-bit complex (cbyte) stream.
+ *
+ * The layout is given by the options bits (1, 2 or 4), complex (interleaved
+ * I/Q), encoding (twos_complement or sign_magnitude), bit_order (lsb_first
+ * or msb_first), word_bytes (1, 2 or 4) and byte_order (little or big
+ * endian words).
+ */
+class PackedToComplex: public GNSSBlockInterface
+{
+public:
+    PackedToComplex(ConfigurationInterface* configuration,
+            std::string role, unsigned int in_streams,
+            unsigned int out_streams, boost::shared_ptr<gr::msg_queue> queue);
+
+    virtual ~PackedToComplex();
+
+    std::string role()
+    {
+        return role_;
+    }
+    //! Returns "Packed_To_Complex"
+    std::string implementation()
+    {
+        return "Packed_To_Complex";
+    }
+    size_t item_size()
+    {
+        return 0;
+    }
+
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+
+private:
+    unpack_packed_samples_sptr unpack_;
+    ConfigurationInterface* config_;
+    bool dump_;
+    std::string dump_filename_;
+    std::string output_item_type_;
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+    boost::shared_ptr<gr::msg_queue> queue_;
+    gr::blocks::file_sink::sptr file_sink_;
+};
+
+#endif
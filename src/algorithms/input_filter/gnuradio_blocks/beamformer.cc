@@ -46,6 +46,7 @@ beamformer::beamformer()
             		gr::io_signature::make(GNSS_SDR_BEAMFORMER_CHANNELS, GNSS_SDR_BEAMFORMER_CHANNELS,sizeof(gr_complex)),
             		gr::io_signature::make(1, 1,sizeof(gr_complex)))
 {
+    d_counters = gnss_block_counters(this);
 
 	//initialize weight vector
 
@@ -65,6 +66,7 @@ beamformer::~beamformer()
 int beamformer::work(int noutput_items,gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), noutput_items);
     gr_complex *out = (gr_complex *) output_items[0];
 	  // channel output buffers
 	//  gr_complex *ch1 = (gr_complex *) input_items[0];
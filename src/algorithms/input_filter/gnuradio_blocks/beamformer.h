@@ -32,6 +32,7 @@
 #define GNSS_SDR_BEAMFORMER_H
 
 #include <gnuradio/sync_block.h>
+#include "gnss_block_counters.h"
 
 class beamformer;
 typedef boost::shared_ptr<beamformer> beamformer_sptr;
@@ -48,6 +49,7 @@ private:
     make_beamformer_sptr();
 
     gr_complex* weight_vector;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
     beamformer();
@@ -0,0 +1,183 @@
+/*!
+ * \file gnss_block_counters.cc
+ * \brief Runtime performance counters of the GNU Radio blocks of the receiver
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_block_counters.h"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <boost/thread/mutex.hpp>
+#include <gnuradio/io_signature.h>
+
+namespace
+{
+boost::mutex registry_mutex;
+std::vector<std::shared_ptr<Gnss_Block_Counters> > registry;   // guarded by registry_mutex
+
+std::shared_ptr<Gnss_Block_Counters> register_counters(const std::shared_ptr<Gnss_Block_Counters>& counters)
+{
+    boost::mutex::scoped_lock lock(registry_mutex);
+    registry.push_back(counters);
+    return counters;
+}
+
+// one Prometheus metric: help, type and a line per block
+void prometheus_metric(std::ostringstream& os, const std::vector<Gnss_Block_Counters_Snapshot>& blocks,
+        const std::string& name, const std::string& type, const std::string& help,
+        double (*value)(const Gnss_Block_Counters_Snapshot&))
+{
+    os << "# HELP " << name << " " << help << "\n";
+    os << "# TYPE " << name << " " << type << "\n";
+    for (unsigned int i = 0; i < blocks.size(); i++)
+        {
+            os << name << "{block=\"" << blocks[i].name << "\",id=\"" << blocks[i].id << "\"} " << value(blocks[i]) << "\n";
+        }
+}
+}
+
+
+Gnss_Block_Counters::Gnss_Block_Counters(const std::string& name, long id, gr::block* block) :
+        d_name(name), d_id(id), d_block(block), d_work_calls(0), d_work_ns(0), d_items_in(0), d_items_out(0),
+        d_input_items(0), d_input_items_max(0), d_late_epochs(0), d_dropped_epochs(0)
+{
+    // blocks with optional ports may run with nothing connected to them
+    d_inputs = (block != nullptr) and block->input_signature()->min_streams() > 0;
+    d_outputs = (block != nullptr) and block->output_signature()->min_streams() > 0;
+}
+
+
+Gnss_Block_Counters_Snapshot Gnss_Block_Counters::snapshot() const
+{
+    Gnss_Block_Counters_Snapshot s;
+    s.name = d_name;
+    s.id = d_id;
+    s.work_calls = d_work_calls.load(std::memory_order_relaxed);
+    s.work_ns = d_work_ns.load(std::memory_order_relaxed);
+    s.items_in = d_items_in.load(std::memory_order_relaxed);
+    s.items_out = d_items_out.load(std::memory_order_relaxed);
+    s.input_items = d_input_items.load(std::memory_order_relaxed);
+    s.input_items_max = d_input_items_max.load(std::memory_order_relaxed);
+    s.late_epochs = d_late_epochs.load(std::memory_order_relaxed);
+    s.dropped_epochs = d_dropped_epochs.load(std::memory_order_relaxed);
+    return s;
+}
+
+
+std::shared_ptr<Gnss_Block_Counters> gnss_block_counters(gr::block* block)
+{
+    return register_counters(std::make_shared<Gnss_Block_Counters>(block->name(), block->unique_id(), block));
+}
+
+
+std::shared_ptr<Gnss_Block_Counters> gnss_block_counters(const std::string& name, long id)
+{
+    return register_counters(std::make_shared<Gnss_Block_Counters>(name, id));
+}
+
+
+std::vector<Gnss_Block_Counters_Snapshot> gnss_block_counters_snapshot()
+{
+    std::vector<Gnss_Block_Counters_Snapshot> blocks;
+    boost::mutex::scoped_lock lock(registry_mutex);
+    std::vector<std::shared_ptr<Gnss_Block_Counters> >::iterator it = registry.begin();
+    while (it != registry.end())
+        {
+            // the registry holds the last reference once the block is gone
+            if (it->use_count() == 1)
+                {
+                    it = registry.erase(it);
+                    continue;
+                }
+            blocks.push_back((*it)->snapshot());
+            ++it;
+        }
+    return blocks;
+}
+
+
+std::string gnss_block_counters_prometheus(const std::vector<Gnss_Block_Counters_Snapshot>& blocks)
+{
+    std::ostringstream os;
+    os << std::setprecision(15);
+    prometheus_metric(os, blocks, "gnss_sdr_block_work_calls_total", "counter", "Calls to the work function of the block",
+            [](const Gnss_Block_Counters_Snapshot& s) { return static_cast<double>(s.work_calls); });
+    prometheus_metric(os, blocks, "gnss_sdr_block_work_seconds_total", "counter", "Time spent in the work function of the block",
+            [](const Gnss_Block_Counters_Snapshot& s) { return static_cast<double>(s.work_ns) * 1e-9; });
+    prometheus_metric(os, blocks, "gnss_sdr_block_items_in_total", "counter", "Items consumed from the first input",
+            [](const Gnss_Block_Counters_Snapshot& s) { return static_cast<double>(s.items_in); });
+    prometheus_metric(os, blocks, "gnss_sdr_block_items_out_total", "counter", "Items produced in the first output",
+            [](const Gnss_Block_Counters_Snapshot& s) { return static_cast<double>(s.items_out); });
+    prometheus_metric(os, blocks, "gnss_sdr_block_input_items_total", "counter",
+            "Items waiting at the first input, summed over the work calls (divided by the calls: average input buffer fill)",
+            [](const Gnss_Block_Counters_Snapshot& s) { return static_cast<double>(s.input_items); });
+    prometheus_metric(os, blocks, "gnss_sdr_block_input_items_max", "gauge", "Largest number of items waiting at the first input",
+            [](const Gnss_Block_Counters_Snapshot& s) { return static_cast<double>(s.input_items_max); });
+    prometheus_metric(os, blocks, "gnss_sdr_block_late_epochs_total", "counter", "Epochs processed too late",
+            [](const Gnss_Block_Counters_Snapshot& s) { return static_cast<double>(s.late_epochs); });
+    prometheus_metric(os, blocks, "gnss_sdr_block_dropped_epochs_total", "counter", "Epochs dropped",
+            [](const Gnss_Block_Counters_Snapshot& s) { return static_cast<double>(s.dropped_epochs); });
+    return os.str();
+}
+
+
+std::vector<std::string> gnss_block_counters_summary(const std::vector<Gnss_Block_Counters_Snapshot>& before,
+        const std::vector<Gnss_Block_Counters_Snapshot>& after, double seconds)
+{
+    if (seconds <= 0.0) return std::vector<std::string>();
+    std::map<long, const Gnss_Block_Counters_Snapshot*> previous;
+    for (unsigned int i = 0; i < before.size(); i++)
+        {
+            previous[before[i].id] = &before[i];
+        }
+    std::vector<std::pair<double, std::string> > lines;
+    for (unsigned int i = 0; i < after.size(); i++)
+        {
+            Gnss_Block_Counters_Snapshot zero = Gnss_Block_Counters_Snapshot();
+            const Gnss_Block_Counters_Snapshot& b = previous.count(after[i].id) ? *previous[after[i].id] : zero;
+            const Gnss_Block_Counters_Snapshot& a = after[i];
+            unsigned long long calls = a.work_calls - b.work_calls;
+            double busy = static_cast<double>(a.work_ns - b.work_ns) * 1e-9 / seconds;
+            std::ostringstream os;
+            os << std::fixed << std::setprecision(1) << a.name << "(" << a.id << "): " << 100.0 * busy << "% busy, "
+               << std::setprecision(0) << static_cast<double>(calls) / seconds << " calls/s, "
+               << static_cast<double>(a.items_in - b.items_in) / seconds << " items/s in, "
+               << static_cast<double>(a.items_out - b.items_out) / seconds << " items/s out, "
+               << (calls > 0 ? static_cast<double>(a.input_items - b.input_items) / calls : 0.0) << " items waiting, "
+               << a.late_epochs - b.late_epochs << " late, " << a.dropped_epochs - b.dropped_epochs << " dropped";
+            lines.push_back(std::make_pair(busy, os.str()));
+        }
+    std::stable_sort(lines.begin(), lines.end(),
+            [](const std::pair<double, std::string>& x, const std::pair<double, std::string>& y) { return x.first > y.first; });
+    std::vector<std::string> summary;
+    for (unsigned int i = 0; i < lines.size(); i++)
+        {
+            summary.push_back(lines[i].second);
+        }
+    return summary;
+}
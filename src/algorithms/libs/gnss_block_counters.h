@@ -0,0 +1,184 @@
+/*!
+ * \file gnss_block_counters.h
+ * \brief Runtime performance counters of the GNU Radio blocks of the receiver
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_BLOCK_COUNTERS_H_
+#define GNSS_SDR_GNSS_BLOCK_COUNTERS_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <gnuradio/block.h>
+
+/*!
+ * \brief Values of the counters of a block at a given time
+ */
+struct Gnss_Block_Counters_Snapshot
+{
+    std::string name;
+    long id;
+    unsigned long long work_calls;
+    unsigned long long work_ns;          //!< Time spent in work [ns]
+    unsigned long long items_in;         //!< Items consumed from the first input
+    unsigned long long items_out;        //!< Items produced in the first output
+    unsigned long long input_items;      //!< Items waiting at the first input, summed over the work calls
+    unsigned long long input_items_max;  //!< Largest number of items waiting at the first input
+    unsigned long long late_epochs;
+    unsigned long long dropped_epochs;
+};
+
+
+/*!
+ * \brief This class keeps the performance counters of one block.
+ *
+ * The work counters are only updated by the thread running the work of the
+ * block (see Gnss_Work_Timer), without locked instructions, and can be read
+ * at any time from any other thread. Items in and out are read from the
+ * block at the beginning of each call, so they do not include the current
+ * call. Late and dropped epochs can be counted from any thread.
+ */
+class Gnss_Block_Counters
+{
+public:
+    Gnss_Block_Counters(const std::string& name, long id, gr::block* block = nullptr);
+
+    const std::string& name() const { return d_name; }
+    long id() const { return d_id; }
+
+    //! Counts an epoch processed too late to be useful
+    void add_late(unsigned long long epochs = 1) { d_late_epochs.fetch_add(epochs, std::memory_order_relaxed); }
+
+    //! Counts an epoch that was dropped
+    void add_dropped(unsigned long long epochs = 1) { d_dropped_epochs.fetch_add(epochs, std::memory_order_relaxed); }
+
+    //! Sets the number of dropped epochs, for blocks that already count them
+    void set_dropped(unsigned long long epochs) { d_dropped_epochs.store(epochs, std::memory_order_relaxed); }
+
+    Gnss_Block_Counters_Snapshot snapshot() const;
+
+private:
+    friend class Gnss_Work_Timer;
+
+    // single writer: the work thread of the block
+    static inline void add(std::atomic<unsigned long long>& counter, unsigned long long value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::string d_name;
+    long d_id;
+    gr::block* d_block;
+    bool d_inputs;
+    bool d_outputs;
+    std::atomic<unsigned long long> d_work_calls;
+    std::atomic<unsigned long long> d_work_ns;
+    std::atomic<unsigned long long> d_items_in;
+    std::atomic<unsigned long long> d_items_out;
+    std::atomic<unsigned long long> d_input_items;
+    std::atomic<unsigned long long> d_input_items_max;
+    std::atomic<unsigned long long> d_late_epochs;
+    std::atomic<unsigned long long> d_dropped_epochs;
+};
+
+
+/*!
+ * \brief Measures a call to the work function of a block: create one at the
+ * beginning of the function, with the number of items waiting at the first
+ * input (-1 for sources). Does nothing if \p counters is null.
+ */
+class Gnss_Work_Timer
+{
+public:
+    Gnss_Work_Timer(Gnss_Block_Counters* counters, int input_items = -1) : d_counters(counters)
+    {
+        if (d_counters == nullptr) return;
+        d_start = std::chrono::steady_clock::now();
+        if (d_counters->d_block != nullptr)
+            {
+                if (d_counters->d_inputs) d_counters->d_items_in.store(d_counters->d_block->nitems_read(0), std::memory_order_relaxed);
+                if (d_counters->d_outputs) d_counters->d_items_out.store(d_counters->d_block->nitems_written(0), std::memory_order_relaxed);
+            }
+        if (input_items > 0)
+            {
+                Gnss_Block_Counters::add(d_counters->d_input_items, input_items);
+                if (static_cast<unsigned long long>(input_items) > d_counters->d_input_items_max.load(std::memory_order_relaxed))
+                    {
+                        d_counters->d_input_items_max.store(input_items, std::memory_order_relaxed);
+                    }
+            }
+    }
+
+    ~Gnss_Work_Timer()
+    {
+        if (d_counters == nullptr) return;
+        std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - d_start;
+        Gnss_Block_Counters::add(d_counters->d_work_ns, elapsed.count());
+        Gnss_Block_Counters::add(d_counters->d_work_calls, 1);
+    }
+
+private:
+    Gnss_Block_Counters* d_counters;
+    std::chrono::steady_clock::time_point d_start;
+};
+
+
+/*!
+ * \brief Creates the counters of \p block, named after it, and registers
+ * them. Meant to be called from the constructor of the block.
+ */
+std::shared_ptr<Gnss_Block_Counters> gnss_block_counters(gr::block* block);
+
+/*!
+ * \brief Creates and registers counters that are not attached to a block
+ */
+std::shared_ptr<Gnss_Block_Counters> gnss_block_counters(const std::string& name, long id);
+
+/*!
+ * \brief Snapshots of the counters of the blocks that still exist, in the
+ * order they were created
+ */
+std::vector<Gnss_Block_Counters_Snapshot> gnss_block_counters_snapshot();
+
+/*!
+ * \brief Formats \p blocks in the Prometheus text exposition format
+ */
+std::string gnss_block_counters_prometheus(const std::vector<Gnss_Block_Counters_Snapshot>& blocks);
+
+/*!
+ * \brief One line per block with what it did between \p before and
+ * \p after, \p seconds apart: the share of the time spent in work (a block
+ * close to 100% is saturated), the work calls and items per second, the
+ * average number of items waiting at its input and the late and dropped
+ * epochs. The busiest blocks come first.
+ */
+std::vector<std::string> gnss_block_counters_summary(const std::vector<Gnss_Block_Counters_Snapshot>& before,
+        const std::vector<Gnss_Block_Counters_Snapshot>& after, double seconds);
+
+#endif
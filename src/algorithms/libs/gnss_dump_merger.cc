@@ -0,0 +1,156 @@
+/*!
+ * \file gnss_dump_merger.cc
+ * \brief Merges in time order the dump files of consecutive time slices
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_dump_merger.h"
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+Gnss_Dump_Merger::Gnss_Dump_Merger(const std::string& filename, const std::string& time_field)
+{
+    d_filename = filename;
+    d_time_field = time_field;
+    d_files = 0;
+    d_records_in = 0;
+    d_records_out = 0;
+    d_last_time = 0.0;
+    d_last_week = 0;
+}
+
+
+Gnss_Dump_Merger::~Gnss_Dump_Merger()
+{
+    close();
+}
+
+
+bool Gnss_Dump_Merger::add(const std::string& filename)
+{
+    Gnss_Dump_Reader reader;
+    if (reader.open(filename) == false)
+        {
+            return false;
+        }
+    if (d_writer.is_open() == false)
+        {
+            d_fields = reader.fields();
+            std::string suffix = "_" + d_time_field;
+            for (unsigned int i = 0; i < d_fields.size(); i++)
+                {
+                    const std::string& name = d_fields[i].name;
+                    if (name == d_time_field or (name.size() > suffix.size()
+                            and name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0))
+                        {
+                            d_time_fields.push_back(i);
+                        }
+                }
+            if (d_time_fields.empty())
+                {
+                    LOG(WARNING) << filename << " has no " << d_time_field << " field, it cannot be merged";
+                    return false;
+                }
+            for (std::map<std::string, std::string>::const_iterator it = reader.attributes().begin(); it != reader.attributes().end(); ++it)
+                {
+                    d_writer.set_attribute(it->first, it->second);
+                }
+            d_writer.set_attribute("merged_by", d_time_field);
+            for (unsigned int i = 0; i < d_fields.size(); i++)
+                {
+                    d_writer.add_field(d_fields[i]);
+                }
+            if (d_writer.open(d_filename, false) == false)
+                {
+                    LOG(WARNING) << "Unable to create the merged dump file " << d_filename;
+                    return false;
+                }
+        }
+    else
+        {
+            bool same_fields = (reader.fields().size() == d_fields.size());
+            for (unsigned int i = 0; same_fields and i < d_fields.size(); i++)
+                {
+                    same_fields = (reader.fields()[i].name == d_fields[i].name and reader.fields()[i].type == d_fields[i].type
+                            and reader.fields()[i].count == d_fields[i].count);
+                }
+            if (same_fields == false)
+                {
+                    LOG(WARNING) << "The fields of " << filename << " do not match those of " << d_filename;
+                    return false;
+                }
+        }
+
+    unsigned long int kept = 0;
+    while (reader.read_record())
+        {
+            d_records_in++;
+            double time = record_time(reader);
+            if (time <= 0.0) continue;
+            // the time of week restarts at each rollover
+            int week = d_last_week;
+            if (d_last_time > 0.0 and time < d_last_time - GNSS_DUMP_MERGER_WEEK_S / 2.0) week++;
+            if (d_last_time > 0.0 and time > d_last_time + GNSS_DUMP_MERGER_WEEK_S / 2.0) week--;
+            if (week > d_last_week or (week == d_last_week and time > d_last_time))
+                {
+                    d_writer.put(reader.record().data(), reader.record_size());
+                    d_writer.end_record();
+                    d_last_time = time;
+                    d_last_week = week;
+                    kept++;
+                }
+        }
+    d_records_out += kept;
+    d_files++;
+    LOG(INFO) << "Merged " << kept << " of " << reader.records() << " records of " << filename;
+    return true;
+}
+
+
+void Gnss_Dump_Merger::close()
+{
+    if (d_writer.is_open())
+        {
+            d_writer.close();
+        }
+}
+
+
+double Gnss_Dump_Merger::record_time(const Gnss_Dump_Reader& reader) const
+{
+    double time = 0.0;
+    for (unsigned int i = 0; i < d_time_fields.size(); i++)
+        {
+            for (unsigned int k = 0; k < d_fields[d_time_fields[i]].count; k++)
+                {
+                    double value = reader.to_double(d_time_fields[i], k);
+                    if (value > time) time = value;
+                }
+        }
+    return time;
+}
@@ -0,0 +1,92 @@
+/*!
+ * \file gnss_dump_merger.h
+ * \brief Merges in time order the dump files of consecutive time slices
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_DUMP_MERGER_H_
+#define GNSS_SDR_GNSS_DUMP_MERGER_H_
+
+#include <string>
+#include <vector>
+#include "gnss_dump_reader.h"
+#include "gnss_dump_writer.h"
+
+#define GNSS_DUMP_MERGER_WEEK_S 604800.0
+
+/*!
+ * \brief This class merges the dump files written by receivers that
+ * processed consecutive, overlapping time slices of one capture.
+ *
+ * Slices are added in capture order. A record is kept only if its time is
+ * later than the time of the last record kept, so the output is in time
+ * order and the records of a slice that fall in its overlap with the
+ * previous one are dropped: there, the previous receiver had already
+ * converged. Records without a time (0) are dropped too. Times are GPS
+ * times of week: they are compared by (week, time), a time more than half
+ * a week before the last one kept being in the next week. The time of a
+ * record is the largest value of the fields called \p time_field or ending
+ * in "_" + \p time_field, so that per-channel times (ch0_rx_time_s,
+ * ch1_rx_time_s...) can be used. All the files must have the same fields.
+ */
+class Gnss_Dump_Merger
+{
+public:
+    Gnss_Dump_Merger(const std::string& filename, const std::string& time_field);
+    ~Gnss_Dump_Merger();
+
+    /*!
+     * \brief Appends the records of the next slice. The output file is
+     * created with the header of the first slice. Returns false if the file
+     * cannot be read or its fields do not match.
+     */
+    bool add(const std::string& filename);
+
+    //! Closes the output file
+    void close();
+
+    unsigned int files() const { return d_files; }                    //!< Slices merged
+    unsigned long int records_in() const { return d_records_in; }     //!< Records read from the slices
+    unsigned long int records_out() const { return d_records_out; }   //!< Records written
+    double last_time() const { return d_last_time; }                  //!< Time of the last record written
+    int last_week() const { return d_last_week; }                     //!< Weeks since the first record written
+
+private:
+    double record_time(const Gnss_Dump_Reader& reader) const;
+
+    std::string d_filename;
+    std::string d_time_field;
+    Gnss_Dump_Writer d_writer;
+    std::vector<Gnss_Dump_Field> d_fields;
+    std::vector<int> d_time_fields;
+    unsigned int d_files;
+    unsigned long int d_records_in;
+    unsigned long int d_records_out;
+    double d_last_time;
+    int d_last_week;
+};
+
+#endif
@@ -0,0 +1,210 @@
+/*!
+ * \file gnss_dump_reader.cc
+ * \brief Reader of the binary dump files written by Gnss_Dump_Writer
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_dump_reader.h"
+#include <cstdint>
+#include <sstream>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+namespace
+{
+// size in bytes of a dump type, 0 if the type is not known
+unsigned int dump_type_size(const std::string& type)
+{
+    const char* names[] = {"int8", "uint8", "int16", "uint16", "int32", "uint32", "int64", "uint64", "float32", "float64"};
+    const unsigned int sizes[] = {1, 1, 2, 2, 4, 4, 8, 8, 4, 8};
+    for (unsigned int i = 0; i < 10; i++)
+        {
+            if (type == names[i]) return sizes[i];
+        }
+    return 0;
+}
+}
+
+
+Gnss_Dump_Reader::Gnss_Dump_Reader()
+{
+    d_record_size = 0;
+    d_data_offset = 0;
+    d_records = 0;
+}
+
+
+bool Gnss_Dump_Reader::open(const std::string& filename)
+{
+    close();
+    d_file.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if (d_file.is_open() == false)
+        {
+            LOG(WARNING) << "Unable to open dump file " << filename;
+            return false;
+        }
+    std::string line;
+    std::getline(d_file, line);
+    std::ostringstream magic;
+    magic << GNSS_DUMP_MAGIC << " " << GNSS_DUMP_VERSION;
+    if (line != magic.str())
+        {
+            LOG(WARNING) << filename << " is not a GNSS-SDR dump file";
+            close();
+            return false;
+        }
+    bool complete = false;
+    unsigned int declared_size = 0;
+    while (std::getline(d_file, line))
+        {
+            if (line == GNSS_DUMP_END_HEADER)
+                {
+                    complete = true;
+                    break;
+                }
+            std::istringstream is(line);
+            std::string key;
+            is >> key;
+            if (key == "field")
+                {
+                    Gnss_Dump_Field field;
+                    is >> field.name >> field.type >> field.count;
+                    field.size = dump_type_size(field.type);
+                    if (is.fail() or field.size == 0)
+                        {
+                            LOG(WARNING) << filename << ": invalid field \"" << line << "\"";
+                            close();
+                            return false;
+                        }
+                    field.offset = d_record_size;
+                    d_record_size += field.size * field.count;
+                    d_fields.push_back(field);
+                }
+            else if (key == "record_size")
+                {
+                    is >> declared_size;
+                }
+            else
+                {
+                    std::string value;
+                    std::getline(is >> std::ws, value);
+                    d_attributes[key] = value;
+                }
+        }
+    if (complete == false or d_record_size == 0 or d_record_size != declared_size)
+        {
+            LOG(WARNING) << filename << ": invalid dump header";
+            close();
+            return false;
+        }
+    d_data_offset = d_file.tellg();
+    d_file.seekg(0, std::ios::end);
+    d_records = static_cast<unsigned long int>(d_file.tellg() - d_data_offset) / d_record_size;
+    d_file.seekg(d_data_offset);
+    d_record.resize(d_record_size);
+    return true;
+}
+
+
+void Gnss_Dump_Reader::close()
+{
+    if (d_file.is_open())
+        {
+            d_file.close();
+        }
+    d_file.clear();
+    d_fields.clear();
+    d_attributes.clear();
+    d_record_size = 0;
+    d_data_offset = 0;
+    d_records = 0;
+    d_record.clear();
+}
+
+
+bool Gnss_Dump_Reader::read_record()
+{
+    if (d_record_size == 0)
+        {
+            return false;
+        }
+    d_file.read(d_record.data(), d_record_size);
+    return d_file.gcount() == static_cast<std::streamsize>(d_record_size);
+}
+
+
+bool Gnss_Dump_Reader::seek_record(unsigned long int index)
+{
+    if (index >= d_records)
+        {
+            return false;
+        }
+    d_file.clear();
+    d_file.seekg(d_data_offset + static_cast<std::streamoff>(index) * d_record_size);
+    return d_file.good();
+}
+
+
+int Gnss_Dump_Reader::field_index(const std::string& name) const
+{
+    for (unsigned int i = 0; i < d_fields.size(); i++)
+        {
+            if (d_fields[i].name == name) return i;
+        }
+    return -1;
+}
+
+
+std::string Gnss_Dump_Reader::attribute(const std::string& key) const
+{
+    std::map<std::string, std::string>::const_iterator it = d_attributes.find(key);
+    if (it == d_attributes.end())
+        {
+            return std::string();
+        }
+    return it->second;
+}
+
+
+double Gnss_Dump_Reader::to_double(int index, unsigned int element) const
+{
+    if (index < 0 or index >= static_cast<int>(d_fields.size()))
+        {
+            return 0.0;
+        }
+    const std::string& type = d_fields[index].type;
+    if (type == "float64") return value<double>(index, element);
+    if (type == "float32") return value<float>(index, element);
+    if (type == "int8") return value<int8_t>(index, element);
+    if (type == "uint8") return value<uint8_t>(index, element);
+    if (type == "int16") return value<int16_t>(index, element);
+    if (type == "uint16") return value<uint16_t>(index, element);
+    if (type == "int32") return value<int32_t>(index, element);
+    if (type == "uint32") return value<uint32_t>(index, element);
+    if (type == "int64") return static_cast<double>(value<int64_t>(index, element));
+    return static_cast<double>(value<uint64_t>(index, element));
+}
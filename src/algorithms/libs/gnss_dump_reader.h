@@ -0,0 +1,109 @@
+/*!
+ * \file gnss_dump_reader.h
+ * \brief Reader of the binary dump files written by Gnss_Dump_Writer
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_DUMP_READER_H_
+#define GNSS_SDR_GNSS_DUMP_READER_H_
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "gnss_dump_writer.h"
+
+/*!
+ * \brief This class reads the header and the records of a dump file
+ * written by Gnss_Dump_Writer.
+ *
+ * Fields are looked up once by name with field_index(); the values of the
+ * current record are then read with value<T>(index, element), or as a
+ * double whatever their type with to_double(). The same files can be read
+ * in Python with src/utils/python/gnss_sdr_dump.py and in MATLAB / Octave
+ * with src/utils/matlab/libs/read_gnss_sdr_dump.m.
+ */
+class Gnss_Dump_Reader
+{
+public:
+    Gnss_Dump_Reader();
+
+    /*!
+     * \brief Opens the file and parses its header. Returns false if it is not
+     * a dump file or the header is not valid.
+     */
+    bool open(const std::string& filename);
+    void close();
+
+    /*!
+     * \brief Reads the next record. Returns false at the end of the file
+     */
+    bool read_record();
+
+    /*!
+     * \brief Moves to record \p index (0 is the first record)
+     */
+    bool seek_record(unsigned long int index);
+
+    //! Index of the field called \p name, or -1 if there is no such field
+    int field_index(const std::string& name) const;
+
+    //! Value of the attribute \p key of the header, or an empty string
+    std::string attribute(const std::string& key) const;
+
+    //! Value \p element of the field \p index in the current record
+    template<typename T>
+    T value(int index, unsigned int element = 0) const
+    {
+        T v = T();
+        if (index < 0 or index >= static_cast<int>(d_fields.size())) return v;
+        const Gnss_Dump_Field& field = d_fields[index];
+        if (sizeof(T) != field.size or element >= field.count) return v;
+        std::memcpy(&v, &d_record[field.offset + element * field.size], sizeof(T));
+        return v;
+    }
+
+    //! Value \p element of the field \p index in the current record, converted to double
+    double to_double(int index, unsigned int element = 0) const;
+
+    const std::vector<Gnss_Dump_Field>& fields() const { return d_fields; }
+    const std::map<std::string, std::string>& attributes() const { return d_attributes; }
+    unsigned int record_size() const { return d_record_size; }
+    unsigned long int records() const { return d_records; }            //!< Number of complete records in the file
+    const std::vector<char>& record() const { return d_record; }     //!< Raw bytes of the current record
+
+private:
+    std::ifstream d_file;
+    std::vector<Gnss_Dump_Field> d_fields;
+    std::map<std::string, std::string> d_attributes;
+    unsigned int d_record_size;
+    std::streamoff d_data_offset;
+    unsigned long int d_records;
+    std::vector<char> d_record;
+};
+
+#endif
@@ -0,0 +1,357 @@
+/*!
+ * \file gnss_dump_writer.cc
+ * \brief Buffered writer of the binary dump files, with a header that
+ * describes the layout of the records
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_dump_writer.h"
+#include <deque>
+#include <functional>
+#include <boost/thread/thread.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+DEFINE_bool(dump_background, true, "Write the dump files from a background thread");
+
+
+/*!
+ * \brief Thread shared by all the dump files opened in background mode. It
+ * exists while at least one of them is open.
+ */
+class Gnss_Dump_Thread
+{
+public:
+    static std::shared_ptr<Gnss_Dump_Thread> instance()
+    {
+        static boost::mutex instance_mutex;
+        static std::weak_ptr<Gnss_Dump_Thread> current;
+        boost::mutex::scoped_lock lock(instance_mutex);
+        std::shared_ptr<Gnss_Dump_Thread> thread = current.lock();
+        if (!thread)
+            {
+                thread = std::make_shared<Gnss_Dump_Thread>();
+                current = thread;
+            }
+        return thread;
+    }
+
+    Gnss_Dump_Thread()
+    {
+        d_stop = false;
+        d_thread = boost::thread(&Gnss_Dump_Thread::run, this);
+    }
+
+    ~Gnss_Dump_Thread()
+    {
+        {
+            boost::mutex::scoped_lock lock(d_mutex);
+            d_stop = true;
+        }
+        d_cond.notify_one();
+        d_thread.join();
+    }
+
+    void post(const std::function<void()>& job)
+    {
+        {
+            boost::mutex::scoped_lock lock(d_mutex);
+            d_jobs.push_back(job);
+        }
+        d_cond.notify_one();
+    }
+
+private:
+    void run()
+    {
+        while (true)
+            {
+                std::function<void()> job;
+                {
+                    boost::mutex::scoped_lock lock(d_mutex);
+                    while (d_jobs.empty() and (d_stop == false))
+                        {
+                            d_cond.wait(lock);
+                        }
+                    if (d_jobs.empty())
+                        {
+                            return;
+                        }
+                    job.swap(d_jobs.front());
+                    d_jobs.pop_front();
+                }
+                job();
+            }
+    }
+
+    std::deque<std::function<void()> > d_jobs;
+    bool d_stop;
+    boost::mutex d_mutex;
+    boost::condition_variable d_cond;
+    boost::thread d_thread;
+};
+
+
+
+Gnss_Dump_Writer::Gnss_Dump_Writer()
+{
+    d_record_size = 0;
+    d_open = false;
+    d_failed = false;
+    d_size_warning = false;
+    d_data = nullptr;
+    d_used = GNSS_DUMP_BLOCK_SIZE;
+    d_record_bytes = 0;
+    d_records = 0;
+    d_waits = 0;
+    d_pending_blocks = 0;
+}
+
+
+Gnss_Dump_Writer::~Gnss_Dump_Writer()
+{
+    close();
+}
+
+
+void Gnss_Dump_Writer::add_field(const std::string& name, const std::string& type, unsigned int size, unsigned int count)
+{
+    if (d_open == true)
+        {
+            LOG(WARNING) << "Dump field " << name << " added after opening " << d_filename << ", ignored";
+            return;
+        }
+    Gnss_Dump_Field field;
+    field.name = name;
+    field.type = type;
+    field.size = size;
+    field.count = count;
+    field.offset = d_record_size;
+    d_fields.push_back(field);
+    d_record_size += size * count;
+}
+
+
+bool Gnss_Dump_Writer::open(const std::string& filename)
+{
+    return open(filename, FLAGS_dump_background);
+}
+
+
+bool Gnss_Dump_Writer::open(const std::string& filename, bool background)
+{
+    close();
+    d_filename = filename;
+    d_file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (d_file.is_open() == false)
+        {
+            LOG(WARNING) << "Unable to open dump file " << filename;
+            return false;
+        }
+    std::ostringstream header;
+    header << GNSS_DUMP_MAGIC << " " << GNSS_DUMP_VERSION << "\n";
+    header << "record_size " << d_record_size << "\n";
+    for (unsigned int i = 0; i < d_attributes.size(); i++)
+        {
+            header << d_attributes.at(i).first << " " << d_attributes.at(i).second << "\n";
+        }
+    for (unsigned int i = 0; i < d_fields.size(); i++)
+        {
+            header << "field " << d_fields.at(i).name << " " << d_fields.at(i).type << " " << d_fields.at(i).count << "\n";
+        }
+    header << GNSS_DUMP_END_HEADER << "\n";
+    std::string text = header.str();
+    d_file.write(text.c_str(), text.length());
+    if (d_file.good() == false)
+        {
+            LOG(WARNING) << "Unable to write the header of dump file " << filename;
+            d_file.close();
+            return false;
+        }
+
+    d_block = std::make_shared<std::vector<char> >(GNSS_DUMP_BLOCK_SIZE);
+    d_data = d_block->data();
+    d_used = 0;
+    d_record_bytes = 0;
+    d_records = 0;
+    d_waits = 0;
+    d_failed = false;
+    d_size_warning = false;
+    if (background == true)
+        {
+            d_thread = Gnss_Dump_Thread::instance();
+        }
+    d_open = true;
+    return true;
+}
+
+
+void Gnss_Dump_Writer::end_record()
+{
+    if (d_open == false)
+        {
+            return;
+        }
+    if ((d_record_bytes != d_record_size) and (d_size_warning == false))
+        {
+            LOG(WARNING) << "Dump file " << d_filename << ": record of " << d_record_bytes
+                         << " bytes, the header declares " << d_record_size;
+            d_size_warning = true;
+        }
+    d_record_bytes = 0;
+    d_records++;
+}
+
+
+void Gnss_Dump_Writer::put_bytes(const void* data, std::size_t length)
+{
+    if (d_open == false)
+        {
+            return;
+        }
+    const char* bytes = static_cast<const char*>(data);
+    d_record_bytes += length;
+    while (length > 0)
+        {
+            if (d_used == GNSS_DUMP_BLOCK_SIZE)
+                {
+                    send_block();
+                }
+            std::size_t n = length;
+            if (n > GNSS_DUMP_BLOCK_SIZE - d_used) n = GNSS_DUMP_BLOCK_SIZE - d_used;
+            std::memcpy(d_data + d_used, bytes, n);
+            d_used += n;
+            bytes += n;
+            length -= n;
+        }
+}
+
+
+void Gnss_Dump_Writer::send_block()
+{
+    if (d_used == 0)
+        {
+            return;
+        }
+    if (!d_thread)
+        {
+            write_block(d_block, d_used);
+            d_used = 0;
+            return;
+        }
+    std::shared_ptr<std::vector<char> > block = d_block;
+    std::size_t length = d_used;
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        if (d_pending_blocks >= GNSS_DUMP_MAX_BLOCKS)
+            {
+                d_waits++;
+                while (d_pending_blocks >= GNSS_DUMP_MAX_BLOCKS)
+                    {
+                        d_cond.wait(lock);
+                    }
+            }
+        d_pending_blocks++;
+        if (d_free_blocks.empty())
+            {
+                d_block = std::make_shared<std::vector<char> >(GNSS_DUMP_BLOCK_SIZE);
+            }
+        else
+            {
+                d_block = d_free_blocks.back();
+                d_free_blocks.pop_back();
+            }
+    }
+    d_data = d_block->data();
+    d_used = 0;
+    d_thread->post([this, block, length]()
+            {
+                write_block(block, length);
+                // notified under the lock: once the count is down, the writer may be destroyed by flush() and close()
+                boost::mutex::scoped_lock lock(d_mutex);
+                d_free_blocks.push_back(block);
+                d_pending_blocks--;
+                d_cond.notify_all();
+            });
+}
+
+
+void Gnss_Dump_Writer::write_block(std::shared_ptr<std::vector<char> > block, std::size_t length)
+{
+    if (d_failed == true)
+        {
+            return;
+        }
+    d_file.write(block->data(), length);
+    if (d_file.good() == false)
+        {
+            LOG(WARNING) << "Error writing dump file " << d_filename << ", the following records are lost";
+            d_failed = true;
+        }
+}
+
+
+void Gnss_Dump_Writer::flush()
+{
+    if (d_open == false)
+        {
+            return;
+        }
+    send_block();
+    if (d_thread)
+        {
+            boost::mutex::scoped_lock lock(d_mutex);
+            while (d_pending_blocks > 0)
+                {
+                    d_cond.wait(lock);
+                }
+        }
+    d_file.flush();
+}
+
+
+void Gnss_Dump_Writer::close()
+{
+    if (d_open == false)
+        {
+            return;
+        }
+    flush();
+    d_open = false;
+    d_thread.reset();
+    d_free_blocks.clear();
+    d_block.reset();
+    d_data = nullptr;
+    d_used = GNSS_DUMP_BLOCK_SIZE;
+    d_file.close();
+    if (d_waits > 0)
+        {
+            LOG(INFO) << "Dump file " << d_filename << ": " << d_records << " records, "
+                      << d_waits << " blocks waited for the background writer";
+        }
+}
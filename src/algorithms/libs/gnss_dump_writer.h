@@ -0,0 +1,226 @@
+/*!
+ * \file gnss_dump_writer.h
+ * \brief Buffered writer of the binary dump files, with a header that
+ * describes the layout of the records
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_DUMP_WRITER_H_
+#define GNSS_SDR_GNSS_DUMP_WRITER_H_
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#define GNSS_DUMP_MAGIC "GNSS-SDR dump"
+#define GNSS_DUMP_VERSION 1
+#define GNSS_DUMP_END_HEADER "end_header"
+#define GNSS_DUMP_BLOCK_SIZE 65536   // bytes handed to the file at once
+#define GNSS_DUMP_MAX_BLOCKS 8       // blocks of one file waiting in the background thread
+
+class Gnss_Dump_Thread;
+
+/*!
+ * \brief Description of one field of the dump records
+ */
+struct Gnss_Dump_Field
+{
+    std::string name;
+    std::string type;      //!< int8, uint8, ..., int64, uint64, float32 or float64
+    unsigned int size;     //!< Size of one element [bytes]
+    unsigned int count;    //!< Number of consecutive elements
+    unsigned int offset;   //!< Offset of the first element in the record [bytes]
+};
+
+/*!
+ * \brief Name of the dump type of \p T, e.g. "float32" for float
+ */
+template<typename T>
+std::string gnss_dump_type()
+{
+    static_assert(std::is_arithmetic<T>::value, "dump fields must be of an arithmetic type");
+    std::string name = std::is_floating_point<T>::value ? "float" : (std::is_signed<T>::value ? "int" : "uint");
+    return name + std::to_string(sizeof(T) * 8);
+}
+
+/*!
+ * \brief This class writes a binary dump file made of a text header and
+ * fixed-size records.
+ *
+ * The header is a list of "key value" lines: the magic "GNSS-SDR dump 1",
+ * the record size, free attributes (source block, channel, sample rate...)
+ * and one "field name type count" line per field, in the order of the
+ * record. It ends with a line "end_header", right after which the records
+ * start. Values are stored in the native (little endian) byte order.
+ *
+ * put() only copies the values to a 64 KB block. Full blocks are written
+ * by the calling thread or, in background mode, handed to a writer thread
+ * shared by all the dump files, so that the signal processing threads do
+ * not wait for the disk. The writer keeps at most GNSS_DUMP_MAX_BLOCKS
+ * blocks in the queue and waits for room beyond that: dumps are never
+ * dropped.
+ */
+class Gnss_Dump_Writer
+{
+public:
+    Gnss_Dump_Writer();
+    ~Gnss_Dump_Writer();
+
+    /*!
+     * \brief Adds a "key value" line to the header. Must be called before open()
+     */
+    template<typename T>
+    void set_attribute(const std::string& key, const T& value)
+    {
+        std::ostringstream os;
+        os.precision(15);
+        os << value;
+        d_attributes.push_back(std::make_pair(key, os.str()));
+    }
+
+    /*!
+     * \brief Appends a field of \p count values of type T to the record. Must
+     * be called before open()
+     */
+    template<typename T>
+    void add_field(const std::string& name, unsigned int count = 1)
+    {
+        add_field(name, gnss_dump_type<T>(), sizeof(T), count);
+    }
+
+    /*!
+     * \brief Appends a field described by \p field (e.g. read from another
+     * dump file) to the record. Must be called before open()
+     */
+    void add_field(const Gnss_Dump_Field& field)
+    {
+        add_field(field.name, field.type, field.size, field.count);
+    }
+
+    /*!
+     * \brief Creates the file and writes the header. Blocks are written in
+     * the background thread if the dump_background flag is set.
+     */
+    bool open(const std::string& filename);
+
+    /*!
+     * \brief Creates the file and writes the header
+     */
+    bool open(const std::string& filename, bool background);
+
+    bool is_open() const
+    {
+        return d_open;
+    }
+
+    //! Appends a value to the current record
+    template<typename T>
+    inline void put(const T& value)
+    {
+        static_assert(std::is_arithmetic<T>::value, "dump fields must be of an arithmetic type");
+        if (d_used + sizeof(T) <= GNSS_DUMP_BLOCK_SIZE)
+            {
+                std::memcpy(d_data + d_used, &value, sizeof(T));
+                d_used += sizeof(T);
+                d_record_bytes += sizeof(T);
+            }
+        else
+            {
+                put_bytes(&value, sizeof(T));
+            }
+    }
+
+    //! Appends \p count values to the current record
+    template<typename T>
+    inline void put(const T* values, unsigned int count)
+    {
+        static_assert(std::is_arithmetic<T>::value, "dump fields must be of an arithmetic type");
+        put_bytes(values, sizeof(T) * count);
+    }
+
+    /*!
+     * \brief Ends the current record. A warning is logged once if its size
+     * does not match the fields declared in the header.
+     */
+    void end_record();
+
+    /*!
+     * \brief Writes the buffered records to the file and waits for the
+     * background thread to write them
+     */
+    void flush();
+
+    /*!
+     * \brief Writes the buffered records and closes the file
+     */
+    void close();
+
+    unsigned int record_size() const { return d_record_size; }       //!< Size of a record [bytes]
+    unsigned long int records() const { return d_records; }          //!< Number of records written
+    unsigned long int waits() const { return d_waits; }              //!< Number of blocks that waited for room in the background queue
+    const std::vector<Gnss_Dump_Field>& fields() const { return d_fields; }
+
+private:
+    friend class Gnss_Dump_Thread;
+
+    void add_field(const std::string& name, const std::string& type, unsigned int size, unsigned int count);
+    void send_block();
+    void write_block(std::shared_ptr<std::vector<char> > block, std::size_t length);
+
+    void put_bytes(const void* data, std::size_t length);
+
+    std::vector<std::pair<std::string, std::string> > d_attributes;
+    std::vector<Gnss_Dump_Field> d_fields;
+    unsigned int d_record_size;
+    std::string d_filename;
+    std::ofstream d_file;
+    bool d_open;
+    bool d_failed;
+    bool d_size_warning;
+
+    std::shared_ptr<std::vector<char> > d_block;   // block being filled
+    char* d_data;                                  // d_block->data()
+    std::size_t d_used;                            // GNSS_DUMP_BLOCK_SIZE while closed, so that put() takes the slow path
+    std::size_t d_record_bytes;
+    unsigned long int d_records;
+    unsigned long int d_waits;
+
+    // background mode
+    std::shared_ptr<Gnss_Dump_Thread> d_thread;
+    std::vector<std::shared_ptr<std::vector<char> > > d_free_blocks;
+    unsigned int d_pending_blocks;
+    boost::mutex d_mutex;
+    boost::condition_variable d_cond;
+};
+
+#endif
@@ -0,0 +1,185 @@
+/*!
+ * \file gnss_event_loop.cc
+ * \brief Single thread that runs the events of the receiver control plane
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_event_loop.h"
+#include <atomic>
+#include <exception>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+Gnss_Event_Loop::Gnss_Event_Loop(unsigned int batch)
+{
+    d_batch = batch > 0 ? batch : 1;
+    d_sleeping.store(false);
+    d_stop.store(false);
+    d_running.store(false);
+    d_processed.store(0);
+    d_wakeups.store(0);
+}
+
+
+Gnss_Event_Loop::~Gnss_Event_Loop()
+{
+    stop();
+}
+
+
+void Gnss_Event_Loop::start()
+{
+    boost::mutex::scoped_lock lock(d_start_mutex);
+    if (d_running.load()) return;
+    d_stop.store(false);
+    d_running.store(true);
+    d_thread = boost::thread(&Gnss_Event_Loop::run, this);
+}
+
+
+void Gnss_Event_Loop::stop()
+{
+    boost::mutex::scoped_lock lock(d_start_mutex);
+    if (not d_running.load()) return;
+    if (in_loop_thread())
+        {
+            LOG(WARNING) << "The event loop cannot be stopped from one of its events";
+            return;
+        }
+    d_stop.store(true);
+    {
+            boost::mutex::scoped_lock sleep_lock(d_mutex);
+            d_sleeping.store(false);
+    }
+    d_condition.notify_one();
+    d_thread.join();
+    d_running.store(false);
+}
+
+
+// Posted by flush(): shared, since a loop stopped meanwhile may run it only after flush() gave up
+struct Gnss_Flush_Mark
+{
+    boost::mutex mutex;
+    boost::condition_variable condition;
+    bool done = false;
+};
+
+
+static void flush_mark(boost::shared_ptr<Gnss_Flush_Mark> mark)
+{
+    boost::mutex::scoped_lock lock(mark->mutex);
+    mark->done = true;
+    mark->condition.notify_one();
+}
+
+
+void Gnss_Event_Loop::flush()
+{
+    if (not d_running.load() or in_loop_thread()) return;
+    boost::shared_ptr<Gnss_Flush_Mark> mark(new Gnss_Flush_Mark);
+    post(boost::bind(&flush_mark, mark));
+    boost::mutex::scoped_lock lock(mark->mutex);
+    while (not mark->done and d_running.load())
+        {
+            mark->condition.timed_wait(lock, boost::posix_time::milliseconds(100));
+        }
+}
+
+
+void Gnss_Event_Loop::post(const boost::function<void()>& event)
+{
+    d_events.push(event);
+    // the loop announces that it sleeps before its last look at the queue,
+    // so either it sees this event or this sees it sleeping. The push ends
+    // with a release store, which alone could be seen after the load below:
+    // this fence and the one in run() order them
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (d_sleeping.load())
+        {
+            boost::mutex::scoped_lock lock(d_mutex);
+            d_sleeping.store(false);
+            d_condition.notify_one();
+        }
+}
+
+
+unsigned int Gnss_Event_Loop::run_batch()
+{
+    boost::function<void()> event;
+    unsigned int events = 0;
+    while (events < d_batch and d_events.try_pop(event))
+        {
+            try
+            {
+                    event();
+            }
+            catch (std::exception& e)
+            {
+                    LOG(ERROR) << "Control plane event failed: " << e.what();
+            }
+            events++;
+        }
+    d_processed.fetch_add(events);
+    return events;
+}
+
+
+void Gnss_Event_Loop::run()
+{
+    while (true)
+        {
+            if (run_batch() > 0) continue;
+            boost::mutex::scoped_lock lock(d_mutex);
+            d_sleeping.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);   // see post()
+            if (not d_events.empty())
+                {
+                    d_sleeping.store(false);
+                    continue;
+                }
+            if (d_stop.load())
+                {
+                    d_sleeping.store(false);
+                    break;
+                }
+            while (d_sleeping.load())
+                {
+                    d_condition.wait(lock);
+                }
+            d_wakeups.fetch_add(1);
+        }
+    DLOG(INFO) << "Event loop stopped after " << d_processed.load() << " events";
+}
+
+
+Gnss_Event_Loop& gnss_event_loop()
+{
+    static Gnss_Event_Loop loop;
+    return loop;
+}
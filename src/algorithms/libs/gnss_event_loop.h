@@ -0,0 +1,124 @@
+/*!
+ * \file gnss_event_loop.h
+ * \brief Single thread that runs the events of the receiver control plane
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_EVENT_LOOP_H_
+#define GNSS_SDR_GNSS_EVENT_LOOP_H_
+
+#include <atomic>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+#include "concurrent_queue.h"
+#include "mpsc_queue.h"
+
+
+/*!
+ * \brief This class runs the events posted by any thread, one after the
+ * other, in a single thread.
+ *
+ * Posting is lock-free (see mpsc_queue), so a signal processing thread
+ * never waits for the control plane. The loop thread takes the events in
+ * batches and only sleeps when there is nothing left, and posters wake it
+ * up only then. Events posted by one thread run in the order they were
+ * posted.
+ *
+ * The navigation data queues and the channel queues are attached to the
+ * loop, so that what is pushed to them becomes an event handled here,
+ * instead of by a thread waiting on each queue.
+ */
+class Gnss_Event_Loop
+{
+public:
+    //! \p batch is the largest number of events run between two checks of the stop request
+    explicit Gnss_Event_Loop(unsigned int batch = 64);
+
+    //! Stops the loop
+    ~Gnss_Event_Loop();
+
+    //! Starts the loop thread, if it is not running. The events posted before run then.
+    void start();
+
+    /*!
+     * \brief Runs the events posted before the call, then the loop thread
+     * ends. The events posted after it wait for the next start().
+     */
+    void stop();
+
+    //! Waits until the events posted before the call have run. Returns at once if the loop is not running, or if called from an event.
+    void flush();
+
+    //! Runs \p event in the loop thread. Any thread, never blocks.
+    void post(const boost::function<void()>& event);
+
+    //! Every item pushed to \p queue becomes an event, handled by \p handler
+    template<typename Data>
+    void attach(concurrent_queue<Data>& queue, boost::function<void(Data const&)> handler)
+    {
+        queue.set_listener(boost::bind(&Gnss_Event_Loop::post_item<Data>, this, handler, _1));
+    }
+
+    //! The items pushed to \p queue are queued again. Those already posted still run.
+    template<typename Data>
+    void detach(concurrent_queue<Data>& queue)
+    {
+        queue.set_listener(boost::function<void(Data const&)>());
+    }
+
+    bool running() const { return d_running.load(); }
+    bool in_loop_thread() const { return boost::this_thread::get_id() == d_thread.get_id(); }
+    unsigned long long processed() const { return d_processed.load(); }   //!< Events run so far
+    unsigned long long wakeups() const { return d_wakeups.load(); }       //!< Times the loop thread was woken up
+
+private:
+    template<typename Data>
+    void post_item(const boost::function<void(Data const&)>& handler, Data const& data)
+    {
+        post(boost::bind(handler, data));
+    }
+
+    void run();
+    unsigned int run_batch();
+
+    mpsc_queue<boost::function<void()> > d_events;
+    unsigned int d_batch;
+    boost::thread d_thread;
+    boost::mutex d_start_mutex;               // start() and stop()
+    boost::mutex d_mutex;                     // only to sleep and to wake up
+    boost::condition_variable d_condition;
+    std::atomic<bool> d_sleeping;
+    std::atomic<bool> d_stop;
+    std::atomic<bool> d_running;
+    std::atomic<unsigned long long> d_processed;
+    std::atomic<unsigned long long> d_wakeups;
+};
+
+//! Event loop of the receiver control plane
+Gnss_Event_Loop& gnss_event_loop();
+
+#endif
@@ -0,0 +1,362 @@
+/*!
+ * \file gnss_latency.cc
+ * \brief Wall-clock arrival time of the samples and latency histograms of
+ * the receiver stages
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include "gnss_latency.h"
+#include <iomanip>
+#include <sstream>
+#include <boost/thread/mutex.hpp>
+
+namespace
+{
+const double latency_bounds_s[GNSS_LATENCY_BUCKETS] = {
+        0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+        0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+
+boost::mutex registry_mutex;
+std::vector<std::shared_ptr<Gnss_Latency_Histogram> > registry;   // guarded by registry_mutex
+
+std::atomic<long long> late_threshold_ns(static_cast<long long>(GNSS_LATENCY_LATE_S * 1e9));
+
+// upper bound of the bucket where the fraction q of the latencies is reached [s]
+double latency_quantile_s(const unsigned long long* counts, unsigned long long count, double q)
+{
+    unsigned long long target = static_cast<unsigned long long>(q * static_cast<double>(count) + 0.5);
+    unsigned long long cumulative = 0;
+    for (unsigned int i = 0; i < GNSS_LATENCY_BUCKETS; i++)
+        {
+            cumulative += counts[i];
+            if (cumulative >= target and cumulative > 0) return latency_bounds_s[i];
+        }
+    return latency_bounds_s[GNSS_LATENCY_BUCKETS - 1];   // beyond the last bound
+}
+}
+
+
+Gnss_Sample_Clock::Gnss_Sample_Clock()
+{
+    reset();
+}
+
+
+void Gnss_Sample_Clock::reset()
+{
+    d_count.store(0);
+    for (unsigned int i = 0; i < GNSS_SAMPLE_CLOCK_STAMPS; i++)
+        {
+            d_stamps[i].samples.store(0, std::memory_order_relaxed);
+            d_stamps[i].ns.store(0, std::memory_order_relaxed);
+        }
+}
+
+
+void Gnss_Sample_Clock::record(unsigned long long samples, long long ns)
+{
+    unsigned long long count = d_count.load(std::memory_order_relaxed);
+    Stamp& stamp = d_stamps[count % GNSS_SAMPLE_CLOCK_STAMPS];
+    stamp.ns.store(ns, std::memory_order_relaxed);
+    stamp.samples.store(samples, std::memory_order_relaxed);
+    d_count.store(count + 1, std::memory_order_release);
+}
+
+
+long long Gnss_Sample_Clock::arrival_ns(unsigned long long sample) const
+{
+    unsigned long long count = d_count.load(std::memory_order_acquire);
+    if (count == 0) return 0;
+    // the oldest slot may be being overwritten: it is left out
+    unsigned long long first = (count > GNSS_SAMPLE_CLOCK_STAMPS - 1) ? count - (GNSS_SAMPLE_CLOCK_STAMPS - 1) : 0;
+    unsigned long long last = count - 1;
+    if (d_stamps[last % GNSS_SAMPLE_CLOCK_STAMPS].samples.load(std::memory_order_relaxed) <= sample) return 0;   // not stamped yet
+    if (d_stamps[first % GNSS_SAMPLE_CLOCK_STAMPS].samples.load(std::memory_order_relaxed) <= sample)
+        {
+            // first stamp past the sample: the samples grow with the stamps
+            while (last - first > 1)
+                {
+                    unsigned long long middle = first + (last - first) / 2;
+                    if (d_stamps[middle % GNSS_SAMPLE_CLOCK_STAMPS].samples.load(std::memory_order_relaxed) > sample)
+                        {
+                            last = middle;
+                        }
+                    else
+                        {
+                            first = middle;
+                        }
+                }
+        }
+    else if (first > 0)
+        {
+            return 0;   // older than the stamps kept
+        }
+    else
+        {
+            last = first;
+        }
+    return d_stamps[last % GNSS_SAMPLE_CLOCK_STAMPS].ns.load(std::memory_order_relaxed);
+}
+
+
+bool Gnss_Sample_Clock::latest(unsigned long long& samples, long long& ns) const
+{
+    unsigned long long count = d_count.load(std::memory_order_acquire);
+    if (count == 0) return false;
+    const Stamp& stamp = d_stamps[(count - 1) % GNSS_SAMPLE_CLOCK_STAMPS];
+    samples = stamp.samples.load(std::memory_order_relaxed);
+    ns = stamp.ns.load(std::memory_order_relaxed);
+    return true;
+}
+
+
+Gnss_Sample_Clock& gnss_sample_clock()
+{
+    static Gnss_Sample_Clock clock;
+    return clock;
+}
+
+
+Gnss_Channel_Progress::Gnss_Channel_Progress()
+{
+    reset();
+}
+
+
+void Gnss_Channel_Progress::reset()
+{
+    for (unsigned int i = 0; i < GNSS_LATENCY_CHANNELS; i++)
+        {
+            d_entries[i].samples.store(0, std::memory_order_relaxed);
+            d_entries[i].cn0_db_hz.store(0.0, std::memory_order_relaxed);
+            d_entries[i].released.store(false, std::memory_order_relaxed);
+            d_entries[i].ns.store(0, std::memory_order_release);
+        }
+}
+
+
+void Gnss_Channel_Progress::record(int channel, unsigned long long samples, double cn0_db_hz, long long ns)
+{
+    if (channel < 0 or channel >= GNSS_LATENCY_CHANNELS) return;
+    Entry& entry = d_entries[channel];
+    entry.samples.store(samples, std::memory_order_relaxed);
+    entry.cn0_db_hz.store(cn0_db_hz, std::memory_order_relaxed);
+    entry.ns.store(ns, std::memory_order_release);
+}
+
+
+bool Gnss_Channel_Progress::get(int channel, unsigned long long& samples, double& cn0_db_hz, long long& ns) const
+{
+    if (channel < 0 or channel >= GNSS_LATENCY_CHANNELS) return false;
+    const Entry& entry = d_entries[channel];
+    ns = entry.ns.load(std::memory_order_acquire);
+    if (ns == 0) return false;
+    samples = entry.samples.load(std::memory_order_relaxed);
+    cn0_db_hz = entry.cn0_db_hz.load(std::memory_order_relaxed);
+    return true;
+}
+
+
+void Gnss_Channel_Progress::release(int channel)
+{
+    if (channel < 0 or channel >= GNSS_LATENCY_CHANNELS) return;
+    d_entries[channel].released.store(true);
+}
+
+
+bool Gnss_Channel_Progress::released(int channel)
+{
+    if (channel < 0 or channel >= GNSS_LATENCY_CHANNELS) return false;
+    if (not d_entries[channel].released.load(std::memory_order_relaxed)) return false;
+    return d_entries[channel].released.exchange(false);
+}
+
+
+Gnss_Channel_Progress& gnss_channel_progress()
+{
+    static Gnss_Channel_Progress progress;
+    return progress;
+}
+
+
+const double* gnss_latency_bounds_s()
+{
+    return latency_bounds_s;
+}
+
+
+Gnss_Latency_Histogram::Gnss_Latency_Histogram(const std::string& stage) : d_stage(stage), d_count(0), d_sum_ns(0), d_max_ns(0)
+{
+    for (unsigned int i = 0; i <= GNSS_LATENCY_BUCKETS; i++)
+        {
+            d_counts[i].store(0);
+        }
+}
+
+
+void Gnss_Latency_Histogram::add(long long ns)
+{
+    if (ns < 0) ns = 0;
+    double s = static_cast<double>(ns) * 1e-9;
+    unsigned int bucket = 0;
+    while (bucket < GNSS_LATENCY_BUCKETS and s > latency_bounds_s[bucket])
+        {
+            bucket++;
+        }
+    d_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    d_sum_ns.fetch_add(ns, std::memory_order_relaxed);
+    long long max = d_max_ns.load(std::memory_order_relaxed);
+    while (ns > max and not d_max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+        {
+        }
+    d_count.fetch_add(1, std::memory_order_release);
+}
+
+
+Gnss_Latency_Snapshot Gnss_Latency_Histogram::snapshot() const
+{
+    Gnss_Latency_Snapshot s;
+    s.stage = d_stage;
+    s.count = d_count.load(std::memory_order_acquire);
+    for (unsigned int i = 0; i <= GNSS_LATENCY_BUCKETS; i++)
+        {
+            s.counts[i] = d_counts[i].load(std::memory_order_relaxed);
+        }
+    s.sum_ns = d_sum_ns.load(std::memory_order_relaxed);
+    s.max_ns = d_max_ns.load(std::memory_order_relaxed);
+    return s;
+}
+
+
+std::shared_ptr<Gnss_Latency_Histogram> gnss_latency_histogram(const std::string& stage)
+{
+    boost::mutex::scoped_lock lock(registry_mutex);
+    for (unsigned int i = 0; i < registry.size(); i++)
+        {
+            if (registry[i]->stage() == stage) return registry[i];
+        }
+    registry.push_back(std::make_shared<Gnss_Latency_Histogram>(stage));
+    return registry.back();
+}
+
+
+std::vector<Gnss_Latency_Snapshot> gnss_latency_snapshot()
+{
+    std::vector<Gnss_Latency_Snapshot> stages;
+    boost::mutex::scoped_lock lock(registry_mutex);
+    for (unsigned int i = 0; i < registry.size(); i++)
+        {
+            stages.push_back(registry[i]->snapshot());
+        }
+    return stages;
+}
+
+
+std::string gnss_latency_prometheus(const std::vector<Gnss_Latency_Snapshot>& stages)
+{
+    std::ostringstream os;
+    os << std::setprecision(15);
+    os << "# HELP gnss_sdr_latency_seconds Latency of each stage of the receiver\n";
+    os << "# TYPE gnss_sdr_latency_seconds histogram\n";
+    for (unsigned int i = 0; i < stages.size(); i++)
+        {
+            const Gnss_Latency_Snapshot& s = stages[i];
+            unsigned long long cumulative = 0;
+            for (unsigned int b = 0; b < GNSS_LATENCY_BUCKETS; b++)
+                {
+                    cumulative += s.counts[b];
+                    os << "gnss_sdr_latency_seconds_bucket{stage=\"" << s.stage << "\",le=\"" << latency_bounds_s[b] << "\"} " << cumulative << "\n";
+                }
+            os << "gnss_sdr_latency_seconds_bucket{stage=\"" << s.stage << "\",le=\"+Inf\"} " << cumulative + s.counts[GNSS_LATENCY_BUCKETS] << "\n";
+            os << "gnss_sdr_latency_seconds_sum{stage=\"" << s.stage << "\"} " << static_cast<double>(s.sum_ns) * 1e-9 << "\n";
+            os << "gnss_sdr_latency_seconds_count{stage=\"" << s.stage << "\"} " << cumulative + s.counts[GNSS_LATENCY_BUCKETS] << "\n";
+        }
+    return os.str();
+}
+
+
+std::vector<std::string> gnss_latency_summary(const std::vector<Gnss_Latency_Snapshot>& before,
+        const std::vector<Gnss_Latency_Snapshot>& after)
+{
+    std::vector<std::string> summary;
+    for (unsigned int i = 0; i < after.size(); i++)
+        {
+            Gnss_Latency_Snapshot b = Gnss_Latency_Snapshot();
+            for (unsigned int j = 0; j < before.size(); j++)
+                {
+                    if (before[j].stage == after[i].stage) b = before[j];
+                }
+            const Gnss_Latency_Snapshot& a = after[i];
+            unsigned long long counts[GNSS_LATENCY_BUCKETS + 1];
+            unsigned long long count = 0;
+            for (unsigned int k = 0; k <= GNSS_LATENCY_BUCKETS; k++)
+                {
+                    counts[k] = a.counts[k] - b.counts[k];
+                    count += counts[k];
+                }
+            if (count == 0) continue;
+            std::ostringstream os;
+            os << std::fixed << std::setprecision(2) << a.stage << ": " << count << " samples, mean "
+               << static_cast<double>(a.sum_ns - b.sum_ns) * 1e-6 / static_cast<double>(count) << " ms, p50 <= "
+               << latency_quantile_s(counts, count, 0.5) * 1e3 << " ms, p99 <= "
+               << latency_quantile_s(counts, count, 0.99) * 1e3 << " ms, max " << static_cast<double>(a.max_ns) * 1e-6 << " ms";
+            summary.push_back(os.str());
+        }
+    return summary;
+}
+
+
+long long gnss_latency_at_pvt(const std::map<int, Gnss_Synchro>& observables)
+{
+    static std::shared_ptr<Gnss_Latency_Histogram> source_to_tracking = gnss_latency_histogram("source_to_tracking");
+    static std::shared_ptr<Gnss_Latency_Histogram> tracking_to_pvt = gnss_latency_histogram("tracking_to_pvt");
+    long long now = gnss_steady_ns();
+    long long latest_arrival = 0;
+    for (std::map<int, Gnss_Synchro>::const_iterator it = observables.begin(); it != observables.end(); ++it)
+        {
+            if (it->second.Tracking_output_ns <= 0) continue;
+            tracking_to_pvt->add(now - it->second.Tracking_output_ns);
+            if (it->second.Sample_arrival_ns <= 0) continue;
+            source_to_tracking->add(it->second.Tracking_output_ns - it->second.Sample_arrival_ns);
+            if (it->second.Sample_arrival_ns > latest_arrival) latest_arrival = it->second.Sample_arrival_ns;
+        }
+    return latest_arrival;
+}
+
+
+void gnss_latency_set_late_threshold(double late_s)
+{
+    late_threshold_ns.store(late_s > 0.0 ? static_cast<long long>(late_s * 1e9) : 0, std::memory_order_relaxed);
+}
+
+
+bool gnss_latency_late(long long sample_arrival_ns)
+{
+    long long threshold = late_threshold_ns.load(std::memory_order_relaxed);
+    if (threshold <= 0 or sample_arrival_ns <= 0) return false;
+    return gnss_steady_ns() - sample_arrival_ns > threshold;
+}
@@ -0,0 +1,245 @@
+/*!
+ * \file gnss_latency.h
+ * \brief Wall-clock arrival time of the samples and latency histograms of
+ * the receiver stages
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_GNSS_LATENCY_H_
+#define GNSS_SDR_GNSS_LATENCY_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "gnss_synchro.h"
+
+#define GNSS_SAMPLE_CLOCK_STAMPS 4096   // arrival stamps kept by the sample clock
+#define GNSS_LATENCY_BUCKETS 16         // finite buckets of the latency histograms
+#define GNSS_LATENCY_CHANNELS 256       // channels followed by the channel progress table
+#define GNSS_LATENCY_LATE_S 0.5         // default age of a late epoch at the PVT [s]
+
+//! Current time of the steady clock [ns]
+inline long long gnss_steady_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/*!
+ * \brief This class is a side table that maps the sample counter of the
+ * stream feeding the channels to the wall-clock time those samples became
+ * available.
+ *
+ * A single writer (see gnss_sample_clock_sink) stamps the number of
+ * samples delivered so far at every work call; any thread can then ask
+ * when a given sample arrived. Only the last GNSS_SAMPLE_CLOCK_STAMPS
+ * stamps are kept, so samples much older than the newest ones are unknown.
+ */
+class Gnss_Sample_Clock
+{
+public:
+    Gnss_Sample_Clock();
+
+    //! Forgets all the stamps, for a new flowgraph
+    void reset();
+
+    //! Stamps that the samples before \p samples had arrived at \p ns [ns]. Single writer.
+    void record(unsigned long long samples, long long ns);
+
+    /*!
+     * \brief Steady clock time [ns] at which sample \p sample (counted from
+     * 0) was first seen, or 0 if it is unknown: not stamped yet, or too old.
+     */
+    long long arrival_ns(unsigned long long sample) const;
+
+    /*!
+     * \brief Gets the newest stamp: \p samples had arrived at \p ns [ns].
+     * Returns false if nothing has been stamped yet.
+     */
+    bool latest(unsigned long long& samples, long long& ns) const;
+
+private:
+    struct Stamp
+    {
+        std::atomic<unsigned long long> samples;
+        std::atomic<long long> ns;
+    };
+    Stamp d_stamps[GNSS_SAMPLE_CLOCK_STAMPS];
+    std::atomic<unsigned long long> d_count;   // stamps recorded so far
+};
+
+//! The sample clock of the receiver
+Gnss_Sample_Clock& gnss_sample_clock();
+
+
+/*!
+ * \brief This class is a side table with the progress of each channel: the
+ * samples its tracking block has processed, when, and the CN0 it measured.
+ *
+ * Each tracking block writes the entry of its channel (see
+ * gnss_latency_stamp) and any thread can read them, which gives the lag of
+ * every channel behind the sample clock. The table also carries release
+ * requests: a released channel reports a loss of lock at its next
+ * CN0 estimation, and its tracking block stops.
+ */
+class Gnss_Channel_Progress
+{
+public:
+    Gnss_Channel_Progress();
+
+    //! Forgets the progress and the release requests of all the channels
+    void reset();
+
+    //! Records that \p channel had processed \p samples at \p ns [ns], with a CN0 of \p cn0_db_hz
+    void record(int channel, unsigned long long samples, double cn0_db_hz, long long ns);
+
+    //! Gets the last record of \p channel. Returns false if it has none since the last reset.
+    bool get(int channel, unsigned long long& samples, double& cn0_db_hz, long long& ns) const;
+
+    //! Asks the tracking block of \p channel to let its satellite go
+    void release(int channel);
+
+    //! Returns true, once, if \p channel has been asked to let its satellite go
+    bool released(int channel);
+
+private:
+    struct Entry
+    {
+        std::atomic<unsigned long long> samples;
+        std::atomic<double> cn0_db_hz;
+        std::atomic<long long> ns;
+        std::atomic<bool> released;
+    };
+    Entry d_entries[GNSS_LATENCY_CHANNELS];
+};
+
+//! The progress of the channels of the receiver
+Gnss_Channel_Progress& gnss_channel_progress();
+
+
+/*!
+ * \brief Counts of a latency histogram at a given time. counts[i] is the
+ * number of latencies up to gnss_latency_bounds_s()[i] and above the
+ * previous bound; counts[GNSS_LATENCY_BUCKETS] the ones above the last bound.
+ */
+struct Gnss_Latency_Snapshot
+{
+    std::string stage;
+    unsigned long long counts[GNSS_LATENCY_BUCKETS + 1];
+    unsigned long long count;
+    long long sum_ns;
+    long long max_ns;
+};
+
+//! Upper bounds of the latency buckets [s], from 100 us to 10 s
+const double* gnss_latency_bounds_s();
+
+
+/*!
+ * \brief This class is a histogram of the latencies of a stage of the
+ * receiver. Any thread can add latencies and take snapshots without locks.
+ */
+class Gnss_Latency_Histogram
+{
+public:
+    explicit Gnss_Latency_Histogram(const std::string& stage);
+
+    const std::string& stage() const { return d_stage; }
+
+    //! Adds a latency of \p ns nanoseconds. Negative latencies (clock races) count as 0.
+    void add(long long ns);
+
+    Gnss_Latency_Snapshot snapshot() const;
+
+private:
+    std::string d_stage;
+    std::atomic<unsigned long long> d_counts[GNSS_LATENCY_BUCKETS + 1];
+    std::atomic<unsigned long long> d_count;
+    std::atomic<long long> d_sum_ns;
+    std::atomic<long long> d_max_ns;
+};
+
+
+/*!
+ * \brief The histogram of \p stage, created the first time it is asked for.
+ * The receiver measures "source_to_tracking" (samples available to the
+ * channels to tracking output), "tracking_to_pvt", "pvt_to_output" (record
+ * posted by the PVT to written by the output writer) and "sample_to_output"
+ * (the age of a fix when it is written).
+ */
+std::shared_ptr<Gnss_Latency_Histogram> gnss_latency_histogram(const std::string& stage);
+
+//! Snapshots of all the histograms, in the order they were created
+std::vector<Gnss_Latency_Snapshot> gnss_latency_snapshot();
+
+//! Formats \p stages as a Prometheus histogram labelled by stage
+std::string gnss_latency_prometheus(const std::vector<Gnss_Latency_Snapshot>& stages);
+
+/*!
+ * \brief One line per stage with the latencies added between \p before and
+ * \p after: count, mean, median and 99th percentile (bucket upper bounds)
+ * and the largest latency seen so far
+ */
+std::vector<std::string> gnss_latency_summary(const std::vector<Gnss_Latency_Snapshot>& before,
+        const std::vector<Gnss_Latency_Snapshot>& after);
+
+
+/*!
+ * \brief Stamps a tracking output with the arrival time of \p last_sample,
+ * the last sample it was computed from, and with the current time, and
+ * records the progress of its channel
+ */
+inline void gnss_latency_stamp(Gnss_Synchro& synchro, unsigned long long last_sample)
+{
+    synchro.Sample_arrival_ns = gnss_sample_clock().arrival_ns(last_sample);
+    synchro.Tracking_output_ns = gnss_steady_ns();
+    gnss_channel_progress().record(synchro.Channel_ID, last_sample, synchro.CN0_dB_hz, synchro.Tracking_output_ns);
+}
+
+/*!
+ * \brief Adds the source to tracking and tracking to PVT latencies of the
+ * valid \p observables of an epoch reaching the PVT. Returns the latest
+ * arrival of their samples (the age of the epoch), or 0 if unknown.
+ */
+long long gnss_latency_at_pvt(const std::map<int, Gnss_Synchro>& observables);
+
+/*!
+ * \brief Sets the age [s] beyond which an epoch reaching the PVT is late
+ * (see gnss_latency_late()). 0 or negative: no epoch is late.
+ */
+void gnss_latency_set_late_threshold(double late_s);
+
+/*!
+ * \brief Tells whether an epoch whose samples arrived at \p sample_arrival_ns
+ * (as returned by gnss_latency_at_pvt()) is late now. Unknown arrivals are not.
+ */
+bool gnss_latency_late(long long sample_arrival_ns);
+
+#endif
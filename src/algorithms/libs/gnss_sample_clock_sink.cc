@@ -0,0 +1,61 @@
+/*!
+ * \file gnss_sample_clock_sink.cc
+ * \brief GNU Radio block that stamps the arrival time of the samples that
+ * reach the channels
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include "gnss_sample_clock_sink.h"
+#include <gnuradio/io_signature.h>
+#include "gnss_latency.h"
+
+gnss_sample_clock_sink::gnss_sample_clock_sink(size_t sizeof_stream_item) : gr::sync_block("sample_clock_sink",
+        gr::io_signature::make(1, 1, sizeof_stream_item),
+        gr::io_signature::make(0, 0, 0))
+{
+    // the sample counter starts again with the new flowgraph
+    gnss_sample_clock().reset();
+    gnss_channel_progress().reset();
+}
+
+
+
+boost::shared_ptr<gr::block> gnss_sdr_make_sample_clock_sink(size_t sizeof_stream_item)
+{
+    boost::shared_ptr<gnss_sample_clock_sink> sink_(new gnss_sample_clock_sink(sizeof_stream_item));
+    return sink_;
+}
+
+
+
+int gnss_sample_clock_sink::work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items)
+{
+    gnss_sample_clock().record(nitems_read(0) + noutput_items, gnss_steady_ns());
+    return noutput_items;
+}
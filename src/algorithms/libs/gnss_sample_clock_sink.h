@@ -0,0 +1,60 @@
+/*!
+ * \file gnss_sample_clock_sink.h
+ * \brief GNU Radio block that stamps the arrival time of the samples that
+ * reach the channels
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_GNSS_SAMPLE_CLOCK_SINK_H_
+#define GNSS_SDR_GNSS_SAMPLE_CLOCK_SINK_H_
+
+#include <cstddef>
+#include <gnuradio/sync_block.h>
+#include <boost/shared_ptr.hpp>
+
+
+boost::shared_ptr<gr::block> gnss_sdr_make_sample_clock_sink(size_t sizeof_stream_item);
+
+/*!
+ * \brief Implementation of a GNU Radio block that records in the sample
+ * clock of the receiver (see Gnss_Sample_Clock) the time at which the
+ * samples of the stream it is connected to become available. It does not
+ * read the samples, so it can share the output of the signal conditioner
+ * with the channels at no cost.
+ */
+class gnss_sample_clock_sink : public gr::sync_block
+{
+    friend boost::shared_ptr<gr::block> gnss_sdr_make_sample_clock_sink(size_t sizeof_stream_item);
+    gnss_sample_clock_sink(size_t sizeof_stream_item);
+
+public:
+    int work(int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif /*GNSS_SDR_GNSS_SAMPLE_CLOCK_SINK_H_*/
@@ -0,0 +1,195 @@
+/*!
+ * \file gnss_throughput_report.cc
+ * \brief Results of a receiver run as fast as it can on a capture: how many
+ * times real time it went, what it cost, and where the time was spent.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_throughput_report.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <sstream>
+
+
+Gnss_Throughput_Report::Gnss_Throughput_Report()
+{
+    synthetic = false;
+    ok = false;
+    fs_hz = 0.0;
+    signal_s = 0.0;
+    wall_s = 0.0;
+    cpu_s = 0.0;
+    peak_rss_kb = 0;
+    ttff_s = -1.0;
+    ttff_wall_s = -1.0;
+}
+
+
+double Gnss_Throughput_Report::realtime_factor() const
+{
+    if (wall_s <= 0.0)
+        {
+            return 0.0;
+        }
+    return signal_s / wall_s;
+}
+
+
+bool throughput_block_busier(const Gnss_Throughput_Block& a, const Gnss_Throughput_Block& b)
+{
+    if (a.work_s != b.work_s)
+        {
+            return a.work_s > b.work_s;
+        }
+    return a.name < b.name;
+}
+
+
+std::vector<Gnss_Throughput_Block> gnss_throughput_blocks(const std::vector<Gnss_Block_Counters_Snapshot>& before,
+        const std::vector<Gnss_Block_Counters_Snapshot>& after)
+{
+    std::map<long, unsigned long long> work_before;
+    for (unsigned int i = 0; i < before.size(); i++)
+        {
+            work_before[before[i].id] = before[i].work_ns;
+        }
+    std::map<std::string, Gnss_Throughput_Block> kinds;
+    for (unsigned int i = 0; i < after.size(); i++)
+        {
+            unsigned long long work_ns = after[i].work_ns;
+            std::map<long, unsigned long long>::const_iterator it = work_before.find(after[i].id);
+            if (it != work_before.end())
+                {
+                    work_ns = (work_ns > it->second) ? work_ns - it->second : 0;
+                }
+            std::map<std::string, Gnss_Throughput_Block>::iterator kind = kinds.find(after[i].name);
+            if (kind == kinds.end())
+                {
+                    Gnss_Throughput_Block block;
+                    block.name = after[i].name;
+                    block.instances = 0;
+                    block.work_s = 0.0;
+                    kind = kinds.insert(std::make_pair(after[i].name, block)).first;
+                }
+            kind->second.instances++;
+            kind->second.work_s += static_cast<double>(work_ns) * 1e-9;
+        }
+    std::vector<Gnss_Throughput_Block> blocks;
+    for (std::map<std::string, Gnss_Throughput_Block>::const_iterator it = kinds.begin(); it != kinds.end(); ++it)
+        {
+            blocks.push_back(it->second);
+        }
+    std::sort(blocks.begin(), blocks.end(), throughput_block_busier);
+    return blocks;
+}
+
+
+std::string throughput_json_string(const std::string& s)
+{
+    std::string out = "\"";
+    for (unsigned int i = 0; i < s.size(); i++)
+        {
+            unsigned char c = static_cast<unsigned char>(s[i]);
+            if (c == '"' or c == '\\')
+                {
+                    out += '\\';
+                    out += s[i];
+                }
+            else if (c < 0x20)
+                {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                }
+            else
+                {
+                    out += s[i];
+                }
+        }
+    return out + "\"";
+}
+
+
+// JSON has no infinity nor NaN, and the unknown values are negative
+std::string throughput_json_number(double value, bool known = true)
+{
+    if (!known or !std::isfinite(value))
+        {
+            return "null";
+        }
+    std::ostringstream out;
+    out.precision(9);
+    out << value;
+    return out.str();
+}
+
+
+std::string gnss_throughput_json(const std::vector<Gnss_Throughput_Report>& reports)
+{
+    std::ostringstream json;
+    json << "[";
+    for (unsigned int i = 0; i < reports.size(); i++)
+        {
+            const Gnss_Throughput_Report& r = reports[i];
+            double total_work_s = 0.0;
+            for (unsigned int j = 0; j < r.blocks.size(); j++)
+                {
+                    total_work_s += r.blocks[j].work_s;
+                }
+            json << (i > 0 ? "," : "") << std::endl;
+            json << "  {" << std::endl;
+            json << "    \"name\": " << throughput_json_string(r.name) << "," << std::endl;
+            json << "    \"config_file\": " << throughput_json_string(r.config_file) << "," << std::endl;
+            json << "    \"signal_source\": " << throughput_json_string(r.signal_source) << "," << std::endl;
+            json << "    \"synthetic\": " << (r.synthetic ? "true" : "false") << "," << std::endl;
+            json << "    \"ok\": " << (r.ok ? "true" : "false") << "," << std::endl;
+            json << "    \"sampling_frequency_hz\": " << throughput_json_number(r.fs_hz) << "," << std::endl;
+            json << "    \"signal_s\": " << throughput_json_number(r.signal_s) << "," << std::endl;
+            json << "    \"wall_s\": " << throughput_json_number(r.wall_s) << "," << std::endl;
+            json << "    \"realtime_factor\": " << throughput_json_number(r.realtime_factor(), r.wall_s > 0.0) << "," << std::endl;
+            json << "    \"cpu_s\": " << throughput_json_number(r.cpu_s) << "," << std::endl;
+            json << "    \"peak_rss_kb\": " << r.peak_rss_kb << "," << std::endl;
+            json << "    \"ttff_s\": " << throughput_json_number(r.ttff_s, r.ttff_s >= 0.0) << "," << std::endl;
+            json << "    \"ttff_wall_s\": " << throughput_json_number(r.ttff_wall_s, r.ttff_wall_s >= 0.0) << "," << std::endl;
+            json << "    \"blocks\": [";
+            for (unsigned int j = 0; j < r.blocks.size(); j++)
+                {
+                    const Gnss_Throughput_Block& b = r.blocks[j];
+                    json << (j > 0 ? "," : "") << std::endl;
+                    json << "      {\"name\": " << throughput_json_string(b.name)
+                         << ", \"instances\": " << b.instances
+                         << ", \"work_s\": " << throughput_json_number(b.work_s)
+                         << ", \"cpu_share\": " << throughput_json_number(b.work_s / total_work_s, total_work_s > 0.0)
+                         << ", \"cores\": " << throughput_json_number(b.work_s / r.wall_s, r.wall_s > 0.0) << "}";
+                }
+            json << (r.blocks.empty() ? "" : "\n    ") << "]" << std::endl;
+            json << "  }";
+        }
+    json << (reports.empty() ? "" : "\n") << "]" << std::endl;
+    return json.str();
+}
@@ -0,0 +1,123 @@
+/*!
+ * \file gnss_throughput_report.h
+ * \brief Results of a receiver run as fast as it can on a capture: how many
+ * times real time it went, what it cost, and where the time was spent.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_THROUGHPUT_REPORT_H_
+#define GNSS_SDR_GNSS_THROUGHPUT_REPORT_H_
+
+#include <string>
+#include <vector>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include "gnss_block_counters.h"
+
+/*!
+ * \brief Time spent in work by all the blocks of a kind (e.g. the tracking
+ * blocks of all the channels)
+ */
+struct Gnss_Throughput_Block
+{
+    std::string name;
+    unsigned int instances;
+    double work_s;   //!< Time spent in work by all the instances [s]
+
+    template<class Archive>
+    void serialize(Archive& archive, const unsigned int version)
+    {
+        using boost::serialization::make_nvp;
+        archive & make_nvp("name", name);
+        archive & make_nvp("instances", instances);
+        archive & make_nvp("work_s", work_s);
+    }
+};
+
+
+/*!
+ * \brief This class is a storage for the results of one receiver run
+ */
+class Gnss_Throughput_Report
+{
+public:
+    std::string name;            //!< Name of the run
+    std::string config_file;
+    std::string signal_source;   //!< Capture processed
+    bool synthetic;              //!< The capture was generated for the run
+    bool ok;                     //!< The receiver ran to the end of the capture
+    double fs_hz;                //!< Sampling frequency at the channels [Hz]
+    double signal_s;             //!< Signal delivered to the channels [s]
+    double wall_s;               //!< Wall time from the start of the flowgraph to its end [s]
+    double cpu_s;                //!< User plus system time of the receiver process [s]
+    long peak_rss_kb;            //!< Peak resident set size of the receiver process [KiB]
+    double ttff_s;               //!< Signal time at the first position fix [s], negative if there was none
+    double ttff_wall_s;          //!< Wall time at the first position fix [s], negative if there was none
+    std::vector<Gnss_Throughput_Block> blocks;   //!< Busiest first
+
+    Gnss_Throughput_Report();
+
+    //! Seconds of signal processed per second, 0 if unknown
+    double realtime_factor() const;
+
+    template<class Archive>
+    void serialize(Archive& archive, const unsigned int version)
+    {
+        using boost::serialization::make_nvp;
+        archive & make_nvp("name", name);
+        archive & make_nvp("config_file", config_file);
+        archive & make_nvp("signal_source", signal_source);
+        archive & make_nvp("synthetic", synthetic);
+        archive & make_nvp("ok", ok);
+        archive & make_nvp("fs_hz", fs_hz);
+        archive & make_nvp("signal_s", signal_s);
+        archive & make_nvp("wall_s", wall_s);
+        archive & make_nvp("cpu_s", cpu_s);
+        archive & make_nvp("peak_rss_kb", peak_rss_kb);
+        archive & make_nvp("ttff_s", ttff_s);
+        archive & make_nvp("ttff_wall_s", ttff_wall_s);
+        archive & make_nvp("blocks", blocks);
+    }
+};
+
+
+/*!
+ * \brief Time spent in work by each kind of block between the \p before
+ * and \p after snapshots of the block counters, busiest first. Blocks are
+ * matched by id, and grouped by name.
+ */
+std::vector<Gnss_Throughput_Block> gnss_throughput_blocks(const std::vector<Gnss_Block_Counters_Snapshot>& before,
+        const std::vector<Gnss_Block_Counters_Snapshot>& after);
+
+/*!
+ * \brief Formats \p reports as a JSON array, one object per run. The share
+ * of each kind of block is its part of the work time of all the blocks;
+ * its cores are its work time over the wall time.
+ */
+std::string gnss_throughput_json(const std::vector<Gnss_Throughput_Report>& reports);
+
+#endif
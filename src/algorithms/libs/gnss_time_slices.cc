@@ -0,0 +1,63 @@
+/*!
+ * \file gnss_time_slices.cc
+ * \brief Splits a capture in overlapping time slices for batch processing
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_time_slices.h"
+#include <algorithm>
+
+
+std::vector<Gnss_Time_Slice> gnss_time_slices(unsigned long long begin_item,
+        unsigned long long total_items, unsigned int slices,
+        unsigned long long overlap_items, unsigned int item_align)
+{
+    std::vector<Gnss_Time_Slice> plan;
+    if (item_align == 0) item_align = 1;
+    total_items -= total_items % item_align;
+    overlap_items += (item_align - overlap_items % item_align) % item_align;
+    if (total_items == 0) return plan;
+    if (slices == 0) slices = 1;
+    if (overlap_items > 0)
+        {
+            slices = static_cast<unsigned int>(std::min<unsigned long long>(slices, std::max<unsigned long long>(1, total_items / overlap_items)));
+        }
+
+    unsigned long long aligned_total = total_items / item_align;
+    for (unsigned int i = 0; i < slices; i++)
+        {
+            Gnss_Time_Slice slice;
+            slice.index = i;
+            unsigned long long owned_begin = aligned_total * i / slices * item_align;
+            unsigned long long owned_end = aligned_total * (i + 1) / slices * item_align;
+            unsigned long long first = (owned_begin > overlap_items) ? owned_begin - overlap_items : 0;
+            slice.first_item = begin_item + first;
+            slice.owned_first_item = begin_item + owned_begin;
+            slice.items = owned_end - first;
+            plan.push_back(slice);
+        }
+    return plan;
+}
@@ -0,0 +1,62 @@
+/*!
+ * \file gnss_time_slices.h
+ * \brief Splits a capture in overlapping time slices for batch processing
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_TIME_SLICES_H_
+#define GNSS_SDR_GNSS_TIME_SLICES_H_
+
+#include <vector>
+
+/*!
+ * \brief A part of a capture processed by an independent receiver.
+ *
+ * The receiver reads \p items items from \p first_item. The results of the
+ * first items, up to \p owned_first_item, are those of a receiver that is
+ * still acquiring and decoding the time: the previous slice covers them.
+ */
+struct Gnss_Time_Slice
+{
+    unsigned int index;
+    unsigned long long first_item;
+    unsigned long long items;
+    unsigned long long owned_first_item;
+};
+
+/*!
+ * \brief Splits \p total_items items, starting at \p begin_item, in at most
+ * \p slices slices, each one starting \p overlap_items before its share of
+ * the capture. Slices start at multiples of \p item_align items (e.g. 2 for
+ * interleaved I/Q samples). The number of slices is reduced so that each
+ * share is at least as long as the overlap: below that, most of the work
+ * would be done twice.
+ */
+std::vector<Gnss_Time_Slice> gnss_time_slices(unsigned long long begin_item,
+        unsigned long long total_items, unsigned int slices,
+        unsigned long long overlap_items, unsigned int item_align = 1);
+
+#endif
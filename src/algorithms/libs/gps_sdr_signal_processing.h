@@ -46,4 +46,13 @@ void gps_l1_ca_code_gen_complex_sampled(std::complex<float>* _dest, unsigned int
 //! Generates complex GPS L1 C/A code for the desired SV ID and code shift
 void gps_l1_ca_code_gen_complex_sampled(std::complex<float>* _dest, unsigned int _prn, signed int _fs, unsigned int _chip_shift);
 
+/*!
+ * \brief Resamples the C/A code of the tracking loops (_ca_code: the 1023 chips with one chip of
+ * margin at each end) into the early, prompt and late codes of one integration. _early must hold
+ * the integration plus twice the early-late spacing.
+ */
+void gps_l1_ca_epl_code_resampler(std::complex<float>* _early, std::complex<float>* _prompt, std::complex<float>* _late,
+        const std::complex<float>* _ca_code, double _code_freq_chips, double _fs, double _rem_code_phase_samples,
+        double _early_late_spc_chips, int _prn_length_samples);
+
 #endif /* GNSS_SDR_GPS_SDR_SIGNAL_PROCESSING_H_ */
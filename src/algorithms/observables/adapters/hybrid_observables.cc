@@ -48,7 +48,7 @@ HybridObservables::HybridObservables(ConfigurationInterface* configuration,
                     queue_(queue)
 {
     int output_rate_ms;
-    output_rate_ms = configuration->property(role + ".output_rate_ms", 500);
+    output_rate_ms = configuration->property(role + ".output_rate_ms", 1);
     std::string default_dump_filename = "./observables.dat";
     DLOG(INFO) << "role " << role;
     bool flag_averaging;
@@ -57,11 +57,19 @@ galileo_e1_observables_cc::galileo_e1_observables_cc(unsigned int nchannels, boo
 		                        gr::block("galileo_e1_observables_cc", gr::io_signature::make(nchannels, nchannels, sizeof(Gnss_Synchro)),
 		                        gr::io_signature::make(nchannels, nchannels, sizeof(Gnss_Synchro)))
 {
+    d_counters = gnss_block_counters(this);
     // initialize internal vars
     d_queue = queue;
     d_dump = dump;
     d_nchannels = nchannels;
     d_output_rate_ms = output_rate_ms;
+    if (d_output_rate_ms < 1)
+        {
+            d_output_rate_ms = 1;
+        }
+    d_sample_counter = 0;
+    // only one out of d_output_rate_ms input epochs is delivered downstream
+    set_relative_rate(1.0 / static_cast<double>(d_output_rate_ms));
     d_dump_filename = dump_filename;
     d_flag_averaging = flag_averaging;
 
@@ -70,16 +78,25 @@ galileo_e1_observables_cc::galileo_e1_observables_cc(unsigned int nchannels, boo
         {
             if (d_dump_file.is_open() == false)
                 {
-                    try
-                    {
-                            d_dump_file.exceptions (std::ifstream::failbit | std::ifstream::badbit );
-                            d_dump_file.open(d_dump_filename.c_str(), std::ios::out | std::ios::binary);
-                            LOG(INFO) << "Observables dump enabled Log file: " << d_dump_filename.c_str();
-                    }
-                    catch (std::ifstream::failure e)
-                    {
-                            LOG(WARNING) << "Exception opening observables dump file " << e.what();
-                    }
+                    d_dump_file.set_attribute("source", "galileo_e1_observables");
+                    d_dump_file.set_attribute("channels", d_nchannels);
+                    for (unsigned int i = 0; i < d_nchannels; i++)
+                        {
+                            std::string channel = "ch" + std::to_string(i) + "_";
+                            d_dump_file.add_field<double>(channel + "TOW_at_current_symbol");
+                            d_dump_file.add_field<double>(channel + "Prn_timestamp_ms");
+                            d_dump_file.add_field<double>(channel + "Pseudorange_m");
+                            d_dump_file.add_field<double>(channel + "Flag_valid_pseudorange");
+                            d_dump_file.add_field<double>(channel + "PRN");
+                        }
+                    if (d_dump_file.open(d_dump_filename))
+                        {
+                            LOG(INFO) << "Observables dump enabled Log file: " << d_dump_filename;
+                        }
+                    else
+                        {
+                            LOG(WARNING) << "Unable to open observables dump file " << d_dump_filename;
+                        }
                 }
         }
 }
@@ -110,6 +127,7 @@ bool Galileo_pairCompare_gnss_synchro_d_TOW_at_current_symbol( std::pair<int,Gns
 int galileo_e1_observables_cc::general_work (int noutput_items, gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items,	gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
     Gnss_Synchro **in = (Gnss_Synchro **)  &input_items[0];   // Get the input pointer
     Gnss_Synchro **out = (Gnss_Synchro **)  &output_items[0]; // Get the output pointer
 
@@ -117,6 +135,36 @@ int galileo_e1_observables_cc::general_work (int noutput_items, gr_vector_int &n
     std::map<int,Gnss_Synchro> current_gnss_synchro_map;
     std::map<int,Gnss_Synchro>::iterator gnss_synchro_iter;
     d_sample_counter++; //count for the processed samples
+    // Measurements are only delivered at the epochs whose receiver TOW, rounded to ms, is a
+    // multiple of d_output_rate_ms, so that the outputs fall on the GNSS time grid whatever
+    // the epoch the receiver started at. The receiver TOW is the most recent symbol TOW of
+    // the channels with a valid word (the reference of the pseudoranges). Before the first
+    // valid word there is no TOW, and the epoch counter is used instead. Intermediate epochs
+    // are consumed without being computed, unless the full rate dump is enabled.
+    bool valid_tow = false;
+    double rx_tow_s = 0.0;
+    for (unsigned int i = 0; i < d_nchannels; i++)
+        {
+            if (in[i][0].Flag_valid_word and (valid_tow == false or in[i][0].d_TOW_at_current_symbol > rx_tow_s))
+                {
+                    rx_tow_s = in[i][0].d_TOW_at_current_symbol;
+                    valid_tow = true;
+                }
+        }
+    bool output_epoch;
+    if (valid_tow)
+        {
+            output_epoch = (static_cast<long long int>(round(rx_tow_s * 1000.0)) % d_output_rate_ms) == 0;
+        }
+    else
+        {
+            output_epoch = (d_sample_counter % d_output_rate_ms) == 0;
+        }
+    if ((output_epoch == false) and (d_dump == false))
+        {
+            consume_each(1);
+            return 0;
+        }
     /*
      * 1. Read the GNSS SYNCHRO objects from available channels
      */
@@ -173,30 +221,22 @@ int galileo_e1_observables_cc::general_work (int noutput_items, gr_vector_int &n
       if(d_dump == true)
         {
             // MULTIPLEXED FILE RECORDING - Record results to file
-            try
-            {
-                    double tmp_double;
-                    for (unsigned int i = 0; i < d_nchannels ; i++)
-                        {
-                            tmp_double = current_gnss_synchro[i].d_TOW_at_current_symbol;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = current_gnss_synchro[i].Prn_timestamp_ms;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = current_gnss_synchro[i].Pseudorange_m;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = (double)(current_gnss_synchro[i].Flag_valid_pseudorange==true);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = current_gnss_synchro[i].PRN;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                        }
-            }
-            catch (const std::ifstream::failure& e)
-            {
-                    LOG(WARNING) << "Exception writing observables dump file " << e.what();
-            }
+            for (unsigned int i = 0; i < d_nchannels; i++)
+                {
+                    d_dump_file.put<double>(current_gnss_synchro[i].d_TOW_at_current_symbol);
+                    d_dump_file.put<double>(current_gnss_synchro[i].Prn_timestamp_ms);
+                    d_dump_file.put<double>(current_gnss_synchro[i].Pseudorange_m);
+                    d_dump_file.put<double>(current_gnss_synchro[i].Flag_valid_pseudorange == true ? 1.0 : 0.0);
+                    d_dump_file.put<double>(current_gnss_synchro[i].PRN);
+                }
+            d_dump_file.end_record();
         }
 
     consume_each(1); //one by one
+    if (output_epoch == false)
+        {
+            return 0;
+        }
     for (unsigned int i = 0; i < d_nchannels ; i++)
         {
             *out[i] = current_gnss_synchro[i];
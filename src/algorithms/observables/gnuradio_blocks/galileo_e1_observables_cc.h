@@ -45,7 +45,9 @@
 #include "galileo_navigation_message.h"
 #include "rinex_printer.h"
 #include "Galileo_E1.h"
+#include "gnss_dump_writer.h"
 #include "gnss_synchro.h"
+#include "gnss_block_counters.h"
 
 class galileo_e1_observables_cc;
 
@@ -79,7 +81,8 @@ private:
     unsigned long int d_fs_in;
     int d_output_rate_ms;
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Gnss_Dump_Writer d_dump_file;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 };
 
 #endif
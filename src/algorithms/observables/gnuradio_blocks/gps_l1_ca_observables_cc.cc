@@ -55,11 +55,19 @@ gps_l1_ca_observables_cc::gps_l1_ca_observables_cc(unsigned int nchannels, boost
 		                        gr::block("gps_l1_ca_observables_cc", gr::io_signature::make(nchannels, nchannels, sizeof(Gnss_Synchro)),
 		                        gr::io_signature::make(nchannels, nchannels, sizeof(Gnss_Synchro)))
 {
+    d_counters = gnss_block_counters(this);
     // initialize internal vars
     d_queue = queue;
     d_dump = dump;
     d_nchannels = nchannels;
     d_output_rate_ms = output_rate_ms;
+    if (d_output_rate_ms < 1)
+        {
+            d_output_rate_ms = 1;
+        }
+    d_sample_counter = 0;
+    // only one out of d_output_rate_ms input epochs is delivered downstream
+    set_relative_rate(1.0 / static_cast<double>(d_output_rate_ms));
     d_dump_filename = dump_filename;
     d_flag_averaging = flag_averaging;
 
@@ -68,16 +76,25 @@ gps_l1_ca_observables_cc::gps_l1_ca_observables_cc(unsigned int nchannels, boost
         {
             if (d_dump_file.is_open() == false)
                 {
-                    try
-                    {
-                            d_dump_file.exceptions (std::ifstream::failbit | std::ifstream::badbit );
-                            d_dump_file.open(d_dump_filename.c_str(), std::ios::out | std::ios::binary);
-                            LOG(INFO) << "Observables dump enabled Log file: " << d_dump_filename.c_str() << std::endl;
-                    }
-                    catch (std::ifstream::failure e)
-                    {
-                            LOG(WARNING) << "Exception opening observables dump file " << e.what() << std::endl;
-                    }
+                    d_dump_file.set_attribute("source", "gps_l1_ca_observables");
+                    d_dump_file.set_attribute("channels", d_nchannels);
+                    for (unsigned int i = 0; i < d_nchannels; i++)
+                        {
+                            std::string channel = "ch" + std::to_string(i) + "_";
+                            d_dump_file.add_field<double>(channel + "TOW_at_current_symbol");
+                            d_dump_file.add_field<double>(channel + "Prn_timestamp_ms");
+                            d_dump_file.add_field<double>(channel + "Pseudorange_m");
+                            d_dump_file.add_field<double>(channel + "Flag_valid_pseudorange");
+                            d_dump_file.add_field<double>(channel + "PRN");
+                        }
+                    if (d_dump_file.open(d_dump_filename))
+                        {
+                            LOG(INFO) << "Observables dump enabled Log file: " << d_dump_filename;
+                        }
+                    else
+                        {
+                            LOG(WARNING) << "Unable to open observables dump file " << d_dump_filename;
+                        }
                 }
         }
 }
@@ -102,17 +119,82 @@ bool pairCompare_gnss_synchro_d_TOW_at_current_symbol( std::pair<int,Gnss_Synchr
 }
 
 
+void gps_l1_ca_compute_pseudoranges(const std::map<int, Gnss_Synchro>& valid_synchro, Gnss_Synchro* current_gnss_synchro)
+{
+    if(valid_synchro.size() > 0)
+        {
+            /*
+             *  Use CURRENT set of measurements and find the nearest satellite
+             *  common RX time algorithm
+             */
+            // what is the most recent symbol TOW in the current set? -> this will be the reference symbol
+            std::map<int,Gnss_Synchro>::const_iterator gnss_synchro_iter;
+            gnss_synchro_iter = max_element(valid_synchro.begin(), valid_synchro.end(), pairCompare_gnss_synchro_d_TOW_at_current_symbol);
+            double d_TOW_reference = gnss_synchro_iter->second.d_TOW_at_current_symbol;
+            double d_ref_PRN_rx_time_ms = gnss_synchro_iter->second.Prn_timestamp_ms;
+
+            // Now compute RX time differences due to the PRN alignment in the correlators
+            double traveltime_ms;
+            double pseudorange_m;
+            double delta_rx_time_ms;
+            for(gnss_synchro_iter = valid_synchro.begin(); gnss_synchro_iter != valid_synchro.end(); gnss_synchro_iter++)
+            {
+            	// compute the required symbol history shift in order to match the reference symbol
+            	delta_rx_time_ms = gnss_synchro_iter->second.Prn_timestamp_ms - d_ref_PRN_rx_time_ms;
+            	//compute the pseudorange
+            	traveltime_ms = (d_TOW_reference-gnss_synchro_iter->second.d_TOW_at_current_symbol)*1000.0 + delta_rx_time_ms + GPS_STARTOFFSET_ms;
+            	pseudorange_m = traveltime_ms * GPS_C_m_ms; // [m]
+                // update the pseudorange object
+                current_gnss_synchro[gnss_synchro_iter->second.Channel_ID] = gnss_synchro_iter->second;
+                current_gnss_synchro[gnss_synchro_iter->second.Channel_ID].Pseudorange_m = pseudorange_m;
+                current_gnss_synchro[gnss_synchro_iter->second.Channel_ID].Flag_valid_pseudorange = true;
+                current_gnss_synchro[gnss_synchro_iter->second.Channel_ID].d_TOW_at_current_symbol = round(d_TOW_reference*1000)/1000 + GPS_STARTOFFSET_ms/1000.0;
+            }
+        }
+}
+
+
 int gps_l1_ca_observables_cc::general_work (int noutput_items, gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items,	gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
     Gnss_Synchro **in = (Gnss_Synchro **)  &input_items[0];   // Get the input pointer
     Gnss_Synchro **out = (Gnss_Synchro **)  &output_items[0]; // Get the output pointer
 
     Gnss_Synchro current_gnss_synchro[d_nchannels];
     std::map<int,Gnss_Synchro> current_gnss_synchro_map;
-    std::map<int,Gnss_Synchro>::iterator gnss_synchro_iter;
 
     d_sample_counter++; //count for the processed samples
+    // Measurements are only delivered at the epochs whose receiver TOW, rounded to ms, is a
+    // multiple of d_output_rate_ms, so that the outputs fall on the GNSS time grid whatever
+    // the epoch the receiver started at. The receiver TOW is the most recent symbol TOW of
+    // the channels with a valid word (the reference of the pseudoranges). Before the first
+    // valid word there is no TOW, and the epoch counter is used instead. Intermediate epochs
+    // are consumed without being computed, unless the full rate dump is enabled.
+    bool valid_tow = false;
+    double rx_tow_s = 0.0;
+    for (unsigned int i = 0; i < d_nchannels; i++)
+        {
+            if (in[i][0].Flag_valid_word and (valid_tow == false or in[i][0].d_TOW_at_current_symbol > rx_tow_s))
+                {
+                    rx_tow_s = in[i][0].d_TOW_at_current_symbol;
+                    valid_tow = true;
+                }
+        }
+    bool output_epoch;
+    if (valid_tow)
+        {
+            output_epoch = (static_cast<long long int>(round(rx_tow_s * 1000.0)) % d_output_rate_ms) == 0;
+        }
+    else
+        {
+            output_epoch = (d_sample_counter % d_output_rate_ms) == 0;
+        }
+    if ((output_epoch == false) and (d_dump == false))
+        {
+            consume_each(1);
+            return 0;
+        }
     /*
      * 1. Read the GNSS SYNCHRO objects from available channels
      */
@@ -135,64 +217,27 @@ int gps_l1_ca_observables_cc::general_work (int noutput_items, gr_vector_int &ni
     /*
      * 2. Compute RAW pseudoranges using COMMON RECEPTION TIME algorithm. Use only the valid channels (channels that are tracking a satellite)
      */
-    if(current_gnss_synchro_map.size() > 0)
-        {
-            /*
-             *  2.1 Use CURRENT set of measurements and find the nearest satellite
-             *  common RX time algorithm
-             */
-            // what is the most recent symbol TOW in the current set? -> this will be the reference symbol
-            gnss_synchro_iter = max_element(current_gnss_synchro_map.begin(), current_gnss_synchro_map.end(), pairCompare_gnss_synchro_d_TOW_at_current_symbol);
-            double d_TOW_reference = gnss_synchro_iter->second.d_TOW_at_current_symbol;
-            double d_ref_PRN_rx_time_ms = gnss_synchro_iter->second.Prn_timestamp_ms;
-            //int reference_channel= gnss_synchro_iter->second.Channel_ID;
-
-            // Now compute RX time differences due to the PRN alignment in the correlators
-            double traveltime_ms;
-            double pseudorange_m;
-            double delta_rx_time_ms;
-            for(gnss_synchro_iter = current_gnss_synchro_map.begin(); gnss_synchro_iter != current_gnss_synchro_map.end(); gnss_synchro_iter++)
-            {
-            	// compute the required symbol history shift in order to match the reference symbol
-            	delta_rx_time_ms = gnss_synchro_iter->second.Prn_timestamp_ms - d_ref_PRN_rx_time_ms;
-            	//compute the pseudorange
-            	traveltime_ms = (d_TOW_reference-gnss_synchro_iter->second.d_TOW_at_current_symbol)*1000.0 + delta_rx_time_ms + GPS_STARTOFFSET_ms;
-            	pseudorange_m = traveltime_ms * GPS_C_m_ms; // [m]
-                // update the pseudorange object
-                current_gnss_synchro[gnss_synchro_iter->second.Channel_ID] = gnss_synchro_iter->second;
-                current_gnss_synchro[gnss_synchro_iter->second.Channel_ID].Pseudorange_m = pseudorange_m;
-                current_gnss_synchro[gnss_synchro_iter->second.Channel_ID].Flag_valid_pseudorange = true;
-                current_gnss_synchro[gnss_synchro_iter->second.Channel_ID].d_TOW_at_current_symbol = round(d_TOW_reference*1000)/1000 + GPS_STARTOFFSET_ms/1000.0;
-            }
-        }
+    gps_l1_ca_compute_pseudoranges(current_gnss_synchro_map, current_gnss_synchro);
 
     if(d_dump == true)
         {
             // MULTIPLEXED FILE RECORDING - Record results to file
-            try
-            {
-                    double tmp_double;
-                    for (unsigned int i = 0; i < d_nchannels; i++)
-                        {
-                            tmp_double = current_gnss_synchro[i].d_TOW_at_current_symbol;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = current_gnss_synchro[i].Prn_timestamp_ms;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = current_gnss_synchro[i].Pseudorange_m;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = (double)(current_gnss_synchro[i].Flag_valid_pseudorange==true);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = current_gnss_synchro[i].PRN;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                        }
-            }
-            catch (const std::ifstream::failure& e)
-            {
-                    LOG(WARNING) << "Exception writing observables dump file " << e.what() << std::endl;
-            }
+            for (unsigned int i = 0; i < d_nchannels; i++)
+                {
+                    d_dump_file.put<double>(current_gnss_synchro[i].d_TOW_at_current_symbol);
+                    d_dump_file.put<double>(current_gnss_synchro[i].Prn_timestamp_ms);
+                    d_dump_file.put<double>(current_gnss_synchro[i].Pseudorange_m);
+                    d_dump_file.put<double>(current_gnss_synchro[i].Flag_valid_pseudorange == true ? 1.0 : 0.0);
+                    d_dump_file.put<double>(current_gnss_synchro[i].PRN);
+                }
+            d_dump_file.end_record();
         }
 
     consume_each(1); //one by one
+    if (output_epoch == false)
+        {
+            return 0;
+        }
     for (unsigned int i = 0; i < d_nchannels; i++)
         {
             *out[i] = current_gnss_synchro[i];
@@ -32,6 +32,7 @@
 #define	GNSS_SDR_GPS_L1_CA_OBSERVABLES_CC_H
 
 #include <fstream>
+#include <map>
 #include <queue>
 #include <string>
 #include <utility>
@@ -43,7 +44,9 @@
 #include "gps_navigation_message.h"
 #include "rinex_printer.h"
 #include "GPS_L1_CA.h"
+#include "gnss_dump_writer.h"
 #include "gnss_synchro.h"
+#include "gnss_block_counters.h"
 
 class gps_l1_ca_observables_cc;
 
@@ -52,6 +55,12 @@ typedef boost::shared_ptr<gps_l1_ca_observables_cc> gps_l1_ca_observables_cc_spt
 gps_l1_ca_observables_cc_sptr
 gps_l1_ca_make_observables_cc(unsigned int n_channels, boost::shared_ptr<gr::msg_queue> queue, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging);
 
+/*!
+ * \brief Computes the pseudoranges of the channels in \p valid_synchro (key: channel ID)
+ * with the common reception time algorithm, into \p current_gnss_synchro (indexed by channel ID)
+ */
+void gps_l1_ca_compute_pseudoranges(const std::map<int, Gnss_Synchro>& valid_synchro, Gnss_Synchro* current_gnss_synchro);
+
 /*!
  * \brief This class implements a block that computes GPS L1 C/A observables
  */
@@ -77,7 +86,8 @@ private:
     unsigned long int d_fs_in;
     int d_output_rate_ms;
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Gnss_Dump_Writer d_dump_file;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 };
 
 #endif
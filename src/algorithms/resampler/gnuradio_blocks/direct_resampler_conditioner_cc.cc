@@ -59,6 +59,7 @@ direct_resampler_conditioner_cc::direct_resampler_conditioner_cc(
                             d_sample_freq_out(sample_freq_out), d_phase(0), d_lphase(0),
                             d_history(1)
 {
+    d_counters = gnss_block_counters(this);
     // Computes the phase step multiplying the resampling ratio by 2^32 = 4294967296
     const double two_32 = 4294967296.0;
     if (d_sample_freq_in >= d_sample_freq_out)
@@ -101,6 +102,7 @@ int direct_resampler_conditioner_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
     const gr_complex *in = (const gr_complex *)input_items[0];
     gr_complex *out = (gr_complex *)output_items[0];
 
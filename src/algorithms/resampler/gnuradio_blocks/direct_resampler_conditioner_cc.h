@@ -40,6 +40,7 @@
 #define	GNSS_SDR_DIRECT_RESAMPLER_CONDITIONER_CC_H
 
 #include <gnuradio/block.h>
+#include "gnss_block_counters.h"
 
 class direct_resampler_conditioner_cc;
 typedef boost::shared_ptr<direct_resampler_conditioner_cc> direct_resampler_conditioner_cc_sptr;
@@ -66,6 +67,7 @@ private:
     unsigned int d_history;
     direct_resampler_conditioner_cc(double sample_freq_in,
             double sample_freq_out);
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
     ~direct_resampler_conditioner_cc();
@@ -56,6 +56,7 @@ direct_resampler_conditioner_ss::direct_resampler_conditioner_ss(
             d_sample_freq_in(sample_freq_in), d_sample_freq_out(
                     sample_freq_out), d_phase(0), d_lphase(0), d_history(1)
 {
+    d_counters = gnss_block_counters(this);
     const double two_32 = 4294967296.0;
     // Computes the phase step multiplying the resampling ratio by 2^32 = 4294967296
     if (d_sample_freq_in >= d_sample_freq_out)
@@ -94,6 +95,7 @@ int direct_resampler_conditioner_ss::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
 
     const signed short *in = (const signed short *)input_items[0];
     signed short *out = (signed short *)output_items[0];
@@ -33,6 +33,7 @@
 #define	GNSS_SDR_DIRECT_RESAMPLER_CONDITIONER_SS_H
 
 #include <gnuradio/block.h>
+#include "gnss_block_counters.h"
 
 class direct_resampler_conditioner_ss;
 typedef boost::shared_ptr<direct_resampler_conditioner_ss>
@@ -64,6 +65,7 @@ private:
 
     direct_resampler_conditioner_ss(double sample_freq_in,
             double sample_freq_out);
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
 
@@ -78,6 +78,7 @@ signal_generator_c::signal_generator_c (std::vector<std::string> signal1, std::v
                   vector_length_(vector_length),
                   BW_BB_(BW_BB * static_cast<float>(fs_in) / 2.0)
 {
+    d_counters = gnss_block_counters(this);
     init();
     generate_codes();
 }
@@ -253,6 +254,7 @@ int signal_generator_c::general_work (int noutput_items,
 gr_vector_const_void_star &input_items,
 gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get());
     gr_complex *out = (gr_complex *) output_items[0];
 
     work_counter_++;
@@ -37,6 +37,7 @@
 #include <gnuradio/random.h>
 #include <gnuradio/block.h>
 #include "gnss_signal.h"
+#include "gnss_block_counters.h"
 
 class signal_generator_c;
 
@@ -122,6 +123,7 @@ private:
     gr_complex* complex_phase_;
 
     unsigned int work_counter_;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 
 public:
     ~signal_generator_c ();	// public destructor
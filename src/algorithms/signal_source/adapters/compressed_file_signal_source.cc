@@ -0,0 +1,230 @@
+/*!
+ * \file compressed_file_signal_source.cc
+ * \brief Implementation of a class that reads signal samples from a zstd
+ * or LZ4 compressed file and adapts it to a SignalSourceInterface
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "compressed_file_signal_source.h"
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "compressed_file_sink.h"
+#include "configuration_interface.h"
+
+using google::LogMessage;
+
+DECLARE_string(signal_source);
+
+
+CompressedFileSignalSource::CompressedFileSignalSource(ConfigurationInterface* configuration,
+        std::string role, unsigned int in_streams, unsigned int out_streams,
+        boost::shared_ptr<gr::msg_queue> queue) :
+                role_(role), in_streams_(in_streams), out_streams_(out_streams), queue_(queue)
+{
+    std::string default_filename = "./example_capture.dat.zst";
+    std::string default_item_type = "short";
+    std::string default_dump_filename = "./my_capture.dat";
+
+    samples_ = configuration->property(role + ".samples", 0);
+    sampling_frequency_ = configuration->property(role + ".sampling_frequency", 0);
+    seek_s_ = configuration->property(role + ".seek_s", 0.0);
+    filename_ = configuration->property(role + ".filename", default_filename);
+
+    // override value with commandline flag, if present
+    if (FLAGS_signal_source.compare("-") != 0) filename_= FLAGS_signal_source;
+
+    compression_ = configuration->property(role + ".compression", std::string("auto"));
+    decompression_threads_ = configuration->property(role + ".decompression_threads", 0u);
+    read_ahead_frames_ = configuration->property(role + ".read_ahead_frames", 8u);
+    item_type_ = configuration->property(role + ".item_type", default_item_type);
+    repeat_ = configuration->property(role + ".repeat", false);
+    dump_ = configuration->property(role + ".dump", false);
+    dump_filename_ = configuration->property(role + ".dump_filename", default_dump_filename);
+    dump_compression_ = configuration->property(role + ".dump_compression", std::string("none"));
+    enable_throttle_control_ = configuration->property(role + ".enable_throttle_control", false);
+    std::string s = "InputFilter";
+    double IF = configuration->property(s + ".IF", 0.0);
+
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            item_size_ = sizeof(gr_complex);
+        }
+    else if (item_type_.compare("float") == 0)
+        {
+            item_size_ = sizeof(float);
+        }
+    else if (item_type_.compare("short") == 0)
+        {
+            item_size_ = sizeof(short int);
+        }
+    else if (item_type_.compare("byte") == 0)
+        {
+            item_size_ = sizeof(char);
+        }
+    else
+        {
+            LOG(WARNING) << item_type_
+                    << " unrecognized item type. Using gr_complex.";
+            item_size_ = sizeof(gr_complex);
+        }
+
+    // if IF < BW/2, the samples are complex: two items per sample unless they are gr_complex
+    unsigned int items_per_sample = 1;
+    if ((item_type_.compare("gr_complex") != 0) && (IF < 1e6))
+        {
+            items_per_sample = 2;
+        }
+    first_item_ = 0;
+    if (seek_s_ > 0.0)
+        {
+            first_item_ = static_cast<unsigned long long>(std::round(seek_s_ * static_cast<double>(sampling_frequency_))) * items_per_sample;
+        }
+
+    try
+    {
+            file_source_ = make_compressed_file_source(item_size_, filename_, compression_, decompression_threads_,
+                    read_ahead_frames_, first_item_, samples_, repeat_, queue_);
+    }
+    catch (const std::exception &e)
+    {
+            std::cerr
+            << "The receiver was configured to work with a compressed file signal source "
+            << std::endl
+            << "but the specified file is unreachable by GNSS-SDR, or its compression is not supported."
+            << std::endl
+            <<  "Please modify your configuration file"
+            << std::endl
+            <<  "and point SignalSource.filename to a valid zstd (.zst) or LZ4 (.lz4) file. Then:"
+            << std::endl
+            << "$ gnss-sdr --config_file=/path/to/my_GNSS_SDR_configuration.conf"
+            << std::endl;
+            LOG(INFO) << "compressed_file_signal_source: Unable to open the samples file "
+                      << filename_.c_str() << ", exiting the program.";
+            throw;
+    }
+    DLOG(INFO) << "compressed_file_source(" << file_source_->unique_id() << ")";
+
+    // the decompressed size of the file is not known in advance
+    std::cout << "Processing file " << filename_ << ", compressed with " << file_source_->compression() << std::endl;
+    if (samples_ > 0)
+        {
+            double signal_duration_s = static_cast<double>(samples_) / static_cast<double>(items_per_sample) / static_cast<double>(sampling_frequency_);
+            DLOG(INFO) << "Total number samples to be processed= " << samples_ << " GNSS signal duration= " << signal_duration_s << " [s]";
+            std::cout << "GNSS signal recorded time to be processed: " << signal_duration_s << " [s], starting at " << seek_s_ << " [s]" << std::endl;
+        }
+
+    if (dump_)
+        {
+            sink_ = make_signal_source_dump_sink(item_size_, dump_filename_, dump_compression_,
+                    configuration->property(role + ".dump_compression_level", 0));
+            DLOG(INFO) << "file_sink(" << sink_->unique_id() << ")";
+        }
+
+    if (enable_throttle_control_)
+        {
+            throttle_ = gr::blocks::throttle::make(item_size_, sampling_frequency_);
+        }
+    DLOG(INFO) << "File source filename " << filename_;
+    DLOG(INFO) << "Samples " << samples_;
+    DLOG(INFO) << "First item " << first_item_;
+    DLOG(INFO) << "Sampling frequency " << sampling_frequency_;
+    DLOG(INFO) << "Compression " << compression_;
+    DLOG(INFO) << "Decompression threads " << decompression_threads_;
+    DLOG(INFO) << "Item type " << item_type_;
+    DLOG(INFO) << "Item size " << item_size_;
+    DLOG(INFO) << "Repeat " << repeat_;
+    DLOG(INFO) << "Dump " << dump_;
+    DLOG(INFO) << "Dump filename " << dump_filename_;
+    DLOG(INFO) << "Dump compression " << dump_compression_;
+}
+
+
+
+
+CompressedFileSignalSource::~CompressedFileSignalSource()
+{}
+
+
+
+
+void CompressedFileSignalSource::connect(gr::top_block_sptr top_block)
+{
+    if (enable_throttle_control_ == true)
+        {
+            top_block->connect(file_source_, 0, throttle_, 0);
+            DLOG(INFO) << "connected file source to throttle";
+        }
+    if (dump_)
+        {
+            top_block->connect(get_right_block(), 0, sink_, 0);
+            DLOG(INFO) << "connected file source to file sink";
+        }
+}
+
+
+
+
+void CompressedFileSignalSource::disconnect(gr::top_block_sptr top_block)
+{
+    if (enable_throttle_control_ == true)
+        {
+            top_block->disconnect(file_source_, 0, throttle_, 0);
+            DLOG(INFO) << "disconnected file source to throttle";
+        }
+    if (dump_)
+        {
+            top_block->disconnect(get_right_block(), 0, sink_, 0);
+            DLOG(INFO) << "disconnected file source to file sink";
+        }
+}
+
+
+
+
+gr::basic_block_sptr CompressedFileSignalSource::get_left_block()
+{
+    LOG(WARNING) << "Left block of a signal source should not be retrieved";
+    return compressed_file_source_sptr();
+}
+
+
+
+
+gr::basic_block_sptr CompressedFileSignalSource::get_right_block()
+{
+    if (enable_throttle_control_ == true)
+        {
+            return throttle_;
+        }
+    else
+        {
+            return file_source_;
+        }
+}
@@ -0,0 +1,136 @@
+/*!
+ * \file compressed_file_signal_source.h
+ * \brief Interface of a class that reads signal samples from a zstd or
+ * LZ4 compressed file and adapts it to a SignalSourceInterface
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_COMPRESSED_FILE_SIGNAL_SOURCE_H_
+#define GNSS_SDR_COMPRESSED_FILE_SIGNAL_SOURCE_H_
+
+#include <string>
+#include <gnuradio/blocks/throttle.h>
+#include <gnuradio/msg_queue.h>
+#include "gnss_block_interface.h"
+#include "compressed_file_source.h"
+
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Class that reads signal samples from a zstd or LZ4 compressed
+ * file and adapts it to a SignalSourceInterface.
+ *
+ * It accepts the options of Mmap_File_Signal_Source, plus compression
+ * (zstd, lz4, or auto to guess it from the extension of the file),
+ * decompression_threads (0 = one per core) and read_ahead_frames, the
+ * number of frames decompressed ahead of the receiver. The source block
+ * stops the receiver by itself, so there is no valve after it.
+ */
+class CompressedFileSignalSource: public GNSSBlockInterface
+{
+public:
+    CompressedFileSignalSource(ConfigurationInterface* configuration, std::string role,
+            unsigned int in_streams, unsigned int out_streams,
+            boost::shared_ptr<gr::msg_queue> queue);
+
+    virtual ~CompressedFileSignalSource();
+    std::string role()
+    {
+        return role_;
+    }
+
+    /*!
+     * \brief Returns "Compressed_File_Signal_Source".
+     */
+    std::string implementation()
+    {
+        return "Compressed_File_Signal_Source";
+    }
+    size_t item_size()
+    {
+        return item_size_;
+    }
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+    std::string filename()
+    {
+        return filename_;
+    }
+    std::string item_type()
+    {
+        return item_type_;
+    }
+    std::string compression()
+    {
+        return compression_;
+    }
+    bool repeat()
+    {
+        return repeat_;
+    }
+    long sampling_frequency()
+    {
+        return sampling_frequency_;
+    }
+    long samples()
+    {
+        return samples_;
+    }
+    unsigned long long first_item()
+    {
+        return first_item_;
+    }
+
+private:
+    unsigned long long samples_;
+    long sampling_frequency_;
+    double seek_s_;
+    unsigned long long first_item_;
+    std::string filename_;
+    std::string item_type_;
+    std::string compression_;
+    unsigned int decompression_threads_;
+    unsigned int read_ahead_frames_;
+    bool repeat_;
+    bool dump_;
+    std::string dump_filename_;
+    std::string dump_compression_;
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+    compressed_file_source_sptr file_source_;
+    gr::basic_block_sptr sink_;
+    gr::blocks::throttle::sptr throttle_;
+    boost::shared_ptr<gr::msg_queue> queue_;
+    size_t item_size_;
+    // Throttle control
+    bool enable_throttle_control_;
+};
+
+#endif /*GNSS_SDR_COMPRESSED_FILE_SIGNAL_SOURCE_H_*/
@@ -39,6 +39,7 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include "gnss_sdr_valve.h"
+#include "compressed_file_sink.h"
 #include "configuration_interface.h"
 
 using google::LogMessage;
@@ -68,6 +69,7 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
     repeat_ = configuration->property(role + ".repeat", false);
     dump_ = configuration->property(role + ".dump", false);
     dump_filename_ = configuration->property(role + ".dump_filename", default_dump_filename);
+    dump_compression_ = configuration->property(role + ".dump_compression", std::string("none"));
     enable_throttle_control_ = configuration->property(role + ".enable_throttle_control", false);
     std::string s = "InputFilter";
     double IF = configuration->property(s + ".IF", 0.0);
@@ -185,7 +187,8 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
 
     if (dump_)
         {
-            sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
+            sink_ = make_signal_source_dump_sink(item_size_, dump_filename_, dump_compression_,
+                    configuration->property(role + ".dump_compression_level", 0));
             DLOG(INFO) << "file_sink(" << sink_->unique_id() << ")";
         }
 
@@ -202,6 +205,7 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
     DLOG(INFO) << "Repeat " << repeat_;
     DLOG(INFO) << "Dump " << dump_;
     DLOG(INFO) << "Dump filename " << dump_filename_;
+    DLOG(INFO) << "Dump compression " << dump_compression_;
 }
 
 
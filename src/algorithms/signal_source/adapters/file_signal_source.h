@@ -37,7 +37,6 @@
 
 #include <string>
 #include <gnuradio/blocks/file_source.h>
-#include <gnuradio/blocks/file_sink.h>
 #include <gnuradio/blocks/throttle.h>
 #include <gnuradio/hier_block2.h>
 #include <gnuradio/msg_queue.h>
@@ -107,12 +106,13 @@ private:
     bool repeat_;
     bool dump_;
     std::string dump_filename_;
+    std::string dump_compression_;
     std::string role_;
     unsigned int in_streams_;
     unsigned int out_streams_;
     gr::blocks::file_source::sptr file_source_;
     boost::shared_ptr<gr::block> valve_;
-    gr::blocks::file_sink::sptr sink_;
+    gr::basic_block_sptr sink_;
     gr::blocks::throttle::sptr  throttle_;
     boost::shared_ptr<gr::msg_queue> queue_;
     size_t item_size_;
@@ -0,0 +1,240 @@
+/*!
+ * \file multi_file_signal_source.cc
+ * \brief Implementation of a class that reads signal samples from a
+ * sequence of files and adapts it to a SignalSourceInterface
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "multi_file_signal_source.h"
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "compressed_file_sink.h"
+#include "configuration_interface.h"
+#include "gnss_sdr_valve.h"
+
+using google::LogMessage;
+
+DECLARE_string(signal_source);
+
+
+MultiFileSignalSource::MultiFileSignalSource(ConfigurationInterface* configuration,
+        std::string role, unsigned int in_streams, unsigned int out_streams,
+        boost::shared_ptr<gr::msg_queue> queue) :
+                role_(role), in_streams_(in_streams), out_streams_(out_streams), queue_(queue)
+{
+    std::string default_filename = "./example_capture.dat";
+    std::string default_item_type = "short";
+    std::string default_dump_filename = "./my_capture.dat";
+
+    samples_ = configuration->property(role + ".samples", 0);
+    sampling_frequency_ = configuration->property(role + ".sampling_frequency", 0);
+    std::string filename = configuration->property(role + ".filename", default_filename);
+    std::string filenames = configuration->property(role + ".filenames", filename);
+
+    // override value with commandline flag, if present
+    if (FLAGS_signal_source.compare("-") != 0) filenames = FLAGS_signal_source;
+
+    item_type_ = configuration->property(role + ".item_type", default_item_type);
+    repeat_ = configuration->property(role + ".repeat", false);
+    unsigned int read_ahead_blocks = configuration->property(role + ".read_ahead_blocks", 4u);
+    dump_ = configuration->property(role + ".dump", false);
+    dump_filename_ = configuration->property(role + ".dump_filename", default_dump_filename);
+    dump_compression_ = configuration->property(role + ".dump_compression", std::string("none"));
+    enable_throttle_control_ = configuration->property(role + ".enable_throttle_control", false);
+    std::string s = "InputFilter";
+    double IF = configuration->property(s + ".IF", 0.0);
+
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            item_size_ = sizeof(gr_complex);
+        }
+    else if (item_type_.compare("float") == 0)
+        {
+            item_size_ = sizeof(float);
+        }
+    else if (item_type_.compare("short") == 0)
+        {
+            item_size_ = sizeof(short int);
+        }
+    else if (item_type_.compare("byte") == 0)
+        {
+            item_size_ = sizeof(char);
+        }
+    else
+        {
+            LOG(WARNING) << item_type_
+                    << " unrecognized item type. Using gr_complex.";
+            item_size_ = sizeof(gr_complex);
+        }
+
+    filenames_ = Sample_File_Sequence::expand(filenames);
+    try
+    {
+            file_source_ = make_multi_file_source(item_size_, filenames_, read_ahead_blocks, repeat_, queue_);
+    }
+    catch (const std::exception &e)
+    {
+            std::cerr
+            << "The receiver was configured to work with a multi-file signal source "
+            << std::endl
+            << "but some of the specified files are unreachable by GNSS-SDR."
+            << std::endl
+            <<  "Please modify your configuration file"
+            << std::endl
+            <<  "and point SignalSource.filenames to valid raw data files. Then:"
+            << std::endl
+            << "$ gnss-sdr --config_file=/path/to/my_GNSS_SDR_configuration.conf"
+            << std::endl;
+            LOG(INFO) << "multi_file_signal_source: Unable to open the samples files "
+                      << filenames << ", exiting the program.";
+            throw;
+    }
+    DLOG(INFO) << "multi_file_source(" << file_source_->unique_id() << ")";
+
+    std::cout << std::setprecision(16);
+    std::cout << "Processing " << filenames_.size() << " files, which contain "
+              << file_source_->total_items() * item_size_ << " [bytes]" << std::endl;
+    if (samples_ == 0) // read all the files
+        {
+            // excluding the last 2 ms, as FileSignalSource does
+            double margin = std::ceil(0.002 * static_cast<double>(sampling_frequency_));
+            if (static_cast<double>(file_source_->total_items()) > margin)
+                {
+                    samples_ = file_source_->total_items() - static_cast<unsigned long long>(margin);
+                }
+        }
+
+    CHECK(samples_ > 0) << "Files do not contain enough samples to process.";
+    double signal_duration_s = static_cast<double>(samples_) / static_cast<double>(sampling_frequency_);
+    if ((item_type_.compare("gr_complex") != 0) && (IF < 1e6))  // if IF < BW/2, signal is complex (interleaved)
+        {
+            signal_duration_s /= 2;
+        }
+    DLOG(INFO) << "Total number samples to be processed= " << samples_ << " GNSS signal duration= " << signal_duration_s << " [s]";
+    std::cout << "GNSS signal recorded time to be processed: " << signal_duration_s << " [s]" << std::endl;
+
+    valve_ = gnss_sdr_make_valve(item_size_, samples_, queue_);
+    DLOG(INFO) << "valve(" << valve_->unique_id() << ")";
+
+    if (dump_)
+        {
+            sink_ = make_signal_source_dump_sink(item_size_, dump_filename_, dump_compression_,
+                    configuration->property(role + ".dump_compression_level", 0));
+            DLOG(INFO) << "file_sink(" << sink_->unique_id() << ")";
+        }
+
+    if (enable_throttle_control_)
+        {
+            throttle_ = gr::blocks::throttle::make(item_size_, sampling_frequency_);
+        }
+    for (unsigned int i = 0; i < filenames_.size(); i++)
+        {
+            DLOG(INFO) << "File source filename " << filenames_[i];
+        }
+    DLOG(INFO) << "Samples " << samples_;
+    DLOG(INFO) << "Sampling frequency " << sampling_frequency_;
+    DLOG(INFO) << "Item type " << item_type_;
+    DLOG(INFO) << "Item size " << item_size_;
+    DLOG(INFO) << "Repeat " << repeat_;
+    DLOG(INFO) << "Dump " << dump_;
+    DLOG(INFO) << "Dump filename " << dump_filename_;
+    DLOG(INFO) << "Dump compression " << dump_compression_;
+}
+
+
+
+
+MultiFileSignalSource::~MultiFileSignalSource()
+{}
+
+
+
+
+void MultiFileSignalSource::connect(gr::top_block_sptr top_block)
+{
+    if (enable_throttle_control_ == true)
+        {
+            top_block->connect(file_source_, 0, throttle_, 0);
+            DLOG(INFO) << "connected file source to throttle";
+            top_block->connect(throttle_, 0, valve_, 0);
+            DLOG(INFO) << "connected throttle to valve";
+        }
+    else
+        {
+            top_block->connect(file_source_, 0, valve_, 0);
+            DLOG(INFO) << "connected file source to valve";
+        }
+    if (dump_)
+        {
+            top_block->connect(valve_, 0, sink_, 0);
+            DLOG(INFO) << "connected valve to file sink";
+        }
+}
+
+
+
+
+void MultiFileSignalSource::disconnect(gr::top_block_sptr top_block)
+{
+    if (enable_throttle_control_ == true)
+        {
+            top_block->disconnect(file_source_, 0, throttle_, 0);
+            DLOG(INFO) << "disconnected file source to throttle";
+            top_block->disconnect(throttle_, 0, valve_, 0);
+            DLOG(INFO) << "disconnected throttle to valve";
+        }
+    else
+        {
+            top_block->disconnect(file_source_, 0, valve_, 0);
+            DLOG(INFO) << "disconnected file source to valve";
+        }
+    if (dump_)
+        {
+            top_block->disconnect(valve_, 0, sink_, 0);
+            DLOG(INFO) << "disconnected valve to file sink";
+        }
+}
+
+
+
+
+gr::basic_block_sptr MultiFileSignalSource::get_left_block()
+{
+    LOG(WARNING) << "Left block of a signal source should not be retrieved";
+    return multi_file_source_sptr();
+}
+
+
+
+
+gr::basic_block_sptr MultiFileSignalSource::get_right_block()
+{
+    return valve_;
+}
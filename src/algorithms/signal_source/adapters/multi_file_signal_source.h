@@ -0,0 +1,125 @@
+/*!
+ * \file multi_file_signal_source.h
+ * \brief Interface of a class that reads signal samples from a sequence
+ * of files and adapts it to a SignalSourceInterface
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MULTI_FILE_SIGNAL_SOURCE_H_
+#define GNSS_SDR_MULTI_FILE_SIGNAL_SOURCE_H_
+
+#include <string>
+#include <vector>
+#include <gnuradio/blocks/throttle.h>
+#include <gnuradio/msg_queue.h>
+#include "gnss_block_interface.h"
+#include "multi_file_source.h"
+
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Class that reads signal samples from a recording split in several
+ * files and adapts it to a SignalSourceInterface.
+ *
+ * The files are given by the option filenames, a list separated by commas
+ * or spaces whose entries may have wildcards (or by filename, if
+ * filenames is not set), and are processed as a single capture: samples
+ * counts the samples of all of them, and 0 means all the files. The other
+ * options are those of File_Signal_Source.
+ */
+class MultiFileSignalSource: public GNSSBlockInterface
+{
+public:
+    MultiFileSignalSource(ConfigurationInterface* configuration, std::string role,
+            unsigned int in_streams, unsigned int out_streams,
+            boost::shared_ptr<gr::msg_queue> queue);
+
+    virtual ~MultiFileSignalSource();
+    std::string role()
+    {
+        return role_;
+    }
+
+    /*!
+     * \brief Returns "Multi_File_Signal_Source".
+     */
+    std::string implementation()
+    {
+        return "Multi_File_Signal_Source";
+    }
+    size_t item_size()
+    {
+        return item_size_;
+    }
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+    std::vector<std::string> filenames()
+    {
+        return filenames_;
+    }
+    std::string item_type()
+    {
+        return item_type_;
+    }
+    bool repeat()
+    {
+        return repeat_;
+    }
+    long sampling_frequency()
+    {
+        return sampling_frequency_;
+    }
+    long samples()
+    {
+        return samples_;
+    }
+
+private:
+    unsigned long long samples_;
+    long sampling_frequency_;
+    std::vector<std::string> filenames_;
+    std::string item_type_;
+    bool repeat_;
+    bool dump_;
+    std::string dump_filename_;
+    std::string dump_compression_;
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+    multi_file_source_sptr file_source_;
+    boost::shared_ptr<gr::block> valve_;
+    gr::basic_block_sptr sink_;
+    gr::blocks::throttle::sptr throttle_;
+    boost::shared_ptr<gr::msg_queue> queue_;
+    size_t item_size_;
+    // Throttle control
+    bool enable_throttle_control_;
+};
+
+#endif /*GNSS_SDR_MULTI_FILE_SIGNAL_SOURCE_H_*/
@@ -82,7 +82,9 @@ NsrFileSignalSource::NsrFileSignalSource(ConfigurationInterface* configuration,
     try
     {
             file_source_ = gr::blocks::file_source::make(item_size_, filename_.c_str(), repeat_);
-            unpack_byte_ = make_unpack_byte_2bit_samples();
+            // 4 real 2-bit two's complement samples per byte, the first one in the lowest bits
+            Packed_Sample_Format nsr_format;
+            unpack_byte_ = make_unpack_packed_samples(nsr_format, "float");
 
     }
     catch (const std::exception &e)
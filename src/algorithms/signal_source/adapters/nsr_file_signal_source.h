@@ -42,7 +42,7 @@
 #include <gnuradio/hier_block2.h>
 #include <gnuradio/msg_queue.h>
 #include "gnss_block_interface.h"
-#include "unpack_byte_2bit_samples.h"
+#include "unpack_packed_samples.h"
 
 
 class ConfigurationInterface;
@@ -112,7 +112,7 @@ private:
     unsigned int in_streams_;
     unsigned int out_streams_;
     gr::blocks::file_source::sptr file_source_;
-    unpack_byte_2bit_samples_sptr unpack_byte_;
+    unpack_packed_samples_sptr unpack_byte_;
     boost::shared_ptr<gr::block> valve_;
     gr::blocks::file_sink::sptr sink_;
     gr::blocks::throttle::sptr  throttle_;
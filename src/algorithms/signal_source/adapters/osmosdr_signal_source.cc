@@ -33,7 +33,7 @@
 #include <iostream>
 #include <boost/format.hpp>
 #include <glog/logging.h>
-#include <gnuradio/blocks/file_sink.h>
+#include "compressed_file_sink.h"
 #include "configuration_interface.h"
 #include "gnss_sdr_valve.h"
 #include "GPS_L1_CA.h"
@@ -56,6 +56,7 @@ OsmosdrSignalSource::OsmosdrSignalSource(ConfigurationInterface* configuration,
     dump_ = configuration->property(role + ".dump", false);
     dump_filename_ = configuration->property(role + ".dump_filename",
             default_dump_file);
+    dump_compression_ = configuration->property(role + ".dump_compression", std::string("none"));
 
     // OSMOSDR Driver parameters
     AGC_enabled_ = configuration->property(role + ".AGC_enabled", true);
@@ -130,7 +131,8 @@ OsmosdrSignalSource::OsmosdrSignalSource(ConfigurationInterface* configuration,
     if (dump_)
         {
             DLOG(INFO) << "Dumping output into file " << dump_filename_;
-            file_sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
+            file_sink_ = make_signal_source_dump_sink(item_size_, dump_filename_, dump_compression_,
+                    configuration->property(role + ".dump_compression_level", 0));
             DLOG(INFO) << "file_sink(" << file_sink_->unique_id() << ")";
         }
 }
@@ -36,7 +36,6 @@
 #include <string>
 #include <boost/shared_ptr.hpp>
 #include <gnuradio/msg_queue.h>
-#include <gnuradio/blocks/file_sink.h>
 #include <osmosdr/source.h>
 #include "gnss_block_interface.h"
 
@@ -98,11 +97,12 @@ private:
     long samples_;
     bool dump_;
     std::string dump_filename_;
+    std::string dump_compression_;
 
     osmosdr::source::sptr osmosdr_source_;
 
     boost::shared_ptr<gr::block> valve_;
-    gr::blocks::file_sink::sptr file_sink_;
+    gr::basic_block_sptr file_sink_;
     boost::shared_ptr<gr::msg_queue> queue_;
 };
 
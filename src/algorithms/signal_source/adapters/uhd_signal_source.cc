@@ -33,6 +33,7 @@
 #include <uhd/types/device_addr.hpp>
 #include <uhd/exception.hpp>
 #include <glog/logging.h>
+#include "compressed_file_sink.h"
 #include "configuration_interface.h"
 #include "gnss_sdr_valve.h"
 #include "GPS_L1_CA.h"
@@ -52,6 +53,7 @@ UhdSignalSource::UhdSignalSource(ConfigurationInterface* configuration,
     samples_ = configuration->property(role + ".samples", 0);
     dump_ = configuration->property(role + ".dump", false);
     dump_filename_ = configuration->property(role + ".dump_filename", default_dump_file);
+    dump_compression_ = configuration->property(role + ".dump_compression", std::string("none"));
 
     // UHD PARAMETERS
     uhd::device_addr_t dev_addr;
@@ -170,8 +172,8 @@ UhdSignalSource::UhdSignalSource(ConfigurationInterface* configuration,
     if (dump_)
         {
             LOG(INFO) << "Dumping output into file " << dump_filename_;
-            //file_sink_ = gr_make_file_sink(item_size_, dump_filename_.c_str());
-            file_sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
+            file_sink_ = make_signal_source_dump_sink(item_size_, dump_filename_, dump_compression_,
+                    configuration->property(role + ".dump_compression_level", 0));
             DLOG(INFO) << "file_sink(" << file_sink_->unique_id() << ")";
         }
 }
@@ -36,7 +36,6 @@
 #include <boost/shared_ptr.hpp>
 #include <gnuradio/hier_block2.h>
 #include <gnuradio/uhd/usrp_source.h>
-#include <gnuradio/blocks/file_sink.h>
 #include <gnuradio/msg_queue.h>
 #include "gnss_block_interface.h"
 
@@ -97,13 +96,13 @@ private:
     long samples_;
     bool dump_;
     std::string dump_filename_;
+    std::string dump_compression_;
 
     //boost::shared_ptr<uhd_usrp_source> uhd_source_;
     gr::uhd::usrp_source::sptr uhd_source_;
 
     boost::shared_ptr<gr::block> valve_;
-    //gr_block_sptr file_sink_;
-    gr::blocks::file_sink::sptr file_sink_;
+    gr::basic_block_sptr file_sink_;
     boost::shared_ptr<gr::msg_queue> queue_;
 };
 
@@ -0,0 +1,103 @@
+/*!
+ * \file compressed_file_sink.cc
+ * \brief GNU Radio sink block that records samples to a zstd or LZ4 compressed file
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "compressed_file_sink.h"
+#include <stdexcept>
+#include <gnuradio/blocks/file_sink.h>
+#include <gnuradio/io_signature.h>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+compressed_file_sink_sptr make_compressed_file_sink(size_t item_size, const std::string& filename,
+        const std::string& compression, int level, unsigned int threads)
+{
+    return compressed_file_sink_sptr(new compressed_file_sink(item_size, filename, compression, level, threads));
+}
+
+
+
+gr::basic_block_sptr make_signal_source_dump_sink(size_t item_size, const std::string& filename,
+        const std::string& compression, int level)
+{
+    if (compression.compare("none") == 0)
+        {
+            return gr::blocks::file_sink::make(item_size, filename.c_str());
+        }
+    if (compression_supported(compression) == false)
+        {
+            LOG(WARNING) << "Compression " << compression << " not supported by this build, recording "
+                         << filename << " uncompressed";
+            return gr::blocks::file_sink::make(item_size, filename.c_str());
+        }
+    LOG(INFO) << "Recording " << filename << " compressed with " << compression;
+    return make_compressed_file_sink(item_size, filename, compression, level, 0);
+}
+
+
+
+compressed_file_sink::compressed_file_sink(size_t item_size, const std::string& filename,
+        const std::string& compression, int level, unsigned int threads) : gr::sync_block("compressed_file_sink",
+                gr::io_signature::make(1, 1, item_size),
+                gr::io_signature::make(0, 0, 0))
+{
+    d_counters = gnss_block_counters(this);
+    if (d_writer.open(filename, compression, level, threads) == false)
+        {
+            throw std::runtime_error("can't create compressed file " + filename);
+        }
+    d_item_size = item_size;
+}
+
+
+
+compressed_file_sink::~compressed_file_sink()
+{
+    d_writer.close();
+}
+
+
+
+bool compressed_file_sink::stop()
+{
+    d_writer.close();
+    return true;
+}
+
+
+
+int compressed_file_sink::work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items)
+{
+    Gnss_Work_Timer work_timer(d_counters.get(), noutput_items);
+    const char* in = static_cast<const char*>(input_items[0]);
+    d_writer.write(in, noutput_items * d_item_size);
+    return noutput_items;
+}
@@ -0,0 +1,85 @@
+/*!
+ * \file compressed_file_sink.h
+ * \brief GNU Radio sink block that records samples to a zstd or LZ4 compressed file
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_COMPRESSED_FILE_SINK_H_
+#define GNSS_SDR_COMPRESSED_FILE_SINK_H_
+
+#include <string>
+#include <gnuradio/sync_block.h>
+#include "compressed_sample_file.h"
+#include "gnss_block_counters.h"
+
+class compressed_file_sink;
+
+typedef boost::shared_ptr<compressed_file_sink> compressed_file_sink_sptr;
+
+/*!
+ * \brief Makes a sink that writes items of \p item_size bytes to
+ * \p filename, compressed with \p compression ("zstd" or "lz4") at
+ * \p level (0 = library default), zstd using \p threads threads of its
+ * own. Throws std::runtime_error if the file cannot be created.
+ */
+compressed_file_sink_sptr make_compressed_file_sink(size_t item_size, const std::string& filename,
+        const std::string& compression, int level, unsigned int threads);
+
+/*!
+ * \brief Makes the dump sink of a signal source: a gr::blocks::file_sink
+ * if \p compression is "none" (or not supported by this build), a
+ * compressed_file_sink otherwise
+ */
+gr::basic_block_sptr make_signal_source_dump_sink(size_t item_size, const std::string& filename,
+        const std::string& compression, int level);
+
+/*!
+ * \brief This class records a stream of items with a Compressed_Sample_Writer.
+ * The file is completed when the flowgraph stops.
+ */
+class compressed_file_sink : public gr::sync_block
+{
+private:
+    friend compressed_file_sink_sptr make_compressed_file_sink(size_t item_size, const std::string& filename,
+            const std::string& compression, int level, unsigned int threads);
+    compressed_file_sink(size_t item_size, const std::string& filename,
+            const std::string& compression, int level, unsigned int threads);
+
+    Compressed_Sample_Writer d_writer;
+    size_t d_item_size;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
+
+public:
+    ~compressed_file_sink();
+
+    bool stop();
+
+    int work(int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif /*GNSS_SDR_COMPRESSED_FILE_SINK_H_*/
@@ -0,0 +1,141 @@
+/*!
+ * \file compressed_file_source.cc
+ * \brief GNU Radio source block that reads the samples of a zstd or LZ4 compressed file
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "compressed_file_source.h"
+#include <algorithm>
+#include <stdexcept>
+#include <gnuradio/io_signature.h>
+#include <glog/logging.h>
+#include "control_message_factory.h"
+
+using google::LogMessage;
+
+compressed_file_source_sptr make_compressed_file_source(size_t item_size, const std::string& filename,
+        const std::string& compression, unsigned int threads, unsigned int ring_frames,
+        unsigned long long first_item, unsigned long long nitems, bool repeat,
+        gr::msg_queue::sptr queue)
+{
+    return compressed_file_source_sptr(new compressed_file_source(item_size, filename, compression,
+            threads, ring_frames, first_item, nitems, repeat, queue));
+}
+
+
+
+compressed_file_source::compressed_file_source(size_t item_size, const std::string& filename,
+        const std::string& compression, unsigned int threads, unsigned int ring_frames,
+        unsigned long long first_item, unsigned long long nitems, bool repeat,
+        gr::msg_queue::sptr queue) : gr::sync_block("compressed_file_source",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(1, 1, item_size))
+{
+    d_counters = gnss_block_counters(this);
+    if (d_file.open(filename, compression, threads, ring_frames) == false)
+        {
+            throw std::runtime_error("can't open compressed file " + filename);
+        }
+    d_item_size = item_size;
+    d_first_item = first_item;
+    d_nitems = nitems;
+    d_produced = 0;
+    d_repeat = repeat;
+    d_done = false;
+    d_queue = queue;
+    if (start_of_items() == false)
+        {
+            LOG(WARNING) << "Start of the samples beyond the end of " << filename << ", starting from the beginning";
+            d_first_item = 0;
+            d_file.rewind();
+        }
+}
+
+
+
+compressed_file_source::~compressed_file_source()
+{}
+
+
+
+// Skips the items before first_item. Returns false if the file ends before
+bool compressed_file_source::start_of_items()
+{
+    unsigned long long nbytes = d_first_item * d_item_size;
+    return d_file.skip(nbytes) == nbytes;
+}
+
+
+
+void compressed_file_source::stop_receiver()
+{
+    if (d_file.failed())
+        {
+            LOG(WARNING) << "Compressed file corrupt or truncated after " << d_produced << " items";
+        }
+    ControlMessageFactory* cmf = new ControlMessageFactory();
+    d_queue->handle(cmf->GetQueueMessage(200, 0));
+    delete cmf;
+    d_done = true;
+}
+
+
+
+int compressed_file_source::work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items)
+{
+    Gnss_Work_Timer work_timer(d_counters.get());
+    if (d_done or (d_nitems > 0 and d_produced >= d_nitems))
+        {
+            if (d_done == false) stop_receiver();
+            return -1;  // Done!
+        }
+    unsigned long long n = noutput_items;
+    if (d_nitems > 0)
+        {
+            n = std::min(n, d_nitems - d_produced);
+        }
+    char* out = static_cast<char*>(output_items[0]);
+    size_t nbytes = d_file.read(out, n * d_item_size);
+    if (nbytes < n * d_item_size and d_repeat == true and d_file.failed() == false)
+        {
+            // a partial item at the end of the file is dropped
+            nbytes -= nbytes % d_item_size;
+            if (d_file.rewind() and start_of_items())
+                {
+                    nbytes += d_file.read(out + nbytes, n * d_item_size - nbytes);
+                }
+        }
+    n = nbytes / d_item_size;
+    if (n == 0)
+        {
+            stop_receiver();
+            return -1;  // Done!
+        }
+    d_produced += n;
+    return n;
+}
@@ -0,0 +1,98 @@
+/*!
+ * \file compressed_file_source.h
+ * \brief GNU Radio source block that reads the samples of a zstd or LZ4 compressed file
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_COMPRESSED_FILE_SOURCE_H_
+#define GNSS_SDR_COMPRESSED_FILE_SOURCE_H_
+
+#include <string>
+#include <gnuradio/msg_queue.h>
+#include <gnuradio/sync_block.h>
+#include "compressed_sample_file.h"
+#include "gnss_block_counters.h"
+
+class compressed_file_source;
+
+typedef boost::shared_ptr<compressed_file_source> compressed_file_source_sptr;
+
+/*!
+ * \brief Makes a source of the items [first_item, first_item + nitems) of
+ * \p filename, compressed with \p compression ("zstd", "lz4" or "auto"),
+ * decompressed by \p threads threads (0 = one per core) at most
+ * \p ring_frames frames ahead. nitems = 0 means up to the end of the file.
+ * Throws std::runtime_error if the file cannot be opened.
+ */
+compressed_file_source_sptr make_compressed_file_source(size_t item_size, const std::string& filename,
+        const std::string& compression, unsigned int threads, unsigned int ring_frames,
+        unsigned long long first_item, unsigned long long nitems, bool repeat,
+        gr::msg_queue::sptr queue);
+
+/*!
+ * \brief This class delivers the decompressed items of a compressed file.
+ *
+ * Like mmap_file_source, it replaces the file_source + valve pair and stops
+ * the receiver by itself after nitems items or at the end of the file. The
+ * size of the decompressed file is not known in advance. With repeat, the
+ * file is decompressed again from first_item once it ends.
+ */
+class compressed_file_source : public gr::sync_block
+{
+private:
+    friend compressed_file_source_sptr make_compressed_file_source(size_t item_size, const std::string& filename,
+            const std::string& compression, unsigned int threads, unsigned int ring_frames,
+            unsigned long long first_item, unsigned long long nitems, bool repeat,
+            gr::msg_queue::sptr queue);
+    compressed_file_source(size_t item_size, const std::string& filename,
+            const std::string& compression, unsigned int threads, unsigned int ring_frames,
+            unsigned long long first_item, unsigned long long nitems, bool repeat,
+            gr::msg_queue::sptr queue);
+
+    bool start_of_items();
+    void stop_receiver();
+
+    Compressed_Sample_File d_file;
+    size_t d_item_size;
+    unsigned long long d_first_item;
+    unsigned long long d_nitems;     // items to deliver, 0 = no limit
+    unsigned long long d_produced;
+    bool d_repeat;
+    bool d_done;
+    gr::msg_queue::sptr d_queue;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
+
+public:
+    ~compressed_file_source();
+
+    std::string compression() const { return d_file.compression(); }
+
+    int work(int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif /*GNSS_SDR_COMPRESSED_FILE_SOURCE_H_*/
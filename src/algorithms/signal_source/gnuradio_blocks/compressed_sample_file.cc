@@ -0,0 +1,684 @@
+/*!
+ * \file compressed_sample_file.cc
+ * \brief Reads and writes zstd or LZ4 compressed files of samples
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "compressed_sample_file.h"
+#include <algorithm>
+#include <cstring>
+#include <glog/logging.h>
+#if ZSTD_COMPRESSION
+#include <zstd.h>
+#include <zstd_errors.h>
+#endif
+#if LZ4_COMPRESSION
+#include <lz4frame.h>
+#endif
+
+using google::LogMessage;
+
+#define COMPRESSED_SAMPLE_FILE_READ_CHUNK 1048576   // bytes read from the file at a time (1 MB)
+
+
+/*!
+ * \brief Frame splitting, decompression and compression of one format.
+ * Each thread uses its own codec.
+ */
+class Sample_Frame_Codec
+{
+public:
+    virtual ~Sample_Frame_Codec() {}
+
+    /*!
+     * \brief Size of the frame at the start of \p data: > 0 if the frame is
+     * complete, 0 if more bytes are needed, < 0 if it is not a frame
+     */
+    virtual long long frame_size(const char* data, std::size_t size) = 0;
+
+    /*!
+     * \brief Decompresses from *in, which is advanced over the bytes consumed,
+     * into out. *out_size is the room in out on input and the bytes written
+     * on output. The state is kept between calls, so a stream of frames can
+     * be fed in pieces. Returns false on error.
+     */
+    virtual bool decompress(const char** in, std::size_t* in_size, char* out, std::size_t* out_size) = 0;
+
+    //! Forgets any frame partially decompressed
+    virtual void reset() = 0;
+
+    virtual void set_parameters(int level, unsigned int threads) = 0;
+
+    //! Compresses \p size bytes as one independent frame
+    virtual bool compress(const char* data, std::size_t size, std::vector<char>& out) = 0;
+};
+
+
+#if ZSTD_COMPRESSION
+class Zstd_Frame_Codec : public Sample_Frame_Codec
+{
+public:
+    Zstd_Frame_Codec()
+    {
+        d_dstream = ZSTD_createDStream();
+        ZSTD_initDStream(d_dstream);
+        d_cctx = nullptr;
+        d_level = 0;
+        d_threads = 0;
+    }
+
+    ~Zstd_Frame_Codec()
+    {
+        ZSTD_freeDStream(d_dstream);
+        if (d_cctx != nullptr) ZSTD_freeCCtx(d_cctx);
+    }
+
+    long long frame_size(const char* data, std::size_t size)
+    {
+        if (size == 0) return 0;
+        std::size_t result = ZSTD_findFrameCompressedSize(data, size);
+        if (ZSTD_isError(result))
+            {
+                return (ZSTD_getErrorCode(result) == ZSTD_error_srcSize_wrong) ? 0 : -1;
+            }
+        return result;
+    }
+
+    bool decompress(const char** in, std::size_t* in_size, char* out, std::size_t* out_size)
+    {
+        ZSTD_inBuffer input = { *in, *in_size, 0 };
+        ZSTD_outBuffer output = { out, *out_size, 0 };
+        std::size_t result = ZSTD_decompressStream(d_dstream, &output, &input);
+        if (ZSTD_isError(result))
+            {
+                LOG(WARNING) << "zstd decompression error: " << ZSTD_getErrorName(result);
+                return false;
+            }
+        *in += input.pos;
+        *in_size -= input.pos;
+        *out_size = output.pos;
+        return true;
+    }
+
+    void reset()
+    {
+        ZSTD_initDStream(d_dstream);
+    }
+
+    void set_parameters(int level, unsigned int threads)
+    {
+        d_level = level;
+        d_threads = threads;
+    }
+
+    bool compress(const char* data, std::size_t size, std::vector<char>& out)
+    {
+        if (d_cctx == nullptr)
+            {
+                d_cctx = ZSTD_createCCtx();
+                if (d_level != 0) ZSTD_CCtx_setParameter(d_cctx, ZSTD_c_compressionLevel, d_level);
+                if (d_threads > 0 and ZSTD_isError(ZSTD_CCtx_setParameter(d_cctx, ZSTD_c_nbWorkers, d_threads)))
+                    {
+                        LOG(INFO) << "This zstd library cannot compress with several threads, using one";
+                    }
+                ZSTD_CCtx_setParameter(d_cctx, ZSTD_c_contentSizeFlag, 1);
+            }
+        out.resize(ZSTD_compressBound(size));
+        std::size_t result = ZSTD_compress2(d_cctx, out.data(), out.size(), data, size);
+        if (ZSTD_isError(result))
+            {
+                LOG(WARNING) << "zstd compression error: " << ZSTD_getErrorName(result);
+                return false;
+            }
+        out.resize(result);
+        return true;
+    }
+
+private:
+    ZSTD_DStream* d_dstream;
+    ZSTD_CCtx* d_cctx;
+    int d_level;
+    unsigned int d_threads;
+};
+#endif
+
+
+#if LZ4_COMPRESSION
+class Lz4_Frame_Codec : public Sample_Frame_Codec
+{
+public:
+    Lz4_Frame_Codec()
+    {
+        LZ4F_createDecompressionContext(&d_dctx, LZ4F_VERSION);
+        d_level = 0;
+    }
+
+    ~Lz4_Frame_Codec()
+    {
+        LZ4F_freeDecompressionContext(d_dctx);
+    }
+
+    // Walks the block headers, as the library has no function for it
+    long long frame_size(const char* data, std::size_t size)
+    {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        if (size < 8) return 0;
+        unsigned int magic = le32(p);
+        if ((magic & 0xFFFFFFF0) == 0x184D2A50)   // skippable frame
+            {
+                unsigned long long skippable = 8ULL + le32(p + 4);
+                return (size >= skippable) ? skippable : 0;
+            }
+        unsigned char flags = p[4];
+        if (magic != 0x184D2204 or (flags >> 6) != 1) return -1;
+        bool block_checksum = flags & 0x10;
+        bool content_checksum = flags & 0x04;
+        unsigned long long position = 4 + 2 + ((flags & 0x08) ? 8 : 0) + ((flags & 0x01) ? 4 : 0) + 1;
+        while (true)
+            {
+                if (position + 4 > size) return 0;
+                unsigned int block = le32(p + position);
+                position += 4;
+                if (block == 0) break;   // end mark
+                position += (block & 0x7FFFFFFF) + (block_checksum ? 4 : 0);
+            }
+        if (content_checksum) position += 4;
+        return (position <= size) ? position : 0;
+    }
+
+    bool decompress(const char** in, std::size_t* in_size, char* out, std::size_t* out_size)
+    {
+        std::size_t consumed = *in_size;
+        std::size_t result = LZ4F_decompress(d_dctx, out, out_size, *in, &consumed, nullptr);
+        if (LZ4F_isError(result))
+            {
+                LOG(WARNING) << "LZ4 decompression error: " << LZ4F_getErrorName(result);
+                return false;
+            }
+        *in += consumed;
+        *in_size -= consumed;
+        return true;
+    }
+
+    void reset()
+    {
+        LZ4F_resetDecompressionContext(d_dctx);
+    }
+
+    void set_parameters(int level, unsigned int threads)
+    {
+        d_level = level;
+    }
+
+    bool compress(const char* data, std::size_t size, std::vector<char>& out)
+    {
+        LZ4F_preferences_t preferences;
+        std::memset(&preferences, 0, sizeof(preferences));
+        preferences.compressionLevel = d_level;
+        preferences.frameInfo.blockSizeID = LZ4F_max4MB;
+        preferences.frameInfo.blockMode = LZ4F_blockIndependent;
+        preferences.frameInfo.contentSize = size;
+        out.resize(LZ4F_compressFrameBound(size, &preferences));
+        std::size_t result = LZ4F_compressFrame(out.data(), out.size(), data, size, &preferences);
+        if (LZ4F_isError(result))
+            {
+                LOG(WARNING) << "LZ4 compression error: " << LZ4F_getErrorName(result);
+                return false;
+            }
+        out.resize(result);
+        return true;
+    }
+
+private:
+    static unsigned int le32(const unsigned char* p)
+    {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<unsigned int>(p[3]) << 24);
+    }
+
+    LZ4F_dctx* d_dctx;
+    int d_level;
+};
+#endif
+
+
+static boost::shared_ptr<Sample_Frame_Codec> make_sample_frame_codec(const std::string& compression)
+{
+#if ZSTD_COMPRESSION
+    if (compression.compare("zstd") == 0) return boost::shared_ptr<Sample_Frame_Codec>(new Zstd_Frame_Codec());
+#endif
+#if LZ4_COMPRESSION
+    if (compression.compare("lz4") == 0) return boost::shared_ptr<Sample_Frame_Codec>(new Lz4_Frame_Codec());
+#endif
+    return boost::shared_ptr<Sample_Frame_Codec>();
+}
+
+
+std::string compression_from_filename(const std::string& filename)
+{
+    std::string::size_type dot = filename.rfind('.');
+    if (dot == std::string::npos) return "none";
+    std::string extension = filename.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension.compare("zst") == 0 or extension.compare("zstd") == 0) return "zstd";
+    if (extension.compare("lz4") == 0) return "lz4";
+    return "none";
+}
+
+
+bool compression_supported(const std::string& compression)
+{
+    if (compression.compare("none") == 0) return true;
+    return make_sample_frame_codec(compression) != nullptr;
+}
+
+
+// Decompresses a whole frame, whatever its size
+static bool decompress_frame(Sample_Frame_Codec& codec, const std::vector<char>& compressed, std::vector<char>& data)
+{
+    codec.reset();
+    const char* in = compressed.data();
+    std::size_t in_size = compressed.size();
+    std::size_t used = 0;
+    data.resize(COMPRESSED_SAMPLE_FILE_FRAME_BYTES);
+    while (true)
+        {
+            if (data.size() - used < COMPRESSED_SAMPLE_FILE_READ_CHUNK)
+                {
+                    data.resize(2 * data.size());
+                }
+            std::size_t produced = data.size() - used;
+            if (codec.decompress(&in, &in_size, &data[used], &produced) == false) return false;
+            used += produced;
+            if (in_size == 0 and used < data.size()) break;
+        }
+    data.resize(used);
+    return true;
+}
+
+
+
+Compressed_Sample_File::Compressed_Sample_File()
+{
+    d_threads = 1;
+    d_ring_frames = 1;
+    d_file = nullptr;
+    d_streaming = false;
+    d_stop = false;
+    d_bytes_read = 0;
+}
+
+
+Compressed_Sample_File::~Compressed_Sample_File()
+{
+    close();
+}
+
+
+bool Compressed_Sample_File::open(const std::string& filename, const std::string& compression,
+        unsigned int threads, unsigned int ring_frames)
+{
+    close();
+    std::string format = compression;
+    if (format.compare("auto") == 0)
+        {
+            format = compression_from_filename(filename);
+        }
+    if (format.compare("none") == 0 or compression_supported(format) == false)
+        {
+            LOG(WARNING) << "Compression " << format << " of " << filename << " not supported by this build";
+            return false;
+        }
+    d_file = std::fopen(filename.c_str(), "rb");
+    if (d_file == nullptr)
+        {
+            LOG(WARNING) << "Unable to open " << filename;
+            return false;
+        }
+    if (threads == 0)
+        {
+            threads = std::max(boost::thread::hardware_concurrency(), 1u);
+        }
+    d_filename = filename;
+    d_compression = format;
+    d_threads = threads;
+    d_ring_frames = std::max(ring_frames, threads);   // at least one frame per decoder
+    d_ring.reset(d_ring_frames);
+    d_streaming = false;
+    d_stop = false;
+    d_bytes_read = 0;
+    d_split_thread = boost::thread(&Compressed_Sample_File::split, this);
+    for (unsigned int i = 0; i < d_threads; i++)
+        {
+            d_decoder_threads.push_back(boost::shared_ptr<boost::thread>(
+                    new boost::thread(&Compressed_Sample_File::decode, this)));
+        }
+    LOG(INFO) << "Reading " << filename << " (" << format << ") with " << d_threads
+              << " decoder threads and " << d_ring_frames << " frames of read-ahead";
+    return true;
+}
+
+
+void Compressed_Sample_File::close()
+{
+    if (d_file == nullptr) return;
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        d_stop = true;
+    }
+    d_ring.stop();
+    d_job_ready.notify_all();
+    d_split_thread.join();
+    for (unsigned int i = 0; i < d_decoder_threads.size(); i++)
+        {
+            d_decoder_threads[i]->join();
+        }
+    d_decoder_threads.clear();
+    d_ring.reset(d_ring_frames);
+    d_jobs.clear();
+    std::fclose(d_file);
+    d_file = nullptr;
+}
+
+
+bool Compressed_Sample_File::rewind()
+{
+    std::string filename = d_filename;
+    std::string compression = d_compression;
+    return open(filename, compression, d_threads, d_ring_frames);
+}
+
+
+std::size_t Compressed_Sample_File::read(char* buffer, std::size_t nbytes)
+{
+    if (d_file == nullptr) return 0;
+    std::size_t copied = d_ring.read(buffer, nbytes);
+    d_bytes_read += copied;
+    return copied;
+}
+
+
+unsigned long long Compressed_Sample_File::skip(unsigned long long nbytes)
+{
+    std::vector<char> buffer(COMPRESSED_SAMPLE_FILE_READ_CHUNK);
+    unsigned long long skipped = 0;
+    while (skipped < nbytes)
+        {
+            std::size_t requested = std::min(nbytes - skipped, static_cast<unsigned long long>(buffer.size()));
+            std::size_t n = read(buffer.data(), requested);
+            skipped += n;
+            if (n < requested) break;
+        }
+    return skipped;
+}
+
+
+bool Compressed_Sample_File::failed() const
+{
+    return d_ring.failed();
+}
+
+
+bool Compressed_Sample_File::streaming() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_streaming;
+}
+
+
+// Queues a frame in the ring and gives its bytes (swapped out of \p compressed) to a decoder
+bool Compressed_Sample_File::push(std::vector<char>& compressed)
+{
+    boost::shared_ptr<Sample_Block> frame(new Sample_Block());
+    frame->ready = false;
+    if (d_ring.push(frame) == false) return false;
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        if (d_stop == true) return false;
+        d_jobs.push_back(Frame_Job());
+        d_jobs.back().compressed.swap(compressed);
+        d_jobs.back().frame = frame;
+    }
+    d_job_ready.notify_one();
+    return true;
+}
+
+
+void Compressed_Sample_File::finish(bool failed)
+{
+    if (failed == true)
+        {
+            LOG(WARNING) << d_filename << " is corrupt or truncated";
+        }
+    d_ring.finish(failed);
+}
+
+
+// Reader thread: cuts the file in frames for the decoders
+void Compressed_Sample_File::split()
+{
+    boost::shared_ptr<Sample_Frame_Codec> codec = make_sample_frame_codec(d_compression);
+    std::vector<char> pending;   // bytes read from the file and not yet in a frame
+    std::size_t begin = 0;
+    bool end_of_file = false;
+    while (true)
+        {
+            long long size;
+            while ((size = codec->frame_size(pending.data() + begin, pending.size() - begin)) > 0)
+                {
+                    std::vector<char> compressed(pending.begin() + begin, pending.begin() + begin + size);
+                    begin += size;
+                    if (push(compressed) == false) return;
+                }
+            if (size < 0)
+                {
+                    finish(true);
+                    return;
+                }
+            if (end_of_file == true)
+                {
+                    finish(begin < pending.size());
+                    return;
+                }
+            if (pending.size() - begin >= COMPRESSED_SAMPLE_FILE_MAX_FRAME)
+                {
+                    stream(pending, begin);
+                    return;
+                }
+            pending.erase(pending.begin(), pending.begin() + begin);
+            begin = 0;
+            std::size_t old_size = pending.size();
+            pending.resize(old_size + COMPRESSED_SAMPLE_FILE_READ_CHUNK);
+            std::size_t n = std::fread(&pending[old_size], 1, COMPRESSED_SAMPLE_FILE_READ_CHUNK, d_file);
+            pending.resize(old_size + n);
+            if (n < COMPRESSED_SAMPLE_FILE_READ_CHUNK) end_of_file = true;
+        }
+}
+
+
+// Decoder thread
+void Compressed_Sample_File::decode()
+{
+    boost::shared_ptr<Sample_Frame_Codec> codec = make_sample_frame_codec(d_compression);
+    while (true)
+        {
+            Frame_Job job;
+            {
+                boost::mutex::scoped_lock lock(d_mutex);
+                while (d_stop == false and d_jobs.empty())
+                    {
+                        d_job_ready.wait(lock);
+                    }
+                if (d_stop == true) return;
+                job.compressed.swap(d_jobs.front().compressed);
+                job.frame = d_jobs.front().frame;
+                d_jobs.pop_front();
+            }
+            bool failed = (decompress_frame(*codec, job.compressed, job.frame->data) == false);
+            d_ring.set_ready(job.frame, failed);
+        }
+}
+
+
+// Decompresses the rest of the file in the reader thread, from pending[begin]
+void Compressed_Sample_File::stream(std::vector<char>& pending, std::size_t begin)
+{
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        d_streaming = true;
+    }
+    LOG(INFO) << "Frames of " << d_filename << " too large to be decoded in parallel, decoding them as a stream";
+    boost::shared_ptr<Sample_Frame_Codec> codec = make_sample_frame_codec(d_compression);
+    std::vector<char> input(pending.begin() + begin, pending.end());
+    std::vector<char>().swap(pending);
+    std::size_t input_position = 0;
+    bool end_of_file = false;
+    boost::shared_ptr<Sample_Block> frame;
+    std::size_t used = 0;
+    while (true)
+        {
+            if (input_position == input.size() and end_of_file == false)
+                {
+                    input.resize(COMPRESSED_SAMPLE_FILE_READ_CHUNK);
+                    std::size_t n = std::fread(input.data(), 1, input.size(), d_file);
+                    input.resize(n);
+                    input_position = 0;
+                    if (n < COMPRESSED_SAMPLE_FILE_READ_CHUNK) end_of_file = true;
+                }
+            if (frame == nullptr)
+                {
+                    frame = boost::shared_ptr<Sample_Block>(new Sample_Block());
+                    frame->data.resize(COMPRESSED_SAMPLE_FILE_FRAME_BYTES);
+                    used = 0;
+                }
+            const char* in = input.data() + input_position;
+            std::size_t in_size = input.size() - input_position;
+            std::size_t produced = frame->data.size() - used;
+            bool failed = (codec->decompress(&in, &in_size, &frame->data[used], &produced) == false);
+            input_position = input.size() - in_size;
+            used += produced;
+            bool drained = (end_of_file == true and input_position == input.size() and used < frame->data.size());
+            if (used == frame->data.size() or drained or failed)
+                {
+                    frame->data.resize(used);
+                    if (used > 0 and d_ring.push(frame) == false) return;
+                    frame.reset();
+                }
+            if (drained or failed)
+                {
+                    finish(failed);
+                    return;
+                }
+        }
+}
+
+
+
+Compressed_Sample_Writer::Compressed_Sample_Writer()
+{
+    d_file = nullptr;
+    d_failed = false;
+    d_bytes_in = 0;
+    d_bytes_out = 0;
+}
+
+
+Compressed_Sample_Writer::~Compressed_Sample_Writer()
+{
+    close();
+}
+
+
+bool Compressed_Sample_Writer::open(const std::string& filename, const std::string& compression,
+        int level, unsigned int threads)
+{
+    close();
+    d_codec = make_sample_frame_codec(compression);
+    if (d_codec == nullptr)
+        {
+            LOG(WARNING) << "Compression " << compression << " not supported by this build";
+            return false;
+        }
+    d_file = std::fopen(filename.c_str(), "wb");
+    if (d_file == nullptr)
+        {
+            LOG(WARNING) << "Unable to create " << filename;
+            return false;
+        }
+    d_codec->set_parameters(level, threads);
+    d_compression = compression;
+    d_frame.clear();
+    d_frame.reserve(COMPRESSED_SAMPLE_FILE_FRAME_BYTES);
+    d_failed = false;
+    d_bytes_in = 0;
+    d_bytes_out = 0;
+    return true;
+}
+
+
+bool Compressed_Sample_Writer::close()
+{
+    if (d_file == nullptr) return false;
+    if (d_frame.empty() == false) write_frame();
+    bool ok = (std::fclose(d_file) == 0) and d_failed == false;
+    d_file = nullptr;
+    if (d_bytes_out > 0)
+        {
+            LOG(INFO) << "Compressed " << d_bytes_in << " bytes to " << d_bytes_out << " with " << d_compression
+                      << " (ratio " << static_cast<double>(d_bytes_in) / static_cast<double>(d_bytes_out) << ")";
+        }
+    return ok;
+}
+
+
+bool Compressed_Sample_Writer::write(const char* data, std::size_t nbytes)
+{
+    if (d_file == nullptr or d_failed == true) return false;
+    while (nbytes > 0)
+        {
+            std::size_t n = std::min(nbytes, COMPRESSED_SAMPLE_FILE_FRAME_BYTES - d_frame.size());
+            d_frame.insert(d_frame.end(), data, data + n);
+            data += n;
+            nbytes -= n;
+            d_bytes_in += n;
+            if (d_frame.size() == COMPRESSED_SAMPLE_FILE_FRAME_BYTES and write_frame() == false) return false;
+        }
+    return true;
+}
+
+
+bool Compressed_Sample_Writer::write_frame()
+{
+    if (d_codec->compress(d_frame.data(), d_frame.size(), d_compressed) == false
+            or std::fwrite(d_compressed.data(), 1, d_compressed.size(), d_file) != d_compressed.size())
+        {
+            LOG(WARNING) << "Error writing a compressed frame";
+            d_failed = true;
+            return false;
+        }
+    d_bytes_out += d_compressed.size();
+    d_frame.clear();
+    return true;
+}
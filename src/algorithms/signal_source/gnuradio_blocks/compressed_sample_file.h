@@ -0,0 +1,196 @@
+/*!
+ * \file compressed_sample_file.h
+ * \brief Reads and writes zstd or LZ4 compressed files of samples
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_COMPRESSED_SAMPLE_FILE_H_
+#define GNSS_SDR_COMPRESSED_SAMPLE_FILE_H_
+
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include "sample_block_ring.h"
+
+#define COMPRESSED_SAMPLE_FILE_FRAME_BYTES 4194304     // uncompressed bytes per frame written (4 MB)
+#define COMPRESSED_SAMPLE_FILE_MAX_FRAME 67108864      // largest compressed frame decoded in parallel (64 MB)
+
+class Sample_Frame_Codec;
+
+/*!
+ * \brief Returns the compression of a file named \p filename from its
+ * extension: "zstd" (.zst, .zstd), "lz4" (.lz4) or "none"
+ */
+std::string compression_from_filename(const std::string& filename);
+
+/*!
+ * \brief Returns true if this build can read and write \p compression
+ * ("none", "zstd" or "lz4")
+ */
+bool compression_supported(const std::string& compression);
+
+
+/*!
+ * \brief This class reads the decompressed bytes of a zstd or LZ4 file.
+ *
+ * A reader thread cuts the file in frames, and a pool of decoder threads
+ * decompresses them in parallel into a ring of frames that read() delivers
+ * in order. The ring holds a bounded number of frames, so the file is read
+ * ahead by at most that many frames. A frame larger than
+ * COMPRESSED_SAMPLE_FILE_MAX_FRAME (for instance, a file compressed as a
+ * single frame by the zstd or lz4 command line tools) cannot be decoded in
+ * parallel: from there on the reader thread decompresses the file as a
+ * stream, still ahead of read(). Files written by Compressed_Sample_Writer
+ * are made of independent frames of COMPRESSED_SAMPLE_FILE_FRAME_BYTES.
+ */
+class Compressed_Sample_File
+{
+public:
+    Compressed_Sample_File();
+    ~Compressed_Sample_File();
+
+    /*!
+     * \brief Opens \p filename, compressed with \p compression ("zstd",
+     * "lz4", or "auto" to guess it from the extension), and starts
+     * \p threads decoder threads (0 = one per core) with a ring of
+     * \p ring_frames frames. Returns false if the file cannot be opened
+     * or the compression is not supported.
+     */
+    bool open(const std::string& filename, const std::string& compression = "auto",
+            unsigned int threads = 0, unsigned int ring_frames = 8);
+
+    //! Stops the threads and closes the file
+    void close();
+
+    //! Closes and opens again the file, to read it from the beginning
+    bool rewind();
+
+    bool is_open() const
+    {
+        return d_file != nullptr;
+    }
+
+    /*!
+     * \brief Copies the next \p nbytes decompressed bytes to \p buffer,
+     * waiting for them if needed. Returns the number of bytes copied,
+     * which is lower than \p nbytes only at the end of the file or after
+     * a decoding error.
+     */
+    std::size_t read(char* buffer, std::size_t nbytes);
+
+    /*!
+     * \brief Decompresses and discards the next \p nbytes bytes. Returns the
+     * number of bytes skipped.
+     */
+    unsigned long long skip(unsigned long long nbytes);
+
+    std::string compression() const { return d_compression; }
+    unsigned long long bytes_read() const { return d_bytes_read; }   //!< Decompressed bytes delivered so far
+    bool failed() const;                                             //!< The file is corrupt or truncated
+    bool streaming() const;                                          //!< Frames are no longer decoded in parallel
+
+private:
+    struct Frame_Job
+    {
+        std::vector<char> compressed;
+        boost::shared_ptr<Sample_Block> frame;   // gets the decompressed bytes
+    };
+
+    void split();
+    void decode();
+    bool push(std::vector<char>& compressed);
+    void stream(std::vector<char>& pending, std::size_t begin);
+    void finish(bool failed);
+
+    std::string d_filename;
+    std::string d_compression;
+    unsigned int d_threads;
+    unsigned int d_ring_frames;
+    std::FILE* d_file;
+    Sample_Block_Ring d_ring;                     // frames in file order
+    std::deque<Frame_Job> d_jobs;                 // frames waiting for a decoder, guarded by d_mutex
+    mutable boost::mutex d_mutex;
+    boost::condition_variable d_job_ready;       // signals the decoders
+    bool d_streaming;
+    bool d_stop;
+    unsigned long long d_bytes_read;
+    boost::thread d_split_thread;
+    std::vector<boost::shared_ptr<boost::thread> > d_decoder_threads;
+};
+
+
+/*!
+ * \brief This class writes bytes to a zstd or LZ4 file as a sequence of
+ * independent frames of COMPRESSED_SAMPLE_FILE_FRAME_BYTES, so that
+ * Compressed_Sample_File can decode them in parallel. The files are
+ * standard: the zstd and lz4 command line tools decompress them.
+ */
+class Compressed_Sample_Writer
+{
+public:
+    Compressed_Sample_Writer();
+    ~Compressed_Sample_Writer();
+
+    /*!
+     * \brief Creates \p filename. \p level is the compression level (0 =
+     * the library default); \p threads > 0 lets zstd compress each frame
+     * with that many threads of its own. Returns false if the file cannot
+     * be created or the compression is not supported.
+     */
+    bool open(const std::string& filename, const std::string& compression,
+            int level = 0, unsigned int threads = 0);
+
+    //! Writes the last frame and closes the file
+    bool close();
+
+    bool is_open() const
+    {
+        return d_file != nullptr;
+    }
+
+    bool write(const char* data, std::size_t nbytes);
+
+    unsigned long long bytes_in() const { return d_bytes_in; }     //!< Uncompressed bytes written
+    unsigned long long bytes_out() const { return d_bytes_out; }   //!< Compressed bytes written
+
+private:
+    bool write_frame();
+
+    std::string d_compression;
+    std::FILE* d_file;
+    boost::shared_ptr<Sample_Frame_Codec> d_codec;
+    std::vector<char> d_frame;
+    std::vector<char> d_compressed;
+    bool d_failed;
+    unsigned long long d_bytes_in;
+    unsigned long long d_bytes_out;
+};
+
+#endif
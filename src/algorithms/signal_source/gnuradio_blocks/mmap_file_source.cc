@@ -0,0 +1,106 @@
+/*!
+ * \file mmap_file_source.cc
+ * \brief GNU Radio source block that reads the samples of a memory-mapped file
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "mmap_file_source.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <gnuradio/io_signature.h>
+#include <glog/logging.h>
+#include "control_message_factory.h"
+
+using google::LogMessage;
+
+mmap_file_source_sptr make_mmap_file_source(size_t item_size, const std::string& filename,
+        unsigned long long first_item, unsigned long long nitems, bool repeat,
+        gr::msg_queue::sptr queue)
+{
+    return mmap_file_source_sptr(new mmap_file_source(item_size, filename, first_item, nitems, repeat, queue));
+}
+
+
+
+mmap_file_source::mmap_file_source(size_t item_size, const std::string& filename,
+        unsigned long long first_item, unsigned long long nitems, bool repeat,
+        gr::msg_queue::sptr queue) : gr::sync_block("mmap_file_source",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(1, 1, item_size))
+{
+    d_counters = gnss_block_counters(this);
+    if (d_file.open(filename, item_size) == false)
+        {
+            throw std::runtime_error("can't map file " + filename);
+        }
+    if (first_item >= d_file.items())
+        {
+            LOG(WARNING) << "Start of the samples beyond the end of " << filename << ", starting from the beginning";
+            first_item = 0;
+        }
+    d_item_size = item_size;
+    d_first_item = first_item;
+    d_nitems = nitems;
+    d_position = first_item;
+    d_produced = 0;
+    d_repeat = repeat;
+    d_queue = queue;
+}
+
+
+
+mmap_file_source::~mmap_file_source()
+{}
+
+
+
+int mmap_file_source::work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items)
+{
+    Gnss_Work_Timer work_timer(d_counters.get());
+    if ((d_nitems > 0 and d_produced >= d_nitems) or (d_position >= d_file.items() and d_repeat == false))
+        {
+            ControlMessageFactory* cmf = new ControlMessageFactory();
+            d_queue->handle(cmf->GetQueueMessage(200, 0));
+            delete cmf;
+            return -1;  // Done!
+        }
+    if (d_position >= d_file.items())
+        {
+            d_position = d_first_item;
+        }
+    unsigned long long n = std::min(d_file.items() - d_position, static_cast<unsigned long long>(noutput_items));
+    if (d_nitems > 0)
+        {
+            n = std::min(n, d_nitems - d_produced);
+        }
+    std::memcpy(output_items[0], d_file.data(d_position), n * d_item_size);
+    d_position += n;
+    d_produced += n;
+    return n;
+}
@@ -0,0 +1,92 @@
+/*!
+ * \file mmap_file_source.h
+ * \brief GNU Radio source block that reads the samples of a memory-mapped file
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MMAP_FILE_SOURCE_H_
+#define GNSS_SDR_MMAP_FILE_SOURCE_H_
+
+#include <string>
+#include <gnuradio/msg_queue.h>
+#include <gnuradio/sync_block.h>
+#include "mmap_sample_file.h"
+#include "gnss_block_counters.h"
+
+class mmap_file_source;
+
+typedef boost::shared_ptr<mmap_file_source> mmap_file_source_sptr;
+
+/*!
+ * \brief Makes a source of the items [first_item, first_item + nitems) of
+ * \p filename. nitems = 0 means up to the end of the file. Throws
+ * std::runtime_error if the file cannot be mapped.
+ */
+mmap_file_source_sptr make_mmap_file_source(size_t item_size, const std::string& filename,
+        unsigned long long first_item, unsigned long long nitems, bool repeat,
+        gr::msg_queue::sptr queue);
+
+/*!
+ * \brief This class copies the items of a memory-mapped file straight to
+ * its output buffer.
+ *
+ * It replaces the file_source + valve pair: the samples are copied once,
+ * from the page cache, and the block stops the receiver by itself after
+ * nitems items. With repeat, the items from first_item to the end of the
+ * file are delivered again until nitems items have been produced (forever
+ * if nitems = 0).
+ */
+class mmap_file_source : public gr::sync_block
+{
+private:
+    friend mmap_file_source_sptr make_mmap_file_source(size_t item_size, const std::string& filename,
+            unsigned long long first_item, unsigned long long nitems, bool repeat,
+            gr::msg_queue::sptr queue);
+    mmap_file_source(size_t item_size, const std::string& filename,
+            unsigned long long first_item, unsigned long long nitems, bool repeat,
+            gr::msg_queue::sptr queue);
+
+    Mmap_Sample_File d_file;
+    size_t d_item_size;
+    unsigned long long d_first_item;
+    unsigned long long d_nitems;     // items to deliver, 0 = no limit
+    unsigned long long d_position;   // next item of the file
+    unsigned long long d_produced;
+    bool d_repeat;
+    gr::msg_queue::sptr d_queue;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
+
+public:
+    ~mmap_file_source();
+
+    unsigned long long items_in_file() const { return d_file.items(); }
+
+    int work(int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif /*GNSS_SDR_MMAP_FILE_SOURCE_H_*/
@@ -0,0 +1,141 @@
+/*!
+ * \file mmap_sample_file.cc
+ * \brief Read-only memory mapping of a file of signal samples
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "mmap_sample_file.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+Mmap_Sample_File::Mmap_Sample_File()
+{
+    d_data = nullptr;
+    d_length = 0;
+    d_item_size = 0;
+    d_items = 0;
+    d_read_ahead_end = 0;
+    d_read_ahead_requests = 0;
+    d_page_size = sysconf(_SC_PAGESIZE);
+}
+
+
+Mmap_Sample_File::~Mmap_Sample_File()
+{
+    close();
+}
+
+
+bool Mmap_Sample_File::open(const std::string& filename, std::size_t item_size)
+{
+    close();
+    if (item_size == 0)
+        {
+            return false;
+        }
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        {
+            LOG(WARNING) << "Unable to open the samples file " << filename;
+            return false;
+        }
+    struct stat file_status;
+    if ((fstat(fd, &file_status) != 0) or (static_cast<std::size_t>(file_status.st_size) < item_size))
+        {
+            LOG(WARNING) << "The samples file " << filename << " does not contain any sample";
+            ::close(fd);
+            return false;
+        }
+    d_length = file_status.st_size;
+    void* mapping = mmap(nullptr, d_length, PROT_READ, MAP_SHARED, fd, 0);
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+        {
+            LOG(WARNING) << "Unable to map the samples file " << filename;
+            d_length = 0;
+            return false;
+        }
+    madvise(mapping, d_length, MADV_SEQUENTIAL);
+    d_data = static_cast<const char*>(mapping);
+    d_item_size = item_size;
+    d_items = d_length / item_size;
+    d_read_ahead_end = 0;
+    d_read_ahead_requests = 0;
+    return true;
+}
+
+
+void Mmap_Sample_File::close()
+{
+    if (d_data != nullptr)
+        {
+            munmap(const_cast<char*>(d_data), d_length);
+            d_data = nullptr;
+        }
+    d_length = 0;
+    d_items = 0;
+}
+
+
+const char* Mmap_Sample_File::data(unsigned long long item)
+{
+    std::size_t offset = item * d_item_size;
+    // a seek backwards (e.g. when the file is repeated) restarts the window
+    if ((offset + MMAP_SAMPLE_FILE_READ_AHEAD / 2 > d_read_ahead_end) or (offset + MMAP_SAMPLE_FILE_READ_AHEAD < d_read_ahead_end))
+        {
+            read_ahead(offset);
+        }
+    return d_data + offset;
+}
+
+
+void Mmap_Sample_File::read_ahead(std::size_t offset)
+{
+    if (offset >= d_length)
+        {
+            return;
+        }
+    std::size_t start = offset;
+    if ((d_read_ahead_end > offset) and (d_read_ahead_end < offset + MMAP_SAMPLE_FILE_READ_AHEAD))
+        {
+            start = d_read_ahead_end;
+        }
+    start -= start % d_page_size;   // madvise needs an address aligned to a page
+    std::size_t end = offset + MMAP_SAMPLE_FILE_READ_AHEAD;
+    if (end > d_length) end = d_length;
+    if (end > start)
+        {
+            madvise(const_cast<char*>(d_data) + start, end - start, MADV_WILLNEED);
+            d_read_ahead_requests++;
+        }
+    d_read_ahead_end = offset + MMAP_SAMPLE_FILE_READ_AHEAD;
+}
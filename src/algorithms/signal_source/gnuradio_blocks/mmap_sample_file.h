@@ -0,0 +1,88 @@
+/*!
+ * \file mmap_sample_file.h
+ * \brief Read-only memory mapping of a file of signal samples
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MMAP_SAMPLE_FILE_H_
+#define GNSS_SDR_MMAP_SAMPLE_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+#define MMAP_SAMPLE_FILE_READ_AHEAD 33554432  // bytes requested ahead of the read position (32 MB)
+
+/*!
+ * \brief This class maps a file of samples in memory and gives pointers to
+ * its items, so that samples are read from the page cache without an
+ * intermediate buffer.
+ *
+ * The whole file is advised as sequential. Besides, data() asks the kernel
+ * to load the next MMAP_SAMPLE_FILE_READ_AHEAD bytes each time the read
+ * position gets into the second half of the window already requested, so
+ * that the disk keeps working while the receiver processes the samples.
+ */
+class Mmap_Sample_File
+{
+public:
+    Mmap_Sample_File();
+    ~Mmap_Sample_File();
+
+    /*!
+     * \brief Maps \p filename, made of items of \p item_size bytes. Returns
+     * false if the file cannot be opened or does not hold a single item.
+     */
+    bool open(const std::string& filename, std::size_t item_size);
+    void close();
+
+    bool is_open() const
+    {
+        return d_data != nullptr;
+    }
+
+    /*!
+     * \brief Pointer to the item \p item of the file, which must be lower
+     * than items(). Requests the read-ahead of the following bytes.
+     */
+    const char* data(unsigned long long item);
+
+    unsigned long long items() const { return d_items; }         //!< Number of whole items in the file
+    std::size_t item_size() const { return d_item_size; }
+    std::size_t read_ahead_requests() const { return d_read_ahead_requests; }
+
+private:
+    void read_ahead(std::size_t offset);
+
+    const char* d_data;
+    std::size_t d_length;
+    std::size_t d_item_size;
+    unsigned long long d_items;
+    std::size_t d_read_ahead_end;   // end of the window already requested [bytes]
+    std::size_t d_read_ahead_requests;
+    std::size_t d_page_size;
+};
+
+#endif
@@ -0,0 +1,97 @@
+/*!
+ * \file multi_file_source.cc
+ * \brief GNU Radio source block that reads a sequence of sample files
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "multi_file_source.h"
+#include <stdexcept>
+#include <gnuradio/io_signature.h>
+#include <glog/logging.h>
+#include "control_message_factory.h"
+
+using google::LogMessage;
+
+multi_file_source_sptr make_multi_file_source(size_t item_size, const std::vector<std::string>& filenames,
+        unsigned int read_ahead_blocks, bool repeat, gr::msg_queue::sptr queue)
+{
+    return multi_file_source_sptr(new multi_file_source(item_size, filenames, read_ahead_blocks, repeat, queue));
+}
+
+
+
+multi_file_source::multi_file_source(size_t item_size, const std::vector<std::string>& filenames,
+        unsigned int read_ahead_blocks, bool repeat, gr::msg_queue::sptr queue) : gr::sync_block("multi_file_source",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(1, 1, item_size))
+{
+    d_counters = gnss_block_counters(this);
+    if (d_files.open(filenames, read_ahead_blocks) == false)
+        {
+            throw std::runtime_error("can't open the sequence of sample files");
+        }
+    d_item_size = item_size;
+    d_repeat = repeat;
+    d_queue = queue;
+}
+
+
+
+multi_file_source::~multi_file_source()
+{}
+
+
+
+int multi_file_source::work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items)
+{
+    Gnss_Work_Timer work_timer(d_counters.get());
+    char* out = static_cast<char*>(output_items[0]);
+    size_t nbytes = d_files.read(out, noutput_items * d_item_size);
+    if (nbytes < noutput_items * d_item_size and d_repeat == true and d_files.failed() == false)
+        {
+            // a partial item at the end of the last file is dropped
+            nbytes -= nbytes % d_item_size;
+            if (d_files.rewind())
+                {
+                    nbytes += d_files.read(out + nbytes, noutput_items * d_item_size - nbytes);
+                }
+        }
+    int n = nbytes / d_item_size;
+    if (n == 0)
+        {
+            if (d_files.failed())
+                {
+                    LOG(WARNING) << "Sequence of sample files interrupted after " << d_files.bytes_read() << " bytes";
+                }
+            ControlMessageFactory* cmf = new ControlMessageFactory();
+            d_queue->handle(cmf->GetQueueMessage(200, 0));
+            delete cmf;
+            return -1;  // Done!
+        }
+    return n;
+}
@@ -0,0 +1,81 @@
+/*!
+ * \file multi_file_source.h
+ * \brief GNU Radio source block that reads a sequence of sample files
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MULTI_FILE_SOURCE_H_
+#define GNSS_SDR_MULTI_FILE_SOURCE_H_
+
+#include <string>
+#include <vector>
+#include <gnuradio/msg_queue.h>
+#include <gnuradio/sync_block.h>
+#include "sample_file_sequence.h"
+#include "gnss_block_counters.h"
+
+class multi_file_source;
+
+typedef boost::shared_ptr<multi_file_source> multi_file_source_sptr;
+
+/*!
+ * \brief Makes a source of the items of \p filenames, read one after the
+ * other with \p read_ahead_blocks blocks of prefetch. Throws
+ * std::runtime_error if a file does not exist.
+ */
+multi_file_source_sptr make_multi_file_source(size_t item_size, const std::vector<std::string>& filenames,
+        unsigned int read_ahead_blocks, bool repeat, gr::msg_queue::sptr queue);
+
+/*!
+ * \brief This class delivers the items of a Sample_File_Sequence, so that
+ * the files are seen by the receiver as a single capture. It stops the
+ * receiver at the end of the last file, unless repeat is set.
+ */
+class multi_file_source : public gr::sync_block
+{
+private:
+    friend multi_file_source_sptr make_multi_file_source(size_t item_size, const std::vector<std::string>& filenames,
+            unsigned int read_ahead_blocks, bool repeat, gr::msg_queue::sptr queue);
+    multi_file_source(size_t item_size, const std::vector<std::string>& filenames,
+            unsigned int read_ahead_blocks, bool repeat, gr::msg_queue::sptr queue);
+
+    Sample_File_Sequence d_files;
+    size_t d_item_size;
+    bool d_repeat;
+    gr::msg_queue::sptr d_queue;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
+
+public:
+    ~multi_file_source();
+
+    unsigned long long total_items() const { return d_files.total_bytes() / d_item_size; }
+
+    int work(int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif /*GNSS_SDR_MULTI_FILE_SOURCE_H_*/
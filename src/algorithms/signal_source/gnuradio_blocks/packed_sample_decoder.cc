@@ -0,0 +1,156 @@
+/*!
+ * \file packed_sample_decoder.cc
+ * \brief Table driven decoder of 1, 2 and 4-bit packed samples
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "packed_sample_decoder.h"
+#include <cstring>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+namespace
+{
+// N values per byte: the copy has a constant size, which the compiler turns into a few vector moves
+template<typename T, unsigned int N>
+void decode_bytes(const unsigned char* in, unsigned int nbytes, const std::vector<unsigned int>& order,
+        const T* lut, T* out)
+{
+    unsigned int word_bytes = order.size();
+    if (word_bytes == 1)
+        {
+            for (unsigned int i = 0; i < nbytes; i++)
+                {
+                    std::memcpy(out, lut + in[i] * N, N * sizeof(T));
+                    out += N;
+                }
+            return;
+        }
+    for (unsigned int w = 0; w + word_bytes <= nbytes; w += word_bytes)
+        {
+            for (unsigned int k = 0; k < word_bytes; k++)
+                {
+                    std::memcpy(out, lut + in[w + order[k]] * N, N * sizeof(T));
+                    out += N;
+                }
+        }
+}
+
+template<typename T>
+void decode_dispatch(const unsigned char* in, unsigned int nbytes, const std::vector<unsigned int>& order,
+        const std::vector<T>& lut, unsigned int values_per_byte, T* out)
+{
+    switch (values_per_byte)
+    {
+    case 2:
+        decode_bytes<T, 2>(in, nbytes, order, lut.data(), out);
+        break;
+    case 4:
+        decode_bytes<T, 4>(in, nbytes, order, lut.data(), out);
+        break;
+    case 8:
+        decode_bytes<T, 8>(in, nbytes, order, lut.data(), out);
+        break;
+    default:
+        decode_bytes<T, 16>(in, nbytes, order, lut.data(), out);
+    }
+}
+}
+
+
+Packed_Sample_Decoder::Packed_Sample_Decoder(const Packed_Sample_Format& format, bool complex_output)
+{
+    d_format = format;
+    if (d_format.bits != 1 and d_format.bits != 2 and d_format.bits != 4)
+        {
+            LOG(WARNING) << d_format.bits << " bits per sample not supported. Using 2 bits";
+            d_format.bits = 2;
+        }
+    if (d_format.word_bytes != 1 and d_format.word_bytes != 2 and d_format.word_bytes != 4)
+        {
+            LOG(WARNING) << "Words of " << d_format.word_bytes << " bytes not supported. Using bytes";
+            d_format.word_bytes = 1;
+        }
+
+    // decode first the byte that holds the first samples of the word
+    bool in_memory_order = (d_format.msb_first == d_format.big_endian);
+    for (unsigned int k = 0; k < d_format.word_bytes; k++)
+        {
+            d_byte_order.push_back(in_memory_order ? k : d_format.word_bytes - 1 - k);
+        }
+
+    unsigned int samples_per_byte = 8 / d_format.bits;
+    bool add_zero_q = complex_output and (d_format.complex == false);
+    d_values_per_byte = add_zero_q ? 2 * samples_per_byte : samples_per_byte;
+    d_lut_float.resize(256 * d_values_per_byte);
+    d_lut_int8.resize(256 * d_values_per_byte);
+    unsigned int mask = (1 << d_format.bits) - 1;
+    for (unsigned int byte = 0; byte < 256; byte++)
+        {
+            for (unsigned int k = 0; k < samples_per_byte; k++)
+                {
+                    unsigned int shift = d_format.msb_first ? 8 - d_format.bits * (k + 1) : d_format.bits * k;
+                    int value = sample_value((byte >> shift) & mask);
+                    unsigned int index = byte * d_values_per_byte + (add_zero_q ? 2 * k : k);
+                    d_lut_float[index] = static_cast<float>(value);
+                    d_lut_int8[index] = static_cast<signed char>(value);
+                    if (add_zero_q)
+                        {
+                            d_lut_float[index + 1] = 0.0;
+                            d_lut_int8[index + 1] = 0;
+                        }
+                }
+        }
+}
+
+
+int Packed_Sample_Decoder::sample_value(unsigned int code) const
+{
+    if (d_format.bits == 1)
+        {
+            return (code == 0) ? 1 : -1;
+        }
+    unsigned int sign_bit = 1 << (d_format.bits - 1);
+    if (d_format.sign_magnitude == true)
+        {
+            int magnitude = 2 * (code & (sign_bit - 1)) + 1;
+            return (code & sign_bit) ? -magnitude : magnitude;
+        }
+    return (code & sign_bit) ? static_cast<int>(code) - (1 << d_format.bits) : static_cast<int>(code);
+}
+
+
+void Packed_Sample_Decoder::decode(const unsigned char* in, unsigned int nbytes, float* out) const
+{
+    decode_dispatch(in, nbytes, d_byte_order, d_lut_float, d_values_per_byte, out);
+}
+
+
+void Packed_Sample_Decoder::decode(const unsigned char* in, unsigned int nbytes, signed char* out) const
+{
+    decode_dispatch(in, nbytes, d_byte_order, d_lut_int8, d_values_per_byte, out);
+}
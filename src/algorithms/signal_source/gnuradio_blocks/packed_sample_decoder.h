@@ -0,0 +1,89 @@
+/*!
+ * \file packed_sample_decoder.h
+ * \brief Table driven decoder of 1, 2 and 4-bit packed samples
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PACKED_SAMPLE_DECODER_H_
+#define GNSS_SDR_PACKED_SAMPLE_DECODER_H_
+
+#include <vector>
+
+/*!
+ * \brief Layout of the packed samples of a front-end
+ */
+struct Packed_Sample_Format
+{
+    unsigned int bits;          //!< Bits per sample (I or Q): 1, 2 or 4
+    bool complex;               //!< Interleaved I/Q samples (I first) instead of real samples
+    bool sign_magnitude;        //!< Sign-magnitude (sign in the upper bit) instead of two's complement
+    bool msb_first;             //!< The first sample is in the most significant bits
+    unsigned int word_bytes;    //!< Bytes of the words where the samples are packed: 1, 2 or 4
+    bool big_endian;            //!< Byte order of the words
+
+    Packed_Sample_Format() : bits(2), complex(false), sign_magnitude(false), msb_first(false),
+            word_bytes(1), big_endian(false) {}
+};
+
+/*!
+ * \brief This class unpacks 1, 2 or 4-bit samples to float or 8-bit values
+ * with a look-up table of the values of each of the 256 bytes, so that
+ * decoding a byte is a copy of a few values of constant size.
+ *
+ * Two's complement 2-bit codes are -2, -1, 0, 1 and sign-magnitude codes
+ * are -3, -1, 1, 3 (odd levels, as in the MAX2769 and similar front-ends).
+ * 1-bit samples are a sign: 0 is +1 and 1 is -1. With complex_output,
+ * real samples get a zero Q component, so the output is always made of
+ * I/Q pairs.
+ */
+class Packed_Sample_Decoder
+{
+public:
+    Packed_Sample_Decoder(const Packed_Sample_Format& format, bool complex_output);
+
+    /*!
+     * \brief Decodes \p nbytes bytes, a multiple of word_bytes(), and writes
+     * nbytes * values_per_byte() values to \p out
+     */
+    void decode(const unsigned char* in, unsigned int nbytes, float* out) const;
+    void decode(const unsigned char* in, unsigned int nbytes, signed char* out) const;
+
+    //! Value of the sample code \p code of bits() bits
+    int sample_value(unsigned int code) const;
+
+    unsigned int values_per_byte() const { return d_values_per_byte; }   //!< Output values per input byte
+    unsigned int word_bytes() const { return d_format.word_bytes; }
+    const Packed_Sample_Format& format() const { return d_format; }
+
+private:
+    Packed_Sample_Format d_format;
+    unsigned int d_values_per_byte;
+    std::vector<unsigned int> d_byte_order;   // order in which the bytes of a word are decoded
+    std::vector<float> d_lut_float;
+    std::vector<signed char> d_lut_int8;
+};
+
+#endif
@@ -0,0 +1,143 @@
+/*!
+ * \file sample_block_ring.cc
+ * \brief Bounded ring of blocks of bytes filled by producer threads and
+ * delivered in order to a reader
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "sample_block_ring.h"
+#include <algorithm>
+#include <cstring>
+
+
+Sample_Block_Ring::Sample_Block_Ring()
+{
+    d_capacity = 1;
+    d_end = false;
+    d_failed = false;
+    d_stop = false;
+}
+
+
+void Sample_Block_Ring::reset(unsigned int capacity)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_blocks.clear();
+    d_capacity = std::max(capacity, 1u);
+    d_end = false;
+    d_failed = false;
+    d_stop = false;
+}
+
+
+bool Sample_Block_Ring::push(const boost::shared_ptr<Sample_Block>& block)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    while (d_stop == false and d_blocks.size() >= d_capacity)
+        {
+            d_room.wait(lock);
+        }
+    if (d_stop == true) return false;
+    d_blocks.push_back(block);
+    if (block->ready == true)
+        {
+            d_block_ready.notify_all();
+        }
+    return true;
+}
+
+
+void Sample_Block_Ring::set_ready(const boost::shared_ptr<Sample_Block>& block, bool failed)
+{
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        block->ready = true;
+        block->failed = failed;
+    }
+    d_block_ready.notify_all();
+}
+
+
+void Sample_Block_Ring::finish(bool failed)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_end = true;
+    if (failed == true) d_failed = true;
+    d_block_ready.notify_all();
+}
+
+
+void Sample_Block_Ring::stop()
+{
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        d_stop = true;
+    }
+    d_room.notify_all();
+    d_block_ready.notify_all();
+}
+
+
+std::size_t Sample_Block_Ring::read(char* buffer, std::size_t nbytes, unsigned int* source)
+{
+    std::size_t copied = 0;
+    boost::mutex::scoped_lock lock(d_mutex);
+    while (copied < nbytes)
+        {
+            while (d_stop == false and (d_blocks.empty() ? d_end == false : d_blocks.front()->ready == false))
+                {
+                    d_block_ready.wait(lock);
+                }
+            if (d_stop == true or d_blocks.empty()) break;
+            boost::shared_ptr<Sample_Block> block = d_blocks.front();
+            if (block->failed == true)
+                {
+                    d_failed = true;
+                    break;
+                }
+            if (source != nullptr) *source = block->source;
+            // a ready block is only touched by this thread, copy it without the lock
+            lock.unlock();
+            std::size_t n = std::min(nbytes - copied, block->data.size() - block->position);
+            std::memcpy(buffer + copied, block->data.data() + block->position, n);
+            block->position += n;
+            copied += n;
+            lock.lock();
+            if (block->position == block->data.size())
+                {
+                    d_blocks.pop_front();
+                    d_room.notify_one();
+                }
+        }
+    return copied;
+}
+
+
+bool Sample_Block_Ring::failed() const
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_failed;
+}
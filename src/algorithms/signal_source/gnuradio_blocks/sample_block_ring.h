@@ -0,0 +1,113 @@
+/*!
+ * \file sample_block_ring.h
+ * \brief Bounded ring of blocks of bytes filled by producer threads and
+ * delivered in order to a reader
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SAMPLE_BLOCK_RING_H_
+#define GNSS_SDR_SAMPLE_BLOCK_RING_H_
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+/*!
+ * \brief A block of bytes of a Sample_Block_Ring
+ */
+struct Sample_Block
+{
+    std::vector<char> data;
+    std::size_t position;   //!< Next byte of data to be delivered
+    unsigned int source;    //!< Index of the file the block comes from
+    bool ready;             //!< data can be delivered
+    bool failed;            //!< data could not be produced
+
+    Sample_Block() : position(0), source(0), ready(true), failed(false) {}
+};
+
+
+/*!
+ * \brief This class keeps the read-ahead of the sample file readers: a
+ * bounded ring of blocks that producer threads push in stream order and
+ * read() delivers in that order.
+ *
+ * A block can be pushed before its data is produced (ready = false, for
+ * instance a frame still being decompressed) and marked with set_ready()
+ * later; read() waits for the block at the front to be ready. A failed
+ * block ends the stream as a failure.
+ */
+class Sample_Block_Ring
+{
+public:
+    Sample_Block_Ring();
+
+    /*!
+     * \brief Empties the ring, which will hold up to \p capacity blocks, and
+     * clears the end, failure and stop states. Only when no thread uses the ring.
+     */
+    void reset(unsigned int capacity);
+
+    /*!
+     * \brief Appends \p block, waiting for room. Returns false if the ring
+     * was stopped.
+     */
+    bool push(const boost::shared_ptr<Sample_Block>& block);
+
+    //! Marks \p block, already pushed, as ready (or failed) to be delivered
+    void set_ready(const boost::shared_ptr<Sample_Block>& block, bool failed);
+
+    //! No more blocks will be pushed; \p failed if the stream is incomplete
+    void finish(bool failed);
+
+    //! Wakes up and returns the threads waiting in push() and read()
+    void stop();
+
+    /*!
+     * \brief Copies the next \p nbytes bytes to \p buffer, waiting for them if
+     * needed. Returns the number of bytes copied, which is lower than
+     * \p nbytes only at the end of the stream, after a failure or when the
+     * ring is stopped. If \p source is not null, it gets the source of the
+     * last block delivered.
+     */
+    std::size_t read(char* buffer, std::size_t nbytes, unsigned int* source = nullptr);
+
+    bool failed() const;   //!< The stream ended with a failure
+
+private:
+    std::deque<boost::shared_ptr<Sample_Block> > d_blocks;   // guarded by d_mutex
+    mutable boost::mutex d_mutex;
+    boost::condition_variable d_block_ready;   // signals read()
+    boost::condition_variable d_room;          // signals push()
+    unsigned int d_capacity;
+    bool d_end;
+    bool d_failed;
+    bool d_stop;
+};
+
+#endif
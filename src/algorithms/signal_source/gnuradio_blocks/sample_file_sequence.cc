@@ -0,0 +1,235 @@
+/*!
+ * \file sample_file_sequence.cc
+ * \brief Reads a sequence of sample files as one continuous stream
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "sample_file_sequence.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fcntl.h>
+#include <glob.h>
+#include <sys/stat.h>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+namespace
+{
+// Natural order of file names: the runs of digits are compared by their
+// value, so that capture_2.dat goes before capture_10.dat
+bool natural_less(const std::string& a, const std::string& b)
+{
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < a.size() and j < b.size())
+        {
+            if (std::isdigit(static_cast<unsigned char>(a[i])) and std::isdigit(static_cast<unsigned char>(b[j])))
+                {
+                    std::size_t a_end = a.find_first_not_of("0123456789", i);
+                    std::size_t b_end = b.find_first_not_of("0123456789", j);
+                    if (a_end == std::string::npos) a_end = a.size();
+                    if (b_end == std::string::npos) b_end = b.size();
+                    std::size_t a_begin = std::min(a.find_first_not_of('0', i), a_end);
+                    std::size_t b_begin = std::min(b.find_first_not_of('0', j), b_end);
+                    // without the leading zeros, a longer run is a larger number
+                    if (a_end - a_begin != b_end - b_begin) return a_end - a_begin < b_end - b_begin;
+                    int digits = a.compare(a_begin, a_end - a_begin, b, b_begin, b_end - b_begin);
+                    if (digits != 0) return digits < 0;
+                    // same value: fewer leading zeros first
+                    if (a_end - i != b_end - j) return a_end - i < b_end - j;
+                    i = a_end;
+                    j = b_end;
+                    continue;
+                }
+            if (a[i] != b[j]) return a[i] < b[j];
+            i++;
+            j++;
+        }
+    return (a.size() - i) < (b.size() - j);
+}
+}
+
+
+std::vector<std::string> Sample_File_Sequence::expand(const std::string& list)
+{
+    std::vector<std::string> filenames;
+    std::string::size_type begin = 0;
+    while (begin < list.size())
+        {
+            std::string::size_type end = list.find_first_of(",; \t\n", begin);
+            if (end == std::string::npos) end = list.size();
+            std::string entry = list.substr(begin, end - begin);
+            begin = end + 1;
+            if (entry.empty()) continue;
+            if (entry.find_first_of("*?[") == std::string::npos)
+                {
+                    filenames.push_back(entry);
+                    continue;
+                }
+            glob_t matches;
+            if (glob(entry.c_str(), GLOB_NOSORT, nullptr, &matches) != 0)
+                {
+                    LOG(WARNING) << "No file matches " << entry;
+                    globfree(&matches);
+                    return std::vector<std::string>();
+                }
+            std::vector<std::string> matched(matches.gl_pathv, matches.gl_pathv + matches.gl_pathc);
+            globfree(&matches);
+            std::sort(matched.begin(), matched.end(), natural_less);
+            filenames.insert(filenames.end(), matched.begin(), matched.end());
+        }
+    return filenames;
+}
+
+
+
+Sample_File_Sequence::Sample_File_Sequence()
+{
+    d_total_bytes = 0;
+    d_blocks = 1;
+    d_open = false;
+    d_bytes_read = 0;
+    d_current_file = 0;
+}
+
+
+Sample_File_Sequence::~Sample_File_Sequence()
+{
+    close();
+}
+
+
+bool Sample_File_Sequence::open(const std::vector<std::string>& filenames, unsigned int blocks)
+{
+    close();
+    if (filenames.empty())
+        {
+            LOG(WARNING) << "Empty list of sample files";
+            return false;
+        }
+    unsigned long long total_bytes = 0;
+    for (unsigned int i = 0; i < filenames.size(); i++)
+        {
+            struct stat status;
+            if (stat(filenames[i].c_str(), &status) != 0 or S_ISREG(status.st_mode) == false)
+                {
+                    LOG(WARNING) << "Unable to open the samples file " << filenames[i];
+                    return false;
+                }
+            total_bytes += status.st_size;
+        }
+    d_filenames = filenames;
+    d_total_bytes = total_bytes;
+    d_blocks = std::max(blocks, 2u);
+    d_ring.reset(d_blocks);
+    d_bytes_read = 0;
+    d_current_file = 0;
+    d_open = true;
+    d_thread = boost::thread(&Sample_File_Sequence::prefetch, this);
+    LOG(INFO) << "Reading a sequence of " << d_filenames.size() << " files, " << d_total_bytes << " bytes";
+    return true;
+}
+
+
+void Sample_File_Sequence::close()
+{
+    if (d_open == false) return;
+    d_ring.stop();
+    d_thread.join();
+    d_ring.reset(d_blocks);
+    d_open = false;
+}
+
+
+bool Sample_File_Sequence::rewind()
+{
+    std::vector<std::string> filenames = d_filenames;
+    return open(filenames, d_blocks);
+}
+
+
+std::size_t Sample_File_Sequence::read(char* buffer, std::size_t nbytes)
+{
+    if (d_open == false) return 0;
+    std::size_t copied = d_ring.read(buffer, nbytes, &d_current_file);
+    d_bytes_read += copied;
+    return copied;
+}
+
+
+bool Sample_File_Sequence::failed() const
+{
+    return d_ring.failed();
+}
+
+
+// Prefetch thread: reads the files one after the other into the ring
+void Sample_File_Sequence::prefetch()
+{
+    for (unsigned int i = 0; i < d_filenames.size(); i++)
+        {
+            std::FILE* file = std::fopen(d_filenames[i].c_str(), "rb");
+            if (file == nullptr)
+                {
+                    LOG(ERROR) << "Unable to open the samples file " << d_filenames[i];
+                    d_ring.finish(true);
+                    return;
+                }
+#ifdef POSIX_FADV_SEQUENTIAL
+            posix_fadvise(fileno(file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+            LOG(INFO) << "Reading file " << i + 1 << " of " << d_filenames.size() << ": " << d_filenames[i];
+            while (true)
+                {
+                    boost::shared_ptr<Sample_Block> block(new Sample_Block());
+                    block->data.resize(SAMPLE_FILE_SEQUENCE_BLOCK_BYTES);
+                    block->source = i;
+                    std::size_t n = std::fread(block->data.data(), 1, block->data.size(), file);
+                    block->data.resize(n);
+                    if (n > 0 and d_ring.push(block) == false)
+                        {
+                            std::fclose(file);
+                            return;
+                        }
+                    if (n < SAMPLE_FILE_SEQUENCE_BLOCK_BYTES)
+                        {
+                            bool error = std::ferror(file);
+                            std::fclose(file);
+                            if (error)
+                                {
+                                    LOG(ERROR) << "Error reading the samples file " << d_filenames[i];
+                                    d_ring.finish(true);
+                                    return;
+                                }
+                            break;
+                        }
+                }
+        }
+    d_ring.finish(false);
+}
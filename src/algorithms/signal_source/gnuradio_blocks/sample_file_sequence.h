@@ -0,0 +1,112 @@
+/*!
+ * \file sample_file_sequence.h
+ * \brief Reads a sequence of sample files as one continuous stream
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SAMPLE_FILE_SEQUENCE_H_
+#define GNSS_SDR_SAMPLE_FILE_SEQUENCE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+#include "sample_block_ring.h"
+
+#define SAMPLE_FILE_SEQUENCE_BLOCK_BYTES 4194304   // bytes read from a file at a time (4 MB)
+
+/*!
+ * \brief This class reads a list of files of samples (for instance, a
+ * recording split in files of one minute) as one continuous stream of
+ * bytes, as if they had been concatenated.
+ *
+ * A prefetch thread reads the files in order into a bounded ring of
+ * blocks, opening the next file as soon as the previous one ends, so that
+ * the receiver does not wait for a file to be opened and its first bytes
+ * to be read at the boundaries.
+ */
+class Sample_File_Sequence
+{
+public:
+    Sample_File_Sequence();
+    ~Sample_File_Sequence();
+
+    /*!
+     * \brief Splits \p list at commas, semicolons and white space, and expands
+     * the wildcards (*, ?, [...]) of each entry. The files matching a
+     * pattern are sorted by name in natural order, comparing the numbers
+     * by value (capture_2 before capture_10, with or without zero padding);
+     * the entries keep their order. Returns an empty list if an entry
+     * matches no file.
+     */
+    static std::vector<std::string> expand(const std::string& list);
+
+    /*!
+     * \brief Opens the sequence of \p filenames, read ahead by at most
+     * \p blocks blocks of SAMPLE_FILE_SEQUENCE_BLOCK_BYTES. Returns false
+     * if a file does not exist.
+     */
+    bool open(const std::vector<std::string>& filenames, unsigned int blocks = 4);
+
+    //! Stops the prefetch thread and closes the files
+    void close();
+
+    //! Closes and opens again the sequence, to read it from the beginning
+    bool rewind();
+
+    bool is_open() const
+    {
+        return d_open;
+    }
+
+    /*!
+     * \brief Copies the next \p nbytes bytes of the sequence to \p buffer,
+     * waiting for them if needed. Returns the number of bytes copied,
+     * which is lower than \p nbytes only at the end of the last file or
+     * after a read error.
+     */
+    std::size_t read(char* buffer, std::size_t nbytes);
+
+    const std::vector<std::string>& filenames() const { return d_filenames; }
+    unsigned long long total_bytes() const { return d_total_bytes; }   //!< Sum of the sizes of the files
+    unsigned long long bytes_read() const { return d_bytes_read; }     //!< Bytes delivered so far
+    unsigned int current_file() const { return d_current_file; }       //!< Index of the file being delivered
+    bool failed() const;                                               //!< A file could not be opened or read
+
+private:
+    void prefetch();
+
+    std::vector<std::string> d_filenames;
+    unsigned long long d_total_bytes;
+    unsigned int d_blocks;
+    bool d_open;
+    Sample_Block_Ring d_ring;
+    unsigned long long d_bytes_read;
+    unsigned int d_current_file;
+    boost::thread d_thread;
+};
+
+#endif
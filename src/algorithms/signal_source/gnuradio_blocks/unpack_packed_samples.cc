@@ -0,0 +1,101 @@
+/*!
+ * \file unpack_packed_samples.cc
+ * \brief Unpacks 1, 2 or 4-bit real or I/Q samples packed in bytes
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "unpack_packed_samples.h"
+#include <complex>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/io_signature.h>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+unpack_packed_samples_sptr make_unpack_packed_samples(const Packed_Sample_Format& format,
+        const std::string& output_item_type)
+{
+    Packed_Sample_Format f = format;
+    std::string type = output_item_type;
+    if (type.compare("float") == 0 and f.complex == true)
+        {
+            LOG(WARNING) << "I/Q samples cannot be unpacked to float. Using gr_complex";
+            type = "gr_complex";
+        }
+    else if (type.compare("gr_complex") != 0 and type.compare("cbyte") != 0 and type.compare("float") != 0)
+        {
+            LOG(WARNING) << type << " unrecognized output item type. Using gr_complex";
+            type = "gr_complex";
+        }
+    if (f.bits != 1 and f.bits != 2 and f.bits != 4) f.bits = 2;   // the decoder warns about it
+    unsigned int samples_per_byte = 8 / f.bits;
+    unsigned int interpolation = f.complex ? samples_per_byte / 2 : samples_per_byte;
+    size_t item_size = sizeof(gr_complex);
+    if (type.compare("cbyte") == 0) item_size = sizeof(std::complex<signed char>);
+    if (type.compare("float") == 0) item_size = sizeof(float);
+    return unpack_packed_samples_sptr(new unpack_packed_samples(f, type.compare("cbyte") == 0, item_size, interpolation));
+}
+
+
+
+unpack_packed_samples::unpack_packed_samples(const Packed_Sample_Format& format, bool byte_output,
+        size_t output_item_size, unsigned int interpolation) :
+                sync_interpolator("unpack_packed_samples",
+                        gr::io_signature::make(1, 1, sizeof(unsigned char)),
+                        gr::io_signature::make(1, 1, output_item_size),
+                        interpolation),
+                d_decoder(format, output_item_size != sizeof(float)),
+                d_byte_output(byte_output)
+{
+    d_counters = gnss_block_counters(this);
+    // whole words of input
+    set_output_multiple(interpolation * d_decoder.word_bytes());
+}
+
+
+
+unpack_packed_samples::~unpack_packed_samples()
+{}
+
+
+
+int unpack_packed_samples::work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items)
+{
+    Gnss_Work_Timer work_timer(d_counters.get(), noutput_items);
+    const unsigned char *in = static_cast<const unsigned char*>(input_items[0]);
+    unsigned int nbytes = noutput_items / interpolation();
+    if (d_byte_output == true)
+        {
+            d_decoder.decode(in, nbytes, static_cast<signed char*>(output_items[0]));
+        }
+    else
+        {
+            d_decoder.decode(in, nbytes, static_cast<float*>(output_items[0]));
+        }
+    return noutput_items;
+}
@@ -0,0 +1,73 @@
+/*!
+ * \file unpack_packed_samples.h
+ * \brief Unpacks 1, 2 or 4-bit real or I/Q samples packed in bytes
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_UNPACK_PACKED_SAMPLES_H_
+#define GNSS_SDR_UNPACK_PACKED_SAMPLES_H_
+
+#include <string>
+#include <gnuradio/sync_interpolator.h>
+#include "packed_sample_decoder.h"
+#include "gnss_block_counters.h"
+
+class unpack_packed_samples;
+
+typedef boost::shared_ptr<unpack_packed_samples> unpack_packed_samples_sptr;
+
+/*!
+ * \brief Makes an unpacker of samples of the given \p format to
+ * \p output_item_type: "gr_complex", "cbyte" (8-bit I/Q) or, for real
+ * samples only, "float"
+ */
+unpack_packed_samples_sptr make_unpack_packed_samples(const Packed_Sample_Format& format,
+        const std::string& output_item_type);
+
+/*!
+ * \brief This class converts a stream of bytes of packed samples to
+ * gr_complex, 8-bit complex or float samples with a Packed_Sample_Decoder
+ */
+class unpack_packed_samples: public gr::sync_interpolator
+{
+private:
+    friend unpack_packed_samples_sptr make_unpack_packed_samples(const Packed_Sample_Format& format,
+            const std::string& output_item_type);
+    unpack_packed_samples(const Packed_Sample_Format& format, bool byte_output,
+            size_t output_item_size, unsigned int interpolation);
+
+    Packed_Sample_Decoder d_decoder;
+    bool d_byte_output;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
+
+public:
+    ~unpack_packed_samples();
+    int work (int noutput_items,
+              gr_vector_const_void_star &input_items,
+              gr_vector_void_star &output_items);
+};
+
+#endif
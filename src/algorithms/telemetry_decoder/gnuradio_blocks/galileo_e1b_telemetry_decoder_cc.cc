@@ -125,6 +125,7 @@ galileo_e1b_telemetry_decoder_cc::galileo_e1b_telemetry_decoder_cc(
            gr::block("galileo_e1b_telemetry_decoder_cc", gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)),
 	   gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)))
 {
+    d_counters = gnss_block_counters(this);
     // initialize internal vars
     d_queue = queue;
     d_dump = dump;
@@ -287,6 +288,7 @@ void galileo_e1b_telemetry_decoder_cc::decode_word(double *page_part_symbols,int
 int galileo_e1b_telemetry_decoder_cc::general_work (int noutput_items, gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items,	gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
     int corr_value = 0;
     int preamble_diff = 0;
 
@@ -487,20 +489,10 @@ int galileo_e1b_telemetry_decoder_cc::general_work (int noutput_items, gr_vector
     if(d_dump == true)
         {
             // MULTIPLEXED FILE RECORDING - Record results to file
-            try
-            {
-                    double tmp_double;
-                    tmp_double = d_TOW_at_current_symbol;
-                    d_dump_file.write((char*)&tmp_double, sizeof(double));
-                    tmp_double = current_synchro_data.Prn_timestamp_ms;
-                    d_dump_file.write((char*)&tmp_double, sizeof(double));
-                    tmp_double = d_TOW_at_Preamble;
-                    d_dump_file.write((char*)&tmp_double, sizeof(double));
-            }
-            catch (const std::ifstream::failure& e)
-            {
-                    LOG(WARNING) << "Exception writing observables dump file " << e.what();
-            }
+            d_dump_file.put<double>(d_TOW_at_current_symbol);
+            d_dump_file.put<double>(current_synchro_data.Prn_timestamp_ms);
+            d_dump_file.put<double>(d_TOW_at_Preamble);
+            d_dump_file.end_record();
         }
     //3. Make the output (copy the object contents to the GNURadio reserved memory)
     *out[0] = current_synchro_data;
@@ -527,19 +519,22 @@ void galileo_e1b_telemetry_decoder_cc::set_channel(int channel)
         {
             if (d_dump_file.is_open() == false)
                 {
-                    try
-                    {
-                            d_dump_filename = "telemetry";
-                            d_dump_filename.append(boost::lexical_cast<std::string>(d_channel));
-                            d_dump_filename.append(".dat");
-                            d_dump_file.exceptions ( std::ifstream::failbit | std::ifstream::badbit );
-                            d_dump_file.open(d_dump_filename.c_str(), std::ios::out | std::ios::binary);
-                            LOG(INFO) << "Telemetry decoder dump enabled on channel " << d_channel << " Log file: " << d_dump_filename.c_str();
-                    }
-                    catch (const std::ifstream::failure& e)
-                    {
-                            LOG(WARNING) << "channel " << d_channel << " Exception opening trk dump file " << e.what();
-                    }
+                    d_dump_filename = "telemetry";
+                    d_dump_filename.append(boost::lexical_cast<std::string>(d_channel));
+                    d_dump_filename.append(".dat");
+                    d_dump_file.set_attribute("source", "galileo_e1b_telemetry_decoder");
+                    d_dump_file.set_attribute("channel", d_channel);
+                    d_dump_file.add_field<double>("TOW_at_current_symbol");
+                    d_dump_file.add_field<double>("Prn_timestamp_ms");
+                    d_dump_file.add_field<double>("TOW_at_Preamble");
+                    if (d_dump_file.open(d_dump_filename))
+                        {
+                            LOG(INFO) << "Telemetry decoder dump enabled on channel " << d_channel << " Log file: " << d_dump_filename;
+                        }
+                    else
+                        {
+                            LOG(WARNING) << "channel " << d_channel << " Unable to open telemetry dump file " << d_dump_filename;
+                        }
                 }
         }
 }
@@ -41,12 +41,14 @@
 #include <gnuradio/fec/viterbi.h>
 #include "Galileo_E1.h"
 #include "concurrent_queue.h"
+#include "gnss_dump_writer.h"
 #include "gnss_satellite.h"
 #include "galileo_navigation_message.h"
 #include "galileo_ephemeris.h"
 #include "galileo_almanac.h"
 #include "galileo_iono.h"
 #include "galileo_utc_model.h"
+#include "gnss_block_counters.h"
 
 
 
@@ -143,7 +145,8 @@ private:
 
 
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Gnss_Dump_Writer d_dump_file;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 };
 
 #endif
@@ -201,6 +201,7 @@ galileo_e5a_telemetry_decoder_cc::galileo_e5a_telemetry_decoder_cc(
            gr::block("galileo_e5a_telemetry_decoder_cc", gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)),
 	   gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)))
 {
+    d_counters = gnss_block_counters(this);
     // initialize internal vars
     d_queue = queue;
     d_dump = dump;
@@ -270,6 +271,7 @@ galileo_e5a_telemetry_decoder_cc::~galileo_e5a_telemetry_decoder_cc()
 int galileo_e5a_telemetry_decoder_cc::general_work (int noutput_items, gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items,	gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
     //
     const Gnss_Synchro **in = (const Gnss_Synchro **)  &input_items[0]; //Get the input samples pointer
     Gnss_Synchro **out = (Gnss_Synchro **) &output_items[0];
@@ -558,20 +560,10 @@ int galileo_e5a_telemetry_decoder_cc::general_work (int noutput_items, gr_vector
     if(d_dump == true)
 	{
 	    // MULTIPLEXED FILE RECORDING - Record results to file
-	    try
-	    {
-		    double tmp_double;
-		    tmp_double = d_TOW_at_current_symbol;
-		    d_dump_file.write((char*)&tmp_double, sizeof(double));
-		    tmp_double = current_synchro_data.Prn_timestamp_ms;
-		    d_dump_file.write((char*)&tmp_double, sizeof(double));
-		    tmp_double = d_TOW_at_Preamble;
-		    d_dump_file.write((char*)&tmp_double, sizeof(double));
-	    }
-	    catch (const std::ifstream::failure& e)
-	    {
-		    LOG(WARNING) << "Exception writing observables dump file " << e.what();
-	    }
+	    d_dump_file.put<double>(d_TOW_at_current_symbol);
+	    d_dump_file.put<double>(current_synchro_data.Prn_timestamp_ms);
+	    d_dump_file.put<double>(d_TOW_at_Preamble);
+	    d_dump_file.end_record();
 	}
     d_sample_counter++; //count for the processed samples
     //3. Make the output (copy the object contents to the GNURadio reserved memory)
@@ -596,19 +588,22 @@ void galileo_e5a_telemetry_decoder_cc::set_channel(int channel)
         {
             if (d_dump_file.is_open() == false)
                 {
-                    try
-                    {
-                            d_dump_filename = "telemetry";
-                            d_dump_filename.append(boost::lexical_cast<std::string>(d_channel));
-                            d_dump_filename.append(".dat");
-                            d_dump_file.exceptions ( std::ifstream::failbit | std::ifstream::badbit );
-                            d_dump_file.open(d_dump_filename.c_str(), std::ios::out | std::ios::binary);
-                            LOG(INFO) << "Telemetry decoder dump enabled on channel " << d_channel << " Log file: " << d_dump_filename.c_str();
-                    }
-                    catch (const std::ifstream::failure& e)
-                    {
-                            LOG(WARNING) << "channel " << d_channel << " Exception opening trk dump file " << e.what();
-                    }
+                    d_dump_filename = "telemetry";
+                    d_dump_filename.append(boost::lexical_cast<std::string>(d_channel));
+                    d_dump_filename.append(".dat");
+                    d_dump_file.set_attribute("source", "galileo_e5a_telemetry_decoder");
+                    d_dump_file.set_attribute("channel", d_channel);
+                    d_dump_file.add_field<double>("TOW_at_current_symbol");
+                    d_dump_file.add_field<double>("Prn_timestamp_ms");
+                    d_dump_file.add_field<double>("TOW_at_Preamble");
+                    if (d_dump_file.open(d_dump_filename))
+                        {
+                            LOG(INFO) << "Telemetry decoder dump enabled on channel " << d_channel << " Log file: " << d_dump_filename;
+                        }
+                    else
+                        {
+                            LOG(WARNING) << "channel " << d_channel << " Unable to open telemetry dump file " << d_dump_filename;
+                        }
                 }
         }
 }
@@ -45,12 +45,14 @@
 //#include <gnuradio/fec/viterbi.h>
 #include "Galileo_E5a.h"
 #include "concurrent_queue.h"
+#include "gnss_dump_writer.h"
 #include "gnss_satellite.h"
 #include "galileo_fnav_message.h"
 #include "galileo_ephemeris.h"
 #include "galileo_almanac.h"
 #include "galileo_iono.h"
 #include "galileo_utc_model.h"
+#include "gnss_block_counters.h"
 
 //#include "convolutional.h"
 
@@ -148,7 +150,8 @@ private:
     bool flag_TOW_set;
 
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Gnss_Dump_Writer d_dump_file;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 };
 
 #endif /* GNSS_SDR_GALILEO_E5A_TELEMETRY_DECODER_CC_H_ */
@@ -38,7 +38,9 @@
 #include "GPS_L1_CA.h"
 #include "gps_l1_ca_subframe_fsm.h"
 #include "concurrent_queue.h"
+#include "gnss_dump_writer.h"
 #include "gnss_satellite.h"
+#include "gnss_block_counters.h"
 
 
 
@@ -146,7 +148,8 @@ private:
     bool flag_TOW_set;
 
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Gnss_Dump_Writer d_dump_file;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 };
 
 #endif
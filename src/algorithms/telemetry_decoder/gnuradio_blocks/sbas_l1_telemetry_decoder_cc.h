@@ -43,6 +43,7 @@
 #include "gnss_satellite.h"
 #include "viterbi_decoder.h"
 #include "sbas_telemetry_data.h"
+#include "gnss_block_counters.h"
 
 class sbas_l1_telemetry_decoder_cc;
 
@@ -173,6 +174,7 @@ private:
 
 
     Sbas_Telemetry_Data sbas_telemetry_data;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 };
 
 #endif
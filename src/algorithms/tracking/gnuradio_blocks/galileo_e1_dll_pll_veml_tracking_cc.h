@@ -41,10 +41,13 @@
 #include <gnuradio/block.h>
 #include <gnuradio/msg_queue.h>
 #include "concurrent_queue.h"
+#include "gnss_dump_writer.h"
 #include "gnss_synchro.h"
 #include "tracking_2nd_DLL_filter.h"
 #include "tracking_2nd_PLL_filter.h"
 #include "correlator.h"
+#include "gnss_block_counters.h"
+#include "gnss_latency.h"
 
 class galileo_e1_dll_pll_veml_tracking_cc;
 
@@ -186,10 +189,11 @@ private:
 
     // file dump
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Gnss_Dump_Writer d_dump_file;
 
     std::map<std::string, std::string> systemName;
     std::string sys;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 };
 
 #endif //GNSS_SDR_GALILEO_E1_DLL_PLL_VEML_TRACKING_CC_H
@@ -48,9 +48,12 @@
 #include <gnuradio/block.h>
 #include <gnuradio/msg_queue.h>
 #include "concurrent_queue.h"
+#include "gnss_dump_writer.h"
 #include "gnss_synchro.h"
 #include "correlator.h"
 #include "tcp_communication.h"
+#include "gnss_block_counters.h"
+#include "gnss_latency.h"
 
 
 class Galileo_E1_Tcp_Connector_Tracking_cc;
@@ -195,10 +198,11 @@ private:
 
     // file dump
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Gnss_Dump_Writer d_dump_file;
 
     std::map<std::string, std::string> systemName;
     std::string sys;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 };
 
 #endif //GNSS_SDR_GALILEO_E1_TCP_CONNECTOR_TRACKING_CC_H
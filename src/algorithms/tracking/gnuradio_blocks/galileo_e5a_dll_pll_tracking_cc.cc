@@ -104,6 +104,7 @@ Galileo_E5a_Dll_Pll_Tracking_cc::Galileo_E5a_Dll_Pll_Tracking_cc(
         gr::block("Galileo_E5a_Dll_Pll_Tracking_cc", gr::io_signature::make(1, 1, sizeof(gr_complex)),
                 gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)))
 {
+    d_counters = gnss_block_counters(this);
     this->set_relative_rate(1.0/vector_length);
     // initialize internal vars
     d_queue = queue;
@@ -380,6 +381,7 @@ void Galileo_E5a_Dll_Pll_Tracking_cc::update_local_carrier()
 int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items, gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
     // process vars
     float carr_error_hz;
     float carr_error_filt_hz;
@@ -642,7 +644,7 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items, gr_vector_
 				    {
 					if (d_carrier_lock_fail_counter > 0) d_carrier_lock_fail_counter--;
 
-					if (d_carrier_lock_fail_counter > MAXIMUM_LOCK_FAIL_COUNTER)
+					if (d_carrier_lock_fail_counter > MAXIMUM_LOCK_FAIL_COUNTER or gnss_channel_progress().released(d_channel))
 					    {
 						std::cout << "Loss of lock in channel " << d_channel << "!" << std::endl;
 						LOG(INFO) << "Loss of lock in channel " << d_channel << "!";
@@ -687,6 +689,7 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items, gr_vector_
 			current_synchro_data.CN0_dB_hz = 0.0;
 			current_synchro_data.Flag_valid_tracking = false;
 		    }
+		gnss_latency_stamp(current_synchro_data, nitems_read(0) + d_current_prn_length_samples);
 		*out[0] = current_synchro_data;
 	    }
     }
@@ -706,46 +709,40 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items, gr_vector_
         	    tmp_P = std::abs<float>(d_Prompt);
         	    tmp_L = std::abs<float>(d_Late);
         	}
-            try
-            {
-        	// EPR
-        	d_dump_file.write(reinterpret_cast<char*>(&tmp_E), sizeof(float));
-        	d_dump_file.write(reinterpret_cast<char*>(&tmp_P), sizeof(float));
-        	d_dump_file.write(reinterpret_cast<char*>(&tmp_L), sizeof(float));
-        	// PROMPT I and Q (to analyze navigation symbols)
-        	d_dump_file.write(reinterpret_cast<char*>(&prompt_I), sizeof(float));
-        	d_dump_file.write(reinterpret_cast<char*>(&prompt_Q), sizeof(float));
-        	// PRN start sample stamp
-        	d_dump_file.write(reinterpret_cast<char*>(&d_sample_counter), sizeof(unsigned long int));
-        	// accumulated carrier phase
-        	d_dump_file.write(reinterpret_cast<char*>(&d_acc_carrier_phase_rad), sizeof(float));
-
-        	// carrier and code frequency
-        	d_dump_file.write(reinterpret_cast<char*>(&d_carrier_doppler_hz), sizeof(float));
-        	d_dump_file.write(reinterpret_cast<char*>(&d_code_freq_chips), sizeof(float));
-
-        	//PLL commands
-        	d_dump_file.write(reinterpret_cast<char*>(&carr_error_hz), sizeof(float));
-        	d_dump_file.write(reinterpret_cast<char*>(&carr_error_filt_hz), sizeof(float));
-
-        	//DLL commands
-        	d_dump_file.write(reinterpret_cast<char*>(&code_error_chips), sizeof(float));
-        	d_dump_file.write(reinterpret_cast<char*>(&code_error_filt_chips), sizeof(float));
-
-        	// CN0 and carrier lock test
-        	d_dump_file.write(reinterpret_cast<char*>(&d_CN0_SNV_dB_Hz), sizeof(float));
-        	d_dump_file.write(reinterpret_cast<char*>(&d_carrier_lock_test), sizeof(float));
-
-        	// AUX vars (for debug purposes)
-        	tmp_float = d_rem_code_phase_samples;
-        	d_dump_file.write(reinterpret_cast<char*>(&tmp_float), sizeof(float));
-        	tmp_double = static_cast<double>(d_sample_counter + d_current_prn_length_samples);
-        	d_dump_file.write(reinterpret_cast<char*>(&tmp_double), sizeof(double));
-            }
-            catch (std::ifstream::failure e)
-            {
-                LOG(WARNING) << "Exception writing trk dump file " << e.what();
-            }
+            // EPR
+            d_dump_file.put<float>(tmp_E);
+            d_dump_file.put<float>(tmp_P);
+            d_dump_file.put<float>(tmp_L);
+            // PROMPT I and Q (to analyze navigation symbols)
+            d_dump_file.put<float>(prompt_I);
+            d_dump_file.put<float>(prompt_Q);
+            // PRN start sample stamp
+            d_dump_file.put<unsigned long int>(d_sample_counter);
+            // accumulated carrier phase
+            d_dump_file.put<float>(d_acc_carrier_phase_rad);
+
+            // carrier and code frequency
+            d_dump_file.put<float>(d_carrier_doppler_hz);
+            d_dump_file.put<float>(d_code_freq_chips);
+
+            //PLL commands
+            d_dump_file.put<float>(carr_error_hz);
+            d_dump_file.put<float>(carr_error_filt_hz);
+
+            //DLL commands
+            d_dump_file.put<float>(code_error_chips);
+            d_dump_file.put<float>(code_error_filt_chips);
+
+            // CN0 and carrier lock test
+            d_dump_file.put<float>(d_CN0_SNV_dB_Hz);
+            d_dump_file.put<float>(d_carrier_lock_test);
+
+            // AUX vars (for debug purposes)
+            tmp_float = d_rem_code_phase_samples;
+            d_dump_file.put<float>(tmp_float);
+            tmp_double = static_cast<double>(d_sample_counter + d_current_prn_length_samples);
+            d_dump_file.put<double>(tmp_double);
+            d_dump_file.end_record();
         }
 
     d_secondary_delay = (d_secondary_delay + 1) % Galileo_E5a_Q_SECONDARY_CODE_LENGTH;
@@ -763,18 +760,36 @@ void Galileo_E5a_Dll_Pll_Tracking_cc::set_channel(unsigned int channel)
         {
             if (d_dump_file.is_open() == false)
                 {
-                    try
-                    {
-                            d_dump_filename.append(boost::lexical_cast<std::string>(d_channel));
-                            d_dump_filename.append(".dat");
-                            d_dump_file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-                            d_dump_file.open(d_dump_filename.c_str(), std::ios::out | std::ios::binary);
-                            LOG(INFO) << "Tracking dump enabled on channel " << d_channel << " Log file: " << d_dump_filename.c_str() << std::endl;
-                    }
-                    catch (std::ifstream::failure e)
-                    {
-                            LOG(WARNING) << "channel " << d_channel << " Exception opening trk dump file " << e.what() << std::endl;
-                    }
+                    d_dump_filename.append(boost::lexical_cast<std::string>(d_channel));
+                    d_dump_filename.append(".dat");
+                    d_dump_file.set_attribute("source", "galileo_e5a_dll_pll_tracking");
+                    d_dump_file.set_attribute("channel", d_channel);
+                    d_dump_file.set_attribute("sample_rate_hz", d_fs_in);
+                    d_dump_file.add_field<float>("abs_E");
+                    d_dump_file.add_field<float>("abs_P");
+                    d_dump_file.add_field<float>("abs_L");
+                    d_dump_file.add_field<float>("prompt_I");
+                    d_dump_file.add_field<float>("prompt_Q");
+                    d_dump_file.add_field<unsigned long int>("PRN_start_sample_count");
+                    d_dump_file.add_field<float>("acc_carrier_phase_rad");
+                    d_dump_file.add_field<float>("carrier_doppler_hz");
+                    d_dump_file.add_field<float>("code_freq_chips");
+                    d_dump_file.add_field<float>("carr_error_hz");
+                    d_dump_file.add_field<float>("carr_error_filt_hz");
+                    d_dump_file.add_field<float>("code_error_chips");
+                    d_dump_file.add_field<float>("code_error_filt_chips");
+                    d_dump_file.add_field<float>("CN0_SNV_dB_Hz");
+                    d_dump_file.add_field<float>("carrier_lock_test");
+                    d_dump_file.add_field<float>("rem_code_phase_samples");
+                    d_dump_file.add_field<double>("PRN_end_sample_count");
+                    if (d_dump_file.open(d_dump_filename))
+                        {
+                            LOG(INFO) << "Tracking dump enabled on channel " << d_channel << " Log file: " << d_dump_filename;
+                        }
+                    else
+                        {
+                            LOG(WARNING) << "channel " << d_channel << " Unable to open trk dump file " << d_dump_filename;
+                        }
                 }
         }
 }
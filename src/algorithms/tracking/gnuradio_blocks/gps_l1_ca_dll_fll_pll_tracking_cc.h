@@ -49,8 +49,11 @@
 #include "gps_sdr_signal_processing.h"
 #include "tracking_FLL_PLL_filter.h"
 #include "tracking_2nd_DLL_filter.h"
+#include "gnss_dump_writer.h"
 #include "gnss_synchro.h"
 #include "correlator.h"
+#include "gnss_block_counters.h"
+#include "gnss_latency.h"
 
 class Gps_L1_Ca_Dll_Fll_Pll_Tracking_cc;
 
@@ -201,10 +204,11 @@ private:
     bool d_enable_tracking;
 
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Gnss_Dump_Writer d_dump_file;
 
     std::map<std::string, std::string> systemName;
     std::string sys;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 };
 
 #endif //GNSS_SDR_GPS_L1_CA_DLL_FLL_PLL_TRACKING_CC_H
@@ -101,6 +101,7 @@ Gps_L1_Ca_Dll_Pll_Optim_Tracking_cc::Gps_L1_Ca_Dll_Pll_Optim_Tracking_cc(
                   gr::io_signature::make(1, 1, sizeof(gr_complex)),
                   gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)))
 {
+    d_counters = gnss_block_counters(this);
     // initialize internal vars
     d_queue = queue;
     d_dump = dump;
@@ -326,6 +327,7 @@ Gps_L1_Ca_Dll_Pll_Optim_Tracking_cc::~Gps_L1_Ca_Dll_Pll_Optim_Tracking_cc()
 int Gps_L1_Ca_Dll_Pll_Optim_Tracking_cc::general_work (int noutput_items, gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
+    Gnss_Work_Timer work_timer(d_counters.get(), ninput_items[0]);
     // stream to collect cout calls to improve thread safety
     std::stringstream tmp_str_stream;
     float carr_error_hz;
@@ -448,7 +450,7 @@ int Gps_L1_Ca_Dll_Pll_Optim_Tracking_cc::general_work (int noutput_items, gr_vec
                         {
                             if (d_carrier_lock_fail_counter > 0) d_carrier_lock_fail_counter--;
                         }
-                    if (d_carrier_lock_fail_counter > MAXIMUM_LOCK_FAIL_COUNTER)
+                    if (d_carrier_lock_fail_counter > MAXIMUM_LOCK_FAIL_COUNTER or gnss_channel_progress().released(d_channel))
                         {
                             std::cout << "Loss of lock in channel " << d_channel << "!" << std::endl;
                             LOG(INFO) << "Loss of lock in channel " << d_channel << "!";
@@ -473,6 +475,7 @@ int Gps_L1_Ca_Dll_Pll_Optim_Tracking_cc::general_work (int noutput_items, gr_vec
             current_synchro_data.Carrier_phase_rads = static_cast<double>(d_acc_carrier_phase_rad);
             current_synchro_data.Carrier_Doppler_hz = static_cast<double>(d_carrier_doppler_hz);
             current_synchro_data.CN0_dB_hz = static_cast<double>(d_CN0_SNV_dB_Hz);
+            gnss_latency_stamp(current_synchro_data, nitems_read(0) + d_current_prn_length_samples);
             *out[0] = current_synchro_data;
 
             // ########## DEBUG OUTPUT
@@ -538,47 +541,40 @@ int Gps_L1_Ca_Dll_Pll_Optim_Tracking_cc::general_work (int noutput_items, gr_vec
             tmp_E = std::abs<float>(*d_Early);
             tmp_P = std::abs<float>(*d_Prompt);
             tmp_L = std::abs<float>(*d_Late);
-            try
-            {
-                    // EPR
-                    d_dump_file.write((char*)&tmp_E, sizeof(float));
-                    d_dump_file.write((char*)&tmp_P, sizeof(float));
-                    d_dump_file.write((char*)&tmp_L, sizeof(float));
-                    // PROMPT I and Q (to analyze navigation symbols)
-                    d_dump_file.write((char*)&prompt_I, sizeof(float));
-                    d_dump_file.write((char*)&prompt_Q, sizeof(float));
-                    // PRN start sample stamp
-                    //tmp_float=(float)d_sample_counter;
-                    d_dump_file.write((char*)&d_sample_counter, sizeof(unsigned long int));
-                    // accumulated carrier phase
-                    d_dump_file.write((char*)&d_acc_carrier_phase_rad, sizeof(float));
-
-                    // carrier and code frequency
-                    d_dump_file.write((char*)&d_carrier_doppler_hz, sizeof(float));
-                    d_dump_file.write((char*)&d_code_freq_chips, sizeof(float));
-
-                    //PLL commands
-                    d_dump_file.write((char*)&carr_error_hz, sizeof(float));
-                    d_dump_file.write((char*)&carr_error_filt_hz, sizeof(float));
-
-                    //DLL commands
-                    d_dump_file.write((char*)&code_error_chips, sizeof(float));
-                    d_dump_file.write((char*)&code_error_filt_chips, sizeof(float));
-
-                    // CN0 and carrier lock test
-                    d_dump_file.write((char*)&d_CN0_SNV_dB_Hz, sizeof(float));
-                    d_dump_file.write((char*)&d_carrier_lock_test, sizeof(float));
-
-                    // AUX vars (for debug purposes)
-                    tmp_float = d_rem_code_phase_samples;
-                    d_dump_file.write((char*)&tmp_float, sizeof(float));
-                    tmp_double = (double)(d_sample_counter + d_current_prn_length_samples);
-                    d_dump_file.write((char*)&tmp_double, sizeof(double));
-            }
-            catch (std::ifstream::failure& e)
-            {
-                    LOG(WARNING) << "Exception writing trk dump file " << e.what();
-            }
+            // EPR
+            d_dump_file.put<float>(tmp_E);
+            d_dump_file.put<float>(tmp_P);
+            d_dump_file.put<float>(tmp_L);
+            // PROMPT I and Q (to analyze navigation symbols)
+            d_dump_file.put<float>(prompt_I);
+            d_dump_file.put<float>(prompt_Q);
+            // PRN start sample stamp
+            d_dump_file.put<unsigned long int>(d_sample_counter);
+            // accumulated carrier phase
+            d_dump_file.put<float>(d_acc_carrier_phase_rad);
+
+            // carrier and code frequency
+            d_dump_file.put<float>(d_carrier_doppler_hz);
+            d_dump_file.put<float>(d_code_freq_chips);
+
+            //PLL commands
+            d_dump_file.put<float>(carr_error_hz);
+            d_dump_file.put<float>(carr_error_filt_hz);
+
+            //DLL commands
+            d_dump_file.put<float>(code_error_chips);
+            d_dump_file.put<float>(code_error_filt_chips);
+
+            // CN0 and carrier lock test
+            d_dump_file.put<float>(d_CN0_SNV_dB_Hz);
+            d_dump_file.put<float>(d_carrier_lock_test);
+
+            // AUX vars (for debug purposes)
+            tmp_float = d_rem_code_phase_samples;
+            d_dump_file.put<float>(tmp_float);
+            tmp_double = (double)(d_sample_counter + d_current_prn_length_samples);
+            d_dump_file.put<double>(tmp_double);
+            d_dump_file.end_record();
         }
 
     consume_each(d_current_prn_length_samples); // this is necesary in gr_block derivates
@@ -597,18 +593,36 @@ void Gps_L1_Ca_Dll_Pll_Optim_Tracking_cc::set_channel(unsigned int channel)
         {
             if (d_dump_file.is_open() == false)
                 {
-                    try
-                    {
-                            d_dump_filename.append(boost::lexical_cast<std::string>(d_channel));
-                            d_dump_filename.append(".dat");
-                            d_dump_file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-                            d_dump_file.open(d_dump_filename.c_str(), std::ios::out | std::ios::binary);
-                            LOG(INFO) << "Tracking dump enabled on channel " << d_channel << " Log file: " << d_dump_filename.c_str();
-                    }
-                    catch (std::ifstream::failure& e)
-                    {
-                            LOG(WARNING) << "channel " << d_channel << " Exception opening trk dump file " << e.what();
-                    }
+                    d_dump_filename.append(boost::lexical_cast<std::string>(d_channel));
+                    d_dump_filename.append(".dat");
+                    d_dump_file.set_attribute("source", "gps_l1_ca_dll_pll_optim_tracking");
+                    d_dump_file.set_attribute("channel", d_channel);
+                    d_dump_file.set_attribute("sample_rate_hz", d_fs_in);
+                    d_dump_file.add_field<float>("abs_E");
+                    d_dump_file.add_field<float>("abs_P");
+                    d_dump_file.add_field<float>("abs_L");
+                    d_dump_file.add_field<float>("prompt_I");
+                    d_dump_file.add_field<float>("prompt_Q");
+                    d_dump_file.add_field<unsigned long int>("PRN_start_sample_count");
+                    d_dump_file.add_field<float>("acc_carrier_phase_rad");
+                    d_dump_file.add_field<float>("carrier_doppler_hz");
+                    d_dump_file.add_field<float>("code_freq_chips");
+                    d_dump_file.add_field<float>("carr_error_hz");
+                    d_dump_file.add_field<float>("carr_error_filt_hz");
+                    d_dump_file.add_field<float>("code_error_chips");
+                    d_dump_file.add_field<float>("code_error_filt_chips");
+                    d_dump_file.add_field<float>("CN0_SNV_dB_Hz");
+                    d_dump_file.add_field<float>("carrier_lock_test");
+                    d_dump_file.add_field<float>("rem_code_phase_samples");
+                    d_dump_file.add_field<double>("PRN_end_sample_count");
+                    if (d_dump_file.open(d_dump_filename))
+                        {
+                            LOG(INFO) << "Tracking dump enabled on channel " << d_channel << " Log file: " << d_dump_filename;
+                        }
+                    else
+                        {
+                            LOG(WARNING) << "channel " << d_channel << " Unable to open trk dump file " << d_dump_filename;
+                        }
                 }
         }
 }
@@ -47,10 +47,13 @@
 #include <gnuradio/msg_queue.h>
 #include "concurrent_queue.h"
 #include "gps_sdr_signal_processing.h"
+#include "gnss_dump_writer.h"
 #include "gnss_synchro.h"
 #include "tracking_2nd_DLL_filter.h"
 #include "tracking_2nd_PLL_filter.h"
 #include "correlator.h"
+#include "gnss_block_counters.h"
+#include "gnss_latency.h"
 
 class Gps_L1_Ca_Dll_Pll_Tracking_cc;
 
@@ -179,10 +182,11 @@ private:
 
     // file dump
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Gnss_Dump_Writer d_dump_file;
 
     std::map<std::string, std::string> systemName;
     std::string sys;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 };
 
 #endif //GNSS_SDR_GPS_L1_CA_DLL_PLL_TRACKING_CC_H
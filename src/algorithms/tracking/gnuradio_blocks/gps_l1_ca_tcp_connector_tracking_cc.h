@@ -47,11 +47,14 @@
 #include <gnuradio/msg_queue.h>
 #include "concurrent_queue.h"
 #include "gps_sdr_signal_processing.h"
+#include "gnss_dump_writer.h"
 #include "gnss_synchro.h"
 #include "tracking_2nd_DLL_filter.h"
 #include "tracking_2nd_PLL_filter.h"
 #include "correlator.h"
 #include "tcp_communication.h"
+#include "gnss_block_counters.h"
+#include "gnss_latency.h"
 
 
 
@@ -196,10 +199,11 @@ private:
 
     // file dump
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Gnss_Dump_Writer d_dump_file;
 
     std::map<std::string, std::string> systemName;
     std::string sys;
+    std::shared_ptr<Gnss_Block_Counters> d_counters;
 };
 
 #endif //GNSS_SDR_GPS_L1_CA_TCP_CONNECTOR_TRACKING_CC_H
@@ -64,6 +64,7 @@ public:
     virtual void set_local_code() = 0;
     virtual signed int mag() = 0;
     virtual void reset() = 0;
+    virtual void release() = 0;   //!< Frees the search grid of an idle acquisition, until the next init()
 };
 
 #endif /* GNSS_SDR_ACQUISITION_INTERFACE */
@@ -40,6 +40,10 @@
 #include "gnss_block_interface.h"
 #include "gnss_signal.h"
 
+class AcquisitionInterface;
+class TrackingInterface;
+class TelemetryDecoderInterface;
+
 /*!
  * \brief This abstract class represents an interface to a channel GNSS block.
  *
@@ -57,6 +61,13 @@ public:
     virtual void start() = 0;
     virtual void standby() = 0;
     virtual void stop() = 0;
+    //! Searches with twice the Doppler step from the next acquisition on, or back with the configured step
+    virtual void set_coarse_acquisition(bool coarse) = 0;
+    //! Takes an idle channel out of the channel pool, freeing what it only needs to search, or puts it back
+    virtual void park(bool parked) = 0;
+    virtual AcquisitionInterface* acquisition() = 0;
+    virtual TrackingInterface* tracking() = 0;
+    virtual TelemetryDecoderInterface* telemetry() = 0;
 };
 
 #endif /* GNSS_SDR_CHANNEL_INTERFACE_H_ */
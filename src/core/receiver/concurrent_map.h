@@ -31,7 +31,9 @@
 #ifndef GNSS_SDR_CONCURRENT_MAP_H
 #define GNSS_SDR_CONCURRENT_MAP_H
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <utility>
 #include <boost/thread/mutex.hpp>
 
@@ -41,14 +43,34 @@ template<typename Data>
 /*!
  * \brief This class implements a thread-safe std::map
  *
+ * Writers modify the map under a mutex and then publish an immutable
+ * snapshot of it together with a new version number (read-copy-update).
+ * Readers can check version() and grab the current snapshot without
+ * taking the mutex, so that they only need to copy the contents when
+ * something has actually changed.
  */
 class concurrent_map
 {
     typedef typename std::map<int,Data>::iterator Data_iterator; // iterator is scope dependent
+    typedef typename std::map<int,Data>::const_iterator Data_const_iterator;
 private:
     std::map<int,Data> the_map;
+    std::shared_ptr<const std::map<int,Data> > the_snapshot;
+    std::atomic<unsigned long int> the_version;
     boost::mutex the_mutex;
+
+    // must be called with the_mutex locked
+    void publish()
+    {
+        std::shared_ptr<const std::map<int,Data> > snapshot = std::make_shared<const std::map<int,Data> >(the_map);
+        std::atomic_store(&the_snapshot, snapshot);
+        the_version.fetch_add(1);
+    }
+
 public:
+    concurrent_map() : the_snapshot(std::make_shared<const std::map<int,Data> >()), the_version(0)
+    {}
+
     void write(int key, Data const& data)
     {
         boost::mutex::scoped_lock lock(the_mutex);
@@ -62,37 +84,94 @@ public:
             {
                 the_map.insert(std::pair<int, Data>(key, data)); // insert SILENTLY fails if the item already exists in the map!
             }
+        publish();
         lock.unlock();
     }
 
+    /*!
+     * \brief Version number of the published snapshot. It starts at 0
+     * (nothing written yet) and is increased by each write. Lock-free.
+     */
+    unsigned long int version() const
+    {
+        return the_version.load();
+    }
+
+    /*!
+     * \brief Returns the current immutable snapshot of the map without
+     * taking the writers mutex. \p version is set to a version number
+     * not newer than the returned snapshot, so comparing it later against
+     * version() never misses an update.
+     */
+    std::shared_ptr<const std::map<int,Data> > get_snapshot(unsigned long int& version) const
+    {
+        version = the_version.load();
+        return std::atomic_load(&the_snapshot);
+    }
+
+    std::shared_ptr<const std::map<int,Data> > get_snapshot() const
+    {
+        return std::atomic_load(&the_snapshot);
+    }
+
+    /*!
+     * \brief Copies the map into \p map_copy only if a newer version than
+     * \p version has been published since the last call. Returns true (and
+     * updates \p version) if the copy was refreshed.
+     */
+    bool get_map_copy_if_updated(std::map<int,Data>& map_copy, unsigned long int& version) const
+    {
+        if (the_version.load() == version)
+            {
+                return false;
+            }
+        map_copy = *get_snapshot(version);
+        return true;
+    }
+
+    /*!
+     * \brief Reads the element at \p key only if a newer version than
+     * \p version has been published since the last call. Returns true if
+     * \p p_data was refreshed.
+     */
+    bool read_if_updated(int key, Data& p_data, unsigned long int& version) const
+    {
+        if (the_version.load() == version)
+            {
+                return false;
+            }
+        std::shared_ptr<const std::map<int,Data> > snapshot = get_snapshot(version);
+        Data_const_iterator data_iter = snapshot->find(key);
+        if (data_iter != snapshot->end())
+            {
+                p_data = data_iter->second;
+                return true;
+            }
+        return false;
+    }
+
     std::map<int,Data> get_map_copy()
     {
-        boost::mutex::scoped_lock lock(the_mutex);
-        return the_map;
-        lock.unlock();
+        return *get_snapshot();
     }
 
     int size()
     {
-        boost::mutex::scoped_lock lock(the_mutex);
-        return the_map.size();
-        lock.unlock();
+        return get_snapshot()->size();
     }
 
     bool read(int key, Data& p_data)
     {
-        boost::mutex::scoped_lock lock(the_mutex);
-        Data_iterator data_iter;
-        data_iter = the_map.find(key);
-        if (data_iter != the_map.end())
+        std::shared_ptr<const std::map<int,Data> > snapshot = get_snapshot();
+        Data_const_iterator data_iter;
+        data_iter = snapshot->find(key);
+        if (data_iter != snapshot->end())
             {
                 p_data = data_iter->second;
-                lock.unlock();
                 return true;
             }
         else
             {
-                lock.unlock();
                 return false;
             }
     }
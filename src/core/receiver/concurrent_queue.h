@@ -32,6 +32,7 @@
 #define GNSS_SDR_CONCURRENT_QUEUE_H
 
 #include <queue>
+#include <boost/function.hpp>
 #include <boost/thread.hpp>
 
 template<typename Data>
@@ -42,6 +43,9 @@ template<typename Data>
  * Thread-safe object queue which uses the library
  * boost_thread to perform MUTEX based on the code available at
  * http://www.justsoftwaresolutions.co.uk/threading/implementing-a-thread-safe-queue-using-condition-variables.html
+ *
+ * With a listener, the items pushed are handed to it instead of being
+ * queued, so that no thread has to wait on the queue.
  */
 class concurrent_queue
 {
@@ -49,10 +53,16 @@ private:
     std::queue<Data> the_queue;
     mutable boost::mutex the_mutex;
     boost::condition_variable the_condition_variable;
+    boost::function<void(Data const&)> the_listener;
 public:
     void push(Data const& data)
     {
         boost::mutex::scoped_lock lock(the_mutex);
+        if(the_listener)
+            {
+                the_listener(data);
+                return;
+            }
         the_queue.push(data);
         lock.unlock();
         the_condition_variable.notify_one();
@@ -86,5 +96,21 @@ public:
         popped_value = the_queue.front();
         the_queue.pop();
     }
+
+    /*!
+     * \brief Hands the queued items, and from now on every pushed item,
+     * to \p listener, which must not block. An empty listener queues the
+     * items again; once it is set, the old listener is not called anymore.
+     */
+    void set_listener(boost::function<void(Data const&)> listener)
+    {
+        boost::mutex::scoped_lock lock(the_mutex);
+        the_listener = listener;
+        while(the_listener and !the_queue.empty())
+            {
+                the_listener(the_queue.front());
+                the_queue.pop();
+            }
+    }
 };
 #endif
@@ -34,6 +34,7 @@
 
 #include "control_thread.h"
 #include <unistd.h>
+#include <ctime>
 #include <iostream>
 #include <map>
 #include <string>
@@ -52,7 +53,9 @@
 #include "galileo_almanac.h"
 #include "concurrent_queue.h"
 #include "concurrent_map.h"
+#include "gnss_event_loop.h"
 #include "gnss_flowgraph.h"
+#include "gnss_receiver_state.h"
 #include "file_configuration.h"
 #include "control_message_factory.h"
 
@@ -151,18 +154,14 @@ void ControlThread::run()
     // start the keyboard_listener thread
     keyboard_thread_ = boost::thread(&ControlThread::keyboard_listener, this);
 
-    //start the GNSS SV data collector thread
-    gps_ephemeris_data_collector_thread_ = boost::thread(&ControlThread::gps_ephemeris_data_collector, this);
-    gps_iono_data_collector_thread_ = boost::thread(&ControlThread::gps_iono_data_collector, this);
-    gps_utc_model_data_collector_thread_ = boost::thread(&ControlThread::gps_utc_model_data_collector, this);
-    gps_acq_assist_data_collector_thread_= boost::thread(&ControlThread::gps_acq_assist_data_collector, this);
-    gps_ref_location_data_collector_thread_ = boost::thread(&ControlThread::gps_ref_location_data_collector, this);
-    gps_ref_time_data_collector_thread_ = boost::thread(&ControlThread::gps_ref_time_data_collector, this);
-
-    galileo_ephemeris_data_collector_thread_ = boost::thread(&ControlThread::galileo_ephemeris_data_collector, this);
-    galileo_iono_data_collector_thread_ = boost::thread(&ControlThread::galileo_iono_data_collector, this);
-    galileo_almanac_data_collector_thread_ = boost::thread(&ControlThread::galileo_almanac_data_collector, this);
-    galileo_utc_model_data_collector_thread_ = boost::thread(&ControlThread::galileo_utc_model_data_collector, this);
+    // the GNSS SV data is collected in the event loop, as it arrives
+    attach_data_collectors();
+
+    if (not state_file_.empty() and state_save_period_s_ > 0.0)
+        {
+            state_thread_ = boost::thread(&ControlThread::receiver_state_saver, this);
+        }
+
     // Main loop to read and process the control messages
     while (flowgraph_->running() && !stop_)
         {
@@ -172,40 +171,30 @@ void ControlThread::run()
         }
     std::cout << "Stopping GNSS-SDR, please wait!" << std::endl;
     flowgraph_->stop();
+    if (supl_assistance_)
+        {
+            supl_assistance_->stop();
+        }
 
-#ifdef OLD_BOOST
-    // Join GPS threads
-    gps_ephemeris_data_collector_thread_.timed_join(boost::posix_time::seconds(1));
-    gps_iono_data_collector_thread_.timed_join(boost::posix_time::seconds(1));
-    gps_utc_model_data_collector_thread_.timed_join(boost::posix_time::seconds(1));
-    gps_acq_assist_data_collector_thread_.timed_join(boost::posix_time::seconds(1));
-    gps_ref_location_data_collector_thread_.timed_join(boost::posix_time::seconds(1));
-    gps_ref_time_data_collector_thread_.timed_join(boost::posix_time::seconds(1));
-
-    //Join Galileo threads
-    galileo_ephemeris_data_collector_thread_.timed_join(boost::posix_time::seconds(1));
-    galileo_iono_data_collector_thread_.timed_join(boost::posix_time::seconds(1));
-    galileo_almanac_data_collector_thread_.timed_join(boost::posix_time::seconds(1));
-    galileo_utc_model_data_collector_thread_.timed_join(boost::posix_time::seconds(1));
+    // the data already pushed is collected before the event loop ends
+    detach_data_collectors();
+    gnss_event_loop().stop();
 
+    if (state_thread_.joinable())
+        {
+            state_thread_.interrupt();
+            state_thread_.join();
+        }
+    if (not state_file_.empty())
+        {
+            save_receiver_state();
+        }
+
+#ifdef OLD_BOOST
     //Join keyboard threads
     keyboard_thread_.timed_join(boost::posix_time::seconds(1));
 #endif
 #ifndef OLD_BOOST
-    // Join GPS threads
-    gps_ephemeris_data_collector_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(50));
-    gps_iono_data_collector_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(50));
-    gps_utc_model_data_collector_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(50));
-    gps_acq_assist_data_collector_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(50));
-    gps_ref_location_data_collector_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(50));
-    gps_ref_time_data_collector_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(50));
-
-    //Join Galileo threads
-    galileo_ephemeris_data_collector_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(50));
-    galileo_iono_data_collector_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(50));
-    galileo_almanac_data_collector_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(50));
-    galileo_utc_model_data_collector_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(50));
-
     //Join keyboard threads
     keyboard_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(50));
 #endif
@@ -225,6 +214,91 @@ void ControlThread::set_control_queue(boost::shared_ptr<gr::msg_queue> control_q
 }
 
 
+void ControlThread::load_receiver_state()
+{
+    Gnss_Receiver_State state;
+    if (state.load(state_file_) == false) return;
+    double ephemeris_max_age_s = configuration_->property("GNSS-SDR.state_ephemeris_max_age_s", 7200.0);
+    double almanac_max_age_s = configuration_->property("GNSS-SDR.state_almanac_max_age_s", 604800.0);
+    double fix_max_age_s = configuration_->property("GNSS-SDR.state_fix_max_age_s", 86400.0);
+    unsigned int discarded = state.discard_stale(static_cast<double>(std::time(nullptr)), ephemeris_max_age_s, almanac_max_age_s, fix_max_age_s);
+    if (discarded > 0)
+        {
+            LOG(INFO) << discarded << " records of the receiver state are too old, discarded";
+        }
+    if (state.empty())
+        {
+            std::cout << "The receiver state in " << state_file_ << " is too old, cold start" << std::endl;
+            return;
+        }
+    state.restore();
+    std::cout << "Hot start: restored " << state.gps_ephemeris.size() << " GPS and "
+              << state.galileo_ephemeris.size() << " Galileo ephemeris"
+              << (state.fix.valid ? " and the last position" : "") << " from " << state_file_ << std::endl;
+}
+
+
+void ControlThread::save_receiver_state()
+{
+    Gnss_Receiver_State state;
+    state.capture(static_cast<double>(std::time(nullptr)));
+    if (state.empty()) return;   // keep the previous file rather than an empty one
+    state.save(state_file_);
+}
+
+
+void ControlThread::receiver_state_saver()
+{
+    try
+    {
+            while (true)
+                {
+                    boost::this_thread::sleep(boost::posix_time::microseconds(static_cast<long>(state_save_period_s_ * 1e6)));
+                    save_receiver_state();
+                }
+    }
+    catch (boost::thread_interrupted&)
+    {
+            DLOG(INFO) << "Receiver state saver stopped";
+    }
+}
+
+
+void ControlThread::attach_data_collectors()
+{
+    Gnss_Event_Loop& loop = gnss_event_loop();
+    loop.start();
+    loop.attach<Gps_Ephemeris>(global_gps_ephemeris_queue, boost::bind(&ControlThread::gps_ephemeris_data_collector, this, _1));
+    loop.attach<Gps_Iono>(global_gps_iono_queue, boost::bind(&ControlThread::gps_iono_data_collector, this, _1));
+    loop.attach<Gps_Utc_Model>(global_gps_utc_model_queue, boost::bind(&ControlThread::gps_utc_model_data_collector, this, _1));
+    loop.attach<Gps_Acq_Assist>(global_gps_acq_assist_queue, boost::bind(&ControlThread::gps_acq_assist_data_collector, this, _1));
+    loop.attach<Gps_Ref_Location>(global_gps_ref_location_queue, boost::bind(&ControlThread::gps_ref_location_data_collector, this, _1));
+    loop.attach<Gps_Ref_Time>(global_gps_ref_time_queue, boost::bind(&ControlThread::gps_ref_time_data_collector, this, _1));
+
+    loop.attach<Galileo_Ephemeris>(global_galileo_ephemeris_queue, boost::bind(&ControlThread::galileo_ephemeris_data_collector, this, _1));
+    loop.attach<Galileo_Iono>(global_galileo_iono_queue, boost::bind(&ControlThread::galileo_iono_data_collector, this, _1));
+    loop.attach<Galileo_Almanac>(global_galileo_almanac_queue, boost::bind(&ControlThread::galileo_almanac_data_collector, this, _1));
+    loop.attach<Galileo_Utc_Model>(global_galileo_utc_model_queue, boost::bind(&ControlThread::galileo_utc_model_data_collector, this, _1));
+}
+
+
+void ControlThread::detach_data_collectors()
+{
+    Gnss_Event_Loop& loop = gnss_event_loop();
+    loop.detach(global_gps_ephemeris_queue);
+    loop.detach(global_gps_iono_queue);
+    loop.detach(global_gps_utc_model_queue);
+    loop.detach(global_gps_acq_assist_queue);
+    loop.detach(global_gps_ref_location_queue);
+    loop.detach(global_gps_ref_time_queue);
+
+    loop.detach(global_galileo_ephemeris_queue);
+    loop.detach(global_galileo_iono_queue);
+    loop.detach(global_galileo_almanac_queue);
+    loop.detach(global_galileo_utc_model_queue);
+}
+
+
 /*
  * Returns true if reading was successful
  */
@@ -393,6 +467,14 @@ bool ControlThread::save_assistance_to_XML()
 
 void ControlThread::init()
 {
+    // The saved navigation data and fix are restored before the flowgraph sorts the satellites to search
+    state_file_ = configuration_->property("GNSS-SDR.state_file", std::string(""));
+    state_save_period_s_ = configuration_->property("GNSS-SDR.state_save_period_s", 60.0);
+    if (not state_file_.empty())
+        {
+            load_receiver_state();
+        }
+
     // Instantiates a control queue, a GNSS flowgraph, and a control message factory
     control_queue_ = gr::msg_queue::make(0);
     flowgraph_ = std::make_shared<GNSSFlowgraph>(configuration_, control_queue_);
@@ -408,35 +490,6 @@ void ControlThread::init()
         //SUPL SERVER TEST. Not operational yet!
         {
             std::cout << "SUPL RRLP GPS assistance enabled!" << std::endl;
-            std::string default_acq_server = "supl.nokia.com";
-            std::string default_eph_server = "supl.google.com";
-            supl_client_ephemeris_.server_name = configuration_->property("GNSS-SDR.SUPL_gps_ephemeris_server", default_acq_server);
-            supl_client_acquisition_.server_name = configuration_->property("GNSS-SDR.SUPL_gps_acquisition_server", default_eph_server);
-            supl_client_ephemeris_.server_port = configuration_->property("GNSS-SDR.SUPL_gps_ephemeris_port", 7275);
-            supl_client_acquisition_.server_port = configuration_->property("GNSS-SDR.SUPL_gps_acquisition_port", 7275);
-            supl_mcc = configuration_->property("GNSS-SDR.SUPL_MCC", 244);
-            supl_mns = configuration_->property("GNSS-SDR.SUPL_MNS", 5);
-
-            std::string default_lac = "0x59e2";
-            std::string default_ci = "0x31b0";
-            try
-            {
-                    supl_lac = boost::lexical_cast<int>(configuration_->property("GNSS-SDR.SUPL_LAC", default_lac));
-            }
-            catch(boost::bad_lexical_cast &)
-            {
-                    supl_lac = 0x59e2;
-            }
-
-            try
-            {
-                    supl_ci = boost::lexical_cast<int>(configuration_->property("GNSS-SDR.SUPL_CI", default_ci));
-            }
-            catch(boost::bad_lexical_cast &)
-            {
-                    supl_ci = 0x31b0;
-            }
-
             bool SUPL_read_gps_assistance_xml = configuration_->property("GNSS-SDR.SUPL_read_gps_assistance_xml", false);
             if (SUPL_read_gps_assistance_xml == true)
                 {
@@ -445,106 +498,9 @@ void ControlThread::init()
                 }
             else
                 {
-                    // Request ephemeris from SUPL server
-                    int error;
-                    supl_client_ephemeris_.request = 1;
-                    std::cout << "SUPL: Try to read GPS ephemeris from SUPL server.." << std::endl;
-                    error = supl_client_ephemeris_.get_assistance(supl_mcc, supl_mns, supl_lac, supl_ci);
-                    if (error == 0)
-                        {
-                            std::map<int,Gps_Ephemeris>::iterator gps_eph_iter;
-                            for(gps_eph_iter = supl_client_ephemeris_.gps_ephemeris_map.begin();
-                                    gps_eph_iter != supl_client_ephemeris_.gps_ephemeris_map.end();
-                                    gps_eph_iter++)
-                                {
-                                    std::cout << "SUPL: Received Ephemeris for GPS SV " << gps_eph_iter->first << std::endl;
-                                    global_gps_ephemeris_map.write(gps_eph_iter->second.i_satellite_PRN, gps_eph_iter->second);
-                                }
-                            //Save ephemeris to XML file
-                            std::string eph_xml_filename = configuration_->property("GNSS-SDR.SUPL_gps_ephemeris_xml", eph_default_xml_filename);
-                            if (supl_client_ephemeris_.save_ephemeris_map_xml(eph_xml_filename, supl_client_ephemeris_.gps_ephemeris_map) == true)
-                                {
-                                    std::cout << "SUPL: XML Ephemeris file created" << std::endl;
-                                }
-                            else
-                                {
-                                    std::cout << "SUPL: Failed to create XML Ephemeris file" << std::endl;
-                                }
-                        }
-                    else
-                        {
-                            std::cout << "ERROR: SUPL client for Ephemeris returned " << error << std::endl;
-                            std::cout << "Please check internet connection and SUPL server configuration" << error << std::endl;
-                            std::cout << "Trying to read ephemeris from XML file" << std::endl;
-                            if (read_assistance_from_XML() == false)
-                                {
-                                    std::cout << "ERROR: Could not read Ephemeris file: Disabling SUPL assistance.." << std::endl;
-                                }
-                        }
-
-                    // Request almanac , IONO and UTC Model
-                    supl_client_ephemeris_.request = 0;
-                    std::cout << "SUPL: Try read Almanac, Iono, Utc Model, Ref Time and Ref Location from SUPL server..." << std::endl;
-                    error = supl_client_ephemeris_.get_assistance(supl_mcc, supl_mns, supl_lac, supl_ci);
-                    if (error == 0)
-                        {
-                            std::map<int,Gps_Almanac>::iterator gps_alm_iter;
-                            for(gps_alm_iter = supl_client_ephemeris_.gps_almanac_map.begin();
-                                    gps_alm_iter != supl_client_ephemeris_.gps_almanac_map.end();
-                                    gps_alm_iter++)
-                                {
-                                    std::cout << "SUPL: Received Almanac for GPS SV " << gps_alm_iter->first << std::endl;
-                                    global_gps_almanac_queue.push(gps_alm_iter->second);
-                                }
-                            if (supl_client_ephemeris_.gps_iono.valid == true)
-                                {
-                                    std::cout << "SUPL: Received GPS Iono" << std::endl;
-                                    global_gps_iono_map.write(0, supl_client_ephemeris_.gps_iono);
-                                }
-                            if (supl_client_ephemeris_.gps_utc.valid == true)
-			        {
-                                    std::cout << "SUPL: Received GPS UTC Model" << std::endl;
-                                    global_gps_utc_model_map.write(0, supl_client_ephemeris_.gps_utc);
-                                }
-                        }
-                    else
-                        {
-                            std::cout << "ERROR: SUPL client for Almanac returned " << error << std::endl;
-                            std::cout << "Please check internet connection and SUPL server configuration" << error << std::endl;
-                            std::cout << "Disabling SUPL assistance.." << std::endl;
-                        }
-
-                    // Request acquisition assistance
-                    supl_client_acquisition_.request = 2;
-                    std::cout << "SUPL: Try read Acquisition assistance from SUPL server.." << std::endl;
-                    error = supl_client_acquisition_.get_assistance(supl_mcc, supl_mns, supl_lac, supl_ci);
-                    if (error == 0)
-                        {
-                            std::map<int, Gps_Acq_Assist>::iterator gps_acq_iter;
-                            for(gps_acq_iter = supl_client_acquisition_.gps_acq_map.begin();
-                                    gps_acq_iter != supl_client_acquisition_.gps_acq_map.end();
-                                    gps_acq_iter++)
-                                {
-                                    std::cout << "SUPL: Received Acquisition assistance for GPS SV " << gps_acq_iter->first << std::endl;
-                                    global_gps_acq_assist_map.write(gps_acq_iter->second.i_satellite_PRN, gps_acq_iter->second);
-                                }
-                            if (supl_client_acquisition_.gps_ref_loc.valid == true)
-                                {
-                                    std::cout << "SUPL: Received Ref Location (Acquisition Assistance)" << std::endl;
-                                    global_gps_ref_location_map.write(0, supl_client_acquisition_.gps_ref_loc);
-                                }
-                            if (supl_client_acquisition_.gps_time.valid == true)
-                                {
-                                    std::cout << "SUPL: Received Ref Time (Acquisition Assistance)" << std::endl;
-                                    global_gps_ref_time_map.write(0, supl_client_acquisition_.gps_time);
-                                }
-                        }
-                    else
-                        {
-                            std::cout << "ERROR: SUPL client for Acquisition assistance returned " << error << std::endl;
-                            std::cout << "Please check internet connection and SUPL server configuration" << error << std::endl;
-                            std::cout << "Disabling SUPL assistance.." << std::endl;
-                        }
+                    // The servers are asked in the background: the receiver starts searching meanwhile
+                    supl_assistance_ = std::make_shared<Gnss_Supl_Assistance>(configuration_, control_queue_);
+                    supl_assistance_->start();
                 }
         }
 }
@@ -576,6 +532,15 @@ void ControlThread::process_control_messages()
                 {
                     apply_action(control_messages_->at(i)->what);
                 }
+            else if (control_messages_->at(i)->who == GNSS_SUPL_ASSISTANCE_ID and control_messages_->at(i)->what == GNSS_SUPL_EPHEMERIS_FAILED)
+                {
+                    // the ephemeris saved at the last stop, until a server answers
+                    std::cout << "Trying to read ephemeris from XML file" << std::endl;
+                    if (read_assistance_from_XML() == false)
+                        {
+                            std::cout << "ERROR: Could not read Ephemeris file" << std::endl;
+                        }
+                }
             else
                 {
                     flowgraph_->apply_action(control_messages_->at(i)->who, control_messages_->at(i)->what);
@@ -603,330 +568,279 @@ void ControlThread::apply_action(unsigned int what)
 }
 
 
-void ControlThread::gps_acq_assist_data_collector()
+void ControlThread::gps_acq_assist_data_collector(const Gps_Acq_Assist& gps_acq)
 {
     // ############ 1.bis READ EPHEMERIS/UTC_MODE/IONO QUEUE ####################
-    Gps_Acq_Assist gps_acq;
     Gps_Acq_Assist gps_acq_old;
-    while(stop_ == false)
-        {
-            global_gps_acq_assist_queue.wait_and_pop(gps_acq);
 
-            // DEBUG MESSAGE
-            std::cout << "Acquisition assistance record has arrived from SAT ID "
-                      << gps_acq.i_satellite_PRN
-                      << " with Doppler "
-                      << gps_acq.d_Doppler0
-                      << " [Hz] "<< std::endl;
-            // insert new acq record to the global ephemeris map
-            if (global_gps_acq_assist_map.read(gps_acq.i_satellite_PRN,gps_acq_old))
-                {
-                    std::cout << "Acquisition assistance record updated" << std::endl;
-                    global_gps_acq_assist_map.write(gps_acq.i_satellite_PRN, gps_acq);
+    // DEBUG MESSAGE
+    std::cout << "Acquisition assistance record has arrived from SAT ID "
+              << gps_acq.i_satellite_PRN
+              << " with Doppler "
+              << gps_acq.d_Doppler0
+              << " [Hz] "<< std::endl;
+    // insert new acq record to the global ephemeris map
+    if (global_gps_acq_assist_map.read(gps_acq.i_satellite_PRN,gps_acq_old))
+        {
+            std::cout << "Acquisition assistance record updated" << std::endl;
+            global_gps_acq_assist_map.write(gps_acq.i_satellite_PRN, gps_acq);
 
-                }
-            else
-                {
-                    // insert new acq record
-                    LOG(INFO) << "New acq assist record inserted";
-                    global_gps_acq_assist_map.write(gps_acq.i_satellite_PRN, gps_acq);
-                }
+        }
+    else
+        {
+            // insert new acq record
+            LOG(INFO) << "New acq assist record inserted";
+            global_gps_acq_assist_map.write(gps_acq.i_satellite_PRN, gps_acq);
         }
 }
 
 
-void ControlThread::gps_ephemeris_data_collector()
+void ControlThread::gps_ephemeris_data_collector(const Gps_Ephemeris& gps_eph)
 {
     // ############ 1.bis READ EPHEMERIS/UTC_MODE/IONO QUEUE ####################
-    Gps_Ephemeris gps_eph;
     Gps_Ephemeris gps_eph_old;
-    while(stop_ == false)
+    std::map<int, std::string>::const_iterator block = gps_eph.satelliteBlock.find(gps_eph.i_satellite_PRN);
+
+    // DEBUG MESSAGE
+    std::cout << "Ephemeris record has arrived from SAT ID "
+              << gps_eph.i_satellite_PRN << " (Block "
+              <<  (block != gps_eph.satelliteBlock.end() ? block->second : std::string(""))
+              << ")" << std::endl;
+    // insert new ephemeris record to the global ephemeris map
+    if (global_gps_ephemeris_map.read(gps_eph.i_satellite_PRN, gps_eph_old))
         {
-            global_gps_ephemeris_queue.wait_and_pop(gps_eph);
-
-            // DEBUG MESSAGE
-            std::cout << "Ephemeris record has arrived from SAT ID "
-                      << gps_eph.i_satellite_PRN << " (Block "
-                      <<  gps_eph.satelliteBlock[gps_eph.i_satellite_PRN]
-                      << ")" << std::endl;
-            // insert new ephemeris record to the global ephemeris map
-            if (global_gps_ephemeris_map.read(gps_eph.i_satellite_PRN, gps_eph_old))
+            // Check the EPHEMERIS timestamp. If it is newer, then update the ephemeris
+            if (gps_eph.i_GPS_week > gps_eph_old.i_GPS_week)
                 {
-                    // Check the EPHEMERIS timestamp. If it is newer, then update the ephemeris
-                    if (gps_eph.i_GPS_week > gps_eph_old.i_GPS_week)
+                    std::cout << "Ephemeris record updated (GPS week=" << gps_eph.i_GPS_week << std::endl;
+                    global_gps_ephemeris_map.write(gps_eph.i_satellite_PRN, gps_eph);
+                }
+            else
+                {
+                    if (gps_eph.d_Toe > gps_eph_old.d_Toe)
                         {
-                            std::cout << "Ephemeris record updated (GPS week=" << gps_eph.i_GPS_week << std::endl;
+                            LOG(INFO) << "Ephemeris record updated (Toe=" << gps_eph.d_Toe;
                             global_gps_ephemeris_map.write(gps_eph.i_satellite_PRN, gps_eph);
                         }
                     else
                         {
-                            if (gps_eph.d_Toe > gps_eph_old.d_Toe)
-                                {
-                                    LOG(INFO) << "Ephemeris record updated (Toe=" << gps_eph.d_Toe;
-                                    global_gps_ephemeris_map.write(gps_eph.i_satellite_PRN, gps_eph);
-                                }
-                            else
-                                {
-                                    LOG(INFO) << "Not updating the existing ephemeris";
-                                }
+                            LOG(INFO) << "Not updating the existing ephemeris";
                         }
                 }
-            else
-                {
-                    // insert new ephemeris record
-                    LOG(INFO) << "New Ephemeris record inserted with Toe="
-                              << gps_eph.d_Toe<<" and GPS Week="
-                              << gps_eph.i_GPS_week;
-                    global_gps_ephemeris_map.write(gps_eph.i_satellite_PRN, gps_eph);
-                }
+        }
+    else
+        {
+            // insert new ephemeris record
+            LOG(INFO) << "New Ephemeris record inserted with Toe="
+                      << gps_eph.d_Toe<<" and GPS Week="
+                      << gps_eph.i_GPS_week;
+            global_gps_ephemeris_map.write(gps_eph.i_satellite_PRN, gps_eph);
         }
 }
 
 
-void ControlThread::galileo_ephemeris_data_collector()
+void ControlThread::galileo_ephemeris_data_collector(const Galileo_Ephemeris& galileo_eph)
 {
     // ############ 1.bis READ EPHEMERIS/UTC_MODE/IONO QUEUE ####################
-    Galileo_Ephemeris galileo_eph;
     Galileo_Ephemeris galileo_eph_old;
-    while(stop_ == false)
-        {
-            global_galileo_ephemeris_queue.wait_and_pop(galileo_eph);
 
-            // DEBUG MESSAGE
-            std::cout << "Galileo Ephemeris record has arrived from SAT ID "
-                      << galileo_eph.SV_ID_PRN_4 << std::endl;
+    // DEBUG MESSAGE
+    std::cout << "Galileo Ephemeris record has arrived from SAT ID "
+              << galileo_eph.SV_ID_PRN_4 << std::endl;
 
-            // insert new ephemeris record to the global ephemeris map
-            if (global_galileo_ephemeris_map.read(galileo_eph.SV_ID_PRN_4, galileo_eph_old))
+    // insert new ephemeris record to the global ephemeris map
+    if (global_galileo_ephemeris_map.read(galileo_eph.SV_ID_PRN_4, galileo_eph_old))
+        {
+            // Check the EPHEMERIS timestamp. If it is newer, then update the ephemeris
+            if (galileo_eph.WN_5 > galileo_eph_old.WN_5) //further check because it is not clear when IOD is reset
                 {
-                    // Check the EPHEMERIS timestamp. If it is newer, then update the ephemeris
-                    if (galileo_eph.WN_5 > galileo_eph_old.WN_5) //further check because it is not clear when IOD is reset
+                    LOG(INFO) << "Galileo Ephemeris record in global map updated -- GALILEO Week Number ="
+                              << galileo_eph.WN_5;
+                    global_galileo_ephemeris_map.write(galileo_eph.SV_ID_PRN_4,galileo_eph);
+                }
+            else
+                {
+                    if (galileo_eph.IOD_ephemeris > galileo_eph_old.IOD_ephemeris)
                         {
-                            LOG(INFO) << "Galileo Ephemeris record in global map updated -- GALILEO Week Number ="
-                                      << galileo_eph.WN_5;
-                            global_galileo_ephemeris_map.write(galileo_eph.SV_ID_PRN_4,galileo_eph);
+                            LOG(INFO) << "Galileo Ephemeris record updated in global map-- IOD_ephemeris ="
+                                      << galileo_eph.IOD_ephemeris;
+                            global_galileo_ephemeris_map.write(galileo_eph.SV_ID_PRN_4, galileo_eph);
+                            LOG(INFO) << "IOD_ephemeris OLD: " << galileo_eph_old.IOD_ephemeris;
+                            LOG(INFO) << "satellite: " << galileo_eph.SV_ID_PRN_4;
                         }
                     else
                         {
-                            if (galileo_eph.IOD_ephemeris > galileo_eph_old.IOD_ephemeris)
-                                {
-                                    LOG(INFO) << "Galileo Ephemeris record updated in global map-- IOD_ephemeris ="
-                                              << galileo_eph.IOD_ephemeris;
-                                    global_galileo_ephemeris_map.write(galileo_eph.SV_ID_PRN_4, galileo_eph);
-                                    LOG(INFO) << "IOD_ephemeris OLD: " << galileo_eph_old.IOD_ephemeris;
-                                    LOG(INFO) << "satellite: " << galileo_eph.SV_ID_PRN_4;
-                                }
-                            else
-                                {
-                                    LOG(INFO) << "Not updating the existing Galileo ephemeris, IOD is not changing";
-                                }
+                            LOG(INFO) << "Not updating the existing Galileo ephemeris, IOD is not changing";
                         }
                 }
-            else
-                {
-                    // insert new ephemeris record
-                    LOG(INFO) << "Galileo New Ephemeris record inserted in global map with TOW =" << galileo_eph.TOW_5
-                              << ", GALILEO Week Number =" << galileo_eph.WN_5
-                              << " and Ephemeris IOD = " << galileo_eph.IOD_ephemeris;
-                    global_galileo_ephemeris_map.write(galileo_eph.SV_ID_PRN_4, galileo_eph);
-                }
+        }
+    else
+        {
+            // insert new ephemeris record
+            LOG(INFO) << "Galileo New Ephemeris record inserted in global map with TOW =" << galileo_eph.TOW_5
+                      << ", GALILEO Week Number =" << galileo_eph.WN_5
+                      << " and Ephemeris IOD = " << galileo_eph.IOD_ephemeris;
+            global_galileo_ephemeris_map.write(galileo_eph.SV_ID_PRN_4, galileo_eph);
         }
 
 }
 
-void ControlThread::gps_iono_data_collector()
+void ControlThread::gps_iono_data_collector(const Gps_Iono& gps_iono)
 {
     // ############ 1.bis READ EPHEMERIS/UTC_MODE/IONO QUEUE ####################
-    Gps_Iono gps_iono;
-    while(stop_ == false)
-        {
-            global_gps_iono_queue.wait_and_pop(gps_iono);
-
-            LOG(INFO) << "New IONO record has arrived ";
-            // there is no timestamp for the iono data, new entries must always be added
-            global_gps_iono_map.write(0, gps_iono);
-        }
+    LOG(INFO) << "New IONO record has arrived ";
+    // there is no timestamp for the iono data, new entries must always be added
+    global_gps_iono_map.write(0, gps_iono);
 }
 
-void ControlThread::galileo_almanac_data_collector()
+void ControlThread::galileo_almanac_data_collector(const Galileo_Almanac& galileo_almanac)
 {
     // ############ 1.bis READ ALMANAC QUEUE ####################
-    Galileo_Almanac galileo_almanac;
-    while(stop_ == false)
-        {
-            global_galileo_almanac_queue.wait_and_pop(galileo_almanac);
-
-            LOG(INFO) << "New galileo_almanac record has arrived ";
-            // there is no timestamp for the galileo_almanac data, new entries must always be added
-            global_galileo_almanac_map.write(0, galileo_almanac);
-        }
+    LOG(INFO) << "New galileo_almanac record has arrived ";
+    // there is no timestamp for the galileo_almanac data, new entries must always be added
+    global_galileo_almanac_map.write(0, galileo_almanac);
 }
 
-void ControlThread::galileo_iono_data_collector()
+void ControlThread::galileo_iono_data_collector(const Galileo_Iono& galileo_iono)
 {
-    Galileo_Iono galileo_iono;
     Galileo_Iono galileo_iono_old;
-    while(stop_ == false)
-        {
-            global_galileo_iono_queue.wait_and_pop(galileo_iono);
 
-            // DEBUG MESSAGE
-            LOG(INFO) << "Iono record has arrived";
+    // DEBUG MESSAGE
+    LOG(INFO) << "Iono record has arrived";
 
-            // insert new Iono record to the global Iono map
-            if (global_galileo_iono_map.read(0, galileo_iono_old))
+    // insert new Iono record to the global Iono map
+    if (global_galileo_iono_map.read(0, galileo_iono_old))
+        {
+            // Check the Iono timestamp from UTC page (page 6). If it is newer, then update the Iono parameters
+            if (galileo_iono.WN_5 > galileo_iono_old.WN_5)
                 {
-                    // Check the Iono timestamp from UTC page (page 6). If it is newer, then update the Iono parameters
-                    if (galileo_iono.WN_5 > galileo_iono_old.WN_5)
+                    LOG(INFO) << "IONO record updated in global map--new GALILEO UTC-IONO Week Number";
+                    global_galileo_iono_map.write(0, galileo_iono);
+                }
+            else
+                {
+                    if (galileo_iono.TOW_5 > galileo_iono_old.TOW_5)
                         {
-                            LOG(INFO) << "IONO record updated in global map--new GALILEO UTC-IONO Week Number";
+                            LOG(INFO) << "IONO record updated in global map--new GALILEO UTC-IONO time of Week";
                             global_galileo_iono_map.write(0, galileo_iono);
+                            //std::cout << "GALILEO IONO time of Week old: " << galileo_iono_old.t0t_6<<std::endl;
                         }
                     else
                         {
-                            if (galileo_iono.TOW_5 > galileo_iono_old.TOW_5)
-                                {
-                                    LOG(INFO) << "IONO record updated in global map--new GALILEO UTC-IONO time of Week";
-                                    global_galileo_iono_map.write(0, galileo_iono);
-                                    //std::cout << "GALILEO IONO time of Week old: " << galileo_iono_old.t0t_6<<std::endl;
-                                }
-                            else
-                                {
-                                    LOG(INFO) << "Not updating the existing Iono parameters in global map, Iono timestamp is not changing";
-                                }
+                            LOG(INFO) << "Not updating the existing Iono parameters in global map, Iono timestamp is not changing";
                         }
                 }
-            else
-                {
-                    // insert new ephemeris record
-                    LOG(INFO) << "New IONO record inserted in global map";
-                    global_galileo_iono_map.write(0, galileo_iono);
-                }
+        }
+    else
+        {
+            // insert new ephemeris record
+            LOG(INFO) << "New IONO record inserted in global map";
+            global_galileo_iono_map.write(0, galileo_iono);
         }
 }
 
 
-void ControlThread::gps_utc_model_data_collector()
+void ControlThread::gps_utc_model_data_collector(const Gps_Utc_Model& gps_utc)
 {
     // ############ 1.bis READ EPHEMERIS/UTC_MODE/IONO QUEUE ####################
-    Gps_Utc_Model gps_utc;
     Gps_Utc_Model gps_utc_old;
-    while(stop_ == false)
+    LOG(INFO) << "New UTC MODEL record has arrived with A0=" << gps_utc.d_A0;
+    // insert new utc record to the global utc model map
+    if (global_gps_utc_model_map.read(0, gps_utc_old))
         {
-            global_gps_utc_model_queue.wait_and_pop(gps_utc);
-            LOG(INFO) << "New UTC MODEL record has arrived with A0=" << gps_utc.d_A0;
-            // insert new utc record to the global utc model map
-            if (global_gps_utc_model_map.read(0, gps_utc_old))
+            if (gps_utc.i_WN_T > gps_utc_old.i_WN_T)
                 {
-                    if (gps_utc.i_WN_T > gps_utc_old.i_WN_T)
-                        {
-                            global_gps_utc_model_map.write(0, gps_utc);
-                        }
-                    else if ((gps_utc.i_WN_T == gps_utc_old.i_WN_T) and (gps_utc.d_t_OT > gps_utc_old.d_t_OT))
-                        {
-                            global_gps_utc_model_map.write(0, gps_utc);
-                        }
-                    else
-                        {
-                            LOG(INFO) << "Not updating the existing utc model";
-                        }
+                    global_gps_utc_model_map.write(0, gps_utc);
                 }
-            else
+            else if ((gps_utc.i_WN_T == gps_utc_old.i_WN_T) and (gps_utc.d_t_OT > gps_utc_old.d_t_OT))
                 {
-                    // insert new utc model record
                     global_gps_utc_model_map.write(0, gps_utc);
                 }
+            else
+                {
+                    LOG(INFO) << "Not updating the existing utc model";
+                }
+        }
+    else
+        {
+            // insert new utc model record
+            global_gps_utc_model_map.write(0, gps_utc);
         }
 }
 
 
-void ControlThread::gps_ref_location_data_collector()
+void ControlThread::gps_ref_location_data_collector(const Gps_Ref_Location& gps_ref_location)
 {
     // ############ READ REF LOCATION ####################
-    Gps_Ref_Location gps_ref_location;
-    while(stop_ == false)
-        {
-            global_gps_ref_location_queue.wait_and_pop(gps_ref_location);
-            LOG(INFO) << "New ref location record has arrived with lat=" << gps_ref_location.lat << " lon=" << gps_ref_location.lon;
-            // insert new ref location record to the global ref location map
-            global_gps_ref_location_map.write(0, gps_ref_location);
-        }
+    LOG(INFO) << "New ref location record has arrived with lat=" << gps_ref_location.lat << " lon=" << gps_ref_location.lon;
+    // insert new ref location record to the global ref location map
+    global_gps_ref_location_map.write(0, gps_ref_location);
 }
 
 
-void ControlThread::gps_ref_time_data_collector()
+void ControlThread::gps_ref_time_data_collector(const Gps_Ref_Time& gps_ref_time)
 {
     // ############ READ REF TIME ####################
-    Gps_Ref_Time gps_ref_time;
     Gps_Ref_Time gps_ref_time_old;
-    while(stop_ == false)
+    LOG(INFO) << "New ref time record has arrived with TOW=" << gps_ref_time.d_TOW << " Week=" << gps_ref_time.d_Week;
+    // insert new ref time record to the global ref time map
+    if (global_gps_ref_time_map.read(0, gps_ref_time_old))
         {
-            global_gps_ref_time_queue.wait_and_pop(gps_ref_time);
-            LOG(INFO) << "New ref time record has arrived with TOW=" << gps_ref_time.d_TOW << " Week=" << gps_ref_time.d_Week;
-            // insert new ref time record to the global ref time map
-            if (global_gps_ref_time_map.read(0, gps_ref_time_old))
+            if (gps_ref_time.d_Week > gps_ref_time_old.d_Week)
                 {
-                    if (gps_ref_time.d_Week > gps_ref_time_old.d_Week)
-                        {
-                            global_gps_ref_time_map.write(0, gps_ref_time);
-                        }
-                    else if ((gps_ref_time.d_Week == gps_ref_time_old.d_Week) and (gps_ref_time.d_TOW > gps_ref_time_old.d_TOW))
-                        {
-                            global_gps_ref_time_map.write(0, gps_ref_time);
-                        }
-                    else
-                        {
-                            LOG(INFO) << "Not updating the existing ref time";
-                        }
+                    global_gps_ref_time_map.write(0, gps_ref_time);
                 }
-            else
+            else if ((gps_ref_time.d_Week == gps_ref_time_old.d_Week) and (gps_ref_time.d_TOW > gps_ref_time_old.d_TOW))
                 {
-                    // insert new ref time record
                     global_gps_ref_time_map.write(0, gps_ref_time);
                 }
+            else
+                {
+                    LOG(INFO) << "Not updating the existing ref time";
+                }
+        }
+    else
+        {
+            // insert new ref time record
+            global_gps_ref_time_map.write(0, gps_ref_time);
         }
 }
 
 
-void ControlThread::galileo_utc_model_data_collector()
+void ControlThread::galileo_utc_model_data_collector(const Galileo_Utc_Model& galileo_utc)
 {
-    Galileo_Utc_Model galileo_utc;
     Galileo_Utc_Model galileo_utc_old;
-    while(stop_ == false)
-        {
-            global_galileo_utc_model_queue.wait_and_pop(galileo_utc);
 
-            // DEBUG MESSAGE
-            LOG(INFO) << "UTC record has arrived" << std::endl;
+    // DEBUG MESSAGE
+    LOG(INFO) << "UTC record has arrived" << std::endl;
 
-            // insert new UTC record to the global UTC map
-            if (global_galileo_utc_model_map.read(0, galileo_utc_old))
+    // insert new UTC record to the global UTC map
+    if (global_galileo_utc_model_map.read(0, galileo_utc_old))
+        {
+            // Check the UTC timestamp. If it is newer, then update the ephemeris
+            if (galileo_utc.WNot_6 > galileo_utc_old.WNot_6) //further check because it is not clear when IOD is reset
+                {
+                    DLOG(INFO) << "UTC record updated --new GALILEO UTC Week Number =" << galileo_utc.WNot_6;
+                    global_galileo_utc_model_map.write(0, galileo_utc);
+                }
+            else
                 {
-                    // Check the UTC timestamp. If it is newer, then update the ephemeris
-                    if (galileo_utc.WNot_6 > galileo_utc_old.WNot_6) //further check because it is not clear when IOD is reset
+                    if (galileo_utc.t0t_6 > galileo_utc_old.t0t_6)
                         {
-                            DLOG(INFO) << "UTC record updated --new GALILEO UTC Week Number =" << galileo_utc.WNot_6;
+                            DLOG(INFO) << "UTC record updated --new GALILEO UTC time of Week =" << galileo_utc.t0t_6;
                             global_galileo_utc_model_map.write(0, galileo_utc);
                         }
                     else
                         {
-                            if (galileo_utc.t0t_6 > galileo_utc_old.t0t_6)
-                                {
-                                    DLOG(INFO) << "UTC record updated --new GALILEO UTC time of Week =" << galileo_utc.t0t_6;
-                                    global_galileo_utc_model_map.write(0, galileo_utc);
-                                }
-                            else
-                                {
-                                    LOG(INFO) << "Not updating the existing UTC in global map, timestamp is not changing";
-                                }
+                            LOG(INFO) << "Not updating the existing UTC in global map, timestamp is not changing";
                         }
                 }
-            else
-                {
-                    // insert new ephemeris record
-                    LOG(INFO) << "New UTC record inserted in global map";
-                    global_galileo_utc_model_map.write(0, galileo_utc);
-                }
+        }
+    else
+        {
+            // insert new ephemeris record
+            LOG(INFO) << "New UTC record inserted in global map";
+            global_galileo_utc_model_map.write(0, galileo_utc);
         }
 }
 
@@ -41,9 +41,14 @@
 #include <gnuradio/msg_queue.h>
 #include "control_message_factory.h"
 #include "gnss_sdr_supl_client.h"
+#include "gnss_supl_assistance.h"
 
 class GNSSFlowgraph;
 class ConfigurationInterface;
+class Galileo_Ephemeris;
+class Galileo_Iono;
+class Galileo_Utc_Model;
+class Galileo_Almanac;
 
 
 /*!
@@ -116,10 +121,7 @@ private:
     //SUPL assistance classes
     gnss_sdr_supl_client supl_client_acquisition_;
     gnss_sdr_supl_client supl_client_ephemeris_;
-    int supl_mcc; // Current network MCC (Mobile country code), 3 digits.
-    int supl_mns; // Current network MNC (Mobile Network code), 2 or 3 digits.
-    int supl_lac; // Current network LAC (Location area code),16 bits, 1-65520 are valid values.
-    int supl_ci;  // Cell Identity (16 bits, 0-65535 are valid values).
+    std::shared_ptr<Gnss_Supl_Assistance> supl_assistance_;
 
     void init();
 
@@ -134,54 +136,75 @@ private:
     void process_control_messages();
 
     /*
-     * Blocking function that reads the GPS ephemeris queue and updates the shared ephemeris map, accessible from the PVT block
+     * Attaches the navigation data queues to the event loop of the receiver,
+     * so that each record is collected in that thread as soon as it is pushed
      */
-    void gps_ephemeris_data_collector();
+    void attach_data_collectors();
+
+    // Queues the records again; those already posted are still collected
+    void detach_data_collectors();
+
+    /*
+     * Updates the shared GPS ephemeris map, accessible from the PVT block, with a new record
+     */
+    void gps_ephemeris_data_collector(const Gps_Ephemeris& gps_eph);
 
     /*
-     * Blocking function that reads the UTC model queue and updates the shared map, accessible from the PVT block
+     * Updates the shared UTC model map, accessible from the PVT block
      */
-    void gps_utc_model_data_collector();
+    void gps_utc_model_data_collector(const Gps_Utc_Model& gps_utc);
 
     /*
-     * \brief Blocking function that reads the ref location queue and updates the shared map
+     * \brief Updates the shared ref location map
      */
-    void gps_ref_location_data_collector();
+    void gps_ref_location_data_collector(const Gps_Ref_Location& gps_ref_location);
 
     /*
-     * \brief Blocking function that reads the ref time queue and updates the shared map
+     * \brief Updates the shared ref time map
      */
-    void gps_ref_time_data_collector();
+    void gps_ref_time_data_collector(const Gps_Ref_Time& gps_ref_time);
 
     /*
-     * Blocking function that reads the iono model queue and updates the shared map, accessible from the PVT block
+     * Updates the shared iono model map, accessible from the PVT block
      */
-    void gps_iono_data_collector();
+    void gps_iono_data_collector(const Gps_Iono& gps_iono);
 
     /*
-     * Blocking function that reads the GPS assistance queue
+     * Updates the shared GPS acquisition assistance map
      */
-    void gps_acq_assist_data_collector();
+    void gps_acq_assist_data_collector(const Gps_Acq_Assist& gps_acq);
 
     /*
-     * Blocking function that reads the Galileo ephemeris queue and updates the shared ephemeris map, accessible from the PVT block
+     * Updates the shared Galileo ephemeris map, accessible from the PVT block
      */
-    void galileo_ephemeris_data_collector();
+    void galileo_ephemeris_data_collector(const Galileo_Ephemeris& galileo_eph);
 
     /*
-     * Blocking function that reads the UTC model queue and updates the shared map, accessible from the PVT block
+     * Updates the shared Galileo UTC model map, accessible from the PVT block
      */
-    void galileo_utc_model_data_collector();
+    void galileo_utc_model_data_collector(const Galileo_Utc_Model& galileo_utc);
 
     /*
-     * Blocking function that reads the iono data queue and updates the shared map, accessible from the PVT block
+     * Updates the shared Galileo iono data map, accessible from the PVT block
      */
-    void galileo_iono_data_collector();
+    void galileo_iono_data_collector(const Galileo_Iono& galileo_iono);
 
     /*
-     * Blocking function that reads the galileo_almanac queue and updates the shared map, accessible from the PVT block
+     * Updates the shared Galileo almanac map, accessible from the PVT block
      */
-    void galileo_almanac_data_collector();
+    void galileo_almanac_data_collector(const Galileo_Almanac& galileo_almanac);
+
+    /*
+     * Loads the receiver state file, discards what is too old and writes the
+     * rest to the global maps, so that the receiver starts hot
+     */
+    void load_receiver_state();
+
+    // Writes the navigation data and the last fix to the receiver state file
+    void save_receiver_state();
+
+    // Saves the receiver state every state_save_period_s_ until interrupted
+    void receiver_state_saver();
 
     void apply_action(unsigned int what);
     std::shared_ptr<GNSSFlowgraph> flowgraph_;
@@ -194,20 +217,12 @@ private:
     unsigned int processed_control_messages_;
     unsigned int applied_actions_;
     boost::thread keyboard_thread_;
-
-    boost::thread gps_ephemeris_data_collector_thread_;
-    boost::thread gps_iono_data_collector_thread_;
-    boost::thread gps_utc_model_data_collector_thread_;
-    boost::thread gps_acq_assist_data_collector_thread_;
-    boost::thread gps_ref_location_data_collector_thread_;
-    boost::thread gps_ref_time_data_collector_thread_;
-
-    boost::thread galileo_ephemeris_data_collector_thread_;
-    boost::thread galileo_utc_model_data_collector_thread_;
-    boost::thread galileo_iono_data_collector_thread_;
-    boost::thread galileo_almanac_data_collector_thread_;
     void keyboard_listener();
 
+    std::string state_file_;       // receiver state file, empty if it is not kept
+    double state_save_period_s_;
+    boost::thread state_thread_;
+
     // default filename for assistance data
     const std::string eph_default_xml_filename = "./gps_ephemeris.xml";
     const std::string utc_default_xml_filename = "./gps_utc_model.xml";
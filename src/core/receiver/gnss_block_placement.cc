@@ -0,0 +1,228 @@
+/*!
+ * \file gnss_block_placement.cc
+ * \brief CPU affinity, real-time priority and output buffer size of the
+ * GNU Radio blocks of the receiver, from the configuration
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_block_placement.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+#include <gnuradio/block.h>
+#include <glog/logging.h>
+#include "configuration_interface.h"
+
+using google::LogMessage;
+
+
+std::vector<int> gnss_parse_cpu_list(const std::string& list)
+{
+    std::vector<int> cpus;
+    std::stringstream list_stream(list);
+    std::string part;
+    while (std::getline(list_stream, part, ','))
+        {
+            part.erase(0, part.find_first_not_of(" \t\n"));
+            part.erase(part.find_last_not_of(" \t\n") + 1);
+            if (part.empty()) continue;
+            std::size_t dash = part.find('-');
+            try
+            {
+                    int first = boost::lexical_cast<int>(part.substr(0, dash));
+                    int last = (dash == std::string::npos) ? first : boost::lexical_cast<int>(part.substr(dash + 1));
+                    if (first < 0 or last < first) continue;
+                    for (int cpu = first; cpu <= last; cpu++)
+                        {
+                            cpus.push_back(cpu);
+                        }
+            }
+            catch (boost::bad_lexical_cast&)
+            {
+                    LOG(WARNING) << "Bad CPU list item " << part << " in " << list;
+            }
+        }
+    return cpus;
+}
+
+
+std::string gnss_format_cpu_list(const std::vector<int>& cpus)
+{
+    std::stringstream list;
+    for (unsigned int i = 0; i < cpus.size(); i++)
+        {
+            unsigned int last = i;
+            while (last + 1 < cpus.size() and cpus[last + 1] == cpus[last] + 1)
+                {
+                    last++;
+                }
+            if (i > 0) list << ",";
+            list << cpus[i];
+            if (last > i) list << "-" << cpus[last];
+            i = last;
+        }
+    return list.str();
+}
+
+
+std::vector<std::vector<int> > gnss_numa_nodes(const std::string& node_dir)
+{
+    std::vector<std::vector<int> > nodes;
+    boost::system::error_code ec;
+    for (unsigned int node = 0; boost::filesystem::exists(node_dir + "/node" + boost::lexical_cast<std::string>(node), ec); node++)
+        {
+            std::ifstream cpulist((node_dir + "/node" + boost::lexical_cast<std::string>(node) + "/cpulist").c_str());
+            std::string list;
+            std::getline(cpulist, list);
+            nodes.push_back(gnss_parse_cpu_list(list));
+        }
+    if (nodes.empty())
+        {
+            unsigned int cpus = std::max(boost::thread::hardware_concurrency(), 1u);
+            nodes.push_back(std::vector<int>());
+            for (unsigned int cpu = 0; cpu < cpus; cpu++)
+                {
+                    nodes.back().push_back(cpu);
+                }
+        }
+    return nodes;
+}
+
+
+Gnss_Block_Placer::Gnss_Block_Placer(ConfigurationInterface* configuration, unsigned int channels,
+        const std::vector<std::vector<int> >& nodes)
+{
+    d_configuration = configuration;
+    d_nodes = nodes;
+    if (d_nodes.empty()) d_nodes.push_back(std::vector<int>());
+    d_numa_layout = configuration->property("GNSS-SDR.numa_layout", false);
+
+    // the node of the conditioner: from its own affinity, or the configured one
+    d_front_node = configuration->property("GNSS-SDR.numa_node", 0);
+    std::vector<std::string> front_roles = {"SignalConditioner", "SignalSource"};
+    std::vector<int> front_affinity = gnss_parse_cpu_list(option(front_roles, "affinity"));
+    for (unsigned int node = 0; node < d_nodes.size() and not front_affinity.empty(); node++)
+        {
+            if (std::find(d_nodes[node].begin(), d_nodes[node].end(), front_affinity[0]) != d_nodes[node].end())
+                {
+                    d_front_node = node;
+                }
+        }
+    if (d_front_node >= d_nodes.size())
+        {
+            LOG(WARNING) << "There is no NUMA node " << d_front_node << ", node 0 is used";
+            d_front_node = 0;
+        }
+
+    // a core for each channel: the ones of the front node left by the source and
+    // the conditioner, then the cores of the other nodes
+    std::vector<unsigned int> slots;
+    unsigned int front_cores = d_nodes[d_front_node].size() > 2 ? d_nodes[d_front_node].size() - 2 : 1;
+    slots.insert(slots.end(), front_cores, d_front_node);
+    for (unsigned int node = 0; node < d_nodes.size(); node++)
+        {
+            if (node != d_front_node) slots.insert(slots.end(), d_nodes[node].size(), node);
+        }
+    for (unsigned int channel = 0; channel < channels; channel++)
+        {
+            d_channel_nodes.push_back(slots[channel % slots.size()]);
+        }
+}
+
+
+unsigned int Gnss_Block_Placer::channel_node(unsigned int channel) const
+{
+    if (channel >= d_channel_nodes.size()) return d_front_node;
+    return d_channel_nodes[channel];
+}
+
+
+std::string Gnss_Block_Placer::option(const std::vector<std::string>& roles, const std::string& name)
+{
+    for (unsigned int i = 0; i < roles.size(); i++)
+        {
+            std::string value = d_configuration->property(roles[i] + "." + name, std::string(""));
+            if (not value.empty()) return value;
+        }
+    return std::string("");
+}
+
+
+Gnss_Block_Placement Gnss_Block_Placer::placement(const std::vector<std::string>& roles, int channel)
+{
+    Gnss_Block_Placement placement;
+    placement.affinity = gnss_parse_cpu_list(option(roles, "affinity"));
+    placement.min_output_buffer = std::atol(option(roles, "min_output_buffer").c_str());
+    placement.max_output_buffer = std::atol(option(roles, "max_output_buffer").c_str());
+    std::string rt_priority = option(roles, "rt_priority");
+    placement.rt_priority = rt_priority.empty() ? -1 : std::atoi(rt_priority.c_str());
+    if (d_numa_layout and placement.affinity.empty() and channel >= -1)
+        {
+            placement.affinity = d_nodes[channel == -1 ? d_front_node : channel_node(channel)];
+        }
+    return placement;
+}
+
+
+bool Gnss_Block_Placer::apply(gr::basic_block_sptr basic_block, const Gnss_Block_Placement& placement, const std::string& role)
+{
+    gr::block_sptr block = boost::dynamic_pointer_cast<gr::block>(basic_block);
+    if (not block) return false;
+    bool applied = false;
+    if (not placement.affinity.empty())
+        {
+            block->set_processor_affinity(placement.affinity);
+            applied = true;
+        }
+    if (placement.min_output_buffer > 0)
+        {
+            block->set_min_output_buffer(placement.min_output_buffer);
+            applied = true;
+        }
+    if (placement.max_output_buffer > 0)
+        {
+            block->set_max_output_buffer(placement.max_output_buffer);
+            applied = true;
+        }
+    if (placement.rt_priority >= 0)
+        {
+            // taken by the thread of the block when the flowgraph starts (SCHED_RR on Linux)
+            block->set_thread_priority(placement.rt_priority);
+            applied = true;
+        }
+    if (applied)
+        {
+            LOG(INFO) << role << " block " << block->name() << " CPUs " << gnss_format_cpu_list(placement.affinity)
+                      << ", min output buffer " << placement.min_output_buffer
+                      << ", max output buffer " << placement.max_output_buffer
+                      << ", real-time priority " << placement.rt_priority;
+        }
+    return applied;
+}
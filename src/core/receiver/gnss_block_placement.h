@@ -0,0 +1,123 @@
+/*!
+ * \file gnss_block_placement.h
+ * \brief CPU affinity, real-time priority and output buffer size of the
+ * GNU Radio blocks of the receiver, from the configuration
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_BLOCK_PLACEMENT_H_
+#define GNSS_SDR_GNSS_BLOCK_PLACEMENT_H_
+
+#include <string>
+#include <vector>
+#include <gnuradio/basic_block.h>
+
+class ConfigurationInterface;
+
+//! CPUs of a Linux cpulist such as "0-3,8,10-11", in order. Malformed parts are skipped.
+std::vector<int> gnss_parse_cpu_list(const std::string& list);
+
+//! Formats \p cpus as a cpulist, "0-3,8"
+std::string gnss_format_cpu_list(const std::vector<int>& cpus);
+
+/*!
+ * \brief CPUs of each NUMA node, read from \p node_dir (nodeN/cpulist).
+ * If the nodes are unknown, a single node with all the CPUs.
+ */
+std::vector<std::vector<int> > gnss_numa_nodes(const std::string& node_dir = "/sys/devices/system/node");
+
+
+//! Where and how a block runs
+struct Gnss_Block_Placement
+{
+    std::vector<int> affinity;   //!< CPUs its thread may run on, empty for any
+    long min_output_buffer;      //!< Items of its output buffers, 0 for the scheduler default
+    long max_output_buffer;      //!< Largest items of its output buffers, 0 for no limit
+    int rt_priority;             //!< Real-time priority of its thread, -1 for a normal thread
+};
+
+
+/*!
+ * \brief This class reads the placement options of the blocks and applies
+ * them before the flowgraph starts.
+ *
+ * Each block takes the options (affinity, min_output_buffer,
+ * max_output_buffer, rt_priority) of the first of its roles that sets
+ * them: for the blocks of channel 3 that are the tracking,
+ * Channel3.affinity, then Tracking_GPS.affinity, then Channel.affinity.
+ *
+ * With GNSS-SDR.numa_layout=true, the blocks without an affinity of their
+ * own are laid out on the NUMA nodes: the signal source and conditioner on
+ * the node of the conditioner (the node of the first CPU in its affinity,
+ * or GNSS-SDR.numa_node), and the channels on that node as well, one per
+ * remaining core, before they spill over to the other nodes. The samples
+ * written by the conditioner are then read by the channels from local
+ * memory as far as the cores allow.
+ */
+class Gnss_Block_Placer
+{
+public:
+    /*!
+     * \brief Constructor.
+     * \param[in] configuration Configuration of the receiver
+     * \param[in] channels Number of channels
+     * \param[in] nodes CPUs of each NUMA node (see gnss_numa_nodes())
+     */
+    Gnss_Block_Placer(ConfigurationInterface* configuration, unsigned int channels,
+            const std::vector<std::vector<int> >& nodes);
+
+    /*!
+     * \brief Placement of a block with \p roles, the most specific first.
+     * \p channel is the channel of the block, -1 for the blocks that
+     * feed the channels (source and conditioner), -2 for the ones after
+     * them.
+     */
+    Gnss_Block_Placement placement(const std::vector<std::string>& roles, int channel);
+
+    //! NUMA node of the signal conditioner
+    unsigned int front_node() const { return d_front_node; }
+
+    //! NUMA node of \p channel with numa_layout
+    unsigned int channel_node(unsigned int channel) const;
+
+    /*!
+     * \brief Applies \p placement to \p block, named \p role in the log.
+     * Hierarchical blocks are left as they are. Returns true if something
+     * was applied.
+     */
+    static bool apply(gr::basic_block_sptr block, const Gnss_Block_Placement& placement, const std::string& role);
+
+private:
+    std::string option(const std::vector<std::string>& roles, const std::string& name);
+
+    ConfigurationInterface* d_configuration;
+    std::vector<std::vector<int> > d_nodes;
+    bool d_numa_layout;
+    unsigned int d_front_node;
+    std::vector<unsigned int> d_channel_nodes;
+};
+
+#endif
@@ -34,20 +34,40 @@
 
 #include "gnss_flowgraph.h"
 #include "unistd.h"
+#include <algorithm>
+#include <ctime>
 #include <exception>
+#include <functional>
 #include <iostream>
 #include <set>
+#include <sstream>
 #include <boost/lexical_cast.hpp>
+#include <gnuradio/gr_complex.h>
 #include <glog/logging.h>
 #include "configuration_interface.h"
 #include "gnss_block_interface.h"
 #include "channel_interface.h"
+#include "acquisition_interface.h"
+#include "tracking_interface.h"
+#include "telemetry_decoder_interface.h"
+#include "signal_conditioner.h"
+#include "gnss_block_placement.h"
 #include "gnss_block_factory.h"
+#include "concurrent_map.h"
+#include "gnss_receiver_state.h"
+#include "gnss_supl_assistance.h"
+#include "gnss_latency.h"
+#include "gnss_sample_clock_sink.h"
 
 #define GNSS_SDR_ARRAY_SIGNAL_CONDITIONER_CHANNELS 8
 
 using google::LogMessage;
 
+extern concurrent_map<Gps_Ephemeris> global_gps_ephemeris_map;
+extern concurrent_map<Gnss_Receiver_Fix> global_receiver_fix_map;
+extern concurrent_map<Gps_Ref_Location> global_gps_ref_location_map;
+extern concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
+
 GNSSFlowgraph::GNSSFlowgraph(std::shared_ptr<ConfigurationInterface> configuration,
         boost::shared_ptr<gr::msg_queue> queue)
 {
@@ -86,6 +106,35 @@ void GNSSFlowgraph::start()
             return;
     }
 
+    int metrics_port = configuration_->property("GNSS-SDR.metrics_port", -1);
+    double metrics_log_period_s = configuration_->property("GNSS-SDR.metrics_log_period_s", 0.0);
+    if (metrics_port >= 0 or metrics_log_period_s > 0.0)
+        {
+            std::string metrics_address = configuration_->property("GNSS-SDR.metrics_address", std::string("127.0.0.1"));
+            metrics_server_ = std::make_shared<Gnss_Metrics_Server>(metrics_address, metrics_port, metrics_log_period_s);
+            metrics_server_->start();
+        }
+
+    if (configuration_->property("GNSS-SDR.realtime_monitor", false))
+        {
+            if (sample_clock_)
+                {
+                    set_shedding_policies();
+                    double fs_hz = configuration_->property("GNSS-SDR.internal_fs_hz", 2048000.0);
+                    double max_backlog_s = configuration_->property("GNSS-SDR.realtime_max_backlog_s", 0.5);
+                    double min_rate = configuration_->property("GNSS-SDR.realtime_min_rate", 0.99);
+                    double period_s = configuration_->property("GNSS-SDR.realtime_check_period_s", 1.0);
+                    double restore_s = configuration_->property("GNSS-SDR.realtime_restore_s", 30.0);
+                    realtime_monitor_ = std::make_shared<Gnss_Realtime_Monitor>(fs_hz, channels_count_,
+                            shedding_policies_.size(), max_backlog_s, min_rate, period_s, restore_s, queue_);
+                    realtime_monitor_->start();
+                }
+            else
+                {
+                    LOG(WARNING) << "The real-time monitor needs GNSS-SDR.latency_tracing=true, it is not started";
+                }
+        }
+
     running_ = true;
 }
 
@@ -93,6 +142,11 @@ void GNSSFlowgraph::start()
 
 void GNSSFlowgraph::stop()
 {
+    if (realtime_monitor_)
+        {
+            realtime_monitor_->stop();
+            realtime_monitor_.reset();
+        }
     for (unsigned int i = 0; i < channels_count_; i++)
         {
             channels_.at(i)->stop();
@@ -100,6 +154,16 @@ void GNSSFlowgraph::stop()
         }
     LOG(INFO) << "Threads finished. Return to main program.";
     top_block_->stop();
+    if (metrics_server_)
+        {
+            metrics_server_->stop();
+            metrics_server_.reset();
+        }
+    std::vector<std::string> latency = gnss_latency_summary(std::vector<Gnss_Latency_Snapshot>(), gnss_latency_snapshot());
+    for (unsigned int i = 0; i < latency.size(); i++)
+        {
+            LOG(INFO) << "Latency " << latency[i];
+        }
     running_ = false;
 }
 
@@ -285,6 +349,14 @@ void GNSSFlowgraph::connect()
                     LOG(INFO) << "Channel " << i
                               << " connected to observables and ready for acquisition";
                 }
+            else if (channels_state_[i] == 3)
+                {
+                    // it only kept a signal of its system, for when it is put back in use
+                    available_GNSS_signals_.push_back(channels_.at(i)->get_signal());
+                    channels_.at(i)->park(true);
+                    LOG(INFO) << "Channel " << i
+                              << " connected to observables and parked";
+                }
             else
                 {
                     LOG(INFO) << "Channel " << i
@@ -323,6 +395,27 @@ void GNSSFlowgraph::connect()
     }
 
     DLOG(INFO) << "PVT connected to output filter";
+
+    // Signal conditioner > sample clock, which stamps when the samples reach the channels
+    if (configuration_->property("GNSS-SDR.latency_tracing", true))
+        {
+            // the PVT counts the epochs older than this as late
+            gnss_latency_set_late_threshold(configuration_->property("GNSS-SDR.late_epoch_s", GNSS_LATENCY_LATE_S));
+            try
+            {
+                    sample_clock_ = gnss_sdr_make_sample_clock_sink(sizeof(gr_complex));
+                    top_block_->connect(sig_conditioner_->get_right_block(), 0, sample_clock_, 0);
+            }
+            catch (std::exception& e)
+            {
+                    LOG(WARNING) << "Can't connect the sample clock, the latencies from the source will not be known";
+                    LOG(ERROR) << e.what();
+                    sample_clock_.reset();
+            }
+        }
+
+    place_blocks();
+
     connected_ = true;
     LOG(INFO) << "Flowgraph connected";
     top_block_->dump();
@@ -357,20 +450,52 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
 {
     LOG(INFO) << "received " << what << " from " << who;
 
+    if (who == GNSS_REALTIME_MONITOR_ID)
+        {
+            if (what == 1)
+                {
+                    shed_load();
+                }
+            else
+                {
+                    restore_load();
+                }
+            return;
+        }
+    if (who == GNSS_CHANNEL_POOL_ID)
+        {
+            set_active_channels(what);
+            return;
+        }
+    if (who == GNSS_SUPL_ASSISTANCE_ID)
+        {
+            // new ephemeris, reference location or acquisition assistance
+            prioritize_signals_in_view();
+            return;
+        }
+
     switch (what)
     {
     case 0:
         LOG(INFO) << "Channel " << who << " ACQ FAILED satellite " << channels_.at(who)->get_signal().get_satellite();
         available_GNSS_signals_.push_back(channels_.at(who)->get_signal());
-
-        while (channels_.at(who)->get_signal().get_satellite().get_system() != available_GNSS_signals_.front().get_satellite().get_system())
+        if (parking_channels_.erase(who) > 0)
             {
-                available_GNSS_signals_.push_back(available_GNSS_signals_.front());
-                available_GNSS_signals_.pop_front();
+                acq_channels_count_--;
+                park_channel(who);
+                start_next_acquisition();
+                break;
             }
-        channels_.at(who)->set_signal(available_GNSS_signals_.front());
-        available_GNSS_signals_.pop_front();
-        channels_.at(who)->start_acquisition();
+        if (acquisition_paused_)
+            {
+                // an idle channel holds the satellite it searches next, as after a tracking failure
+                LOG(INFO) << "Channel " << who << " idle while the acquisition is paused";
+                assign_next_signal(who);
+                channels_state_[who] = 0;
+                acq_channels_count_--;
+                break;
+            }
+        acquire_next_signal(who);
 
         break;
         // TODO: Tracking messages
@@ -379,19 +504,12 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
         LOG(INFO) << "Channel " << who << " ACQ SUCCESS satellite " << channels_.at(who)->get_signal().get_satellite();
         channels_state_[who] = 2;
         acq_channels_count_--;
-        if (acq_channels_count_ < max_acq_channels_)
+        if (parking_channels_.count(who) > 0)
             {
-                for (unsigned int i = 0; i < channels_count_; i++)
-                    {
-                        if (channels_state_[i] == 0)
-                            {
-                                channels_state_[i] = 1;
-                                acq_channels_count_++;
-                                channels_.at(i)->start_acquisition();
-                                break;
-                            }
-                    }
+                // taken out of the pool while it was searching: it is parked when the tracking lets go
+                gnss_channel_progress().release(who);
             }
+        start_next_acquisition();
 
         for (unsigned int i = 0; i < channels_count_; i++)
             {
@@ -401,7 +519,19 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
 
     case 2:
         LOG(INFO) << "Channel " << who << " TRK FAILED satellite " << channels_.at(who)->get_signal().get_satellite();
-        if (acq_channels_count_ < max_acq_channels_)
+        if (parking_channels_.erase(who) > 0)
+            {
+                channels_.at(who)->standby();
+                available_GNSS_signals_.push_back(channels_.at(who)->get_signal());
+                park_channel(who);
+            }
+        else if (dropped_channel(who))
+            {
+                // released by the load shedding, it keeps its satellite until the load is restored
+                channels_state_[who] = 0;
+                channels_.at(who)->standby();
+            }
+        else if (acq_channels_count_ < max_acq_channels_ and not acquisition_paused_)
             {
                 channels_state_[who] = 1;
                 acq_channels_count_++;
@@ -427,6 +557,315 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
 
 
 
+void GNSSFlowgraph::acquire_next_signal(unsigned int who)
+{
+    assign_next_signal(who);
+    channels_.at(who)->start_acquisition();
+}
+
+
+
+void GNSSFlowgraph::assign_next_signal(unsigned int who)
+{
+    while (channels_.at(who)->get_signal().get_satellite().get_system() != available_GNSS_signals_.front().get_satellite().get_system())
+        {
+            available_GNSS_signals_.push_back(available_GNSS_signals_.front());
+            available_GNSS_signals_.pop_front();
+        }
+    channels_.at(who)->set_signal(available_GNSS_signals_.front());
+    available_GNSS_signals_.pop_front();
+}
+
+
+
+void GNSSFlowgraph::start_next_acquisition()
+{
+    if (acq_channels_count_ >= max_acq_channels_ or acquisition_paused_)
+        {
+            return;
+        }
+    for (unsigned int i = 0; i < channels_count_; i++)
+        {
+            if (channels_state_[i] == 0 and not dropped_channel(i))
+                {
+                    channels_state_[i] = 1;
+                    acq_channels_count_++;
+                    channels_.at(i)->start_acquisition();
+                    break;
+                }
+        }
+}
+
+
+
+bool GNSSFlowgraph::dropped_channel(unsigned int who) const
+{
+    return std::find(dropped_channels_.begin(), dropped_channels_.end(), static_cast<int>(who)) != dropped_channels_.end();
+}
+
+
+
+/*
+ * Grows or shrinks the channel pool from the top channel. The blocks of a
+ * parked channel stay connected, since the observables take one epoch of
+ * every channel at a time, but it does no acquisition nor tracking work.
+ */
+void GNSSFlowgraph::set_active_channels(unsigned int count)
+{
+    if (not connected_)
+        {
+            LOG(WARNING) << "The channels in use are set once the flowgraph is connected, see Channels.active";
+            return;
+        }
+    if (count > channels_count_)
+        {
+            LOG(WARNING) << "Only " << channels_count_ << " channels are connected, " << count << " cannot be in use";
+            count = channels_count_;
+        }
+    for (unsigned int i = active_channels_; i < count; i++)
+        {
+            if (parking_channels_.erase(i) == 0)
+                {
+                    unpark_channel(i);
+                }
+        }
+    for (unsigned int i = count; i < active_channels_; i++)
+        {
+            switch (channels_state_[i])
+            {
+            case 0:
+                available_GNSS_signals_.push_back(channels_.at(i)->get_signal());
+                park_channel(i);
+                break;
+            case 1:
+                parking_channels_.insert(i);   // parked when its search ends
+                break;
+            case 2:
+                parking_channels_.insert(i);
+                gnss_channel_progress().release(i);
+                break;
+            default:
+                break;
+            }
+        }
+    LOG(INFO) << "Channels in use: " << count << " of " << channels_count_ << " (was " << active_channels_ << ")";
+    active_channels_ = count;
+}
+
+
+
+void GNSSFlowgraph::park_channel(unsigned int who)
+{
+    channels_state_[who] = 3;
+    channels_.at(who)->park(true);
+    LOG(INFO) << "Channel " << who << " parked";
+}
+
+
+
+void GNSSFlowgraph::unpark_channel(unsigned int who)
+{
+    if (channels_state_[who] != 3)
+        {
+            return;
+        }
+    channels_.at(who)->park(false);
+    assign_next_signal(who);
+    channels_state_[who] = 0;
+    start_next_acquisition();
+    LOG(INFO) << "Channel " << who << " back in use, in state " << channels_state_[who];
+}
+
+
+
+void GNSSFlowgraph::set_shedding_policies()
+{
+    std::string policies = configuration_->property("GNSS-SDR.load_shedding_policies",
+            std::string("pause_acquisition,coarse_acquisition,drop_weakest"));
+    std::stringstream policies_stream(policies);
+    std::string policy;
+    shedding_policies_.clear();
+    while (std::getline(policies_stream, policy, ','))
+        {
+            policy.erase(0, policy.find_first_not_of(" \t"));
+            policy.erase(policy.find_last_not_of(" \t") + 1);
+            if (policy.empty()) continue;
+            if (policy == "pause_acquisition" or policy == "coarse_acquisition" or policy == "drop_weakest")
+                {
+                    shedding_policies_.push_back(policy);
+                }
+            else
+                {
+                    LOG(WARNING) << "Unknown load shedding policy " << policy << ", ignored";
+                }
+        }
+    shed_level_ = 0;
+}
+
+
+
+/*
+ * Applies the next load shedding policy. Every policy is undone by
+ * restore_load(), in the reverse order.
+ */
+void GNSSFlowgraph::shed_load()
+{
+    if (shed_level_ >= shedding_policies_.size())
+        {
+            LOG(WARNING) << "Load shedding: no policy left to apply";
+            return;
+        }
+    std::string policy = shedding_policies_.at(shed_level_);
+    shed_level_++;
+    if (policy == "pause_acquisition")
+        {
+            // the channels searching now finish their satellite and stay idle
+            acquisition_paused_ = true;
+            LOG(WARNING) << "Load shedding level " << shed_level_ << ": acquisition paused, "
+                         << acq_channels_count_ << " channels finish their search";
+        }
+    else if (policy == "coarse_acquisition")
+        {
+            for (unsigned int i = 0; i < channels_count_; i++)
+                {
+                    channels_.at(i)->set_coarse_acquisition(true);
+                }
+            LOG(WARNING) << "Load shedding level " << shed_level_ << ": acquisition with twice the Doppler step";
+        }
+    else if (policy == "drop_weakest")
+        {
+            int weakest = -1;
+            double weakest_cn0_db_hz = 0.0;
+            for (unsigned int i = 0; i < channels_count_; i++)
+                {
+                    unsigned long long samples;
+                    double cn0_db_hz;
+                    long long ns;
+                    if (channels_state_[i] != 2) continue;
+                    if (dropped_channel(i)) continue;
+                    if (not gnss_channel_progress().get(i, samples, cn0_db_hz, ns)) continue;
+                    if (weakest < 0 or cn0_db_hz < weakest_cn0_db_hz)
+                        {
+                            weakest = i;
+                            weakest_cn0_db_hz = cn0_db_hz;
+                        }
+                }
+            dropped_channels_.push_back(weakest);   // -1 if no channel was tracking, to keep the levels
+            if (weakest >= 0)
+                {
+                    // the tracking block reports a loss of lock, and the channel stands by
+                    gnss_channel_progress().release(weakest);
+                    LOG(WARNING) << "Load shedding level " << shed_level_ << ": channel " << weakest
+                                 << " released satellite " << channels_.at(weakest)->get_signal().get_satellite()
+                                 << ", CN0 " << weakest_cn0_db_hz << " dB-Hz";
+                }
+            else
+                {
+                    LOG(WARNING) << "Load shedding level " << shed_level_ << ": no tracking channel to release";
+                }
+        }
+}
+
+
+
+void GNSSFlowgraph::restore_load()
+{
+    if (shed_level_ == 0)
+        {
+            return;
+        }
+    shed_level_--;
+    std::string policy = shedding_policies_.at(shed_level_);
+    if (policy == "pause_acquisition")
+        {
+            acquisition_paused_ = false;
+            // the idle channels search the satellites they hold, such as those whose tracking failed meanwhile
+            for (unsigned int i = 0; i < channels_count_ and acq_channels_count_ < max_acq_channels_; i++)
+                {
+                    if (channels_state_[i] == 0 and not dropped_channel(i))
+                        {
+                            channels_state_[i] = 1;
+                            acq_channels_count_++;
+                            channels_.at(i)->start_acquisition();
+                        }
+                }
+            LOG(WARNING) << "Load restored to level " << shed_level_ << ": acquisition resumed";
+        }
+    else if (policy == "coarse_acquisition")
+        {
+            for (unsigned int i = 0; i < channels_count_; i++)
+                {
+                    channels_.at(i)->set_coarse_acquisition(false);
+                }
+            LOG(WARNING) << "Load restored to level " << shed_level_ << ": acquisition with the configured Doppler step";
+        }
+    else if (policy == "drop_weakest")
+        {
+            // the channel keeps the satellite it released, and searches it again when an acquisition slot is free
+            int channel = dropped_channels_.back();
+            dropped_channels_.pop_back();
+            start_next_acquisition();
+            LOG(WARNING) << "Load restored to level " << shed_level_ << ": channel " << channel << " can search again";
+        }
+}
+
+
+
+// Applies the placement of roles to the left and right blocks of adapter, once per block
+static void place_adapter(Gnss_Block_Placer& placer, std::set<gr::basic_block*>& placed,
+        GNSSBlockInterface* adapter, const std::vector<std::string>& roles, int channel)
+{
+    if (adapter == nullptr) return;
+    Gnss_Block_Placement placement = placer.placement(roles, channel);
+    gr::basic_block_sptr edges[2] = {adapter->get_left_block(), adapter->get_right_block()};
+    for (unsigned int i = 0; i < 2; i++)
+        {
+            if (edges[i] and placed.insert(edges[i].get()).second)
+                {
+                    Gnss_Block_Placer::apply(edges[i], placement, roles.front());
+                }
+        }
+}
+
+
+void GNSSFlowgraph::place_blocks()
+{
+    Gnss_Block_Placer placer(configuration_.get(), channels_count_, gnss_numa_nodes());
+    std::set<gr::basic_block*> placed;   // the left and right blocks of an adapter are often the same
+    place_adapter(placer, placed, sig_source_.get(), {"SignalSource"}, -1);
+    std::shared_ptr<SignalConditioner> conditioner = std::dynamic_pointer_cast<SignalConditioner>(sig_conditioner_);
+    if (conditioner)
+        {
+            GNSSBlockInterface* stages[3] = {conditioner->data_type_adapter(), conditioner->input_filter(), conditioner->resampler()};
+            for (unsigned int j = 0; j < 3; j++)
+                {
+                    if (stages[j] != nullptr) place_adapter(placer, placed, stages[j], {stages[j]->role(), "SignalConditioner"}, -1);
+                }
+        }
+    place_adapter(placer, placed, sig_conditioner_.get(), {"SignalConditioner"}, -1);
+    for (unsigned int i = 0; i < channels_count_; i++)
+        {
+            std::string channel_role = "Channel" + boost::lexical_cast<std::string>(i);
+            std::shared_ptr<ChannelInterface> channel = channels_.at(i);
+            place_adapter(placer, placed, channel->acquisition(), {channel_role, channel->acquisition()->role(), "Channel"}, i);
+            place_adapter(placer, placed, channel->tracking(), {channel_role, channel->tracking()->role(), "Channel"}, i);
+            place_adapter(placer, placed, channel->telemetry(), {channel_role, channel->telemetry()->role(), "Channel"}, i);
+            place_adapter(placer, placed, channel.get(), {channel_role, "Channel"}, i);
+        }
+    place_adapter(placer, placed, observables_.get(), {"Observables"}, -2);
+    place_adapter(placer, placed, pvt_.get(), {"PVT"}, -2);
+    place_adapter(placer, placed, output_filter_.get(), {"OutputFilter"}, -2);
+    if (configuration_->property("GNSS-SDR.numa_layout", false))
+        {
+            LOG(INFO) << "Signal conditioner on NUMA node " << placer.front_node();
+            for (unsigned int i = 0; i < channels_count_; i++)
+                {
+                    LOG(INFO) << "Channel " << i << " on NUMA node " << placer.channel_node(i);
+                }
+        }
+}
+
+
 void GNSSFlowgraph::set_configuration(std::shared_ptr<ConfigurationInterface> configuration)
 {
     if (running_)
@@ -478,11 +917,72 @@ void GNSSFlowgraph::init()
     set_signals_list();
     set_channels_state();
     applied_actions_ = 0;
+    shed_level_ = 0;
+    acquisition_paused_ = false;
     std::vector<std::shared_ptr<ChannelInterface>> channels_(channels_count_);
 
     DLOG(INFO) << "Blocks instantiated. " << channels_count_ << " channels.";
 }
 
+
+/*
+ * Hot start: with a known position and ephemeris (see Gnss_Receiver_State),
+ * the satellites in view are searched first, the highest first. The
+ * position is the last fix or else the SUPL reference location, and
+ * without ephemeris the elevations of the SUPL acquisition assistance are
+ * used. The signals held by a channel are left where they are.
+ */
+void GNSSFlowgraph::prioritize_signals_in_view()
+{
+    Gnss_Receiver_State state;
+    Gps_Ref_Location ref_location;
+    if (global_receiver_fix_map.read(0, state.fix) == false or state.fix.valid == false)
+        {
+            if (global_gps_ref_location_map.read(0, ref_location) and ref_location.valid)
+                {
+                    state.fix.set_position(ref_location.lat, ref_location.lon, 0.0);
+                }
+        }
+    std::vector<unsigned int> in_view;
+    if (state.fix.valid)
+        {
+            state.gps_ephemeris = global_gps_ephemeris_map.get_map_copy();
+            double elevation_mask_deg = configuration_->property("GNSS-SDR.state_elevation_mask_deg", 5.0);
+            in_view = state.gps_prns_in_view(static_cast<double>(std::time(nullptr)), elevation_mask_deg);
+        }
+    if (in_view.empty())
+        {
+            std::map<int, Gps_Acq_Assist> acq_assist = global_gps_acq_assist_map.get_map_copy();
+            std::vector<std::pair<double, unsigned int>> by_elevation;
+            for (std::map<int, Gps_Acq_Assist>::iterator it = acq_assist.begin(); it != acq_assist.end(); ++it)
+                {
+                    by_elevation.push_back(std::make_pair(it->second.Elevation, it->second.i_satellite_PRN));
+                }
+            std::sort(by_elevation.begin(), by_elevation.end(), std::greater<std::pair<double, unsigned int>>());
+            for (unsigned int i = 0; i < by_elevation.size(); i++)
+                {
+                    in_view.push_back(by_elevation.at(i).second);
+                }
+        }
+    unsigned int moved = 0;
+    for (std::vector<unsigned int>::reverse_iterator prn = in_view.rbegin(); prn != in_view.rend(); ++prn)
+        {
+            Gnss_Signal signal(Gnss_Satellite(std::string("GPS"), *prn), std::string("1C"));
+            std::list<Gnss_Signal>::iterator it = std::find(available_GNSS_signals_.begin(), available_GNSS_signals_.end(), signal);
+            if (it != available_GNSS_signals_.end())
+                {
+                    available_GNSS_signals_.erase(it);
+                    available_GNSS_signals_.push_front(signal);
+                    moved++;
+                }
+        }
+    if (moved > 0)
+        {
+            LOG(INFO) << moved << " GPS satellites in view are searched first";
+        }
+}
+
+
 void GNSSFlowgraph::set_signals_list()
 {
     /*
@@ -521,6 +1021,8 @@ void GNSSFlowgraph::set_signals_list()
                     available_GNSS_signals_.push_back(Gnss_Signal(Gnss_Satellite(std::string("GPS"),
                             *available_gnss_prn_iter), std::string("1C")));
                 }
+
+            prioritize_signals_in_view();
         }
 
 
@@ -620,17 +1122,28 @@ void GNSSFlowgraph::set_channels_state()
             LOG(WARNING) << "Channels_in_acquisition is bigger than number of channels. Variable acq_channels_count_ is set to "
                          << channels_count_;
         }
+    active_channels_ = configuration_->property("Channels.active", channels_count_);
+    if (active_channels_ > channels_count_)
+        {
+            active_channels_ = channels_count_;
+            LOG(WARNING) << "Channels.active is bigger than the number of channels, all of them are in use";
+        }
     channels_state_.reserve(channels_count_);
+    acq_channels_count_ = 0;
     for (unsigned int i = 0; i < channels_count_; i++)
         {
-            if (i < max_acq_channels_)
+            if (i >= active_channels_)
+                {
+                    channels_state_.push_back(3);   // parked
+                }
+            else if (i < max_acq_channels_)
                 {
                     channels_state_.push_back(1);
+                    acq_channels_count_++;
                 }
             else
                 channels_state_.push_back(0);
         }
-    acq_channels_count_ = max_acq_channels_;
     DLOG(INFO) << acq_channels_count_ << " channels in acquisition state";
     for (unsigned int i = 0; i < channels_count_; i++)
         {
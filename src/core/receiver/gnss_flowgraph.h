@@ -39,12 +39,17 @@
 #include <list>
 #include <memory>
 #include <queue>
+#include <set>
 #include <string>
 #include <vector>
 #include <gnuradio/top_block.h>
 #include <gnuradio/msg_queue.h>
 #include "GPS_L1_CA.h"
 #include "gnss_signal.h"
+#include "gnss_metrics_server.h"
+#include "gnss_realtime_monitor.h"
+
+#define GNSS_CHANNEL_POOL_ID 400   // who of the control messages setting the number of channels in use (what)
 
 class GNSSBlockInterface;
 class ChannelInterface;
@@ -95,6 +100,22 @@ public:
 
     void set_configuration(std::shared_ptr<ConfigurationInterface> configuration);
 
+    /*!
+     * \brief Sets how many of the connected channels are in use
+     *
+     * The channels from \p count on are parked: an idle one at once, one
+     * searching or tracking as soon as it lets its satellite go. A parked
+     * channel searches no satellite and frees its acquisition grid, and it
+     * is put back in use when the count grows again. Also set by the control
+     * messages (who = GNSS_CHANNEL_POOL_ID, what = count).
+     */
+    void set_active_channels(unsigned int count);
+
+    unsigned int active_channels()
+    {
+        return active_channels_;
+    }
+
     unsigned int applied_actions()
     {
         return applied_actions_;
@@ -111,8 +132,19 @@ public:
 private:
     void init(); // Populates the SV PRN list available for acquisition and tracking
     void set_signals_list();
+    void prioritize_signals_in_view(); // Moves the GPS satellites in view to the front of the signals list
     void set_channels_state(); // Initializes the channels state (start acquisition or keep standby)
                                // using the configuration parameters (number of channels and max channels in acquisition)
+    void acquire_next_signal(unsigned int who); // Starts the acquisition of the next available signal of the system of the channel
+    void assign_next_signal(unsigned int who);  // Gives the channel the next available signal of its system
+    void start_next_acquisition();              // Starts an idle channel, if an acquisition slot is free
+    void park_channel(unsigned int who);
+    void unpark_channel(unsigned int who);
+    void set_shedding_policies();
+    void shed_load();
+    void restore_load();
+    bool dropped_channel(unsigned int who) const; // Released by the drop_weakest policy until the load is restored
+    void place_blocks(); // Applies the affinity, priority and buffer options of each role to its blocks
     bool connected_;
     bool running_;
     unsigned int channels_count_;
@@ -133,6 +165,15 @@ private:
     boost::shared_ptr<gr::msg_queue> queue_;
     std::list<Gnss_Signal> available_GNSS_signals_;
     std::vector<unsigned int> channels_state_;
+    std::shared_ptr<Gnss_Metrics_Server> metrics_server_;
+    gr::basic_block_sptr sample_clock_;   // stamps the arrival of the samples at the channels
+    std::shared_ptr<Gnss_Realtime_Monitor> realtime_monitor_;
+    std::vector<std::string> shedding_policies_;   // applied in this order when the receiver falls behind
+    unsigned int shed_level_;                      // policies applied so far
+    bool acquisition_paused_;
+    std::vector<int> dropped_channels_;            // released by drop_weakest, -1 when there was none
+    unsigned int active_channels_;                 // channels in use, the others are parked (state 3)
+    std::set<unsigned int> parking_channels_;      // parked when they stop searching or tracking
 };
 
 #endif /*GNSS_SDR_GNSS_FLOWGRAPH_H_*/
@@ -0,0 +1,244 @@
+/*!
+ * \file gnss_metrics_server.cc
+ * \brief Serves the performance counters of the blocks in the Prometheus
+ * text format and logs a periodic summary of them
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_metrics_server.h"
+#include <sstream>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+Gnss_Metrics_Server::Gnss_Metrics_Server(const std::string& address, int port, double log_period_s) :
+        d_acceptor(d_io_service), d_timer(d_io_service)
+{
+    d_address = address;
+    d_listen_port = port;
+    d_port = 0;
+    d_log_period_s = log_period_s;
+    d_running = false;
+}
+
+
+Gnss_Metrics_Server::~Gnss_Metrics_Server()
+{
+    stop();
+}
+
+
+bool Gnss_Metrics_Server::start()
+{
+    if (d_running == true)
+        {
+            return true;
+        }
+    if (d_listen_port >= 0)
+        {
+            try
+            {
+                    boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address::from_string(d_address), d_listen_port);
+                    d_acceptor.open(endpoint.protocol());
+                    d_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+                    d_acceptor.bind(endpoint);
+                    d_acceptor.listen();
+                    d_port = d_acceptor.local_endpoint().port();
+            }
+            catch (const boost::system::system_error& e)
+            {
+                    LOG(WARNING) << "Cannot serve the metrics on " << d_address << ":" << d_listen_port << ": " << e.what();
+                    boost::system::error_code ec;
+                    d_acceptor.close(ec);
+                    return false;
+            }
+            accept();
+            LOG(INFO) << "Serving the block metrics on http://" << d_address << ":" << d_port << "/metrics";
+        }
+    if (d_log_period_s > 0.0)
+        {
+            d_last = gnss_block_counters_snapshot();
+            d_last_latency = gnss_latency_snapshot();
+            d_last_time = std::chrono::steady_clock::now();
+            schedule_summary();
+        }
+    d_running = true;
+    d_io_service.reset();
+    d_thread = boost::thread([this]() { d_io_service.run(); });
+    return true;
+}
+
+
+void Gnss_Metrics_Server::stop()
+{
+    if (d_running == false)
+        {
+            return;
+        }
+    // with the acceptor and the sockets closed and the timer cancelled the server thread runs out of work and returns
+    d_io_service.post([this]()
+            {
+                boost::system::error_code ec;
+                d_acceptor.close(ec);
+                d_timer.cancel(ec);
+                while (d_client_list.empty() == false)
+                    {
+                        close(d_client_list.front());
+                    }
+            });
+    d_thread.join();
+    d_running = false;
+    if (d_log_period_s > 0.0)
+        {
+            log_summary();
+        }
+}
+
+
+void Gnss_Metrics_Server::accept()
+{
+    Metrics_Client_Ptr client = std::make_shared<Metrics_Client>(d_io_service);
+    d_acceptor.async_accept(client->socket, [this, client](const boost::system::error_code& error)
+            {
+                if (error)
+                    {
+                        if (error != boost::asio::error::operation_aborted)
+                            {
+                                LOG(WARNING) << "Metrics server accept error: " << error.message();
+                                accept();
+                            }
+                        return;
+                    }
+                d_client_list.push_back(client);
+                answer(client);
+                accept();
+            });
+}
+
+
+void Gnss_Metrics_Server::answer(const Metrics_Client_Ptr& client)
+{
+    // an idle or slow client is dropped, it does not hold the server
+    client->deadline.expires_from_now(boost::posix_time::seconds(METRICS_CLIENT_TIMEOUT_S));
+    client->deadline.async_wait([this, client](const boost::system::error_code& error)
+            {
+                if (!error)
+                    {
+                        close(client);
+                    }
+            });
+    boost::asio::async_read_until(client->socket, client->request, "\r\n\r\n",
+            [this, client](const boost::system::error_code& error, std::size_t)
+            {
+                if (error)
+                    {
+                        close(client);
+                        return;
+                    }
+                std::istream request(&client->request);
+                std::string method;
+                std::string path;
+                request >> method >> path;
+                std::string status = "200 OK";
+                std::string body;
+                if (method != "GET")
+                    {
+                        status = "405 Method Not Allowed";
+                    }
+                else if (path != "/metrics" and path != "/")
+                    {
+                        status = "404 Not Found";
+                    }
+                else
+                    {
+                        body = gnss_block_counters_prometheus(gnss_block_counters_snapshot())
+                               + gnss_latency_prometheus(gnss_latency_snapshot());
+                    }
+                std::ostringstream response;
+                response << "HTTP/1.0 " << status << "\r\n"
+                         << "Content-Type: text/plain; version=0.0.4\r\n"
+                         << "Content-Length: " << body.size() << "\r\n"
+                         << "Connection: close\r\n\r\n"
+                         << body;
+                client->response = response.str();
+                boost::asio::async_write(client->socket, boost::asio::buffer(client->response),
+                        [this, client](const boost::system::error_code&, std::size_t)
+                        {
+                            close(client);
+                        });
+            });
+}
+
+
+void Gnss_Metrics_Server::close(const Metrics_Client_Ptr& client)
+{
+    boost::system::error_code ec;
+    client->deadline.cancel(ec);
+    if (client->socket.is_open())
+        {
+            client->socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+            client->socket.close(ec);
+        }
+    d_client_list.remove(client);
+}
+
+
+void Gnss_Metrics_Server::schedule_summary()
+{
+    d_timer.expires_from_now(boost::posix_time::microseconds(static_cast<long>(d_log_period_s * 1e6)));
+    d_timer.async_wait([this](const boost::system::error_code& error)
+            {
+                if (error)
+                    {
+                        return;
+                    }
+                log_summary();
+                schedule_summary();
+            });
+}
+
+
+void Gnss_Metrics_Server::log_summary()
+{
+    std::vector<Gnss_Block_Counters_Snapshot> now = gnss_block_counters_snapshot();
+    std::chrono::steady_clock::time_point now_time = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now_time - d_last_time).count();
+    std::vector<std::string> summary = gnss_block_counters_summary(d_last, now, seconds);
+    for (unsigned int i = 0; i < summary.size(); i++)
+        {
+            LOG(INFO) << "Block " << summary[i];
+        }
+    std::vector<Gnss_Latency_Snapshot> latency = gnss_latency_snapshot();
+    summary = gnss_latency_summary(d_last_latency, latency);
+    for (unsigned int i = 0; i < summary.size(); i++)
+        {
+            LOG(INFO) << "Latency " << summary[i];
+        }
+    d_last = now;
+    d_last_time = now_time;
+    d_last_latency = latency;
+}
@@ -0,0 +1,113 @@
+/*!
+ * \file gnss_metrics_server.h
+ * \brief Serves the performance counters of the blocks in the Prometheus
+ * text format and logs a periodic summary of them
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_METRICS_SERVER_H_
+#define GNSS_SDR_GNSS_METRICS_SERVER_H_
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/thread.hpp>
+#include "gnss_block_counters.h"
+#include "gnss_latency.h"
+
+#define METRICS_CLIENT_TIMEOUT_S 5
+
+/*!
+ * \brief This class serves the counters of all the blocks (see
+ * Gnss_Block_Counters) on a local HTTP endpoint, in the Prometheus text
+ * format: any GET request to /metrics gets them, followed by the latency
+ * histograms of the receiver stages (see gnss_latency_histogram()). It
+ * also logs a summary of what each block did every log period, the
+ * busiest blocks first, and of the latencies of that period.
+ *
+ * Requests and the summary are handled by a dedicated thread, which only
+ * reads the counters: the blocks are never blocked by it. A client has
+ * METRICS_CLIENT_TIMEOUT_S seconds to send its request and read the answer.
+ */
+class Gnss_Metrics_Server
+{
+public:
+    /*!
+     * \brief Constructor.
+     * \param[in] address Address to listen on, usually the loopback
+     * \param[in] port TCP port (0 lets the system choose one, see port()). Negative: no endpoint
+     * \param[in] log_period_s Period of the summary log [s] (0: no summary)
+     */
+    Gnss_Metrics_Server(const std::string& address, int port, double log_period_s);
+
+    ~Gnss_Metrics_Server();
+
+    /*!
+     * \brief Starts listening and the server thread. Returns false if the port cannot be used.
+     */
+    bool start();
+
+    //! Closes the connections and stops the server thread
+    void stop();
+
+    unsigned short port() const { return d_port; }   //!< Port the server is listening on
+
+private:
+    struct Metrics_Client
+    {
+        boost::asio::ip::tcp::socket socket;
+        boost::asio::deadline_timer deadline;
+        boost::asio::streambuf request;
+        std::string response;
+        Metrics_Client(boost::asio::io_service& io_service) : socket(io_service), deadline(io_service) {}
+    };
+    typedef std::shared_ptr<Metrics_Client> Metrics_Client_Ptr;
+
+    void accept();
+    void answer(const Metrics_Client_Ptr& client);
+    void close(const Metrics_Client_Ptr& client);
+    void schedule_summary();
+    void log_summary();
+
+    boost::asio::io_service d_io_service;
+    boost::asio::ip::tcp::acceptor d_acceptor;
+    boost::asio::deadline_timer d_timer;
+    std::list<Metrics_Client_Ptr> d_client_list;  // only used by the server thread
+    boost::thread d_thread;
+    std::string d_address;
+    int d_listen_port;
+    unsigned short d_port;
+    double d_log_period_s;
+    bool d_running;
+    std::vector<Gnss_Block_Counters_Snapshot> d_last;           // only used by the server thread
+    std::chrono::steady_clock::time_point d_last_time;
+    std::vector<Gnss_Latency_Snapshot> d_last_latency;
+};
+
+#endif
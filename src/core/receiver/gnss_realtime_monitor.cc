@@ -0,0 +1,191 @@
+/*!
+ * \file gnss_realtime_monitor.cc
+ * \brief Watches whether the receiver keeps up with a live signal source
+ * and asks the flowgraph to shed or restore load
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_realtime_monitor.h"
+#include <memory>
+#include <glog/logging.h>
+#include "control_message_factory.h"
+#include "gnss_latency.h"
+
+using google::LogMessage;
+
+
+Gnss_Realtime_Monitor::Gnss_Realtime_Monitor(double fs_hz, unsigned int channels, unsigned int levels,
+        double max_backlog_s, double min_rate, double period_s, double restore_s,
+        boost::shared_ptr<gr::msg_queue> queue)
+{
+    d_fs_hz = fs_hz;
+    d_channels = channels;
+    d_levels = levels;
+    d_max_backlog_s = max_backlog_s;
+    d_min_rate = min_rate;
+    d_period_s = period_s;
+    d_restore_s = restore_s;
+    d_queue = queue;
+    d_level = 0;
+    d_last_change_s = -1.0;
+    d_healthy_since_s = -1.0;
+    d_last_samples = 0;
+    d_last_ns = 0;
+}
+
+
+Gnss_Realtime_Monitor::~Gnss_Realtime_Monitor()
+{
+    stop();
+}
+
+
+void Gnss_Realtime_Monitor::start()
+{
+    if (d_thread.joinable()) return;
+    d_thread = boost::thread(&Gnss_Realtime_Monitor::run, this);
+}
+
+
+void Gnss_Realtime_Monitor::stop()
+{
+    if (not d_thread.joinable()) return;
+    d_thread.interrupt();
+    d_thread.join();
+}
+
+
+bool Gnss_Realtime_Monitor::measure(Gnss_Realtime_Check& check)
+{
+    long long now = gnss_steady_ns();
+    unsigned long long samples = 0;
+    long long arrival_ns = 0;
+    gnss_sample_clock().latest(samples, arrival_ns);
+    bool first = (d_last_ns == 0);
+    check.elapsed_s = first ? 0.0 : static_cast<double>(now - d_last_ns) * 1e-9;
+    check.arrival_rate = (first or check.elapsed_s <= 0.0) ? 0.0
+            : static_cast<double>(samples - d_last_samples) / check.elapsed_s / d_fs_hz;
+    bool arrived = (not first and samples > d_last_samples);
+    d_last_samples = samples;
+    d_last_ns = now;
+
+    // channels not recorded for two periods are not tracking
+    check.backlog_s = 0.0;
+    check.lagging_channel = -1;
+    long long stale_ns = static_cast<long long>(2.0 * d_period_s * 1e9);
+    for (unsigned int channel = 0; channel < d_channels; channel++)
+        {
+            unsigned long long processed;
+            double cn0_db_hz;
+            long long ns;
+            if (not gnss_channel_progress().get(channel, processed, cn0_db_hz, ns)) continue;
+            if (now - ns > stale_ns) continue;
+            double backlog_s = (samples > processed) ? static_cast<double>(samples - processed) / d_fs_hz : 0.0;
+            if (check.lagging_channel < 0 or backlog_s > check.backlog_s)
+                {
+                    check.backlog_s = backlog_s;
+                    check.lagging_channel = channel;
+                }
+        }
+    return arrived;
+}
+
+
+int Gnss_Realtime_Monitor::decide(const Gnss_Realtime_Check& check, double now_s)
+{
+    bool behind = check.backlog_s > d_max_backlog_s or check.arrival_rate < d_min_rate;
+    bool healthy = check.backlog_s < 0.5 * d_max_backlog_s and check.arrival_rate >= d_min_rate;
+    bool settled = d_last_change_s < 0.0 or now_s - d_last_change_s >= 2.0 * d_period_s;
+    if (behind)
+        {
+            d_healthy_since_s = -1.0;
+            if (d_level < d_levels and settled)
+                {
+                    d_level++;
+                    d_last_change_s = now_s;
+                    return 1;
+                }
+            return 0;
+        }
+    if (not healthy)
+        {
+            d_healthy_since_s = -1.0;
+            return 0;
+        }
+    if (d_healthy_since_s < 0.0) d_healthy_since_s = now_s;
+    if (d_level > 0 and settled and now_s - d_healthy_since_s >= d_restore_s)
+        {
+            d_level--;
+            d_last_change_s = now_s;
+            d_healthy_since_s = now_s;   // the next level needs a full restore time too
+            return -1;
+        }
+    return 0;
+}
+
+
+void Gnss_Realtime_Monitor::run()
+{
+    std::unique_ptr<ControlMessageFactory> cmf(new ControlMessageFactory());
+    Gnss_Realtime_Check check;
+    try
+    {
+            measure(check);   // the first measure sets the reference
+            while (true)
+                {
+                    boost::this_thread::sleep(boost::posix_time::microseconds(static_cast<long>(d_period_s * 1e6)));
+                    if (not measure(check))
+                        {
+                            DLOG(INFO) << "No samples reached the channels in the last " << check.elapsed_s << " s";
+                            continue;
+                        }
+                    DLOG(INFO) << "Arrival rate " << check.arrival_rate << ", backlog " << check.backlog_s
+                               << " s in channel " << check.lagging_channel;
+                    int action = decide(check, static_cast<double>(gnss_steady_ns()) * 1e-9);
+                    if (action == 0) continue;
+                    if (action > 0)
+                        {
+                            LOG(WARNING) << "Real time lost: arrival rate " << check.arrival_rate
+                                         << " of the sampling frequency, backlog " << check.backlog_s
+                                         << " s in channel " << check.lagging_channel
+                                         << ". Shedding load, level " << d_level;
+                        }
+                    else
+                        {
+                            LOG(WARNING) << "Real time kept for " << d_restore_s
+                                         << " s. Restoring load, level " << d_level;
+                        }
+                    if (d_queue != gr::msg_queue::sptr())
+                        {
+                            d_queue->handle(cmf->GetQueueMessage(GNSS_REALTIME_MONITOR_ID, action > 0 ? 1 : 0));
+                        }
+                }
+    }
+    catch (boost::thread_interrupted&)
+    {
+            DLOG(INFO) << "Real-time monitor stopped at level " << d_level;
+    }
+}
@@ -0,0 +1,127 @@
+/*!
+ * \file gnss_realtime_monitor.h
+ * \brief Watches whether the receiver keeps up with a live signal source
+ * and asks the flowgraph to shed or restore load
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_REALTIME_MONITOR_H_
+#define GNSS_SDR_GNSS_REALTIME_MONITOR_H_
+
+#include <boost/thread.hpp>
+#include <gnuradio/msg_queue.h>
+
+#define GNSS_REALTIME_MONITOR_ID 300   // who of the control messages of the monitor
+
+//! What the monitor measured in a check period
+struct Gnss_Realtime_Check
+{
+    double elapsed_s;       //!< Wall-clock time since the previous check [s]
+    double arrival_rate;    //!< Samples that reached the channels per second, over the sampling frequency
+    double backlog_s;       //!< Largest lag of a tracking channel behind the newest samples [s]
+    int lagging_channel;    //!< Channel with that lag, -1 if no channel is tracking
+};
+
+
+/*!
+ * \brief This class compares, every check period, the samples processed
+ * by the receiver with the wall-clock time.
+ *
+ * Globally, the samples that reach the channels (see Gnss_Sample_Clock)
+ * must arrive at the sampling frequency: a live source that delivers less
+ * is dropping what the receiver could not take (overruns). Per channel,
+ * the last sample processed by each tracking block (see
+ * Gnss_Channel_Progress) must not lag far behind the newest sample.
+ *
+ * When the receiver falls behind, the monitor posts a control message
+ * (who = GNSS_REALTIME_MONITOR_ID, what = 1) asking the flowgraph to shed
+ * one more level of load; once it has kept up for the restore time, it
+ * asks to restore one level (what = 0). It waits two check periods after
+ * every request, so that the flowgraph has time to act.
+ */
+class Gnss_Realtime_Monitor
+{
+public:
+    /*!
+     * \brief Constructor.
+     * \param[in] fs_hz Sampling frequency of the samples reaching the channels [Hz]
+     * \param[in] channels Number of channels
+     * \param[in] levels Number of shedding levels the flowgraph can apply
+     * \param[in] max_backlog_s Largest lag of a channel before shedding [s]
+     * \param[in] min_rate Lowest arrival rate, relative to fs_hz, before shedding
+     * \param[in] period_s Check period [s]
+     * \param[in] restore_s Time keeping up before restoring a level [s]
+     * \param[in] queue Control queue of the receiver
+     */
+    Gnss_Realtime_Monitor(double fs_hz, unsigned int channels, unsigned int levels,
+            double max_backlog_s, double min_rate, double period_s, double restore_s,
+            boost::shared_ptr<gr::msg_queue> queue);
+
+    ~Gnss_Realtime_Monitor();
+
+    //! Starts the monitor thread
+    void start();
+
+    //! Stops the monitor thread
+    void stop();
+
+    /*!
+     * \brief Measures the arrival rate since the previous call and the
+     * backlog of the channels. Returns false if no sample arrived since
+     * the previous call (the source stalled or ended): there is nothing
+     * to judge.
+     */
+    bool measure(Gnss_Realtime_Check& check);
+
+    /*!
+     * \brief Feeds \p check, taken at \p now_s [s], to the hysteresis.
+     * Returns 1 to shed one more level, -1 to restore one, 0 to keep the
+     * current level.
+     */
+    int decide(const Gnss_Realtime_Check& check, double now_s);
+
+    unsigned int level() const { return d_level; }   //!< Levels shed so far
+
+private:
+    void run();
+
+    double d_fs_hz;
+    unsigned int d_channels;
+    unsigned int d_levels;
+    double d_max_backlog_s;
+    double d_min_rate;
+    double d_period_s;
+    double d_restore_s;
+    boost::shared_ptr<gr::msg_queue> d_queue;
+    boost::thread d_thread;
+    unsigned int d_level;
+    double d_last_change_s;      // time of the last request, negative if none
+    double d_healthy_since_s;    // start of the current healthy stretch, negative if none
+    unsigned long long d_last_samples;
+    long long d_last_ns;
+};
+
+#endif
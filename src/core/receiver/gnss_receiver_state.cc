@@ -0,0 +1,349 @@
+/*!
+ * \file gnss_receiver_state.cc
+ * \brief Navigation data and last fix of the receiver, kept on disk
+ * between runs for a hot start
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_receiver_state.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/crc.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/filesystem.hpp>
+#include <glog/logging.h>
+#include "concurrent_map.h"
+
+using google::LogMessage;
+
+extern concurrent_map<Gps_Ephemeris> global_gps_ephemeris_map;
+extern concurrent_map<Gps_Iono> global_gps_iono_map;
+extern concurrent_map<Gps_Utc_Model> global_gps_utc_model_map;
+extern concurrent_map<Gps_Almanac> global_gps_almanac_map;
+
+extern concurrent_map<Galileo_Ephemeris> global_galileo_ephemeris_map;
+extern concurrent_map<Galileo_Iono> global_galileo_iono_map;
+extern concurrent_map<Galileo_Utc_Model> global_galileo_utc_model_map;
+extern concurrent_map<Galileo_Almanac> global_galileo_almanac_map;
+
+extern concurrent_map<Gnss_Receiver_Fix> global_receiver_fix_map;
+
+static const char state_magic[8] = {'G', 'N', 'S', 'S', 'S', 'T', 'A', 'T'};
+static const boost::uint64_t state_max_size = 64 * 1024 * 1024;   // larger is not a state file
+
+static const double seconds_per_week = 604800.0;
+static const double gps_epoch_unix_s = 315964800.0;   // 1980-01-06 in seconds since 1970-01-01
+
+
+// Seconds since the GPS epoch. Leap seconds are ignored.
+static double gps_seconds(double utc_s)
+{
+    return utc_s - gps_epoch_unix_s;
+}
+
+
+// Time from the reference time of an ephemeris whose week number is only known modulo week_rollover
+static double ephemeris_age(double now_gps_s, double week_mod, double toe_s, long week_rollover)
+{
+    long now_week = static_cast<long>(std::floor(now_gps_s / seconds_per_week));
+    long difference = ((now_week - static_cast<long>(week_mod)) % week_rollover + week_rollover) % week_rollover;
+    return now_gps_s - (static_cast<double>(now_week - difference) * seconds_per_week + toe_s);
+}
+
+
+template<typename Data>
+static void copy_to_global(const std::map<int, Data>& map, concurrent_map<Data>& global_map)
+{
+    for (typename std::map<int, Data>::const_iterator it = map.begin(); it != map.end(); ++it)
+        {
+            global_map.write(it->first, it->second);
+        }
+}
+
+
+Gnss_Receiver_State::Gnss_Receiver_State()
+{
+    saved_time_s = 0.0;
+}
+
+
+void Gnss_Receiver_State::clear()
+{
+    gps_ephemeris.clear();
+    gps_almanac.clear();
+    gps_iono.clear();
+    gps_utc_model.clear();
+    galileo_ephemeris.clear();
+    galileo_almanac.clear();
+    galileo_iono.clear();
+    galileo_utc_model.clear();
+    fix = Gnss_Receiver_Fix();
+    saved_time_s = 0.0;
+}
+
+
+bool Gnss_Receiver_State::empty() const
+{
+    return gps_ephemeris.empty() and gps_almanac.empty() and galileo_ephemeris.empty()
+            and galileo_almanac.empty() and not fix.valid;
+}
+
+
+void Gnss_Receiver_State::capture(double now_s)
+{
+    gps_ephemeris = global_gps_ephemeris_map.get_map_copy();
+    gps_almanac = global_gps_almanac_map.get_map_copy();
+    gps_iono = global_gps_iono_map.get_map_copy();
+    gps_utc_model = global_gps_utc_model_map.get_map_copy();
+    galileo_ephemeris = global_galileo_ephemeris_map.get_map_copy();
+    galileo_almanac = global_galileo_almanac_map.get_map_copy();
+    galileo_iono = global_galileo_iono_map.get_map_copy();
+    galileo_utc_model = global_galileo_utc_model_map.get_map_copy();
+    if (global_receiver_fix_map.read(0, fix) == false)
+        {
+            fix = Gnss_Receiver_Fix();
+        }
+    saved_time_s = now_s;
+}
+
+
+void Gnss_Receiver_State::restore() const
+{
+    copy_to_global(gps_ephemeris, global_gps_ephemeris_map);
+    copy_to_global(gps_almanac, global_gps_almanac_map);
+    copy_to_global(gps_iono, global_gps_iono_map);
+    copy_to_global(gps_utc_model, global_gps_utc_model_map);
+    copy_to_global(galileo_ephemeris, global_galileo_ephemeris_map);
+    copy_to_global(galileo_almanac, global_galileo_almanac_map);
+    copy_to_global(galileo_iono, global_galileo_iono_map);
+    copy_to_global(galileo_utc_model, global_galileo_utc_model_map);
+    if (fix.valid)
+        {
+            global_receiver_fix_map.write(0, fix);
+        }
+}
+
+
+bool Gnss_Receiver_State::save(const std::string& filename) const
+{
+    std::ostringstream payload_stream;
+    try
+    {
+            boost::archive::binary_oarchive archive(payload_stream);
+            archive << *this;
+    }
+    catch (std::exception& e)
+    {
+            LOG(ERROR) << "Could not serialize the receiver state: " << e.what();
+            return false;
+    }
+    std::string payload = payload_stream.str();
+    boost::crc_32_type crc;
+    crc.process_bytes(payload.data(), payload.size());
+    boost::uint32_t version = GNSS_RECEIVER_STATE_VERSION;
+    boost::uint64_t size = payload.size();
+    boost::uint32_t checksum = crc.checksum();
+
+    std::string tmp_filename = filename + ".tmp";
+    std::ofstream ofs(tmp_filename.c_str(), std::ofstream::binary | std::ofstream::trunc | std::ofstream::out);
+    ofs.write(state_magic, sizeof(state_magic));
+    ofs.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    ofs.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    ofs.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+    ofs.write(payload.data(), payload.size());
+    ofs.close();
+    if (ofs.fail())
+        {
+            LOG(WARNING) << "Could not write the receiver state to " << tmp_filename;
+            return false;
+        }
+    boost::system::error_code ec;
+    boost::filesystem::rename(tmp_filename, filename, ec);
+    if (ec)
+        {
+            LOG(WARNING) << "Could not replace " << filename << ": " << ec.message();
+            return false;
+        }
+    DLOG(INFO) << "Saved the receiver state to " << filename << " (" << size << " bytes)";
+    return true;
+}
+
+
+bool Gnss_Receiver_State::load(const std::string& filename)
+{
+    clear();
+    std::ifstream ifs(filename.c_str(), std::ifstream::binary | std::ifstream::in);
+    if (not ifs.is_open())
+        {
+            LOG(INFO) << "No receiver state in " << filename << ", cold start";
+            return false;
+        }
+    char magic[sizeof(state_magic)];
+    boost::uint32_t version = 0;
+    boost::uint64_t size = 0;
+    boost::uint32_t checksum = 0;
+    ifs.read(magic, sizeof(magic));
+    ifs.read(reinterpret_cast<char*>(&version), sizeof(version));
+    ifs.read(reinterpret_cast<char*>(&size), sizeof(size));
+    ifs.read(reinterpret_cast<char*>(&checksum), sizeof(checksum));
+    if (ifs.fail() or std::memcmp(magic, state_magic, sizeof(state_magic)) != 0)
+        {
+            LOG(WARNING) << filename << " is not a receiver state file, cold start";
+            return false;
+        }
+    if (version != GNSS_RECEIVER_STATE_VERSION)
+        {
+            LOG(WARNING) << "The receiver state in " << filename << " has format " << version
+                         << " instead of " << GNSS_RECEIVER_STATE_VERSION << ", cold start";
+            return false;
+        }
+    if (size > state_max_size)
+        {
+            LOG(WARNING) << "The receiver state in " << filename << " is corrupted, cold start";
+            return false;
+        }
+    std::string payload(static_cast<size_t>(size), '\0');
+    ifs.read(&payload[0], payload.size());
+    boost::crc_32_type crc;
+    crc.process_bytes(payload.data(), payload.size());
+    if (ifs.fail() or crc.checksum() != checksum)
+        {
+            LOG(WARNING) << "The receiver state in " << filename << " is corrupted, cold start";
+            return false;
+        }
+    try
+    {
+            std::istringstream payload_stream(payload);
+            boost::archive::binary_iarchive archive(payload_stream);
+            archive >> *this;
+    }
+    catch (std::exception& e)
+    {
+            LOG(WARNING) << "Could not read the receiver state in " << filename << ": " << e.what() << ", cold start";
+            clear();
+            return false;
+    }
+    LOG(INFO) << "Loaded the receiver state from " << filename << ": " << gps_ephemeris.size() << " GPS and "
+              << galileo_ephemeris.size() << " Galileo ephemeris, " << gps_almanac.size() + galileo_almanac.size()
+              << " almanacs, " << (fix.valid ? "a fix" : "no fix");
+    return true;
+}
+
+
+unsigned int Gnss_Receiver_State::discard_stale(double now_s, double ephemeris_max_age_s, double almanac_max_age_s, double fix_max_age_s)
+{
+    unsigned int removed = 0;
+    double now_gps_s = gps_seconds(now_s);
+    for (std::map<int, Gps_Ephemeris>::iterator it = gps_ephemeris.begin(); it != gps_ephemeris.end(); )
+        {
+            // the broadcast week number rolls over every 1024 weeks
+            if (std::fabs(ephemeris_age(now_gps_s, it->second.i_GPS_week, it->second.d_Toe, 1024)) > ephemeris_max_age_s)
+                {
+                    gps_ephemeris.erase(it++);
+                    removed++;
+                }
+            else
+                {
+                    ++it;
+                }
+        }
+    // Galileo System Time started at GPS week 1024, its week number rolls over every 4096 weeks
+    double now_gst_s = now_gps_s - 1024.0 * seconds_per_week;
+    for (std::map<int, Galileo_Ephemeris>::iterator it = galileo_ephemeris.begin(); it != galileo_ephemeris.end(); )
+        {
+            if (std::fabs(ephemeris_age(now_gst_s, it->second.WN_5, it->second.t0e_1, 4096)) > ephemeris_max_age_s)
+                {
+                    galileo_ephemeris.erase(it++);
+                    removed++;
+                }
+            else
+                {
+                    ++it;
+                }
+        }
+
+    // almanacs, ionospheric and UTC models last for days: their age is the age of the file
+    double saved_age_s = now_s - saved_time_s;
+    if (saved_age_s < 0.0 or saved_age_s > almanac_max_age_s)
+        {
+            removed += gps_almanac.size() + gps_iono.size() + gps_utc_model.size() + galileo_almanac.size()
+                    + galileo_iono.size() + galileo_utc_model.size();
+            gps_almanac.clear();
+            gps_iono.clear();
+            gps_utc_model.clear();
+            galileo_almanac.clear();
+            galileo_iono.clear();
+            galileo_utc_model.clear();
+        }
+
+    double fix_age_s = now_s - fix.utc_time_s;
+    if (fix.valid and (fix_age_s < 0.0 or fix_age_s > fix_max_age_s))
+        {
+            fix = Gnss_Receiver_Fix();
+            removed++;
+        }
+    return removed;
+}
+
+
+std::vector<unsigned int> Gnss_Receiver_State::gps_prns_in_view(double now_s, double elevation_mask_deg) const
+{
+    std::vector<unsigned int> prns;
+    if (not fix.valid) return prns;
+
+    const double deg_to_rad = M_PI / 180.0;
+    double lat = fix.latitude_d * deg_to_rad;
+    double lon = fix.longitude_d * deg_to_rad;
+    double up[3] = {std::cos(lat) * std::cos(lon), std::cos(lat) * std::sin(lon), std::sin(lat)};
+    double tow = std::fmod(gps_seconds(now_s), seconds_per_week);
+
+    std::vector<std::pair<double, unsigned int> > in_view;
+    for (std::map<int, Gps_Ephemeris>::const_iterator it = gps_ephemeris.begin(); it != gps_ephemeris.end(); ++it)
+        {
+            Gps_Ephemeris eph = it->second;
+            eph.satellitePosition(tow);
+            double los[3] = {eph.d_satpos_X - fix.x_m, eph.d_satpos_Y - fix.y_m, eph.d_satpos_Z - fix.z_m};
+            double range = std::sqrt(los[0] * los[0] + los[1] * los[1] + los[2] * los[2]);
+            if (range <= 0.0) continue;
+            double elevation_deg = std::asin((los[0] * up[0] + los[1] * up[1] + los[2] * up[2]) / range) / deg_to_rad;
+            if (elevation_deg >= elevation_mask_deg)
+                {
+                    in_view.push_back(std::make_pair(elevation_deg, static_cast<unsigned int>(it->first)));
+                }
+        }
+    std::sort(in_view.rbegin(), in_view.rend());
+    for (unsigned int i = 0; i < in_view.size(); i++)
+        {
+            prns.push_back(in_view[i].second);
+        }
+    return prns;
+}
@@ -0,0 +1,136 @@
+/*!
+ * \file gnss_receiver_state.h
+ * \brief Navigation data and last fix of the receiver, kept on disk
+ * between runs for a hot start
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_RECEIVER_STATE_H_
+#define GNSS_SDR_GNSS_RECEIVER_STATE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/nvp.hpp>
+#include "gps_ephemeris.h"
+#include "gps_almanac.h"
+#include "gps_iono.h"
+#include "gps_utc_model.h"
+#include "galileo_ephemeris.h"
+#include "galileo_almanac.h"
+#include "galileo_iono.h"
+#include "galileo_utc_model.h"
+#include "gnss_receiver_fix.h"
+
+#define GNSS_RECEIVER_STATE_VERSION 1   // format of the state file, bumped when the records change
+
+
+/*!
+ * \brief This class holds what a receiver needs for a hot start: the
+ * ephemeris, almanac, ionospheric and UTC models of GPS and Galileo, and
+ * the last position fix with the receiver clock.
+ *
+ * The state is taken from the global navigation maps with capture(), and
+ * given back to them with restore(). The file is a boost binary archive
+ * behind a header with a magic string, the format version, the length
+ * and a CRC-32 of the archive, so that a file from another version or a
+ * truncated or corrupted one is rejected as a whole by load(). save()
+ * writes a temporary file and renames it, so that a crash while saving
+ * never leaves a half written state behind.
+ *
+ * Times are UTC seconds since 1970-01-01. Leap seconds are ignored when
+ * they are converted to GPS time: the age checks work at the scale of
+ * hours.
+ */
+class Gnss_Receiver_State
+{
+public:
+    Gnss_Receiver_State();
+
+    //! Copies the global navigation maps and the last fix, taken at UTC time \p now_s
+    void capture(double now_s);
+
+    //! Writes the navigation data and the fix to the global maps
+    void restore() const;
+
+    //! Writes the state to \p filename. False if it could not be written.
+    bool save(const std::string& filename) const;
+
+    //! Reads the state from \p filename. False, and the state left empty, if it is missing or not valid.
+    bool load(const std::string& filename);
+
+    /*!
+     * \brief Removes what is too old at UTC time \p now_s: the ephemeris
+     * farther than \p ephemeris_max_age_s from their reference time, the
+     * almanacs saved more than \p almanac_max_age_s ago and the fix taken
+     * more than \p fix_max_age_s ago. Returns the number of records removed.
+     */
+    unsigned int discard_stale(double now_s, double ephemeris_max_age_s, double almanac_max_age_s, double fix_max_age_s);
+
+    //! PRNs of the GPS satellites above \p elevation_mask_deg at UTC time \p now_s, seen from the fix, highest first
+    std::vector<unsigned int> gps_prns_in_view(double now_s, double elevation_mask_deg) const;
+
+    //! True if there is nothing to restore
+    bool empty() const;
+
+    std::map<int, Gps_Ephemeris> gps_ephemeris;
+    std::map<int, Gps_Almanac> gps_almanac;
+    std::map<int, Gps_Iono> gps_iono;
+    std::map<int, Gps_Utc_Model> gps_utc_model;
+    std::map<int, Galileo_Ephemeris> galileo_ephemeris;
+    std::map<int, Galileo_Almanac> galileo_almanac;
+    std::map<int, Galileo_Iono> galileo_iono;
+    std::map<int, Galileo_Utc_Model> galileo_utc_model;
+    Gnss_Receiver_Fix fix;
+    double saved_time_s;   //!< UTC time of capture() [s since 1970-01-01]
+
+    template<class Archive>
+
+    /*!
+     * \brief Serialize is a boost standard method to be called by the boost serialization. Here is used to save the state on disk file.
+     */
+    void serialize(Archive& archive, const unsigned int version)
+    {
+        using boost::serialization::make_nvp;
+
+        archive & make_nvp("saved_time_s", saved_time_s);
+        archive & make_nvp("fix", fix);
+        archive & make_nvp("gps_ephemeris", gps_ephemeris);
+        archive & make_nvp("gps_almanac", gps_almanac);
+        archive & make_nvp("gps_iono", gps_iono);
+        archive & make_nvp("gps_utc_model", gps_utc_model);
+        archive & make_nvp("galileo_ephemeris", galileo_ephemeris);
+        archive & make_nvp("galileo_almanac", galileo_almanac);
+        archive & make_nvp("galileo_iono", galileo_iono);
+        archive & make_nvp("galileo_utc_model", galileo_utc_model);
+    }
+
+private:
+    void clear();
+};
+
+#endif
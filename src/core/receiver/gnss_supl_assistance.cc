@@ -0,0 +1,428 @@
+/*!
+ * \file gnss_supl_assistance.cc
+ * \brief Fetches the SUPL assistance in the background, with a cache on disk
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_supl_assistance.h"
+#include <atomic>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <string>
+#include <boost/archive/xml_iarchive.hpp>
+#include <boost/archive/xml_oarchive.hpp>
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/serialization/map.hpp>
+#include <glog/logging.h>
+#include "concurrent_map.h"
+#include "configuration_interface.h"
+#include "control_message_factory.h"
+
+using google::LogMessage;
+
+extern concurrent_map<Gps_Ephemeris> global_gps_ephemeris_map;
+extern concurrent_map<Gps_Iono> global_gps_iono_map;
+extern concurrent_map<Gps_Utc_Model> global_gps_utc_model_map;
+extern concurrent_map<Gps_Almanac> global_gps_almanac_map;
+extern concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
+extern concurrent_map<Gps_Ref_Time> global_gps_ref_time_map;
+extern concurrent_map<Gps_Ref_Location> global_gps_ref_location_map;
+
+// SUPL requests, in the order they are sent
+static const int supl_requests[3] = {1, 0, 2};
+
+
+/*
+ * The answers of the SUPL servers, each with the UTC time it was received
+ * at (seconds since 1970-01-01, 0 = never)
+ */
+struct Gnss_Supl_Cache
+{
+    double almanac_time_s;        // request 0
+    double ephemeris_time_s;      // request 1
+    double acquisition_time_s;    // request 2
+    std::map<int, Gps_Ephemeris> ephemeris;
+    std::map<int, Gps_Almanac> almanac;
+    Gps_Iono iono;
+    Gps_Utc_Model utc_model;
+    std::map<int, Gps_Acq_Assist> acq_assist;
+    Gps_Ref_Location ref_location;
+    Gps_Ref_Time ref_time;
+
+    Gnss_Supl_Cache()
+    {
+        almanac_time_s = 0.0;
+        ephemeris_time_s = 0.0;
+        acquisition_time_s = 0.0;
+    }
+
+    double& time_s(int request)
+    {
+        return request == 0 ? almanac_time_s : (request == 1 ? ephemeris_time_s : acquisition_time_s);
+    }
+
+    template<class Archive>
+    void serialize(Archive& archive, const unsigned int version)
+    {
+        using boost::serialization::make_nvp;
+
+        archive & make_nvp("almanac_time_s", almanac_time_s);
+        archive & make_nvp("ephemeris_time_s", ephemeris_time_s);
+        archive & make_nvp("acquisition_time_s", acquisition_time_s);
+        archive & make_nvp("ephemeris", ephemeris);
+        archive & make_nvp("almanac", almanac);
+        archive & make_nvp("iono", iono);
+        archive & make_nvp("utc_model", utc_model);
+        archive & make_nvp("acq_assist", acq_assist);
+        archive & make_nvp("ref_location", ref_location);
+        archive & make_nvp("ref_time", ref_time);
+    }
+};
+
+
+// What the fetch thread uses: it may outlive the Gnss_Supl_Assistance object while a server does not answer
+struct Gnss_Supl_Job
+{
+    Gnss_Supl_Assistance::Fetcher fetch;
+    gnss_sdr_supl_client ephemeris_client;      // requests 0 and 1
+    gnss_sdr_supl_client acquisition_client;    // request 2
+    boost::shared_ptr<gr::msg_queue> queue;
+    std::string cache_file;
+    double max_age_s[3];                        // by request
+    double retry_period_s;
+    Gnss_Supl_Cache cache;
+    bool pending[3];                            // by request
+    bool ephemeris_failed;                      // the first failure of the ephemeris request was announced
+    std::atomic<bool> stop;
+    std::atomic<bool> finished;
+    std::atomic<unsigned int> received;
+};
+
+
+static int supl_get_assistance(gnss_sdr_supl_client& client, int request, int mcc, int mns, int lac, int ci)
+{
+    client.request = request;
+    return client.get_assistance(mcc, mns, lac, ci);
+}
+
+
+static double utc_now_s()
+{
+    return static_cast<double>(std::time(nullptr));
+}
+
+
+static bool load_cache(const std::string& filename, Gnss_Supl_Cache& cache)
+{
+    if (filename.empty() or not boost::filesystem::exists(filename)) return false;
+    try
+    {
+            std::ifstream ifs(filename.c_str(), std::ifstream::binary | std::ifstream::in);
+            boost::archive::xml_iarchive xml(ifs);
+            xml >> boost::serialization::make_nvp("GNSS-SDR_supl_cache", cache);
+    }
+    catch (std::exception& e)
+    {
+            LOG(WARNING) << "SUPL: could not read the cache " << filename << ": " << e.what();
+            cache = Gnss_Supl_Cache();
+            return false;
+    }
+    return true;
+}
+
+
+static void save_cache(const std::string& filename, Gnss_Supl_Cache& cache)
+{
+    if (filename.empty()) return;
+    std::string tmp_filename = filename + ".tmp";
+    try
+    {
+            {
+                    std::ofstream ofs(tmp_filename.c_str(), std::ofstream::trunc | std::ofstream::out);
+                    boost::archive::xml_oarchive xml(ofs);
+                    xml << boost::serialization::make_nvp("GNSS-SDR_supl_cache", cache);
+            }
+            boost::filesystem::rename(tmp_filename, filename);
+    }
+    catch (std::exception& e)
+    {
+            LOG(WARNING) << "SUPL: could not write the cache " << filename << ": " << e.what();
+    }
+}
+
+
+// Keeps the answer of a server in the cache
+static void store_answer(Gnss_Supl_Job& job, int request, gnss_sdr_supl_client& client)
+{
+    if (request == 1)
+        {
+            job.cache.ephemeris = client.gps_ephemeris_map;
+        }
+    else if (request == 0)
+        {
+            job.cache.almanac = client.gps_almanac_map;
+            job.cache.iono = client.gps_iono;
+            job.cache.utc_model = client.gps_utc;
+        }
+    else
+        {
+            job.cache.acq_assist = client.gps_acq_map;
+            job.cache.ref_location = client.gps_ref_loc;
+            job.cache.ref_time = client.gps_time;
+        }
+    job.cache.time_s(request) = utc_now_s();
+}
+
+
+// Sends a control message from the assistance
+static void announce(Gnss_Supl_Job& job, unsigned int what)
+{
+    if (job.queue != gr::msg_queue::sptr())
+        {
+            std::unique_ptr<ControlMessageFactory> cmf(new ControlMessageFactory());
+            job.queue->handle(cmf->GetQueueMessage(GNSS_SUPL_ASSISTANCE_ID, what));
+        }
+}
+
+
+// Writes the cached answer to a request to the global maps, and tells the flowgraph
+static void publish(Gnss_Supl_Job& job, int request)
+{
+    if (request == 1)
+        {
+            for (std::map<int, Gps_Ephemeris>::iterator it = job.cache.ephemeris.begin(); it != job.cache.ephemeris.end(); ++it)
+                {
+                    // the ephemeris decoded meanwhile may be newer
+                    Gps_Ephemeris old;
+                    if (global_gps_ephemeris_map.read(it->first, old) == false or it->second.i_GPS_week > old.i_GPS_week
+                            or (it->second.i_GPS_week == old.i_GPS_week and it->second.d_Toe > old.d_Toe))
+                        {
+                            global_gps_ephemeris_map.write(it->first, it->second);
+                        }
+                }
+            LOG(INFO) << "SUPL: ephemeris of " << job.cache.ephemeris.size() << " GPS satellites";
+        }
+    else if (request == 0)
+        {
+            for (std::map<int, Gps_Almanac>::iterator it = job.cache.almanac.begin(); it != job.cache.almanac.end(); ++it)
+                {
+                    global_gps_almanac_map.write(it->first, it->second);
+                }
+            if (job.cache.iono.valid == true)
+                {
+                    global_gps_iono_map.write(0, job.cache.iono);
+                }
+            if (job.cache.utc_model.valid == true)
+                {
+                    global_gps_utc_model_map.write(0, job.cache.utc_model);
+                }
+            LOG(INFO) << "SUPL: almanac of " << job.cache.almanac.size() << " GPS satellites";
+        }
+    else
+        {
+            for (std::map<int, Gps_Acq_Assist>::iterator it = job.cache.acq_assist.begin(); it != job.cache.acq_assist.end(); ++it)
+                {
+                    global_gps_acq_assist_map.write(it->second.i_satellite_PRN, it->second);
+                }
+            if (job.cache.ref_location.valid == true)
+                {
+                    global_gps_ref_location_map.write(0, job.cache.ref_location);
+                }
+            if (job.cache.ref_time.valid == true)
+                {
+                    global_gps_ref_time_map.write(0, job.cache.ref_time);
+                }
+            LOG(INFO) << "SUPL: acquisition assistance for " << job.cache.acq_assist.size() << " GPS satellites";
+        }
+    announce(job, request);
+}
+
+
+static void supl_fetch_run(std::shared_ptr<Gnss_Supl_Job> job)
+{
+    try
+    {
+            bool pending = true;
+            while (pending and not job->stop.load())
+                {
+                    pending = false;
+                    for (int i = 0; i < 3 and not job->stop.load(); i++)
+                        {
+                            int request = supl_requests[i];
+                            if (not job->pending[request]) continue;
+                            gnss_sdr_supl_client& client = request == 2 ? job->acquisition_client : job->ephemeris_client;
+                            int error = job->fetch(client, request);
+                            if (job->stop.load()) break;   // too late, nobody waits for the answer
+                            if (error == 0)
+                                {
+                                    store_answer(*job, request, client);
+                                    save_cache(job->cache_file, job->cache);
+                                    publish(*job, request);
+                                    job->pending[request] = false;
+                                    job->received.fetch_add(1);
+                                }
+                            else
+                                {
+                                    LOG(WARNING) << "SUPL: request " << request << " to " << client.server_name
+                                                 << " failed with error " << error;
+                                    if (request == 1 and not job->ephemeris_failed)
+                                        {
+                                            announce(*job, GNSS_SUPL_EPHEMERIS_FAILED);
+                                            job->ephemeris_failed = true;
+                                        }
+                                    pending = true;
+                                }
+                        }
+                    if (job->retry_period_s <= 0.0) break;
+                    if (pending)
+                        {
+                            boost::this_thread::sleep(boost::posix_time::microseconds(static_cast<long>(job->retry_period_s * 1e6)));
+                        }
+                }
+    }
+    catch (boost::thread_interrupted&)
+    {
+            DLOG(INFO) << "SUPL: fetch stopped";
+    }
+    job->finished.store(true);
+}
+
+
+Gnss_Supl_Assistance::Gnss_Supl_Assistance(std::shared_ptr<ConfigurationInterface> configuration, boost::shared_ptr<gr::msg_queue> queue)
+{
+    d_job = std::make_shared<Gnss_Supl_Job>();
+    d_job->queue = queue;
+    d_job->ephemeris_client.server_name = configuration->property("GNSS-SDR.SUPL_gps_ephemeris_server", std::string("supl.nokia.com"));
+    d_job->ephemeris_client.server_port = configuration->property("GNSS-SDR.SUPL_gps_ephemeris_port", 7275);
+    d_job->acquisition_client.server_name = configuration->property("GNSS-SDR.SUPL_gps_acquisition_server", std::string("supl.google.com"));
+    d_job->acquisition_client.server_port = configuration->property("GNSS-SDR.SUPL_gps_acquisition_port", 7275);
+    int mcc = configuration->property("GNSS-SDR.SUPL_MCC", 244);
+    int mns = configuration->property("GNSS-SDR.SUPL_MNS", 5);
+    int lac;
+    int ci;
+    try
+    {
+            lac = boost::lexical_cast<int>(configuration->property("GNSS-SDR.SUPL_LAC", std::string("0x59e2")));
+    }
+    catch(boost::bad_lexical_cast &)
+    {
+            lac = 0x59e2;
+    }
+    try
+    {
+            ci = boost::lexical_cast<int>(configuration->property("GNSS-SDR.SUPL_CI", std::string("0x31b0")));
+    }
+    catch(boost::bad_lexical_cast &)
+    {
+            ci = 0x31b0;
+    }
+    d_job->fetch = boost::bind(&supl_get_assistance, _1, _2, mcc, mns, lac, ci);
+    d_job->cache_file = configuration->property("GNSS-SDR.SUPL_cache_file", std::string("./gps_supl_cache.xml"));
+    d_job->max_age_s[0] = configuration->property("GNSS-SDR.SUPL_almanac_max_age_s", 604800.0);
+    d_job->max_age_s[1] = configuration->property("GNSS-SDR.SUPL_ephemeris_max_age_s", 7200.0);
+    d_job->max_age_s[2] = configuration->property("GNSS-SDR.SUPL_acquisition_max_age_s", 600.0);
+    d_job->retry_period_s = configuration->property("GNSS-SDR.SUPL_retry_period_s", 30.0);
+    for (int request = 0; request < 3; request++)
+        {
+            d_job->pending[request] = true;
+        }
+    d_job->ephemeris_failed = false;
+    d_job->stop.store(false);
+    d_job->finished.store(false);
+    d_job->received.store(0);
+}
+
+
+Gnss_Supl_Assistance::~Gnss_Supl_Assistance()
+{
+    stop();
+}
+
+
+void Gnss_Supl_Assistance::set_fetcher(const Fetcher& fetcher)
+{
+    d_job->fetch = fetcher;
+}
+
+
+void Gnss_Supl_Assistance::start()
+{
+    if (d_thread.joinable()) return;
+    if (load_cache(d_job->cache_file, d_job->cache))
+        {
+            double now_s = utc_now_s();
+            for (int request = 0; request < 3; request++)
+                {
+                    double age_s = now_s - d_job->cache.time_s(request);
+                    if (d_job->cache.time_s(request) > 0.0 and age_s >= 0.0 and age_s <= d_job->max_age_s[request])
+                        {
+                            LOG(INFO) << "SUPL: answer to request " << request << " taken from the cache (" << age_s << " s old)";
+                            publish(*d_job, request);
+                            d_job->pending[request] = false;
+                        }
+                }
+        }
+    if (not d_job->pending[0] and not d_job->pending[1] and not d_job->pending[2])
+        {
+            d_job->finished.store(true);
+            return;
+        }
+    d_thread = boost::thread(&supl_fetch_run, d_job);
+}
+
+
+void Gnss_Supl_Assistance::stop()
+{
+    if (not d_thread.joinable()) return;
+    d_job->stop.store(true);
+    d_thread.interrupt();
+#ifdef OLD_BOOST
+    bool joined = d_thread.timed_join(boost::posix_time::seconds(1));
+#endif
+#ifndef OLD_BOOST
+    bool joined = d_thread.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::seconds(1));
+#endif
+    if (not joined)
+        {
+            LOG(INFO) << "SUPL: a request is still waiting for its server, its answer will be ignored";
+            d_thread.detach();
+        }
+}
+
+
+bool Gnss_Supl_Assistance::finished() const
+{
+    return d_job->finished.load();
+}
+
+
+unsigned int Gnss_Supl_Assistance::received() const
+{
+    return d_job->received.load();
+}
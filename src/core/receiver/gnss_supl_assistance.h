@@ -0,0 +1,98 @@
+/*!
+ * \file gnss_supl_assistance.h
+ * \brief Fetches the SUPL assistance in the background, with a cache on disk
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SUPL_ASSISTANCE_H_
+#define GNSS_SDR_GNSS_SUPL_ASSISTANCE_H_
+
+#include <memory>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+#include <gnuradio/msg_queue.h>
+#include "gnss_sdr_supl_client.h"
+
+#define GNSS_SUPL_ASSISTANCE_ID 500   // who of the control messages announcing new assistance (what = SUPL request)
+#define GNSS_SUPL_EPHEMERIS_FAILED 3  // what of the control message announcing that the ephemeris request failed
+
+class ConfigurationInterface;
+struct Gnss_Supl_Job;
+
+
+/*!
+ * \brief This class gets the SUPL (RRLP) assistance without holding back
+ * the start of the receiver.
+ *
+ * start() returns at once. It first publishes what the cache file still
+ * holds fresh, then a thread asks the SUPL servers for the rest: the
+ * ephemeris (request 1), the almanac, ionospheric and UTC models
+ * (request 0) and the acquisition assistance, reference location and
+ * time (request 2). Each answer is written to the global maps as soon as
+ * it arrives, saved in the cache with its time, and announced with a
+ * control message (who = GNSS_SUPL_ASSISTANCE_ID, what = request), so
+ * that the flowgraph searches first the satellites it puts in view. The
+ * requests that fail are retried every retry period. The first failure of
+ * the ephemeris request is announced too (what = GNSS_SUPL_EPHEMERIS_FAILED),
+ * so that the receiver can read the ephemeris of its XML file meanwhile.
+ *
+ * Configuration (GNSS-SDR. prefix): SUPL_gps_ephemeris_server/port,
+ * SUPL_gps_acquisition_server/port, SUPL_MCC, SUPL_MNS, SUPL_LAC, SUPL_CI,
+ * SUPL_cache_file, SUPL_ephemeris_max_age_s, SUPL_almanac_max_age_s,
+ * SUPL_acquisition_max_age_s and SUPL_retry_period_s.
+ */
+class Gnss_Supl_Assistance
+{
+public:
+    //! Sends one SUPL request with a client, returns 0 on success (see gnss_sdr_supl_client::get_assistance)
+    typedef boost::function<int(gnss_sdr_supl_client& client, int request)> Fetcher;
+
+    Gnss_Supl_Assistance(std::shared_ptr<ConfigurationInterface> configuration, boost::shared_ptr<gr::msg_queue> queue);
+
+    //! Stops the fetch
+    ~Gnss_Supl_Assistance();
+
+    //! Replaces the requests to the SUPL servers. Before start() only.
+    void set_fetcher(const Fetcher& fetcher);
+
+    //! Publishes the fresh part of the cache, and fetches the rest in the background
+    void start();
+
+    /*!
+     * \brief Stops the fetch. A request waiting for a server is left
+     * behind: its answer is thrown away.
+     */
+    void stop();
+
+    bool finished() const;            //!< True when there is nothing left to fetch, or the fetch gave up
+    unsigned int received() const;    //!< Requests answered by the servers so far
+
+private:
+    std::shared_ptr<Gnss_Supl_Job> d_job;
+    boost::thread d_thread;
+};
+
+#endif
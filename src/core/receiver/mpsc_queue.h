@@ -0,0 +1,107 @@
+/*!
+ * \file mpsc_queue.h
+ * \brief Interface of a lock-free multiple producer, single consumer queue
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MPSC_QUEUE_H
+#define GNSS_SDR_MPSC_QUEUE_H
+
+#include <atomic>
+
+template<typename Data>
+
+/*!
+ * \brief This class implements a lock-free queue for many producer threads
+ * and a single consumer thread
+ *
+ * Linked list of nodes with a stub, after Dmitry Vyukov's non-intrusive
+ * MPSC queue: a push is an atomic exchange of the head, so producers never
+ * wait for each other nor for the consumer. Items come out in the order
+ * they were pushed by each producer.
+ */
+class mpsc_queue
+{
+private:
+    struct node
+    {
+        std::atomic<node*> next;
+        Data data;
+        node() : next(nullptr), data() {}
+        explicit node(Data const& d) : next(nullptr), data(d) {}
+    };
+    std::atomic<node*> the_head;   // last pushed, written by the producers
+    node* the_tail;                // already popped, owned by the consumer
+    mpsc_queue(mpsc_queue const&);
+    mpsc_queue& operator=(mpsc_queue const&);
+
+public:
+    mpsc_queue()
+    {
+        the_tail = new node();
+        the_head.store(the_tail);
+    }
+
+    ~mpsc_queue()
+    {
+        Data data;
+        while (try_pop(data)) {}
+        delete the_tail;
+    }
+
+    //! Any thread
+    void push(Data const& data)
+    {
+        node* n = new node(data);
+        node* previous = the_head.exchange(n);
+        previous->next.store(n, std::memory_order_release);
+    }
+
+    //! Consumer thread only. False if there was nothing to pop.
+    bool try_pop(Data& popped_value)
+    {
+        node* next = the_tail->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+            {
+                return false;
+            }
+        popped_value = next->data;
+        next->data = Data();
+        delete the_tail;
+        the_tail = next;
+        return true;
+    }
+
+    /*!
+     * \brief Consumer thread only. An item being pushed while this is
+     * called may not be seen yet.
+     */
+    bool empty() const
+    {
+        return the_tail->next.load() == nullptr;
+    }
+};
+#endif
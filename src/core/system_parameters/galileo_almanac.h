@@ -31,6 +31,7 @@
 #ifndef GNSS_SDR_GALILEO_ALMANAC_H_
 #define GNSS_SDR_GALILEO_ALMANAC_H_
 
+#include <boost/serialization/nvp.hpp>
 
 /*!
  * \brief This class is a storage for the GALILEO ALMANAC data as described in GALILEO ICD
@@ -102,6 +103,68 @@ public:
     double WN_0G_10 = 0;
 
     Galileo_Almanac();  //!< Default constructor
+
+    template<class Archive>
+
+    /*!
+     * \brief Serialize is a boost standard method to be called by the boost serialization. Here is used to save the almanac data on disk file.
+     */
+    void serialize(Archive& archive, const unsigned int version)
+    {
+        using boost::serialization::make_nvp;
+
+        archive & make_nvp("IOD_a_7", IOD_a_7);
+        archive & make_nvp("WN_a_7", WN_a_7);
+        archive & make_nvp("t0a_7", t0a_7);
+        archive & make_nvp("SVID1_7", SVID1_7);
+        archive & make_nvp("DELTA_A_7", DELTA_A_7);
+        archive & make_nvp("e_7", e_7);
+        archive & make_nvp("omega_7", omega_7);
+        archive & make_nvp("delta_i_7", delta_i_7);
+        archive & make_nvp("Omega0_7", Omega0_7);
+        archive & make_nvp("Omega_dot_7", Omega_dot_7);
+        archive & make_nvp("M0_7", M0_7);
+        archive & make_nvp("IOD_a_8", IOD_a_8);
+        archive & make_nvp("af0_8", af0_8);
+        archive & make_nvp("af1_8", af1_8);
+        archive & make_nvp("E5b_HS_8", E5b_HS_8);
+        archive & make_nvp("E1B_HS_8", E1B_HS_8);
+        archive & make_nvp("E5a_HS_8", E5a_HS_8);
+        archive & make_nvp("SVID2_8", SVID2_8);
+        archive & make_nvp("DELTA_A_8", DELTA_A_8);
+        archive & make_nvp("e_8", e_8);
+        archive & make_nvp("omega_8", omega_8);
+        archive & make_nvp("delta_i_8", delta_i_8);
+        archive & make_nvp("Omega0_8", Omega0_8);
+        archive & make_nvp("Omega_dot_8", Omega_dot_8);
+        archive & make_nvp("IOD_a_9", IOD_a_9);
+        archive & make_nvp("WN_a_9", WN_a_9);
+        archive & make_nvp("t0a_9", t0a_9);
+        archive & make_nvp("M0_9", M0_9);
+        archive & make_nvp("af0_9", af0_9);
+        archive & make_nvp("af1_9", af1_9);
+        archive & make_nvp("E5b_HS_9", E5b_HS_9);
+        archive & make_nvp("E1B_HS_9", E1B_HS_9);
+        archive & make_nvp("E5a_HS_9", E5a_HS_9);
+        archive & make_nvp("SVID3_9", SVID3_9);
+        archive & make_nvp("DELTA_A_9", DELTA_A_9);
+        archive & make_nvp("e_9", e_9);
+        archive & make_nvp("omega_9", omega_9);
+        archive & make_nvp("delta_i_9", delta_i_9);
+        archive & make_nvp("IOD_a_10", IOD_a_10);
+        archive & make_nvp("Omega0_10", Omega0_10);
+        archive & make_nvp("Omega_dot_10", Omega_dot_10);
+        archive & make_nvp("M0_10", M0_10);
+        archive & make_nvp("af0_10", af0_10);
+        archive & make_nvp("af1_10", af1_10);
+        archive & make_nvp("E5b_HS_10", E5b_HS_10);
+        archive & make_nvp("E1B_HS_10", E1B_HS_10);
+        archive & make_nvp("E5a_HS_10", E5a_HS_10);
+        archive & make_nvp("A_0G_10", A_0G_10);
+        archive & make_nvp("A_1G_10", A_1G_10);
+        archive & make_nvp("t_0G_10", t_0G_10);
+        archive & make_nvp("WN_0G_10", WN_0G_10);
+    }
 };
 
 #endif
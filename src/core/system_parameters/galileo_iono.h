@@ -32,6 +32,7 @@
 #ifndef GNSS_SDR_GALILEO_IONO_H_
 #define GNSS_SDR_GALILEO_IONO_H_
 
+#include <boost/serialization/nvp.hpp>
 
 /*!
  * \brief This class is a storage for the GALILEO IONOSPHERIC data as described in Galileo ICD paragraph 5.1.6
@@ -61,6 +62,27 @@ public:
      * Default constructor
      */
     Galileo_Iono();
+
+    template<class Archive>
+
+    /*!
+     * \brief Serialize is a boost standard method to be called by the boost serialization. Here is used to save the ionospheric data on disk file.
+     */
+    void serialize(Archive& archive, const unsigned int version)
+    {
+        using boost::serialization::make_nvp;
+
+        archive & make_nvp("ai0_5", ai0_5);
+        archive & make_nvp("ai1_5", ai1_5);
+        archive & make_nvp("ai2_5", ai2_5);
+        archive & make_nvp("Region1_flag_5", Region1_flag_5);
+        archive & make_nvp("Region2_flag_5", Region2_flag_5);
+        archive & make_nvp("Region3_flag_5", Region3_flag_5);
+        archive & make_nvp("Region4_flag_5", Region4_flag_5);
+        archive & make_nvp("Region5_flag_5", Region5_flag_5);
+        archive & make_nvp("TOW_5", TOW_5);
+        archive & make_nvp("WN_5", WN_5);
+    }
 };
 
 #endif
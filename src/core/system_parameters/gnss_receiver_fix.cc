@@ -0,0 +1,62 @@
+/*!
+ * \file gnss_receiver_fix.cc
+ * \brief Implementation of a storage for the last position and clock of the receiver
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_receiver_fix.h"
+#include <cmath>
+
+Gnss_Receiver_Fix::Gnss_Receiver_Fix()
+{
+    valid = false;
+    utc_time_s = 0.0;
+    latitude_d = 0.0;
+    longitude_d = 0.0;
+    height_m = 0.0;
+    x_m = 0.0;
+    y_m = 0.0;
+    z_m = 0.0;
+    clock_bias_m = 0.0;
+    clock_drift_m_s = 0.0;
+}
+
+
+void Gnss_Receiver_Fix::set_position(double latitude_deg, double longitude_deg, double height)
+{
+    const double a = 6378137.0;              // WGS-84 semi-major axis [m]
+    const double e2 = 6.69437999014e-3;      // WGS-84 first eccentricity squared
+    double lat = latitude_deg * M_PI / 180.0;
+    double lon = longitude_deg * M_PI / 180.0;
+    double n = a / std::sqrt(1.0 - e2 * std::sin(lat) * std::sin(lat));
+    x_m = (n + height) * std::cos(lat) * std::cos(lon);
+    y_m = (n + height) * std::cos(lat) * std::sin(lon);
+    z_m = (n * (1.0 - e2) + height) * std::sin(lat);
+    latitude_d = latitude_deg;
+    longitude_d = longitude_deg;
+    height_m = height;
+    valid = true;
+}
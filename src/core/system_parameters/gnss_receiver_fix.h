@@ -0,0 +1,88 @@
+/*!
+ * \file gnss_receiver_fix.h
+ * \brief Interface of a storage for the last position and clock of the receiver
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#ifndef GNSS_SDR_GNSS_RECEIVER_FIX_H_
+#define GNSS_SDR_GNSS_RECEIVER_FIX_H_
+
+#include <boost/serialization/nvp.hpp>
+
+
+/*!
+ * \brief This class is a storage for the last position fix of the receiver
+ * and the state of its clock, written by the PVT blocks and kept across
+ * restarts in the receiver state file
+ */
+class Gnss_Receiver_Fix
+{
+public:
+    bool valid;
+    double utc_time_s;       //!< UTC time of the fix [s since 1970-01-01]
+    double latitude_d;       //!< Latitude [deg]
+    double longitude_d;      //!< Longitude [deg]
+    double height_m;         //!< Height [m]
+    double x_m;              //!< ECEF coordinates [m]
+    double y_m;
+    double z_m;
+    double clock_bias_m;     //!< Receiver clock bias times the speed of light [m]
+    double clock_drift_m_s;  //!< Receiver clock drift times the speed of light [m/s]
+    /*!
+     * Default constructor
+     */
+    Gnss_Receiver_Fix();
+
+    /*!
+     * \brief Sets a valid position from its geodetic coordinates (WGS-84),
+     * e.g. an approximate one, without the clock
+     */
+    void set_position(double latitude_deg, double longitude_deg, double height);
+
+    template<class Archive>
+
+    /*!
+     * \brief Serialize is a boost standard method to be called by the boost serialization. Here is used to save the fix on disk file.
+     */
+    void serialize(Archive& archive, const unsigned int version)
+        {
+            using boost::serialization::make_nvp;
+
+            archive & make_nvp("valid", valid);
+            archive & make_nvp("utc_time_s", utc_time_s);
+            archive & make_nvp("latitude_d", latitude_d);
+            archive & make_nvp("longitude_d", longitude_d);
+            archive & make_nvp("height_m", height_m);
+            archive & make_nvp("x_m", x_m);
+            archive & make_nvp("y_m", y_m);
+            archive & make_nvp("z_m", z_m);
+            archive & make_nvp("clock_bias_m", clock_bias_m);
+            archive & make_nvp("clock_drift_m_s", clock_drift_m_s);
+        }
+};
+
+#endif
@@ -59,6 +59,8 @@ public:
     double Code_phase_secs;         //!< Set by Tracking processing block
     double Tracking_timestamp_secs; //!< Set by Tracking processing block
     bool Flag_valid_tracking;
+    long long Sample_arrival_ns;    //!< Set by Tracking processing block: steady clock time its last sample reached the channels [ns] (0: unknown)
+    long long Tracking_output_ns;   //!< Set by Tracking processing block: steady clock time it was output [ns]
 
     //Telemetry Decoder
     double Prn_timestamp_ms;             //!< Set by Telemetry Decoder processing block
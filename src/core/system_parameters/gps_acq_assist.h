@@ -33,6 +33,7 @@
 #define GNSS_SDR_GPS_ACQ_ASSIST_H_
 
 #include "GPS_L1_CA.h"
+#include <boost/serialization/nvp.hpp>
 
 
 /*!
@@ -62,6 +63,28 @@ public:
      * Default constructor
      */
     Gps_Acq_Assist();
+
+    template<class Archive>
+
+    /*!
+     * \brief Serialize is a boost standard method to be called by the boost XML serialization. Here is used to save the acquisition assistance on disk file.
+     */
+    void serialize(Archive& archive, const unsigned int version)
+        {
+            using boost::serialization::make_nvp;
+
+            archive & make_nvp("i_satellite_PRN", i_satellite_PRN);
+            archive & make_nvp("d_TOW", d_TOW);
+            archive & make_nvp("d_Doppler0", d_Doppler0);
+            archive & make_nvp("d_Doppler1", d_Doppler1);
+            archive & make_nvp("dopplerUncertainty", dopplerUncertainty);
+            archive & make_nvp("Code_Phase", Code_Phase);
+            archive & make_nvp("Code_Phase_int", Code_Phase_int);
+            archive & make_nvp("GPS_Bit_Number", GPS_Bit_Number);
+            archive & make_nvp("Code_Phase_window", Code_Phase_window);
+            archive & make_nvp("Azimuth", Azimuth);
+            archive & make_nvp("Elevation", Elevation);
+        }
 };
 
 #endif
@@ -33,6 +33,7 @@
 #define GNSS_SDR_GPS_ALMANAC_H_
 
 #include "GPS_L1_CA.h"
+#include <boost/serialization/nvp.hpp>
 
 
 /*!
@@ -60,6 +61,29 @@ public:
      * Default constructor
      */
     Gps_Almanac();
+
+    template<class Archive>
+
+    /*!
+     * \brief Serialize is a boost standard method to be called by the boost serialization. Here is used to save the almanac data on disk file.
+     */
+    void serialize(Archive& archive, const unsigned int version)
+    {
+        using boost::serialization::make_nvp;
+
+        archive & make_nvp("i_satellite_PRN", i_satellite_PRN);
+        archive & make_nvp("d_Delta_i", d_Delta_i);
+        archive & make_nvp("d_Toa", d_Toa);
+        archive & make_nvp("d_M_0", d_M_0);
+        archive & make_nvp("d_e_eccentricity", d_e_eccentricity);
+        archive & make_nvp("d_sqrt_A", d_sqrt_A);
+        archive & make_nvp("d_OMEGA0", d_OMEGA0);
+        archive & make_nvp("d_OMEGA", d_OMEGA);
+        archive & make_nvp("d_OMEGA_DOT", d_OMEGA_DOT);
+        archive & make_nvp("i_SV_health", i_SV_health);
+        archive & make_nvp("d_A_f0", d_A_f0);
+        archive & make_nvp("d_A_f1", d_A_f1);
+    }
 };
 
 #endif
@@ -35,6 +35,7 @@
 #include "GPS_L1_CA.h"
 #include "boost/assign.hpp"
 #include <boost/serialization/nvp.hpp>
+#include <boost/serialization/version.hpp>
 
 
 /*!
@@ -75,7 +76,17 @@ public:
         archive & make_nvp("d_beta1",d_beta1);
         archive & make_nvp("d_beta2",d_beta2);
         archive & make_nvp("d_beta3",d_beta3);
+        if (version >= 1)
+            {
+                archive & make_nvp("valid",valid);
+            }
+        else if (Archive::is_loading::value)
+            {
+                valid = true;   // files without the flag were only written with received models
+            }
     }
 };
 
+BOOST_CLASS_VERSION(Gps_Iono, 1)   // 1: valid flag
+
 #endif
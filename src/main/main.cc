@@ -60,6 +60,7 @@
 #include "sbas_satellite_correction.h"
 #include "sbas_ephemeris.h"
 #include "sbas_time.h"
+#include "gnss_receiver_fix.h"
 
 
 using google::LogMessage;
@@ -113,6 +114,9 @@ concurrent_map<Sbas_Ionosphere_Correction> global_sbas_iono_map;
 concurrent_map<Sbas_Satellite_Correction> global_sbas_sat_corr_map;
 concurrent_map<Sbas_Ephemeris> global_sbas_ephemeris_map;
 
+// Last position fix, kept in the receiver state
+concurrent_map<Gnss_Receiver_Fix> global_receiver_fix_map;
+
 int main(int argc, char** argv)
 {
     const std::string intro_help(
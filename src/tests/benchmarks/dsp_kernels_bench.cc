@@ -0,0 +1,255 @@
+/*!
+ * \file dsp_kernels_bench.cc
+ * \brief Microbenchmarks of the acquisition and tracking DSP kernels,
+ * at sampling rates from 2 to 50 Msps.
+ *
+ * Each iteration processes 1 ms of signal. Besides the time per iteration,
+ * the "realtime" counter gives how many seconds of signal one channel
+ * processes per second.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <complex>
+#include <cstring>
+#include <benchmark/benchmark.h>
+#include <gnuradio/fft/fft.h>
+#include <gnuradio/gr_complex.h>
+#include <volk/volk.h>
+#include "correlator.h"
+#include "gnss_signal_processing.h"
+#include "gps_sdr_signal_processing.h"
+#include "nco_lib.h"
+#include "GPS_L1_CA.h"
+
+
+// 1 ms of GPS L1 C/A signal at each rate
+#define DSP_BENCH_SAMPLING_RATES Arg(2000000)->Arg(4000000)->Arg(8000000)->Arg(16000000)->Arg(25000000)->Arg(50000000)
+
+
+/*!
+ * \brief Buffers of one channel, aligned for volk
+ */
+class Dsp_Bench_Buffers
+{
+public:
+    Dsp_Bench_Buffers(int fs_in)
+    {
+        fs = fs_in;
+        samples = fs_in / 1000;
+        // room for the early-late spacing of the code resampler
+        int length = 2 * samples;
+        input = static_cast<gr_complex*>(volk_malloc(length * sizeof(gr_complex), volk_get_alignment()));
+        carrier = static_cast<gr_complex*>(volk_malloc(length * sizeof(gr_complex), volk_get_alignment()));
+        for (int i = 0; i < 5; i++)
+            {
+                code[i] = static_cast<gr_complex*>(volk_malloc(length * sizeof(gr_complex), volk_get_alignment()));
+            }
+        outputs = static_cast<gr_complex*>(volk_malloc(5 * sizeof(gr_complex), volk_get_alignment()));
+        ca_code = new gr_complex[static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS) + 2];
+
+        // a satellite at 1.5 kHz, plus the tracking replicas
+        gps_l1_ca_code_gen_complex(&ca_code[1], 1, 0);
+        ca_code[0] = ca_code[static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS)];
+        ca_code[static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS) + 1] = ca_code[1];
+        gps_l1_ca_code_gen_complex_sampled(code[0], 1, fs_in, 0);
+        complex_exp_gen(carrier, 1500.0, fs_in, samples);
+        volk_32fc_x2_multiply_32fc(input, code[0], carrier, samples);
+        complex_exp_gen_conj(carrier, 1500.0, fs_in, samples);
+        for (int i = 1; i < 5; i++)
+            {
+                memcpy(code[i], code[0], samples * sizeof(gr_complex));
+            }
+    }
+
+    ~Dsp_Bench_Buffers()
+    {
+        volk_free(input);
+        volk_free(carrier);
+        for (int i = 0; i < 5; i++)
+            {
+                volk_free(code[i]);
+            }
+        volk_free(outputs);
+        delete[] ca_code;
+    }
+
+    int fs;
+    int samples;
+    gr_complex* input;
+    gr_complex* carrier;
+    gr_complex* code[5];    // VE, E, P, L, VL
+    gr_complex* outputs;
+    gr_complex* ca_code;    // 1023 chips, with one chip of margin at each end
+};
+
+
+void dsp_bench_counters(benchmark::State& state, int samples)
+{
+    state.SetItemsProcessed(state.iterations() * samples);
+    state.counters["realtime"] = benchmark::Counter(0.001 * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+
+/*
+ * One Doppler bin of the PCPS acquisition (pcps_acquisition_cc::general_work):
+ * carrier wipe-off, FFT, product with the conjugated code FFT, IFFT and search of the peak
+ */
+static void BM_PcpsAcquisitionDopplerBin(benchmark::State& state)
+{
+    Dsp_Bench_Buffers b(state.range(0));
+    gr::fft::fft_complex fft_if(b.samples, true);
+    gr::fft::fft_complex ifft(b.samples, false);
+    gr_complex* fft_codes = static_cast<gr_complex*>(volk_malloc(b.samples * sizeof(gr_complex), volk_get_alignment()));
+    float* magnitude = static_cast<float*>(volk_malloc(b.samples * sizeof(float), volk_get_alignment()));
+    memcpy(fft_if.get_inbuf(), b.code[0], b.samples * sizeof(gr_complex));
+    fft_if.execute();
+    volk_32fc_conjugate_32fc(fft_codes, fft_if.get_outbuf(), b.samples);
+    unsigned int indext = 0;
+
+    for (auto _ : state)
+        {
+            volk_32fc_x2_multiply_32fc(fft_if.get_inbuf(), b.input, b.carrier, b.samples);
+            fft_if.execute();
+            volk_32fc_x2_multiply_32fc(ifft.get_inbuf(), fft_if.get_outbuf(), fft_codes, b.samples);
+            ifft.execute();
+            volk_32fc_magnitude_squared_32f(magnitude, ifft.get_outbuf(), b.samples);
+            volk_32f_index_max_16u(&indext, magnitude, b.samples);
+            benchmark::DoNotOptimize(indext);
+        }
+    dsp_bench_counters(state, b.samples);
+    volk_free(fft_codes);
+    volk_free(magnitude);
+}
+BENCHMARK(BM_PcpsAcquisitionDopplerBin)->DSP_BENCH_SAMPLING_RATES;
+
+
+static void BM_CorrelatorEplVolk(benchmark::State& state)
+{
+    Dsp_Bench_Buffers b(state.range(0));
+    Correlator correlator;
+    for (auto _ : state)
+        {
+            correlator.Carrier_wipeoff_and_EPL_volk(b.samples, b.input, b.carrier, b.code[1], b.code[2], b.code[3],
+                    &b.outputs[1], &b.outputs[2], &b.outputs[3]);
+            benchmark::DoNotOptimize(b.outputs[2]);
+        }
+    dsp_bench_counters(state, b.samples);
+}
+BENCHMARK(BM_CorrelatorEplVolk)->DSP_BENCH_SAMPLING_RATES;
+
+
+static void BM_CorrelatorEplGeneric(benchmark::State& state)
+{
+    Dsp_Bench_Buffers b(state.range(0));
+    Correlator correlator;
+    for (auto _ : state)
+        {
+            correlator.Carrier_wipeoff_and_EPL_generic(b.samples, b.input, b.carrier, b.code[1], b.code[2], b.code[3],
+                    &b.outputs[1], &b.outputs[2], &b.outputs[3]);
+            benchmark::DoNotOptimize(b.outputs[2]);
+        }
+    dsp_bench_counters(state, b.samples);
+}
+BENCHMARK(BM_CorrelatorEplGeneric)->DSP_BENCH_SAMPLING_RATES;
+
+
+static void BM_CorrelatorVeplVolk(benchmark::State& state)
+{
+    Dsp_Bench_Buffers b(state.range(0));
+    Correlator correlator;
+    for (auto _ : state)
+        {
+            correlator.Carrier_wipeoff_and_VEPL_volk(b.samples, b.input, b.carrier, b.code[0], b.code[1], b.code[2], b.code[3], b.code[4],
+                    &b.outputs[0], &b.outputs[1], &b.outputs[2], &b.outputs[3], &b.outputs[4]);
+            benchmark::DoNotOptimize(b.outputs[2]);
+        }
+    dsp_bench_counters(state, b.samples);
+}
+BENCHMARK(BM_CorrelatorVeplVolk)->DSP_BENCH_SAMPLING_RATES;
+
+
+// Gps_L1_Ca_Dll_Pll_Tracking_cc::update_local_code, 0.5 chips of early-late spacing
+static void BM_TrackingUpdateLocalCode(benchmark::State& state)
+{
+    Dsp_Bench_Buffers b(state.range(0));
+    double code_freq_chips = GPS_L1_CA_CODE_RATE_HZ + 0.35;
+    double rem_code_phase_samples = 0.25;
+    for (auto _ : state)
+        {
+            gps_l1_ca_epl_code_resampler(b.code[1], b.code[2], b.code[3], b.ca_code,
+                    code_freq_chips, static_cast<double>(b.fs), rem_code_phase_samples, 0.5, b.samples);
+            benchmark::DoNotOptimize(b.code[2][0]);
+        }
+    dsp_bench_counters(state, b.samples);
+}
+BENCHMARK(BM_TrackingUpdateLocalCode)->DSP_BENCH_SAMPLING_RATES;
+
+
+/*
+ * Gps_L1_Ca_Dll_Pll_Tracking_cc::update_local_carrier (same loop as std_nco),
+ * and the CORDIC alternatives of nco_lib
+ */
+static void BM_TrackingUpdateLocalCarrier(benchmark::State& state)
+{
+    Dsp_Bench_Buffers b(state.range(0));
+    float phase_step_rad = static_cast<float>(GPS_TWO_PI) * 1500.0 / static_cast<float>(b.fs);
+    for (auto _ : state)
+        {
+            std_nco(b.carrier, b.samples, 0.1, phase_step_rad);
+            benchmark::DoNotOptimize(b.carrier[0]);
+        }
+    dsp_bench_counters(state, b.samples);
+}
+BENCHMARK(BM_TrackingUpdateLocalCarrier)->DSP_BENCH_SAMPLING_RATES;
+
+
+static void BM_FxpNco(benchmark::State& state)
+{
+    Dsp_Bench_Buffers b(state.range(0));
+    float phase_step_rad = static_cast<float>(GPS_TWO_PI) * 1500.0 / static_cast<float>(b.fs);
+    for (auto _ : state)
+        {
+            fxp_nco(b.carrier, b.samples, 0.1, phase_step_rad);
+            benchmark::DoNotOptimize(b.carrier[0]);
+        }
+    dsp_bench_counters(state, b.samples);
+}
+BENCHMARK(BM_FxpNco)->DSP_BENCH_SAMPLING_RATES;
+
+
+static void BM_SseNco(benchmark::State& state)
+{
+    Dsp_Bench_Buffers b(state.range(0));
+    float phase_step_rad = static_cast<float>(GPS_TWO_PI) * 1500.0 / static_cast<float>(b.fs);
+    for (auto _ : state)
+        {
+            sse_nco(b.carrier, b.samples, 0.1, phase_step_rad);
+            benchmark::DoNotOptimize(b.carrier[0]);
+        }
+    dsp_bench_counters(state, b.samples);
+}
+BENCHMARK(BM_SseNco)->DSP_BENCH_SAMPLING_RATES;
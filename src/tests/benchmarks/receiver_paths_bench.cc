@@ -0,0 +1,318 @@
+/*!
+ * \file receiver_paths_bench.cc
+ * \brief Microbenchmarks of the receiver hot paths after tracking: channel
+ * decoding, navigation message decoding, observables, PVT and RINEX output.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <gflags/gflags.h>
+#include "viterbi_decoder.h"
+#include "gps_navigation_message.h"
+#include "gps_ephemeris.h"
+#include "gnss_synchro.h"
+#include "gps_l1_ca_observables_cc.h"
+#include "ls_pvt_solver.h"
+#include "orbit_cache.h"
+#include "pvt_solution.h"
+#include "rinex_printer.h"
+
+DECLARE_string(RINEX_version);
+
+
+Gps_Ephemeris bench_gps_ephemeris(int prn)
+{
+    Gps_Ephemeris eph;
+    eph.i_satellite_PRN = prn;
+    eph.i_GPS_week = 1820;
+    eph.d_TOW = 345600.0 + 6.0 * prn;
+    eph.d_A_f0 = -1.2345678901234e-4 * prn;
+    eph.d_A_f1 = 3.41060513164848e-12;
+    eph.d_A_f2 = 0.0;
+    eph.d_Crs = -87.40625 + prn;
+    eph.d_Delta_n = 4.50304614942e-09;
+    eph.d_M_0 = 1.23456789 - 0.1 * prn;
+    eph.d_Cuc = -4.5299530029296875e-06;
+    eph.d_e_eccentricity = 0.0123456789 / prn;
+    eph.d_Cus = 7.0538371801376e-06;
+    eph.d_sqrt_A = 5153.65531731;
+    eph.d_Toe = 345600.0;
+    eph.d_Toc = 345600.0;
+    eph.d_Cic = 1.4901161193848e-08;
+    eph.d_OMEGA0 = -2.9861245332 + 0.01 * prn;
+    eph.d_Cis = -9.8720192909241e-08;
+    eph.d_i_0 = 0.96184582654;
+    eph.d_Crc = 254.96875;
+    eph.d_OMEGA = -1.5708 * prn / 32.0;
+    eph.d_OMEGA_DOT = -8.1073948815e-09;
+    eph.d_IDOT = 3.2143196030e-10;
+    eph.i_code_on_L2 = 1;
+    eph.i_SV_accuracy = 2;
+    eph.i_SV_health = 0;
+    eph.d_TGD = -1.1175870895386e-08;
+    eph.d_IODC = 50.0;
+    return eph;
+}
+
+
+// Synchro of the channels after the telemetry decoder, 2 ms apart in reception time
+std::map<int, Gnss_Synchro> bench_valid_synchro(int channels)
+{
+    std::map<int, Gnss_Synchro> valid_synchro;
+    for (int i = 0; i < channels; i++)
+        {
+            Gnss_Synchro gs;
+            gs.System = 'G';
+            gs.Channel_ID = i;
+            gs.PRN = i + 1;
+            gs.Prn_timestamp_ms = 80000.0 + 0.5 * i;
+            gs.d_TOW_at_current_symbol = 345678.0 + 0.002 * i;
+            gs.Flag_valid_word = true;
+            valid_synchro[i] = gs;
+        }
+    return valid_synchro;
+}
+
+
+/*
+ * Decoding of a Galileo E1B page part: 240 symbols of the K = 7, rate 1/2 code
+ * into 114 bits, as in galileo_e1b_telemetry_decoder_cc::viterbi_decoder
+ */
+static void BM_ViterbiDecodeBlock(benchmark::State& state)
+{
+    int g_encoder[2] = {121, 91};
+    Viterbi_Decoder decoder(g_encoder, 7, 2);
+    const int LL = 114;
+    std::vector<double> symbols(2 * (LL + 6));
+    std::vector<int> bits(LL);
+    srand(1);
+    for (unsigned int i = 0; i < symbols.size(); i++)
+        {
+            symbols[i] = (rand() % 2 == 0 ? 1.0 : -1.0) * (1.0 + 0.5 * (rand() % 100) / 100.0);
+        }
+    for (auto _ : state)
+        {
+            decoder.reset();
+            benchmark::DoNotOptimize(decoder.decode_block(symbols.data(), bits.data(), LL));
+        }
+    state.SetItemsProcessed(state.iterations() * LL);
+}
+BENCHMARK(BM_ViterbiDecodeBlock);
+
+
+// Decoding of the 5 GPS L1 C/A subframes of a frame (one subframe per iteration)
+static void BM_GpsNavigationSubframeDecoder(benchmark::State& state)
+{
+    Gps_Navigation_Message nav;
+    char subframes[5][GPS_SUBFRAME_LENGTH];
+    srand(1);
+    for (int id = 1; id <= 5; id++)
+        {
+            unsigned int words[10];
+            for (int i = 0; i < 10; i++)
+                {
+                    words[i] = static_cast<unsigned int>(rand()) & 0x3FFFFFFF;
+                }
+            // the subframe ID is in bits 20-22 of the HOW
+            words[1] = (words[1] & ~(7u << 8)) | (static_cast<unsigned int>(id) << 8);
+            memcpy(subframes[id - 1], words, GPS_SUBFRAME_LENGTH);
+        }
+    int subframe = 0;
+    for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(nav.subframe_decoder(subframes[subframe]));
+            subframe = (subframe + 1) % 5;
+        }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GpsNavigationSubframeDecoder);
+
+
+// Pseudoranges of gps_l1_ca_observables_cc, for 4 to 24 channels
+static void BM_GpsL1CaPseudoranges(benchmark::State& state)
+{
+    int channels = state.range(0);
+    std::map<int, Gnss_Synchro> valid_synchro = bench_valid_synchro(channels);
+    std::vector<Gnss_Synchro> current_gnss_synchro(channels);
+    for (auto _ : state)
+        {
+            gps_l1_ca_compute_pseudoranges(valid_synchro, current_gnss_synchro.data());
+            benchmark::DoNotOptimize(current_gnss_synchro[0].Pseudorange_m);
+        }
+    state.SetItemsProcessed(state.iterations() * channels);
+}
+BENCHMARK(BM_GpsL1CaPseudoranges)->Arg(4)->Arg(12)->Arg(24);
+
+
+/*
+ * Least squares position and clock of the PVT blocks (the leastSquarePos of
+ * gps_l1_ca_ls_pvt), warm-started from the previous epoch as in the receiver
+ */
+static void BM_LeastSquarePos(benchmark::State& state)
+{
+    int satellites = state.range(0);
+    Ls_Pvt_Solver<PVT_MAX_CHANNELS> solver;
+    // receiver near Castelldefels, satellites spread in azimuth and elevation, 20200 to 25200 km away
+    const double rx[3] = {4797000.0, 166000.0, 4185000.0};
+    const double clock_bias_m = 12345.6;
+    std::vector<double> sat(3 * satellites);
+    std::vector<double> pseudorange(satellites);
+    for (int i = 0; i < satellites; i++)
+        {
+            double az = 2.0 * GPS_PI * i / satellites;
+            double el = 0.2 + 1.2 * (i % 4) / 4.0;
+            double up[3] = {rx[0], rx[1], rx[2]};
+            double norm = std::sqrt(up[0] * up[0] + up[1] * up[1] + up[2] * up[2]);
+            double east[3] = {-rx[1] / std::sqrt(rx[0] * rx[0] + rx[1] * rx[1]), rx[0] / std::sqrt(rx[0] * rx[0] + rx[1] * rx[1]), 0.0};
+            double north[3] = {up[1] / norm * east[2] - up[2] / norm * east[1], up[2] / norm * east[0] - up[0] / norm * east[2], up[0] / norm * east[1] - up[1] / norm * east[0]};
+            double range = 20200000.0 + 5000000.0 * std::cos(el);
+            double r = 0.0;
+            for (int k = 0; k < 3; k++)
+                {
+                    sat[3 * i + k] = rx[k] + range * (std::cos(el) * (std::sin(az) * east[k] + std::cos(az) * north[k]) + std::sin(el) * up[k] / norm);
+                    r += (sat[3 * i + k] - rx[k]) * (sat[3 * i + k] - rx[k]);
+                }
+            pseudorange[i] = std::sqrt(r) + clock_bias_m;
+        }
+    double pos[4];
+    for (auto _ : state)
+        {
+            solver.clear();
+            for (int i = 0; i < satellites; i++)
+                {
+                    solver.add_observation(sat[3 * i], sat[3 * i + 1], sat[3 * i + 2], pseudorange[i], 1.0);
+                }
+            benchmark::DoNotOptimize(solver.solve(pos));
+        }
+    state.counters["iterations_per_fix"] = solver.iterations;
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LeastSquarePos)->Arg(4)->Arg(8)->Arg(12);
+
+
+// Broadcast orbit model, one satellite per iteration, 1 s apart
+static void BM_GpsSatellitePosition(benchmark::State& state)
+{
+    std::vector<Gps_Ephemeris> eph;
+    for (int prn = 1; prn <= 12; prn++)
+        {
+            eph.push_back(bench_gps_ephemeris(prn));
+        }
+    double t = 345600.0;
+    int i = 0;
+    for (auto _ : state)
+        {
+            eph[i].satellitePosition(t);
+            benchmark::DoNotOptimize(eph[i].d_satpos_X);
+            i = (i + 1) % 12;
+            t += 1.0 / 12.0;
+        }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GpsSatellitePosition);
+
+
+// Same as above, evaluated from the Chebyshev fits of the PVT blocks
+static void BM_GpsSatellitePositionOrbitCache(benchmark::State& state)
+{
+    std::vector<Gps_Ephemeris> eph;
+    for (int prn = 1; prn <= 12; prn++)
+        {
+            eph.push_back(bench_gps_ephemeris(prn));
+        }
+    Orbit_Cache<Gps_Ephemeris> cache;
+    double t = 345600.0;
+    int i = 0;
+    for (auto _ : state)
+        {
+            cache.satellitePosition(eph[i], t);
+            benchmark::DoNotOptimize(eph[i].d_satpos_X);
+            i = (i + 1) % 12;
+            t += 1.0 / 12.0;
+        }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GpsSatellitePositionOrbitCache);
+
+
+// One RINEX 3.02 observation epoch of 4 to 12 GPS satellites
+static void BM_RinexObservationEpoch(benchmark::State& state)
+{
+    FLAGS_RINEX_version = "3.02";
+    Rinex_Printer printer;
+    Gps_Ephemeris eph = bench_gps_ephemeris(1);
+    std::map<int, Gnss_Synchro> pseudoranges = bench_valid_synchro(state.range(0));
+    for (std::map<int, Gnss_Synchro>::iterator it = pseudoranges.begin(); it != pseudoranges.end(); ++it)
+        {
+            it->second.Pseudorange_m = 20000000.0 + 123456.789 * it->first;
+            it->second.Carrier_phase_rads = -1.23456789e6 * it->first;
+            it->second.Carrier_Doppler_hz = 1234.5678 - 321.0 * it->first;
+            it->second.CN0_dB_hz = 40.0 + 0.3333 * it->first;
+        }
+    std::ofstream out("/dev/null");
+    double obs_time = 345678.0;
+    for (auto _ : state)
+        {
+            printer.log_rinex_obs(out, eph, obs_time, pseudoranges);
+            obs_time += 1.0;
+        }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RinexObservationEpoch)->Arg(4)->Arg(12);
+
+
+// RINEX 3.02 navigation records of 12 GPS satellites
+static void BM_RinexNavigationRecords(benchmark::State& state)
+{
+    FLAGS_RINEX_version = "3.02";
+    Rinex_Printer printer;
+    std::map<int, Gps_Ephemeris> eph_map;
+    for (int prn = 1; prn <= 12; prn++)
+        {
+            eph_map[prn] = bench_gps_ephemeris(prn);
+        }
+    std::ofstream out("/dev/null");
+    double iodc = 50.0;
+    for (auto _ : state)
+        {
+            // a new issue of data of each satellite, the ones already logged are skipped
+            iodc += 1.0;
+            for (std::map<int, Gps_Ephemeris>::iterator it = eph_map.begin(); it != eph_map.end(); ++it)
+                {
+                    it->second.d_IODC = iodc;
+                }
+            printer.log_rinex_nav(out, eph_map);
+        }
+    state.SetItemsProcessed(state.iterations() * eph_map.size());
+}
+BENCHMARK(BM_RinexNavigationRecords);
@@ -0,0 +1,86 @@
+/*!
+ * \file concurrent_map_test.cc
+ * \brief  This file implements unit tests for the concurrent_map class.
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <map>
+#include <memory>
+#include "concurrent_map.h"
+
+
+
+TEST(Concurrent_Map_Test, VersionIncreasesOnWrite)
+{
+    concurrent_map<double> the_map;
+    EXPECT_EQ(0, the_map.version());
+    EXPECT_EQ(0, the_map.size());
+    the_map.write(1, 1.0);
+    the_map.write(1, 2.0);
+    EXPECT_EQ(2, the_map.version());
+    EXPECT_EQ(1, the_map.size());
+    double value = 0.0;
+    EXPECT_TRUE(the_map.read(1, value));
+    EXPECT_DOUBLE_EQ(2.0, value);
+    EXPECT_FALSE(the_map.read(2, value));
+}
+
+
+
+TEST(Concurrent_Map_Test, SnapshotIsImmutable)
+{
+    concurrent_map<double> the_map;
+    the_map.write(1, 1.0);
+    unsigned long int version = 0;
+    std::shared_ptr<const std::map<int, double> > snapshot = the_map.get_snapshot(version);
+    EXPECT_EQ(1, version);
+    the_map.write(2, 2.0);
+    EXPECT_EQ(1, snapshot->size());
+    EXPECT_EQ(2, the_map.get_snapshot()->size());
+}
+
+
+
+TEST(Concurrent_Map_Test, CopyOnlyWhenUpdated)
+{
+    concurrent_map<double> the_map;
+    std::map<int, double> copy;
+    unsigned long int version = 0;
+    EXPECT_FALSE(the_map.get_map_copy_if_updated(copy, version));
+    the_map.write(3, 3.0);
+    EXPECT_TRUE(the_map.get_map_copy_if_updated(copy, version));
+    EXPECT_EQ(1, copy.size());
+    EXPECT_FALSE(the_map.get_map_copy_if_updated(copy, version));
+    double value = 0.0;
+    unsigned long int read_version = 0;
+    EXPECT_TRUE(the_map.read_if_updated(3, value, read_version));
+    EXPECT_DOUBLE_EQ(3.0, value);
+    EXPECT_FALSE(the_map.read_if_updated(3, value, read_version));
+    the_map.write(3, 4.0);
+    EXPECT_TRUE(the_map.read_if_updated(3, value, read_version));
+    EXPECT_DOUBLE_EQ(4.0, value);
+}
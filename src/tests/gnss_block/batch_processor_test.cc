@@ -0,0 +1,113 @@
+/*!
+ * \file batch_processor_test.cc
+ * \brief Implements Unit Tests for the slices planned by the BatchProcessor class.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <map>
+#include <memory>
+#include <string>
+#include <boost/filesystem.hpp>
+#include "batch_processor.h"
+#include "concurrent_queue.h"
+#include "control_thread.h"
+#include "gnss_sdr_supl_client.h"
+#include "gps_ephemeris.h"
+#include "in_memory_configuration.h"
+
+extern concurrent_queue<Gps_Ephemeris> global_gps_ephemeris_queue;
+
+
+TEST(Batch_Processor_Test, SeededSliceLoadsTheEphemeris)
+{
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    std::string path = std::string(TEST_PATH);
+    std::string file = path + "signal_samples/GSoC_CTTC_capture_2012_07_26_4Msps_4ms.dat";
+    config->set_property("SignalSource.implementation", "File_Signal_Source");
+    config->set_property("SignalSource.filename", file);
+    config->set_property("SignalSource.item_type", "gr_complex");
+    config->set_property("SignalSource.sampling_frequency", "4000000");
+    config->set_property("SignalConditioner.implementation", "Pass_Through");
+    config->set_property("SignalConditioner.item_type", "gr_complex");
+    config->set_property("Channels_GPS.count", "2");
+    config->set_property("Channels_Galileo.count", "0");
+    config->set_property("Channels.in_acquisition", "1");
+    config->set_property("Channel.system", "GPS");
+    config->set_property("Channel.signal", "1C");
+    config->set_property("Acquisition_GPS.implementation", "GPS_L1_CA_PCPS_Acquisition");
+    config->set_property("Tracking_GPS.implementation", "GPS_L1_CA_DLL_PLL_Tracking");
+    config->set_property("TelemetryDecoder_GPS.implementation", "GPS_L1_CA_Telemetry_Decoder");
+    config->set_property("Observables.implementation", "GPS_L1_CA_Observables");
+    config->set_property("PVT.implementation", "GPS_L1_CA_PVT");
+    config->set_property("OutputFilter.implementation", "Null_Sink_Output_Filter");
+
+    Batch_Options options;
+    options.directory = (boost::filesystem::temp_directory_path() / "batch_processor_test").string();
+    options.slices = 2;
+    options.jobs = 1;
+    options.overlap_s = 0.001;
+    options.nav_pass_s = 0.0;
+    BatchProcessor batch(config, options);
+    ASSERT_TRUE(batch.plan());
+    ASSERT_EQ(2u, batch.slices().size());
+
+    // a slice without seed decodes its own ephemerides
+    std::map<std::string, std::string> unseeded = batch.slice_overrides(0, "");
+    EXPECT_EQ("false", unseeded["GNSS-SDR.SUPL_gps_enabled"]);
+    EXPECT_EQ("false", unseeded["GNSS-SDR.SUPL_read_gps_assistance_xml"]);
+
+    // a seeded one reads them from its copy of the seed, which needs SUPL enabled
+    std::string seed = (boost::filesystem::temp_directory_path() / "batch_processor_test_seed.xml").string();
+    std::map<std::string, std::string> seeded = batch.slice_overrides(1, seed);
+    EXPECT_EQ("true", seeded["GNSS-SDR.SUPL_gps_enabled"]);
+    EXPECT_EQ("true", seeded["GNSS-SDR.SUPL_read_gps_assistance_xml"]);
+    EXPECT_EQ("Mmap_File_Signal_Source", seeded["SignalSource.implementation"]);
+    EXPECT_EQ("false", seeded["SignalSource.repeat"]);
+    boost::filesystem::path slice_xml(seeded["GNSS-SDR.SUPL_gps_ephemeris_xml"]);
+    EXPECT_EQ(boost::filesystem::path(options.directory), slice_xml.parent_path().parent_path());
+
+    // the receiver of the slice loads the seed as the batch processor leaves it
+    Gps_Ephemeris eph = Gps_Ephemeris();
+    eph.i_satellite_PRN = 7;
+    std::map<int, Gps_Ephemeris> eph_map;
+    eph_map[7] = eph;
+    boost::filesystem::create_directories(slice_xml.parent_path());
+    gnss_sdr_supl_client supl_client;
+    ASSERT_TRUE(supl_client.save_ephemeris_map_xml(slice_xml.string(), eph_map));
+    for (std::map<std::string, std::string>::const_iterator it = seeded.begin(); it != seeded.end(); ++it)
+        {
+            config->set_property(it->first, it->second);
+        }
+    Gps_Ephemeris loaded;
+    while (global_gps_ephemeris_queue.try_pop(loaded)) {}
+    {
+        std::unique_ptr<ControlThread> control_thread(new ControlThread(config));
+    }
+    ASSERT_TRUE(global_gps_ephemeris_queue.try_pop(loaded));
+    EXPECT_EQ(7u, loaded.i_satellite_PRN);
+    boost::filesystem::remove_all(options.directory);
+}
@@ -0,0 +1,199 @@
+/*!
+ * \file compressed_file_signal_source_test.cc
+ * \brief Implements Unit Tests for the compressed sample files and the
+ * CompressedFileSignalSource class.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <gnuradio/msg_queue.h>
+#include <gtest/gtest.h>
+#include "compressed_file_signal_source.h"
+#include "compressed_sample_file.h"
+#include "in_memory_configuration.h"
+
+
+// Writes a ramp of shorts with some noise, compressible but not trivially
+std::vector<short> write_compressed_samples(const std::string& filename, const std::string& compression, unsigned int nsamples)
+{
+    std::vector<short> samples(nsamples);
+    std::srand(1234);
+    for (unsigned int i = 0; i < nsamples; i++)
+        {
+            samples[i] = static_cast<short>((i % 1000) + std::rand() % 4);
+        }
+    Compressed_Sample_Writer writer;
+    EXPECT_TRUE(writer.open(filename, compression));
+    // in pieces that do not match the frames
+    unsigned int written = 0;
+    while (written < nsamples)
+        {
+            unsigned int n = std::min(nsamples - written, 777777u);
+            EXPECT_TRUE(writer.write(reinterpret_cast<const char*>(&samples[written]), n * sizeof(short)));
+            written += n;
+        }
+    EXPECT_TRUE(writer.close());
+    EXPECT_EQ(nsamples * sizeof(short), writer.bytes_in());
+    EXPECT_LT(writer.bytes_out(), writer.bytes_in());
+    return samples;
+}
+
+
+void check_compressed_round_trip(const std::string& compression, const std::string& extension)
+{
+    std::string filename = (boost::filesystem::temp_directory_path() / ("compressed_sample_file_test" + extension)).string();
+    unsigned int nsamples = 10000000;   // 20 MB, several frames
+    std::vector<short> samples = write_compressed_samples(filename, compression, nsamples);
+
+    Compressed_Sample_File file;
+    ASSERT_TRUE(file.open(filename, "auto", 4, 4));
+    EXPECT_EQ(compression, file.compression());
+    std::vector<short> read(nsamples + 100);
+    // the last read gets only what is left
+    std::size_t nbytes = 0;
+    std::size_t n;
+    while ((n = file.read(reinterpret_cast<char*>(read.data()) + nbytes, 1000003)) > 0)
+        {
+            nbytes += n;
+        }
+    EXPECT_EQ(nsamples * sizeof(short), nbytes);
+    EXPECT_EQ(nbytes, file.bytes_read());
+    EXPECT_FALSE(file.failed());
+    EXPECT_FALSE(file.streaming());
+    read.resize(nsamples);
+    EXPECT_TRUE(samples == read);
+
+    // skip to the middle of a frame and read on
+    ASSERT_TRUE(file.rewind());
+    EXPECT_EQ(6000001u * sizeof(short), file.skip(6000001 * sizeof(short)));
+    short sample;
+    ASSERT_EQ(sizeof(short), file.read(reinterpret_cast<char*>(&sample), sizeof(short)));
+    EXPECT_EQ(samples[6000001], sample);
+    file.close();
+    boost::filesystem::remove(filename);
+}
+
+
+TEST(Compressed_Sample_File_Test, CompressionFromFilename)
+{
+    EXPECT_EQ(std::string("zstd"), compression_from_filename("capture.dat.zst"));
+    EXPECT_EQ(std::string("zstd"), compression_from_filename("capture.ZSTD"));
+    EXPECT_EQ(std::string("lz4"), compression_from_filename("/data/capture.lz4"));
+    EXPECT_EQ(std::string("none"), compression_from_filename("capture.dat"));
+    EXPECT_EQ(std::string("none"), compression_from_filename("capture"));
+    EXPECT_TRUE(compression_supported("none"));
+    EXPECT_FALSE(compression_supported("gzip"));
+}
+
+
+TEST(Compressed_Sample_File_Test, FileNotExists)
+{
+    Compressed_Sample_File file;
+    EXPECT_FALSE(file.open("./not_found_file_passes.dat.zst"));
+    EXPECT_FALSE(file.open("./capture.dat", "gzip"));
+    EXPECT_FALSE(file.is_open());
+}
+
+
+#if ZSTD_COMPRESSION
+TEST(Compressed_Sample_File_Test, ZstdRoundTrip)
+{
+    check_compressed_round_trip("zstd", ".dat.zst");
+}
+
+
+TEST(Compressed_Sample_File_Test, ZstdTruncated)
+{
+    std::string filename = (boost::filesystem::temp_directory_path() / "compressed_sample_file_test_truncated.zst").string();
+    write_compressed_samples(filename, "zstd", 3000000);
+    boost::filesystem::resize_file(filename, boost::filesystem::file_size(filename) - 100);
+    Compressed_Sample_File file;
+    ASSERT_TRUE(file.open(filename));
+    std::vector<char> buffer(3000000 * sizeof(short));
+    std::size_t nbytes = file.read(buffer.data(), buffer.size());
+    EXPECT_LT(nbytes, buffer.size());
+    EXPECT_EQ(0u, nbytes % COMPRESSED_SAMPLE_FILE_FRAME_BYTES);   // the whole frames are delivered
+    EXPECT_TRUE(file.failed());
+    file.close();
+    boost::filesystem::remove(filename);
+}
+#endif
+
+
+#if LZ4_COMPRESSION
+TEST(Compressed_Sample_File_Test, Lz4RoundTrip)
+{
+    check_compressed_round_trip("lz4", ".dat.lz4");
+}
+#endif
+
+
+#if ZSTD_COMPRESSION
+TEST(CompressedFileSignalSource, InstantiateWithSeek)
+{
+    std::string filename = (boost::filesystem::temp_directory_path() / "compressed_file_signal_source_test.dat.zst").string();
+    write_compressed_samples(filename, "zstd", 100000);
+    boost::shared_ptr<gr::msg_queue> queue = gr::msg_queue::make(0);
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+
+    config->set_property("Test.samples", "0");
+    config->set_property("Test.sampling_frequency", "4000000");
+    config->set_property("Test.seek_s", "0.001");
+    config->set_property("Test.filename", filename);
+    config->set_property("Test.item_type", "short");
+    config->set_property("Test.decompression_threads", "2");
+    config->set_property("Test.repeat", "false");
+
+    std::unique_ptr<CompressedFileSignalSource> signal_source(new CompressedFileSignalSource(config.get(), "Test", 1, 1, queue));
+
+    EXPECT_STREQ("short", signal_source->item_type().c_str());
+    EXPECT_STREQ("Compressed_File_Signal_Source", signal_source->implementation().c_str());
+    EXPECT_STREQ("auto", signal_source->compression().c_str());
+    EXPECT_EQ(8000u, signal_source->first_item());   // interleaved I/Q
+    signal_source.reset();
+    boost::filesystem::remove(filename);
+}
+#endif
+
+
+TEST(CompressedFileSignalSource, InstantiateFileNotExists)
+{
+    boost::shared_ptr<gr::msg_queue> queue = gr::msg_queue::make(0);
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+
+    config->set_property("Test.samples", "0");
+    config->set_property("Test.sampling_frequency", "0");
+    config->set_property("Test.filename", "./signal_samples/i_dont_exist.dat.zst");
+    config->set_property("Test.item_type", "gr_complex");
+    config->set_property("Test.repeat", "false");
+
+    EXPECT_THROW({auto uptr = std::make_shared<CompressedFileSignalSource>(config.get(), "Test", 1, 1, queue);}, std::exception);
+}
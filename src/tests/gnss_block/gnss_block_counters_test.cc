@@ -0,0 +1,119 @@
+/*!
+ * \file gnss_block_counters_test.cc
+ * \brief Implements Unit Tests for the Gnss_Block_Counters class and the
+ * Prometheus and summary formatting of the counters.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+#include "gnss_block_counters.h"
+
+
+TEST(Gnss_Block_Counters_Test, WorkTimer)
+{
+    std::shared_ptr<Gnss_Block_Counters> counters = gnss_block_counters("test_timer", 1001);
+    for (int i = 0; i < 3; i++)
+        {
+            Gnss_Work_Timer timer(counters.get(), 10 * (i + 1));
+            boost::this_thread::sleep(boost::posix_time::milliseconds(2));
+        }
+    Gnss_Work_Timer source(counters.get());   // no input
+    Gnss_Work_Timer nothing(nullptr, 100);
+    counters->add_late(2);
+    counters->add_dropped();
+    Gnss_Block_Counters_Snapshot s = counters->snapshot();
+    EXPECT_EQ(std::string("test_timer"), s.name);
+    EXPECT_EQ(1001, s.id);
+    EXPECT_EQ(3u, s.work_calls);   // the last timer is still running
+    EXPECT_GE(s.work_ns, 6000000u);
+    EXPECT_EQ(60u, s.input_items);
+    EXPECT_EQ(30u, s.input_items_max);
+    EXPECT_EQ(2u, s.late_epochs);
+    EXPECT_EQ(1u, s.dropped_epochs);
+    counters->set_dropped(7);
+    EXPECT_EQ(7u, counters->snapshot().dropped_epochs);
+}
+
+
+TEST(Gnss_Block_Counters_Test, SnapshotForgetsDeletedBlocks)
+{
+    std::shared_ptr<Gnss_Block_Counters> kept = gnss_block_counters("test_kept", 1002);
+    std::shared_ptr<Gnss_Block_Counters> deleted = gnss_block_counters("test_deleted", 1003);
+    deleted.reset();
+    std::vector<Gnss_Block_Counters_Snapshot> blocks = gnss_block_counters_snapshot();
+    bool found_kept = false;
+    bool found_deleted = false;
+    for (unsigned int i = 0; i < blocks.size(); i++)
+        {
+            if (blocks[i].id == 1002) found_kept = true;
+            if (blocks[i].id == 1003) found_deleted = true;
+        }
+    EXPECT_TRUE(found_kept);
+    EXPECT_FALSE(found_deleted);
+}
+
+
+TEST(Gnss_Block_Counters_Test, Prometheus)
+{
+    Gnss_Block_Counters_Snapshot s = Gnss_Block_Counters_Snapshot();
+    s.name = "pcps_acquisition_cc";
+    s.id = 12;
+    s.work_calls = 40;
+    s.work_ns = 1500000000;
+    s.items_in = 123456789;
+    std::string text = gnss_block_counters_prometheus(std::vector<Gnss_Block_Counters_Snapshot>(1, s));
+    EXPECT_NE(std::string::npos, text.find("# TYPE gnss_sdr_block_work_calls_total counter\n"));
+    EXPECT_NE(std::string::npos, text.find("gnss_sdr_block_work_calls_total{block=\"pcps_acquisition_cc\",id=\"12\"} 40\n"));
+    EXPECT_NE(std::string::npos, text.find("gnss_sdr_block_work_seconds_total{block=\"pcps_acquisition_cc\",id=\"12\"} 1.5\n"));
+    EXPECT_NE(std::string::npos, text.find("gnss_sdr_block_items_in_total{block=\"pcps_acquisition_cc\",id=\"12\"} 123456789\n"));
+    EXPECT_NE(std::string::npos, text.find("# TYPE gnss_sdr_block_input_items_max gauge\n"));
+    EXPECT_NE(std::string::npos, text.find("gnss_sdr_block_dropped_epochs_total{block=\"pcps_acquisition_cc\",id=\"12\"} 0\n"));
+}
+
+
+TEST(Gnss_Block_Counters_Test, SummaryBusiestFirst)
+{
+    std::vector<Gnss_Block_Counters_Snapshot> before(2, Gnss_Block_Counters_Snapshot());
+    before[0].name = "idle";
+    before[0].id = 1;
+    before[1].name = "busy";
+    before[1].id = 2;
+    std::vector<Gnss_Block_Counters_Snapshot> after = before;
+    after[0].work_ns = 100000000;    // 10% of one second
+    after[1].work_ns = 900000000;    // 90%
+    after[1].work_calls = 1000;
+    after[1].input_items = 4000;
+    after[1].late_epochs = 3;
+    std::vector<std::string> summary = gnss_block_counters_summary(before, after, 1.0);
+    ASSERT_EQ(2u, summary.size());
+    EXPECT_EQ(0u, summary[0].find("busy(2): 90.0% busy, 1000 calls/s"));
+    EXPECT_NE(std::string::npos, summary[0].find("4 items waiting, 3 late, 0 dropped"));
+    EXPECT_EQ(0u, summary[1].find("idle(1): 10.0% busy"));
+    EXPECT_TRUE(gnss_block_counters_summary(before, after, 0.0).empty());
+}
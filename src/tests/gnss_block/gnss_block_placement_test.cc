@@ -0,0 +1,119 @@
+/*!
+ * \file gnss_block_placement_test.cc
+ * \brief Implements Unit Tests for the Gnss_Block_Placer class.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <fstream>
+#include <boost/filesystem.hpp>
+#include "gnss_block_placement.h"
+#include "in_memory_configuration.h"
+
+
+TEST(GnssBlockPlacement, CpuList)
+{
+    std::vector<int> cpus = gnss_parse_cpu_list("0-3, 8,10-11");
+    std::vector<int> expected = {0, 1, 2, 3, 8, 10, 11};
+    EXPECT_EQ(expected, cpus);
+    EXPECT_EQ("0-3,8,10-11", gnss_format_cpu_list(cpus));
+    EXPECT_TRUE(gnss_parse_cpu_list("").empty());
+    EXPECT_EQ(std::vector<int>(1, 5), gnss_parse_cpu_list("x,5,3-1"));
+}
+
+
+TEST(GnssBlockPlacement, NumaNodes)
+{
+    boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    boost::filesystem::create_directories(dir / "node0");
+    boost::filesystem::create_directories(dir / "node1");
+    std::ofstream((dir / "node0" / "cpulist").string().c_str()) << "0-3\n";
+    std::ofstream((dir / "node1" / "cpulist").string().c_str()) << "4-7\n";
+    std::vector<std::vector<int> > nodes = gnss_numa_nodes(dir.string());
+    ASSERT_EQ(2, nodes.size());
+    EXPECT_EQ("0-3", gnss_format_cpu_list(nodes[0]));
+    EXPECT_EQ("4-7", gnss_format_cpu_list(nodes[1]));
+    boost::filesystem::remove_all(dir);
+
+    // without NUMA information, all the CPUs are one node
+    EXPECT_EQ(1, gnss_numa_nodes(dir.string()).size());
+}
+
+
+TEST(GnssBlockPlacement, MostSpecificRoleWins)
+{
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("Channel.affinity", "0-1");
+    config->set_property("Channel.rt_priority", "10");
+    config->set_property("Tracking_GPS.affinity", "2");
+    config->set_property("Channel3.affinity", "3");
+    config->set_property("Channel3.min_output_buffer", "8192");
+    Gnss_Block_Placer placer(config.get(), 4, std::vector<std::vector<int> >(1, gnss_parse_cpu_list("0-3")));
+
+    Gnss_Block_Placement placement = placer.placement({"Channel3", "Tracking_GPS", "Channel"}, 3);
+    EXPECT_EQ("3", gnss_format_cpu_list(placement.affinity));
+    EXPECT_EQ(8192, placement.min_output_buffer);
+    EXPECT_EQ(0, placement.max_output_buffer);
+    EXPECT_EQ(10, placement.rt_priority);
+
+    placement = placer.placement({"Channel1", "Tracking_GPS", "Channel"}, 1);
+    EXPECT_EQ("2", gnss_format_cpu_list(placement.affinity));
+    placement = placer.placement({"Channel1", "Acquisition_GPS", "Channel"}, 1);
+    EXPECT_EQ("0-1", gnss_format_cpu_list(placement.affinity));
+
+    // nothing set and no NUMA layout: the scheduler decides
+    placement = placer.placement({"PVT"}, -2);
+    EXPECT_TRUE(placement.affinity.empty());
+    EXPECT_EQ(-1, placement.rt_priority);
+}
+
+
+TEST(GnssBlockPlacement, NumaLayout)
+{
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("GNSS-SDR.numa_layout", "true");
+    config->set_property("SignalConditioner.affinity", "5");
+    config->set_property("Channel2.affinity", "0");
+    std::vector<std::vector<int> > nodes = {gnss_parse_cpu_list("0-3"), gnss_parse_cpu_list("4-7")};
+    Gnss_Block_Placer placer(config.get(), 8, nodes);
+
+    // the conditioner is on node 1: its 4 cores take the source, the conditioner
+    // and 2 channels, the other channels spill over to node 0
+    EXPECT_EQ(1, placer.front_node());
+    EXPECT_EQ(1, placer.channel_node(0));
+    EXPECT_EQ(1, placer.channel_node(1));
+    for (unsigned int channel = 2; channel < 6; channel++)
+        {
+            EXPECT_EQ(0, placer.channel_node(channel));
+        }
+    EXPECT_EQ(1, placer.channel_node(6));
+
+    EXPECT_EQ("4-7", gnss_format_cpu_list(placer.placement({"SignalSource"}, -1).affinity));
+    EXPECT_EQ("4-7", gnss_format_cpu_list(placer.placement({"Channel1", "Channel"}, 1).affinity));
+    EXPECT_EQ("0-3", gnss_format_cpu_list(placer.placement({"Channel3", "Channel"}, 3).affinity));
+    EXPECT_EQ("0", gnss_format_cpu_list(placer.placement({"Channel2", "Channel"}, 2).affinity));
+    EXPECT_TRUE(placer.placement({"Observables"}, -2).affinity.empty());
+}
@@ -0,0 +1,223 @@
+/*!
+ * \file gnss_dump_merger_test.cc
+ * \brief Implements Unit Tests for gnss_time_slices() and the
+ * Gnss_Dump_Merger class.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "gnss_dump_merger.h"
+#include "gnss_dump_reader.h"
+#include "gnss_dump_writer.h"
+#include "gnss_time_slices.h"
+
+
+// Writes a PVT-like dump with one record per time in [begin, end) every step,
+// or a time of 0 while the receiver has no fix. Times are of week: they wrap at the week rollover
+std::string write_slice_dump(const std::string& name, double begin, double end, double step, double no_fix_until)
+{
+    std::string filename = (boost::filesystem::temp_directory_path() / name).string();
+    Gnss_Dump_Writer writer;
+    writer.set_attribute("source", "test_pvt");
+    writer.add_field<double>("ch0_rx_time_s");
+    writer.add_field<double>("ch1_rx_time_s");
+    writer.add_field<double>("x_m");
+    EXPECT_TRUE(writer.open(filename, false));
+    for (double t = begin; t < end - step / 2.0; t += step)
+        {
+            double time = (t < no_fix_until) ? 0.0 : std::fmod(t, GNSS_DUMP_MERGER_WEEK_S);
+            writer.put(time);
+            writer.put(time - 0.5);
+            writer.put(begin);   // tells the slice
+            writer.end_record();
+        }
+    writer.close();
+    return filename;
+}
+
+
+TEST(Gnss_Time_Slices_Test, Overlap)
+{
+    std::vector<Gnss_Time_Slice> slices = gnss_time_slices(0, 1000, 4, 50, 2);
+    ASSERT_EQ(4u, slices.size());
+    EXPECT_EQ(0u, slices[0].first_item);
+    EXPECT_EQ(0u, slices[0].owned_first_item);
+    EXPECT_EQ(250u, slices[0].items);
+    EXPECT_EQ(200u, slices[1].first_item);
+    EXPECT_EQ(250u, slices[1].owned_first_item);
+    EXPECT_EQ(300u, slices[1].items);
+    // the shares cover the capture exactly
+    unsigned long long covered = 0;
+    for (unsigned int i = 0; i < slices.size(); i++)
+        {
+            EXPECT_EQ(i, slices[i].index);
+            EXPECT_EQ(covered, slices[i].owned_first_item);
+            covered = slices[i].first_item + slices[i].items;
+        }
+    EXPECT_EQ(1000u, covered);
+}
+
+
+TEST(Gnss_Time_Slices_Test, AlignedAndLimited)
+{
+    // odd sizes are aligned to I/Q pairs, and the offset is kept
+    std::vector<Gnss_Time_Slice> slices = gnss_time_slices(100, 1001, 3, 33, 2);
+    ASSERT_EQ(3u, slices.size());
+    for (unsigned int i = 0; i < slices.size(); i++)
+        {
+            EXPECT_EQ(0u, slices[i].first_item % 2);
+            EXPECT_EQ(0u, slices[i].items % 2);
+            EXPECT_LE(100u, slices[i].first_item);
+        }
+    EXPECT_EQ(1100u, slices.back().first_item + slices.back().items);
+
+    // shares shorter than the overlap are not worth it
+    EXPECT_EQ(4u, gnss_time_slices(0, 1000, 32, 250).size());
+    EXPECT_EQ(1u, gnss_time_slices(0, 1000, 32, 5000).size());
+    EXPECT_EQ(0u, gnss_time_slices(0, 1, 4, 0, 2).size());
+}
+
+
+TEST(Gnss_Dump_Merger_Test, DropsOverlapAndWarmUp)
+{
+    // three slices of 100 s that start 20 s early and need 10 s to get a fix
+    std::vector<std::string> files;
+    files.push_back(write_slice_dump("gnss_dump_merger_test_0.dat", 1000.0, 1100.0, 0.5, 1010.0));
+    files.push_back(write_slice_dump("gnss_dump_merger_test_1.dat", 1080.0, 1200.0, 0.5, 1090.0));
+    files.push_back(write_slice_dump("gnss_dump_merger_test_2.dat", 1180.0, 1300.0, 0.5, 1190.0));
+    std::string merged = (boost::filesystem::temp_directory_path() / "gnss_dump_merger_test.dat").string();
+
+    {
+        Gnss_Dump_Merger merger(merged, "rx_time_s");
+        for (unsigned int i = 0; i < files.size(); i++)
+            {
+                EXPECT_TRUE(merger.add(files[i]));
+            }
+        EXPECT_FALSE(merger.add("./not_found_file_passes.dat"));
+        EXPECT_EQ(3u, merger.files());
+        EXPECT_EQ(200u + 240u + 240u, merger.records_in());
+        EXPECT_EQ(180u + 200u + 200u, merger.records_out());
+        EXPECT_DOUBLE_EQ(1299.5, merger.last_time());
+    }
+
+    Gnss_Dump_Reader reader;
+    ASSERT_TRUE(reader.open(merged));
+    EXPECT_EQ("test_pvt", reader.attribute("source"));
+    EXPECT_EQ("rx_time_s", reader.attribute("merged_by"));
+    ASSERT_EQ(580u, reader.records());
+    int time = reader.field_index("ch0_rx_time_s");
+    int slice = reader.field_index("x_m");
+    double last = 0.0;
+    bool ordered = true;
+    bool converged = true;
+    while (reader.read_record())
+        {
+            double t = reader.value<double>(time);
+            if (t <= last) ordered = false;
+            // in the overlaps, the records are those of the previous slice
+            if (t < 1100.0 and reader.value<double>(slice) != 1000.0) converged = false;
+            if (t >= 1100.0 and t < 1200.0 and reader.value<double>(slice) != 1080.0) converged = false;
+            last = t;
+        }
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(converged);
+    reader.close();
+    boost::filesystem::remove(merged);
+    for (unsigned int i = 0; i < files.size(); i++)
+        {
+            boost::filesystem::remove(files[i]);
+        }
+}
+
+
+TEST(Gnss_Dump_Merger_Test, WeekRollover)
+{
+    // the second slice crosses the end of the week, the third one starts in the next week
+    double end_of_week = GNSS_DUMP_MERGER_WEEK_S;
+    std::vector<std::string> files;
+    files.push_back(write_slice_dump("gnss_dump_merger_test_w0.dat", end_of_week - 199.75, end_of_week - 99.75, 0.5, 0.0));
+    files.push_back(write_slice_dump("gnss_dump_merger_test_w1.dat", end_of_week - 119.75, end_of_week + 0.25, 0.5, 0.0));
+    files.push_back(write_slice_dump("gnss_dump_merger_test_w2.dat", end_of_week - 19.75, end_of_week + 100.25, 0.5, 0.0));
+    std::string merged = (boost::filesystem::temp_directory_path() / "gnss_dump_merger_test_w.dat").string();
+
+    {
+        Gnss_Dump_Merger merger(merged, "rx_time_s");
+        for (unsigned int i = 0; i < files.size(); i++)
+            {
+                EXPECT_TRUE(merger.add(files[i]));
+            }
+        EXPECT_EQ(200u + 200u + 200u, merger.records_out());
+        EXPECT_EQ(1, merger.last_week());
+        EXPECT_DOUBLE_EQ(99.75, merger.last_time());
+    }
+
+    Gnss_Dump_Reader reader;
+    ASSERT_TRUE(reader.open(merged));
+    int time = reader.field_index("ch0_rx_time_s");
+    double last = 0.0;
+    unsigned int rollovers = 0;
+    while (reader.read_record())
+        {
+            double t = reader.value<double>(time);
+            if (t < last) rollovers++;
+            last = t;
+        }
+    EXPECT_EQ(1u, rollovers);
+    reader.close();
+    boost::filesystem::remove(merged);
+    for (unsigned int i = 0; i < files.size(); i++)
+        {
+            boost::filesystem::remove(files[i]);
+        }
+}
+
+
+TEST(Gnss_Dump_Merger_Test, FieldsMustMatch)
+{
+    std::string first = write_slice_dump("gnss_dump_merger_test_a.dat", 0.0, 10.0, 1.0, 0.0);
+    std::string other = (boost::filesystem::temp_directory_path() / "gnss_dump_merger_test_b.dat").string();
+    {
+        Gnss_Dump_Writer writer;
+        writer.add_field<double>("rx_time_s");
+        ASSERT_TRUE(writer.open(other, false));
+        writer.put(20.0);
+        writer.end_record();
+    }
+    std::string merged = (boost::filesystem::temp_directory_path() / "gnss_dump_merger_test_ab.dat").string();
+    Gnss_Dump_Merger merger(merged, "rx_time_s");
+    EXPECT_TRUE(merger.add(first));
+    EXPECT_FALSE(merger.add(other));
+    merger.close();
+    EXPECT_EQ(9u, merger.records_out());   // time 0 is no time
+    Gnss_Dump_Merger no_time(merged, "TOW_at_current_symbol");
+    EXPECT_FALSE(no_time.add(first));
+    boost::filesystem::remove(first);
+    boost::filesystem::remove(other);
+    boost::filesystem::remove(merged);
+}
@@ -0,0 +1,145 @@
+/*!
+ * \file gnss_dump_writer_test.cc
+ * \brief Implements Unit Tests for the Gnss_Dump_Writer and
+ * Gnss_Dump_Reader classes.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <boost/filesystem.hpp>
+#include "gnss_dump_reader.h"
+#include "gnss_dump_writer.h"
+
+
+// Writes n tracking-like records and reads them back
+void gnss_dump_round_trip(bool background, unsigned long int n)
+{
+    std::string filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gnss_dump_%%%%%%.dat")).string();
+    {
+        Gnss_Dump_Writer writer;
+        writer.set_attribute("source", "test");
+        writer.set_attribute("channel", 3);
+        writer.set_attribute("sample_rate_hz", 4e6);
+        writer.add_field<float>("abs_P");
+        writer.add_field<unsigned long int>("sample_counter");
+        writer.add_field<double>("pseudorange_m", 4);
+        writer.add_field<int>("prn");
+        ASSERT_TRUE(writer.open(filename, background));
+        EXPECT_EQ(4u + 8u + 32u + 4u, writer.record_size());
+        for (unsigned long int i = 0; i < n; i++)
+            {
+                double pseudoranges[4] = {i * 1.0, i * 2.0, i * 3.0, i * 4.0};
+                writer.put(static_cast<float>(i) * 0.5f);
+                writer.put(i * 4000);
+                writer.put(pseudoranges, 4);
+                writer.put(static_cast<int>(i % 32));
+                writer.end_record();
+            }
+        EXPECT_EQ(n, writer.records());
+    }
+
+    Gnss_Dump_Reader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_EQ("test", reader.attribute("source"));
+    EXPECT_EQ("3", reader.attribute("channel"));
+    EXPECT_EQ("4000000", reader.attribute("sample_rate_hz"));
+    EXPECT_EQ(n, reader.records());
+    ASSERT_EQ(4u, reader.fields().size());
+    EXPECT_EQ("uint64", reader.fields().at(1).type);
+    EXPECT_EQ("int32", reader.fields().at(3).type);
+    int abs_p = reader.field_index("abs_P");
+    int counter = reader.field_index("sample_counter");
+    int pseudorange = reader.field_index("pseudorange_m");
+    int prn = reader.field_index("prn");
+    EXPECT_EQ(-1, reader.field_index("not_a_field"));
+    bool all_equal = true;
+    for (unsigned long int i = 0; i < n; i++)
+        {
+            ASSERT_TRUE(reader.read_record());
+            if (reader.value<float>(abs_p) != static_cast<float>(i) * 0.5f) all_equal = false;
+            if (reader.value<unsigned long int>(counter) != i * 4000) all_equal = false;
+            if (reader.value<double>(pseudorange, 2) != i * 3.0) all_equal = false;
+            if (reader.to_double(prn) != static_cast<double>(i % 32)) all_equal = false;
+        }
+    EXPECT_TRUE(all_equal);
+    EXPECT_FALSE(reader.read_record());
+
+    ASSERT_TRUE(reader.seek_record(n / 2));
+    ASSERT_TRUE(reader.read_record());
+    EXPECT_EQ((n / 2) * 4000, reader.value<unsigned long int>(counter));
+    reader.close();
+    std::remove(filename.c_str());
+}
+
+
+TEST(Gnss_Dump_Writer_Test, RoundTrip)
+{
+    // 20000 records of 48 bytes span several 64 KB blocks
+    gnss_dump_round_trip(false, 20000);
+}
+
+
+TEST(Gnss_Dump_Writer_Test, RoundTripBackground)
+{
+    gnss_dump_round_trip(true, 20000);
+}
+
+
+TEST(Gnss_Dump_Writer_Test, DestroyedRightAfterClose)
+{
+    // the background thread must be done with a writer once close() returns
+    std::string filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gnss_dump_%%%%%%.dat")).string();
+    for (int i = 0; i < 200; i++)
+        {
+            std::unique_ptr<Gnss_Dump_Writer> writer(new Gnss_Dump_Writer());
+            writer->add_field<double>("x");
+            ASSERT_TRUE(writer->open(filename, true));
+            for (int k = 0; k < 3 * GNSS_DUMP_BLOCK_SIZE / 8; k++)
+                {
+                    writer->put(static_cast<double>(k));
+                    writer->end_record();
+                }
+            writer->close();
+        }
+    std::remove(filename.c_str());
+}
+
+
+TEST(Gnss_Dump_Writer_Test, NotADumpFile)
+{
+    std::string filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gnss_dump_%%%%%%.dat")).string();
+    std::FILE* f = std::fopen(filename.c_str(), "wb");
+    ASSERT_TRUE(f != nullptr);
+    double raw[4] = {1.0, 2.0, 3.0, 4.0};
+    std::fwrite(raw, sizeof(double), 4, f);
+    std::fclose(f);
+
+    Gnss_Dump_Reader reader;
+    EXPECT_FALSE(reader.open(filename));
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,281 @@
+/*!
+ * \file gnss_event_loop_test.cc
+ * \brief Implements Unit Tests for the Gnss_Event_Loop class.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "concurrent_queue.h"
+#include "gnss_event_loop.h"
+
+
+/*
+ * Events recorded from a receiver run: the thread that pushed them, then
+ * an ephemeris (PRN, week, Toe) or a channel message (channel, message)
+ */
+const char* recorded_events =
+        "1 eph 12 1830 345600\n"
+        "2 ch 0 2\n"
+        "1 eph 25 1830 345600\n"
+        "3 ch 1 1\n"
+        "2 ch 0 1\n"
+        "1 eph 12 1830 352800\n"
+        "3 ch 1 2\n"
+        "1 eph 12 1830 345600\n"   // older, must not replace the one above
+        "2 ch 0 2\n"
+        "1 eph 25 1831 0\n"
+        "3 ch 1 1\n";
+
+
+struct Recorded_Ephemeris
+{
+    int prn;
+    int week;
+    double toe;
+};
+
+
+struct Event_Replay
+{
+    std::map<int, Recorded_Ephemeris> ephemeris;
+    std::map<int, std::vector<int> > channel_messages;
+
+    // the rule of ControlThread::gps_ephemeris_data_collector
+    void collect_ephemeris(Recorded_Ephemeris const& eph)
+    {
+        std::map<int, Recorded_Ephemeris>::iterator old = ephemeris.find(eph.prn);
+        if (old == ephemeris.end() or eph.week > old->second.week
+                or (eph.week == old->second.week and eph.toe > old->second.toe))
+            {
+                ephemeris[eph.prn] = eph;
+            }
+    }
+
+    void channel_message(int channel, int const& message)
+    {
+        channel_messages[channel].push_back(message);
+    }
+};
+
+
+// Pushes the events of one recorded thread to the queues, as that thread did
+void replay_thread(const std::vector<std::string>* lines, concurrent_queue<Recorded_Ephemeris>* ephemeris_queue,
+        std::map<int, concurrent_queue<int>*>* channel_queues)
+{
+    for (unsigned int i = 0; i < lines->size(); i++)
+        {
+            std::istringstream line(lines->at(i));
+            std::string type;
+            line >> type;
+            if (type == "eph")
+                {
+                    Recorded_Ephemeris eph;
+                    line >> eph.prn >> eph.week >> eph.toe;
+                    ephemeris_queue->push(eph);
+                }
+            else
+                {
+                    int channel, message;
+                    line >> channel >> message;
+                    channel_queues->at(channel)->push(message);
+                }
+        }
+}
+
+
+TEST(GnssEventLoop, ReplaysRecordedStream)
+{
+    std::map<int, std::vector<std::string> > threads;
+    std::istringstream stream(recorded_events);
+    std::string line;
+    unsigned int events = 0;
+    while (std::getline(stream, line))
+        {
+            int thread = std::atoi(line.substr(0, line.find(' ')).c_str());
+            threads[thread].push_back(line.substr(line.find(' ') + 1));
+            events++;
+        }
+
+    Event_Replay replay;
+    concurrent_queue<Recorded_Ephemeris> ephemeris_queue;
+    concurrent_queue<int> channel0_queue;
+    concurrent_queue<int> channel1_queue;
+    std::map<int, concurrent_queue<int>*> channel_queues;
+    channel_queues[0] = &channel0_queue;
+    channel_queues[1] = &channel1_queue;
+
+    Gnss_Event_Loop loop(2);
+    loop.attach<Recorded_Ephemeris>(ephemeris_queue, boost::bind(&Event_Replay::collect_ephemeris, &replay, _1));
+    loop.attach<int>(channel0_queue, boost::bind(&Event_Replay::channel_message, &replay, 0, _1));
+    loop.attach<int>(channel1_queue, boost::bind(&Event_Replay::channel_message, &replay, 1, _1));
+    loop.start();
+
+    boost::thread_group producers;
+    for (std::map<int, std::vector<std::string> >::iterator it = threads.begin(); it != threads.end(); ++it)
+        {
+            producers.create_thread(boost::bind(&replay_thread, &it->second, &ephemeris_queue, &channel_queues));
+        }
+    producers.join_all();
+    loop.detach(ephemeris_queue);
+    loop.detach(channel0_queue);
+    loop.detach(channel1_queue);
+    loop.stop();
+
+    // everything pushed before stop() was handled, and nothing was left queued
+    EXPECT_EQ(events, loop.processed());
+    EXPECT_FALSE(loop.running());
+    EXPECT_TRUE(ephemeris_queue.empty());
+    EXPECT_TRUE(channel0_queue.empty());
+
+    ASSERT_EQ(2, replay.ephemeris.size());
+    EXPECT_EQ(352800.0, replay.ephemeris[12].toe);
+    EXPECT_EQ(1831, replay.ephemeris[25].week);
+    std::vector<int> channel0 = {2, 1, 2};
+    std::vector<int> channel1 = {1, 2, 1};
+    EXPECT_EQ(channel0, replay.channel_messages[0]);
+    EXPECT_EQ(channel1, replay.channel_messages[1]);
+}
+
+
+void count_event(int* counter)
+{
+    (*counter)++;
+}
+
+
+TEST(GnssEventLoop, StopRunsThePostedEvents)
+{
+    int counter = 0;
+    Gnss_Event_Loop loop;
+    for (int i = 0; i < 1000; i++)
+        {
+            loop.post(boost::bind(&count_event, &counter));
+        }
+    EXPECT_EQ(0, counter);   // not started yet
+    loop.start();
+    loop.stop();
+    EXPECT_EQ(1000, counter);
+
+    // posted while stopped: they wait for the next start
+    loop.post(boost::bind(&count_event, &counter));
+    EXPECT_EQ(1000, counter);
+    loop.start();
+    loop.flush();
+    EXPECT_EQ(1001, counter);
+}
+
+
+TEST(GnssEventLoop, DetachedQueueQueuesAgain)
+{
+    int counter = 0;
+    concurrent_queue<int> queue;
+    queue.push(7);
+    Gnss_Event_Loop loop;
+    loop.start();
+    // what was queued before is handed to the loop too
+    loop.attach<int>(queue, boost::bind(&count_event, &counter));
+    queue.push(8);
+    loop.flush();
+    EXPECT_EQ(2, counter);
+    EXPECT_TRUE(queue.empty());
+
+    loop.detach(queue);
+    queue.push(9);
+    loop.flush();
+    EXPECT_EQ(2, counter);
+    int message = 0;
+    EXPECT_TRUE(queue.try_pop(message));
+    EXPECT_EQ(9, message);
+}
+
+
+void append_event(std::vector<int>* trace, int event)
+{
+    trace->push_back(event);
+}
+
+
+void post_sequence(Gnss_Event_Loop* loop, std::vector<int>* trace, int producer, int events)
+{
+    for (int i = 0; i < events; i++)
+        {
+            loop->post(boost::bind(&append_event, trace, producer * events + i));
+        }
+}
+
+
+TEST(GnssEventLoop, ManyProducersKeepTheirOrder)
+{
+    const int producers = 4;
+    const int events = 20000;
+    std::vector<int> trace;   // only written by the loop thread
+    Gnss_Event_Loop loop;
+    loop.start();
+    boost::thread_group threads;
+    for (int p = 0; p < producers; p++)
+        {
+            threads.create_thread(boost::bind(&post_sequence, &loop, &trace, p, events));
+        }
+    threads.join_all();
+    loop.stop();
+
+    ASSERT_EQ(static_cast<unsigned int>(producers * events), trace.size());
+    std::vector<int> last(producers, -1);
+    for (unsigned int i = 0; i < trace.size(); i++)
+        {
+            int producer = trace[i] / events;
+            EXPECT_GT(trace[i], last[producer]);
+            last[producer] = trace[i];
+        }
+    // the loop thread sleeps only when there is nothing left
+    EXPECT_LE(loop.wakeups(), loop.processed());
+}
+
+
+TEST(GnssEventLoop, EveryPostWakesTheLoop)
+{
+    // one event at a time, so that the loop goes to sleep between them: a lost wakeup leaves it asleep
+    int counter = 0;
+    Gnss_Event_Loop loop;
+    loop.start();
+    bool woken = true;
+    for (int i = 0; i < 5000 and woken; i++)
+        {
+            loop.post(boost::bind(&count_event, &counter));
+            boost::posix_time::ptime deadline = boost::posix_time::microsec_clock::universal_time() + boost::posix_time::seconds(1);
+            while (loop.processed() < static_cast<unsigned long long>(i + 1) and woken)
+                {
+                    woken = boost::posix_time::microsec_clock::universal_time() < deadline;
+                }
+        }
+    EXPECT_TRUE(woken);
+    loop.stop();
+    EXPECT_EQ(5000, counter);
+}
@@ -0,0 +1,198 @@
+/*!
+ * \file gnss_latency_test.cc
+ * \brief Implements Unit Tests for the sample clock and the latency histograms.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <map>
+#include <string>
+#include <vector>
+#include "gnss_latency.h"
+
+
+TEST(Gnss_Latency_Test, SampleClock)
+{
+    Gnss_Sample_Clock clock;
+    unsigned long long samples;
+    long long ns;
+    EXPECT_EQ(0, clock.arrival_ns(0));
+    EXPECT_FALSE(clock.latest(samples, ns));
+    clock.record(1000, 10);      // samples 0 to 999 at 10 ns
+    clock.record(3000, 20);      // 1000 to 2999
+    clock.record(3000, 25);      // nothing new
+    clock.record(4000, 30);
+    EXPECT_EQ(10, clock.arrival_ns(0));
+    EXPECT_EQ(10, clock.arrival_ns(999));
+    EXPECT_EQ(20, clock.arrival_ns(1000));
+    EXPECT_EQ(20, clock.arrival_ns(2999));
+    EXPECT_EQ(30, clock.arrival_ns(3000));
+    EXPECT_EQ(0, clock.arrival_ns(4000));   // not arrived yet
+    ASSERT_TRUE(clock.latest(samples, ns));
+    EXPECT_EQ(4000u, samples);
+    EXPECT_EQ(30, ns);
+    clock.reset();
+    EXPECT_EQ(0, clock.arrival_ns(0));
+    EXPECT_FALSE(clock.latest(samples, ns));
+}
+
+
+TEST(Gnss_Latency_Test, SampleClockForgetsOldStamps)
+{
+    Gnss_Sample_Clock clock;
+    for (unsigned long long i = 1; i <= 3 * GNSS_SAMPLE_CLOCK_STAMPS; i++)
+        {
+            clock.record(100 * i, 1000 * i);
+        }
+    unsigned long long last = 3 * GNSS_SAMPLE_CLOCK_STAMPS;
+    EXPECT_EQ(static_cast<long long>(1000 * last), clock.arrival_ns(100 * last - 1));
+    EXPECT_EQ(static_cast<long long>(1000 * (last - 10)), clock.arrival_ns(100 * (last - 10) - 50));
+    EXPECT_EQ(0, clock.arrival_ns(50));   // too old
+}
+
+
+TEST(Gnss_Latency_Test, Histogram)
+{
+    Gnss_Latency_Histogram histogram("test_stage");
+    histogram.add(50000);        // 50 us
+    histogram.add(800000);       // 0.8 ms
+    histogram.add(900000);
+    histogram.add(-5);           // counts as 0
+    histogram.add(20000000000);  // 20 s, beyond the last bound
+    Gnss_Latency_Snapshot s = histogram.snapshot();
+    EXPECT_EQ(5u, s.count);
+    EXPECT_EQ(2u, s.counts[0]);
+    EXPECT_EQ(2u, s.counts[3]);   // up to 1 ms
+    EXPECT_EQ(1u, s.counts[GNSS_LATENCY_BUCKETS]);
+    EXPECT_EQ(20000000000, s.max_ns);
+    EXPECT_EQ(20000000000 + 1750000, s.sum_ns);
+
+    std::string text = gnss_latency_prometheus(std::vector<Gnss_Latency_Snapshot>(1, s));
+    EXPECT_NE(std::string::npos, text.find("# TYPE gnss_sdr_latency_seconds histogram\n"));
+    EXPECT_NE(std::string::npos, text.find("gnss_sdr_latency_seconds_bucket{stage=\"test_stage\",le=\"0.0001\"} 2\n"));
+    EXPECT_NE(std::string::npos, text.find("gnss_sdr_latency_seconds_bucket{stage=\"test_stage\",le=\"0.001\"} 4\n"));
+    EXPECT_NE(std::string::npos, text.find("gnss_sdr_latency_seconds_bucket{stage=\"test_stage\",le=\"10\"} 4\n"));
+    EXPECT_NE(std::string::npos, text.find("gnss_sdr_latency_seconds_bucket{stage=\"test_stage\",le=\"+Inf\"} 5\n"));
+    EXPECT_NE(std::string::npos, text.find("gnss_sdr_latency_seconds_count{stage=\"test_stage\"} 5\n"));
+}
+
+
+TEST(Gnss_Latency_Test, Summary)
+{
+    Gnss_Latency_Histogram histogram("test_summary");
+    Gnss_Latency_Snapshot before = histogram.snapshot();
+    for (int i = 0; i < 99; i++)
+        {
+            histogram.add(2000000);   // 2 ms
+        }
+    histogram.add(300000000);         // 300 ms
+    std::vector<std::string> summary = gnss_latency_summary(std::vector<Gnss_Latency_Snapshot>(1, before),
+            std::vector<Gnss_Latency_Snapshot>(1, histogram.snapshot()));
+    ASSERT_EQ(1u, summary.size());
+    EXPECT_EQ(std::string("test_summary: 100 samples, mean 4.98 ms, p50 <= 2.50 ms, p99 <= 2.50 ms, max 300.00 ms"), summary[0]);
+    // nothing new: no line
+    EXPECT_TRUE(gnss_latency_summary(std::vector<Gnss_Latency_Snapshot>(1, histogram.snapshot()),
+            std::vector<Gnss_Latency_Snapshot>(1, histogram.snapshot())).empty());
+}
+
+
+TEST(Gnss_Latency_Test, AtPvt)
+{
+    std::shared_ptr<Gnss_Latency_Histogram> tracking_to_pvt = gnss_latency_histogram("tracking_to_pvt");
+    std::shared_ptr<Gnss_Latency_Histogram> source_to_tracking = gnss_latency_histogram("source_to_tracking");
+    unsigned long long tracking_before = tracking_to_pvt->snapshot().count;
+    unsigned long long source_before = source_to_tracking->snapshot().count;
+    long long now = gnss_steady_ns();
+    std::map<int, Gnss_Synchro> observables;
+    observables[1] = Gnss_Synchro();
+    observables[1].Sample_arrival_ns = now - 3000000;
+    observables[1].Tracking_output_ns = now - 1000000;
+    observables[2] = Gnss_Synchro();
+    observables[2].Sample_arrival_ns = now - 2000000;
+    observables[2].Tracking_output_ns = now - 1000000;
+    observables[3] = Gnss_Synchro();   // not stamped
+    EXPECT_EQ(now - 2000000, gnss_latency_at_pvt(observables));
+    EXPECT_EQ(tracking_before + 2, tracking_to_pvt->snapshot().count);
+    EXPECT_EQ(source_before + 2, source_to_tracking->snapshot().count);
+}
+
+
+TEST(Gnss_Latency_Test, ChannelProgress)
+{
+    Gnss_Channel_Progress progress;
+    unsigned long long samples;
+    double cn0_db_hz;
+    long long ns;
+    EXPECT_FALSE(progress.get(3, samples, cn0_db_hz, ns));
+    progress.record(3, 4000, 42.5, 100);
+    progress.record(GNSS_LATENCY_CHANNELS, 4000, 42.5, 100);   // out of the table, ignored
+    ASSERT_TRUE(progress.get(3, samples, cn0_db_hz, ns));
+    EXPECT_EQ(4000u, samples);
+    EXPECT_EQ(42.5, cn0_db_hz);
+    EXPECT_EQ(100, ns);
+    EXPECT_FALSE(progress.get(GNSS_LATENCY_CHANNELS, samples, cn0_db_hz, ns));
+
+    EXPECT_FALSE(progress.released(3));
+    progress.release(3);
+    EXPECT_FALSE(progress.released(2));
+    EXPECT_TRUE(progress.released(3));
+    EXPECT_FALSE(progress.released(3));   // only once
+
+    progress.reset();
+    EXPECT_FALSE(progress.get(3, samples, cn0_db_hz, ns));
+}
+
+
+TEST(Gnss_Latency_Test, StampRecordsTheChannel)
+{
+    gnss_sample_clock().reset();
+    gnss_channel_progress().reset();
+    Gnss_Synchro synchro = Gnss_Synchro();
+    synchro.Channel_ID = 5;
+    synchro.CN0_dB_hz = 38.0;
+    gnss_latency_stamp(synchro, 2000);
+    unsigned long long samples;
+    double cn0_db_hz;
+    long long ns;
+    ASSERT_TRUE(gnss_channel_progress().get(5, samples, cn0_db_hz, ns));
+    EXPECT_EQ(2000u, samples);
+    EXPECT_EQ(38.0, cn0_db_hz);
+    EXPECT_EQ(synchro.Tracking_output_ns, ns);
+    gnss_channel_progress().reset();
+}
+
+
+TEST(Gnss_Latency_Test, LateEpochs)
+{
+    long long now = gnss_steady_ns();
+    gnss_latency_set_late_threshold(0.5);
+    EXPECT_FALSE(gnss_latency_late(0));   // unknown arrival
+    EXPECT_FALSE(gnss_latency_late(now));
+    EXPECT_TRUE(gnss_latency_late(now - 2000000000LL));
+    gnss_latency_set_late_threshold(0.0);
+    EXPECT_FALSE(gnss_latency_late(now - 2000000000LL));
+    gnss_latency_set_late_threshold(GNSS_LATENCY_LATE_S);
+}
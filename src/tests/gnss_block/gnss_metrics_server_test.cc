@@ -0,0 +1,79 @@
+/*!
+ * \file gnss_metrics_server_test.cc
+ * \brief Implements Unit Tests for the Gnss_Metrics_Server class with loopback clients.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <string>
+#include <boost/asio.hpp>
+#include <boost/thread.hpp>
+#include "gnss_metrics_server.h"
+
+
+TEST(Gnss_Metrics_Server_Test, GetMetrics)
+{
+    Gnss_Metrics_Server server("127.0.0.1", 0, 0.0);
+    ASSERT_TRUE(server.start());
+    ASSERT_NE(0, server.port());
+    boost::asio::io_service io_service;
+    boost::asio::ip::tcp::socket socket(io_service);
+    socket.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::address::from_string("127.0.0.1"), server.port()));
+    std::string request("GET /metrics HTTP/1.0\r\n\r\n");
+    boost::asio::write(socket, boost::asio::buffer(request));
+    boost::asio::streambuf answer;
+    boost::system::error_code ec;
+    boost::asio::read(socket, answer, ec);   // until the server closes the connection
+    std::string text((std::istreambuf_iterator<char>(&answer)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(0u, text.find("HTTP/1.0 200 OK"));
+    server.stop();
+}
+
+
+TEST(Gnss_Metrics_Server_Test, StopWithIdleClient)
+{
+    Gnss_Metrics_Server server("127.0.0.1", 0, 0.0);
+    ASSERT_TRUE(server.start());
+    boost::asio::io_service io_service;
+    boost::asio::ip::tcp::socket socket(io_service);
+    socket.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::address::from_string("127.0.0.1"), server.port()));
+    boost::this_thread::sleep(boost::posix_time::milliseconds(20));   // accepted, waiting for a request
+
+    // the client never sends its request: stop() must not wait for it
+    boost::thread stopper([&server]() { server.stop(); });
+    EXPECT_TRUE(stopper.timed_join(boost::posix_time::seconds(1)));
+    if (stopper.joinable())
+        {
+            socket.close();
+            stopper.join();
+        }
+
+    // and the server closed the connection
+    char c;
+    boost::system::error_code ec;
+    socket.read_some(boost::asio::buffer(&c, 1), ec);
+    EXPECT_TRUE(ec == boost::asio::error::eof or ec == boost::asio::error::connection_reset);
+}
@@ -0,0 +1,106 @@
+/*!
+ * \file gnss_realtime_monitor_test.cc
+ * \brief Implements Unit Tests for the Gnss_Realtime_Monitor class.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <gnuradio/msg_queue.h>
+#include "gnss_latency.h"
+#include "gnss_realtime_monitor.h"
+
+
+Gnss_Realtime_Check realtime_check(double arrival_rate, double backlog_s)
+{
+    Gnss_Realtime_Check check;
+    check.elapsed_s = 1.0;
+    check.arrival_rate = arrival_rate;
+    check.backlog_s = backlog_s;
+    check.lagging_channel = 0;
+    return check;
+}
+
+
+TEST(Gnss_Realtime_Monitor_Test, ShedsAndRestores)
+{
+    // 2 levels, 0.5 s of backlog, 99 % of the rate, checks every second, restores after 10 s
+    Gnss_Realtime_Monitor monitor(4e6, 8, 2, 0.5, 0.99, 1.0, 10.0, boost::shared_ptr<gr::msg_queue>());
+    EXPECT_EQ(0, monitor.decide(realtime_check(1.0, 0.01), 0.0));
+    EXPECT_EQ(0, monitor.decide(realtime_check(1.0, 0.01), 20.0));   // nothing to restore
+    EXPECT_EQ(1, monitor.decide(realtime_check(0.9, 0.01), 21.0));        // samples lost
+    EXPECT_EQ(1u, monitor.level());
+    EXPECT_EQ(0, monitor.decide(realtime_check(0.9, 0.01), 22.0));        // the flowgraph is given time
+    EXPECT_EQ(1, monitor.decide(realtime_check(1.0, 0.8), 23.0));         // a channel lags behind
+    EXPECT_EQ(2u, monitor.level());
+    EXPECT_EQ(0, monitor.decide(realtime_check(0.5, 2.0), 26.0));         // no level left
+    EXPECT_EQ(2u, monitor.level());
+
+    // between the thresholds, neither shedding nor restoring
+    EXPECT_EQ(0, monitor.decide(realtime_check(1.0, 0.3), 27.0));
+    EXPECT_EQ(0, monitor.decide(realtime_check(1.0, 0.3), 40.0));
+    // healthy for the restore time, one level at a time
+    EXPECT_EQ(0, monitor.decide(realtime_check(1.0, 0.1), 41.0));
+    EXPECT_EQ(0, monitor.decide(realtime_check(1.0, 0.1), 50.0));
+    EXPECT_EQ(-1, monitor.decide(realtime_check(1.0, 0.1), 51.0));
+    EXPECT_EQ(1u, monitor.level());
+    EXPECT_EQ(0, monitor.decide(realtime_check(1.0, 0.1), 55.0));
+    EXPECT_EQ(-1, monitor.decide(realtime_check(1.0, 0.1), 61.0));
+    EXPECT_EQ(0u, monitor.level());
+    EXPECT_EQ(0, monitor.decide(realtime_check(1.0, 0.1), 80.0));
+}
+
+
+TEST(Gnss_Realtime_Monitor_Test, Measure)
+{
+    gnss_sample_clock().reset();
+    gnss_channel_progress().reset();
+    Gnss_Realtime_Monitor monitor(1e6, 4, 1, 0.5, 0.99, 10.0, 30.0, boost::shared_ptr<gr::msg_queue>());
+    Gnss_Realtime_Check check;
+    EXPECT_FALSE(monitor.measure(check));   // the reference
+    EXPECT_FALSE(monitor.measure(check));   // nothing arrived
+    gnss_sample_clock().record(1000000, gnss_steady_ns());
+    gnss_channel_progress().record(1, 900000, 40.0, gnss_steady_ns());
+    gnss_channel_progress().record(2, 400000, 35.0, gnss_steady_ns());
+    gnss_channel_progress().record(3, 100000, 35.0, gnss_steady_ns() - 30000000000LL);   // stale, not tracking
+    ASSERT_TRUE(monitor.measure(check));
+    EXPECT_GT(check.elapsed_s, 0.0);
+    EXPECT_GT(check.arrival_rate, 1.0);   // a million samples in much less than a second
+    EXPECT_EQ(2, check.lagging_channel);
+    EXPECT_NEAR(0.6, check.backlog_s, 1e-9);
+    gnss_sample_clock().reset();
+    gnss_channel_progress().reset();
+}
+
+
+TEST(Gnss_Realtime_Monitor_Test, StartStop)
+{
+    Gnss_Realtime_Monitor monitor(1e6, 4, 1, 0.5, 0.99, 0.01, 30.0, boost::shared_ptr<gr::msg_queue>());
+    monitor.start();
+    boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+    monitor.stop();
+    monitor.stop();
+    EXPECT_EQ(0u, monitor.level());
+}
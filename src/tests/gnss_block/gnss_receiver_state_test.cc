@@ -0,0 +1,188 @@
+/*!
+ * \file gnss_receiver_state_test.cc
+ * \brief Implements Unit Tests for the Gnss_Receiver_State class.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <cmath>
+#include <fstream>
+#include <boost/filesystem.hpp>
+#include "gnss_receiver_state.h"
+
+
+const double state_now_s = 1445000000.0;   // 2015-10-16, UTC seconds since 1970
+const double state_now_gps_s = state_now_s - 315964800.0;
+
+
+// A circular GPS orbit whose reference time is age_s before state_now_s
+Gps_Ephemeris state_test_ephemeris(unsigned int prn, double age_s, double mean_anomaly)
+{
+    Gps_Ephemeris eph;
+    double toe_gps_s = state_now_gps_s - age_s;
+    eph.i_satellite_PRN = prn;
+    eph.i_GPS_week = static_cast<int>(std::floor(toe_gps_s / 604800.0)) % 1024;
+    eph.d_Toe = std::fmod(toe_gps_s, 604800.0);
+    eph.d_Toc = eph.d_Toe;
+    eph.d_sqrt_A = std::sqrt(26560e3);
+    eph.d_e_eccentricity = 0.0;
+    eph.d_i_0 = 0.96;
+    eph.d_OMEGA0 = 1.0;
+    eph.d_M_0 = mean_anomaly;
+    return eph;
+}
+
+
+boost::filesystem::path state_test_file()
+{
+    return boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gnss_state_%%%%%%%%");
+}
+
+
+TEST(GnssReceiverState, SaveAndLoad)
+{
+    Gnss_Receiver_State state;
+    state.gps_ephemeris[5] = state_test_ephemeris(5, 600.0, 0.5);
+    Galileo_Iono iono;
+    iono.ai0_5 = 42.5;
+    state.galileo_iono[0] = iono;
+    state.fix.valid = true;
+    state.fix.latitude_d = 41.27;
+    state.fix.clock_drift_m_s = -12.5;
+    state.saved_time_s = state_now_s;
+
+    boost::filesystem::path file = state_test_file();
+    ASSERT_TRUE(state.save(file.string()));
+    EXPECT_FALSE(boost::filesystem::exists(file.string() + ".tmp"));
+
+    Gnss_Receiver_State loaded;
+    ASSERT_TRUE(loaded.load(file.string()));
+    ASSERT_EQ(1, loaded.gps_ephemeris.size());
+    EXPECT_EQ(state.gps_ephemeris[5].d_Toe, loaded.gps_ephemeris[5].d_Toe);
+    EXPECT_EQ(state.gps_ephemeris[5].d_Toc, loaded.gps_ephemeris[5].d_Toc);
+    EXPECT_EQ(state.gps_ephemeris[5].i_GPS_week, loaded.gps_ephemeris[5].i_GPS_week);
+    EXPECT_EQ(42.5, loaded.galileo_iono[0].ai0_5);
+    EXPECT_TRUE(loaded.fix.valid);
+    EXPECT_EQ(41.27, loaded.fix.latitude_d);
+    EXPECT_EQ(-12.5, loaded.fix.clock_drift_m_s);
+    EXPECT_EQ(state_now_s, loaded.saved_time_s);
+    boost::filesystem::remove(file);
+
+    // nothing to load: cold start
+    EXPECT_FALSE(loaded.load(file.string()));
+    EXPECT_TRUE(loaded.empty());
+}
+
+
+TEST(GnssReceiverState, CorruptedFileIsRejected)
+{
+    Gnss_Receiver_State state;
+    state.gps_ephemeris[5] = state_test_ephemeris(5, 600.0, 0.5);
+    state.gps_ephemeris[7] = state_test_ephemeris(7, 600.0, 1.5);
+    boost::filesystem::path file = state_test_file();
+    ASSERT_TRUE(state.save(file.string()));
+    boost::uintmax_t size = boost::filesystem::file_size(file);
+
+    // one byte of the records changed
+    {
+        std::fstream f(file.string().c_str(), std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(size - 20);
+        f.put('\x5a');
+    }
+    Gnss_Receiver_State loaded;
+    EXPECT_FALSE(loaded.load(file.string()));
+    EXPECT_TRUE(loaded.empty());
+
+    // truncated
+    ASSERT_TRUE(state.save(file.string()));
+    boost::filesystem::resize_file(file, size / 2);
+    EXPECT_FALSE(loaded.load(file.string()));
+
+    // not a state file
+    std::ofstream(file.string().c_str()) << "GNSS-SDR.internal_fs_hz=4000000\n";
+    EXPECT_FALSE(loaded.load(file.string()));
+    EXPECT_TRUE(loaded.empty());
+    boost::filesystem::remove(file);
+}
+
+
+TEST(GnssReceiverState, DiscardStale)
+{
+    Gnss_Receiver_State state;
+    state.gps_ephemeris[5] = state_test_ephemeris(5, 600.0, 0.5);
+    state.gps_ephemeris[7] = state_test_ephemeris(7, 3.0 * 3600.0, 1.5);   // older than 2 h
+    state.gps_ephemeris[9] = state_test_ephemeris(9, -3.0 * 3600.0, 1.5);  // 3 h ahead, a wrong clock
+    Galileo_Ephemeris galileo;
+    double gst_s = state_now_gps_s - 1024 * 604800.0 - 1800.0;
+    galileo.WN_5 = std::floor(gst_s / 604800.0);
+    galileo.t0e_1 = std::fmod(gst_s, 604800.0);
+    state.galileo_ephemeris[11] = galileo;
+    state.gps_almanac[5] = Gps_Almanac();
+    state.fix.valid = true;
+    state.fix.utc_time_s = state_now_s - 3600.0;
+    state.saved_time_s = state_now_s - 3600.0;
+
+    // the ephemeris too far from their reference time
+    EXPECT_EQ(2, state.discard_stale(state_now_s, 7200.0, 86400.0, 86400.0));
+    EXPECT_EQ(1, state.gps_ephemeris.count(5));
+    EXPECT_EQ(1, state.galileo_ephemeris.size());
+    EXPECT_EQ(1, state.gps_almanac.size());
+    EXPECT_TRUE(state.fix.valid);
+
+    // two days later, the almanac and the fix too
+    EXPECT_EQ(4, state.discard_stale(state_now_s + 2 * 86400.0, 7200.0, 86400.0, 86400.0));
+    EXPECT_TRUE(state.gps_almanac.empty());
+    EXPECT_FALSE(state.fix.valid);
+    EXPECT_TRUE(state.empty());
+}
+
+
+TEST(GnssReceiverState, SatellitesInView)
+{
+    Gnss_Receiver_State state;
+    double tow = std::fmod(state_now_gps_s, 604800.0);
+    state.gps_ephemeris[5] = state_test_ephemeris(5, 600.0, 0.5);
+    state.gps_ephemeris[7] = state_test_ephemeris(7, 600.0, 0.5 + M_PI);   // other side of the Earth
+    state.gps_ephemeris[9] = state_test_ephemeris(9, 600.0, 0.7);
+
+    // no fix, no idea
+    EXPECT_TRUE(state.gps_prns_in_view(state_now_s, 5.0).empty());
+
+    // right under PRN 5
+    Gps_Ephemeris eph = state.gps_ephemeris[5];
+    eph.satellitePosition(tow);
+    double r = std::sqrt(eph.d_satpos_X * eph.d_satpos_X + eph.d_satpos_Y * eph.d_satpos_Y + eph.d_satpos_Z * eph.d_satpos_Z);
+    state.fix.valid = true;
+    state.fix.x_m = eph.d_satpos_X / r * 6371e3;
+    state.fix.y_m = eph.d_satpos_Y / r * 6371e3;
+    state.fix.z_m = eph.d_satpos_Z / r * 6371e3;
+    state.fix.latitude_d = std::asin(eph.d_satpos_Z / r) * 180.0 / M_PI;
+    state.fix.longitude_d = std::atan2(eph.d_satpos_Y, eph.d_satpos_X) * 180.0 / M_PI;
+
+    std::vector<unsigned int> in_view = state.gps_prns_in_view(state_now_s, 5.0);
+    std::vector<unsigned int> expected = {5, 9};
+    EXPECT_EQ(expected, in_view);
+}
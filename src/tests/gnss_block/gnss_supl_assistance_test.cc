@@ -0,0 +1,306 @@
+/*!
+ * \file gnss_supl_assistance_test.cc
+ * \brief Implements Unit Tests for the Gnss_Supl_Assistance class.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <map>
+#include <sstream>
+#include <vector>
+#include <boost/archive/xml_iarchive.hpp>
+#include <boost/archive/xml_oarchive.hpp>
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/serialization/map.hpp>
+#include <gnuradio/msg_queue.h>
+#include "concurrent_map.h"
+#include "control_message_factory.h"
+#include "gnss_supl_assistance.h"
+#include "in_memory_configuration.h"
+
+extern concurrent_map<Gps_Ephemeris> global_gps_ephemeris_map;
+extern concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
+extern concurrent_map<Gps_Ref_Location> global_gps_ref_location_map;
+
+
+// Stand-in SUPL server: after delay_ms, answers each connection with bytes that are not TLS
+void supl_test_server(boost::asio::io_service* io_service, boost::asio::ip::tcp::acceptor* acceptor, int connections, int delay_ms)
+{
+    for (int i = 0; i < connections; i++)
+        {
+            boost::asio::ip::tcp::socket socket(*io_service);
+            acceptor->accept(socket);
+            boost::this_thread::sleep(boost::posix_time::milliseconds(delay_ms));
+            boost::system::error_code error;
+            boost::asio::write(socket, boost::asio::buffer(std::string("HTTP/1.0 400 Bad Request\r\n\r\n")), error);
+            char buffer[256];
+            while (not error)
+                {
+                    socket.read_some(boost::asio::buffer(buffer), error);   // until the client gives up
+                }
+        }
+}
+
+
+// Stand-in answers of the servers, for GPS PRN 29
+int supl_test_answer(gnss_sdr_supl_client& client, int request)
+{
+    if (request == 1)
+        {
+            Gps_Ephemeris eph;
+            eph.i_satellite_PRN = 29;
+            eph.i_GPS_week = 850;
+            eph.d_Toe = 7200.0;
+            client.gps_ephemeris_map[29] = eph;
+        }
+    else if (request == 0)
+        {
+            Gps_Almanac almanac;
+            almanac.i_satellite_PRN = 29;
+            client.gps_almanac_map[29] = almanac;
+        }
+    else
+        {
+            Gps_Acq_Assist acq;
+            acq.i_satellite_PRN = 29;
+            acq.Elevation = 61.0;
+            client.gps_acq_map[29] = acq;
+            client.gps_ref_loc.valid = true;
+            client.gps_ref_loc.lat = 41.27;
+            client.gps_ref_loc.lon = 1.99;
+        }
+    return 0;
+}
+
+
+int supl_test_failure(gnss_sdr_supl_client& client, int request, std::vector<int>* requests)
+{
+    requests->push_back(request);
+    return -1;
+}
+
+
+// Control messages in the queue, as who * 10 + what
+std::vector<unsigned int> supl_test_messages(boost::shared_ptr<gr::msg_queue> queue)
+{
+    std::vector<unsigned int> messages;
+    ControlMessageFactory factory;
+    while (queue->count() > 0)
+        {
+            std::shared_ptr<std::vector<std::shared_ptr<ControlMessage>>> control = factory.GetControlMessages(queue->delete_head_nowait());
+            for (unsigned int i = 0; i < control->size(); i++)
+                {
+                    messages.push_back(control->at(i)->who * 10 + control->at(i)->what);
+                }
+        }
+    return messages;
+}
+
+
+bool supl_test_wait(Gnss_Supl_Assistance& assistance, double timeout_s)
+{
+    boost::chrono::steady_clock::time_point end = boost::chrono::steady_clock::now() + boost::chrono::milliseconds(static_cast<long>(timeout_s * 1000));
+    while (not assistance.finished() and boost::chrono::steady_clock::now() < end)
+        {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+        }
+    return assistance.finished();
+}
+
+
+std::shared_ptr<InMemoryConfiguration> supl_test_configuration(const std::string& cache_file)
+{
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("GNSS-SDR.SUPL_gps_ephemeris_server", "127.0.0.1");
+    config->set_property("GNSS-SDR.SUPL_gps_acquisition_server", "127.0.0.1");
+    config->set_property("GNSS-SDR.SUPL_cache_file", cache_file);
+    config->set_property("GNSS-SDR.SUPL_retry_period_s", "0");
+    return config;
+}
+
+
+TEST(GnssSuplAssistance, SlowServerDoesNotHoldBackStart)
+{
+    // the SUPL client always connects to port 7275
+    boost::asio::io_service io_service;
+    boost::asio::ip::tcp::acceptor acceptor(io_service, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 7275));
+    boost::thread server(&supl_test_server, &io_service, &acceptor, 3, 500);
+
+    boost::shared_ptr<gr::msg_queue> queue = gr::msg_queue::make(0);
+    Gnss_Supl_Assistance assistance(supl_test_configuration(""), queue);
+    boost::chrono::steady_clock::time_point begin = boost::chrono::steady_clock::now();
+    assistance.start();
+    EXPECT_LT(boost::chrono::steady_clock::now() - begin, boost::chrono::milliseconds(200));
+    EXPECT_FALSE(assistance.finished());
+
+    // the three requests fail, nothing is published: the receiver is told once to read its ephemeris XML file
+    EXPECT_TRUE(supl_test_wait(assistance, 10.0));
+    EXPECT_EQ(0, assistance.received());
+    std::vector<unsigned int> expected = {GNSS_SUPL_ASSISTANCE_ID * 10 + GNSS_SUPL_EPHEMERIS_FAILED};
+    EXPECT_EQ(expected, supl_test_messages(queue));
+    server.join();
+}
+
+
+TEST(GnssSuplAssistance, StopLeavesAStalledRequestBehind)
+{
+    boost::asio::io_service io_service;
+    boost::asio::ip::tcp::acceptor acceptor(io_service, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 7275));
+    boost::thread server(&supl_test_server, &io_service, &acceptor, 1, 3000);
+
+    boost::shared_ptr<gr::msg_queue> queue = gr::msg_queue::make(0);
+    Gnss_Supl_Assistance assistance(supl_test_configuration(""), queue);
+    assistance.start();
+    boost::this_thread::sleep(boost::posix_time::milliseconds(200));
+    boost::chrono::steady_clock::time_point begin = boost::chrono::steady_clock::now();
+    assistance.stop();
+    EXPECT_LT(boost::chrono::steady_clock::now() - begin, boost::chrono::milliseconds(2000));
+
+    // the request left behind ends with the server, and asks nothing else
+    server.join();
+    EXPECT_TRUE(supl_test_wait(assistance, 10.0));
+    EXPECT_EQ(0, assistance.received());
+    EXPECT_EQ(0, queue->count());
+}
+
+
+TEST(GnssSuplAssistance, AnswersArePublishedAndCached)
+{
+    boost::filesystem::path cache = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gnss_supl_%%%%%%%%.xml");
+    boost::shared_ptr<gr::msg_queue> queue = gr::msg_queue::make(0);
+    {
+        Gnss_Supl_Assistance assistance(supl_test_configuration(cache.string()), queue);
+        assistance.set_fetcher(boost::bind(&supl_test_answer, _1, _2));
+        assistance.start();
+        ASSERT_TRUE(supl_test_wait(assistance, 10.0));
+        EXPECT_EQ(3, assistance.received());
+    }
+    Gps_Ephemeris eph;
+    ASSERT_TRUE(global_gps_ephemeris_map.read(29, eph));
+    EXPECT_EQ(7200.0, eph.d_Toe);
+    Gps_Acq_Assist acq;
+    ASSERT_TRUE(global_gps_acq_assist_map.read(29, acq));
+    EXPECT_EQ(61.0, acq.Elevation);
+    Gps_Ref_Location ref_location;
+    ASSERT_TRUE(global_gps_ref_location_map.read(0, ref_location));
+    EXPECT_EQ(41.27, ref_location.lat);
+    std::vector<unsigned int> expected = {5001, 5000, 5002};
+    EXPECT_EQ(expected, supl_test_messages(queue));
+    EXPECT_TRUE(boost::filesystem::exists(cache));
+
+    // next start: the servers are not reachable, the cache is used at once
+    eph.d_Toe = 0.0;
+    global_gps_ephemeris_map.write(29, eph);
+    acq.Elevation = 0.0;
+    global_gps_acq_assist_map.write(29, acq);
+    std::vector<int> requests;
+    {
+        Gnss_Supl_Assistance assistance(supl_test_configuration(cache.string()), queue);
+        assistance.set_fetcher(boost::bind(&supl_test_failure, _1, _2, &requests));
+        assistance.start();
+        EXPECT_TRUE(assistance.finished());
+    }
+    EXPECT_TRUE(requests.empty());
+    ASSERT_TRUE(global_gps_ephemeris_map.read(29, eph));
+    EXPECT_EQ(7200.0, eph.d_Toe);
+    ASSERT_TRUE(global_gps_acq_assist_map.read(29, acq));
+    EXPECT_EQ(61.0, acq.Elevation);
+    EXPECT_EQ(3, supl_test_messages(queue).size());
+
+    // an expired part is asked again
+    std::shared_ptr<InMemoryConfiguration> config = supl_test_configuration(cache.string());
+    config->set_property("GNSS-SDR.SUPL_acquisition_max_age_s", "-1");
+    {
+        Gnss_Supl_Assistance assistance(config, queue);
+        assistance.set_fetcher(boost::bind(&supl_test_failure, _1, _2, &requests));
+        assistance.start();
+        ASSERT_TRUE(supl_test_wait(assistance, 10.0));
+        EXPECT_EQ(0, assistance.received());
+    }
+    std::vector<int> expected_requests = {2};
+    EXPECT_EQ(expected_requests, requests);
+    expected = {5000, 5001};
+    EXPECT_EQ(expected, supl_test_messages(queue));
+    boost::filesystem::remove(cache);
+}
+
+
+// gps_iono.xml as written before Gps_Iono had a valid flag
+const char* iono_xml_version_0 =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\" ?>\n"
+        "<!DOCTYPE boost_serialization>\n"
+        "<boost_serialization signature=\"serialization::archive\" version=\"10\">\n"
+        "<GNSS-SDR_iono_map class_id=\"0\" tracking_level=\"0\" version=\"0\">\n"
+        "<count>1</count>\n"
+        "<item_version>0</item_version>\n"
+        "<item class_id=\"1\" tracking_level=\"0\" version=\"0\">\n"
+        "<first>0</first>\n"
+        "<second class_id=\"2\" tracking_level=\"0\" version=\"0\">\n"
+        "<d_alpha0>1.1e-08</d_alpha0>\n"
+        "<d_alpha1>0</d_alpha1>\n"
+        "<d_alpha2>0</d_alpha2>\n"
+        "<d_alpha3>0</d_alpha3>\n"
+        "<d_beta0>90112</d_beta0>\n"
+        "<d_beta1>0</d_beta1>\n"
+        "<d_beta2>0</d_beta2>\n"
+        "<d_beta3>0</d_beta3>\n"
+        "</second>\n"
+        "</item>\n"
+        "</GNSS-SDR_iono_map>\n"
+        "</boost_serialization>\n";
+
+
+TEST(GnssSuplAssistance, OldIonoXmlStillLoads)
+{
+    std::map<int, Gps_Iono> iono_map;
+    std::istringstream old_xml(iono_xml_version_0);
+    {
+        boost::archive::xml_iarchive xml(old_xml);
+        xml >> boost::serialization::make_nvp("GNSS-SDR_iono_map", iono_map);
+    }
+    ASSERT_EQ(1u, iono_map.size());
+    EXPECT_EQ(1.1e-8, iono_map[0].d_alpha0);
+    EXPECT_EQ(90112.0, iono_map[0].d_beta0);
+    EXPECT_TRUE(iono_map[0].valid);
+
+    // the flag is kept by the files written now
+    iono_map[0].valid = false;
+    std::ostringstream out;
+    {
+        boost::archive::xml_oarchive xml(out);
+        xml << boost::serialization::make_nvp("GNSS-SDR_iono_map", iono_map);
+    }
+    std::map<int, Gps_Iono> read_map;
+    std::istringstream in(out.str());
+    {
+        boost::archive::xml_iarchive xml(in);
+        xml >> boost::serialization::make_nvp("GNSS-SDR_iono_map", read_map);
+    }
+    EXPECT_FALSE(read_map[0].valid);
+}
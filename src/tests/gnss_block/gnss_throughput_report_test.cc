@@ -0,0 +1,129 @@
+/*!
+ * \file gnss_throughput_report_test.cc
+ * \brief Implements Unit Tests for the throughput reports of gnss-sdr-throughput.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/archive/xml_iarchive.hpp>
+#include <boost/archive/xml_oarchive.hpp>
+#include "gnss_throughput_report.h"
+
+
+Gnss_Block_Counters_Snapshot throughput_test_snapshot(const std::string& name, long id, unsigned long long work_ns)
+{
+    Gnss_Block_Counters_Snapshot s = Gnss_Block_Counters_Snapshot();
+    s.name = name;
+    s.id = id;
+    s.work_ns = work_ns;
+    return s;
+}
+
+
+TEST(Gnss_Throughput_Report_Test, BlocksAreGroupedByKind)
+{
+    std::vector<Gnss_Block_Counters_Snapshot> before;
+    before.push_back(throughput_test_snapshot("tracking", 1, 1000000000));
+    before.push_back(throughput_test_snapshot("tracking", 2, 0));
+    before.push_back(throughput_test_snapshot("pvt", 3, 0));
+    std::vector<Gnss_Block_Counters_Snapshot> after;
+    after.push_back(throughput_test_snapshot("tracking", 1, 3000000000));
+    after.push_back(throughput_test_snapshot("tracking", 2, 1500000000));
+    after.push_back(throughput_test_snapshot("pvt", 3, 250000000));
+    after.push_back(throughput_test_snapshot("acquisition", 4, 500000000));   // created in between
+
+    std::vector<Gnss_Throughput_Block> blocks = gnss_throughput_blocks(before, after);
+    ASSERT_EQ(3u, blocks.size());
+    EXPECT_EQ("tracking", blocks[0].name);
+    EXPECT_EQ(2u, blocks[0].instances);
+    EXPECT_DOUBLE_EQ(3.5, blocks[0].work_s);
+    EXPECT_EQ("acquisition", blocks[1].name);
+    EXPECT_DOUBLE_EQ(0.5, blocks[1].work_s);
+    EXPECT_EQ("pvt", blocks[2].name);
+    EXPECT_DOUBLE_EQ(0.25, blocks[2].work_s);
+}
+
+
+TEST(Gnss_Throughput_Report_Test, Json)
+{
+    std::vector<Gnss_Throughput_Report> reports(2);
+    reports[0].name = "gps \"l1\"";
+    reports[0].ok = true;
+    reports[0].signal_s = 60.0;
+    reports[0].wall_s = 15.0;
+    reports[0].ttff_s = 32.5;
+    Gnss_Throughput_Block tracking = {"tracking", 8, 6.0};
+    Gnss_Throughput_Block pvt = {"pvt", 1, 2.0};
+    reports[0].blocks.push_back(tracking);
+    reports[0].blocks.push_back(pvt);
+    std::string json = gnss_throughput_json(reports);
+
+    EXPECT_EQ('[', json[0]);
+    EXPECT_NE(std::string::npos, json.find("\"name\": \"gps \\\"l1\\\"\""));
+    EXPECT_NE(std::string::npos, json.find("\"realtime_factor\": 4,"));
+    EXPECT_NE(std::string::npos, json.find("\"ttff_s\": 32.5,"));
+    EXPECT_NE(std::string::npos, json.find("\"ttff_wall_s\": null,"));
+    EXPECT_NE(std::string::npos, json.find("{\"name\": \"tracking\", \"instances\": 8, \"work_s\": 6, \"cpu_share\": 0.75, \"cores\": 0.4}"));
+    // the run that did not start has no rate
+    EXPECT_NE(std::string::npos, json.find("\"realtime_factor\": null,"));
+    EXPECT_NE(std::string::npos, json.find("\"blocks\": []"));
+    EXPECT_EQ("[]\n", gnss_throughput_json(std::vector<Gnss_Throughput_Report>()));
+}
+
+
+TEST(Gnss_Throughput_Report_Test, Serialization)
+{
+    Gnss_Throughput_Report report;
+    report.name = "run";
+    report.ok = true;
+    report.fs_hz = 4e6;
+    report.signal_s = 12.5;
+    report.ttff_wall_s = 1.25;
+    Gnss_Throughput_Block block = {"tracking", 4, 0.5};
+    report.blocks.push_back(block);
+    std::ostringstream out;
+    {
+        boost::archive::xml_oarchive archive(out);
+        archive << boost::serialization::make_nvp("report", report);
+    }
+    Gnss_Throughput_Report read;
+    std::istringstream in(out.str());
+    {
+        boost::archive::xml_iarchive archive(in);
+        archive >> boost::serialization::make_nvp("report", read);
+    }
+    EXPECT_EQ("run", read.name);
+    EXPECT_TRUE(read.ok);
+    EXPECT_EQ(12.5, read.signal_s);
+    EXPECT_EQ(-1.0, read.ttff_s);
+    EXPECT_EQ(1.25, read.ttff_wall_s);
+    ASSERT_EQ(1u, read.blocks.size());
+    EXPECT_EQ("tracking", read.blocks[0].name);
+    EXPECT_EQ(4u, read.blocks[0].instances);
+}
@@ -215,6 +215,9 @@ TEST_F(GpsL1CaPcpsAcquisitionTest, ValidationOfResults)
 
     start_queue();
 
+    acquisition->init();
+    acquisition->release();   // as a parked channel: the grid is freed, twice is harmless
+    acquisition->release();
     acquisition->init();
     acquisition->reset();
 
@@ -0,0 +1,185 @@
+/*!
+ * \file ls_pvt_solver_test.cc
+ * \brief  This file implements unit tests for the Ls_Pvt_Solver class.
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include "ls_pvt_armadillo.h"
+#include "ls_pvt_solver.h"
+
+
+// Fills the solver with error-free pseudoranges from 7 satellites seen from rx (ECEF) with clock offset clk_m
+template<class Solver>
+void ls_pvt_solver_test_observations(Solver& solver, const double rx[3], double clk_m)
+{
+    const double az[7] = {10.0, 70.0, 130.0, 190.0, 250.0, 310.0, 0.0};
+    const double el[7] = {15.0, 40.0, 25.0, 60.0, 35.0, 20.0, 85.0};
+    double phi, lambda, h;
+    Ls_Pvt_Solver<12>::togeod(&phi, &lambda, &h, 6378137.0, 298.257223563, rx[0], rx[1], rx[2]);
+    double sb = std::sin(phi * GPS_PI / 180.0);
+    double cb = std::cos(phi * GPS_PI / 180.0);
+    double sl = std::sin(lambda * GPS_PI / 180.0);
+    double cl = std::cos(lambda * GPS_PI / 180.0);
+    solver.clear();
+    for (int i = 0; i < 7; i++)
+        {
+            // line of sight in ENU, rotated to ECEF, and scaled to reach the GPS orbit radius
+            double e = std::cos(el[i] * GPS_PI / 180.0) * std::sin(az[i] * GPS_PI / 180.0);
+            double n = std::cos(el[i] * GPS_PI / 180.0) * std::cos(az[i] * GPS_PI / 180.0);
+            double u = std::sin(el[i] * GPS_PI / 180.0);
+            double los[3] = {-sl * e - sb * cl * n + cb * cl * u, cl * e - sb * sl * n + cb * sl * u, cb * n + sb * u};
+            double p = rx[0] * los[0] + rx[1] * los[1] + rx[2] * los[2];
+            double r2 = rx[0] * rx[0] + rx[1] * rx[1] + rx[2] * rx[2];
+            double range = -p + std::sqrt(p * p - r2 + 26560.0e3 * 26560.0e3);
+            double sat[3] = {rx[0] + range * los[0], rx[1] + range * los[1], rx[2] + range * los[2]};
+            // same Earth rotation correction as the solver
+            double rot[3];
+            Ls_Pvt_Solver<12>::rotate_satellite(range / GPS_C_m_s, sat, rot);
+            double d0 = rot[0] - rx[0];
+            double d1 = rot[1] - rx[1];
+            double d2 = rot[2] - rx[2];
+            solver.add_observation(sat[0], sat[1], sat[2], std::sqrt(d0 * d0 + d1 * d1 + d2 * d2) + clk_m, 1.0);
+        }
+}
+
+
+TEST(Ls_Pvt_Solver_Test, ConvergesToTruth)
+{
+    Ls_Pvt_Solver<12> solver;
+    solver.tropo_enabled = false;
+    const double rx[3] = {4796983.5, 160308.8, 4187384.3};
+    ls_pvt_solver_test_observations(solver, rx, 12345.6);
+    double pos[4];
+    ASSERT_TRUE(solver.solve(pos));
+    EXPECT_NEAR(rx[0], pos[0], 1e-3);
+    EXPECT_NEAR(rx[1], pos[1], 1e-3);
+    EXPECT_NEAR(rx[2], pos[2], 1e-3);
+    EXPECT_NEAR(12345.6, pos[3], 1e-3);
+    for (int i = 0; i < solver.size(); i++)
+        {
+            EXPECT_GT(solver.el_deg[i], 0.0);
+            EXPECT_GT(solver.distance_m[i], 19.0e6);
+        }
+    for (int r = 0; r < 4; r++)
+        {
+            EXPECT_GT(solver.Q[r][r], 0.0);
+            for (int c = 0; c < 4; c++) EXPECT_NEAR(solver.Q[r][c], solver.Q[c][r], 1e-12);
+        }
+}
+
+
+TEST(Ls_Pvt_Solver_Test, WarmStartConvergesFaster)
+{
+    Ls_Pvt_Solver<12> solver;
+    solver.tropo_enabled = false;
+    double rx[3] = {4796983.5, 160308.8, 4187384.3};
+    double pos[4];
+    ls_pvt_solver_test_observations(solver, rx, 0.0);
+    ASSERT_TRUE(solver.solve(pos));
+    int cold_iterations = solver.iterations;
+
+    rx[0] += 10.0;
+    rx[2] -= 5.0;
+    ls_pvt_solver_test_observations(solver, rx, 3.0);
+    ASSERT_TRUE(solver.solve(pos));
+    EXPECT_LT(solver.iterations, cold_iterations);
+    EXPECT_NEAR(rx[0], pos[0], 1e-3);
+    EXPECT_NEAR(rx[1], pos[1], 1e-3);
+    EXPECT_NEAR(rx[2], pos[2], 1e-3);
+    EXPECT_NEAR(3.0, pos[3], 1e-3);
+}
+
+
+TEST(Ls_Pvt_Solver_Test, TroposphereIsAppliedAtConvergence)
+{
+    // with the troposphere model enabled, the error-free ranges make the solver move the position
+    // by no more than a few meters, mostly in height and clock
+    Ls_Pvt_Solver<12> solver;
+    const double rx[3] = {4796983.5, 160308.8, 4187384.3};
+    ls_pvt_solver_test_observations(solver, rx, 0.0);
+    double pos[4];
+    ASSERT_TRUE(solver.solve(pos));
+    double dx = pos[0] - rx[0];
+    double dy = pos[1] - rx[1];
+    double dz = pos[2] - rx[2];
+    double error = std::sqrt(dx * dx + dy * dy + dz * dz);
+    EXPECT_GT(error, 0.01);
+    EXPECT_LT(error, 20.0);
+}
+
+
+TEST(Ls_Pvt_Solver_Test, BoundedObservations)
+{
+    Ls_Pvt_Solver<4> solver;
+    double pos[4];
+    for (int i = 0; i < 3; i++)
+        {
+            EXPECT_TRUE(solver.add_observation(2.0e7 * i, 1.0e7, 1.0e7, 2.2e7, 1.0));
+        }
+    EXPECT_FALSE(solver.solve(pos));
+    EXPECT_TRUE(solver.add_observation(-2.0e7, 1.0e7, 1.0e7, 2.2e7, 1.0));
+    EXPECT_FALSE(solver.add_observation(0.0, 2.0e7, 1.0e7, 2.2e7, 1.0));
+    EXPECT_EQ(4, solver.size());
+    solver.clear();
+    EXPECT_EQ(0, solver.size());
+}
+
+
+TEST(Ls_Pvt_Solver_Test, MatchesArmadilloSolver)
+{
+    // the former solver (positioning_mode=LS_ARMADILLO) and the new one converge to the same fix
+    const double rx[3] = {4796983.5, 160308.8, 4187384.3};
+    for (int tropo = 0; tropo < 2; tropo++)
+        {
+            Ls_Pvt_Solver<12> solver;
+            Ls_Pvt_Armadillo<12> armadillo;
+            solver.tropo_enabled = (tropo == 1);
+            armadillo.tropo_enabled = (tropo == 1);
+            ls_pvt_solver_test_observations(solver, rx, 12345.6);
+            ls_pvt_solver_test_observations(armadillo, rx, 12345.6);
+            double pos[4];
+            double armadillo_pos[4];
+            ASSERT_TRUE(solver.solve(pos));
+            ASSERT_TRUE(armadillo.solve(armadillo_pos));
+            for (int k = 0; k < 4; k++)
+                {
+                    EXPECT_NEAR(armadillo_pos[k], pos[k], 1e-3);
+                }
+            for (int i = 0; i < solver.size(); i++)
+                {
+                    EXPECT_NEAR(armadillo.az_deg[i], solver.az_deg[i], 1e-6);
+                    EXPECT_NEAR(armadillo.el_deg[i], solver.el_deg[i], 1e-6);
+                    EXPECT_NEAR(armadillo.distance_m[i], solver.distance_m[i], 1e-3);
+                }
+            // the former design matrix is divided by the pseudoranges, not by the ranges
+            for (int r = 0; r < 4; r++)
+                {
+                    EXPECT_NEAR(armadillo.Q[r][r], solver.Q[r][r], 1e-2 * solver.Q[r][r]);
+                }
+        }
+}
@@ -0,0 +1,124 @@
+/*!
+ * \file mmap_file_signal_source_test.cc
+ * \brief Implements Unit Tests for the Mmap_Sample_File and
+ * MmapFileSignalSource classes.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <gnuradio/msg_queue.h>
+#include <gtest/gtest.h>
+#include "mmap_file_signal_source.h"
+#include "mmap_sample_file.h"
+#include "in_memory_configuration.h"
+
+
+TEST(Mmap_Sample_File_Test, ReadItems)
+{
+    std::string filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("mmap_samples_%%%%%%.dat")).string();
+    // 40 MB of shorts, larger than the read-ahead window
+    std::vector<short> samples(20 * 1024 * 1024);
+    for (unsigned int i = 0; i < samples.size(); i++)
+        {
+            samples[i] = static_cast<short>(i % 32749);
+        }
+    std::FILE* f = std::fopen(filename.c_str(), "wb");
+    ASSERT_TRUE(f != nullptr);
+    std::fwrite(samples.data(), sizeof(short), samples.size(), f);
+    // one byte more than a whole number of items
+    std::fputc(0, f);
+    std::fclose(f);
+
+    Mmap_Sample_File file;
+    ASSERT_TRUE(file.open(filename, sizeof(short)));
+    EXPECT_EQ(samples.size(), file.items());
+
+    bool all_equal = true;
+    for (unsigned long long i = 0; i < file.items(); i += 4096)
+        {
+            if (std::memcmp(file.data(i), &samples[i], 4096 * sizeof(short)) != 0) all_equal = false;
+        }
+    EXPECT_TRUE(all_equal);
+    EXPECT_GT(file.read_ahead_requests(), 1u);
+
+    // random access
+    short value;
+    std::memcpy(&value, file.data(123457), sizeof(short));
+    EXPECT_EQ(samples[123457], value);
+    file.close();
+    EXPECT_FALSE(file.is_open());
+    std::remove(filename.c_str());
+}
+
+
+TEST(Mmap_Sample_File_Test, FileNotExists)
+{
+    Mmap_Sample_File file;
+    EXPECT_FALSE(file.open("./signal_samples/i_dont_exist.dat", sizeof(short)));
+    EXPECT_FALSE(file.is_open());
+}
+
+
+TEST(MmapFileSignalSource, InstantiateWithSeek)
+{
+    boost::shared_ptr<gr::msg_queue> queue = gr::msg_queue::make(0);
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+
+    config->set_property("Test.samples", "0");
+    config->set_property("Test.sampling_frequency", "4000000");
+    config->set_property("Test.seek_s", "0.001");
+    std::string path = std::string(TEST_PATH);
+    std::string filename = path + "signal_samples/GPS_L1_CA_ID_1_Fs_4Msps_2ms.dat";
+    config->set_property("Test.filename", filename);
+    config->set_property("Test.item_type", "gr_complex");
+    config->set_property("Test.repeat", "false");
+
+    std::unique_ptr<MmapFileSignalSource> signal_source(new MmapFileSignalSource(config.get(), "Test", 1, 1, queue));
+
+    EXPECT_STREQ("gr_complex", signal_source->item_type().c_str());
+    EXPECT_STREQ("Mmap_File_Signal_Source", signal_source->implementation().c_str());
+    EXPECT_EQ(4000u, signal_source->first_item());
+}
+
+
+TEST(MmapFileSignalSource, InstantiateFileNotExists)
+{
+    boost::shared_ptr<gr::msg_queue> queue = gr::msg_queue::make(0);
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+
+    config->set_property("Test.samples", "0");
+    config->set_property("Test.sampling_frequency", "0");
+    config->set_property("Test.filename", "./signal_samples/i_dont_exist.dat");
+    config->set_property("Test.item_type", "gr_complex");
+    config->set_property("Test.repeat", "false");
+
+    EXPECT_THROW({auto uptr = std::make_shared<MmapFileSignalSource>(config.get(), "Test", 1, 1, queue);}, std::exception);
+}
@@ -0,0 +1,200 @@
+/*!
+ * \file multi_file_signal_source_test.cc
+ * \brief Implements Unit Tests for the Sample_File_Sequence and the
+ * MultiFileSignalSource classes.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <gnuradio/msg_queue.h>
+#include <gtest/gtest.h>
+#include "multi_file_signal_source.h"
+#include "sample_file_sequence.h"
+#include "in_memory_configuration.h"
+
+
+// Splits a ramp of bytes in files of the given sizes, in a new directory
+std::vector<char> write_file_sequence(const boost::filesystem::path& directory, const std::vector<std::size_t>& sizes)
+{
+    boost::filesystem::remove_all(directory);
+    boost::filesystem::create_directories(directory);
+    std::vector<char> all;
+    for (unsigned int i = 0; i < sizes.size(); i++)
+        {
+            std::vector<char> data(sizes[i]);
+            for (std::size_t k = 0; k < sizes[i]; k++)
+                {
+                    data[k] = static_cast<char>((all.size() + k) * 7 + i);
+                }
+            std::string name = (directory / ("capture_" + std::to_string(i) + ".dat")).string();
+            std::FILE* file = std::fopen(name.c_str(), "wb");
+            std::fwrite(data.data(), 1, data.size(), file);
+            std::fclose(file);
+            all.insert(all.end(), data.begin(), data.end());
+        }
+    return all;
+}
+
+
+TEST(Sample_File_Sequence_Test, Expand)
+{
+    boost::filesystem::path directory = boost::filesystem::temp_directory_path() / "sample_file_sequence_expand";
+    std::vector<std::size_t> sizes = {10, 10, 10};
+    write_file_sequence(directory, sizes);
+    std::string d = directory.string();
+
+    std::vector<std::string> filenames = Sample_File_Sequence::expand(d + "/capture_*.dat");
+    ASSERT_EQ(3u, filenames.size());
+    EXPECT_EQ(d + "/capture_0.dat", filenames[0]);
+    EXPECT_EQ(d + "/capture_2.dat", filenames[2]);
+
+    // the entries of a list keep their order
+    filenames = Sample_File_Sequence::expand(d + "/capture_2.dat, " + d + "/capture_[01].dat");
+    ASSERT_EQ(3u, filenames.size());
+    EXPECT_EQ(d + "/capture_2.dat", filenames[0]);
+    EXPECT_EQ(d + "/capture_0.dat", filenames[1]);
+    EXPECT_EQ(d + "/capture_1.dat", filenames[2]);
+
+    EXPECT_TRUE(Sample_File_Sequence::expand(d + "/nothing_*.dat").empty());
+    boost::filesystem::remove_all(directory);
+}
+
+
+TEST(Sample_File_Sequence_Test, ExpandNaturalOrder)
+{
+    boost::filesystem::path directory = boost::filesystem::temp_directory_path() / "sample_file_sequence_natural";
+    std::vector<std::size_t> sizes(12, 1);
+    write_file_sequence(directory, sizes);   // capture_0.dat to capture_11.dat
+    std::string d = directory.string();
+
+    std::vector<std::string> filenames = Sample_File_Sequence::expand(d + "/capture_*.dat");
+    ASSERT_EQ(12u, filenames.size());
+    for (unsigned int i = 0; i < filenames.size(); i++)
+        {
+            EXPECT_EQ(d + "/capture_" + std::to_string(i) + ".dat", filenames[i]);
+        }
+
+    // zero padded names keep their order, and sort after the unpadded ones of the same value
+    std::FILE* file = std::fopen((d + "/capture_02.dat").c_str(), "wb");
+    std::fclose(file);
+    filenames = Sample_File_Sequence::expand(d + "/capture_?.dat " + d + "/capture_0?.dat");
+    ASSERT_EQ(11u, filenames.size());
+    EXPECT_EQ(d + "/capture_9.dat", filenames[9]);
+    EXPECT_EQ(d + "/capture_02.dat", filenames[10]);
+    filenames = Sample_File_Sequence::expand(d + "/capture_*.dat");
+    ASSERT_EQ(13u, filenames.size());
+    EXPECT_EQ(d + "/capture_2.dat", filenames[2]);
+    EXPECT_EQ(d + "/capture_02.dat", filenames[3]);
+    EXPECT_EQ(d + "/capture_3.dat", filenames[4]);
+    EXPECT_EQ(d + "/capture_11.dat", filenames[12]);
+    boost::filesystem::remove_all(directory);
+}
+
+
+TEST(Sample_File_Sequence_Test, ReadAcrossFiles)
+{
+    boost::filesystem::path directory = boost::filesystem::temp_directory_path() / "sample_file_sequence_read";
+    // files larger and smaller than a block, and an empty one
+    std::vector<std::size_t> sizes = {SAMPLE_FILE_SEQUENCE_BLOCK_BYTES + 3, 1001, 0, 2 * SAMPLE_FILE_SEQUENCE_BLOCK_BYTES, 5};
+    std::vector<char> expected = write_file_sequence(directory, sizes);
+
+    Sample_File_Sequence files;
+    ASSERT_TRUE(files.open(Sample_File_Sequence::expand(directory.string() + "/*.dat"), 2));
+    EXPECT_EQ(expected.size(), files.total_bytes());
+    std::vector<char> read(expected.size() + 100);
+    std::size_t nbytes = 0;
+    std::size_t n;
+    while ((n = files.read(read.data() + nbytes, 999983)) > 0)
+        {
+            nbytes += n;
+        }
+    EXPECT_EQ(expected.size(), nbytes);
+    EXPECT_EQ(nbytes, files.bytes_read());
+    EXPECT_EQ(4u, files.current_file());
+    EXPECT_FALSE(files.failed());
+    read.resize(nbytes);
+    EXPECT_TRUE(expected == read);
+
+    ASSERT_TRUE(files.rewind());
+    char first;
+    ASSERT_EQ(1u, files.read(&first, 1));
+    EXPECT_EQ(expected[0], first);
+    files.close();
+    boost::filesystem::remove_all(directory);
+}
+
+
+TEST(Sample_File_Sequence_Test, FileNotExists)
+{
+    Sample_File_Sequence files;
+    std::vector<std::string> filenames = {"./signal_samples/i_dont_exist.dat"};
+    EXPECT_FALSE(files.open(filenames));
+    EXPECT_FALSE(files.open(std::vector<std::string>()));
+    EXPECT_FALSE(files.is_open());
+}
+
+
+TEST(MultiFileSignalSource, InstantiateAllFiles)
+{
+    boost::filesystem::path directory = boost::filesystem::temp_directory_path() / "multi_file_signal_source";
+    std::vector<std::size_t> sizes = {16000, 16000, 8000};   // 10 ms of shorts at 4 Msps, I/Q
+    write_file_sequence(directory, sizes);
+    boost::shared_ptr<gr::msg_queue> queue = gr::msg_queue::make(0);
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+
+    config->set_property("Test.samples", "0");
+    config->set_property("Test.sampling_frequency", "4000000");
+    config->set_property("Test.filenames", directory.string() + "/capture_*.dat");
+    config->set_property("Test.item_type", "short");
+    config->set_property("Test.repeat", "false");
+
+    std::unique_ptr<MultiFileSignalSource> signal_source(new MultiFileSignalSource(config.get(), "Test", 1, 1, queue));
+
+    EXPECT_STREQ("Multi_File_Signal_Source", signal_source->implementation().c_str());
+    EXPECT_EQ(3u, signal_source->filenames().size());
+    EXPECT_EQ(20000 - 8000, signal_source->samples());   // all the items but the last 2 ms
+    signal_source.reset();
+    boost::filesystem::remove_all(directory);
+}
+
+
+TEST(MultiFileSignalSource, InstantiateFileNotExists)
+{
+    boost::shared_ptr<gr::msg_queue> queue = gr::msg_queue::make(0);
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+
+    config->set_property("Test.samples", "0");
+    config->set_property("Test.sampling_frequency", "0");
+    config->set_property("Test.filenames", "./signal_samples/i_dont_exist_1.dat,./signal_samples/i_dont_exist_2.dat");
+    config->set_property("Test.item_type", "gr_complex");
+    config->set_property("Test.repeat", "false");
+
+    EXPECT_THROW({auto uptr = std::make_shared<MultiFileSignalSource>(config.get(), "Test", 1, 1, queue);}, std::exception);
+}
@@ -0,0 +1,132 @@
+/*!
+ * \file orbit_cache_test.cc
+ * \brief  This file implements unit tests for the Orbit_Cache class.
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include "orbit_cache.h"
+
+
+Gps_Ephemeris orbit_cache_test_gps_ephemeris()
+{
+    Gps_Ephemeris eph;
+    eph.i_satellite_PRN = 5;
+    eph.d_sqrt_A = 5153.7;
+    eph.d_e_eccentricity = 0.012;
+    eph.d_M_0 = 1.2;
+    eph.d_Delta_n = 4.5e-9;
+    eph.d_OMEGA0 = -2.1;
+    eph.d_i_0 = 0.96;
+    eph.d_OMEGA = 0.7;
+    eph.d_OMEGA_DOT = -8e-9;
+    eph.d_IDOT = 1e-10;
+    eph.d_Cuc = 1e-6;
+    eph.d_Cus = 8e-6;
+    eph.d_Crc = 200.0;
+    eph.d_Crs = 30.0;
+    eph.d_Cic = 1e-7;
+    eph.d_Cis = -1e-7;
+    eph.d_Toe = 302400.0;
+    eph.d_Toc = 302400.0;
+    eph.d_IODC = 10.0;
+    eph.d_A_f0 = 1e-4;
+    eph.d_A_f1 = 1e-11;
+    return eph;
+}
+
+
+TEST(Orbit_Cache_Test, GpsMatchesOrbitalModel)
+{
+    Gps_Ephemeris eph = orbit_cache_test_gps_ephemeris();
+    Orbit_Cache<Gps_Ephemeris> cache;
+    for (double t = 300000.0; t < 304000.0; t += 0.73)
+        {
+            Gps_Ephemeris exact = eph;
+            exact.satellitePosition(t);
+            double exact_clock = exact.sv_clock_drift(t);
+            double cached_clock = cache.sv_clock_drift(eph, t);
+            cache.satellitePosition(eph, t);
+            ASSERT_NEAR(exact.d_satpos_X, eph.d_satpos_X, 1e-3);
+            ASSERT_NEAR(exact.d_satpos_Y, eph.d_satpos_Y, 1e-3);
+            ASSERT_NEAR(exact.d_satpos_Z, eph.d_satpos_Z, 1e-3);
+            ASSERT_NEAR(exact.d_satvel_X, eph.d_satvel_X, 1e-3);
+            ASSERT_NEAR(exact.d_satvel_Y, eph.d_satvel_Y, 1e-3);
+            ASSERT_NEAR(exact.d_satvel_Z, eph.d_satvel_Z, 1e-3);
+            ASSERT_NEAR(exact_clock, cached_clock, 1e-12);
+        }
+}
+
+
+TEST(Orbit_Cache_Test, GalileoMatchesOrbitalModel)
+{
+    Galileo_Ephemeris eph;
+    eph.i_satellite_PRN = 11;
+    eph.A_1 = 5440.6;
+    eph.e_1 = 0.0003;
+    eph.M0_1 = -0.4;
+    eph.delta_n_3 = 3e-9;
+    eph.OMEGA_0_2 = 1.3;
+    eph.i_0_2 = 0.97;
+    eph.omega_2 = -0.5;
+    eph.OMEGA_dot_3 = -5.6e-9;
+    eph.C_rc_3 = 180.0;
+    eph.C_rs_3 = -20.0;
+    eph.t0e_1 = 100800.0;
+    eph.t0c_4 = 100800.0;
+    eph.af0_4 = -3e-4;
+    eph.IOD_ephemeris = 7;
+    Orbit_Cache<Galileo_Ephemeris> cache;
+    for (double t = 100000.0; t < 102000.0; t += 0.91)
+        {
+            Galileo_Ephemeris exact = eph;
+            exact.satellitePosition(t);
+            cache.satellitePosition(eph, t);
+            ASSERT_NEAR(exact.d_satpos_X, eph.d_satpos_X, 1e-3);
+            ASSERT_NEAR(exact.d_satpos_Y, eph.d_satpos_Y, 1e-3);
+            ASSERT_NEAR(exact.d_satpos_Z, eph.d_satpos_Z, 1e-3);
+            ASSERT_NEAR(exact.sv_clock_drift(t), cache.sv_clock_drift(eph, t), 1e-12);
+        }
+}
+
+
+TEST(Orbit_Cache_Test, NewIssueOfDataInvalidatesFit)
+{
+    Gps_Ephemeris eph = orbit_cache_test_gps_ephemeris();
+    Orbit_Cache<Gps_Ephemeris> cache;
+    double t = 302410.0;
+    cache.satellitePosition(eph, t);
+    // new ephemeris set for the same satellite within the same window
+    eph.d_IODC = 11.0;
+    eph.d_A_f0 = 2e-4;
+    eph.d_M_0 = 1.21;
+    Gps_Ephemeris exact = eph;
+    exact.satellitePosition(t);
+    cache.satellitePosition(eph, t);
+    EXPECT_NEAR(exact.d_satpos_X, eph.d_satpos_X, 1e-3);
+    EXPECT_NEAR(exact.sv_clock_drift(t), cache.sv_clock_drift(eph, t), 1e-12);
+}
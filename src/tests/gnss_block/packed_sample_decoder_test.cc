@@ -0,0 +1,204 @@
+/*!
+ * \file packed_sample_decoder_test.cc
+ * \brief Implements Unit Tests for the Packed_Sample_Decoder class.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdlib>
+#include <vector>
+#include "packed_sample_decoder.h"
+
+
+// Decodes the samples one by one from the words, as a reference
+std::vector<float> packed_reference_decode(const Packed_Sample_Format& format, bool complex_output,
+        const std::vector<unsigned char>& bytes)
+{
+    Packed_Sample_Decoder values(format, complex_output);   // only for sample_value()
+    std::vector<float> out;
+    unsigned int word_bits = 8 * format.word_bytes;
+    for (unsigned int w = 0; w < bytes.size(); w += format.word_bytes)
+        {
+            unsigned long long word = 0;
+            for (unsigned int k = 0; k < format.word_bytes; k++)
+                {
+                    unsigned int shift = format.big_endian ? 8 * (format.word_bytes - 1 - k) : 8 * k;
+                    word |= static_cast<unsigned long long>(bytes[w + k]) << shift;
+                }
+            for (unsigned int s = 0; s < word_bits / format.bits; s++)
+                {
+                    unsigned int shift = format.msb_first ? word_bits - format.bits * (s + 1) : format.bits * s;
+                    out.push_back(values.sample_value((word >> shift) & ((1 << format.bits) - 1)));
+                    if (complex_output and format.complex == false) out.push_back(0.0);
+                }
+        }
+    return out;
+}
+
+
+TEST(Packed_Sample_Decoder_Test, TwoBitRealTwosComplement)
+{
+    // the layout of the NSR front-end: 4 samples per byte, the first one in the lowest bits
+    Packed_Sample_Format format;
+    Packed_Sample_Decoder decoder(format, false);
+    unsigned char in[1] = {0xE4};   // 11 10 01 00
+    float out[4];
+    ASSERT_EQ(4u, decoder.values_per_byte());
+    decoder.decode(in, 1, out);
+    EXPECT_EQ(0.0, out[0]);
+    EXPECT_EQ(1.0, out[1]);
+    EXPECT_EQ(-2.0, out[2]);
+    EXPECT_EQ(-1.0, out[3]);
+}
+
+
+TEST(Packed_Sample_Decoder_Test, TwoBitRealSignMagnitudeMsbFirst)
+{
+    Packed_Sample_Format format;
+    format.sign_magnitude = true;
+    format.msb_first = true;
+    Packed_Sample_Decoder decoder(format, false);
+    unsigned char in[1] = {0xE4};   // 11 10 01 00
+    float out[4];
+    decoder.decode(in, 1, out);
+    EXPECT_EQ(-3.0, out[0]);
+    EXPECT_EQ(-1.0, out[1]);
+    EXPECT_EQ(3.0, out[2]);
+    EXPECT_EQ(1.0, out[3]);
+}
+
+
+TEST(Packed_Sample_Decoder_Test, TwoBitComplex)
+{
+    Packed_Sample_Format format;
+    format.complex = true;
+    Packed_Sample_Decoder decoder(format, true);
+    unsigned char in[2] = {0xE4, 0x1B};
+    std::vector<float> out(2 * decoder.values_per_byte());
+    decoder.decode(in, 2, out.data());
+    // I, Q, I, Q
+    float expected[8] = {0.0, 1.0, -2.0, -1.0, -1.0, -2.0, 1.0, 0.0};
+    for (unsigned int i = 0; i < 8; i++)
+        {
+            EXPECT_EQ(expected[i], out[i]) << "value " << i;
+        }
+}
+
+
+TEST(Packed_Sample_Decoder_Test, OneBitRealToComplex)
+{
+    Packed_Sample_Format format;
+    format.bits = 1;
+    Packed_Sample_Decoder decoder(format, true);
+    unsigned char in[1] = {0xA5};   // 1010 0101
+    std::vector<float> out(decoder.values_per_byte());
+    ASSERT_EQ(16u, decoder.values_per_byte());
+    decoder.decode(in, 1, out.data());
+    float expected[8] = {-1.0, 1.0, -1.0, 1.0, 1.0, -1.0, 1.0, -1.0};
+    for (unsigned int i = 0; i < 8; i++)
+        {
+            EXPECT_EQ(expected[i], out[2 * i]) << "sample " << i;
+            EXPECT_EQ(0.0, out[2 * i + 1]) << "sample " << i;
+        }
+}
+
+
+TEST(Packed_Sample_Decoder_Test, FourBit)
+{
+    Packed_Sample_Format format;
+    format.bits = 4;
+    format.complex = true;
+    Packed_Sample_Decoder twos(format, true);
+    format.sign_magnitude = true;
+    Packed_Sample_Decoder sign_magnitude(format, true);
+    unsigned char in[1] = {0x8F};
+    float out[2];
+    twos.decode(in, 1, out);
+    EXPECT_EQ(-1.0, out[0]);
+    EXPECT_EQ(-8.0, out[1]);
+    sign_magnitude.decode(in, 1, out);
+    EXPECT_EQ(-15.0, out[0]);
+    EXPECT_EQ(-1.0, out[1]);
+}
+
+
+TEST(Packed_Sample_Decoder_Test, BigEndianWords)
+{
+    Packed_Sample_Format format;
+    format.word_bytes = 2;
+    format.big_endian = true;
+    Packed_Sample_Decoder decoder(format, false);
+    unsigned char in[2] = {0x01, 0x02};   // word 0x0102: the first samples are in 0x02
+    float out[8];
+    decoder.decode(in, 2, out);
+    float expected[8] = {-2.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0};
+    for (unsigned int i = 0; i < 8; i++)
+        {
+            EXPECT_EQ(expected[i], out[i]) << "sample " << i;
+        }
+}
+
+
+TEST(Packed_Sample_Decoder_Test, AllLayouts)
+{
+    std::vector<unsigned char> bytes(256 * 4);
+    std::srand(1234);
+    for (unsigned int i = 0; i < bytes.size(); i++)
+        {
+            bytes[i] = (i < 256) ? i : std::rand() % 256;
+        }
+    unsigned int bits[3] = {1, 2, 4};
+    unsigned int word_bytes[3] = {1, 2, 4};
+    int layouts = 0;
+    for (unsigned int b = 0; b < 3; b++)
+        for (unsigned int w = 0; w < 3; w++)
+            for (unsigned int flags = 0; flags < 16; flags++)
+                for (unsigned int complex_output = 0; complex_output < 2; complex_output++)
+                    {
+                        Packed_Sample_Format format;
+                        format.bits = bits[b];
+                        format.word_bytes = word_bytes[w];
+                        format.complex = flags & 1;
+                        format.sign_magnitude = flags & 2;
+                        format.msb_first = flags & 4;
+                        format.big_endian = flags & 8;
+                        Packed_Sample_Decoder decoder(format, complex_output);
+                        std::vector<float> expected = packed_reference_decode(format, complex_output, bytes);
+                        std::vector<float> out(bytes.size() * decoder.values_per_byte());
+                        std::vector<signed char> out8(out.size());
+                        ASSERT_EQ(expected.size(), out.size());
+                        decoder.decode(bytes.data(), bytes.size(), out.data());
+                        decoder.decode(bytes.data(), bytes.size(), out8.data());
+                        bool equal = true;
+                        for (unsigned int i = 0; i < out.size(); i++)
+                            {
+                                if (out[i] != expected[i] or static_cast<float>(out8[i]) != expected[i]) equal = false;
+                            }
+                        EXPECT_TRUE(equal) << "bits " << format.bits << " word_bytes " << format.word_bytes
+                                           << " flags " << flags << " complex output " << complex_output;
+                        layouts++;
+                    }
+    EXPECT_EQ(288, layouts);
+}
@@ -0,0 +1,198 @@
+/*!
+ * \file pvt_ekf_test.cc
+ * \brief  This file implements unit tests for the Pvt_Ekf class.
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include "pvt_ekf.h"
+
+
+// Fixed satellites seen from around rx0 (ECEF). The last 4 satellites belong to
+// the second system, whose pseudoranges include the inter-system bias.
+class Pvt_Ekf_Test_Scenario
+{
+public:
+    double rx0[3];
+    double sat[8][3];
+    std::mt19937 generator;
+    std::normal_distribution<double> noise;
+
+    Pvt_Ekf_Test_Scenario(double sigma_m) : generator(1234), noise(0.0, sigma_m)
+    {
+        rx0[0] = 4796983.5;
+        rx0[1] = 160308.8;
+        rx0[2] = 4187384.3;
+        const double az[8] = {10.0, 100.0, 190.0, 280.0, 55.0, 145.0, 235.0, 325.0};
+        const double el[8] = {20.0, 45.0, 30.0, 70.0, 60.0, 25.0, 40.0, 15.0};
+        double phi, lambda, h;
+        Ls_Pvt_Solver<8>::togeod(&phi, &lambda, &h, 6378137.0, 298.257223563, rx0[0], rx0[1], rx0[2]);
+        double sb = std::sin(phi * GPS_PI / 180.0);
+        double cb = std::cos(phi * GPS_PI / 180.0);
+        double sl = std::sin(lambda * GPS_PI / 180.0);
+        double cl = std::cos(lambda * GPS_PI / 180.0);
+        for (int i = 0; i < 8; i++)
+            {
+                double e = std::cos(el[i] * GPS_PI / 180.0) * std::sin(az[i] * GPS_PI / 180.0);
+                double n = std::cos(el[i] * GPS_PI / 180.0) * std::cos(az[i] * GPS_PI / 180.0);
+                double u = std::sin(el[i] * GPS_PI / 180.0);
+                double los[3] = {-sl * e - sb * cl * n + cb * cl * u, cl * e - sb * sl * n + cb * sl * u, cb * n + sb * u};
+                for (int k = 0; k < 3; k++) sat[i][k] = rx0[k] + 2.2e7 * los[k];
+            }
+    }
+
+    // error-free pseudorange of satellite i, with the same Earth rotation correction as the filter
+    double pseudorange(int i, const double rx[3], double clk_m, double isb_m)
+    {
+        double d[3] = {sat[i][0] - rx[0], sat[i][1] - rx[1], sat[i][2] - rx[2]};
+        double rot[3];
+        Ls_Pvt_Solver<8>::rotate_satellite(std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) / GPS_C_m_s, sat[i], rot);
+        for (int k = 0; k < 3; k++) d[k] = rot[k] - rx[k];
+        return std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) + clk_m + ((i < 4) ? 0.0 : isb_m);
+    }
+
+    void observe(Pvt_Ekf<8>& ekf, const double rx[3], double clk_m, double isb_m, int n_sat)
+    {
+        ekf.clear();
+        for (int i = 0; i < n_sat; i++)
+            {
+                ekf.add_observation(sat[i][0], sat[i][1], sat[i][2], pseudorange(i, rx, clk_m, isb_m) + noise(generator), (i < 4) ? 0 : 1);
+            }
+    }
+};
+
+
+TEST(Pvt_Ekf_Test, SmootherThanLeastSquares)
+{
+    Pvt_Ekf_Test_Scenario scenario(3.0);
+    Pvt_Ekf<8> ekf;
+    Ls_Pvt_Solver<8> ls;
+    ekf.tropo_enabled = false;
+    ls.tropo_enabled = false;
+    double rx[3] = {scenario.rx0[0], scenario.rx0[1], scenario.rx0[2]};
+    const double v[3] = {10.0, -5.0, 2.0};
+    double clk = 1000.0;
+    const double drift = 50.0;
+    double pos[4];
+    double ls_pos[4];
+    double ekf_error2 = 0.0;
+    double ls_error2 = 0.0;
+    int n = 0;
+    for (int epoch = 0; epoch < 600; epoch++)
+        {
+            double t = 100.0 + 0.1 * epoch;
+            for (int k = 0; k < 3; k++) rx[k] += 0.1 * v[k];
+            clk += 0.1 * drift;
+            // both get the same noisy measurements from 5 satellites
+            ekf.clear();
+            ls.clear();
+            for (int i = 0; i < 5; i++)
+                {
+                    double pr = scenario.pseudorange(i, rx, clk, 0.0) + scenario.noise(scenario.generator);
+                    ekf.add_observation(scenario.sat[i][0], scenario.sat[i][1], scenario.sat[i][2], pr, 0);
+                    ls.add_observation(scenario.sat[i][0], scenario.sat[i][1], scenario.sat[i][2], pr, 1.0);
+                }
+            ASSERT_TRUE(ls.solve(ls_pos));
+            if (ekf.initialized() == false)
+                {
+                    ekf.initialize(ls_pos, t);
+                    continue;
+                }
+            ASSERT_TRUE(ekf.update(t, pos));
+            if (epoch > 300)
+                {
+                    for (int k = 0; k < 3; k++)
+                        {
+                            ekf_error2 += (pos[k] - rx[k]) * (pos[k] - rx[k]);
+                            ls_error2 += (ls_pos[k] - rx[k]) * (ls_pos[k] - rx[k]);
+                        }
+                    n++;
+                }
+        }
+    double ekf_rms = std::sqrt(ekf_error2 / n);
+    double ls_rms = std::sqrt(ls_error2 / n);
+    EXPECT_LT(ekf_rms, 0.5 * ls_rms);
+    EXPECT_NEAR(v[0], ekf.state[3], 1.0);
+    EXPECT_NEAR(v[1], ekf.state[4], 1.0);
+    EXPECT_NEAR(v[2], ekf.state[5], 1.0);
+    EXPECT_NEAR(drift, ekf.state[7], 1.0);
+}
+
+
+TEST(Pvt_Ekf_Test, EstimatesInterSystemBias)
+{
+    Pvt_Ekf_Test_Scenario scenario(1.0);
+    Pvt_Ekf<8> ekf;
+    ekf.tropo_enabled = false;
+    const double* rx = scenario.rx0;
+    double pos[4] = {rx[0] + 5.0, rx[1] - 5.0, rx[2] + 5.0, 0.0};
+    ekf.initialize(pos, 0.0);
+    for (int epoch = 1; epoch <= 200; epoch++)
+        {
+            scenario.observe(ekf, rx, 20.0, 35.0, 8);
+            ASSERT_TRUE(ekf.update(epoch * 0.5, pos));
+        }
+    EXPECT_NEAR(35.0, ekf.state[8], 1.0);
+    EXPECT_NEAR(20.0, pos[3], 1.0);
+    EXPECT_NEAR(rx[0], pos[0], 1.0);
+    EXPECT_NEAR(rx[1], pos[1], 1.0);
+    EXPECT_NEAR(rx[2], pos[2], 1.0);
+    for (int r = 0; r < 4; r++) EXPECT_GT(ekf.Q[r][r], 0.0);
+}
+
+
+TEST(Pvt_Ekf_Test, DetectsDivergence)
+{
+    Pvt_Ekf_Test_Scenario scenario(1.0);
+    Pvt_Ekf<8> ekf;
+    ekf.tropo_enabled = false;
+    double rx[3] = {scenario.rx0[0], scenario.rx0[1], scenario.rx0[2]};
+    double pos[4] = {rx[0], rx[1], rx[2], 0.0};
+    EXPECT_FALSE(ekf.update(1.0, pos));
+    ekf.initialize(pos, 0.0);
+    scenario.observe(ekf, rx, 0.0, 0.0, 4);
+    EXPECT_TRUE(ekf.update(1.0, pos));
+    EXPECT_FALSE(ekf.update(0.5, pos));  // time going backwards
+    EXPECT_FALSE(ekf.update(100.0, pos)); // gap longer than max_prediction_s
+    double state[PVT_EKF_STATES];
+    double P[PVT_EKF_STATES][PVT_EKF_STATES];
+    std::memcpy(state, ekf.state, sizeof(state));
+    std::memcpy(P, ekf.P, sizeof(P));
+    double far[3] = {rx[0] + 10000.0, rx[1], rx[2]};
+    scenario.observe(ekf, far, 0.0, 0.0, 4);
+    EXPECT_FALSE(ekf.update(1.5, pos));
+    EXPECT_EQ(4, ekf.rejected);
+
+    // a rejected epoch leaves the filter as it was
+    EXPECT_EQ(0, std::memcmp(state, ekf.state, sizeof(state)));
+    EXPECT_EQ(0, std::memcmp(P, ekf.P, sizeof(P)));
+    scenario.observe(ekf, rx, 0.0, 0.0, 4);
+    EXPECT_TRUE(ekf.update(1.5, pos));
+    EXPECT_NEAR(rx[0], pos[0], 10.0);
+}
@@ -0,0 +1,97 @@
+/*!
+ * \file pvt_output_writer_test.cc
+ * \brief Implements Unit Tests for the Pvt_Output_Writer class.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <atomic>
+#include <vector>
+#include <boost/thread.hpp>
+#include "pvt_output_writer.h"
+
+
+TEST(Pvt_Output_Writer_Test, WritesInOrder)
+{
+    std::vector<int> written;
+    Pvt_Output_Writer writer(16, false);
+    for (int i = 0; i < 1000; i++)
+        {
+            EXPECT_TRUE(writer.post([&written, i]() { written.push_back(i); }));
+        }
+    writer.stop();
+    ASSERT_EQ(1000u, written.size());
+    for (int i = 0; i < 1000; i++)
+        {
+            EXPECT_EQ(i, written.at(i));
+        }
+    EXPECT_EQ(1000u, writer.written());
+    EXPECT_EQ(0u, writer.dropped());
+}
+
+
+TEST(Pvt_Output_Writer_Test, DropsWhenFull)
+{
+    boost::mutex gate;
+    gate.lock();
+    std::atomic<bool> started(false);
+    Pvt_Output_Writer writer(4, true);
+    // the first record holds the writer thread until the gate is opened
+    writer.post([&gate, &started]() { started = true; boost::mutex::scoped_lock lock(gate); });
+    while (started.load() == false)
+        {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        }
+    int accepted = 0;
+    for (int i = 0; i < 10; i++)
+        {
+            if (writer.post([]() {})) accepted++;
+        }
+    gate.unlock();
+    writer.stop();
+    EXPECT_EQ(4, accepted);
+    EXPECT_EQ(6u, writer.dropped());
+    EXPECT_EQ(5u, writer.written());
+}
+
+
+TEST(Pvt_Output_Writer_Test, FlushesAfterRecords)
+{
+    std::atomic<int> records(0);
+    std::atomic<int> flushes(0);
+    Pvt_Output_Writer writer(8, false);
+    writer.add_flush([&flushes]() { flushes++; });
+    for (int i = 0; i < 3; i++)
+        {
+            writer.post([&records]() { records++; });
+        }
+    writer.stop();
+    EXPECT_EQ(3, records.load());
+    EXPECT_GE(flushes.load(), 1);
+
+    // once stopped, records are written by the caller
+    writer.post([&records]() { records++; });
+    EXPECT_EQ(4, records.load());
+}
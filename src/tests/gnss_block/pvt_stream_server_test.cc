@@ -0,0 +1,165 @@
+/*!
+ * \file pvt_stream_server_test.cc
+ * \brief Implements Unit Tests for the Pvt_Stream_Server class with loopback clients.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <string>
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/thread.hpp>
+#include "pvt_stream_server.h"
+
+
+// Waits up to one second for the server to see \p n clients
+bool stream_server_wait_clients(const Pvt_Stream_Server& server, unsigned int n)
+{
+    for (int i = 0; i < 1000; i++)
+        {
+            if (server.clients() == n) return true;
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        }
+    return false;
+}
+
+
+// Waits up to one second for the server to complete \p n writes
+bool stream_server_wait_sent(const Pvt_Stream_Server& server, unsigned long int n)
+{
+    for (int i = 0; i < 1000; i++)
+        {
+            if (server.sent() == n) return true;
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        }
+    return false;
+}
+
+
+TEST(Pvt_Stream_Server_Test, FanOutToClients)
+{
+    Pvt_Stream_Server server("127.0.0.1", 0, 64);
+    ASSERT_TRUE(server.start());
+    ASSERT_NE(0, server.port());
+
+    boost::asio::io_service io_service;
+    boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), server.port());
+    std::vector<std::shared_ptr<boost::asio::ip::tcp::socket> > clients;
+    for (int i = 0; i < 3; i++)
+        {
+            clients.push_back(std::make_shared<boost::asio::ip::tcp::socket>(io_service));
+            clients.back()->connect(endpoint);
+        }
+    ASSERT_TRUE(stream_server_wait_clients(server, 3));
+
+    std::string expected;
+    for (int i = 0; i < 50; i++)
+        {
+            std::string message = "$GPGGA," + std::to_string(i) + "*00\r\n";
+            server.publish(message.c_str(), message.length());
+            expected += message;
+        }
+    for (unsigned int i = 0; i < clients.size(); i++)
+        {
+            std::string received(expected.length(), '\0');
+            boost::asio::read(*clients.at(i), boost::asio::buffer(&received[0], received.length()));
+            EXPECT_EQ(expected, received);
+        }
+    // the clients can get the data before the server runs the write handlers
+    EXPECT_TRUE(stream_server_wait_sent(server, 150));
+    EXPECT_EQ(0u, server.dropped());
+
+    // closed connections are removed
+    clients.at(0)->close();
+    EXPECT_TRUE(stream_server_wait_clients(server, 2));
+    server.stop();
+}
+
+
+TEST(Pvt_Stream_Server_Test, SlowClientDoesNotBlock)
+{
+    Pvt_Stream_Server server("127.0.0.1", 0, 8);
+    ASSERT_TRUE(server.start());
+
+    boost::asio::io_service io_service;
+    boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), server.port());
+    boost::asio::ip::tcp::socket slow(io_service);  // never reads
+    boost::asio::ip::tcp::socket fast(io_service);
+    slow.connect(endpoint);
+    fast.connect(endpoint);
+    ASSERT_TRUE(stream_server_wait_clients(server, 2));
+
+    const int n_messages = 400;
+    const std::size_t message_length = 64 * 1024;
+    std::size_t received = 0;
+    bool in_order = true;
+    boost::thread reader([&]()
+            {
+                std::vector<char> buffer(message_length);
+                for (int i = 0; i < n_messages; i++)
+                    {
+                        boost::system::error_code ec;
+                        boost::asio::read(fast, boost::asio::buffer(buffer), ec);
+                        if (ec) break;
+                        received += buffer.size();
+                        if (buffer.front() != static_cast<char>(i) or buffer.back() != static_cast<char>(i)) in_order = false;
+                    }
+            });
+
+    // 25 MB: much more than the socket buffers of the client that does not read
+    double max_publish_s = 0.0;
+    for (int i = 0; i < n_messages; i++)
+        {
+            std::vector<char> message(message_length, static_cast<char>(i));
+            boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+            server.publish(message.data(), message.size());
+            double elapsed = static_cast<double>((boost::posix_time::microsec_clock::universal_time() - start).total_microseconds()) * 1e-6;
+            if (elapsed > max_publish_s) max_publish_s = elapsed;
+            boost::this_thread::sleep(boost::posix_time::microseconds(500));
+        }
+    reader.join();
+
+    EXPECT_EQ(n_messages * message_length, received);
+    EXPECT_TRUE(in_order);
+    EXPECT_LT(0u, server.dropped());
+    EXPECT_GT(0.05, max_publish_s);
+    server.stop();
+}
+
+
+TEST(Pvt_Stream_Server_Test, PortInUse)
+{
+    Pvt_Stream_Server first("127.0.0.1", 0, 8);
+    ASSERT_TRUE(first.start());
+    Pvt_Stream_Server second("127.0.0.1", first.port(), 8);
+    EXPECT_FALSE(second.start());
+}
+
+
+TEST(Pvt_Stream_Server_Test, InvalidAddress)
+{
+    Pvt_Stream_Server server("not an address", 0, 8);
+    EXPECT_FALSE(server.start());
+}
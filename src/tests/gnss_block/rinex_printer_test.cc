@@ -0,0 +1,256 @@
+/*!
+ * \file rinex_printer_test.cc
+ * \brief Implements Unit Tests for the RINEX navigation and observation
+ * records written by the Rinex_Printer class.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <gflags/gflags.h>
+#include "rinex_printer.h"
+#include "gps_ephemeris.h"
+#include "galileo_ephemeris.h"
+#include "gnss_synchro.h"
+
+DECLARE_string(RINEX_version);
+
+// The golden files in src/tests/data were written by the string based
+// formatter that preceded the fixed line buffer, with the same inputs.
+
+Gps_Ephemeris rinex_test_gps_ephemeris(int prn, double iodc)
+{
+    Gps_Ephemeris eph;
+    eph.i_satellite_PRN = prn;
+    eph.i_GPS_week = 1820;
+    eph.d_TOW = 345600.0 + 6.0 * prn;
+    eph.d_A_f0 = -1.2345678901234e-4 * prn;
+    eph.d_A_f1 = 3.41060513164848e-12;
+    eph.d_A_f2 = 0.0;
+    eph.d_Crs = -87.40625 + prn;
+    eph.d_Delta_n = 4.50304614942e-09;
+    eph.d_M_0 = 1.23456789 - 0.1 * prn;
+    eph.d_Cuc = -4.5299530029296875e-06;
+    eph.d_e_eccentricity = 0.0123456789 / prn;
+    eph.d_Cus = 7.0538371801376e-06;
+    eph.d_sqrt_A = 5153.65531731;
+    eph.d_Toe = 345600.0;
+    eph.d_Cic = 1.4901161193848e-08;
+    eph.d_OMEGA0 = -2.9861245332 + 0.01 * prn;
+    eph.d_Cis = -9.8720192909241e-08;
+    eph.d_i_0 = 0.96184582654;
+    eph.d_Crc = 254.96875;
+    eph.d_OMEGA = -1.5708 * prn / 32.0;
+    eph.d_OMEGA_DOT = -8.1073948815e-09;
+    eph.d_IDOT = 3.2143196030e-10;
+    eph.i_code_on_L2 = 1;
+    eph.i_SV_accuracy = 2;
+    eph.i_SV_health = 0;
+    eph.d_TGD = -1.1175870895386e-08;
+    eph.d_IODC = iodc;
+    return eph;
+}
+
+
+Galileo_Ephemeris rinex_test_galileo_ephemeris(int prn, int iod)
+{
+    Galileo_Ephemeris eph;
+    eph.i_satellite_PRN = prn;
+    eph.WN_5 = 796.0;
+    eph.TOW_5 = 345612.0 + prn;
+    eph.af0_4 = 2.7823541313410e-04 / prn;
+    eph.af1_4 = -1.2789769243682e-13;
+    eph.af2_4 = 0.0;
+    eph.IOD_ephemeris = iod;
+    eph.C_rs_3 = 12.5 * prn;
+    eph.delta_n_3 = 2.8954863306e-09;
+    eph.M0_1 = -2.1234567890123;
+    eph.C_uc_3 = 1.0300427675247e-06;
+    eph.e_1 = 1.9432161934674e-04;
+    eph.C_us_3 = 6.5807253122330e-06;
+    eph.A_1 = 5440.6183395386;
+    eph.t0e_1 = 345600.0;
+    eph.C_ic_4 = -5.5879354476929e-09;
+    eph.OMEGA_0_2 = 1.0987654321 - 0.02 * prn;
+    eph.C_is_4 = 2.4214386940002e-08;
+    eph.i_0_2 = 0.95957467625;
+    eph.C_rc_3 = 198.4375;
+    eph.omega_2 = -0.5678901234;
+    eph.OMEGA_dot_3 = -5.6173768698e-09;
+    eph.iDot_2 = -1.5000625161e-10;
+    eph.E1B_HS_5 = 0.0;
+    eph.E5b_HS_5 = 0.0;
+    eph.E1B_DVS_5 = 0.0;
+    eph.E5b_DVS_5 = 0.0;
+    eph.BGD_E1E5a_5 = -6.9849193096161e-09;
+    eph.BGD_E1E5b_5 = -7.4505805969238e-09;
+    return eph;
+}
+
+
+Gnss_Synchro rinex_test_observation(char system, int prn, double pseudorange_m)
+{
+    Gnss_Synchro gs;
+    gs.System = system;
+    gs.PRN = prn;
+    gs.Pseudorange_m = pseudorange_m;
+    gs.Carrier_phase_rads = -1.23456789e6 * prn;
+    gs.Carrier_Doppler_hz = 1234.5678 - 321.0 * prn;
+    gs.CN0_dB_hz = 40.0 + 0.3333 * prn;
+    return gs;
+}
+
+
+std::string rinex_test_read(const std::string& filename)
+{
+    std::ifstream in(filename.c_str());
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+
+std::string rinex_test_golden(const std::string& name)
+{
+    return rinex_test_read(std::string(TEST_PATH) + "data/" + name);
+}
+
+
+TEST(Rinex_Printer_Test, NavigationRecordsMatchGolden)
+{
+    FLAGS_RINEX_version = "3.02";
+    std::shared_ptr<Rinex_Printer> rp = std::make_shared<Rinex_Printer>();
+    std::map<int, Gps_Ephemeris> gps_eph_map;
+    int gps_prn[4] = {1, 7, 12, 31};
+    for (int i = 0; i < 4; i++)
+        {
+            gps_eph_map[gps_prn[i]] = rinex_test_gps_ephemeris(gps_prn[i], 50.0 + i);
+        }
+    std::map<int, Galileo_Ephemeris> galileo_eph_map;
+    galileo_eph_map[11] = rinex_test_galileo_ephemeris(11, 85);
+    galileo_eph_map[19] = rinex_test_galileo_ephemeris(19, 86);
+
+    std::string filename = "rinex_printer_test_nav_v3.txt";
+    std::ofstream out(filename.c_str());
+    rp->log_rinex_nav(out, gps_eph_map);
+    rp->log_rinex_nav(out, galileo_eph_map);
+    out.close();
+    EXPECT_EQ(rinex_test_golden("rinex_printer_golden_nav_v3.txt"), rinex_test_read(filename));
+    std::remove(filename.c_str());
+}
+
+
+TEST(Rinex_Printer_Test, ObservationRecordsMatchGolden)
+{
+    FLAGS_RINEX_version = "3.02";
+    std::shared_ptr<Rinex_Printer> rp = std::make_shared<Rinex_Printer>();
+    Gps_Ephemeris gps_eph = rinex_test_gps_ephemeris(7, 50.0);
+    Galileo_Ephemeris galileo_eph = rinex_test_galileo_ephemeris(11, 85);
+    std::map<int, Gnss_Synchro> gps_obs;
+    gps_obs[3] = rinex_test_observation('G', 3, 20123456.7891234);
+    gps_obs[7] = rinex_test_observation('G', 7, 22345678.0004999);
+    gps_obs[22] = rinex_test_observation('G', 22, 24680135.9995001);
+    std::map<int, Gnss_Synchro> galileo_obs;
+    galileo_obs[11] = rinex_test_observation('E', 11, 23456789.1234567);
+    galileo_obs[19] = rinex_test_observation('E', 19, 25678901.5);
+    std::map<int, Gnss_Synchro> mixed_obs;
+    mixed_obs[5] = rinex_test_observation('G', 5, 21000000.0625);
+    mixed_obs[12] = rinex_test_observation('E', 12, 26000000.3125);
+
+    std::string filename = "rinex_printer_test_obs_v3.txt";
+    std::ofstream out(filename.c_str());
+    rp->log_rinex_obs(out, gps_eph, 345603.0, gps_obs);
+    rp->log_rinex_obs(out, gps_eph, 345659.9, gps_obs);
+    rp->log_rinex_obs(out, galileo_eph, 345612.25, galileo_obs);
+    rp->log_rinex_obs(out, gps_eph, galileo_eph, 345621.5, mixed_obs);
+    out.close();
+    EXPECT_EQ(rinex_test_golden("rinex_printer_golden_obs_v3.txt"), rinex_test_read(filename));
+    std::remove(filename.c_str());
+}
+
+
+TEST(Rinex_Printer_Test, Version2RecordsMatchGolden)
+{
+    FLAGS_RINEX_version = "2.11";
+    std::shared_ptr<Rinex_Printer> rp = std::make_shared<Rinex_Printer>();
+    FLAGS_RINEX_version = "3.02";
+    std::map<int, Gps_Ephemeris> gps_eph_map;
+    gps_eph_map[4] = rinex_test_gps_ephemeris(4, 60.0);
+    gps_eph_map[29] = rinex_test_gps_ephemeris(29, 61.0);
+    std::map<int, Gnss_Synchro> gps_obs;
+    gps_obs[4] = rinex_test_observation('G', 4, 20987654.3210987);
+    gps_obs[29] = rinex_test_observation('G', 29, 23456789.0);
+
+    std::string filename = "rinex_printer_test_v2.txt";
+    std::ofstream out(filename.c_str());
+    rp->log_rinex_nav(out, gps_eph_map);
+    rp->log_rinex_obs(out, gps_eph_map[4], 345607.125, gps_obs);
+    out.close();
+    EXPECT_EQ(rinex_test_golden("rinex_printer_golden_v2.txt"), rinex_test_read(filename));
+    std::remove(filename.c_str());
+}
+
+
+TEST(Rinex_Printer_Test, OnlyNewEphemerisIsLogged)
+{
+    FLAGS_RINEX_version = "3.02";
+    std::shared_ptr<Rinex_Printer> rp = std::make_shared<Rinex_Printer>();
+    std::map<int, Gps_Ephemeris> gps_eph_map;
+    gps_eph_map[2] = rinex_test_gps_ephemeris(2, 70.0);
+    gps_eph_map[9] = rinex_test_gps_ephemeris(9, 71.0);
+    std::map<int, Galileo_Ephemeris> galileo_eph_map;
+    galileo_eph_map[24] = rinex_test_galileo_ephemeris(24, 90);
+
+    std::string filename = "rinex_printer_test_nav_iode.txt";
+    std::ofstream out(filename.c_str());
+    rp->log_rinex_nav(out, gps_eph_map);
+    rp->log_rinex_nav(out, galileo_eph_map);
+    out.flush();
+    std::string first = rinex_test_read(filename);
+    EXPECT_EQ(3u * 8u * 81u, first.size());
+
+    // same issues of data: nothing is written
+    rp->log_rinex_nav(out, gps_eph_map);
+    rp->log_rinex_nav(out, galileo_eph_map);
+    out.flush();
+    EXPECT_EQ(first, rinex_test_read(filename));
+
+    // a new issue of data of one satellite of each system
+    gps_eph_map[9] = rinex_test_gps_ephemeris(9, 72.0);
+    galileo_eph_map[24] = rinex_test_galileo_ephemeris(24, 91);
+    rp->log_rinex_nav(out, gps_eph_map);
+    rp->log_rinex_nav(out, galileo_eph_map);
+    out.close();
+    std::string second = rinex_test_read(filename);
+    ASSERT_EQ(5u * 8u * 81u, second.size());
+    EXPECT_EQ("G09", second.substr(first.size(), 3));
+    EXPECT_EQ("E24", second.substr(first.size() + 8 * 81, 3));
+    std::remove(filename.c_str());
+}
@@ -28,13 +28,57 @@
  * -------------------------------------------------------------------------
  */
 
+#include <cmath>
+#include <cstdio>
 #include <fstream>
+#include <iterator>
 #include <map>
 #include <string>
+#include <vector>
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/serialization/nvp.hpp>
 #include "rtcm_printer.h"
 #include "gps_ephemeris.h"
+#include "galileo_ephemeris.h"
+#include "gnss_synchro.h"
+#include "GPS_L1_CA.h"
+
+
+// Reads \p length bits of an RTCM frame, starting at bit \p pos (MSB first)
+unsigned long long int rtcm_test_bits(const unsigned char* frame, int pos, int length)
+{
+    unsigned long long int value = 0;
+    for (int i = pos; i < pos + length; i++)
+        {
+            value = (value << 1) | ((frame[i / 8] >> (7 - i % 8)) & 1u);
+        }
+    return value;
+}
+
+
+long long int rtcm_test_signed_bits(const unsigned char* frame, int pos, int length)
+{
+    unsigned long long int value = rtcm_test_bits(frame, pos, length);
+    if (value & (1ULL << (length - 1)))
+        {
+            return static_cast<long long int>(value) - (1LL << length);
+        }
+    return static_cast<long long int>(value);
+}
+
+
+Gnss_Synchro rtcm_test_observable(char system, unsigned int prn, double pseudorange_m, double phase_cycles)
+{
+    Gnss_Synchro gs = Gnss_Synchro();
+    gs.System = system;
+    gs.PRN = prn;
+    gs.Pseudorange_m = pseudorange_m;
+    gs.Carrier_phase_rads = phase_cycles * GPS_TWO_PI;
+    gs.Carrier_Doppler_hz = -1234.5;
+    gs.CN0_dB_hz = 45.3;
+    gs.Flag_valid_pseudorange = true;
+    return gs;
+}
 
 
 TEST(Rtcm_Printer_Test, Instantiate)
@@ -73,3 +117,309 @@ TEST(Rtcm_Printer_Test, Instantiate_and_Run)
 
     EXPECT_EQ(reference_msg, testing_msg);
 }
+
+
+
+TEST(Rtcm_Printer_Test, Crc24q)
+{
+    const unsigned char check[] = "123456789";
+    EXPECT_EQ(0xCDE703u, Rtcm_Printer::crc24q(check, 9));
+}
+
+
+
+TEST(Rtcm_Printer_Test, GpsEphemerisMessage)
+{
+    Rtcm_Printer rtcm("rtcm_printer_test.rtcm", false, "");
+    Gps_Ephemeris eph = Gps_Ephemeris();
+    eph.i_satellite_PRN = 17;
+    eph.i_GPS_week = 1840;
+    eph.d_IODC = 300;
+    eph.d_Toe = 403200;
+    eph.d_Toc = 403200;
+    eph.d_M_0 = -12345678 * M_0_LSB;
+    eph.d_e_eccentricity = 87654321 * E_LSB;
+    eph.d_sqrt_A = 2702512345u * SQRT_A_LSB;
+    eph.d_A_f0 = -54321 * A_F0_LSB;
+    eph.d_OMEGA_DOT = -22222 * OMEGA_DOT_LSB;
+
+    ASSERT_EQ(6 + 61, rtcm.encode_M1019(eph));  // 488 bits
+    const unsigned char* f = rtcm.frame();
+    EXPECT_EQ(0xD3, f[0]);
+    EXPECT_EQ(61u, rtcm_test_bits(f, 14, 10));
+    EXPECT_EQ(rtcm_test_bits(f, 8 * 64, 24), Rtcm_Printer::crc24q(f, 64));
+    EXPECT_EQ(1019u, rtcm_test_bits(f, 24, 12));
+    EXPECT_EQ(17u, rtcm_test_bits(f, 36, 6));
+    EXPECT_EQ(1840u % 1024u, rtcm_test_bits(f, 42, 10));
+    EXPECT_EQ(300u & 0xFFu, rtcm_test_bits(f, 72, 8));           // IODE
+    EXPECT_EQ(403200u / 16u, rtcm_test_bits(f, 80, 16));         // toc
+    EXPECT_EQ(-54321, rtcm_test_signed_bits(f, 120, 22));        // af0
+    EXPECT_EQ(300u, rtcm_test_bits(f, 142, 10));                 // IODC
+    EXPECT_EQ(-12345678, rtcm_test_signed_bits(f, 184, 32));     // M0
+    EXPECT_EQ(87654321u, rtcm_test_bits(f, 232, 32));            // e
+    EXPECT_EQ(2702512345u, rtcm_test_bits(f, 280, 32));          // sqrt(A)
+    EXPECT_EQ(-22222, rtcm_test_signed_bits(f, 472, 24));        // OMEGA DOT
+}
+
+
+
+TEST(Rtcm_Printer_Test, GalileoEphemerisMessage)
+{
+    Rtcm_Printer rtcm("rtcm_printer_test.rtcm", false, "");
+    Galileo_Ephemeris eph = Galileo_Ephemeris();
+    eph.i_satellite_PRN = 11;
+    eph.WN_5 = 840;
+    eph.IOD_ephemeris = 77;
+    eph.t0e_1 = 3600;
+    eph.af0_4 = -777 * af0_4_LSB;
+    ASSERT_EQ(6 + 62, rtcm.encode_M1045(eph));  // 496 bits
+    const unsigned char* f = rtcm.frame();
+    EXPECT_EQ(1045u, rtcm_test_bits(f, 24, 12));
+    EXPECT_EQ(11u, rtcm_test_bits(f, 36, 6));
+    EXPECT_EQ(840u, rtcm_test_bits(f, 42, 12));
+    EXPECT_EQ(77u, rtcm_test_bits(f, 54, 10));
+    EXPECT_EQ(-777, rtcm_test_signed_bits(f, 127, 31));
+    EXPECT_EQ(60u, rtcm_test_bits(f, 24 + 294, 14));   // toe
+}
+
+
+
+TEST(Rtcm_Printer_Test, ObservablesMessages)
+{
+    Rtcm_Printer rtcm("rtcm_printer_test.rtcm", false, "", 100);
+    std::map<int, Gnss_Synchro> observables;
+    observables[5] = rtcm_test_observable('G', 5, 21345678.91, 112233445.25);
+    observables[2] = rtcm_test_observable('G', 2, 23456789.01, -998877.5);
+    observables[40] = rtcm_test_observable('E', 12, 25000000.0, 0.0);
+
+    int lengths[4] = {58, 74, 101, 125};
+    for (unsigned int type = 1001; type <= 1004; type++)
+        {
+            int bits = 64 + 2 * lengths[type - 1001];
+            ASSERT_EQ(6 + (bits + 7) / 8, rtcm.encode_observables(type, 345600.2, observables, false));
+        }
+
+    // 1004: satellites sorted by PRN, ambiguity and modulo pseudorange
+    const unsigned char* f = rtcm.frame();
+    EXPECT_EQ(100u, rtcm_test_bits(f, 36, 12));
+    EXPECT_EQ(345600200u, rtcm_test_bits(f, 48, 30));
+    EXPECT_EQ(2u, rtcm_test_bits(f, 79, 5));
+    EXPECT_EQ(2u, rtcm_test_bits(f, 88, 6));
+    EXPECT_EQ(5u, rtcm_test_bits(f, 88 + 125, 6));
+    double range_ms = GPS_C_m_s * 0.001;
+    double pr = static_cast<double>(rtcm_test_bits(f, 88 + 7, 24)) * 0.02 + static_cast<double>(rtcm_test_bits(f, 88 + 58, 8)) * range_ms;
+    EXPECT_NEAR(23456789.01, pr, 0.01);
+    EXPECT_EQ(-8192, rtcm_test_signed_bits(f, 88 + 76, 14));  // no L2
+
+    EXPECT_EQ(0, rtcm.encode_observables(1005, 345600.2, observables, false));
+    EXPECT_EQ(0, rtcm.encode_observables(1001, 345600.2, std::map<int, Gnss_Synchro>(), false));
+}
+
+
+
+TEST(Rtcm_Printer_Test, PrintObservables)
+{
+    std::string filename = "rtcm_printer_observables_test.rtcm";
+    std::map<int, Gnss_Synchro> observables;
+    observables[5] = rtcm_test_observable('G', 5, 21345678.91, 112233445.25);
+    observables[40] = rtcm_test_observable('E', 12, 25000000.0, 0.0);
+    std::map<int, Gnss_Synchro> gps_observables;
+    gps_observables[5] = observables[5];
+    {
+        Rtcm_Printer rtcm(filename, false, "", 100);
+        // Galileo has no legacy message, so it follows the 1004 as MSM7
+        EXPECT_TRUE(rtcm.Print_Rtcm_Observables(1004, 345600.2, observables));
+        EXPECT_TRUE(rtcm.Print_Rtcm_Observables(4, 345600.4, observables));
+        EXPECT_TRUE(rtcm.Print_Rtcm_Observables(1002, 345600.6, gps_observables));
+        EXPECT_FALSE(rtcm.Print_Rtcm_Observables(1001, 345600.8, std::map<int, Gnss_Synchro>()));
+    }
+
+    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ifs.close();
+    std::remove(filename.c_str());
+    std::vector<unsigned int> types;
+    std::vector<unsigned int> more;
+    size_t pos = 0;
+    while (pos + 6 <= data.size())
+        {
+            ASSERT_EQ(0xD3, data[pos]);
+            size_t length = static_cast<size_t>(rtcm_test_bits(&data[pos], 14, 10));
+            ASSERT_LE(pos + length + 6, data.size());
+            EXPECT_EQ(Rtcm_Printer::crc24q(&data[pos], static_cast<int>(length) + 3), rtcm_test_bits(&data[pos], (static_cast<int>(length) + 3) * 8, 24));
+            types.push_back(static_cast<unsigned int>(rtcm_test_bits(&data[pos], 24, 12)));
+            more.push_back(static_cast<unsigned int>(rtcm_test_bits(&data[pos], 78, 1)));  // synchronous GNSS / multiple message flag
+            pos += length + 6;
+        }
+    EXPECT_EQ(data.size(), pos);
+    unsigned int expected_types[5] = {1004, 1097, 1074, 1094, 1002};
+    unsigned int expected_more[5] = {1, 0, 1, 0, 0};
+    ASSERT_EQ(5u, types.size());
+    for (int i = 0; i < 5; i++)
+        {
+            EXPECT_EQ(expected_types[i], types[i]);
+            EXPECT_EQ(expected_more[i], more[i]);
+        }
+}
+
+
+
+TEST(Rtcm_Printer_Test, MsmMessages)
+{
+    Rtcm_Printer rtcm("rtcm_printer_test.rtcm", false, "");
+    std::map<int, Gnss_Synchro> observables;
+    observables[1] = rtcm_test_observable('E', 30, 24123456.789, 126771234.5);
+    observables[2] = rtcm_test_observable('E', 3, 26123456.789, 0.0);
+    observables[3] = rtcm_test_observable('G', 7, 22000000.0, 0.0);
+    double range_ms = GPS_C_m_s * 0.001;
+    double lambda = GPS_C_m_s / GPS_L1_FREQ_HZ;
+
+    // MSM7: 169 + 2 header, 2 * 36 satellite and 2 * 80 signal bits
+    ASSERT_EQ(6 + (171 + 72 + 160 + 7) / 8, rtcm.encode_MSM(7, 'E', 100.0, observables, true));
+    const unsigned char* f = rtcm.frame();
+    EXPECT_EQ(1097u, rtcm_test_bits(f, 24, 12));
+    EXPECT_EQ(1u, rtcm_test_bits(f, 78, 1));
+    EXPECT_EQ((1ULL << 61) | (1ULL << 34), rtcm_test_bits(f, 97, 64));
+    EXPECT_EQ(1ULL << 27, rtcm_test_bits(f, 161, 32));  // E1 B+C
+    EXPECT_EQ(3u, rtcm_test_bits(f, 193, 2));
+    int sat = 195;
+    int sig = sat + 2 * 36;
+    for (int i = 0; i < 2; i++)
+        {
+            double expected = (i == 0) ? 26123456.789 : 24123456.789;
+            double rough_ms = static_cast<double>(rtcm_test_bits(f, sat + 8 * i, 8)) + static_cast<double>(rtcm_test_bits(f, sat + 24 + 10 * i, 10)) / 1024.0;
+            double fine_ms = static_cast<double>(rtcm_test_signed_bits(f, sig + 20 * i, 20)) * std::ldexp(1.0, -29);
+            EXPECT_NEAR(expected, (rough_ms + fine_ms) * range_ms, 0.001);
+            EXPECT_EQ(std::floor(1234.5 * lambda + 0.5), rtcm_test_signed_bits(f, sat + 44 + 14 * i, 14));
+        }
+    EXPECT_EQ(-8388608, rtcm_test_signed_bits(f, sig + 40, 24));  // PRN 3 has no phase
+    long long int phase0 = rtcm_test_signed_bits(f, sig + 64, 24);
+    EXPECT_EQ(0u, rtcm_test_bits(f, sig + 98, 10));    // just locked
+    EXPECT_EQ(725u, rtcm_test_bits(f, sig + 110, 10));  // 45.3 dB-Hz
+
+    // one second later, with the rough range unchanged, the phaserange is the
+    // opposite of the accumulated carrier phase, and the lock time grows
+    observables[1].Carrier_phase_rads += 10.0 * GPS_TWO_PI;
+    ASSERT_LT(0, rtcm.encode_MSM(7, 'E', 101.0, observables, true));
+    f = rtcm.frame();
+    double delta_m = static_cast<double>(rtcm_test_signed_bits(f, sig + 64, 24) - phase0) * std::ldexp(1.0, -31) * range_ms;
+    EXPECT_NEAR(-10.0 * lambda, delta_m, 0.001);
+    EXPECT_EQ(190u, rtcm_test_bits(f, sig + 98, 10));
+
+    // MSM4 of the GPS satellite
+    ASSERT_EQ(6 + (170 + 18 + 48 + 7) / 8, rtcm.encode_MSM(4, 'G', 100.0, observables, false));
+    f = rtcm.frame();
+    EXPECT_EQ(1074u, rtcm_test_bits(f, 24, 12));
+    EXPECT_EQ(45u, rtcm_test_bits(f, 194 + 18 + 15 + 22 + 4 + 1, 6));
+    EXPECT_EQ(0, rtcm.encode_MSM(5, 'G', 100.0, observables, false));
+}
+
+
+
+// Signal IDs of the DF395 signal mask of an MSM frame (the first one is 1, at the most significant bit)
+std::vector<int> rtcm_test_msm_signals(const unsigned char* f)
+{
+    std::vector<int> signals;
+    for (int id = 1; id <= 32; id++)
+        {
+            if (rtcm_test_bits(f, 161 + id - 1, 1) == 1)
+                {
+                    signals.push_back(id);
+                }
+        }
+    return signals;
+}
+
+
+TEST(Rtcm_Printer_Test, MsmSignalMask)
+{
+    Rtcm_Printer rtcm("rtcm_printer_test.rtcm", false, "");
+    std::map<int, Gnss_Synchro> observables;
+    observables[1] = rtcm_test_observable('G', 7, 22000000.0, 0.0);
+    observables[2] = rtcm_test_observable('G', 12, 23000000.0, 0.0);
+    observables[3] = rtcm_test_observable('E', 11, 25000000.0, 0.0);
+    for (unsigned int msm = 4; msm <= 7; msm += 3)
+        {
+            // GPS L1 C/A: signal ID 2 (1C), one cell per satellite
+            ASSERT_LT(0, rtcm.encode_MSM(msm, 'G', 100.0, observables, true));
+            const unsigned char* f = rtcm.frame();
+            EXPECT_EQ(1070u + msm, rtcm_test_bits(f, 24, 12));
+            std::vector<int> signals = rtcm_test_msm_signals(f);
+            ASSERT_EQ(1u, signals.size());
+            EXPECT_EQ(2, signals[0]);
+            EXPECT_EQ(3u, rtcm_test_bits(f, 193, 2));
+
+            // Galileo E1 B+C: signal ID 5 (1X), not 3 (1A, the PRS)
+            ASSERT_LT(0, rtcm.encode_MSM(msm, 'E', 100.0, observables, false));
+            f = rtcm.frame();
+            EXPECT_EQ(1090u + msm, rtcm_test_bits(f, 24, 12));
+            signals = rtcm_test_msm_signals(f);
+            ASSERT_EQ(1u, signals.size());
+            EXPECT_EQ(5, signals[0]);
+            EXPECT_EQ(1u, rtcm_test_bits(f, 193, 1));
+        }
+}
+
+
+// Phaserange of the first satellite of an MSM7 frame of \p n satellites [m]
+double rtcm_test_msm7_phaserange(const unsigned char* f, int n)
+{
+    double range_ms = GPS_C_m_s * 0.001;
+    int sat = 193 + n;   // one signal: n cells
+    int sig = sat + 36 * n;
+    double rough_ms = static_cast<double>(rtcm_test_bits(f, sat, 8)) + static_cast<double>(rtcm_test_bits(f, sat + 12 * n, 10)) / 1024.0;
+    return (rough_ms + static_cast<double>(rtcm_test_signed_bits(f, sig + 20 * n, 24)) * std::ldexp(1.0, -31)) * range_ms;
+}
+
+
+double rtcm_test_msm7_pseudorange(const unsigned char* f, int n)
+{
+    double range_ms = GPS_C_m_s * 0.001;
+    int sat = 193 + n;
+    int sig = sat + 36 * n;
+    double rough_ms = static_cast<double>(rtcm_test_bits(f, sat, 8)) + static_cast<double>(rtcm_test_bits(f, sat + 12 * n, 10)) / 1024.0;
+    return (rough_ms + static_cast<double>(rtcm_test_signed_bits(f, sig, 20)) * std::ldexp(1.0, -29)) * range_ms;
+}
+
+
+TEST(Rtcm_Printer_Test, PhaseFollowsDoppler)
+{
+    // A satellite going away: negative Doppler, the tracking loop accumulates
+    // 2 pi Doppler T, and the pseudorange grows by -Doppler lambda T
+    Rtcm_Printer rtcm("rtcm_printer_test.rtcm", false, "");
+    double lambda = GPS_C_m_s / GPS_L1_FREQ_HZ;
+    double doppler_hz = -1234.5;
+    std::map<int, Gnss_Synchro> observables;
+    observables[1] = rtcm_test_observable('G', 9, 22000000.0, 5000123.25);
+    observables[1].Carrier_Doppler_hz = doppler_hz;
+
+    ASSERT_LT(0, rtcm.encode_MSM(7, 'G', 200.0, observables, false));
+    double phase_0 = rtcm_test_msm7_phaserange(rtcm.frame(), 1);
+    double code_0 = rtcm_test_msm7_pseudorange(rtcm.frame(), 1);
+    ASSERT_LT(0, rtcm.encode_observables(1002, 200.0, observables, false));
+    long long int df012_0 = rtcm_test_signed_bits(rtcm.frame(), 88 + 31, 20);
+    unsigned long long int msm_lock = 0;
+    for (int t = 1; t <= 20; t++)
+        {
+            observables[1].Carrier_phase_rads += GPS_TWO_PI * doppler_hz;
+            observables[1].Pseudorange_m -= doppler_hz * lambda;
+            ASSERT_LT(0, rtcm.encode_MSM(7, 'G', 200.0 + t, observables, false));
+            const unsigned char* f = rtcm.frame();
+            double phase = rtcm_test_msm7_phaserange(f, 1);
+            EXPECT_NEAR(-doppler_hz * lambda * t, phase - phase_0, 0.001);
+            EXPECT_NEAR(phase - phase_0, rtcm_test_msm7_pseudorange(f, 1) - code_0, 0.001);
+            EXPECT_LT(msm_lock, rtcm_test_bits(f, 194 + 36 + 44, 10));  // no lock reset
+            msm_lock = rtcm_test_bits(f, 194 + 36 + 44, 10);
+
+            ASSERT_LT(0, rtcm.encode_observables(1002, 200.0 + t, observables, false));
+            f = rtcm.frame();
+            EXPECT_NEAR(df012_0, rtcm_test_signed_bits(f, 88 + 31, 20), 50);   // 0.02 m of pseudorange resolution
+            EXPECT_EQ(static_cast<unsigned long long int>(t), rtcm_test_bits(f, 88 + 51, 7));
+        }
+
+    // a cycle slip out of the +/-1500 cycles of DF012 restarts the lock, it is not wrapped
+    observables[1].Carrier_phase_rads += GPS_TWO_PI * 2000.0;
+    ASSERT_LT(0, rtcm.encode_observables(1002, 221.0, observables, false));
+    EXPECT_EQ(0u, rtcm_test_bits(rtcm.frame(), 88 + 51, 7));
+    EXPECT_GT(0.5 * lambda / 0.0005, std::fabs(static_cast<double>(rtcm_test_signed_bits(rtcm.frame(), 88 + 31, 20))));
+}
@@ -0,0 +1,119 @@
+/*!
+ * \file gnss_sdr_bench.cc
+ * \brief Microbenchmarks of the DSP kernels and of the receiver hot paths.
+ *
+ * Build with 'make gnss_sdr_bench' (needs Google Benchmark). The results
+ * can be written in JSON, to be compared between builds:
+ *
+ *     ./gnss_sdr_bench --benchmark_out=bench.json --benchmark_out_format=json
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <benchmark/benchmark.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "concurrent_queue.h"
+#include "concurrent_map.h"
+
+#include "gps_ephemeris.h"
+#include "gps_almanac.h"
+#include "gps_iono.h"
+#include "gps_utc_model.h"
+#include "gps_acq_assist.h"
+#include "gps_ref_location.h"
+#include "gps_ref_time.h"
+
+#include "galileo_ephemeris.h"
+#include "galileo_almanac.h"
+#include "galileo_iono.h"
+#include "galileo_utc_model.h"
+
+#include "sbas_ephemeris.h"
+#include "sbas_telemetry_data.h"
+#include "sbas_ionospheric_correction.h"
+#include "sbas_satellite_correction.h"
+#include "sbas_time.h"
+#include "gnss_receiver_fix.h"
+
+
+using google::LogMessage;
+
+#include "benchmarks/dsp_kernels_bench.cc"
+#include "benchmarks/receiver_paths_bench.cc"
+
+
+concurrent_queue<Gps_Ephemeris> global_gps_ephemeris_queue;
+concurrent_queue<Gps_Iono> global_gps_iono_queue;
+concurrent_queue<Gps_Utc_Model> global_gps_utc_model_queue;
+concurrent_queue<Gps_Almanac> global_gps_almanac_queue;
+concurrent_queue<Gps_Acq_Assist> global_gps_acq_assist_queue;
+concurrent_queue<Gps_Ref_Location> global_gps_ref_location_queue;
+concurrent_queue<Gps_Ref_Time> global_gps_ref_time_queue;
+
+concurrent_map<Gps_Ephemeris> global_gps_ephemeris_map;
+concurrent_map<Gps_Iono> global_gps_iono_map;
+concurrent_map<Gps_Utc_Model> global_gps_utc_model_map;
+concurrent_map<Gps_Almanac> global_gps_almanac_map;
+concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
+concurrent_map<Gps_Ref_Location> global_gps_ref_location_map;
+concurrent_map<Gps_Ref_Time> global_gps_ref_time_map;
+
+// For GALILEO NAVIGATION
+concurrent_queue<Galileo_Ephemeris> global_galileo_ephemeris_queue;
+concurrent_queue<Galileo_Iono> global_galileo_iono_queue;
+concurrent_queue<Galileo_Utc_Model> global_galileo_utc_model_queue;
+concurrent_queue<Galileo_Almanac> global_galileo_almanac_queue;
+
+concurrent_map<Galileo_Ephemeris> global_galileo_ephemeris_map;
+concurrent_map<Galileo_Iono> global_galileo_iono_map;
+concurrent_map<Galileo_Utc_Model> global_galileo_utc_model_map;
+concurrent_map<Galileo_Almanac> global_galileo_almanac_map;
+
+// For SBAS CORRECTIONS
+concurrent_queue<Sbas_Raw_Msg> global_sbas_raw_msg_queue;
+concurrent_queue<Sbas_Ionosphere_Correction> global_sbas_iono_queue;
+concurrent_queue<Sbas_Satellite_Correction> global_sbas_sat_corr_queue;
+concurrent_queue<Sbas_Ephemeris> global_sbas_ephemeris_queue;
+
+concurrent_map<Sbas_Ionosphere_Correction> global_sbas_iono_map;
+concurrent_map<Sbas_Satellite_Correction> global_sbas_sat_corr_map;
+concurrent_map<Sbas_Ephemeris> global_sbas_ephemeris_map;
+
+// Last position fix, kept in the receiver state
+concurrent_map<Gnss_Receiver_Fix> global_receiver_fix_map;
+
+
+
+int main(int argc, char **argv)
+{
+    // nothing else goes to stdout, where the results can be written in JSON
+    benchmark::Initialize(&argc, argv);
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
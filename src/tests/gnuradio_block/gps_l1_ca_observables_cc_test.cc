@@ -0,0 +1,136 @@
+/*!
+ * \file gps_l1_ca_observables_cc_test.cc
+ * \brief Checks the output decimation of the GPS L1 C/A observables block
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <gnuradio/top_block.h>
+#include <gnuradio/msg_queue.h>
+#include <gnuradio/blocks/file_source.h>
+#include <gnuradio/blocks/file_sink.h>
+#include "gnss_synchro.h"
+#include "gnss_dump_reader.h"
+#include "gps_l1_ca_observables_cc.h"
+#include "GPS_L1_CA.h"
+
+
+/*
+ * Feeds nepochs epochs of two channels: channel 0 has a valid word from epoch 5 on,
+ * with a TOW that does not start on the output grid, and channel 1 never has one.
+ * The measurements must come out at the epochs whose TOW is a multiple of the
+ * output rate, while the dump gets every epoch.
+ */
+TEST(Gps_L1_Ca_Observables_Cc_Test, OutputEpochsFollowTow)
+{
+    const int nepochs = 100;
+    const int output_rate_ms = 10;
+    const unsigned int nchannels = 2;
+    const long long int first_tow_ms = 100003;
+    boost::filesystem::path tmp = boost::filesystem::temp_directory_path();
+    std::string dump_filename = (tmp / boost::filesystem::unique_path("observables_%%%%%%.dat")).string();
+    std::string in_filename[nchannels];
+    std::string out_filename[nchannels];
+    for (unsigned int ch = 0; ch < nchannels; ch++)
+        {
+            in_filename[ch] = (tmp / boost::filesystem::unique_path("observables_in_%%%%%%.dat")).string();
+            out_filename[ch] = (tmp / boost::filesystem::unique_path("observables_out_%%%%%%.dat")).string();
+            std::ofstream ofs(in_filename[ch].c_str(), std::ios::binary);
+            for (int k = 0; k < nepochs; k++)
+                {
+                    Gnss_Synchro gs = Gnss_Synchro();
+                    gs.System = 'G';
+                    gs.PRN = 10 + ch;
+                    gs.Channel_ID = ch;
+                    gs.Prn_timestamp_ms = static_cast<double>(k);
+                    gs.Flag_valid_word = (ch == 0) and (k >= 5);
+                    gs.d_TOW_at_current_symbol = static_cast<double>(first_tow_ms + k) / 1000.0;
+                    ofs.write(reinterpret_cast<const char*>(&gs), sizeof(Gnss_Synchro));
+                }
+        }
+
+    {
+        gr::msg_queue::sptr queue = gr::msg_queue::make(0);
+        gr::top_block_sptr top_block = gr::make_top_block("gps_l1_ca_observables_cc_test");
+        gps_l1_ca_observables_cc_sptr observables = gps_l1_ca_make_observables_cc(nchannels, queue, true, dump_filename, output_rate_ms, false);
+        for (unsigned int ch = 0; ch < nchannels; ch++)
+            {
+                gr::blocks::file_source::sptr source = gr::blocks::file_source::make(sizeof(Gnss_Synchro), in_filename[ch].c_str(), false);
+                gr::blocks::file_sink::sptr sink = gr::blocks::file_sink::make(sizeof(Gnss_Synchro), out_filename[ch].c_str());
+                top_block->connect(source, 0, observables, ch);
+                top_block->connect(observables, ch, sink, 0);
+            }
+        EXPECT_NO_THROW({
+            top_block->run();
+            top_block->stop();
+        }) << "Failure running gps_l1_ca_observables_cc.";
+    }
+
+    // the first valid epoch is k = 5 (TOW 100008 ms), so the outputs are at TOW 100010, 100020, ... 100100 ms
+    std::vector<Gnss_Synchro> out;
+    std::ifstream ifs(out_filename[0].c_str(), std::ios::binary);
+    Gnss_Synchro gs;
+    while (ifs.read(reinterpret_cast<char*>(&gs), sizeof(Gnss_Synchro)))
+        {
+            out.push_back(gs);
+        }
+    ifs.close();
+    ASSERT_EQ(10u, out.size());
+    for (unsigned int i = 0; i < out.size(); i++)
+        {
+            EXPECT_TRUE(out[i].Flag_valid_pseudorange);
+            EXPECT_EQ(7.0 + 10.0 * i, out[i].Prn_timestamp_ms);
+            long long int tow_ms = static_cast<long long int>(round(out[i].d_TOW_at_current_symbol * 1000.0 - GPS_STARTOFFSET_ms));
+            EXPECT_EQ(100010 + 10 * static_cast<long long int>(i), tow_ms);
+        }
+    EXPECT_EQ(10 * sizeof(Gnss_Synchro), boost::filesystem::file_size(out_filename[1]));
+
+    Gnss_Dump_Reader reader;
+    ASSERT_TRUE(reader.open(dump_filename));
+    EXPECT_EQ(static_cast<unsigned long int>(nepochs), reader.records());
+    int timestamp = reader.field_index("ch0_Prn_timestamp_ms");
+    int valid = reader.field_index("ch0_Flag_valid_pseudorange");
+    for (int k = 0; k < nepochs; k++)
+        {
+            ASSERT_TRUE(reader.read_record());
+            EXPECT_EQ(static_cast<double>(k), reader.value<double>(timestamp));
+            EXPECT_EQ(k >= 5 ? 1.0 : 0.0, reader.value<double>(valid));
+        }
+    reader.close();
+
+    std::remove(dump_filename.c_str());
+    for (unsigned int ch = 0; ch < nchannels; ch++)
+        {
+            std::remove(in_filename[ch].c_str());
+            std::remove(out_filename[ch].c_str());
+        }
+}
@@ -61,6 +61,7 @@
 #include "sbas_ionospheric_correction.h"
 #include "sbas_satellite_correction.h"
 #include "sbas_time.h"
+#include "gnss_receiver_fix.h"
 
 
 
@@ -76,12 +77,35 @@ DECLARE_string(log_dir);
 #include "configuration/in_memory_configuration_test.cc"
 #include "control_thread/control_message_factory_test.cc"
 #include "control_thread/control_thread_test.cc"
+#include "control_thread/concurrent_map_test.cc"
 #include "flowgraph/pass_through_test.cc"
 #include "flowgraph/gnss_flowgraph_test.cc"
 #include "gnss_block/gnss_block_factory_test.cc"
 #include "gnss_block/rtcm_printer_test.cc"
+#include "gnss_block/orbit_cache_test.cc"
+#include "gnss_block/ls_pvt_solver_test.cc"
+#include "gnss_block/pvt_ekf_test.cc"
+#include "gnss_block/pvt_output_writer_test.cc"
+#include "gnss_block/rinex_printer_test.cc"
+#include "gnss_block/pvt_stream_server_test.cc"
+#include "gnss_block/gnss_dump_writer_test.cc"
+#include "gnss_block/gnss_dump_merger_test.cc"
+#include "gnss_block/gnss_block_counters_test.cc"
+#include "gnss_block/gnss_throughput_report_test.cc"
+#include "gnss_block/gnss_latency_test.cc"
+#include "gnss_block/gnss_metrics_server_test.cc"
+#include "gnss_block/gnss_realtime_monitor_test.cc"
+#include "gnss_block/gnss_block_placement_test.cc"
+#include "gnss_block/gnss_event_loop_test.cc"
+#include "gnss_block/gnss_receiver_state_test.cc"
+#include "gnss_block/gnss_supl_assistance_test.cc"
+#include "gnss_block/batch_processor_test.cc"
 #include "gnss_block/file_output_filter_test.cc"
 #include "gnss_block/file_signal_source_test.cc"
+#include "gnss_block/mmap_file_signal_source_test.cc"
+#include "gnss_block/compressed_file_signal_source_test.cc"
+#include "gnss_block/multi_file_signal_source_test.cc"
+#include "gnss_block/packed_sample_decoder_test.cc"
 #include "gnss_block/fir_filter_test.cc"
 #include "gnss_block/gps_l1_ca_pcps_acquisition_test.cc"
 #include "gnss_block/gps_l1_ca_pcps_acquisition_gsoc2013_test.cc"
@@ -100,6 +124,7 @@ DECLARE_string(log_dir);
 #include "gnss_block/galileo_e1_pcps_quicksync_ambiguous_acquisition_gsoc2014_test.cc"
 #include "gnss_block/galileo_e1_dll_pll_veml_tracking_test.cc"
 #include "gnuradio_block/gnss_sdr_valve_test.cc"
+#include "gnuradio_block/gps_l1_ca_observables_cc_test.cc"
 #include "gnuradio_block/direct_resampler_conditioner_cc_test.cc"
 #include "string_converter/string_converter_test.cc"
 
@@ -147,6 +172,9 @@ concurrent_map<Sbas_Ionosphere_Correction> global_sbas_iono_map;
 concurrent_map<Sbas_Satellite_Correction> global_sbas_sat_corr_map;
 concurrent_map<Sbas_Ephemeris> global_sbas_ephemeris_map;
 
+// Last position fix, kept in the receiver state
+concurrent_map<Gnss_Receiver_Fix> global_receiver_fix_map;
+
 
 
 int main(int argc, char **argv)
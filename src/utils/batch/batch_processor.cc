@@ -0,0 +1,395 @@
+/*!
+ * \file batch_processor.cc
+ * \brief Implementation of the batch post-processing program, which runs one
+ * receiver per time slice of a capture and merges their outputs.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "batch_processor.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <boost/filesystem.hpp>
+#include <glog/logging.h>
+#include <gnuradio/gr_complex.h>
+#include "gnss_dump_merger.h"
+
+using google::LogMessage;
+
+
+BatchProcessor::BatchProcessor(std::shared_ptr<ConfigurationInterface> configuration, const Batch_Options& options)
+{
+    configuration_ = configuration;
+    options_ = options;
+    items_per_sample_ = 1;
+    items_per_second_ = 0.0;
+}
+
+
+bool BatchProcessor::plan()
+{
+    std::string role = "SignalSource";
+    implementation_ = configuration_->property(role + ".implementation", std::string("File_Signal_Source"));
+    if (implementation_.compare("File_Signal_Source") == 0)
+        {
+            // same options, plus seek_s
+            implementation_ = "Mmap_File_Signal_Source";
+        }
+    else if (implementation_.compare("Mmap_File_Signal_Source") != 0 and implementation_.compare("Compressed_File_Signal_Source") != 0)
+        {
+            std::cerr << "Batch processing needs a File_Signal_Source, Mmap_File_Signal_Source or Compressed_File_Signal_Source, not "
+                      << implementation_ << std::endl;
+            return false;
+        }
+    filename_ = configuration_->property(role + ".filename", std::string("../data/my_capture.dat"));
+    boost::system::error_code ec;
+    filename_ = boost::filesystem::absolute(filename_).string();
+    std::string item_type = configuration_->property(role + ".item_type", std::string("short"));
+    long sampling_frequency = configuration_->property(role + ".sampling_frequency", 0);
+    unsigned long long samples = configuration_->property(role + ".samples", 0);
+    double seek_s = configuration_->property(role + ".seek_s", 0.0);
+    double IF = configuration_->property("InputFilter.IF", 0.0);
+    if (sampling_frequency <= 0)
+        {
+            std::cerr << "Set " << role << ".sampling_frequency to split the capture in time" << std::endl;
+            return false;
+        }
+
+    unsigned int item_size = sizeof(gr_complex);
+    if (item_type.compare("float") == 0)
+        {
+            item_size = sizeof(float);
+        }
+    else if (item_type.compare("short") == 0)
+        {
+            item_size = sizeof(short int);
+        }
+    else if (item_type.compare("byte") == 0)
+        {
+            item_size = sizeof(char);
+        }
+    // if IF < BW/2, the samples are complex: two items per sample unless they are gr_complex
+    items_per_sample_ = 1;
+    if ((item_type.compare("gr_complex") != 0) && (IF < 1e6))
+        {
+            items_per_sample_ = 2;
+        }
+    items_per_second_ = static_cast<double>(sampling_frequency) * items_per_sample_;
+    unsigned long long begin_item = static_cast<unsigned long long>(std::round(seek_s * static_cast<double>(sampling_frequency))) * items_per_sample_;
+
+    unsigned long long total_items = samples;
+    if (implementation_.compare("Compressed_File_Signal_Source") == 0)
+        {
+            if (samples == 0)
+                {
+                    std::cerr << "The length of a compressed capture is not known: set " << role << ".samples" << std::endl;
+                    return false;
+                }
+        }
+    else
+        {
+            unsigned long long file_items = boost::filesystem::file_size(filename_, ec) / item_size;
+            if (ec)
+                {
+                    std::cerr << "Unable to read " << filename_ << ": " << ec.message() << std::endl;
+                    return false;
+                }
+            file_items = (file_items > begin_item) ? file_items - begin_item : 0;
+            if (total_items == 0 or total_items > file_items)
+                {
+                    total_items = file_items;
+                }
+        }
+
+    unsigned long long overlap_items = static_cast<unsigned long long>(std::round(options_.overlap_s * static_cast<double>(sampling_frequency))) * items_per_sample_;
+    slices_ = gnss_time_slices(begin_item, total_items, options_.slices, overlap_items, items_per_sample_);
+    if (slices_.empty())
+        {
+            std::cerr << "Nothing to process in " << filename_ << std::endl;
+            return false;
+        }
+    std::cout << std::setprecision(6) << "Processing " << static_cast<double>(total_items) / items_per_second_
+              << " [s] of " << filename_ << " in " << slices_.size() << " slices overlapping "
+              << options_.overlap_s << " [s], " << options_.jobs << " at a time" << std::endl;
+    return true;
+}
+
+
+bool BatchProcessor::run()
+{
+    boost::system::error_code ec;
+    boost::filesystem::path directory = boost::filesystem::absolute(options_.directory);
+    boost::filesystem::create_directories(directory, ec);
+    if (ec)
+        {
+            std::cerr << "Unable to create " << directory.string() << ": " << ec.message() << std::endl;
+            return false;
+        }
+
+    std::vector<Job> jobs;
+    std::string nav_xml;
+    if (options_.nav_xml.empty() == false)
+        {
+            nav_xml = boost::filesystem::absolute(options_.nav_xml).string();
+            if (boost::filesystem::exists(nav_xml) == false)
+                {
+                    std::cerr << "The ephemeris file " << nav_xml << " does not exist" << std::endl;
+                    return false;
+                }
+        }
+    else if (options_.nav_pass_s > 0.0 and slices_.size() > 1)
+        {
+            // the first slice is not seeded, so it can run next to the first pass
+            Gnss_Time_Slice first = slices_.front();
+            first.items = std::min<unsigned long long>(first.items,
+                    static_cast<unsigned long long>(std::round(options_.nav_pass_s * items_per_second_ / items_per_sample_)) * items_per_sample_);
+            Job nav_pass = slice_job(first, "");
+            nav_pass.name = "first pass";
+            nav_pass.directory = (directory / "nav_pass").string();
+            nav_pass.overrides["GNSS-SDR.SUPL_gps_ephemeris_xml"] = (directory / "gps_ephemeris.xml").string();
+            nav_pass.overrides["Observables.dump"] = "false";
+            nav_pass.overrides["PVT.dump"] = "false";
+            jobs.push_back(nav_pass);
+            jobs.push_back(slice_job(slices_.front(), ""));
+            for (unsigned int i = 0; i < jobs.size(); i++)
+                {
+                    if (start(jobs[i]) == false) return false;
+                }
+            while (jobs.front().pid > 0)
+                {
+                    if (wait(jobs) < 0) break;
+                }
+            nav_xml = (directory / "gps_ephemeris.xml").string();
+            if (boost::filesystem::exists(nav_xml) == false)
+                {
+                    std::cout << "The first pass collected no ephemeris, the slices will decode their own" << std::endl;
+                    nav_xml.clear();
+                }
+        }
+
+    for (unsigned int i = jobs.empty() ? 0 : 1; i < slices_.size(); i++)
+        {
+            jobs.push_back(slice_job(slices_[i], nav_xml));
+        }
+    unsigned int running = 0;
+    for (unsigned int i = 0; i < jobs.size(); i++)
+        {
+            if (jobs[i].pid > 0) running++;
+        }
+    for (unsigned int i = 0; i < jobs.size(); i++)
+        {
+            if (jobs[i].pid != 0) continue;   // already started
+            while (running >= options_.jobs)
+                {
+                    if (wait(jobs) < 0) break;
+                    running--;
+                }
+            if (start(jobs[i]))
+                {
+                    running++;
+                }
+        }
+    while (running > 0 and wait(jobs) >= 0)
+        {
+            running--;
+        }
+
+    bool ok = true;
+    for (unsigned int i = 0; i < jobs.size(); i++)
+        {
+            ok = ok and jobs[i].ok;
+        }
+    merge((directory / "observables.dat").string(), "TOW_at_current_symbol");
+    merge((directory / "PVT_raw.dat").string(), "rx_time_s");
+    merge((directory / "PVT_ls_pvt.dat").string(), "rx_time_s");
+    return ok;
+}
+
+
+BatchProcessor::Job BatchProcessor::slice_job(const Gnss_Time_Slice& slice, const std::string& nav_xml) const
+{
+    Job job;
+    std::ostringstream name;
+    name << "slice_" << std::setfill('0') << std::setw(3) << slice.index;
+    job.name = name.str();
+    job.directory = (boost::filesystem::absolute(options_.directory) / job.name).string();
+    job.pid = 0;
+    job.ok = false;
+
+    std::ostringstream samples;
+    samples << slice.items;
+    job.overrides["SignalSource.implementation"] = implementation_;
+    job.overrides["SignalSource.filename"] = filename_;
+    job.overrides["SignalSource.seek_s"] = seek(slice.first_item);
+    job.overrides["SignalSource.samples"] = samples.str();
+    job.overrides["SignalSource.repeat"] = "false";
+    job.overrides["SignalSource.enable_throttle_control"] = "false";
+    job.overrides["SignalSource.dump"] = "false";
+    // the receiver only reads the XML assistance with SUPL enabled: then it asks no server
+    job.overrides["GNSS-SDR.SUPL_gps_enabled"] = nav_xml.empty() ? "false" : "true";
+    // the receiver saves its ephemerides at exit: each slice gets its own file
+    job.overrides["GNSS-SDR.SUPL_gps_ephemeris_xml"] = (boost::filesystem::path(job.directory) / "gps_ephemeris.xml").string();
+    job.overrides["GNSS-SDR.SUPL_read_gps_assistance_xml"] = nav_xml.empty() ? "false" : "true";
+    job.overrides["Observables.dump"] = "true";
+    job.overrides["Observables.dump_filename"] = "observables.dat";
+    job.overrides["PVT.dump"] = "true";
+    job.overrides["PVT.dump_filename"] = "PVT";
+    job.seed = nav_xml;
+    return job;
+}
+
+
+std::map<std::string, std::string> BatchProcessor::slice_overrides(unsigned int slice, const std::string& nav_xml) const
+{
+    return slice_job(slices_.at(slice), nav_xml).overrides;
+}
+
+
+bool BatchProcessor::start(Job& job) const
+{
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(job.directory, ec);
+    if (!ec and job.seed.empty() == false)
+        {
+            boost::filesystem::copy_file(job.seed, job.overrides.at("GNSS-SDR.SUPL_gps_ephemeris_xml"),
+                    boost::filesystem::copy_option::overwrite_if_exists, ec);
+        }
+    if (ec)
+        {
+            std::cerr << "Unable to prepare " << job.directory << ": " << ec.message() << std::endl;
+            return false;
+        }
+
+    // a copy of the configuration, with the keys of the slice appended: the last value read wins
+    std::string config_file = (boost::filesystem::path(job.directory) / "gnss-sdr.conf").string();
+    std::ifstream in(options_.config_file.c_str());
+    std::ofstream out(config_file.c_str());
+    out << in.rdbuf() << std::endl;
+    out << ";######### " << job.name << " of gnss-sdr-batch #########" << std::endl;
+    out << "[GNSS-SDR]" << std::endl;
+    for (std::map<std::string, std::string>::const_iterator it = job.overrides.begin(); it != job.overrides.end(); ++it)
+        {
+            out << it->first << "=" << it->second << std::endl;
+        }
+    out.close();
+    if (in.fail() or out.fail())
+        {
+            std::cerr << "Unable to write " << config_file << std::endl;
+            return false;
+        }
+
+    std::string config_flag = "--config_file=" + config_file;
+    std::string log_flag = "--log_dir=" + job.directory;
+    std::string output = (boost::filesystem::path(job.directory) / "gnss-sdr.out").string();
+    int pid = fork();
+    if (pid < 0)
+        {
+            std::cerr << "Unable to start a receiver for " << job.name << std::endl;
+            return false;
+        }
+    if (pid == 0)
+        {
+            // the receiver writes its RINEX, KML and NMEA files to its working directory
+            int null_fd = ::open("/dev/null", O_RDONLY);
+            int out_fd = ::open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (chdir(job.directory.c_str()) != 0 or null_fd < 0 or out_fd < 0) _exit(127);
+            dup2(null_fd, 0);
+            dup2(out_fd, 1);
+            dup2(out_fd, 2);
+            execlp(options_.gnss_sdr.c_str(), options_.gnss_sdr.c_str(), config_flag.c_str(), log_flag.c_str(), static_cast<char*>(nullptr));
+            _exit(127);
+        }
+    job.pid = pid;
+    std::cout << "Started " << job.name << " (pid " << pid << ") in " << job.directory << std::endl;
+    return true;
+}
+
+
+int BatchProcessor::wait(std::vector<Job>& jobs) const
+{
+    int status = 0;
+    int pid = waitpid(-1, &status, 0);
+    if (pid < 0)
+        {
+            return -1;
+        }
+    for (unsigned int i = 0; i < jobs.size(); i++)
+        {
+            if (jobs[i].pid == pid)
+                {
+                    jobs[i].pid = -1;
+                    jobs[i].ok = WIFEXITED(status) and WEXITSTATUS(status) == 0;
+                    if (jobs[i].ok)
+                        {
+                            std::cout << "Finished " << jobs[i].name << std::endl;
+                        }
+                    else
+                        {
+                            std::cerr << jobs[i].name << " failed, see " << jobs[i].directory << std::endl;
+                        }
+                    return i;
+                }
+        }
+    return wait(jobs);
+}
+
+
+void BatchProcessor::merge(const std::string& filename, const std::string& time_field) const
+{
+    std::string name = boost::filesystem::path(filename).filename().string();
+    Gnss_Dump_Merger merger(filename, time_field);
+    for (unsigned int i = 0; i < slices_.size(); i++)
+        {
+            std::ostringstream slice;
+            slice << "slice_" << std::setfill('0') << std::setw(3) << slices_[i].index;
+            boost::filesystem::path part = boost::filesystem::absolute(options_.directory) / slice.str() / name;
+            if (boost::filesystem::exists(part) and merger.add(part.string()) == false)
+                {
+                    std::cerr << "Unable to merge " << part.string() << std::endl;
+                }
+        }
+    merger.close();
+    if (merger.files() > 0)
+        {
+            std::cout << "Merged " << merger.records_out() << " of " << merger.records_in() << " records of "
+                      << merger.files() << " slices into " << filename << std::endl;
+        }
+}
+
+
+std::string BatchProcessor::seek(unsigned long long item) const
+{
+    // seek_s * sampling_frequency is rounded to the sample by the signal source
+    std::ostringstream os;
+    os << std::setprecision(17) << static_cast<double>(item) / items_per_second_;
+    return os.str();
+}
@@ -0,0 +1,123 @@
+/*!
+ * \file batch_processor.h
+ * \brief Interface of the batch post-processing program, which runs one
+ * receiver per time slice of a capture and merges their outputs.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BATCH_PROCESSOR_H_
+#define GNSS_SDR_BATCH_PROCESSOR_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "configuration_interface.h"
+#include "gnss_time_slices.h"
+
+/*!
+ * \brief Options of a batch run
+ */
+struct Batch_Options
+{
+    std::string config_file;   //!< Configuration of the receiver
+    std::string gnss_sdr;      //!< gnss-sdr executable
+    std::string directory;     //!< Directory of the slices and of the merged outputs
+    std::string nav_xml;       //!< GPS ephemeris XML file seeding the slices. Empty: collected by a first pass
+    unsigned int slices;       //!< Number of time slices
+    unsigned int jobs;         //!< Receivers running at the same time
+    double overlap_s;          //!< Time each slice starts before its share of the capture [s]
+    double nav_pass_s;         //!< Length of the first pass that collects the ephemerides [s]
+};
+
+
+/*!
+ * \brief This class post-processes one long capture with all the cores.
+ *
+ * The capture is split in time slices (see gnss_time_slices()), each one
+ * processed by an independent gnss-sdr process: the receiver keeps its
+ * navigation data in process-wide maps, so receivers cannot share a
+ * process. Each slice gets a copy of the configuration file with its
+ * seek_s, samples and output files appended, and runs in its own directory
+ * under Batch_Options::directory, where its logs, RINEX, KML and NMEA files
+ * are left. The slices are seeded with the GPS ephemerides through the
+ * SUPL XML assistance: either a given XML file, or the one saved by a first
+ * pass over the beginning of the capture, which runs next to the first
+ * slice (that one needs no seed). The observables and PVT dumps of the
+ * slices are finally merged in time order by Gnss_Dump_Merger.
+ */
+class BatchProcessor
+{
+public:
+    BatchProcessor(std::shared_ptr<ConfigurationInterface> configuration, const Batch_Options& options);
+
+    /*!
+     * \brief Plans the slices from the signal source of the configuration.
+     * Returns false if the source cannot be split.
+     */
+    bool plan();
+
+    /*!
+     * \brief Runs the receivers and merges their outputs. Returns false if
+     * a receiver failed; what the others produced is still merged.
+     */
+    bool run();
+
+    const std::vector<Gnss_Time_Slice>& slices() const { return slices_; }
+
+    /*!
+     * \brief Keys appended to the configuration of the planned slice
+     * \p slice, seeded with the ephemeris XML file \p nav_xml (empty: none)
+     */
+    std::map<std::string, std::string> slice_overrides(unsigned int slice, const std::string& nav_xml) const;
+
+private:
+    struct Job
+    {
+        std::string name;
+        std::string directory;
+        std::string seed;   // ephemeris XML file copied to the directory
+        std::map<std::string, std::string> overrides;
+        int pid;
+        bool ok;
+    };
+
+    Job slice_job(const Gnss_Time_Slice& slice, const std::string& nav_xml) const;
+    bool start(Job& job) const;
+    int wait(std::vector<Job>& jobs) const;
+    void merge(const std::string& filename, const std::string& time_field) const;
+    std::string seek(unsigned long long item) const;
+
+    std::shared_ptr<ConfigurationInterface> configuration_;
+    Batch_Options options_;
+    std::string implementation_;
+    std::string filename_;
+    unsigned int items_per_sample_;
+    double items_per_second_;
+    std::vector<Gnss_Time_Slice> slices_;
+};
+
+#endif
@@ -0,0 +1,109 @@
+/*!
+ * \file main.cc
+ * \brief Main file of the batch post-processing program, which runs one
+ * receiver per time slice of a capture and merges their outputs.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_VERSION
+#define GNSS_SDR_VERSION "0.0.5"
+#endif
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "batch_processor.h"
+#include "file_configuration.h"
+
+using google::LogMessage;
+
+DEFINE_string(config_file, std::string(GNSSSDR_INSTALL_DIR "/share/gnss-sdr/conf/default.conf"),
+        "File containing the configuration parameters of the receiver");
+DEFINE_string(batch_dir, "./batch", "Directory of the time slices and of the merged outputs");
+DEFINE_string(gnss_sdr, "", "gnss-sdr executable (by default, the one next to this program or else in the PATH)");
+DEFINE_int32(slices, 0, "Number of time slices (0: one per core)");
+DEFINE_int32(jobs, 0, "Number of receivers running at the same time (0: one per core)");
+DEFINE_double(overlap_s, 40.0, "Time each slice starts before its share of the capture, to acquire and decode the time [s]");
+DEFINE_double(nav_pass_s, 60.0, "Length of the first pass that collects the GPS ephemerides seeding the slices [s] (0: none)");
+DEFINE_string(nav_xml, "", "GPS ephemeris XML file (as saved by gnss-sdr) that seeds the slices instead of a first pass");
+
+
+int main(int argc, char** argv)
+{
+    const std::string intro_help(
+            std::string("\ngnss-sdr-batch post-processes a long capture with all the cores:\n")
+    +
+    "it runs one GNSS-SDR receiver per time slice and merges their outputs in time order.\n"
+    +
+    "Copyright (C) 2010-2015 (see AUTHORS file for a list of contributors)\n"
+    +
+    "This program comes with ABSOLUTELY NO WARRANTY;\n"
+    +
+    "See COPYING file to see a copy of the General Public License\n \n");
+
+    google::SetUsageMessage(intro_help);
+    google::SetVersionString(GNSS_SDR_VERSION);
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    if (boost::filesystem::exists(FLAGS_config_file) == false)
+        {
+            std::cerr << "The configuration file " << FLAGS_config_file << " does not exist" << std::endl;
+            return 1;
+        }
+    unsigned int cores = boost::thread::hardware_concurrency();
+    if (cores == 0) cores = 1;
+
+    Batch_Options options;
+    options.config_file = FLAGS_config_file;
+    options.directory = FLAGS_batch_dir;
+    options.nav_xml = FLAGS_nav_xml;
+    options.slices = (FLAGS_slices > 0) ? FLAGS_slices : cores;
+    options.jobs = (FLAGS_jobs > 0) ? FLAGS_jobs : cores;
+    options.overlap_s = FLAGS_overlap_s;
+    options.nav_pass_s = FLAGS_nav_pass_s;
+    options.gnss_sdr = FLAGS_gnss_sdr;
+    if (options.gnss_sdr.empty())
+        {
+            boost::filesystem::path next_to_this = boost::filesystem::path(argv[0]).parent_path() / "gnss-sdr";
+            options.gnss_sdr = boost::filesystem::exists(next_to_this) ? next_to_this.string() : std::string("gnss-sdr");
+        }
+
+    std::shared_ptr<ConfigurationInterface> configuration = std::make_shared<FileConfiguration>(FLAGS_config_file);
+    BatchProcessor batch(configuration, options);
+    if (batch.plan() == false)
+        {
+            return 1;
+        }
+    bool ok = batch.run();
+    google::ShutDownCommandLineFlags();
+    std::cout << "gnss-sdr-batch program ended." << std::endl;
+    return ok ? 0 : 1;
+}
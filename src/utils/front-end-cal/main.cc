@@ -60,6 +60,8 @@
 #include "gps_almanac.h"
 #include "gps_iono.h"
 #include "gps_utc_model.h"
+#include "gps_ref_location.h"
+#include "gps_ref_time.h"
 #include "galileo_ephemeris.h"
 #include "galileo_almanac.h"
 #include "galileo_iono.h"
@@ -69,6 +71,7 @@
 #include "sbas_satellite_correction.h"
 #include "sbas_ephemeris.h"
 #include "sbas_time.h"
+#include "gnss_receiver_fix.h"
 #include "gnss_sdr_supl_client.h"
 
 
@@ -96,6 +99,8 @@ concurrent_map<Gps_Iono> global_gps_iono_map;
 concurrent_map<Gps_Utc_Model> global_gps_utc_model_map;
 concurrent_map<Gps_Almanac> global_gps_almanac_map;
 concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
+concurrent_map<Gps_Ref_Location> global_gps_ref_location_map;
+concurrent_map<Gps_Ref_Time> global_gps_ref_time_map;
 
 // For GALILEO NAVIGATION
 concurrent_queue<Galileo_Ephemeris> global_galileo_ephemeris_queue;
@@ -118,6 +123,9 @@ concurrent_map<Sbas_Ionosphere_Correction> global_sbas_iono_map;
 concurrent_map<Sbas_Satellite_Correction> global_sbas_sat_corr_map;
 concurrent_map<Sbas_Ephemeris> global_sbas_ephemeris_map;
 
+// Last position fix, kept in the receiver state
+concurrent_map<Gnss_Receiver_Fix> global_receiver_fix_map;
+
 bool stop;
 concurrent_queue<int> channel_internal_queue;
 GpsL1CaPcpsAcquisitionFineDoppler *acquisition;
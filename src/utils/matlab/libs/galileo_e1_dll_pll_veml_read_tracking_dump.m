@@ -51,6 +51,7 @@ function [GNSS_tracking] = galileo_e1_dll_pll_veml_read_tracking_dump (filename,
   end
     %loops_counter = fread (f, count, 'uint32',4*12);
   f = fopen (filename, 'rb');
+  bytes_shift = gnss_sdr_dump_data_offset (f); % skips the header of the dump file
   if (f < 0)
   else
     v1 = fread (f, count, 'float',skip_bytes_each_read-float_size_bytes);
@@ -0,0 +1,49 @@
+% /*!
+%  * \file gnss_sdr_dump_data_offset.m
+%  * \brief Skips the header of a GNSS-SDR dump file.
+%  * -------------------------------------------------------------------------
+%  *
+%  * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+%  *
+%  * GNSS-SDR is a software defined Global Navigation
+%  *          Satellite Systems receiver
+%  *
+%  * This file is part of GNSS-SDR.
+%  *
+%  * GNSS-SDR is free software: you can redistribute it and/or modify
+%  * it under the terms of the GNU General Public License as published by
+%  * the Free Software Foundation, either version 3 of the License, or
+%  * at your option) any later version.
+%  *
+%  * GNSS-SDR is distributed in the hope that it will be useful,
+%  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+%  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+%  * GNU General Public License for more details.
+%  *
+%  * You should have received a copy of the GNU General Public License
+%  * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+%  *
+%  * -------------------------------------------------------------------------
+%  */
+function [offset] = gnss_sdr_dump_data_offset (f)
+
+  %% usage: offset = gnss_sdr_dump_data_offset (f)
+  %%
+  %% returns the position of the first record of the open dump file f and
+  %% moves there. Files without header (older versions) start at 0.
+  %%
+
+  offset = 0;
+  if (f < 0)
+    return;
+  end
+  fseek(f,0,'bof');
+  line = fgetl(f);
+  if (ischar(line) && strncmp(line, 'GNSS-SDR dump', 13))
+    while ischar(line) && ~strcmp(line, 'end_header')
+      line = fgetl(f);
+    end
+    offset = ftell(f);
+  end
+  fseek(f,offset,'bof');
+end
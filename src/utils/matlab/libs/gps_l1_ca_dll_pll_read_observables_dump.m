@@ -20,6 +20,7 @@ function [observables] = gps_l1_ca_dll_pll_read_observables_dump (channels, file
   end
     %loops_counter = fread (f, count, 'uint32',4*12);
   f = fopen (filename, 'rb');
+  bytes_shift = gnss_sdr_dump_data_offset (f); % skips the header of the dump file
   if (f < 0)
   else
     for N=1:1:channels
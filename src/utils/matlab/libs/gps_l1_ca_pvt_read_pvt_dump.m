@@ -73,6 +73,7 @@ function [navSolutions] = gps_l1_ca_pvt_read_pvt_dump (filename, count)
   end
     %loops_counter = fread (f, count, 'uint32',4*12);
   f = fopen (filename, 'rb');
+  bytes_shift = gnss_sdr_dump_data_offset (f); % skips the header of the dump file
   if (f < 0)
   else
         GPS_current_time = fread (f, count, 'float64',skip_bytes_each_read-double_size_bytes);
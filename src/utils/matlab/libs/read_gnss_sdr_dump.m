@@ -0,0 +1,90 @@
+% /*!
+%  * \file read_gnss_sdr_dump.m
+%  * \brief Read any GNSS-SDR dump file with a header into MATLAB / Octave.
+%  * -------------------------------------------------------------------------
+%  *
+%  * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+%  *
+%  * GNSS-SDR is a software defined Global Navigation
+%  *          Satellite Systems receiver
+%  *
+%  * This file is part of GNSS-SDR.
+%  *
+%  * GNSS-SDR is free software: you can redistribute it and/or modify
+%  * it under the terms of the GNU General Public License as published by
+%  * the Free Software Foundation, either version 3 of the License, or
+%  * at your option) any later version.
+%  *
+%  * GNSS-SDR is distributed in the hope that it will be useful,
+%  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+%  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+%  * GNU General Public License for more details.
+%  *
+%  * You should have received a copy of the GNU General Public License
+%  * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+%  *
+%  * -------------------------------------------------------------------------
+%  */
+function [dump, info] = read_gnss_sdr_dump (filename, count)
+
+  %% usage: [dump, info] = read_gnss_sdr_dump (filename, [count])
+  %%
+  %% returns a struct with one member per field of the records (one row
+  %% per element, one column per record) and a struct with the attributes
+  %% of the header (source, channel, sample_rate_hz...)
+  %%
+
+  if (nargin < 2)
+    count = Inf;
+  end
+  dump = struct();
+  info = struct();
+  f = fopen (filename, 'rb');
+  if (f < 0)
+    return;
+  end
+  line = fgetl(f);
+  if (~ischar(line) || ~strncmp(line, 'GNSS-SDR dump', 13))
+    fclose(f);
+    error('%s is not a GNSS-SDR dump file', filename);
+  end
+  names = {};
+  types = {};
+  counts = [];
+  line = fgetl(f);
+  while ischar(line) && ~strcmp(line, 'end_header')
+    [key, value] = strtok(line);
+    value = strtrim(value);
+    if strcmp(key, 'field')
+      parts = strsplit(value);
+      names{end+1} = parts{1};
+      types{end+1} = parts{2};
+      counts(end+1) = str2double(parts{3});
+    else
+      info.(key) = value;
+    end
+    line = fgetl(f);
+  end
+  data_offset = ftell(f);
+  record_size = str2double(info.record_size);
+
+  % each field is read with a skip of the rest of the record
+  field_offset = 0;
+  for i = 1:numel(names)
+    switch types{i}
+      case 'float32'
+        precision = 'float32';
+      case 'float64'
+        precision = 'float64';
+      otherwise
+        precision = types{i};
+    end
+    element_size = str2double(regexp(types{i}, '\d+', 'match', 'once')) / 8;
+    field_size = element_size * counts(i);
+    fseek(f, data_offset + field_offset, 'bof');
+    values = fread(f, [counts(i), count], sprintf('%d*%s', counts(i), precision), record_size - field_size);
+    dump.(names{i}) = values;
+    field_offset = field_offset + field_size;
+  end
+  fclose(f);
+end
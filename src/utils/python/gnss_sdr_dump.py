@@ -0,0 +1,96 @@
+#!/usr/bin/env python
+#
+# Reader of the GNSS-SDR binary dump files (tracking, telemetry,
+# observables and PVT dumps written with Gnss_Dump_Writer).
+#
+# Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+#
+# This file is part of GNSS-SDR.
+#
+# GNSS-SDR is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# GNSS-SDR is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+#
+"""Reads a GNSS-SDR dump file.
+
+    info, fields, records = read_dump('tracking_ch_0.dat')
+
+info is a dict with the attributes of the header (source, channel,
+sample_rate_hz...). fields is a list of (name, type, count). With numpy,
+records is a structured array (records['abs_P'], records['sample_counter']);
+without it, a dict of lists with one entry per record.
+
+Running this file prints the header and the first records of a dump.
+"""
+
+import struct
+import sys
+
+MAGIC = 'GNSS-SDR dump 1'
+
+_FORMATS = {'int8': 'b', 'uint8': 'B', 'int16': 'h', 'uint16': 'H',
+            'int32': 'i', 'uint32': 'I', 'int64': 'q', 'uint64': 'Q',
+            'float32': 'f', 'float64': 'd'}
+
+
+def read_header(f):
+    """Parses the header of the open file f and leaves it at the first record."""
+    if f.readline().decode('ascii').rstrip('\n') != MAGIC:
+        raise ValueError('not a GNSS-SDR dump file')
+    info = {}
+    fields = []
+    for raw in iter(f.readline, b''):
+        line = raw.decode('ascii').rstrip('\n')
+        if line == 'end_header':
+            return info, fields
+        key, _, value = line.partition(' ')
+        if key == 'field':
+            name, ftype, count = value.split()
+            fields.append((name, ftype, int(count)))
+        else:
+            info[key] = value
+    raise ValueError('truncated dump header')
+
+
+def read_dump(filename, count=-1):
+    """Reads the header and up to count records (all by default) of a dump file."""
+    with open(filename, 'rb') as f:
+        info, fields = read_header(f)
+        fmt = '<' + ''.join('%d%s' % (n, _FORMATS[t]) for _, t, n in fields)
+        record_size = struct.calcsize(fmt)
+        if record_size != int(info['record_size']):
+            raise ValueError('record size does not match the fields')
+        data = f.read() if count < 0 else f.read(count * record_size)
+    n = len(data) // record_size
+    try:
+        import numpy as np
+        dtype = np.dtype([(name, '<' + _FORMATS[t], (c,)) if c > 1 else (name, '<' + _FORMATS[t])
+                          for name, t, c in fields])
+        return info, fields, np.frombuffer(data[:n * record_size], dtype=dtype)
+    except ImportError:
+        records = dict((name, []) for name, _, _ in fields)
+        for values in struct.iter_unpack(fmt, data[:n * record_size]):
+            i = 0
+            for name, _, c in fields:
+                records[name].append(values[i] if c == 1 else values[i:i + c])
+                i += c
+        return info, fields, records
+
+
+if __name__ == '__main__':
+    if len(sys.argv) < 2:
+        sys.exit('usage: gnss_sdr_dump.py file.dat [records]')
+    info, fields, records = read_dump(sys.argv[1], int(sys.argv[2]) if len(sys.argv) > 2 else 10)
+    for key in sorted(info):
+        print('%s: %s' % (key, info[key]))
+    for name, ftype, c in fields:
+        print('%-32s %-8s %d  %s' % (name, ftype, c, list(records[name])))
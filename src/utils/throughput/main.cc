@@ -0,0 +1,182 @@
+/*!
+ * \file main.cc
+ * \brief Main file of the throughput program, which runs the whole receiver
+ * as fast as it can on captures and reports how fast it went, in JSON.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_VERSION
+#define GNSS_SDR_VERSION "0.0.5"
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/algorithm/string.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "concurrent_queue.h"
+#include "concurrent_map.h"
+#include "gps_ephemeris.h"
+#include "gps_almanac.h"
+#include "gps_iono.h"
+#include "gps_utc_model.h"
+#include "gps_acq_assist.h"
+#include "gps_ref_location.h"
+#include "gps_ref_time.h"
+#include "galileo_ephemeris.h"
+#include "galileo_almanac.h"
+#include "galileo_iono.h"
+#include "galileo_utc_model.h"
+#include "sbas_telemetry_data.h"
+#include "sbas_ionospheric_correction.h"
+#include "sbas_satellite_correction.h"
+#include "sbas_ephemeris.h"
+#include "sbas_time.h"
+#include "gnss_receiver_fix.h"
+#include "throughput_harness.h"
+
+using google::LogMessage;
+
+// the receivers run in this program: it holds their navigation data
+concurrent_queue<Gps_Ephemeris> global_gps_ephemeris_queue;
+concurrent_queue<Gps_Iono> global_gps_iono_queue;
+concurrent_queue<Gps_Utc_Model> global_gps_utc_model_queue;
+concurrent_queue<Gps_Almanac> global_gps_almanac_queue;
+concurrent_queue<Gps_Acq_Assist> global_gps_acq_assist_queue;
+concurrent_queue<Gps_Ref_Location> global_gps_ref_location_queue;
+concurrent_queue<Gps_Ref_Time> global_gps_ref_time_queue;
+
+concurrent_map<Gps_Ephemeris> global_gps_ephemeris_map;
+concurrent_map<Gps_Iono> global_gps_iono_map;
+concurrent_map<Gps_Utc_Model> global_gps_utc_model_map;
+concurrent_map<Gps_Almanac> global_gps_almanac_map;
+concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
+concurrent_map<Gps_Ref_Time> global_gps_ref_time_map;
+concurrent_map<Gps_Ref_Location> global_gps_ref_location_map;
+
+concurrent_queue<Galileo_Ephemeris> global_galileo_ephemeris_queue;
+concurrent_queue<Galileo_Iono> global_galileo_iono_queue;
+concurrent_queue<Galileo_Utc_Model> global_galileo_utc_model_queue;
+concurrent_queue<Galileo_Almanac> global_galileo_almanac_queue;
+
+concurrent_map<Galileo_Ephemeris> global_galileo_ephemeris_map;
+concurrent_map<Galileo_Iono> global_galileo_iono_map;
+concurrent_map<Galileo_Utc_Model> global_galileo_utc_model_map;
+concurrent_map<Galileo_Almanac> global_galileo_almanac_map;
+
+concurrent_queue<Sbas_Raw_Msg> global_sbas_raw_msg_queue;
+concurrent_queue<Sbas_Ionosphere_Correction> global_sbas_iono_queue;
+concurrent_queue<Sbas_Satellite_Correction> global_sbas_sat_corr_queue;
+concurrent_queue<Sbas_Ephemeris> global_sbas_ephemeris_queue;
+
+concurrent_map<Sbas_Ionosphere_Correction> global_sbas_iono_map;
+concurrent_map<Sbas_Satellite_Correction> global_sbas_sat_corr_map;
+concurrent_map<Sbas_Ephemeris> global_sbas_ephemeris_map;
+
+concurrent_map<Gnss_Receiver_Fix> global_receiver_fix_map;
+
+// config_file and signal_source are flags of the receiver itself
+DEFINE_string(config_files, std::string(GNSSSDR_INSTALL_DIR "/share/gnss-sdr/conf/default.conf"),
+        "Comma-separated configuration files of the receiver, each one run on the captures");
+DEFINE_string(signal_sources, "", "Comma-separated captures run with each configuration (empty: the one of each configuration)");
+DEFINE_string(throughput_dir, "./throughput", "Directory of the runs, with their logs and outputs");
+DEFINE_double(synthetic_s, 0.0, "Length of a synthetic GPS L1 C/A capture also run with each configuration [s] (0: none)");
+DEFINE_int32(synthetic_satellites, 8, "Satellites in the synthetic captures (up to 32)");
+DEFINE_double(synthetic_cn0_db_hz, 45.0, "C/N0 of the satellites in the synthetic captures [dB-Hz]");
+DEFINE_bool(assistance, false, "Keep the SUPL assistance and the receiver state of the configurations (by default, cold starts)");
+DEFINE_string(output, "", "JSON file of the results (empty: the standard output)");
+
+
+std::vector<std::string> throughput_list(const std::string& flag)
+{
+    std::vector<std::string> items;
+    std::vector<std::string> split;
+    boost::algorithm::split(split, flag, boost::algorithm::is_any_of(","));
+    for (unsigned int i = 0; i < split.size(); i++)
+        {
+            boost::algorithm::trim(split[i]);
+            if (split[i].empty() == false) items.push_back(split[i]);
+        }
+    return items;
+}
+
+
+int main(int argc, char** argv)
+{
+    const std::string intro_help(
+            std::string("\ngnss-sdr-throughput runs the whole GNSS-SDR receiver as fast as it can on captures:\n")
+    +
+    "it reports the wall time, the times real time, the share of each block, the peak memory and the TTFF, in JSON.\n"
+    +
+    "Copyright (C) 2010-2015 (see AUTHORS file for a list of contributors)\n"
+    +
+    "This program comes with ABSOLUTELY NO WARRANTY;\n"
+    +
+    "See COPYING file to see a copy of the General Public License\n \n");
+
+    google::SetUsageMessage(intro_help);
+    google::SetVersionString(GNSS_SDR_VERSION);
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    Throughput_Options options;
+    options.config_files = throughput_list(FLAGS_config_files);
+    options.signal_sources = throughput_list(FLAGS_signal_sources);
+    options.directory = FLAGS_throughput_dir;
+    options.synthetic_s = FLAGS_synthetic_s;
+    options.synthetic_satellites = std::max(0, std::min(32, FLAGS_synthetic_satellites));
+    options.synthetic_cn0_db_hz = FLAGS_synthetic_cn0_db_hz;
+    options.assistance = FLAGS_assistance;
+    if (options.config_files.empty())
+        {
+            std::cerr << "Give the configuration files with --config_files" << std::endl;
+            return 1;
+        }
+
+    ThroughputHarness harness(options);
+    bool ok = harness.run();
+    std::string json = gnss_throughput_json(harness.reports());
+    if (FLAGS_output.empty())
+        {
+            std::cout << json;
+        }
+    else
+        {
+            std::ofstream out(FLAGS_output.c_str());
+            out << json;
+            out.close();
+            if (out.fail())
+                {
+                    std::cerr << "Unable to write " << FLAGS_output << std::endl;
+                    ok = false;
+                }
+        }
+    google::ShutDownCommandLineFlags();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,519 @@
+/*!
+ * \file throughput_harness.cc
+ * \brief Implementation of the throughput program, which runs the whole
+ * receiver as fast as it can on captures and reports how fast it went.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "throughput_harness.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <boost/archive/xml_iarchive.hpp>
+#include <boost/archive/xml_oarchive.hpp>
+#include <boost/exception/diagnostic_information.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "concurrent_map.h"
+#include "control_thread.h"
+#include "file_configuration.h"
+#include "gnss_block_counters.h"
+#include "gnss_latency.h"
+#include "gnss_receiver_fix.h"
+#include "gps_sdr_signal_processing.h"
+#include "GPS_L1_CA.h"
+
+using google::LogMessage;
+
+DECLARE_string(log_dir);
+
+extern concurrent_map<Gnss_Receiver_Fix> global_receiver_fix_map;
+
+
+ThroughputHarness::ThroughputHarness(const Throughput_Options& options)
+{
+    options_ = options;
+}
+
+
+bool ThroughputHarness::run()
+{
+    boost::system::error_code ec;
+    boost::filesystem::path directory = boost::filesystem::absolute(options_.directory);
+    boost::filesystem::create_directories(directory, ec);
+    if (ec)
+        {
+            std::cerr << "Unable to create " << directory.string() << ": " << ec.message() << std::endl;
+            return false;
+        }
+
+    bool ok = true;
+    for (unsigned int i = 0; i < options_.config_files.size(); i++)
+        {
+            std::string config_file = boost::filesystem::absolute(options_.config_files[i]).string();
+            std::string stem = boost::filesystem::path(config_file).stem().string();
+            if (boost::filesystem::exists(config_file) == false)
+                {
+                    std::cerr << "The configuration file " << config_file << " does not exist" << std::endl;
+                    Gnss_Throughput_Report missing;
+                    missing.name = stem;
+                    missing.config_file = config_file;
+                    reports_.push_back(missing);
+                    ok = false;
+                    continue;
+                }
+            std::shared_ptr<ConfigurationInterface> configuration = std::make_shared<FileConfiguration>(config_file);
+
+            std::map<std::string, std::string> overrides;
+            overrides["SignalSource.implementation"] = signal_source_implementation(configuration);
+            overrides["SignalSource.repeat"] = "false";
+            overrides["SignalSource.enable_throttle_control"] = "false";
+            overrides["SignalSource.dump"] = "false";
+            overrides["GNSS-SDR.latency_tracing"] = "true";
+            overrides["GNSS-SDR.realtime_monitor"] = "false";
+            if (options_.assistance == false)
+                {
+                    overrides["GNSS-SDR.SUPL_gps_enabled"] = "false";
+                    overrides["GNSS-SDR.SUPL_read_gps_assistance_xml"] = "false";
+                    overrides["GNSS-SDR.state_file"] = "";
+                }
+
+            std::vector<std::string> captures = options_.signal_sources;
+            if (captures.empty())
+                {
+                    captures.push_back(configuration->property("SignalSource.filename", std::string("../data/my_capture.dat")));
+                }
+            for (unsigned int j = 0; j < captures.size(); j++)
+                {
+                    Gnss_Throughput_Report report;
+                    std::ostringstream name;
+                    name << std::setfill('0') << std::setw(2) << reports_.size() << "_" << stem;
+                    if (options_.signal_sources.size() > 1)
+                        {
+                            name << "_" << boost::filesystem::path(captures[j]).stem().string();
+                        }
+                    report.name = name.str();
+                    report.config_file = config_file;
+                    report.signal_source = boost::filesystem::absolute(captures[j]).string();
+                    overrides["SignalSource.filename"] = report.signal_source;
+                    ok = run_one(report, overrides, (directory / report.name).string()) and ok;
+                    reports_.push_back(report);
+                }
+
+            if (options_.synthetic_s > 0.0)
+                {
+                    Gnss_Throughput_Report report;
+                    std::ostringstream name;
+                    name << std::setfill('0') << std::setw(2) << reports_.size() << "_" << stem << "_synthetic";
+                    report.name = name.str();
+                    report.config_file = config_file;
+                    report.synthetic = true;
+                    boost::filesystem::path run_directory = directory / report.name;
+                    boost::filesystem::create_directories(run_directory, ec);
+                    report.signal_source = (run_directory / "synthetic.dat").string();
+                    if (!ec and synthesize(configuration, report.signal_source))
+                        {
+                            if (overrides["SignalSource.implementation"].compare("Compressed_File_Signal_Source") == 0)
+                                {
+                                    overrides["SignalSource.implementation"] = "File_Signal_Source";
+                                }
+                            overrides["SignalSource.filename"] = report.signal_source;
+                            overrides["SignalSource.seek_s"] = "0";
+                            overrides["SignalSource.samples"] = "0";
+                            ok = run_one(report, overrides, run_directory.string()) and ok;
+                            // the captures are large, and easy to make again
+                            boost::filesystem::remove(report.signal_source, ec);
+                        }
+                    else
+                        {
+                            ok = false;
+                        }
+                    reports_.push_back(report);
+                }
+        }
+    return ok;
+}
+
+
+bool ThroughputHarness::run_one(Gnss_Throughput_Report& report, const std::map<std::string, std::string>& overrides, const std::string& directory)
+{
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(directory, ec);
+    if (ec)
+        {
+            std::cerr << "Unable to create " << directory << ": " << ec.message() << std::endl;
+            return false;
+        }
+    std::cerr << "Running " << report.name << " on " << report.signal_source << std::endl;
+
+    // the keyboard listener of the receiver gets a pipe that stays open until
+    // the receiver ends, so that it waits for keys instead of spinning at EOF
+    int keys[2];
+    if (pipe(keys) != 0)
+        {
+            std::cerr << "Unable to start a receiver for " << report.name << std::endl;
+            return false;
+        }
+    std::string output = (boost::filesystem::path(directory) / "gnss-sdr.out").string();
+    std::cout.flush();
+    std::cerr.flush();
+    int pid = fork();
+    if (pid < 0)
+        {
+            close(keys[0]);
+            close(keys[1]);
+            std::cerr << "Unable to start a receiver for " << report.name << std::endl;
+            return false;
+        }
+    if (pid == 0)
+        {
+            close(keys[1]);
+            int out_fd = ::open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (out_fd < 0) _exit(127);
+            dup2(keys[0], 0);
+            dup2(out_fd, 1);
+            dup2(out_fd, 2);
+            receiver(report.config_file, overrides, directory);
+        }
+    close(keys[0]);
+    int status = 0;
+    struct rusage usage;
+    while (wait4(pid, &status, 0, &usage) < 0)
+        {
+            if (errno != EINTR)
+                {
+                    close(keys[1]);
+                    std::cerr << "Lost the receiver of " << report.name << std::endl;
+                    return false;
+                }
+        }
+    close(keys[1]);
+    report.cpu_s = static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+            + static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+    report.peak_rss_kb = usage.ru_maxrss;
+
+    // what the receiver measured itself
+    bool measured = false;
+    std::ifstream in((boost::filesystem::path(directory) / "throughput.xml").string().c_str());
+    if (in.is_open())
+        {
+            try
+            {
+                    Gnss_Throughput_Report receiver_report;
+                    boost::archive::xml_iarchive archive(in);
+                    archive >> boost::serialization::make_nvp("report", receiver_report);
+                    report.fs_hz = receiver_report.fs_hz;
+                    report.signal_s = receiver_report.signal_s;
+                    report.wall_s = receiver_report.wall_s;
+                    report.ttff_s = receiver_report.ttff_s;
+                    report.ttff_wall_s = receiver_report.ttff_wall_s;
+                    report.blocks = receiver_report.blocks;
+                    measured = true;
+            }
+            catch (std::exception const& ex)
+            {
+                    std::cerr << "Unable to read the measurements of " << report.name << ": " << ex.what() << std::endl;
+            }
+        }
+    report.ok = measured and WIFEXITED(status) and WEXITSTATUS(status) == 0;
+    if (report.ok)
+        {
+            std::cerr << std::setprecision(4) << "Finished " << report.name << ": " << report.signal_s << " [s] of signal in "
+                      << report.wall_s << " [s], " << report.realtime_factor() << " times real time" << std::endl;
+        }
+    else
+        {
+            std::cerr << report.name << " failed, see " << directory << std::endl;
+        }
+    return report.ok;
+}
+
+
+/*
+ * Waits for the first position fix of the receiver, ignoring the one it
+ * may have restored from its state (same time), and records when it came
+ */
+void throughput_fix_poller(double restored_fix_time_s, std::chrono::steady_clock::time_point start, double fs_hz,
+        double* ttff_s, double* ttff_wall_s)
+{
+    try
+    {
+            while (true)
+                {
+                    Gnss_Receiver_Fix fix;
+                    if (global_receiver_fix_map.read(0, fix) and fix.valid and fix.utc_time_s != restored_fix_time_s)
+                        {
+                            std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+                            *ttff_wall_s = wall.count();
+                            unsigned long long samples = 0;
+                            long long ns = 0;
+                            if (gnss_sample_clock().latest(samples, ns))
+                                {
+                                    *ttff_s = static_cast<double>(samples) / fs_hz;
+                                }
+                            return;
+                        }
+                    boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+                }
+    }
+    catch (boost::thread_interrupted&)
+    {
+            DLOG(INFO) << "No position fix";
+    }
+}
+
+
+void ThroughputHarness::receiver(const std::string& config_file, const std::map<std::string, std::string>& overrides, const std::string& directory) const
+{
+    // the receiver writes its logs, RINEX, KML and NMEA files to its directory
+    FLAGS_log_dir = directory;
+    if (chdir(directory.c_str()) != 0) _exit(127);
+    std::shared_ptr<FileConfiguration> configuration = std::make_shared<FileConfiguration>(config_file);
+    for (std::map<std::string, std::string>::const_iterator it = overrides.begin(); it != overrides.end(); ++it)
+        {
+            configuration->set_property(it->first, it->second);
+        }
+
+    Gnss_Throughput_Report report;
+    report.fs_hz = configuration->property("GNSS-SDR.internal_fs_hz", 2048000.0);
+    int exit_code = 1;
+    try
+    {
+            std::unique_ptr<ControlThread> control_thread(new ControlThread(configuration));
+            Gnss_Receiver_Fix restored_fix;
+            global_receiver_fix_map.read(0, restored_fix);
+            std::vector<Gnss_Block_Counters_Snapshot> before = gnss_block_counters_snapshot();
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            boost::thread fix_poller(throughput_fix_poller, restored_fix.utc_time_s, start, report.fs_hz, &report.ttff_s, &report.ttff_wall_s);
+            control_thread->run();
+            std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+            fix_poller.interrupt();
+            fix_poller.join();
+
+            report.wall_s = wall.count();
+            unsigned long long samples = 0;
+            long long ns = 0;
+            if (gnss_sample_clock().latest(samples, ns))
+                {
+                    report.signal_s = static_cast<double>(samples) / report.fs_hz;
+                }
+            // the counters of the blocks are gone with the flowgraph
+            report.blocks = gnss_throughput_blocks(before, gnss_block_counters_snapshot());
+
+            std::ofstream out("throughput.xml");
+            {
+                boost::archive::xml_oarchive archive(out);
+                archive << boost::serialization::make_nvp("report", report);
+            }
+            out.close();
+            exit_code = out.fail() ? 1 : 0;
+    }
+    catch(boost::exception & e)
+    {
+            LOG(ERROR) << "Boost exception: " << boost::diagnostic_information(e);
+    }
+    catch(std::exception const& ex)
+    {
+            LOG(ERROR) << "STD exception: " << ex.what();
+    }
+    google::FlushLogFiles(google::GLOG_INFO);
+    std::cout.flush();
+    std::cerr.flush();
+    // a copy of the parent: leave without its exit handlers
+    _exit(exit_code);
+}
+
+
+std::string ThroughputHarness::signal_source_implementation(std::shared_ptr<ConfigurationInterface> configuration) const
+{
+    std::string implementation = configuration->property("SignalSource.implementation", std::string("File_Signal_Source"));
+    if (implementation.compare("File_Signal_Source") == 0 or implementation.compare("Mmap_File_Signal_Source") == 0
+            or implementation.compare("Compressed_File_Signal_Source") == 0)
+        {
+            return implementation;
+        }
+    // a front-end configuration is run on captures with the same samples
+    return "File_Signal_Source";
+}
+
+
+/*
+ * State of a satellite of the synthetic captures
+ */
+struct Throughput_Satellite
+{
+    std::vector<std::complex<float> > code;
+    double code_phase_chips;     // from the beginning of a data bit
+    double chips_per_sample;
+    std::complex<float> carrier;
+    std::complex<float> rotation;
+    unsigned long long bit_index;
+    float bit;
+};
+
+
+bool ThroughputHarness::synthesize(std::shared_ptr<ConfigurationInterface> configuration, const std::string& filename) const
+{
+    std::string role = "SignalSource";
+    std::string item_type = configuration->property(role + ".item_type", std::string("short"));
+    long sampling_frequency = configuration->property(role + ".sampling_frequency", 0);
+    double IF = configuration->property("InputFilter.IF", 0.0);
+    if (sampling_frequency <= 0)
+        {
+            std::cerr << "Set " << role << ".sampling_frequency to make a synthetic capture" << std::endl;
+            return false;
+        }
+    if (IF >= 1e6)
+        {
+            std::cerr << "The synthetic captures are complex samples, they cannot feed a real IF front-end configuration" << std::endl;
+            return false;
+        }
+    // noise of unit power, quantized with some headroom
+    float scale = 1.0;
+    if (item_type.compare("short") == 0)
+        {
+            scale = 1000.0;
+        }
+    else if (item_type.compare("byte") == 0)
+        {
+            scale = 24.0;
+        }
+    else if (item_type.compare("gr_complex") != 0 and item_type.compare("float") != 0)
+        {
+            std::cerr << "Unable to make a synthetic capture of " << item_type << " items" << std::endl;
+            return false;
+        }
+    double fs = static_cast<double>(sampling_frequency);
+    float amplitude = static_cast<float>(std::sqrt(std::pow(10.0, options_.synthetic_cn0_db_hz / 10.0) / fs));
+    const double chips_per_bit = GPS_L1_CA_CODE_LENGTH_CHIPS * static_cast<double>(GPS_CA_TELEMETRY_RATE_SYMBOLS_SECOND / GPS_CA_TELEMETRY_RATE_BITS_SECOND);
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::normal_distribution<float> noise(0.0, std::sqrt(0.5));
+    std::vector<Throughput_Satellite> satellites(options_.synthetic_satellites);
+    std::ostringstream prns;
+    for (unsigned int i = 0; i < satellites.size(); i++)
+        {
+            // distinct PRNs, and Dopplers spread over the search range
+            unsigned int prn = 1 + (i * 5) % 32;
+            double doppler = -4000.0 + 8000.0 * (static_cast<double>(i) + 0.5) / static_cast<double>(satellites.size());
+            double carrier_hz = IF + doppler;
+            satellites[i].code.resize(static_cast<unsigned int>(GPS_L1_CA_CODE_LENGTH_CHIPS));
+            gps_l1_ca_code_gen_complex(&satellites[i].code[0], prn, 0);
+            satellites[i].code_phase_chips = uniform(generator) * chips_per_bit;
+            satellites[i].chips_per_sample = GPS_L1_CA_CODE_RATE_HZ * (1.0 + doppler / GPS_L1_FREQ_HZ) / fs;
+            satellites[i].carrier = std::complex<float>(1.0, 0.0);
+            satellites[i].rotation = std::polar(1.0f, static_cast<float>(2.0 * GPS_PI * carrier_hz / fs));
+            satellites[i].bit_index = 0;
+            satellites[i].bit = (uniform(generator) < 0.5) ? -1.0 : 1.0;
+            prns << (i > 0 ? ", " : "") << prn << std::setprecision(5) << " (" << doppler << " Hz)";
+        }
+
+    std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+    unsigned long long samples = static_cast<unsigned long long>(std::round(options_.synthetic_s * fs));
+    const unsigned int chunk = 65536;
+    std::vector<std::complex<float> > signal(chunk);
+    std::vector<char> items;
+    for (unsigned long long n = 0; n < samples and out.good(); n += chunk)
+        {
+            unsigned int length = static_cast<unsigned int>(std::min<unsigned long long>(chunk, samples - n));
+            for (unsigned int k = 0; k < length; k++)
+                {
+                    signal[k] = std::complex<float>(noise(generator), noise(generator));
+                }
+            for (unsigned int i = 0; i < satellites.size(); i++)
+                {
+                    Throughput_Satellite& s = satellites[i];
+                    for (unsigned int k = 0; k < length; k++)
+                        {
+                            unsigned long long chip = static_cast<unsigned long long>(s.code_phase_chips);
+                            unsigned long long bit_index = static_cast<unsigned long long>(s.code_phase_chips / chips_per_bit);
+                            if (bit_index != s.bit_index)
+                                {
+                                    s.bit_index = bit_index;
+                                    s.bit = (uniform(generator) < 0.5) ? -1.0 : 1.0;
+                                }
+                            signal[k] += s.code[chip % s.code.size()] * (s.bit * amplitude) * s.carrier;
+                            s.carrier *= s.rotation;
+                            s.code_phase_chips += s.chips_per_sample;
+                        }
+                    s.carrier /= std::abs(s.carrier);
+                }
+            if (item_type.compare("gr_complex") == 0)
+                {
+                    out.write(reinterpret_cast<const char*>(&signal[0]), length * sizeof(std::complex<float>));
+                }
+            else if (item_type.compare("float") == 0)
+                {
+                    // interleaved I/Q
+                    out.write(reinterpret_cast<const char*>(&signal[0]), length * 2 * sizeof(float));
+                }
+            else if (item_type.compare("short") == 0)
+                {
+                    items.resize(length * 2 * sizeof(short));
+                    short* iq = reinterpret_cast<short*>(&items[0]);
+                    for (unsigned int k = 0; k < length; k++)
+                        {
+                            iq[2 * k] = static_cast<short>(std::round(std::max(-32767.0f, std::min(32767.0f, signal[k].real() * scale))));
+                            iq[2 * k + 1] = static_cast<short>(std::round(std::max(-32767.0f, std::min(32767.0f, signal[k].imag() * scale))));
+                        }
+                    out.write(&items[0], items.size());
+                }
+            else
+                {
+                    items.resize(length * 2);
+                    for (unsigned int k = 0; k < length; k++)
+                        {
+                            items[2 * k] = static_cast<signed char>(std::round(std::max(-127.0f, std::min(127.0f, signal[k].real() * scale))));
+                            items[2 * k + 1] = static_cast<signed char>(std::round(std::max(-127.0f, std::min(127.0f, signal[k].imag() * scale))));
+                        }
+                    out.write(&items[0], items.size());
+                }
+        }
+    out.close();
+    if (out.fail())
+        {
+            std::cerr << "Unable to write " << filename << std::endl;
+            return false;
+        }
+    std::cerr << "Synthesized " << options_.synthetic_s << " [s] of GPS L1 C/A PRN " << prns.str() << " at "
+              << options_.synthetic_cn0_db_hz << " dB-Hz, " << item_type << " items, in " << filename << std::endl;
+    return true;
+}
@@ -0,0 +1,96 @@
+/*!
+ * \file throughput_harness.h
+ * \brief Interface of the throughput program, which runs the whole receiver
+ * as fast as it can on captures and reports how fast it went.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_THROUGHPUT_HARNESS_H_
+#define GNSS_SDR_THROUGHPUT_HARNESS_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "configuration_interface.h"
+#include "gnss_throughput_report.h"
+
+/*!
+ * \brief Options of a throughput run
+ */
+struct Throughput_Options
+{
+    std::vector<std::string> config_files;     //!< Configurations of the receiver
+    std::vector<std::string> signal_sources;   //!< Captures run with each configuration. Empty: the one of each configuration
+    std::string directory;                     //!< Directory of the runs
+    double synthetic_s;                        //!< Length of the synthetic capture run with each configuration [s] (0: none)
+    unsigned int synthetic_satellites;         //!< GPS L1 C/A satellites in the synthetic captures
+    double synthetic_cn0_db_hz;                //!< C/N0 of the satellites in the synthetic captures [dB-Hz]
+    bool assistance;                           //!< Keep the SUPL assistance and the receiver state of the configurations
+};
+
+
+/*!
+ * \brief This class measures how fast the whole receiver processes captures.
+ *
+ * Each configuration is run on each capture, plus a synthetic one if asked,
+ * one run at a time so that the runs do not compete for the cores. The
+ * receiver keeps its navigation data in process-wide maps, so each run is
+ * a forked process with its own ControlThread and flowgraph, left in its own
+ * directory under Throughput_Options::directory with its logs and outputs.
+ * The signal source is not throttled nor repeated, and the receiver starts
+ * cold unless Throughput_Options::assistance is set.
+ *
+ * The run measures the signal time delivered to the channels (from the
+ * sample clock), the wall time of the flowgraph, the time spent in work by
+ * each kind of block (from the block counters) and the time to first fix,
+ * polled every 10 ms. The parent adds the CPU time and the peak resident
+ * set size of the run from the exit status of the process.
+ */
+class ThroughputHarness
+{
+public:
+    ThroughputHarness(const Throughput_Options& options);
+
+    /*!
+     * \brief Runs all the configurations. Returns false if a run failed; its
+     * report is kept, with ok set to false.
+     */
+    bool run();
+
+    const std::vector<Gnss_Throughput_Report>& reports() const { return reports_; }
+
+private:
+    bool run_one(Gnss_Throughput_Report& report, const std::map<std::string, std::string>& overrides, const std::string& directory);
+    void receiver(const std::string& config_file, const std::map<std::string, std::string>& overrides, const std::string& directory) const;
+    bool synthesize(std::shared_ptr<ConfigurationInterface> configuration, const std::string& filename) const;
+    std::string signal_source_implementation(std::shared_ptr<ConfigurationInterface> configuration) const;
+
+    Throughput_Options options_;
+    std::vector<Gnss_Throughput_Report> reports_;
+};
+
+#endif